@@ -0,0 +1,159 @@
+/*
+ * Copyright (C) 2015-2017 Alibaba Group Holding Limited
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <hal/hal.h>
+
+/*
+ * NOR flash emulation for the host: partition n is the file
+ * aos_partition_<n>.bin of FLASH_EMU_PART_SIZE bytes in the current
+ * directory, created erased on first use. A write can only clear bits
+ * and an erase sets a whole sector back to 0xFF, as on the real part, so
+ * the flash users see the same contents they would on a board.
+ */
+#ifndef FLASH_EMU_PART_SIZE
+#define FLASH_EMU_PART_SIZE   (64 * 1024)
+#endif
+
+#ifndef FLASH_EMU_SECTOR_SIZE
+#define FLASH_EMU_SECTOR_SIZE 4096
+#endif
+
+#define FLASH_EMU_PARTS       16
+
+static int g_flash_fd[FLASH_EMU_PARTS];
+
+static int flash_open(hal_partition_t pno)
+{
+    unsigned char buf[FLASH_EMU_SECTOR_SIZE];
+    char          path[32];
+    off_t         off;
+    int           fd;
+
+    if ((unsigned)pno >= FLASH_EMU_PARTS) {
+        return -EINVAL;
+    }
+
+    /* fds are stored + 1 so the zeroed table means none open */
+    if (g_flash_fd[pno] > 0) {
+        return g_flash_fd[pno] - 1;
+    }
+
+    snprintf(path, sizeof(path), "./aos_partition_%d.bin", (int)pno);
+    fd = open(path, O_RDWR);
+    if (fd < 0) {
+        fd = open(path, O_RDWR | O_CREAT, 0644);
+        if (fd < 0) {
+            return -errno;
+        }
+
+        memset(buf, 0xff, sizeof(buf));
+        for (off = 0; off < FLASH_EMU_PART_SIZE; off += sizeof(buf)) {
+            if (pwrite(fd, buf, sizeof(buf), off) != sizeof(buf)) {
+                close(fd);
+                unlink(path);
+                return -EIO;
+            }
+        }
+    }
+
+    g_flash_fd[pno] = fd + 1;
+    return fd;
+}
+
+static int flash_range_ok(uint32_t off, uint32_t len)
+{
+    return off <= FLASH_EMU_PART_SIZE && len <= FLASH_EMU_PART_SIZE - off;
+}
+
+int32_t hal_flash_read(hal_partition_t pno, uint32_t *poff, void *buf, uint32_t buf_size)
+{
+    int fd = flash_open(pno);
+
+    if (fd < 0) {
+        return fd;
+    }
+
+    if (!flash_range_ok(*poff, buf_size)) {
+        return -EINVAL;
+    }
+
+    if (pread(fd, buf, buf_size, *poff) != buf_size) {
+        return -EIO;
+    }
+
+    *poff += buf_size;
+    return 0;
+}
+
+int32_t hal_flash_write(hal_partition_t pno, uint32_t *poff, const void *buf, uint32_t buf_size)
+{
+    const unsigned char *src = buf;
+    unsigned char        cur[FLASH_EMU_SECTOR_SIZE];
+    uint32_t             done;
+    uint32_t             n;
+    uint32_t             i;
+    int                  fd = flash_open(pno);
+
+    if (fd < 0) {
+        return fd;
+    }
+
+    if (!flash_range_ok(*poff, buf_size)) {
+        return -EINVAL;
+    }
+
+    for (done = 0; done < buf_size; done += n) {
+        n = buf_size - done;
+        if (n > sizeof(cur)) {
+            n = sizeof(cur);
+        }
+
+        if (pread(fd, cur, n, *poff + done) != n) {
+            return -EIO;
+        }
+
+        for (i = 0; i < n; i++) {
+            cur[i] &= src[done + i];
+        }
+
+        if (pwrite(fd, cur, n, *poff + done) != n) {
+            return -EIO;
+        }
+    }
+
+    *poff += buf_size;
+    return 0;
+}
+
+int32_t hal_flash_erase(hal_partition_t pno, uint32_t off_set, uint32_t size)
+{
+    unsigned char buf[FLASH_EMU_SECTOR_SIZE];
+    uint32_t      start = off_set & ~(FLASH_EMU_SECTOR_SIZE - 1);
+    uint32_t      end = (off_set + size + FLASH_EMU_SECTOR_SIZE - 1) & ~(FLASH_EMU_SECTOR_SIZE - 1);
+    uint32_t      off;
+    int           fd = flash_open(pno);
+
+    if (fd < 0) {
+        return fd;
+    }
+
+    if (!flash_range_ok(start, end - start)) {
+        return -EINVAL;
+    }
+
+    memset(buf, 0xff, sizeof(buf));
+    for (off = start; off < end; off += sizeof(buf)) {
+        if (pwrite(fd, buf, sizeof(buf), off) != sizeof(buf)) {
+            return -EIO;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,196 @@
+/*
+ * Copyright (C) 2015-2017 Alibaba Group Holding Limited
+ */
+
+#ifndef K_CONFIG_H
+#define K_CONFIG_H
+
+/* chip level conf */
+#ifndef RHINO_CONFIG_LITTLE_ENDIAN
+#define RHINO_CONFIG_LITTLE_ENDIAN           1
+#endif
+
+#ifndef RHINO_CONFIG_CPU_STACK_DOWN
+#define RHINO_CONFIG_CPU_STACK_DOWN          1
+#endif
+
+/* kernel feature conf */
+#ifndef RHINO_CONFIG_SEM
+#define RHINO_CONFIG_SEM                     1
+#endif
+
+#ifndef RHINO_CONFIG_QUEUE
+#define RHINO_CONFIG_QUEUE                   1
+#endif
+
+#ifndef RHINO_CONFIG_TASK_SEM
+#define RHINO_CONFIG_TASK_SEM                1
+#endif
+
+#ifndef RHINO_CONFIG_EVENT_FLAG
+#define RHINO_CONFIG_EVENT_FLAG              1
+#endif
+
+#ifndef RHINO_CONFIG_TIMER
+#define RHINO_CONFIG_TIMER                   1
+#endif
+
+#ifndef RHINO_CONFIG_BUF_QUEUE
+#define RHINO_CONFIG_BUF_QUEUE               1
+#endif
+
+#ifndef RHINO_CONFIG_WORKQUEUE
+#define RHINO_CONFIG_WORKQUEUE               1
+#endif
+
+#ifndef RHINO_CONFIG_WORKQUEUE_STACK_SIZE
+#define RHINO_CONFIG_WORKQUEUE_STACK_SIZE    4096
+#endif
+
+#ifndef RHINO_CONFIG_WORKQUEUE_WORKER_MAX
+#define RHINO_CONFIG_WORKQUEUE_WORKER_MAX    4
+#endif
+
+#ifndef RHINO_CONFIG_WORKQUEUE_STATS
+#define RHINO_CONFIG_WORKQUEUE_STATS         1
+#endif
+
+#ifndef RHINO_CONFIG_RINGBUF_VENDOR
+#define RHINO_CONFIG_RINGBUF_VENDOR          1
+#endif
+
+#ifndef RHINO_CONFIG_RINGBUF_LOCKFREE
+#define RHINO_CONFIG_RINGBUF_LOCKFREE        1
+#endif
+
+/* heap conf */
+#ifndef RHINO_CONFIG_MM_TLF
+#define RHINO_CONFIG_MM_TLF                  1
+#endif
+
+#ifndef RHINO_CONFIG_MM_TLF_BLK_SIZE
+#define RHINO_CONFIG_MM_TLF_BLK_SIZE         8192
+#endif
+
+#ifndef RHINO_CONFIG_MM_MAXMSIZEBIT
+#define RHINO_CONFIG_MM_MAXMSIZEBIT          24
+#endif
+
+#ifndef RHINO_CONFIG_MM_DEBUG
+#define RHINO_CONFIG_MM_DEBUG                1
+#endif
+
+#ifndef K_MM_STATISTIC
+#define K_MM_STATISTIC                       1
+#endif
+
+#ifndef RHINO_CONFIG_MM_MAGAZINE
+#define RHINO_CONFIG_MM_MAGAZINE             1
+#endif
+
+#ifndef RHINO_CONFIG_MM_SLAB
+#define RHINO_CONFIG_MM_SLAB                 1
+#endif
+
+#ifndef RHINO_CONFIG_MM_SLAB_EMPTY_PAGES
+#define RHINO_CONFIG_MM_SLAB_EMPTY_PAGES     2
+#endif
+
+/* kernel task conf */
+#ifndef RHINO_CONFIG_TASK_SUSPEND
+#define RHINO_CONFIG_TASK_SUSPEND            1
+#endif
+
+#ifndef RHINO_CONFIG_TASK_INFO
+#define RHINO_CONFIG_TASK_INFO               1
+#endif
+
+#ifndef RHINO_CONFIG_TASK_DEL
+#define RHINO_CONFIG_TASK_DEL                1
+#endif
+
+#ifndef RHINO_CONFIG_TASK_WAIT_ABORT
+#define RHINO_CONFIG_TASK_WAIT_ABORT         1
+#endif
+
+#ifndef RHINO_CONFIG_TASK_STACK_OVF_CHECK
+#define RHINO_CONFIG_TASK_STACK_OVF_CHECK    1
+#endif
+
+#ifndef RHINO_CONFIG_SCHED_RR
+#define RHINO_CONFIG_SCHED_RR                1
+#endif
+
+#ifndef RHINO_CONFIG_TIME_SLICE_DEFAULT
+#define RHINO_CONFIG_TIME_SLICE_DEFAULT      50
+#endif
+
+#ifndef RHINO_CONFIG_PRI_MAX
+#define RHINO_CONFIG_PRI_MAX                 62
+#endif
+
+#ifndef RHINO_CONFIG_USER_PRI_MAX
+#define RHINO_CONFIG_USER_PRI_MAX            (RHINO_CONFIG_PRI_MAX - 2)
+#endif
+
+/* kernel timer&tick conf */
+#ifndef RHINO_CONFIG_HW_COUNT
+#define RHINO_CONFIG_HW_COUNT                1
+#endif
+
+#ifndef RHINO_CONFIG_TICKS_PER_SECOND
+#define RHINO_CONFIG_TICKS_PER_SECOND        1000
+#endif
+
+/* the host idles in sigsuspend() instead of spinning on a tick per ms */
+#ifndef RHINO_CONFIG_TICKLESS
+#define RHINO_CONFIG_TICKLESS                1
+#endif
+
+#ifndef RHINO_CONFIG_TIMER_TASK_STACK_SIZE
+#define RHINO_CONFIG_TIMER_TASK_STACK_SIZE   4096
+#endif
+
+#ifndef RHINO_CONFIG_TIMER_TASK_PRI
+#define RHINO_CONFIG_TIMER_TASK_PRI          5
+#endif
+
+#ifndef RHINO_CONFIG_TIMER_MSG_NUM
+#define RHINO_CONFIG_TIMER_MSG_NUM           20
+#endif
+
+/* kernel dyn alloc conf */
+#ifndef RHINO_CONFIG_KOBJ_DYN_ALLOC
+#define RHINO_CONFIG_KOBJ_DYN_ALLOC          1
+#endif
+
+#ifndef RHINO_CONFIG_K_DYN_TASK_STACK
+#define RHINO_CONFIG_K_DYN_TASK_STACK        4096
+#endif
+
+/* kernel idle conf */
+#ifndef RHINO_CONFIG_IDLE_TASK_STACK_SIZE
+#define RHINO_CONFIG_IDLE_TASK_STACK_SIZE    4096
+#endif
+
+/* kernel trace conf, the sink runs on the drain task stack */
+#ifndef RHINO_CONFIG_TRACE_TASK_STACK
+#define RHINO_CONFIG_TRACE_TASK_STACK        4096
+#endif
+
+/* kernel hook conf */
+#ifndef RHINO_CONFIG_USER_HOOK
+#define RHINO_CONFIG_USER_HOOK               0
+#endif
+
+/* kernel stats conf */
+#ifndef RHINO_CONFIG_SYSTEM_STATS
+#define RHINO_CONFIG_SYSTEM_STATS            1
+#endif
+
+#ifndef RHINO_CONFIG_CPU_NUM
+#define RHINO_CONFIG_CPU_NUM                 1
+#endif
+
+#endif /* K_CONFIG_H */
+
@@ -0,0 +1,14 @@
+NAME := board_linuxhost
+
+HOST_ARCH := linux
+
+$(NAME)_TYPE := kernel
+$(NAME)_MBINS_TYPE := kernel
+
+$(NAME)_COMPONENTS += platform/arch/linux rhino
+
+GLOBAL_INCLUDES += ./
+
+$(NAME)_SOURCES := soc_impl.c \
+                   main.c \
+                   flash.c
@@ -0,0 +1,44 @@
+/*
+ * Copyright (C) 2015-2017 Alibaba Group Holding Limited
+ */
+
+#include <stdio.h>
+
+#include <k_api.h>
+
+#define LINUXHOST_APP_TASK_PRI        10
+#define LINUXHOST_APP_TASK_STACK_SIZE 8192
+
+extern int application_start(int argc, char **argv);
+
+static ktask_t     g_app_task;
+static cpu_stack_t g_app_task_stack[LINUXHOST_APP_TASK_STACK_SIZE];
+
+static int    g_argc;
+static char **g_argv;
+
+static void app_entry(void *arg)
+{
+    (void)arg;
+
+    application_start(g_argc, g_argv);
+}
+
+int main(int argc, char **argv)
+{
+    g_argc = argc;
+    g_argv = argv;
+
+    setvbuf(stdout, NULL, _IOLBF, 0);
+
+    krhino_init();
+
+    krhino_task_create(&g_app_task, "app_task", NULL, LINUXHOST_APP_TASK_PRI, 0,
+                       g_app_task_stack, LINUXHOST_APP_TASK_STACK_SIZE,
+                       app_entry, 1u);
+
+    krhino_start();
+
+    return 0;
+}
+
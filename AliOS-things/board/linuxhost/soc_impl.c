@@ -0,0 +1,58 @@
+/*
+ * Copyright (C) 2015-2017 Alibaba Group Holding Limited
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <k_api.h>
+
+#ifndef LINUXHOST_HEAP_SIZE
+#define LINUXHOST_HEAP_SIZE (8 * 1024 * 1024)
+#endif
+
+static uint64_t g_linuxhost_heap[LINUXHOST_HEAP_SIZE / sizeof(uint64_t)];
+
+k_mm_region_t g_mm_region[] = {
+    {(uint8_t *)g_linuxhost_heap, sizeof(g_linuxhost_heap)}
+};
+
+int g_region_num = sizeof(g_mm_region) / sizeof(k_mm_region_t);
+
+#if (RHINO_CONFIG_HW_COUNT > 0)
+void soc_hw_timer_init(void)
+{
+}
+
+/* CLOCK_MONOTONIC in ns, so hr counts need no further scaling on this board */
+hr_timer_t soc_hr_hw_cnt_get(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (hr_timer_t)ts.tv_sec * 1000000000ull + (hr_timer_t)ts.tv_nsec;
+}
+
+lr_timer_t soc_lr_hw_cnt_get(void)
+{
+    return (lr_timer_t)(soc_hr_hw_cnt_get() / 1000u);
+}
+#endif /* RHINO_CONFIG_HW_COUNT */
+
+size_t soc_get_cur_sp(void)
+{
+    volatile size_t dummy;
+
+    return (size_t)&dummy;
+}
+
+void soc_err_proc(kstat_t err)
+{
+    fprintf(stderr, "kernel panic, err %d\n", err);
+    abort();
+}
+
+krhino_err_proc_t g_err_proc = soc_err_proc;
+
@@ -0,0 +1,10 @@
+src     = Split('''
+        soc_impl.c
+        main.c
+        flash.c
+''')
+component = aos_component('board_linuxhost', src)
+
+aos_global_config.set('arch', 'linux')
+component.add_comp_deps('platform/arch/linux', 'kernel/rhino')
+component.add_global_includes('.')
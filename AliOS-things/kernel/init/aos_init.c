@@ -15,11 +15,13 @@
 
 extern int vfs_init(void);
 extern int vfs_device_init(void);
+extern void vfs_bench_init(void);
 extern int aos_kv_init(void);
 extern void ota_service_init(void);
 extern int aos_framework_init(void);
 extern void trace_start(void);
 extern void dumpsys_cli_init(void);
+extern int aos_mm_prof_init(void);
 extern int application_start(int argc, char **argv);
 //extern void aos_components_init(void);
 
@@ -228,6 +230,9 @@ void cli_service_init(kinit_t *kinit)
 #ifdef VCALL_RHINO
         dumpsys_cli_init();
 #endif
+#if defined(AOS_VFS) && defined(CONFIG_AOS_BENCH)
+        vfs_bench_init();
+#endif
 #ifndef CONFIG_NO_TCPIP
         tcpip_cli_init();
 #endif
@@ -266,6 +271,7 @@ int aos_kernel_init(kinit_t *kinit)
 
 #ifdef VCALL_RHINO
     trace_start();
+    aos_mm_prof_init();
 #endif
 
 #ifdef AOS_FOTA 
@@ -0,0 +1,530 @@
+/*
+ * Copyright (C) 2015-2017 Alibaba Group Holding Limited
+ */
+
+#include <string.h>
+#include <aos/aos.h>
+#include "fatfs_diskio.h"
+#include "ff.h"
+
+#if FATFS_CACHE_SECTORS > 0
+/*
+ * Sector cache between FatFs and the drivers, one pool for all the mounted
+ * drives, allocated by the first one. Sectors are found by drive and
+ * number in hash chains and kept on an LRU list, both link entries by
+ * index + 1.
+ *
+ * A one sector write stays in the cache until its entry is evicted or the
+ * drive is synced, dirty neighbours then go along in one transfer of up
+ * to FATFS_CACHE_BURST sectors. A one sector read missing right after the
+ * previous miss of its drive reads the next FATFS_CACHE_BURST sectors in
+ * one transfer. Transfers of several sectors, which FatFs does for whole
+ * sectors of file data, go to the drive directly: a read takes the newer
+ * cached copies over, a write refreshes them.
+ */
+#if FATFS_CACHE_BURST > FATFS_CACHE_SECTORS
+#error "FATFS_CACHE_BURST must not exceed FATFS_CACHE_SECTORS"
+#endif
+
+#define CACHE_SS        FF_MAX_SS
+#define CACHE_BUCKETS   16
+#define CACHE_FREE      0xFF        /* pdrv of an unused entry */
+#define CACHE_DIRTY     0x01
+
+typedef struct {
+    DWORD    sector;
+    uint16_t hnext;                 /* hash chain, index + 1 */
+    uint16_t prev;                  /* LRU list, index + 1 */
+    uint16_t next;
+    BYTE     pdrv;
+    BYTE     flags;
+} cache_ent_t;
+
+typedef struct {
+    aos_mutex_t         lock;
+    cache_ent_t        *ents;
+    BYTE               *data;       /* CACHE_SS bytes per entry */
+    BYTE               *burst;      /* FATFS_CACHE_BURST sectors for merged transfers */
+    uint16_t            hash[CACHE_BUCKETS];
+    uint16_t            head;       /* most recently used */
+    uint16_t            tail;       /* least recently used, or free */
+    uint16_t            attached;   /* bit per drive */
+    int                 users;
+    int                 disabled;
+    DWORD               ra_next[FF_VOLUMES];    /* the sector after the last miss */
+    fatfs_cache_stats_t stats;
+} fatfs_cache_t;
+
+static fatfs_cache_t g_cache;
+
+static BYTE *ent_data(cache_ent_t *e)
+{
+    return g_cache.data + (size_t)(e - g_cache.ents) * CACHE_SS;
+}
+
+static uint16_t ent_id(cache_ent_t *e)
+{
+    return (uint16_t)(e - g_cache.ents) + 1;
+}
+
+static uint16_t *cache_bucket(BYTE pdrv, DWORD sector)
+{
+    return &g_cache.hash[(sector + pdrv * 7) & (CACHE_BUCKETS - 1)];
+}
+
+static cache_ent_t *cache_find(BYTE pdrv, DWORD sector)
+{
+    cache_ent_t *e;
+    uint16_t     id;
+
+    for (id = *cache_bucket(pdrv, sector); id != 0; id = e->hnext) {
+        e = &g_cache.ents[id - 1];
+        if (e->sector == sector && e->pdrv == pdrv) {
+            return e;
+        }
+    }
+
+    return NULL;
+}
+
+static void cache_unhash(cache_ent_t *e)
+{
+    uint16_t *link = cache_bucket(e->pdrv, e->sector);
+
+    while (*link != ent_id(e)) {
+        link = &g_cache.ents[*link - 1].hnext;
+    }
+
+    *link = e->hnext;
+}
+
+static void lru_unlink(cache_ent_t *e)
+{
+    if (e->prev != 0) {
+        g_cache.ents[e->prev - 1].next = e->next;
+    } else {
+        g_cache.head = e->next;
+    }
+
+    if (e->next != 0) {
+        g_cache.ents[e->next - 1].prev = e->prev;
+    } else {
+        g_cache.tail = e->prev;
+    }
+}
+
+static void lru_push(cache_ent_t *e, int tail)
+{
+    if (tail) {
+        e->next = 0;
+        e->prev = g_cache.tail;
+        if (g_cache.tail != 0) {
+            g_cache.ents[g_cache.tail - 1].next = ent_id(e);
+        } else {
+            g_cache.head = ent_id(e);
+        }
+        g_cache.tail = ent_id(e);
+    } else {
+        e->prev = 0;
+        e->next = g_cache.head;
+        if (g_cache.head != 0) {
+            g_cache.ents[g_cache.head - 1].prev = ent_id(e);
+        } else {
+            g_cache.tail = ent_id(e);
+        }
+        g_cache.head = ent_id(e);
+    }
+}
+
+static void cache_touch(cache_ent_t *e)
+{
+    lru_unlink(e);
+    lru_push(e, 0);
+}
+
+/* forget the entry, it goes first the next time one is needed */
+static void cache_drop(cache_ent_t *e)
+{
+    if (e->pdrv != CACHE_FREE) {
+        cache_unhash(e);
+    }
+
+    e->pdrv  = CACHE_FREE;
+    e->flags = 0;
+    lru_unlink(e);
+    lru_push(e, 1);
+}
+
+static DRESULT cache_dev_read(BYTE pdrv, BYTE *buff, DWORD sector, UINT count)
+{
+    g_cache.stats.dev_reads++;
+    g_cache.stats.dev_read_sectors += count;
+    return disk_dev_read(pdrv, buff, sector, count);
+}
+
+static DRESULT cache_dev_write(BYTE pdrv, const BYTE *buff, DWORD sector, UINT count)
+{
+    g_cache.stats.dev_writes++;
+    g_cache.stats.dev_write_sectors += count;
+    return disk_dev_write(pdrv, buff, sector, count);
+}
+
+/* write back the run of dirty sectors around e in one transfer */
+static DRESULT cache_write_run(cache_ent_t *e)
+{
+    cache_ent_t *run[FATFS_CACHE_BURST];
+    cache_ent_t *n;
+    DWORD        first = e->sector;
+    UINT         count;
+    UINT         i;
+    DRESULT      res;
+
+    while (first > 0 && e->sector - first + 1 < FATFS_CACHE_BURST &&
+           (n = cache_find(e->pdrv, first - 1)) != NULL && (n->flags & CACHE_DIRTY)) {
+        first--;
+    }
+
+    for (count = 0; count < FATFS_CACHE_BURST; count++) {
+        n = cache_find(e->pdrv, first + count);
+        if (n == NULL || !(n->flags & CACHE_DIRTY)) {
+            break;
+        }
+        run[count] = n;
+    }
+
+    if (count == 1) {
+        res = cache_dev_write(e->pdrv, ent_data(run[0]), first, 1);
+    } else {
+        for (i = 0; i < count; i++) {
+            memcpy(g_cache.burst + i * CACHE_SS, ent_data(run[i]), CACHE_SS);
+        }
+        res = cache_dev_write(e->pdrv, g_cache.burst, first, count);
+    }
+
+    if (res != RES_OK) {
+        return res;
+    }
+
+    for (i = 0; i < count; i++) {
+        run[i]->flags &= ~CACHE_DIRTY;
+    }
+    g_cache.stats.write_backs += count;
+
+    return RES_OK;
+}
+
+/* take the least recently used entry for sector, writing it back if dirty */
+static cache_ent_t *cache_alloc(BYTE pdrv, DWORD sector, DRESULT *res)
+{
+    cache_ent_t *e = &g_cache.ents[g_cache.tail - 1];
+    uint16_t    *bucket;
+
+    if (e->pdrv != CACHE_FREE) {
+        if ((e->flags & CACHE_DIRTY) && (*res = cache_write_run(e)) != RES_OK) {
+            return NULL;
+        }
+        cache_unhash(e);
+    }
+
+    bucket   = cache_bucket(pdrv, sector);
+    e->pdrv   = pdrv;
+    e->sector = sector;
+    e->flags  = 0;
+    e->hnext  = *bucket;
+    *bucket   = ent_id(e);
+    cache_touch(e);
+
+    return e;
+}
+
+/* read the missing sector, and the ones after it for a sequential reader */
+static DRESULT cache_fill(BYTE pdrv, BYTE *buff, DWORD sector)
+{
+    cache_ent_t *run[FATFS_CACHE_BURST];
+    DRESULT      res = RES_OK;
+    UINT         count = 1;
+    UINT         i;
+
+    if (sector == g_cache.ra_next[pdrv]) {
+        while (count < FATFS_CACHE_BURST && cache_find(pdrv, sector + count) == NULL) {
+            count++;
+        }
+    }
+
+    /* evict first, a write back goes through the burst buffer */
+    for (i = 0; i < count; i++) {
+        run[i] = cache_alloc(pdrv, sector + i, &res);
+        if (run[i] == NULL) {
+            count = i;
+            goto out;
+        }
+    }
+
+    if (count == 1) {
+        res = cache_dev_read(pdrv, ent_data(run[0]), sector, 1);
+    } else {
+        res = cache_dev_read(pdrv, g_cache.burst, sector, count);
+        /* past the end of the drive maybe, the sector alone will do */
+        if (res != RES_OK) {
+            for (i = 1; i < count; i++) {
+                cache_drop(run[i]);
+            }
+            count = 1;
+            res = cache_dev_read(pdrv, ent_data(run[0]), sector, 1);
+        } else {
+            for (i = 0; i < count; i++) {
+                memcpy(ent_data(run[i]), g_cache.burst + i * CACHE_SS, CACHE_SS);
+            }
+            g_cache.stats.read_ahead += count - 1;
+        }
+    }
+
+    if (res == RES_OK) {
+        memcpy(buff, ent_data(run[0]), CACHE_SS);
+        g_cache.ra_next[pdrv] = sector + count;
+        return RES_OK;
+    }
+
+out:
+    for (i = 0; i < count; i++) {
+        cache_drop(run[i]);
+    }
+    return res;
+}
+
+static int cache_bypass(BYTE pdrv)
+{
+    return pdrv >= FF_VOLUMES || !(g_cache.attached & (1u << pdrv));
+}
+
+DRESULT fatfs_cache_read(BYTE pdrv, BYTE *buff, DWORD sector, UINT count)
+{
+    cache_ent_t *e;
+    DRESULT      res;
+    UINT         i;
+
+    if (cache_bypass(pdrv)) {
+        return disk_dev_read(pdrv, buff, sector, count);
+    }
+
+    if (aos_mutex_lock(&g_cache.lock, AOS_WAIT_FOREVER) != 0) {
+        return RES_ERROR;
+    }
+
+    if (g_cache.disabled) {
+        res = cache_dev_read(pdrv, buff, sector, count);
+    } else if (count == 1) {
+        e = cache_find(pdrv, sector);
+        if (e != NULL) {
+            memcpy(buff, ent_data(e), CACHE_SS);
+            cache_touch(e);
+            g_cache.stats.hits++;
+            res = RES_OK;
+        } else {
+            g_cache.stats.misses++;
+            res = cache_fill(pdrv, buff, sector);
+        }
+    } else {
+        g_cache.stats.misses += count;
+        res = cache_dev_read(pdrv, buff, sector, count);
+        for (i = 0; res == RES_OK && i < count; i++) {
+            e = cache_find(pdrv, sector + i);
+            if (e != NULL && (e->flags & CACHE_DIRTY)) {
+                memcpy(buff + i * CACHE_SS, ent_data(e), CACHE_SS);
+            }
+        }
+        g_cache.ra_next[pdrv] = sector + count;
+    }
+
+    aos_mutex_unlock(&g_cache.lock);
+    return res;
+}
+
+DRESULT fatfs_cache_write(BYTE pdrv, const BYTE *buff, DWORD sector, UINT count)
+{
+    cache_ent_t *e;
+    DRESULT      res = RES_OK;
+    UINT         i;
+
+    if (cache_bypass(pdrv)) {
+        return disk_dev_write(pdrv, buff, sector, count);
+    }
+
+    if (aos_mutex_lock(&g_cache.lock, AOS_WAIT_FOREVER) != 0) {
+        return RES_ERROR;
+    }
+
+    if (g_cache.disabled) {
+        res = cache_dev_write(pdrv, buff, sector, count);
+    } else if (count == 1) {
+        e = cache_find(pdrv, sector);
+        if (e == NULL) {
+            e = cache_alloc(pdrv, sector, &res);
+        } else {
+            cache_touch(e);
+        }
+
+        if (e != NULL) {
+            memcpy(ent_data(e), buff, CACHE_SS);
+            e->flags |= CACHE_DIRTY;
+        }
+    } else {
+        res = cache_dev_write(pdrv, buff, sector, count);
+        for (i = 0; res == RES_OK && i < count; i++) {
+            e = cache_find(pdrv, sector + i);
+            if (e != NULL) {
+                memcpy(ent_data(e), buff + i * CACHE_SS, CACHE_SS);
+                e->flags &= ~CACHE_DIRTY;
+            }
+        }
+    }
+
+    aos_mutex_unlock(&g_cache.lock);
+    return res;
+}
+
+/* write back the dirty sectors of pdrv, or of all drives if pdrv is CACHE_FREE */
+static DRESULT cache_flush(BYTE pdrv)
+{
+    cache_ent_t *e;
+    DRESULT      res;
+    int          i;
+
+    for (i = 0; i < FATFS_CACHE_SECTORS; i++) {
+        e = &g_cache.ents[i];
+        if ((e->flags & CACHE_DIRTY) && (pdrv == CACHE_FREE || e->pdrv == pdrv) &&
+            (res = cache_write_run(e)) != RES_OK) {
+            return res;
+        }
+    }
+
+    return RES_OK;
+}
+
+DRESULT fatfs_cache_flush(BYTE pdrv)
+{
+    DRESULT res;
+
+    if (cache_bypass(pdrv)) {
+        return RES_OK;
+    }
+
+    if (aos_mutex_lock(&g_cache.lock, AOS_WAIT_FOREVER) != 0) {
+        return RES_ERROR;
+    }
+
+    res = cache_flush(pdrv);
+
+    aos_mutex_unlock(&g_cache.lock);
+    return res;
+}
+
+DRESULT fatfs_cache_enable(int enable)
+{
+    DRESULT res = RES_OK;
+    int     i;
+
+    if (g_cache.users == 0) {
+        return RES_NOTRDY;
+    }
+
+    if (aos_mutex_lock(&g_cache.lock, AOS_WAIT_FOREVER) != 0) {
+        return RES_ERROR;
+    }
+
+    if (!enable && !g_cache.disabled) {
+        res = cache_flush(CACHE_FREE);
+        if (res == RES_OK) {
+            for (i = 0; i < FATFS_CACHE_SECTORS; i++) {
+                cache_drop(&g_cache.ents[i]);
+            }
+            g_cache.disabled = 1;
+        }
+    } else if (enable) {
+        g_cache.disabled = 0;
+    }
+
+    aos_mutex_unlock(&g_cache.lock);
+    return res;
+}
+
+int fatfs_cache_attach(BYTE pdrv)
+{
+    int i;
+
+    if (pdrv >= FF_VOLUMES) {
+        return -EINVAL;
+    }
+
+    if (g_cache.attached & (1u << pdrv)) {
+        return 0;
+    }
+
+    if (g_cache.users == 0) {
+        memset(&g_cache, 0, sizeof(g_cache));
+        g_cache.ents  = (cache_ent_t *)aos_malloc(sizeof(cache_ent_t) * FATFS_CACHE_SECTORS);
+        g_cache.data  = (BYTE *)aos_malloc(CACHE_SS * FATFS_CACHE_SECTORS);
+        g_cache.burst = (BYTE *)aos_malloc(CACHE_SS * FATFS_CACHE_BURST);
+        if (!g_cache.ents || !g_cache.data || !g_cache.burst ||
+            aos_mutex_new(&g_cache.lock) != 0) {
+            aos_free(g_cache.ents);
+            aos_free(g_cache.data);
+            aos_free(g_cache.burst);
+            g_cache.ents = NULL;
+            return -ENOMEM;
+        }
+
+        for (i = 0; i < FATFS_CACHE_SECTORS; i++) {
+            g_cache.ents[i].pdrv  = CACHE_FREE;
+            g_cache.ents[i].flags = 0;
+            lru_push(&g_cache.ents[i], 1);
+        }
+    }
+
+    g_cache.ra_next[pdrv] = 0;
+    g_cache.attached |= 1u << pdrv;
+    g_cache.users++;
+    return 0;
+}
+
+void fatfs_cache_detach(BYTE pdrv)
+{
+    cache_ent_t *e;
+    int          i;
+
+    if (cache_bypass(pdrv)) {
+        return;
+    }
+
+    if (aos_mutex_lock(&g_cache.lock, AOS_WAIT_FOREVER) == 0) {
+        cache_flush(pdrv);
+        for (i = 0; i < FATFS_CACHE_SECTORS; i++) {
+            e = &g_cache.ents[i];
+            if (e->pdrv == pdrv) {
+                cache_drop(e);
+            }
+        }
+        g_cache.attached &= ~(1u << pdrv);
+        aos_mutex_unlock(&g_cache.lock);
+    }
+
+    if (--g_cache.users == 0) {
+        aos_mutex_free(&g_cache.lock);
+        aos_free(g_cache.ents);
+        aos_free(g_cache.data);
+        aos_free(g_cache.burst);
+        g_cache.ents = NULL;
+    }
+}
+
+void fatfs_cache_stats(fatfs_cache_stats_t *stats)
+{
+    if (g_cache.users == 0 || aos_mutex_lock(&g_cache.lock, AOS_WAIT_FOREVER) != 0) {
+        memset(stats, 0, sizeof(*stats));
+        return;
+    }
+
+    *stats = g_cache.stats;
+    aos_mutex_unlock(&g_cache.lock);
+}
+#endif
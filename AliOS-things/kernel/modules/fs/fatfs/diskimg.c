@@ -0,0 +1,137 @@
+/*
+ * Copyright (C) 2015-2017 Alibaba Group Holding Limited
+ */
+
+#ifdef CONFIG_AOS_FATFS_SUPPORT_IMG
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "fatfs_diskio.h"
+#include "ff.h"
+
+/*
+ * Disk image driver for the host: the drive is the file IMG_PATH of
+ * IMG_SECTORS sectors, created zeroed on first use, so the volume outlives
+ * the process like a card would. Each call is one transfer of count
+ * sectors, as it would be for the SD driver.
+ */
+#ifndef CONFIG_AOS_FATFS_IMG_PATH
+#define IMG_PATH        "./aos_fatfs.img"
+#else
+#define IMG_PATH        CONFIG_AOS_FATFS_IMG_PATH
+#endif
+
+#ifndef CONFIG_AOS_FATFS_IMG_SECTORS
+#define IMG_SECTORS     16384
+#else
+#define IMG_SECTORS     CONFIG_AOS_FATFS_IMG_SECTORS
+#endif
+
+#define IMG_SECTOR_SIZE FF_MAX_SS
+
+static int g_img_fd = -1;
+
+DSTATUS IMG_disk_initialize(void)
+{
+    int fd;
+
+    if (g_img_fd >= 0) {
+        return 0;
+    }
+
+    fd = open(IMG_PATH, O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
+        return STA_NOINIT;
+    }
+
+    if (lseek(fd, 0, SEEK_END) < (off_t)IMG_SECTORS * IMG_SECTOR_SIZE &&
+        ftruncate(fd, (off_t)IMG_SECTORS * IMG_SECTOR_SIZE) != 0) {
+        close(fd);
+        return STA_NOINIT;
+    }
+
+    g_img_fd = fd;
+    return 0;
+}
+
+DSTATUS IMG_disk_status(void)
+{
+    return (g_img_fd >= 0) ? 0 : STA_NOINIT;
+}
+
+static int img_range_ok(DWORD sector, UINT count)
+{
+    return sector < IMG_SECTORS && count <= IMG_SECTORS - sector;
+}
+
+DRESULT IMG_disk_read(BYTE *buff, DWORD sector, UINT count)
+{
+    size_t len = (size_t)count * IMG_SECTOR_SIZE;
+
+    if (g_img_fd < 0) {
+        return RES_NOTRDY;
+    }
+
+    if (!img_range_ok(sector, count)) {
+        return RES_PARERR;
+    }
+
+    if (pread(g_img_fd, buff, len, (off_t)sector * IMG_SECTOR_SIZE) != len) {
+        return RES_ERROR;
+    }
+
+    return RES_OK;
+}
+
+DRESULT IMG_disk_write(const BYTE *buff, DWORD sector, UINT count)
+{
+    size_t len = (size_t)count * IMG_SECTOR_SIZE;
+
+    if (g_img_fd < 0) {
+        return RES_NOTRDY;
+    }
+
+    if (!img_range_ok(sector, count)) {
+        return RES_PARERR;
+    }
+
+    if (pwrite(g_img_fd, buff, len, (off_t)sector * IMG_SECTOR_SIZE) != len) {
+        return RES_ERROR;
+    }
+
+    return RES_OK;
+}
+
+DRESULT IMG_disk_ioctl(BYTE cmd, void *buff)
+{
+    if (g_img_fd < 0) {
+        return RES_NOTRDY;
+    }
+
+    switch (cmd) {
+        case CTRL_SYNC:
+            return (fsync(g_img_fd) == 0) ? RES_OK : RES_ERROR;
+
+        case GET_SECTOR_COUNT:
+            *(DWORD *)buff = IMG_SECTORS;
+            return RES_OK;
+
+        case GET_SECTOR_SIZE:
+            *(WORD *)buff = IMG_SECTOR_SIZE;
+            return RES_OK;
+
+        case GET_BLOCK_SIZE:
+            *(DWORD *)buff = 1;
+            return RES_OK;
+
+        case GET_FORMAT_OPTION:
+            *(BYTE *)buff = FM_ANY;
+            return RES_OK;
+
+        default:
+            break;
+    }
+
+    return RES_PARERR;
+}
+#endif
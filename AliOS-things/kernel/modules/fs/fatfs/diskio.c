@@ -118,6 +118,11 @@ DSTATUS ff_disk_status(BYTE pdrv)
             return RAM_disk_status();
 #endif
 
+#ifdef CONFIG_AOS_FATFS_SUPPORT_IMG
+        case DEV_IMG:
+            return IMG_disk_status();
+#endif
+
         default:
             break;
     }
@@ -141,13 +146,19 @@ DSTATUS ff_disk_initialize(BYTE pdrv)
         case DEV_RAM:
             return RAM_disk_initialize();
 #endif
+
+#ifdef CONFIG_AOS_FATFS_SUPPORT_IMG
+        case DEV_IMG:
+            return IMG_disk_initialize();
+#endif
+
         default:
             break;
     }
     return STA_NOINIT;
 }
 
-DRESULT ff_disk_read(BYTE pdrv, BYTE *buff, DWORD sector, UINT count)
+DRESULT disk_dev_read(BYTE pdrv, BYTE *buff, DWORD sector, UINT count)
 {
     switch (pdrv) {
 #ifdef CONFIG_AOS_FATFS_SUPPORT_MMC
@@ -165,13 +176,18 @@ DRESULT ff_disk_read(BYTE pdrv, BYTE *buff, DWORD sector, UINT count)
             return RAM_disk_read(buff, sector, count);
 #endif
 
+#ifdef CONFIG_AOS_FATFS_SUPPORT_IMG
+        case DEV_IMG:
+            return IMG_disk_read(buff, sector, count);
+#endif
+
         default:
             break;
     }
     return RES_PARERR;
 }
 
-DRESULT ff_disk_write(BYTE pdrv, const BYTE *buff, DWORD sector, UINT count)
+DRESULT disk_dev_write(BYTE pdrv, const BYTE *buff, DWORD sector, UINT count)
 {
     switch (pdrv) {
 #ifdef CONFIG_AOS_FATFS_SUPPORT_MMC
@@ -189,13 +205,18 @@ DRESULT ff_disk_write(BYTE pdrv, const BYTE *buff, DWORD sector, UINT count)
             return RAM_disk_write(buff, sector, count);
 #endif
 
+#ifdef CONFIG_AOS_FATFS_SUPPORT_IMG
+        case DEV_IMG:
+            return IMG_disk_write(buff, sector, count);
+#endif
+
         default:
             break;
     }
     return RES_PARERR;
 }
 
-DRESULT ff_disk_ioctl(BYTE pdrv, BYTE cmd, void *buff)
+DRESULT disk_dev_ioctl(BYTE pdrv, BYTE cmd, void *buff)
 {
     switch (pdrv) {
 #ifdef CONFIG_AOS_FATFS_SUPPORT_MMC
@@ -213,8 +234,45 @@ DRESULT ff_disk_ioctl(BYTE pdrv, BYTE cmd, void *buff)
             return RAM_disk_ioctl(cmd, buff);
 #endif
 
+#ifdef CONFIG_AOS_FATFS_SUPPORT_IMG
+        case DEV_IMG:
+            return IMG_disk_ioctl(cmd, buff);
+#endif
+
         default:
             break;
     }
     return RES_PARERR;
 }
+
+DRESULT ff_disk_read(BYTE pdrv, BYTE *buff, DWORD sector, UINT count)
+{
+#if FATFS_CACHE_SECTORS > 0
+    return fatfs_cache_read(pdrv, buff, sector, count);
+#else
+    return disk_dev_read(pdrv, buff, sector, count);
+#endif
+}
+
+DRESULT ff_disk_write(BYTE pdrv, const BYTE *buff, DWORD sector, UINT count)
+{
+#if FATFS_CACHE_SECTORS > 0
+    return fatfs_cache_write(pdrv, buff, sector, count);
+#else
+    return disk_dev_write(pdrv, buff, sector, count);
+#endif
+}
+
+DRESULT ff_disk_ioctl(BYTE pdrv, BYTE cmd, void *buff)
+{
+#if FATFS_CACHE_SECTORS > 0
+    DRESULT res;
+
+    /* f_sync() and f_close() end here, the written sectors must reach the drive */
+    if (cmd == CTRL_SYNC && (res = fatfs_cache_flush(pdrv)) != RES_OK) {
+        return res;
+    }
+#endif
+
+    return disk_dev_ioctl(pdrv, cmd, buff);
+}
@@ -34,11 +34,14 @@ typedef struct _fat_dir_t
 static fsid_map_t g_fsid[] = {
         { DEV_MMC, MMC_MOUNTPOINT, MMC_PARTITION_ID },
         { DEV_USB, USB_MOUNTPOINT, USB_PARTITION_ID },
-        { DEV_RAM, RAM_MOUNTPOINT, RAM_PARTITION_ID }
+        { DEV_RAM, RAM_MOUNTPOINT, RAM_PARTITION_ID },
+        { DEV_IMG, IMG_MOUNTPOINT, IMG_PARTITION_ID }
 };
 
 static FATFS *g_fatfs[FF_VOLUMES] = {0};
 
+void fatfs_bench_init(void);
+
 #if FF_USE_LFN == 3 /* Dynamic memory allocation */
 
 /*------------------------------------------------------------------------*/
@@ -256,12 +259,12 @@ static int fatfs_close(file_t *fp)
 
 static ssize_t fatfs_read(file_t *fp, char *buf, size_t len)
 {
-    ssize_t nbytes;
+    UINT nbytes;
     int ret = -EPERM;
     FIL *f = (FIL *)(fp->f_arg);
 
     if (f) {
-        if ((ret = f_read(f, (void *)buf, (UINT)len, (UINT *)&nbytes)) == FR_OK)
+        if ((ret = f_read(f, (void *)buf, (UINT)len, &nbytes)) == FR_OK)
             return nbytes;
     }
 
@@ -270,12 +273,12 @@ static ssize_t fatfs_read(file_t *fp, char *buf, size_t len)
 
 static ssize_t fatfs_write(file_t *fp, const char *buf, size_t len)
 {
-    ssize_t nbytes;
+    UINT nbytes;
     int ret = -EPERM;
     FIL *f = (FIL *)(fp->f_arg);
 
     if (f) {
-        if ((ret = f_write(f, (void *)buf, (UINT)len, (UINT *)&nbytes)) == FR_OK)
+        if ((ret = f_write(f, (void *)buf, (UINT)len, &nbytes)) == FR_OK)
             return nbytes;
     }
 
@@ -316,6 +319,12 @@ static int fatfs_sync(file_t *fp)
 
     if (f) {
         ret = f_sync(f);
+#if FATFS_CACHE_SECTORS > 0
+        /* f_sync() leaves the cache alone unless f was modified */
+        if (ret == FR_OK && fatfs_cache_flush(f->obj.fs->pdrv) != RES_OK) {
+            ret = FR_DISK_ERR;
+        }
+#endif
     }
 
     return ret;
@@ -494,6 +503,13 @@ static int fatfs_dev_register(int pdrv)
     if (!fatfs)
         return -ENOMEM;
 
+#if FATFS_CACHE_SECTORS > 0
+    if ((err = fatfs_cache_attach(pdrv)) != 0) {
+        aos_free(fatfs);
+        return err;
+    }
+#endif
+
     err = f_mount(fatfs, g_fsid[index].id, 1);
 
     if (err == FR_OK) {
@@ -528,6 +544,9 @@ static int fatfs_dev_register(int pdrv)
     }
 #endif
 error:
+#if FATFS_CACHE_SECTORS > 0
+    fatfs_cache_detach(pdrv);
+#endif
     aos_free(fatfs);
     return err;
 }
@@ -545,6 +564,9 @@ static int fatfs_dev_unregister(int pdrv)
     err = aos_unregister_fs(g_fsid[index].root);
     if (err == FR_OK) {
         f_mount(NULL, g_fsid[index].id, 1);
+#if FATFS_CACHE_SECTORS > 0
+        fatfs_cache_detach(pdrv);
+#endif
         aos_free(g_fatfs[index]);
         g_fatfs[index] = NULL;
     }
@@ -571,6 +593,15 @@ int fatfs_register(void)
         return err;
 #endif
 
+#ifdef CONFIG_AOS_FATFS_SUPPORT_IMG
+    if ((err = fatfs_dev_register(DEV_IMG)) != FR_OK)
+        return err;
+#endif
+
+#if defined(CONFIG_AOS_CLI) && defined(CONFIG_AOS_BENCH) && FATFS_CACHE_SECTORS > 0
+    fatfs_bench_init();
+#endif
+
     return err;
 }
 
@@ -593,5 +624,10 @@ int fatfs_unregister(void)
         return err;
 #endif
 
+#ifdef CONFIG_AOS_FATFS_SUPPORT_IMG
+    if ((err = fatfs_dev_unregister(DEV_IMG)) != FR_OK)
+        return err;
+#endif
+
     return err;
 }
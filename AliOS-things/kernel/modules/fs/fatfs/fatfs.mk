@@ -4,9 +4,23 @@ $(NAME)_TYPE        := kernel
 
 $(NAME)_SOURCES     := fatfs.c
 $(NAME)_SOURCES     += diskio.c
+$(NAME)_SOURCES     += diskcache.c
+$(NAME)_SOURCES     += diskimg.c
 $(NAME)_SOURCES     += ff/ff.c
 $(NAME)_SOURCES     += ff/ffunicode.c
 
+# "fatfs_cache=N" on the make line turns on a write-back cache of N sectors
+ifneq ($(fatfs_cache),)
+GLOBAL_DEFINES      += CONFIG_AOS_FATFS_CACHE_SECTORS=$(fatfs_cache)
+endif
+
+# "aos_bench=1" on the make line adds the benchmark cli commands, they
+# compare the cache off and on, so they need "fatfs_cache=N" as well
+ifeq ($(aos_bench),1)
+$(NAME)_SOURCES     += fatfs_bench.c
+GLOBAL_DEFINES      += CONFIG_AOS_BENCH
+endif
+
 #default gcc
 ifeq ($(COMPILER),)
 $(NAME)_CFLAGS      += -Wall -Werror
@@ -0,0 +1,180 @@
+/*
+ * Copyright (C) 2015-2017 Alibaba Group Holding Limited
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <sys/fcntl.h>
+#include <aos/aos.h>
+#include "fatfs_diskio.h"
+
+#if defined(CONFIG_AOS_CLI) && FATFS_CACHE_SECTORS > 0
+/*
+ * "fatfs_bench [dir]": the drive transfers of a FatFs volume with the
+ * sector cache off, then on. A file of FBENCH_FILE_SIZE bytes is written
+ * and read back in FBENCH_CHUNK byte calls, then FBENCH_FILES small files
+ * are created, looked up and removed in a directory. The default dir is
+ * the mount point of the disk image if there is one, of the card if not.
+ */
+#define FBENCH_FILE_SIZE  (64 * 1024)
+#define FBENCH_CHUNK      128
+#define FBENCH_FILES      32
+
+#ifdef CONFIG_AOS_FATFS_SUPPORT_IMG
+#define FBENCH_DIR        IMG_MOUNTPOINT
+#else
+#define FBENCH_DIR        MMC_MOUNTPOINT
+#endif
+
+static char g_fbench_buf[FBENCH_CHUNK];
+
+static int fbench_write(const char *dir)
+{
+    char path[64];
+    int  fd;
+    int  off;
+    int  ret = 0;
+
+    snprintf(path, sizeof(path), "%s/fbench.bin", dir);
+    fd = aos_open(path, O_RDWR | O_CREAT | O_TRUNC);
+    if (fd < 0) {
+        return fd;
+    }
+
+    for (off = 0; off < FBENCH_FILE_SIZE && ret == 0; off += FBENCH_CHUNK) {
+        memset(g_fbench_buf, off / FBENCH_CHUNK, sizeof(g_fbench_buf));
+        if (aos_write(fd, g_fbench_buf, FBENCH_CHUNK) != FBENCH_CHUNK) {
+            ret = -1;
+        }
+    }
+
+    if (ret == 0) {
+        ret = aos_sync(fd);
+    }
+
+    aos_close(fd);
+    return ret;
+}
+
+static int fbench_read(const char *dir)
+{
+    char path[64];
+    int  fd;
+    int  off;
+    int  ret = 0;
+
+    snprintf(path, sizeof(path), "%s/fbench.bin", dir);
+    fd = aos_open(path, O_RDONLY);
+    if (fd < 0) {
+        return fd;
+    }
+
+    for (off = 0; off < FBENCH_FILE_SIZE && ret == 0; off += FBENCH_CHUNK) {
+        if (aos_read(fd, g_fbench_buf, FBENCH_CHUNK) != FBENCH_CHUNK ||
+            g_fbench_buf[FBENCH_CHUNK - 1] != (char)(off / FBENCH_CHUNK)) {
+            ret = -1;
+        }
+    }
+
+    aos_close(fd);
+    return ret;
+}
+
+static int fbench_files(const char *dir)
+{
+    struct stat st;
+    char        path[64];
+    int         fd;
+    int         i;
+
+    snprintf(path, sizeof(path), "%s/fbench.d", dir);
+    aos_mkdir(path);
+
+    for (i = 0; i < FBENCH_FILES; i++) {
+        snprintf(path, sizeof(path), "%s/fbench.d/file_%02d.txt", dir, i);
+        fd = aos_open(path, O_RDWR | O_CREAT | O_TRUNC);
+        if (fd < 0) {
+            return fd;
+        }
+        aos_write(fd, path, strlen(path));
+        aos_close(fd);
+    }
+
+    for (i = 0; i < FBENCH_FILES; i++) {
+        snprintf(path, sizeof(path), "%s/fbench.d/file_%02d.txt", dir, i);
+        if (aos_stat(path, &st) != 0) {
+            return -1;
+        }
+    }
+
+    for (i = 0; i < FBENCH_FILES; i++) {
+        snprintf(path, sizeof(path), "%s/fbench.d/file_%02d.txt", dir, i);
+        aos_unlink(path);
+    }
+
+    return 0;
+}
+
+static const struct {
+    const char *name;
+    int       (*run)(const char *dir);
+} fbench_runs[] = {
+    { "write", fbench_write },
+    { "read",  fbench_read },
+    { "files", fbench_files },
+};
+
+static void handle_fatfs_bench_cmd(char *pwbuf, int blen, int argc, char **argv)
+{
+    const char         *dir = (argc > 1) ? argv[1] : FBENCH_DIR;
+    fatfs_cache_stats_t s0;
+    fatfs_cache_stats_t s1;
+    long long           start;
+    int                 cache;
+    int                 r;
+
+    /* every run starts cold, turning the cache off writes back what it left */
+    if (fatfs_cache_enable(0) != RES_OK) {
+        aos_cli_printf("fatfs_bench: no cache\r\n");
+        return;
+    }
+
+    for (cache = 0; cache <= 1; cache++) {
+        for (r = 0; r < sizeof(fbench_runs) / sizeof(fbench_runs[0]); r++) {
+            fatfs_cache_enable(cache);
+            fatfs_cache_stats(&s0);
+            start = aos_now_ms();
+            if (fbench_runs[r].run(dir) != 0) {
+                aos_cli_printf("fatfs_bench: %s in %s failed\r\n", fbench_runs[r].name, dir);
+                fatfs_cache_enable(1);
+                return;
+            }
+            fatfs_cache_enable(0);
+            fatfs_cache_stats(&s1);
+
+            aos_cli_printf("%-5s cache %-3s %5d ms, %5d reads %5d sectors, "
+                           "%5d writes %5d sectors, %5d hits\r\n",
+                           fbench_runs[r].name, cache ? "on" : "off",
+                           (int)(aos_now_ms() - start),
+                           (int)(s1.dev_reads - s0.dev_reads),
+                           (int)(s1.dev_read_sectors - s0.dev_read_sectors),
+                           (int)(s1.dev_writes - s0.dev_writes),
+                           (int)(s1.dev_write_sectors - s0.dev_write_sectors),
+                           (int)(s1.hits - s0.hits));
+        }
+    }
+
+    fatfs_cache_enable(1);
+}
+
+static struct cli_command fatfs_bench_cmd = {
+    "fatfs_bench",
+    "fatfs drive transfers with the sector cache off and on",
+    handle_fatfs_bench_cmd
+};
+
+void fatfs_bench_init(void)
+{
+    aos_cli_register_command(&fatfs_bench_cmd);
+}
+#endif
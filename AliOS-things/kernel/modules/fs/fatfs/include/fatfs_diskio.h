@@ -9,6 +9,7 @@
  extern "C" {
 #endif
 
+#include <stdint.h>
 #include "diskio.h"
 
 /* Definitions of physical driver number of each drive */
@@ -25,6 +26,75 @@
 #define RAM_MOUNTPOINT      "/ramdisk"
 #define RAM_PARTITION_ID    "2:"
 
+#define DEV_IMG 3   /* Map the host disk image to physical drive 3 */
+
+#define IMG_MOUNTPOINT      "/img"
+#define IMG_PARTITION_ID    "3:"
+
+/*
+ * The sectors of the cache shared by the mounted drives, allocated when the
+ * first drive mounts. 0 disables it, "fatfs_cache=N" on the make line sets it.
+ */
+#ifndef CONFIG_AOS_FATFS_CACHE_SECTORS
+#define FATFS_CACHE_SECTORS 0
+#else
+#define FATFS_CACHE_SECTORS CONFIG_AOS_FATFS_CACHE_SECTORS
+#endif
+
+/* The most sectors the cache reads ahead or writes back in one transfer */
+#ifndef CONFIG_AOS_FATFS_CACHE_BURST
+#define FATFS_CACHE_BURST   4
+#else
+#define FATFS_CACHE_BURST   CONFIG_AOS_FATFS_CACHE_BURST
+#endif
+
+/* The transfers between the sector cache and the drivers */
+typedef struct {
+    uint32_t hits;              /* Sectors read from the cache */
+    uint32_t misses;            /* Sectors read from the drive for a caller */
+    uint32_t read_ahead;        /* Sectors read ahead of a sequential reader */
+    uint32_t write_backs;       /* Dirty sectors written back */
+    uint32_t dev_reads;         /* Read transfers to the drives */
+    uint32_t dev_read_sectors;  /* Sectors read from the drives */
+    uint32_t dev_writes;        /* Write transfers to the drives */
+    uint32_t dev_write_sectors; /* Sectors written to the drives */
+} fatfs_cache_stats_t;
+
+/* the drivers, below the cache */
+DRESULT disk_dev_read(BYTE pdrv, BYTE *buff, DWORD sector, UINT count);
+DRESULT disk_dev_write(BYTE pdrv, const BYTE *buff, DWORD sector, UINT count);
+DRESULT disk_dev_ioctl(BYTE pdrv, BYTE cmd, void *buff);
+
+/*
+ * Take pdrv into the cache before it is mounted, the first drive
+ * allocates the FATFS_CACHE_SECTORS shared by all. Returns 0 or -ENOMEM.
+ */
+int fatfs_cache_attach(BYTE pdrv);
+
+/* write back and drop the sectors of pdrv, the last drive frees the cache */
+void fatfs_cache_detach(BYTE pdrv);
+
+/* read/write count sectors through the cache, as disk_read()/disk_write() */
+DRESULT fatfs_cache_read(BYTE pdrv, BYTE *buff, DWORD sector, UINT count);
+DRESULT fatfs_cache_write(BYTE pdrv, const BYTE *buff, DWORD sector, UINT count);
+
+/* write back the dirty sectors of pdrv, merging adjacent ones */
+DRESULT fatfs_cache_flush(BYTE pdrv);
+
+/* turn the cache off, writing back and dropping every sector, or on again */
+DRESULT fatfs_cache_enable(int enable);
+
+/* copy the counters since the cache was allocated */
+void fatfs_cache_stats(fatfs_cache_stats_t *stats);
+
+#ifdef CONFIG_AOS_FATFS_SUPPORT_IMG
+DSTATUS IMG_disk_initialize(void);
+DSTATUS IMG_disk_status(void);
+DRESULT IMG_disk_read(BYTE *buff, DWORD sector, UINT count);
+DRESULT IMG_disk_write(const BYTE *buff, DWORD sector, UINT count);
+DRESULT IMG_disk_ioctl(BYTE cmd, void *buff);
+#endif
+
 
 #ifdef __cplusplus
  }
@@ -1,6 +1,8 @@
 src = Split('''
     fatfs.c
     diskio.c
+    diskcache.c
+    diskimg.c
     ff/ff.c
     ff/ffunicode.c
 ''')
@@ -12,3 +14,10 @@ component.add_cflags('-Werror')
 component.add_global_macros('AOS_FATFS')
 component.add_global_includes('include')
 component.add_global_includes('ff/include')
+
+if aos_global_config.get('fatfs_cache'):
+    component.add_global_macros('CONFIG_AOS_FATFS_CACHE_SECTORS=' + aos_global_config.get('fatfs_cache'))
+
+if aos_global_config.get('aos_bench') == '1':
+    component.add_sources('fatfs_bench.c')
+    component.add_global_macros('CONFIG_AOS_BENCH')
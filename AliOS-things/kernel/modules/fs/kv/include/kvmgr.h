@@ -5,6 +5,8 @@
 #ifndef _key_value_h_
 #define _key_value_h_
 
+#include <stdint.h>
+
 #if defined(__cplusplus) /* If this is a C++ compiler, use C linkage */
 extern "C"
 {
@@ -24,6 +26,56 @@ extern "C"
 #define KV_PTN    CONFIG_AOS_KV_PTN
 #endif
 
+/* The number of values kept in RAM by the read cache, 0 disables it */
+#ifndef CONFIG_AOS_KV_CACHE_NUM
+#define KV_CACHE_NUM    4
+#else
+#define KV_CACHE_NUM    CONFIG_AOS_KV_CACHE_NUM
+#endif
+
+/* The size of the log buffer combining aos_kv_set() calls without sync, 0 disables it */
+#ifndef CONFIG_AOS_KV_LOG_SIZE
+#define KV_LOG_SIZE     256
+#else
+#define KV_LOG_SIZE     CONFIG_AOS_KV_LOG_SIZE
+#endif
+
+/* The number of items the garbage collection moves between two lock releases */
+#ifndef CONFIG_AOS_KV_GC_STEP
+#define KV_GC_STEP      4
+#else
+#define KV_GC_STEP      CONFIG_AOS_KV_GC_STEP
+#endif
+
+/* The priority of the garbage collection task, below the applications by default */
+#ifndef CONFIG_AOS_KV_GC_PRI
+#define KV_GC_PRI       (AOS_DEFAULT_APP_PRI + 4)
+#else
+#define KV_GC_PRI       CONFIG_AOS_KV_GC_PRI
+#endif
+
+/*
+ * The flash traffic of the kv module since aos_kv_init(). The write
+ * amplification is flash_write_bytes / user_bytes.
+ */
+typedef struct {
+    uint32_t flash_reads;           /* The number of flash reads */
+    uint32_t flash_read_bytes;      /* The bytes read from flash */
+    uint32_t flash_writes;          /* The number of flash writes */
+    uint32_t flash_write_bytes;     /* The bytes written to flash */
+    uint32_t flash_erases;          /* The number of blocks erased */
+    uint32_t cache_hits;            /* The lookups served by the value cache */
+    uint32_t cache_misses;          /* The lookups which went to flash */
+    uint32_t user_bytes;            /* The bytes of keys and values stored */
+    uint32_t log_items;             /* The items which went through the log buffer */
+    uint32_t log_flushes;           /* The times the log buffer was programmed */
+    uint32_t gc_runs;               /* The blocks collected */
+    uint32_t gc_steps;              /* The steps of the collections */
+    uint32_t gc_moved_bytes;        /* The bytes of live items moved */
+    uint32_t gc_pause_max_us;       /* The longest step, in us */
+    uint32_t gc_pause_total_us;     /* The time of all steps, in us */
+} kv_stats_t;
+
 /**
  * @brief init the kv module.
  *
@@ -45,6 +97,27 @@ int aos_kv_init(void);
  */
 void aos_kv_deinit(void);
 
+/**
+ * @brief get the flash and cache statistics of the kv module.
+ *
+ * @param[out] stats  the statistics, all 0 if the module is not initialized.
+ *
+ * @retval none.
+ */
+void aos_kv_stats(kv_stats_t *stats);
+
+/**
+ * @brief program the values set without sync to flash.
+ *
+ * @param[in] none.
+ *
+ * @note: aos_kv_set() with sync 0 keeps the value in RAM until the log
+ *        buffer is full, another call has sync 1, or this is called. A
+ *        reset loses these values, the previous ones are kept.
+ * @retval  0 on success, negative error on failure.
+ */
+int aos_kv_sync(void);
+
 #if defined(__cplusplus) /* If this is a C++ compiler, use C linkage */
 }
 #endif
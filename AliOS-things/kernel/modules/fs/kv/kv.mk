@@ -4,6 +4,12 @@ $(NAME)_TYPE        := kernel
 $(NAME)_SOURCES     := kvmgr.c
 $(NAME)_COMPONENTS  += log
 
+# "aos_bench=1" on the make line adds the benchmark cli commands
+ifeq ($(aos_bench),1)
+$(NAME)_SOURCES     += kv_bench.c
+GLOBAL_DEFINES      += CONFIG_AOS_BENCH
+endif
+
 #default gcc
 ifeq ($(COMPILER),)
 $(NAME)_CFLAGS      += -Wall -Werror
@@ -0,0 +1,146 @@
+/*
+ * Copyright (C) 2015-2017 Alibaba Group Holding Limited
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <aos/aos.h>
+#include "kvmgr.h"
+
+#ifdef CONFIG_AOS_CLI
+/*
+ * "kv_bench": get and set rates of KVB_KEYS keys with KVB_VAL_LEN byte
+ * values, and the flash traffic per operation. The sets rewrite every key
+ * with a new value, so once the partition is full they include the GC,
+ * "aset" runs them unsynced through the write log and syncs at the end.
+ * Set runs also print the write amplification, flash bytes written per
+ * key and value byte, and the GC pauses.
+ * The gets go round all the keys, more than the cache holds, then round
+ * KVB_HOT_KEYS only. The keys are deleted at the end, other keys are left
+ * alone.
+ */
+#define KVB_KEYS        16
+#define KVB_HOT_KEYS    2
+#define KVB_VAL_LEN     32
+#define KVB_ROUNDS      64
+
+static const struct {
+    const char *name;
+    int         set;            /* 0 get, 1 synced set, 2 unsynced set */
+    int         keys;
+} kvb_runs[] = {
+    { "set", 1, KVB_KEYS },
+    { "aset", 2, KVB_KEYS },
+    { "get", 0, KVB_KEYS },
+    { "hot", 0, KVB_HOT_KEYS },
+};
+
+static void kvb_key(char *key, uint8_t i)
+{
+    snprintf(key, 16, "kvbench_%02d", (int)i);
+}
+
+static void kvb_report(const char *name, int ops, long long ms,
+                       const kv_stats_t *s0, const kv_stats_t *s1)
+{
+    aos_cli_printf("%-4s %6d ops/s, per op %3d.%02d reads %5d bytes, "
+                   "%d.%02d writes, %d erases\r\n", name,
+                   (int)(ops * 1000LL / (ms > 0 ? ms : 1)),
+                   (int)((s1->flash_reads - s0->flash_reads) / ops),
+                   (int)((s1->flash_reads - s0->flash_reads) * 100 / ops % 100),
+                   (int)((s1->flash_read_bytes - s0->flash_read_bytes) / ops),
+                   (int)((s1->flash_writes - s0->flash_writes) / ops),
+                   (int)((s1->flash_writes - s0->flash_writes) * 100 / ops % 100),
+                   (int)(s1->flash_erases - s0->flash_erases));
+}
+
+static void kvb_report_set(const kv_stats_t *s0, const kv_stats_t *s1)
+{
+    uint32_t user = s1->user_bytes - s0->user_bytes;
+    uint32_t flash = s1->flash_write_bytes - s0->flash_write_bytes;
+    uint32_t steps = s1->gc_steps - s0->gc_steps;
+
+    user = user > 0 ? user : 1;
+    aos_cli_printf("     write amplification %d.%02d, %d log flushes, "
+                   "gc %d runs %d steps, pause avg %d max %d us\r\n",
+                   (int)(flash / user), (int)(flash * 100ULL / user % 100),
+                   (int)(s1->log_flushes - s0->log_flushes),
+                   (int)(s1->gc_runs - s0->gc_runs), (int)steps,
+                   (int)(steps ? (s1->gc_pause_total_us - s0->gc_pause_total_us) / steps : 0),
+                   (int)s1->gc_pause_max_us);
+}
+
+static int kvb_run(int set, int keys)
+{
+    char       key[16];
+    char       val[KVB_VAL_LEN];
+    int        len;
+    int        round;
+    int        i;
+    int        ret;
+
+    for (round = 0; round < KVB_ROUNDS; round++) {
+        for (i = 0; i < keys; i++) {
+            kvb_key(key, i);
+            if (set) {
+                memset(val, 'a' + (round + i) % 26, sizeof(val));
+                ret = aos_kv_set(key, val, sizeof(val), set == 1);
+            } else {
+                len = sizeof(val);
+                ret = aos_kv_get(key, val, &len);
+            }
+
+            if (ret != 0) {
+                aos_cli_printf("kv_bench: %s %s failed %d\r\n", set ? "set" : "get", key, ret);
+                return ret;
+            }
+        }
+    }
+
+    return set == 2 ? aos_kv_sync() : 0;
+}
+
+static void handle_kv_bench_cmd(char *pwbuf, int blen, int argc, char **argv)
+{
+    kv_stats_t s0;
+    kv_stats_t s1;
+    long long  start;
+    long long  ms;
+    char       key[16];
+    int        r;
+    int        i;
+
+    for (r = 0; r < sizeof(kvb_runs) / sizeof(kvb_runs[0]); r++) {
+        aos_kv_stats(&s0);
+        start = aos_now_ms();
+        if (kvb_run(kvb_runs[r].set, kvb_runs[r].keys) != 0) {
+            goto out;
+        }
+        ms = aos_now_ms() - start;
+        aos_kv_stats(&s1);
+        kvb_report(kvb_runs[r].name, KVB_ROUNDS * kvb_runs[r].keys, ms, &s0, &s1);
+        if (kvb_runs[r].set) {
+            kvb_report_set(&s0, &s1);
+        }
+    }
+
+    aos_cli_printf("cache %d hits %d misses\r\n", (int)s1.cache_hits, (int)s1.cache_misses);
+
+out:
+    for (i = 0; i < KVB_KEYS; i++) {
+        kvb_key(key, i);
+        aos_kv_del(key);
+    }
+}
+
+static struct cli_command kv_bench_cmd = {
+    "kv_bench",
+    "kv get/set rate, flash operations per call and write amplification",
+    handle_kv_bench_cmd
+};
+
+void kv_bench_init(void)
+{
+    aos_cli_register_command(&kv_bench_cmd);
+}
+#endif
@@ -49,14 +49,20 @@ typedef enum {
 #define KV_ALIGN_MASK           ~(sizeof(void *) - 1)       /* The mask of key-value store alignment */
 #define KV_GC_RESERVED          1                           /* The reserved block for garbage collection */
 #define KV_GC_STACK_SIZE        1024
+#define KV_WEAR_DELTA           32                          /* The erase count spread which moves cold data */
 
 #define KV_SELF_REMOVE          0
 #define KV_ORIG_REMOVE          1
+
+/* Defination of the RAM index */
+#define KV_INDEX_BUCKETS        32                          /* The number of hash buckets, power of 2 */
+#define KV_INDEX_GROW           16                          /* The number of entries the index grows by */
+
 /* Flash block header description */
 typedef struct _block_header_t {
     uint8_t     magic;          /* The magic number of block */
     uint8_t     state;          /* The state of the block */
-    uint8_t     reserved[2];
+    uint16_t    erase_cnt;      /* The times the block was erased */
 } __attribute__((packed)) block_hdr_t;
 
 /* Key-value item header description */
@@ -75,11 +81,37 @@ typedef struct _kv_item_t {
     char       *store;          /* The store buffer for key-value */
     uint16_t    len;            /* The length of the buffer */
     uint16_t    pos;            /* The store position of the key-value item */
+    uint16_t    idx;            /* The index entry + 1 which found the item, 0 if none */
 } kv_item_t;
 
+/*
+ * RAM index entry of a key-value item. The entries of a hash bucket and
+ * the free ones are chained by entry number + 1, the key itself stays on
+ * flash, tag and key_len only tell which items are worth reading.
+ */
+typedef struct _kv_index_t {
+    uint16_t    pos;            /* The store position of the key-value item */
+    uint16_t    tag;            /* The high bits of the key hash */
+    uint16_t    val_len;        /* The length of the value */
+    uint16_t    next;           /* The next entry + 1 in the bucket or free list */
+    uint8_t     key_len;        /* The length of the key */
+    uint8_t     crc;            /* The crc-8 value of the key-value item */
+} kv_index_t;
+
+/* Value cache slot, the copy of the key-value item at pos, pos 0 if unused */
+typedef struct _kv_cache_t {
+    char       *store;          /* The key and the value */
+    uint16_t    pos;            /* The store position of the key-value item */
+    uint16_t    val_len;        /* The length of the value */
+    uint8_t     key_len;        /* The length of the key */
+    uint32_t    stamp;          /* The last use, the smallest one is evicted */
+} kv_cache_t;
+
 /* Block information structure for management */
 typedef struct _block_info_t {
     uint16_t    space;          /* Free space in current block */
+    uint16_t    live;           /* The bytes of normal items, valid with the index only */
+    uint16_t    erases;         /* The times the block was erased */
     uint8_t     state;          /* The state of current block */
 } block_info_t;
 
@@ -92,6 +124,26 @@ typedef struct _kv_mgr_t {
     aos_sem_t       gc_sem;
     aos_mutex_t     kv_mutex;
     block_info_t    block_info[BLK_NUMS];   /* The array to record block management information */
+    aos_task_t      gc_task;
+    uint8_t         gc_blk;                 /* The block being collected, BLK_NUMS if none */
+    uint8_t         gc_dest;                /* The block the live items move to */
+    uint16_t        gc_pos;                 /* The next item to move */
+    uint16_t        gc_reserve;             /* The space of gc_dest kept for the items left */
+#if KV_LOG_SIZE > 0
+    uint16_t        log_pos;                /* The store position of the log buffer */
+    uint16_t        log_len;                /* The bytes in the log buffer, not on flash yet */
+    char            log[KV_LOG_SIZE];       /* The items of aos_kv_set() without sync */
+#endif
+    uint8_t         index_valid;            /* The index is complete, flash is scanned otherwise */
+    uint16_t        index_size;             /* The number of entries allocated */
+    uint16_t        index_free;             /* The free entries, entry + 1 */
+    uint16_t        index_bucket[KV_INDEX_BUCKETS];
+    kv_index_t     *index;                  /* The RAM index of the normal items */
+#if KV_CACHE_NUM > 0
+    uint32_t        cache_stamp;
+    kv_cache_t      cache[KV_CACHE_NUM];    /* The LRU value cache */
+#endif
+    kv_stats_t      stats;
 } kv_mgr_t;
 
 static kv_mgr_t g_kv_mgr;
@@ -100,6 +152,9 @@ static const uint8_t BLK_MAGIC_NUM  = 'K';                  /* The block header
 static const uint8_t ITEM_MAGIC_NUM = 'I';                  /* The key-value item header magic number */
 
 void aos_kv_gc(void *arg);
+static int kv_log_flush(void);
+static int kv_gc_resume(void);
+void kv_bench_init(void);
 
 /* CRC-8: the poly is 0x31 (x^8 + x^5 + x^4 + 1) */
 static uint8_t utils_crc8(uint8_t *buf, uint16_t length)
@@ -121,30 +176,289 @@ static uint8_t utils_crc8(uint8_t *buf, uint16_t length)
     return crc;
 }
 
+/*
+ * The log buffer holds the bytes of [log_pos, log_pos + log_len) until
+ * kv_log_flush() programs them, raw_read() and raw_write() see them in
+ * its place.
+ */
 static int raw_read(uint32_t offset, void *buf, size_t nbytes)
 {
+    int ret = RES_OK;
+#if KV_LOG_SIZE > 0
+    uint32_t start = g_kv_mgr.log_pos;
+    uint32_t end = start + g_kv_mgr.log_len;
+
+    if (g_kv_mgr.log_len && offset < end && offset + nbytes > start) {
+        if (offset < start || offset + nbytes > end) {
+            g_kv_mgr.stats.flash_reads++;
+            g_kv_mgr.stats.flash_read_bytes += nbytes;
+            ret = hal_flash_read((hal_partition_t)KV_PTN, &offset, buf, nbytes);
+            offset -= nbytes;
+        }
+
+        if (offset < start) {
+            memcpy((char *)buf + (start - offset), g_kv_mgr.log,
+                   ((offset + nbytes < end) ? offset + nbytes : end) - start);
+        } else {
+            memcpy(buf, g_kv_mgr.log + (offset - start),
+                   ((offset + nbytes < end) ? offset + nbytes : end) - offset);
+        }
+        return ret;
+    }
+#endif
+
+    g_kv_mgr.stats.flash_reads++;
+    g_kv_mgr.stats.flash_read_bytes += nbytes;
     return hal_flash_read((hal_partition_t)KV_PTN, &offset, buf, nbytes);
 }
 
 static int raw_write(uint32_t offset, const void *buf, size_t nbytes)
 {
+#if KV_LOG_SIZE > 0
+    uint32_t start = g_kv_mgr.log_pos;
+    uint32_t end = start + g_kv_mgr.log_len;
+    size_t i;
+
+    if (g_kv_mgr.log_len && offset < end && offset + nbytes > start) {
+        if (offset >= start && offset + nbytes <= end) {
+            /* programming clears bits only, as on flash */
+            for (i = 0; i < nbytes; i++) {
+                g_kv_mgr.log[offset - start + i] &= ((const uint8_t *)buf)[i];
+            }
+            return RES_OK;
+        }
+
+        if (kv_log_flush() != RES_OK) {
+            return RES_FLASH_WRITE_ERR;
+        }
+    }
+#endif
+
+    g_kv_mgr.stats.flash_writes++;
+    g_kv_mgr.stats.flash_write_bytes += nbytes;
     return hal_flash_write((hal_partition_t)KV_PTN, &offset, buf, nbytes);
 }
 
 static int raw_erase(uint32_t offset, uint32_t size)
 {
+    g_kv_mgr.stats.flash_erases++;
     return hal_flash_erase((hal_partition_t)KV_PTN, offset, size);
 }
 
+/* FNV-1a */
+static uint32_t kv_key_hash(const char *key, uint8_t key_len)
+{
+    uint32_t hash = 2166136261u;
+
+    while (key_len--) {
+        hash = (hash ^ (uint8_t)*key++) * 16777619u;
+    }
+
+    return hash;
+}
+
+static uint16_t *kv_index_bucket(uint32_t hash)
+{
+    return &(g_kv_mgr.index_bucket[hash & (KV_INDEX_BUCKETS - 1)]);
+}
+
+static void kv_index_reset(void)
+{
+    uint16_t i;
+
+    memset(g_kv_mgr.index_bucket, 0, sizeof(g_kv_mgr.index_bucket));
+    g_kv_mgr.index_free = 0;
+    for (i = g_kv_mgr.index_size; i > 0; i--) {
+        g_kv_mgr.index[i - 1].next = g_kv_mgr.index_free;
+        g_kv_mgr.index_free = i;
+    }
+    g_kv_mgr.index_valid = 1;
+}
+
+/* the index is dropped if it cannot grow, lookups scan the flash from then on */
+static void kv_index_add(uint32_t hash, uint8_t key_len, uint16_t val_len, uint16_t pos, uint8_t crc)
+{
+    kv_index_t *entries;
+    kv_index_t *e;
+    uint16_t   *bucket = kv_index_bucket(hash);
+    uint16_t    i;
+
+    if (!g_kv_mgr.index_valid) {
+        return;
+    }
+
+    if (g_kv_mgr.index_free == 0) {
+        entries = (kv_index_t *)aos_malloc((g_kv_mgr.index_size + KV_INDEX_GROW) * sizeof(kv_index_t));
+        if (!entries) {
+            g_kv_mgr.index_valid = 0;
+            return;
+        }
+
+        if (g_kv_mgr.index) {
+            memcpy(entries, g_kv_mgr.index, g_kv_mgr.index_size * sizeof(kv_index_t));
+            aos_free(g_kv_mgr.index);
+        }
+        g_kv_mgr.index = entries;
+
+        for (i = g_kv_mgr.index_size + KV_INDEX_GROW; i > g_kv_mgr.index_size; i--) {
+            entries[i - 1].next = g_kv_mgr.index_free;
+            g_kv_mgr.index_free = i;
+        }
+        g_kv_mgr.index_size += KV_INDEX_GROW;
+    }
+
+    i = g_kv_mgr.index_free;
+    e = &(g_kv_mgr.index[i - 1]);
+    g_kv_mgr.index_free = e->next;
+
+    e->pos = pos;
+    e->tag = hash >> 16;
+    e->key_len = key_len;
+    e->val_len = val_len;
+    e->crc = crc;
+    e->next = *bucket;
+    *bucket = i;
+}
+
+/* the entry of the item at pos, whose key hashes to hash */
+static uint16_t *kv_index_link(uint32_t hash, uint16_t pos)
+{
+    uint16_t *link = kv_index_bucket(hash);
+
+    while (*link != 0 && g_kv_mgr.index[*link - 1].pos != pos) {
+        link = &(g_kv_mgr.index[*link - 1].next);
+    }
+
+    return *link != 0 ? link : NULL;
+}
+
+static void kv_index_del(uint16_t *link)
+{
+    uint16_t i = *link;
+
+    *link = g_kv_mgr.index[i - 1].next;
+    g_kv_mgr.index[i - 1].next = g_kv_mgr.index_free;
+    g_kv_mgr.index_free = i;
+}
+
+#if KV_CACHE_NUM > 0
+static kv_cache_t *kv_cache_at(uint16_t pos)
+{
+    uint8_t i;
+
+    for (i = 0; i < KV_CACHE_NUM; i++) {
+        if (g_kv_mgr.cache[i].pos == pos) {
+            return &(g_kv_mgr.cache[i]);
+        }
+    }
+
+    return NULL;
+}
+
+/* the cached copy of key, found through the index without flash reads */
+static kv_cache_t *kv_cache_lookup(const char *key)
+{
+    kv_index_t *e;
+    kv_cache_t *c;
+    uint32_t hash;
+    uint16_t id;
+    uint8_t key_len = strlen(key);
+
+    if (!g_kv_mgr.index_valid) {
+        return NULL;
+    }
+
+    hash = kv_key_hash(key, key_len);
+    for (id = *kv_index_bucket(hash); id != 0; id = e->next) {
+        e = &(g_kv_mgr.index[id - 1]);
+        if (e->tag != (hash >> 16) || e->key_len != key_len) {
+            continue;
+        }
+
+        c = kv_cache_at(e->pos);
+        if (c && memcmp(c->store, key, key_len) == 0) {
+            c->stamp = ++(g_kv_mgr.cache_stamp);
+            g_kv_mgr.stats.cache_hits++;
+            return c;
+        }
+    }
+
+    g_kv_mgr.stats.cache_misses++;
+    return NULL;
+}
+
+/* keep a copy of the item at pos, in place of the least recently used one */
+static void kv_cache_put(uint16_t pos, const char *store, uint8_t key_len, uint16_t val_len)
+{
+    kv_cache_t *c = kv_cache_at(pos);
+    uint8_t i;
+
+    if (!c) {
+        c = &(g_kv_mgr.cache[0]);
+        for (i = 1; i < KV_CACHE_NUM; i++) {
+            if (g_kv_mgr.cache[i].stamp < c->stamp) {
+                c = &(g_kv_mgr.cache[i]);
+            }
+        }
+    }
+
+    if (c->store && (c->key_len + c->val_len) != (key_len + val_len)) {
+        aos_free(c->store);
+        c->store = NULL;
+    }
+
+    if (!c->store) {
+        c->store = (char *)aos_malloc(key_len + val_len);
+        if (!c->store) {
+            c->pos = 0;
+            return;
+        }
+    }
+
+    memcpy(c->store, store, key_len + val_len);
+    c->pos = pos;
+    c->key_len = key_len;
+    c->val_len = val_len;
+    c->stamp = ++(g_kv_mgr.cache_stamp);
+}
+
+static void kv_cache_move(uint16_t pos, uint16_t new_pos)
+{
+    kv_cache_t *c = kv_cache_at(pos);
+
+    if (c) {
+        c->pos = new_pos;
+    }
+}
+
+static void kv_cache_free(void)
+{
+    uint8_t i;
+
+    for (i = 0; i < KV_CACHE_NUM; i++) {
+        if (g_kv_mgr.cache[i].store) {
+            aos_free(g_kv_mgr.cache[i].store);
+        }
+        memset(&(g_kv_mgr.cache[i]), 0, sizeof(kv_cache_t));
+    }
+}
+#else
+#define kv_cache_put(pos, store, key_len, val_len)
+#define kv_cache_move(pos, new_pos)
+#define kv_cache_free()
+#endif
+
 static void trigger_gc(void)
 {
     if (g_kv_mgr.gc_triggered) {
         return;
     }
 
-    g_kv_mgr.gc_waiter = 0;
     g_kv_mgr.gc_triggered = 1;
-    aos_task_new("kv-gc", aos_kv_gc, NULL, KV_GC_STACK_SIZE);
+    if (aos_task_new_ext(&(g_kv_mgr.gc_task), "kv-gc", aos_kv_gc, NULL,
+                         KV_GC_STACK_SIZE, KV_GC_PRI) != 0) {
+        g_kv_mgr.gc_triggered = 0;
+    }
 }
 
 static void kv_item_free(kv_item_t *item)
@@ -169,6 +483,10 @@ static int kv_block_format(uint8_t index)
 
     memset(&hdr, 0, sizeof(hdr));
     hdr.magic = BLK_MAGIC_NUM;
+    if (g_kv_mgr.block_info[index].erases < 0xFFFF) {
+        g_kv_mgr.block_info[index].erases++;
+    }
+    hdr.erase_cnt = g_kv_mgr.block_info[index].erases;
     if (!raw_erase(pos, BLK_SIZE)) {
         hdr.state = BLK_STATE_CLEAN;
     } else {
@@ -181,10 +499,23 @@ static int kv_block_format(uint8_t index)
 
     g_kv_mgr.block_info[index].state = BLK_STATE_CLEAN;
     g_kv_mgr.block_info[index].space = BLK_SIZE - BLK_HEADER_SIZE;
+    g_kv_mgr.block_info[index].live = 0;
     (g_kv_mgr.clean_blk_nums)++;
     return RES_OK;
 }
 
+/* the free space of a block for new items, the GC keeps its share of gc_dest */
+static uint16_t kv_block_space(uint8_t index)
+{
+    uint16_t space = g_kv_mgr.block_info[index].space;
+
+    if (g_kv_mgr.gc_blk != BLK_NUMS && index == g_kv_mgr.gc_dest) {
+        return (space > g_kv_mgr.gc_reserve) ? space - g_kv_mgr.gc_reserve : 0;
+    }
+
+    return (index == g_kv_mgr.gc_blk) ? 0 : space;
+}
+
 static uint16_t kv_item_calc_pos(uint16_t len)
 {
     block_info_t *blk_info;
@@ -194,7 +525,7 @@ static uint16_t kv_item_calc_pos(uint16_t len)
 #endif
 
     blk_info = &(g_kv_mgr.block_info[blk_index]);
-    if (blk_info->space > len) {
+    if (kv_block_space(blk_index) > len) {
         if (((blk_info->space - len) < ITEM_MAX_LEN) && (g_kv_mgr.clean_blk_nums <= KV_GC_RESERVED)) {
             trigger_gc();
         }
@@ -202,13 +533,14 @@ static uint16_t kv_item_calc_pos(uint16_t len)
     }
 
 #if BLK_NUMS > KV_GC_RESERVED + 1
-    for (i = blk_index + 1; i != blk_index; i++) {
-        if (i == BLK_NUMS) {
-            i = 0;
+    for (i = (blk_index + 1) % BLK_NUMS; i != blk_index; i = (i + 1) % BLK_NUMS) {
+        /* the last clean blocks are left to the GC */
+        blk_info = &(g_kv_mgr.block_info[i]);
+        if ((blk_info->state == BLK_STATE_CLEAN) && (g_kv_mgr.clean_blk_nums <= KV_GC_RESERVED)) {
+            continue;
         }
 
-        blk_info = &(g_kv_mgr.block_info[i]);
-        if ((blk_info->space) > len) {
+        if (kv_block_space(i) > len) {
             g_kv_mgr.write_pos = (i << BLK_BITS) + BLK_SIZE - blk_info->space;
             if (blk_info->state == BLK_STATE_CLEAN) {
                 if (kv_state_set((i << BLK_BITS), BLK_STATE_USED) != RES_OK) {
@@ -226,17 +558,41 @@ static uint16_t kv_item_calc_pos(uint16_t len)
     return 0;
 }
 
+/* mark the normal item of len bytes at pos deleted, and its block dirty */
+static int kv_item_retire(uint16_t pos, uint16_t len)
+{
+    int ret;
+    uint8_t i = pos >> BLK_BITS;
+
+    if ((ret = kv_state_set(pos, ITEM_STATE_DELETE)) != RES_OK) {
+        return ret;
+    }
+
+    len = (len + ~KV_ALIGN_MASK) & KV_ALIGN_MASK;
+    g_kv_mgr.block_info[i].live -= (g_kv_mgr.block_info[i].live > len) ? len : g_kv_mgr.block_info[i].live;
+    kv_cache_move(pos, 0);
+
+    if (g_kv_mgr.block_info[i].state == BLK_STATE_USED) {
+        if ((ret = kv_state_set((pos & BLK_OFF_MASK), BLK_STATE_DIRTY)) != RES_OK) {
+            return ret;
+        }
+        g_kv_mgr.block_info[i].state = BLK_STATE_DIRTY;
+    }
+
+    return RES_OK;
+}
+
 static int kv_item_del(kv_item_t *item, int mode)
 {
     int ret = RES_OK;
     item_hdr_t hdr;
     char *origin_key = NULL;
     char *new_key = NULL;
-    uint8_t i;
     uint16_t offset;
 
     if (mode == KV_SELF_REMOVE) {
         offset = item->pos;
+        hdr = item->hdr;
     } else if (mode == KV_ORIG_REMOVE) {
         offset = item->hdr.origin_off;
         memset(&hdr, 0, ITEM_HEADER_SIZE);
@@ -274,16 +630,14 @@ static int kv_item_del(kv_item_t *item, int mode)
         return RES_INVALID_PARAM;
     }
 
-    if ((ret = kv_state_set(offset, ITEM_STATE_DELETE)) != RES_OK) {
+    if ((ret = kv_item_retire(offset, ITEM_HEADER_SIZE + hdr.key_len + hdr.val_len)) != RES_OK) {
         return ret;
     }
 
-    i = offset >> BLK_BITS;
-    if (g_kv_mgr.block_info[i].state == BLK_STATE_USED) {
-        if ((ret = kv_state_set((offset & BLK_OFF_MASK), BLK_STATE_DIRTY)) != RES_OK) {
-            return ret;
-        }
-        g_kv_mgr.block_info[i].state = BLK_STATE_DIRTY;
+    /* an update has pointed the entry at the new item already */
+    if (item->idx && g_kv_mgr.index_valid &&
+        g_kv_mgr.index[item->idx - 1].pos == offset) {
+        kv_index_del(kv_index_link(kv_key_hash(item->store, item->hdr.key_len), offset));
     }
 
     return ret;
@@ -292,6 +646,100 @@ static int kv_item_del(kv_item_t *item, int mode)
 /*the function to be invoked while polling the used block*/
 typedef int (*item_func)(kv_item_t *item, const char *key);
 
+/*
+ * Index a normal item found on flash, p holds its key and value. Blocks
+ * are walked in order and the first item of a key wins, as it did for the
+ * flash scan, unless it is the origin the item just replaced.
+ */
+static void __item_index(kv_item_t *item, const char *p)
+{
+    uint32_t hash = kv_key_hash(p, item->hdr.key_len);
+    item_hdr_t hdr;
+    uint16_t *link;
+    uint16_t id;
+    kv_index_t *e;
+    char *key;
+
+    if (!g_kv_mgr.index_valid) {
+        return;
+    }
+
+    /*
+     * origin_off may be stale, e.g. in a GC copy, and the entry there then
+     * belongs to another key of the bucket: drop it only once recovery has
+     * deleted the origin on flash
+     */
+    link = kv_index_link(hash, item->hdr.origin_off);
+    if (item->hdr.origin_off != 0 && link &&
+        (raw_read(item->hdr.origin_off, &hdr, ITEM_HEADER_SIZE) != RES_OK ||
+         hdr.state != ITEM_STATE_NORMAL)) {
+        kv_index_del(link);
+    } else {
+        key = (char *)aos_malloc(item->hdr.key_len);
+        if (!key) {
+            g_kv_mgr.index_valid = 0;
+            return;
+        }
+
+        for (id = *kv_index_bucket(hash); id != 0; id = e->next) {
+            e = &(g_kv_mgr.index[id - 1]);
+            if (e->tag == (hash >> 16) && e->key_len == item->hdr.key_len &&
+                raw_read(e->pos + ITEM_HEADER_SIZE, key, e->key_len) == RES_OK &&
+                memcmp(key, p, e->key_len) == 0) {
+                break;
+            }
+        }
+
+        aos_free(key);
+        if (id != 0) {
+            return;
+        }
+    }
+
+    kv_index_add(hash, item->hdr.key_len, item->hdr.val_len, item->pos, item->hdr.crc);
+}
+
+/* the bytes of normal items in each block, from the index */
+static void kv_live_count(void)
+{
+    kv_index_t *e;
+    uint16_t id;
+    uint8_t i;
+
+    for (i = 0; i < BLK_NUMS; i++) {
+        g_kv_mgr.block_info[i].live = 0;
+    }
+
+    if (!g_kv_mgr.index_valid) {
+        return;
+    }
+
+    for (i = 0; i < KV_INDEX_BUCKETS; i++) {
+        for (id = g_kv_mgr.index_bucket[i]; id != 0; id = e->next) {
+            e = &(g_kv_mgr.index[id - 1]);
+            g_kv_mgr.block_info[e->pos >> BLK_BITS].live +=
+                (ITEM_HEADER_SIZE + e->key_len + e->val_len + ~KV_ALIGN_MASK) & KV_ALIGN_MASK;
+        }
+    }
+}
+
+static int __item_index_cb(kv_item_t *item, const char *key)
+{
+    char *p = (char *)aos_malloc(item->len);
+    if (!p) {
+        return RES_MALLOC_FAILED;
+    }
+
+    if (raw_read(item->pos + ITEM_HEADER_SIZE, p, item->len) != RES_OK) {
+        aos_free(p);
+        return RES_FLASH_READ_ERR;
+    }
+
+    __item_index(item, p);
+    aos_free(p);
+    return RES_CONT;
+}
+
 static int __item_recovery_cb(kv_item_t *item, const char *key)
 {
     char *p = (char *)aos_malloc(item->len);
@@ -308,6 +756,7 @@ static int __item_recovery_cb(kv_item_t *item, const char *key)
         if ((item->hdr.origin_off != 0) && (item->pos != item->hdr.origin_off)) {
             kv_item_del(item, KV_ORIG_REMOVE);
         }
+        __item_index(item, p);
     } else {
         kv_item_del(item, KV_SELF_REMOVE);
     }
@@ -338,39 +787,6 @@ static int __item_find_cb(kv_item_t *item, const char *key)
     return RES_CONT;
 }
 
-static int __item_gc_cb(kv_item_t *item, const char *key)
-{
-    char *p;
-    int ret;
-    uint16_t len;
-    uint8_t index;
-
-    len = (ITEM_HEADER_SIZE + item->len + ~KV_ALIGN_MASK) & KV_ALIGN_MASK;
-    p = (char *)aos_malloc(len);
-    if (!p) {
-        return RES_MALLOC_FAILED;
-    }
-
-    if (raw_read(item->pos, p, len) != RES_OK) {
-        ret = RES_FLASH_READ_ERR;
-        goto err;
-    }
-
-    if (raw_write(g_kv_mgr.write_pos, p, len) != RES_OK) {
-        ret = RES_FLASH_WRITE_ERR;
-        goto err;
-    }
-
-    g_kv_mgr.write_pos += len;
-    index = (g_kv_mgr.write_pos) >> BLK_BITS;
-    g_kv_mgr.block_info[index].space -= len;
-    ret = RES_CONT;
-
-err:
-    aos_free(p);
-    return ret;
-}
-
 static kv_item_t *kv_item_traverse(item_func func, uint8_t blk_index, const char *key)
 {
     kv_item_t *item;
@@ -412,56 +828,210 @@ static kv_item_t *kv_item_traverse(item_func func, uint8_t blk_index, const char
             continue;
         }
 
-        len = (ITEM_HEADER_SIZE + hdr->key_len + hdr->val_len + ~KV_ALIGN_MASK) & KV_ALIGN_MASK;
+        len = (ITEM_HEADER_SIZE + hdr->key_len + hdr->val_len + ~KV_ALIGN_MASK) & KV_ALIGN_MASK;
+
+        if (hdr->state == ITEM_STATE_NORMAL) {
+            item->pos = pos;
+            item->len = hdr->key_len + hdr->val_len;
+            ret = func(item, key);
+            if (ret == RES_OK) {
+                return item;
+            } else if (ret != RES_CONT) {
+                kv_item_free(item);
+                return NULL;
+            }
+        } else {
+            if (g_kv_mgr.block_info[blk_index].state == BLK_STATE_USED) {
+                kv_state_set((blk_index << BLK_BITS), BLK_STATE_DIRTY);
+                g_kv_mgr.block_info[blk_index].state = BLK_STATE_DIRTY;
+            }
+        }
+
+        kv_item_free(item);
+        pos += len;
+    } while (end > (pos + ITEM_HEADER_SIZE));
+
+    g_kv_mgr.block_info[blk_index].space = (end > pos) ? (end - pos) : ITEM_HEADER_SIZE;
+    return NULL;
+}
+
+static kv_item_t *kv_item_scan(const char *key)
+{
+    kv_item_t *item;
+    uint8_t i;
+
+    for (i = 0; i < BLK_NUMS; i++) {
+        if (g_kv_mgr.block_info[i].state != BLK_STATE_CLEAN) {
+            item = kv_item_traverse(__item_find_cb, i, key);
+            if (item) {
+                return item;
+            }
+        }
+    }
+
+    return NULL;
+}
+
+/* read the normal item of len key and value bytes at pos, with one flash read */
+static kv_item_t *kv_item_read(uint16_t pos, uint16_t len)
+{
+    kv_item_t *item;
+
+    item = (kv_item_t *)aos_malloc(sizeof(kv_item_t));
+    if (!item) {
+        return NULL;
+    }
+    memset(item, 0, sizeof(kv_item_t));
+
+    item->store = (char *)aos_malloc(ITEM_HEADER_SIZE + len);
+    if (!item->store) {
+        kv_item_free(item);
+        return NULL;
+    }
+
+    if (raw_read(pos, item->store, ITEM_HEADER_SIZE + len) != RES_OK) {
+        kv_item_free(item);
+        return NULL;
+    }
+
+    memcpy(&(item->hdr), item->store, ITEM_HEADER_SIZE);
+    if ((item->hdr.magic != ITEM_MAGIC_NUM) || (item->hdr.state != ITEM_STATE_NORMAL) ||
+        (item->hdr.key_len + item->hdr.val_len != len)) {
+        kv_item_free(item);
+        return NULL;
+    }
+
+    memmove(item->store, item->store + ITEM_HEADER_SIZE, len);
+    item->pos = pos;
+    item->len = len;
+    return item;
+}
+
+static kv_item_t *kv_item_get(const char *key)
+{
+    kv_item_t *item;
+    kv_index_t *e;
+    uint32_t hash;
+    uint16_t id;
+    uint8_t key_len = strlen(key);
+
+    if (!g_kv_mgr.index_valid) {
+        if (kv_log_flush() != RES_OK) {
+            return NULL;
+        }
+        return kv_item_scan(key);
+    }
+
+    hash = kv_key_hash(key, key_len);
+    for (id = *kv_index_bucket(hash); id != 0; id = e->next) {
+        e = &(g_kv_mgr.index[id - 1]);
+        if (e->tag != (hash >> 16) || e->key_len != key_len) {
+            continue;
+        }
+
+        item = kv_item_read(e->pos, e->key_len + e->val_len);
+        if (!item) {
+            return NULL;
+        }
+
+        if (memcmp(item->store, key, key_len) == 0) {
+            item->idx = id;
+            return item;
+        }
+        kv_item_free(item);
+    }
+
+    return NULL;
+}
+
+typedef struct {
+    char *p;
+    int ret;
+    uint16_t len;
+} kv_storeage_t;
+#if KV_LOG_SIZE > 0
+static int kv_log_holds(uint16_t pos)
+{
+    return pos >= g_kv_mgr.log_pos && pos < g_kv_mgr.log_pos + g_kv_mgr.log_len;
+}
+
+/*
+ * Program the log buffer. An item updated from an origin on flash leaves
+ * the origin normal until now, so that a reset before the flush finds the
+ * old value rather than none.
+ */
+static int kv_log_flush(void)
+{
+    item_hdr_t *hdr;
+    item_hdr_t origin;
+    uint16_t pos = g_kv_mgr.log_pos;
+    uint16_t len = g_kv_mgr.log_len;
+    uint16_t off;
+    int ret;
+
+    if (len == 0) {
+        return RES_OK;
+    }
+
+    g_kv_mgr.log_len = 0;
+    if ((ret = raw_write(pos, g_kv_mgr.log, len)) != RES_OK) {
+        return RES_FLASH_WRITE_ERR;
+    }
+    g_kv_mgr.stats.log_flushes++;
+
+    for (off = 0; off < len; off += (ITEM_HEADER_SIZE + hdr->key_len + hdr->val_len + ~KV_ALIGN_MASK) & KV_ALIGN_MASK) {
+        hdr = (item_hdr_t *)(g_kv_mgr.log + off);
+        if ((hdr->origin_off == 0) || (hdr->origin_off >= pos && hdr->origin_off < pos + len)) {
+            continue;
+        }
+
+        if (raw_read(hdr->origin_off, &origin, ITEM_HEADER_SIZE) != RES_OK) {
+            return RES_FLASH_READ_ERR;
+        }
 
-        if (hdr->state == ITEM_STATE_NORMAL) {
-            item->pos = pos;
-            item->len = hdr->key_len + hdr->val_len;
-            ret = func(item, key);
-            if (ret == RES_OK) {
-                return item;
-            } else if (ret != RES_CONT) {
-                kv_item_free(item);
-                return NULL;
-            }
-        } else {
-            if (g_kv_mgr.block_info[blk_index].state == BLK_STATE_USED) {
-                kv_state_set((blk_index << BLK_BITS), BLK_STATE_DIRTY);
-                g_kv_mgr.block_info[blk_index].state = BLK_STATE_DIRTY;
+        if ((origin.magic == ITEM_MAGIC_NUM) && (origin.state == ITEM_STATE_NORMAL)) {
+            if ((ret = kv_item_retire(hdr->origin_off, ITEM_HEADER_SIZE + origin.key_len + origin.val_len)) != RES_OK) {
+                return ret;
             }
         }
+    }
 
-        kv_item_free(item);
-        pos += len;
-    } while (end > (pos + ITEM_HEADER_SIZE));
-
-    g_kv_mgr.block_info[blk_index].space = (end > pos) ? (end - pos) : ITEM_HEADER_SIZE;
-    return NULL;
+    return RES_OK;
 }
 
-static kv_item_t *kv_item_get(const char *key)
+/* append len bytes at pos to the log buffer, programming it if sync */
+static int kv_log_write(uint16_t pos, const char *p, uint16_t len, int sync)
 {
-    kv_item_t *item;
-    uint8_t i;
+    int ret;
 
-    for (i = 0; i < BLK_NUMS; i++) {
-        if (g_kv_mgr.block_info[i].state != BLK_STATE_CLEAN) {
-            item = kv_item_traverse(__item_find_cb, i, key);
-            if (item) {
-                return item;
-            }
+    if (g_kv_mgr.log_len &&
+        ((pos != g_kv_mgr.log_pos + g_kv_mgr.log_len) || (g_kv_mgr.log_len + len > KV_LOG_SIZE))) {
+        if ((ret = kv_log_flush()) != RES_OK) {
+            return ret;
         }
     }
 
-    return NULL;
+    /* the scan without the index could find an origin before its update */
+    if (len > KV_LOG_SIZE || !g_kv_mgr.index_valid) {
+        return raw_write(pos, p, len);
+    }
+
+    if (g_kv_mgr.log_len == 0) {
+        g_kv_mgr.log_pos = pos;
+    }
+    memcpy(g_kv_mgr.log + g_kv_mgr.log_len, p, len);
+    g_kv_mgr.log_len += len;
+    g_kv_mgr.stats.log_items++;
+
+    return sync ? kv_log_flush() : RES_OK;
 }
+#else
+#define kv_log_flush()                  RES_OK
+#define kv_log_write(pos, p, len, sync) raw_write(pos, p, len)
+#endif
 
-typedef struct {
-    char *p;
-    int ret;
-    uint16_t len;
-} kv_storeage_t;
-static int kv_item_store(const char *key, const void *val, int len, uint16_t origin_off)
+/* store the item and index it, replacing the entry idx + 1 of its origin if not 0 */
+static int kv_item_store(const char *key, const void *val, int len, uint16_t origin_off, uint16_t idx, int sync)
 {
     kv_storeage_t store;
     item_hdr_t hdr;
@@ -492,11 +1062,22 @@ static int kv_item_store(const char *key, const void *val, int len, uint16_t ori
 
     pos = kv_item_calc_pos(store.len);
     if (pos > 0) {
-        store.ret = raw_write(pos, store.p, store.len);
+        store.ret = kv_log_write(pos, store.p, store.len, sync);
         if (store.ret == RES_OK) {
             g_kv_mgr.write_pos = pos + store.len;
-            index = g_kv_mgr.write_pos >> BLK_BITS;
+            index = pos >> BLK_BITS;
             g_kv_mgr.block_info[index].space -= store.len;
+            g_kv_mgr.block_info[index].live += store.len;
+            g_kv_mgr.stats.user_bytes += hdr.key_len + hdr.val_len;
+
+            if (idx && g_kv_mgr.index_valid) {
+                g_kv_mgr.index[idx - 1].pos = pos;
+                g_kv_mgr.index[idx - 1].val_len = hdr.val_len;
+                g_kv_mgr.index[idx - 1].crc = hdr.crc;
+            } else {
+                kv_index_add(kv_key_hash(key, hdr.key_len), hdr.key_len, hdr.val_len, pos, hdr.crc);
+            }
+            kv_cache_put(pos, p, hdr.key_len, hdr.val_len);
         }
     } else {
         store.ret = RES_NO_SPACE;
@@ -508,21 +1089,41 @@ static int kv_item_store(const char *key, const void *val, int len, uint16_t ori
     return store.ret;
 }
 
-static int kv_item_update(kv_item_t *item, const char *key, const void *val, int len)
+static int kv_item_update(kv_item_t *item, const char *key, const void *val, int len, int sync)
 {
     int ret;
+#if KV_LOG_SIZE > 0
+    item_hdr_t hdr;
+#endif
 
     if (item->hdr.val_len == len) {
+        /* the value may still be in the log */
         if (!memcmp(item->store + item->hdr.key_len, val, len)) {
-            return RES_OK;
+            return sync ? kv_log_flush() : RES_OK;
         }
     }
 
-    ret = kv_item_store(key, val, len, item->pos);
+    ret = kv_item_store(key, val, len, item->pos, item->idx, sync);
     if (ret != RES_OK) {
         return ret;
     }
 
+#if KV_LOG_SIZE > 0
+    /* the new item is in the log, kv_log_flush() deletes an origin on flash */
+    if (g_kv_mgr.log_len && !kv_log_holds(item->pos)) {
+        kv_cache_move(item->pos, 0);
+        return RES_OK;
+    }
+
+    /* a flush on the way, e.g. by sync, has deleted the origin already */
+    if (raw_read(item->pos, &hdr, ITEM_HEADER_SIZE) != RES_OK) {
+        return RES_FLASH_READ_ERR;
+    }
+    if (hdr.state != ITEM_STATE_NORMAL) {
+        return RES_OK;
+    }
+#endif
+
     ret = kv_item_del(item, KV_SELF_REMOVE);
 
     return ret;
@@ -534,11 +1135,15 @@ static int kv_init(void)
     int ret, nums = 0;
     uint8_t i, next;
     uint8_t unclean[BLK_NUMS] = {0};
+    uint8_t reindex = 0;
+
+    kv_index_reset();
 
     for (i = 0; i < BLK_NUMS; i++) {
         memset(&hdr, 0, sizeof(block_hdr_t));
         raw_read((i << BLK_BITS), &hdr, BLK_HEADER_SIZE);
         if (hdr.magic == BLK_MAGIC_NUM) {
+            g_kv_mgr.block_info[i].erases = hdr.erase_cnt;
             if (INVALID_BLK_STATE(hdr.state)) {
                 if ((ret = kv_block_format(i)) != RES_OK) {
                     return ret;
@@ -575,11 +1180,24 @@ static int kv_init(void)
             if ((ret = kv_block_format(i)) != RES_OK) {
                 return ret;
             }
+            reindex = 1;
         }
         nums--;
     }
 
-    if (g_kv_mgr.clean_blk_nums == 0) {
+    /* items of a formatted block were indexed, maybe in place of others */
+    if (reindex) {
+        kv_index_reset();
+        for (i = 0; i < BLK_NUMS; i++) {
+            if (g_kv_mgr.block_info[i].state != BLK_STATE_CLEAN) {
+                kv_item_traverse(__item_index_cb, i, NULL);
+            }
+        }
+    }
+
+    kv_live_count();
+
+    if ((g_kv_mgr.clean_blk_nums == 0) && (kv_gc_resume() != RES_OK)) {
         if ((ret = kv_block_format(0)) != RES_OK) {
             return ret;
         }
@@ -607,67 +1225,311 @@ static int kv_init(void)
     return RES_OK;
 }
 
-void aos_kv_gc(void *arg)
+/*
+ * The victim of the GC: the dirty block with the most deleted bytes, the
+ * less worn one of equals. Once the erase counts spread by KV_WEAR_DELTA,
+ * the least worn block is taken even if its items are all normal, so that
+ * its cold data leaves a block which then takes the writes.
+ */
+static uint8_t kv_gc_victim(void)
 {
+    block_info_t *blk;
+    uint16_t min_erases = 0xFFFF;
+    uint16_t max_erases = 0;
+    uint16_t dead;
+    uint16_t best_dead = 0;
+    uint8_t victim = BLK_NUMS;
+    uint8_t coldest = BLK_NUMS;
     uint8_t i;
-    uint8_t gc_index;
-    uint8_t gc_copy = 0;
-    uint16_t origin_pos;
 
-    if (aos_mutex_lock(&(g_kv_mgr.kv_mutex), AOS_WAIT_FOREVER) != 0) {
-        goto exit;
+    for (i = 0; i < BLK_NUMS; i++) {
+        blk = &(g_kv_mgr.block_info[i]);
+        max_erases = (blk->erases > max_erases) ? blk->erases : max_erases;
+        if (blk->erases < min_erases) {
+            min_erases = blk->erases;
+            coldest = i;
+        }
+
+        if (blk->state != BLK_STATE_DIRTY) {
+            continue;
+        }
+
+        /* deleted items are reclaimed, the header and tail space are not */
+        dead = BLK_SIZE - BLK_HEADER_SIZE - blk->space;
+        dead = (g_kv_mgr.index_valid && dead > blk->live) ? dead - blk->live : 1;
+        if ((victim == BLK_NUMS) || (dead > best_dead) ||
+            ((dead == best_dead) && (blk->erases < g_kv_mgr.block_info[victim].erases))) {
+            victim = i;
+            best_dead = dead;
+        }
+    }
+
+    if ((max_erases - min_erases > KV_WEAR_DELTA) &&
+        (g_kv_mgr.block_info[coldest].state == BLK_STATE_USED)) {
+        return coldest;
     }
 
-    origin_pos = g_kv_mgr.write_pos;
-    if (g_kv_mgr.clean_blk_nums == 0) {
-        goto exit;
+    return victim;
+}
+
+static int kv_gc_start(void)
+{
+    uint16_t least = 0xFFFF;
+    uint8_t victim;
+    uint8_t dest = BLK_NUMS;
+    uint8_t i;
+    int ret;
+
+    victim = kv_gc_victim();
+    if (victim == BLK_NUMS) {
+        return RES_ITEM_NOT_FOUND;
     }
 
-    for (gc_index = 0; gc_index < BLK_NUMS; gc_index++) {
-        if (g_kv_mgr.block_info[gc_index].state == BLK_STATE_CLEAN) {
-            g_kv_mgr.write_pos = (gc_index << BLK_BITS) + BLK_HEADER_SIZE;
-            break;
+    for (i = 0; i < BLK_NUMS; i++) {
+        if ((g_kv_mgr.block_info[i].state == BLK_STATE_CLEAN) &&
+            (g_kv_mgr.block_info[i].erases < least)) {
+            least = g_kv_mgr.block_info[i].erases;
+            dest = i;
         }
     }
 
-    if (gc_index == BLK_NUMS) {
-        goto exit;
+    if (dest == BLK_NUMS) {
+        return RES_NO_SPACE;
+    }
+
+    if ((ret = kv_state_set((dest << BLK_BITS), BLK_STATE_USED)) != RES_OK) {
+        return ret;
+    }
+    g_kv_mgr.block_info[dest].state = BLK_STATE_USED;
+    (g_kv_mgr.clean_blk_nums)--;
+
+    /* new items go after the moved ones if they were going to the victim */
+    if ((g_kv_mgr.write_pos >> BLK_BITS) == victim) {
+        g_kv_mgr.write_pos = (dest << BLK_BITS) + BLK_HEADER_SIZE;
+    }
+
+    g_kv_mgr.gc_blk = victim;
+    g_kv_mgr.gc_dest = dest;
+    g_kv_mgr.gc_pos = (victim << BLK_BITS) + BLK_HEADER_SIZE;
+    g_kv_mgr.gc_reserve = BLK_SIZE - BLK_HEADER_SIZE - g_kv_mgr.block_info[victim].space;
+    return RES_OK;
+}
+
+/*
+ * Move the item at gc_pos to gc_dest. The copy is programmed before the
+ * victim's item is deleted, so a reset in between leaves two identical
+ * items, never none; and a later update of the copy cannot leave the
+ * victim's one as an older normal item.
+ */
+static int kv_gc_move(void)
+{
+    item_hdr_t hdr;
+    block_info_t *dest = &(g_kv_mgr.block_info[g_kv_mgr.gc_dest]);
+    uint16_t end = (g_kv_mgr.gc_blk << BLK_BITS) + BLK_SIZE;
+    uint16_t pos;
+    uint16_t len = ITEM_HEADER_SIZE;
+    uint16_t *link;
+    char *p;
+    int ret = RES_CONT;
+
+    if (end <= g_kv_mgr.gc_pos + ITEM_HEADER_SIZE) {
+        return RES_OK;
+    }
+
+    if (raw_read(g_kv_mgr.gc_pos, &hdr, ITEM_HEADER_SIZE) != RES_OK) {
+        return RES_FLASH_READ_ERR;
+    }
+
+    if (hdr.magic != ITEM_MAGIC_NUM) {
+        if ((hdr.magic == 0xFF) && (hdr.state == 0xFF)) {
+            return RES_OK;
+        }
+    } else if (hdr.val_len <= ITEM_MAX_VAL_LEN && hdr.key_len <= ITEM_MAX_KEY_LEN &&
+               hdr.val_len != 0 && hdr.key_len != 0) {
+        len = (ITEM_HEADER_SIZE + hdr.key_len + hdr.val_len + ~KV_ALIGN_MASK) & KV_ALIGN_MASK;
     }
 
-    i = (origin_pos >> BLK_BITS) + 1;
-    while (1) {
-        if (i == BLK_NUMS) {
-            i = 0;
+    if ((len > ITEM_HEADER_SIZE) && (hdr.state == ITEM_STATE_NORMAL)) {
+        /* the live count picked gc_dest, never program past its end */
+        if (dest->space < len) {
+            return RES_NO_SPACE;
+        }
+
+        p = (char *)aos_malloc(len);
+        if (!p) {
+            return RES_MALLOC_FAILED;
+        }
+
+        /*
+         * the copy names the item it replaces as origin, so recovery drops
+         * the victim's one if a reset comes before it is deleted below
+         */
+        pos = (g_kv_mgr.gc_dest << BLK_BITS) + BLK_SIZE - dest->space;
+        if (raw_read(g_kv_mgr.gc_pos, p, len) != RES_OK) {
+            ret = RES_FLASH_READ_ERR;
+        } else {
+            ((item_hdr_t *)p)->origin_off = g_kv_mgr.gc_pos;
+            if (raw_write(pos, p, len) != RES_OK) {
+                ret = RES_FLASH_WRITE_ERR;
+            }
         }
 
-        if (g_kv_mgr.block_info[i].state == BLK_STATE_DIRTY) {
-            kv_item_traverse(__item_gc_cb, i, NULL);
+        if (ret == RES_CONT) {
+            dest->space -= len;
+            dest->live += len;
+            if ((g_kv_mgr.write_pos >> BLK_BITS) == g_kv_mgr.gc_dest) {
+                g_kv_mgr.write_pos = pos + len;
+            }
 
-            gc_copy = 1;
-            if (kv_block_format(i) != RES_OK) {
-                goto exit;
+            if (g_kv_mgr.index_valid) {
+                link = kv_index_link(kv_key_hash(p + ITEM_HEADER_SIZE, hdr.key_len), g_kv_mgr.gc_pos);
+                if (link) {
+                    g_kv_mgr.index[*link - 1].pos = pos;
+                }
             }
+            kv_cache_move(g_kv_mgr.gc_pos, pos);
 
-            kv_state_set((g_kv_mgr.write_pos & BLK_OFF_MASK), BLK_STATE_USED);
-            g_kv_mgr.block_info[gc_index].state = BLK_STATE_USED;
-            (g_kv_mgr.clean_blk_nums)--;
-            break;
+            kv_state_set(g_kv_mgr.gc_pos, ITEM_STATE_DELETE);
+            g_kv_mgr.stats.gc_moved_bytes += len;
         }
-        if (i == (origin_pos >> BLK_BITS)) {
+
+        aos_free(p);
+        if (ret != RES_CONT) {
+            return ret;
+        }
+    }
+
+    g_kv_mgr.gc_pos += len;
+    g_kv_mgr.gc_reserve -= (g_kv_mgr.gc_reserve > len) ? len : g_kv_mgr.gc_reserve;
+    return RES_CONT;
+}
+
+/* move up to KV_GC_STEP items, returns RES_CONT while the victim has more */
+static int kv_gc_step(void)
+{
+    uint8_t i;
+    int ret;
+
+    /* nothing in the log may stay behind the items moved to flash */
+    if ((ret = kv_log_flush()) != RES_OK) {
+        return ret;
+    }
+
+    if (g_kv_mgr.gc_blk == BLK_NUMS) {
+        if ((ret = kv_gc_start()) != RES_OK) {
+            return ret;
+        }
+    }
+
+    for (i = 0; i < KV_GC_STEP; i++) {
+        if ((ret = kv_gc_move()) != RES_CONT) {
             break;
         }
-        i++;
     }
 
-    if (gc_copy == 0) {
-        g_kv_mgr.write_pos = origin_pos;
+    if (ret != RES_OK) {
+        return ret;
     }
 
-exit:
-    g_kv_mgr.gc_triggered = 0;
-    aos_mutex_unlock(&(g_kv_mgr.kv_mutex));
-    if (g_kv_mgr.gc_waiter > 0) {
-        aos_sem_signal_all(&(g_kv_mgr.gc_sem));
+    if ((ret = kv_block_format(g_kv_mgr.gc_blk)) != RES_OK) {
+        return ret;
+    }
+
+    g_kv_mgr.gc_blk = BLK_NUMS;
+    g_kv_mgr.gc_reserve = 0;
+    g_kv_mgr.stats.gc_runs++;
+    return RES_OK;
+}
+
+/*
+ * A reset during a GC leaves no clean block behind, the items the victim
+ * still holds fit in the space the dest kept for them. Finish it with the
+ * block of most dead bytes whose live ones fit in another block.
+ */
+static int kv_gc_resume(void)
+{
+    block_info_t *blk;
+    uint16_t used;
+    uint16_t live;
+    uint16_t best_dead = 0;
+    uint16_t best_space;
+    uint8_t victim = BLK_NUMS;
+    uint8_t dest = BLK_NUMS;
+    uint8_t i, j, d;
+    int ret;
+
+    for (i = 0; i < BLK_NUMS; i++) {
+        blk = &(g_kv_mgr.block_info[i]);
+        used = BLK_SIZE - BLK_HEADER_SIZE - blk->space;
+        live = g_kv_mgr.index_valid ? blk->live : used;
+        if ((used - live <= best_dead) && (victim != BLK_NUMS)) {
+            continue;
+        }
+
+        best_space = 0;
+        d = BLK_NUMS;
+        for (j = 0; j < BLK_NUMS; j++) {
+            if ((j != i) && (g_kv_mgr.block_info[j].space >= best_space)) {
+                best_space = g_kv_mgr.block_info[j].space;
+                d = j;
+            }
+        }
+
+        if ((d != BLK_NUMS) && (best_space >= live)) {
+            victim = i;
+            dest = d;
+            best_dead = used - live;
+        }
+    }
+
+    if (victim == BLK_NUMS) {
+        return RES_NO_SPACE;
+    }
+
+    g_kv_mgr.gc_blk = victim;
+    g_kv_mgr.gc_dest = dest;
+    g_kv_mgr.gc_pos = (victim << BLK_BITS) + BLK_HEADER_SIZE;
+    g_kv_mgr.gc_reserve = 0;
+
+    while ((ret = kv_gc_step()) == RES_CONT);
+
+    return ret;
+}
+
+/*
+ * The GC task collects one block, a step at a time. Writers take the lock
+ * between the steps, and only wait for the GC when there is no space left.
+ */
+void aos_kv_gc(void *arg)
+{
+    long long start;
+    uint32_t pause;
+    int ret = RES_CONT;
+
+    while (ret == RES_CONT) {
+        if (aos_mutex_lock(&(g_kv_mgr.kv_mutex), AOS_WAIT_FOREVER) != 0) {
+            g_kv_mgr.gc_triggered = 0;
+            break;
+        }
+
+        start = aos_now();
+        ret = kv_gc_step();
+
+        pause = (uint32_t)((aos_now() - start) / 1000);
+        g_kv_mgr.stats.gc_steps++;
+        g_kv_mgr.stats.gc_pause_total_us += pause;
+        if (pause > g_kv_mgr.stats.gc_pause_max_us) {
+            g_kv_mgr.stats.gc_pause_max_us = pause;
+        }
+
+        if (ret != RES_CONT) {
+            g_kv_mgr.gc_triggered = 0;
+            while (g_kv_mgr.gc_waiter > 0) {
+                (g_kv_mgr.gc_waiter)--;
+                aos_sem_signal(&(g_kv_mgr.gc_sem));
+            }
+        }
+        aos_mutex_unlock(&(g_kv_mgr.kv_mutex));
     }
 
     aos_task_exit(0);
@@ -681,6 +1543,12 @@ int aos_kv_del(const char *key)
         return ret;
     }
 
+    /* a delete is never left in the log, nor the updates before it */
+    if ((ret = kv_log_flush()) != RES_OK) {
+        aos_mutex_unlock(&(g_kv_mgr.kv_mutex));
+        return ret;
+    }
+
     item = kv_item_get(key);
     if (!item) {
         aos_mutex_unlock(&(g_kv_mgr.kv_mutex));
@@ -697,26 +1565,48 @@ AOS_EXPORT(int, aos_kv_del, const char *);
 int aos_kv_set(const char *key, const void *val, int len, int sync)
 {
     kv_item_t *item;
+    int retry;
     int ret;
     if (!key || !val || len <= 0 || strlen(key) > ITEM_MAX_KEY_LEN || len > ITEM_MAX_VAL_LEN) {
         return RES_INVALID_PARAM;
     }
 
-    if (g_kv_mgr.gc_triggered) {
-        (g_kv_mgr.gc_waiter)++;
-        aos_sem_wait(&(g_kv_mgr.gc_sem), AOS_WAIT_FOREVER);
-    }
-
     if ((ret = aos_mutex_lock(&(g_kv_mgr.kv_mutex), AOS_WAIT_FOREVER)) != RES_OK) {
         return ret;
     }
 
-    item = kv_item_get(key);
-    if (item) {
-        ret = kv_item_update(item, key, val, len);
-        kv_item_free(item);
-    } else {
-        ret = kv_item_store(key, val, len, 0);
+#if KV_CACHE_NUM > 0
+    {
+        kv_cache_t *c = kv_cache_lookup(key);
+        if (c && c->val_len == len && !memcmp(c->store + c->key_len, val, len)) {
+            /* the value may still be in the log */
+            ret = sync ? kv_log_flush() : RES_OK;
+            aos_mutex_unlock(&(g_kv_mgr.kv_mutex));
+            return ret;
+        }
+    }
+#endif
+
+    for (retry = 0; ; retry++) {
+        item = kv_item_get(key);
+        if (item) {
+            ret = kv_item_update(item, key, val, len, sync);
+            kv_item_free(item);
+        } else {
+            ret = kv_item_store(key, val, len, 0, 0, sync);
+        }
+
+        /* no space until the GC has moved the last items of its block */
+        if ((ret != RES_NO_SPACE) || !g_kv_mgr.gc_triggered || (retry > 0)) {
+            break;
+        }
+
+        (g_kv_mgr.gc_waiter)++;
+        aos_mutex_unlock(&(g_kv_mgr.kv_mutex));
+        aos_sem_wait(&(g_kv_mgr.gc_sem), AOS_WAIT_FOREVER);
+        if ((ret = aos_mutex_lock(&(g_kv_mgr.kv_mutex), AOS_WAIT_FOREVER)) != RES_OK) {
+            return ret;
+        }
     }
 
     aos_mutex_unlock(&(g_kv_mgr.kv_mutex));
@@ -737,7 +1627,26 @@ int aos_kv_get(const char *key, void *buffer, int *buffer_len)
         return ret;
     }
 
+#if KV_CACHE_NUM > 0
+    {
+        kv_cache_t *c = kv_cache_lookup(key);
+        if (c) {
+            if (*buffer_len < c->val_len) {
+                ret = RES_NO_SPACE;
+            } else {
+                memcpy(buffer, c->store + c->key_len, c->val_len);
+            }
+            *buffer_len = c->val_len;
+            aos_mutex_unlock(&(g_kv_mgr.kv_mutex));
+            return ret;
+        }
+    }
+#endif
+
     item = kv_item_get(key);
+    if (item) {
+        kv_cache_put(item->pos, item->store, item->hdr.key_len, item->hdr.val_len);
+    }
 
     aos_mutex_unlock(&(g_kv_mgr.kv_mutex));
 
@@ -759,6 +1668,32 @@ int aos_kv_get(const char *key, void *buffer, int *buffer_len)
 }
 AOS_EXPORT(int, aos_kv_get,const char *, void *, int *);
 
+void aos_kv_stats(kv_stats_t *stats)
+{
+    if (aos_mutex_lock(&(g_kv_mgr.kv_mutex), AOS_WAIT_FOREVER) != RES_OK) {
+        memset(stats, 0, sizeof(*stats));
+        return;
+    }
+
+    *stats = g_kv_mgr.stats;
+    aos_mutex_unlock(&(g_kv_mgr.kv_mutex));
+}
+AOS_EXPORT(void, aos_kv_stats, kv_stats_t *);
+
+int aos_kv_sync(void)
+{
+    int ret;
+
+    if ((ret = aos_mutex_lock(&(g_kv_mgr.kv_mutex), AOS_WAIT_FOREVER)) != RES_OK) {
+        return ret;
+    }
+
+    ret = kv_log_flush();
+    aos_mutex_unlock(&(g_kv_mgr.kv_mutex));
+    return ret;
+}
+AOS_EXPORT(int, aos_kv_sync, void);
+
 /* CLI Support */
 #ifdef CONFIG_AOS_CLI
 static int __item_print_cb(kv_item_t *item, const char *key)
@@ -861,12 +1796,16 @@ int aos_kv_init(void)
     }
 
     memset(&g_kv_mgr, 0, sizeof(g_kv_mgr));
+    g_kv_mgr.gc_blk = BLK_NUMS;
     if ((ret = aos_mutex_new(&(g_kv_mgr.kv_mutex))) != 0) {
         return ret;
     }
 
 #ifdef CONFIG_AOS_CLI
     aos_cli_register_command(&ncmd);
+#ifdef CONFIG_AOS_BENCH
+    kv_bench_init();
+#endif
 #endif
 
     if ((ret = kv_init()) != RES_OK) {
@@ -891,7 +1830,19 @@ int aos_kv_init(void)
 
 void aos_kv_deinit(void)
 {
+    if (aos_mutex_lock(&(g_kv_mgr.kv_mutex), AOS_WAIT_FOREVER) == RES_OK) {
+        kv_log_flush();
+        aos_mutex_unlock(&(g_kv_mgr.kv_mutex));
+    }
+
     g_kv_mgr.kv_initialize = 0;
+    kv_cache_free();
+    if (g_kv_mgr.index) {
+        aos_free(g_kv_mgr.index);
+        g_kv_mgr.index = NULL;
+    }
+    g_kv_mgr.index_size = 0;
+    g_kv_mgr.index_valid = 0;
     aos_sem_free(&(g_kv_mgr.gc_sem));
     aos_mutex_free(&(g_kv_mgr.kv_mutex));
 }
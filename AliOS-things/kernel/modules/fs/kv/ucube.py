@@ -9,3 +9,7 @@ component.add_comp_deps('utility/log')
 component.add_global_includes('include')
 
 component.add_global_macros('AOS_KV')
+
+if aos_global_config.get('aos_bench') == '1':
+    component.add_sources('kv_bench.c')
+    component.add_global_macros('CONFIG_AOS_BENCH')
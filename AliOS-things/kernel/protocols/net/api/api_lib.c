@@ -709,22 +709,12 @@ netconn_send(struct netconn *conn, struct netbuf *buf)
 }
 
 /**
- * @ingroup netconn_tcp
- * Send data over a TCP netconn.
- *
- * @param conn the TCP netconn over which to send data
- * @param dataptr pointer to the application buffer that contains the data to send
- * @param size size of the application data to send
- * @param apiflags combination of following flags :
- * - NETCONN_COPY: data will be copied into memory belonging to the stack
- * - NETCONN_MORE: for TCP connection, PSH flag will be set on last segment sent
- * - NETCONN_DONTBLOCK: only write the data if all data can be written at once
- * @param bytes_written pointer to a location that receives the number of written bytes
- * @return ERR_OK if data was sent, any other err_t on error
+ * Common part of netconn_write_partly() and netconn_write_pbuf(): 'ref',
+ * if not NULL, is the pbuf owning 'dataptr'.
  */
-err_t
-netconn_write_partly(struct netconn *conn, const void *dataptr, size_t size,
-                     u8_t apiflags, size_t *bytes_written)
+static err_t
+netconn_write_ext(struct netconn *conn, const void *dataptr, size_t size,
+                  u8_t apiflags, size_t *bytes_written, struct pbuf *ref)
 {
   API_MSG_VAR_DECLARE(msg);
   err_t err;
@@ -748,6 +738,11 @@ netconn_write_partly(struct netconn *conn, const void *dataptr, size_t size,
   API_MSG_VAR_REF(msg).msg.w.dataptr = dataptr;
   API_MSG_VAR_REF(msg).msg.w.apiflags = apiflags;
   API_MSG_VAR_REF(msg).msg.w.len = size;
+#if LWIP_SOCKET_ZEROCOPY
+  API_MSG_VAR_REF(msg).msg.w.ref = ref;
+#else /* LWIP_SOCKET_ZEROCOPY */
+  LWIP_UNUSED_ARG(ref);
+#endif /* LWIP_SOCKET_ZEROCOPY */
 #if LWIP_SO_SNDTIMEO
   if (conn->send_timeout != 0) {
     /* get the time we started, which is later compared to
@@ -780,6 +775,54 @@ netconn_write_partly(struct netconn *conn, const void *dataptr, size_t size,
   return err;
 }
 
+/**
+ * @ingroup netconn_tcp
+ * Send data over a TCP netconn.
+ *
+ * @param conn the TCP netconn over which to send data
+ * @param dataptr pointer to the application buffer that contains the data to send
+ * @param size size of the application data to send
+ * @param apiflags combination of following flags :
+ * - NETCONN_COPY: data will be copied into memory belonging to the stack
+ * - NETCONN_MORE: for TCP connection, PSH flag will be set on last segment sent
+ * - NETCONN_DONTBLOCK: only write the data if all data can be written at once
+ * @param bytes_written pointer to a location that receives the number of written bytes
+ * @return ERR_OK if data was sent, any other err_t on error
+ */
+err_t
+netconn_write_partly(struct netconn *conn, const void *dataptr, size_t size,
+                     u8_t apiflags, size_t *bytes_written)
+{
+  return netconn_write_ext(conn, dataptr, size, apiflags, bytes_written, NULL);
+}
+
+#if LWIP_SOCKET_ZEROCOPY
+/**
+ * @ingroup netconn_tcp
+ * Send the payload of a single pbuf over a TCP netconn without copying it.
+ *
+ * The data is enqueued by reference: the stack holds a reference on 'p'
+ * until the data written from it has been acked, so a custom pbuf's free
+ * function tells the application when its buffer is released. The caller
+ * keeps its own reference on 'p'. Only p->payload/p->len is sent, not the
+ * rest of a chain.
+ *
+ * @param conn the TCP netconn over which to send data
+ * @param p pbuf holding the data to send
+ * @param apiflags NETCONN_MORE and/or NETCONN_DONTBLOCK (NETCONN_COPY is ignored)
+ * @param bytes_written pointer to a location that receives the number of written bytes
+ * @return ERR_OK if data was sent, any other err_t on error
+ */
+err_t
+netconn_write_pbuf(struct netconn *conn, struct pbuf *p, u8_t apiflags,
+                   size_t *bytes_written)
+{
+  LWIP_ERROR("netconn_write_pbuf: invalid pbuf", (p != NULL), return ERR_ARG;);
+  return netconn_write_ext(conn, p->payload, p->len,
+                           (u8_t)(apiflags & ~NETCONN_COPY), bytes_written, p);
+}
+#endif /* LWIP_SOCKET_ZEROCOPY */
+
 /**
  * @ingroup netconn_tcp
  * Close or shutdown a TCP netconn (doesn't delete it).
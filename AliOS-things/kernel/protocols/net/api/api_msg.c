@@ -1553,7 +1553,14 @@ lwip_netconn_do_writemore(struct netconn *conn  WRITE_DELAYED_PARAM)
       }
     }
     LWIP_ASSERT("lwip_netconn_do_writemore: invalid length!", ((conn->write_offset + len) <= conn->current_msg->msg.w.len));
-    err = tcp_write(conn->pcb.tcp, dataptr, len, apiflags);
+#if LWIP_SOCKET_ZEROCOPY
+    if (conn->current_msg->msg.w.ref != NULL) {
+      err = tcp_write_ref(conn->pcb.tcp, dataptr, len, apiflags, conn->current_msg->msg.w.ref);
+    } else
+#endif /* LWIP_SOCKET_ZEROCOPY */
+    {
+      err = tcp_write(conn->pcb.tcp, dataptr, len, apiflags);
+    }
     /* if OK or memory error, check available space */
     if ((err == ERR_OK) || (err == ERR_MEM)) {
 err_mem:
@@ -217,6 +217,9 @@ struct lwip_sock {
   u8_t err;
   /** counter of how many threads are waiting for this socket using select */
   SELWAIT_T select_waiting;
+  /** set by lwip_sock_notify(), called from event_callback() */
+  lwip_sock_notify_t notify;
+  void *notify_arg;
 };
 
 #if LWIP_NETCONN_SEM_PER_THREAD
@@ -447,6 +450,8 @@ alloc_socket(struct netconn *newconn, int accepted)
       sockets[i].errevent   = 0;
       sockets[i].err        = 0;
       sockets[i].select_waiting = 0;
+      sockets[i].notify     = NULL;
+      sockets[i].notify_arg = NULL;
       return i + LWIP_SOCKET_OFFSET;
     }
     SYS_ARCH_UNPROTECT(lev);
@@ -760,6 +765,45 @@ lwip_listen(int s, int backlog)
 }
 AOS_EXPORT(int, lwip_listen, int, int);
 
+/** Fill in the source address of data received on a socket.
+ * 'buf' is the netbuf the data came from for UDP/RAW and unused for TCP. */
+static void
+lwip_recv_fromaddr(int s, struct lwip_sock *sock, void *buf, int len,
+                   struct sockaddr *from, socklen_t *fromlen)
+{
+  LWIP_UNUSED_ARG(s);
+  LWIP_UNUSED_ARG(len);
+#if !SOCKETS_DEBUG
+  if (from && fromlen)
+#endif /* !SOCKETS_DEBUG */
+  {
+    u16_t port;
+    ip_addr_t tmpaddr;
+    ip_addr_t *fromaddr;
+    union sockaddr_aligned saddr;
+    LWIP_DEBUGF(SOCKETS_DEBUG, ("lwip_recvfrom(%d): addr=", s));
+    if (NETCONNTYPE_GROUP(netconn_type(sock->conn)) == NETCONN_TCP) {
+      fromaddr = &tmpaddr;
+      netconn_getaddr(sock->conn, fromaddr, &port, 0);
+    } else {
+      port = netbuf_fromport((struct netbuf *)buf);
+      fromaddr = netbuf_fromaddr((struct netbuf *)buf);
+    }
+    IPADDR_PORT_TO_SOCKADDR(&saddr, fromaddr, port);
+    ip_addr_debug_print(SOCKETS_DEBUG, fromaddr);
+    LWIP_DEBUGF(SOCKETS_DEBUG, (" port=%"U16_F" len=%d\n", port, len));
+#if SOCKETS_DEBUG
+    if (from && fromlen)
+#endif /* SOCKETS_DEBUG */
+    {
+      if (*fromlen > saddr.sa.sa_len) {
+        *fromlen = saddr.sa.sa_len;
+      }
+      MEMCPY(from, &saddr, *fromlen);
+    }
+  }
+}
+
 int
 lwip_recvfrom(int s, void *mem, size_t len, int flags,
               struct sockaddr *from, socklen_t *fromlen)
@@ -869,35 +913,7 @@ lwip_recvfrom(int s, void *mem, size_t len, int flags,
 
     /* Check to see from where the data was.*/
     if (done) {
-#if !SOCKETS_DEBUG
-      if (from && fromlen)
-#endif /* !SOCKETS_DEBUG */
-      {
-        u16_t port;
-        ip_addr_t tmpaddr;
-        ip_addr_t *fromaddr;
-        union sockaddr_aligned saddr;
-        LWIP_DEBUGF(SOCKETS_DEBUG, ("lwip_recvfrom(%d): addr=", s));
-        if (NETCONNTYPE_GROUP(netconn_type(sock->conn)) == NETCONN_TCP) {
-          fromaddr = &tmpaddr;
-          netconn_getaddr(sock->conn, fromaddr, &port, 0);
-        } else {
-          port = netbuf_fromport((struct netbuf *)buf);
-          fromaddr = netbuf_fromaddr((struct netbuf *)buf);
-        }
-        IPADDR_PORT_TO_SOCKADDR(&saddr, fromaddr, port);
-        ip_addr_debug_print(SOCKETS_DEBUG, fromaddr);
-        LWIP_DEBUGF(SOCKETS_DEBUG, (" port=%"U16_F" len=%d\n", port, off));
-#if SOCKETS_DEBUG
-        if (from && fromlen)
-#endif /* SOCKETS_DEBUG */
-        {
-          if (*fromlen > saddr.sa.sa_len) {
-            *fromlen = saddr.sa.sa_len;
-          }
-          MEMCPY(from, &saddr, *fromlen);
-        }
-      }
+      lwip_recv_fromaddr(s, sock, buf, off, from, fromlen);
     }
 
     /* If we don't peek the incoming message... */
@@ -928,6 +944,105 @@ lwip_recvfrom(int s, void *mem, size_t len, int flags,
 }
 AOS_EXPORT(int, lwip_recvfrom, int, void *, size_t, int, struct sockaddr *, socklen_t *);
 
+#if LWIP_SOCKET_ZEROCOPY
+/** Drop the first 'off' bytes of the pbuf chain 'p', freeing pbufs that
+ * become empty, and return what is left of the chain. */
+static struct pbuf *
+lwip_pbuf_skip_header(struct pbuf *p, u16_t off)
+{
+  while ((off > 0) && (off >= p->len)) {
+    struct pbuf *q = p;
+    off -= p->len;
+    p = p->next;
+    LWIP_ASSERT("lwip_pbuf_skip_header: offset beyond chain", p != NULL);
+    /* the reference q held on p is passed to the caller */
+    q->next = NULL;
+    pbuf_free(q);
+  }
+  while (off > 0) {
+    s16_t step = (s16_t)LWIP_MIN(off, 0x7fff);
+    pbuf_header(p, (s16_t)-step);
+    off = (u16_t)(off - step);
+  }
+  return p;
+}
+
+/**
+ * Receive without copying: hands the next received pbuf chain to the
+ * caller, who owns it and must pbuf_free() it. For TCP this is whatever
+ * has been received, for UDP/RAW one datagram. MSG_PEEK is not supported.
+ *
+ * @return the number of bytes in *p, 0 on EOF or -1 with errno set
+ */
+int
+lwip_recv_pbuf(int s, struct pbuf **p, int flags,
+               struct sockaddr *from, socklen_t *fromlen)
+{
+  struct lwip_sock *sock;
+  void             *buf;
+  struct pbuf      *q;
+  err_t            err;
+
+  LWIP_DEBUGF(SOCKETS_DEBUG, ("lwip_recv_pbuf(%d, %p, 0x%x, ..)\n", s, (void *)p, flags));
+  sock = get_socket(s);
+  if (!sock) {
+    return -1;
+  }
+
+  LWIP_ERROR("lwip_recv_pbuf: invalid pbuf pointer", p != NULL,
+             sock_set_errno(sock, err_to_errno(ERR_ARG)); return -1;);
+  if (flags & MSG_PEEK) {
+    sock_set_errno(sock, EOPNOTSUPP);
+    return -1;
+  }
+
+  /* Check if there is data left from the last recv operation. */
+  if (sock->lastdata) {
+    buf = sock->lastdata;
+  } else {
+    /* If this is non-blocking call, then check first */
+    if (((flags & MSG_DONTWAIT) || netconn_is_nonblocking(sock->conn)) &&
+        (sock->rcvevent <= 0)) {
+      LWIP_DEBUGF(SOCKETS_DEBUG, ("lwip_recv_pbuf(%d): returning EWOULDBLOCK\n", s));
+      sock_set_errno(sock, EWOULDBLOCK);
+      return -1;
+    }
+
+    if (NETCONNTYPE_GROUP(netconn_type(sock->conn)) == NETCONN_TCP) {
+      err = netconn_recv_tcp_pbuf(sock->conn, (struct pbuf **)&buf);
+    } else {
+      err = netconn_recv(sock->conn, (struct netbuf **)&buf);
+    }
+    if (err != ERR_OK) {
+      LWIP_DEBUGF(SOCKETS_DEBUG, ("lwip_recv_pbuf(%d): error is \"%s\"!\n",
+        s, lwip_strerr(err)));
+      sock_set_errno(sock, err_to_errno(err));
+      return (err == ERR_CLSD ? 0 : -1);
+    }
+    LWIP_ASSERT("buf != NULL", buf != NULL);
+  }
+
+  if (NETCONNTYPE_GROUP(netconn_type(sock->conn)) == NETCONN_TCP) {
+    /* a previous recv may have consumed part of lastdata already */
+    q = lwip_pbuf_skip_header((struct pbuf *)buf, sock->lastoffset);
+    lwip_recv_fromaddr(s, sock, NULL, q->tot_len, from, fromlen);
+  } else {
+    /* take the pbuf chain out of the netbuf before deleting it */
+    q = ((struct netbuf *)buf)->p;
+    ((struct netbuf *)buf)->p = ((struct netbuf *)buf)->ptr = NULL;
+    lwip_recv_fromaddr(s, sock, buf, q->tot_len, from, fromlen);
+    netbuf_delete((struct netbuf *)buf);
+  }
+  sock->lastdata = NULL;
+  sock->lastoffset = 0;
+
+  *p = q;
+  sock_set_errno(sock, 0);
+  return q->tot_len;
+}
+AOS_EXPORT(int, lwip_recv_pbuf, int, struct pbuf **, int, struct sockaddr *, socklen_t *);
+#endif /* LWIP_SOCKET_ZEROCOPY */
+
 int
 lwip_read(int s, void *mem, size_t len)
 {
@@ -983,6 +1098,101 @@ lwip_send(int s, const void *data, size_t size, int flags)
 }
 AOS_EXPORT(int, lwip_send, int, const void *, size_t, int);
 
+#if LWIP_SOCKET_ZEROCOPY
+/**
+ * Send a pbuf chain without copying the data. The caller keeps its
+ * reference on 'p' and frees it when done: for TCP every pbuf of the
+ * chain stays referenced by the stack until its data has been acked,
+ * so a custom pbuf's free function runs once the buffer can be reused.
+ * UDP/RAW send the chain as one datagram and may prepend headers in
+ * place, so 'p' must not be sent again.
+ *
+ * @return the number of bytes sent (can be partial for TCP sockets when
+ *         the stack runs out of room or fails after queueing some of
+ *         the chain) or -1 with errno set
+ */
+int
+lwip_send_pbuf(int s, struct pbuf *p, int flags)
+{
+  struct lwip_sock *sock;
+  err_t err;
+
+  LWIP_DEBUGF(SOCKETS_DEBUG, ("lwip_send_pbuf(%d, p=%p, flags=0x%x)\n",
+                              s, (void *)p, flags));
+  sock = get_socket(s);
+  if (!sock) {
+    return -1;
+  }
+
+  LWIP_ERROR("lwip_send_pbuf: invalid pbuf", p != NULL,
+             sock_set_errno(sock, err_to_errno(ERR_ARG)); return -1;);
+
+  if (NETCONNTYPE_GROUP(netconn_type(sock->conn)) == NETCONN_TCP) {
+#if LWIP_TCP
+    struct pbuf *q;
+    u8_t write_flags;
+    size_t written;
+    int size = 0;
+
+    err = ERR_OK;
+    write_flags = ((flags & MSG_DONTWAIT) ? NETCONN_DONTBLOCK : 0);
+    for (q = p; q != NULL; q = q->next) {
+      if (q->len == 0) {
+        continue;
+      }
+      written = 0;
+      /* only the last pbuf may carry PSH */
+      err = netconn_write_pbuf(sock->conn, q, (u8_t)(write_flags |
+              (((q->next != NULL) || (flags & MSG_MORE)) ? NETCONN_MORE : 0)), &written);
+      if (err == ERR_OK) {
+        size += written;
+        /* return a partial write if this pbuf was not accepted entirely */
+        if (written != q->len) {
+          break;
+        }
+      } else if (size > 0) {
+        /* previous pbufs were accepted and stay queued: report them,
+           a hard error shows up again on the next call */
+        err = ERR_OK;
+        break;
+      } else {
+        size = -1;
+        break;
+      }
+    }
+    LWIP_DEBUGF(SOCKETS_DEBUG, ("lwip_send_pbuf(%d) err=%d size=%d\n", s, err, size));
+    sock_set_errno(sock, err_to_errno(err));
+    return size;
+#else /* LWIP_TCP */
+    sock_set_errno(sock, err_to_errno(ERR_ARG));
+    return -1;
+#endif /* LWIP_TCP */
+  }
+  /* else, UDP and RAW NETCONNs */
+#if LWIP_UDP || LWIP_RAW
+  {
+    struct netbuf buf;
+
+    /* the netbuf only borrows p, it is not freed here */
+    buf.p = buf.ptr = p;
+#if LWIP_CHECKSUM_ON_COPY
+    buf.flags = 0;
+#endif /* LWIP_CHECKSUM_ON_COPY */
+    ip_addr_set_any(NETCONNTYPE_ISIPV6(netconn_type(sock->conn)), &buf.addr);
+    netbuf_fromport(&buf) = 0;
+
+    err = netconn_send(sock->conn, &buf);
+    sock_set_errno(sock, err_to_errno(err));
+    return (err == ERR_OK ? (int)p->tot_len : -1);
+  }
+#else /* LWIP_UDP || LWIP_RAW */
+  sock_set_errno(sock, err_to_errno(ERR_ARG));
+  return -1;
+#endif /* LWIP_UDP || LWIP_RAW */
+}
+AOS_EXPORT(int, lwip_send_pbuf, int, struct pbuf *, int);
+#endif /* LWIP_SOCKET_ZEROCOPY */
+
 int
 lwip_sendmsg(int s, const struct msghdr *msg, int flags)
 {
@@ -1076,16 +1286,25 @@ lwip_sendmsg(int s, const struct msghdr *msg, int flags)
     } else {
       /* flatten the IO vectors */
       size_t offset = 0;
+#if LWIP_CHECKSUM_ON_COPY
+      u32_t acc = 0;
+      u16_t chksum;
+#endif /* LWIP_CHECKSUM_ON_COPY */
       for (i = 0; i < msg->msg_iovlen; i++) {
+#if LWIP_CHECKSUM_ON_COPY
+        chksum = LWIP_CHKSUM_COPY(&((u8_t*)chain_buf->p->payload)[offset], msg->msg_iov[i].iov_base,
+                                  (u16_t)msg->msg_iov[i].iov_len);
+        /* a vector starting at an odd offset contributes byte swapped */
+        acc += (offset & 1) ? (u32_t)(SWAP_BYTES_IN_WORD(chksum)) : chksum;
+#else /* LWIP_CHECKSUM_ON_COPY */
         MEMCPY(&((u8_t*)chain_buf->p->payload)[offset], msg->msg_iov[i].iov_base, msg->msg_iov[i].iov_len);
+#endif /* LWIP_CHECKSUM_ON_COPY */
         offset += msg->msg_iov[i].iov_len;
       }
 #if LWIP_CHECKSUM_ON_COPY
-      {
-        /* This can be improved by using LWIP_CHKSUM_COPY() and aggregating the checksum for each IO vector */
-        u16_t chksum = ~inet_chksum_pbuf(chain_buf->p);
-        netbuf_set_chksum(chain_buf, chksum);
-      }
+      acc = FOLD_U32T(acc);
+      acc = FOLD_U32T(acc);
+      netbuf_set_chksum(chain_buf, (u16_t)acc);
 #endif /* LWIP_CHECKSUM_ON_COPY */
       err = ERR_OK;
     }
@@ -1435,6 +1654,62 @@ int lwip_eventfd(unsigned int initval, int flags)
 }
 AOS_EXPORT(int, lwip_eventfd, unsigned int, int);
 
+/** the LWIP_SOCK_EVT_* a socket is ready for, with SYS_ARCH protection held */
+static int
+sock_notify_evt(struct lwip_sock *sock)
+{
+  return ((sock->lastdata != NULL || sock->rcvevent > 0) ? LWIP_SOCK_EVT_RCV : 0) |
+         (sock->sendevent != 0 ? LWIP_SOCK_EVT_SEND : 0) |
+         (sock->errevent != 0 ? LWIP_SOCK_EVT_ERR : 0);
+}
+
+/**
+ * Register a callback run each time socket s turns ready, unlike select()
+ * it stays until it is replaced or s is closed. It runs at once if s is
+ * ready already. A socket has one slot: only the owner of arg may replace
+ * its callback, and a NULL notify drops the callback registered with arg.
+ *
+ * @param s the socket
+ * @param notify the callback, or NULL
+ * @param arg passed to notify
+ * @return 0 on success, -EBADF if s is not a socket, -EBUSY if a callback
+ *         with another arg is registered
+ */
+int
+lwip_sock_notify(int s, lwip_sock_notify_t notify, void *arg)
+{
+  struct lwip_sock *sock;
+  int evt;
+  SYS_ARCH_DECL_PROTECT(lev);
+
+  sock = get_socket(s);
+  if (!sock) {
+    return -EBADF;
+  }
+
+  SYS_ARCH_PROTECT(lev);
+  if (notify == NULL) {
+    if (sock->notify_arg == arg) {
+      sock->notify = NULL;
+      sock->notify_arg = NULL;
+    }
+  } else if (sock->notify != NULL && sock->notify_arg != arg) {
+    SYS_ARCH_UNPROTECT(lev);
+    return -EBUSY;
+  } else {
+    sock->notify = notify;
+    sock->notify_arg = arg;
+    evt = sock_notify_evt(sock);
+    if (evt != 0) {
+      notify(s, evt, arg);
+    }
+  }
+  SYS_ARCH_UNPROTECT(lev);
+
+  return 0;
+}
+AOS_EXPORT(int, lwip_sock_notify, int, lwip_sock_notify_t, void *);
+
 int
 lwip_select(int maxfdp1, fd_set *readset, fd_set *writeset, fd_set *exceptset,
             struct timeval *timeout)
@@ -1710,6 +1985,13 @@ event_callback(struct netconn *conn, enum netconn_evt evt, u16_t len)
       break;
   }
 
+  if (sock->notify != NULL && evt != NETCONN_EVT_RCVMINUS && evt != NETCONN_EVT_SENDMINUS) {
+    int nevt = sock_notify_evt(sock);
+    if (nevt != 0) {
+      sock->notify(s, nevt, sock->notify_arg);
+    }
+  }
+
   if (sock->select_waiting == 0) {
     /* noone is waiting for this socket, no need to check select_cb_list */
     SYS_ARCH_UNPROTECT(lev);
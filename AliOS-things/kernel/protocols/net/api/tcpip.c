@@ -219,6 +219,118 @@ tcpip_input(struct pbuf *p, struct netif *inp)
   return tcpip_inpkt(p, inp, ip_input);
 }
 
+#if TCPIP_RX_RING_SIZE
+/* Set rx_sched, returns its previous value. Both sides update the flag with
+ * a read-modify-write, so a drain that clears it after its last look at
+ * rx_tail is ordered against a producer that publishes rx_tail before
+ * setting it: either the drain sees the packet or the producer sees 0 and
+ * posts a new wakeup. */
+static u32_t
+tcpip_rx_sched_set(struct netif *netif)
+{
+  u32_t old = sys_ring_load_relaxed(&netif->rx_sched);
+
+  while (!sys_ring_cas(&netif->rx_sched, &old, 1)) {
+  }
+  return old;
+}
+
+/* Runs in tcpip_thread, posted by tcpip_input_ring() */
+static void
+tcpip_rx_drain(void *ctx)
+{
+  struct netif *netif = (struct netif *)ctx;
+  struct pbuf *p;
+  u32_t head = sys_ring_load_relaxed(&netif->rx_head);
+  u32_t tail;
+  u32_t sched;
+  int n;
+
+  while (1) {
+    tail = sys_ring_load_acquire(&netif->rx_tail);
+    for (n = 0; n < TCPIP_RX_BATCH && head != tail; n++) {
+      p = netif->rx_ring[head & (TCPIP_RX_RING_SIZE - 1)];
+      sys_ring_store_release(&netif->rx_head, ++head);
+      LWIP_DEBUGF(TCPIP_DEBUG, ("tcpip_thread: RING PACKET %p\n", (void *)p));
+#if LWIP_ETHERNET
+      if (netif->flags & (NETIF_FLAG_ETHARP | NETIF_FLAG_ETHERNET)) {
+        ethernet_input(p, netif);
+      } else
+#endif /* LWIP_ETHERNET */
+      {
+        ip_input(p, netif);
+      }
+    }
+
+    if (head != sys_ring_load_acquire(&netif->rx_tail)) {
+      /* more queued: go behind the other messages, or carry on if full */
+      if (tcpip_trycallback(netif->rx_msg) == ERR_OK) {
+        return;
+      }
+      continue;
+    }
+
+    sched = 1;
+    while (!sys_ring_cas(&netif->rx_sched, &sched, 0)) {
+      sched = 1;
+    }
+    if (head == sys_ring_load_acquire(&netif->rx_tail) ||
+        tcpip_rx_sched_set(netif) != 0) {
+      /* idle, or the producer has posted the next wakeup itself */
+      return;
+    }
+  }
+}
+
+/**
+ * @ingroup lwip_os
+ * Queue a received packet on the netif's input ring for tcpip_thread, which
+ * passes it to ethernet_input or ip_input like tcpip_input(). Packets are
+ * taken up to TCPIP_RX_BATCH per wakeup and only the first packet after the
+ * ring went idle posts to the mbox, so no message is allocated per packet.
+ * Pass to netif_add() instead of tcpip_input() and call netif->input().
+ *
+ * Only one context per netif may call this at a time (the driver's RX
+ * thread or interrupt), tcpip_thread being the only consumer. Stop the
+ * driver and let the ring drain before netif_remove().
+ *
+ * @param p the received packet, as for tcpip_input()
+ * @param inp the network interface on which the packet was received
+ * @return ERR_OK if queued, ERR_MEM if the ring or the mbox is full
+ *         (p is not freed)
+ */
+err_t
+tcpip_input_ring(struct pbuf *p, struct netif *inp)
+{
+  u32_t tail = sys_ring_load_relaxed(&inp->rx_tail);
+
+  LWIP_ASSERT("Invalid mbox", sys_mbox_valid_val(mbox));
+
+  if (inp->rx_msg == NULL) {
+    inp->rx_msg = tcpip_callbackmsg_new(tcpip_rx_drain, inp);
+    if (inp->rx_msg == NULL) {
+      return ERR_MEM;
+    }
+  }
+
+  if (tail - sys_ring_load_acquire(&inp->rx_head) >= TCPIP_RX_RING_SIZE) {
+    return ERR_MEM;
+  }
+  inp->rx_ring[tail & (TCPIP_RX_RING_SIZE - 1)] = p;
+  sys_ring_store_release(&inp->rx_tail, tail + 1);
+
+  if (tcpip_rx_sched_set(inp) == 0 && tcpip_trycallback(inp->rx_msg) != ERR_OK) {
+    /* mbox full: rx_sched was 0, so no drain runs. Take this packet back
+       for the driver to retry, the retry posts the wakeup that picks up
+       any packets still queued before it. */
+    sys_ring_store_release(&inp->rx_tail, tail);
+    sys_ring_store_release(&inp->rx_sched, 0);
+    return ERR_MEM;
+  }
+  return ERR_OK;
+}
+#endif /* TCPIP_RX_RING_SIZE */
+
 /**
  * Call a specific function in the thread context of
  * tcpip_thread for easy access synchronization.
@@ -57,7 +57,7 @@
 #ifndef LWIP_CHKSUM
 # define LWIP_CHKSUM lwip_standard_chksum
 # ifndef LWIP_CHKSUM_ALGORITHM
-#  define LWIP_CHKSUM_ALGORITHM 2
+#  define LWIP_CHKSUM_ALGORITHM 4
 # endif
 u16_t lwip_standard_chksum(const void *dataptr, int len);
 #endif
@@ -66,6 +66,100 @@ u16_t lwip_standard_chksum(const void *dataptr, int len);
 # define LWIP_CHKSUM_ALGORITHM 0
 #endif
 
+/* Vector unit used by checksum version #4 and copy version #2: 1 for SSE2,
+   2 for NEON, 0 for plain C. Follows the compiler's target flags unless
+   lwipopts.h sets it. */
+#ifndef LWIP_CHKSUM_SIMD
+# if defined(__SSE2__)
+#  define LWIP_CHKSUM_SIMD 1
+# elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#  define LWIP_CHKSUM_SIMD 2
+# else
+#  define LWIP_CHKSUM_SIMD 0
+# endif
+#endif
+
+#if (LWIP_CHKSUM_ALGORITHM == 4) || (LWIP_CHKSUM_COPY_ALGORITHM == 2)
+#if (LWIP_CHKSUM_SIMD == 1)
+#include <emmintrin.h>
+#elif (LWIP_CHKSUM_SIMD == 2)
+#include <arm_neon.h>
+#endif
+
+/* Most 16 byte blocks per lwip_chksum_simd() call: each 32 bit lane gains
+   at most 2 * 0xffff per block */
+#define LWIP_CHKSUM_SIMD_BLOCKS 0x4000
+
+/** Fold a 64 bit sum of native order words down to 16 bits */
+static u16_t
+lwip_chksum_fold64(uint64_t sum)
+{
+  u32_t acc;
+
+  sum = (sum >> 32) + (sum & 0xffffffffUL);
+  sum = (sum >> 32) + (sum & 0xffffffffUL);
+  acc = (u32_t)sum;
+  acc = FOLD_U32T(acc);
+  acc = FOLD_U32T(acc);
+  return (u16_t)acc;
+}
+
+#if (LWIP_CHKSUM_SIMD == 1)
+/** Sum n 16 byte blocks, copying them to dst unless dst is NULL */
+static uint64_t
+lwip_chksum_simd(u8_t *dst, const u8_t *src, int n)
+{
+  const __m128i mask = _mm_set1_epi32(0xffff);
+  __m128i lo = _mm_setzero_si128();
+  __m128i hi = _mm_setzero_si128();
+  __m128i v;
+  u32_t lanes[4];
+
+  if (dst == NULL) {
+    for (; n > 0; n--, src += 16) {
+      v = _mm_loadu_si128((const __m128i *)(const void *)src);
+      lo = _mm_add_epi32(lo, _mm_and_si128(v, mask));
+      hi = _mm_add_epi32(hi, _mm_srli_epi32(v, 16));
+    }
+  } else {
+    for (; n > 0; n--, src += 16, dst += 16) {
+      v = _mm_loadu_si128((const __m128i *)(const void *)src);
+      _mm_storeu_si128((__m128i *)(void *)dst, v);
+      lo = _mm_add_epi32(lo, _mm_and_si128(v, mask));
+      hi = _mm_add_epi32(hi, _mm_srli_epi32(v, 16));
+    }
+  }
+
+  _mm_storeu_si128((__m128i *)(void *)lanes, _mm_add_epi32(lo, hi));
+  return (uint64_t)lanes[0] + lanes[1] + lanes[2] + lanes[3];
+}
+#elif (LWIP_CHKSUM_SIMD == 2)
+/** Sum n 16 byte blocks, copying them to dst unless dst is NULL */
+static uint64_t
+lwip_chksum_simd(u8_t *dst, const u8_t *src, int n)
+{
+  uint32x4_t acc = vdupq_n_u32(0);
+  uint64x2_t sum;
+  uint8x16_t v;
+
+  if (dst == NULL) {
+    for (; n > 0; n--, src += 16) {
+      acc = vpadalq_u16(acc, vreinterpretq_u16_u8(vld1q_u8(src)));
+    }
+  } else {
+    for (; n > 0; n--, src += 16, dst += 16) {
+      v = vld1q_u8(src);
+      vst1q_u8(dst, v);
+      acc = vpadalq_u16(acc, vreinterpretq_u16_u8(v));
+    }
+  }
+
+  sum = vpaddlq_u32(acc);
+  return vgetq_lane_u64(sum, 0) + vgetq_lane_u64(sum, 1);
+}
+#endif /* LWIP_CHKSUM_SIMD */
+#endif /* (LWIP_CHKSUM_ALGORITHM == 4) || (LWIP_CHKSUM_COPY_ALGORITHM == 2) */
+
 #if (LWIP_CHKSUM_ALGORITHM == 1) /* Version #1 */
 /**
  * lwip checksum
@@ -256,6 +350,88 @@ lwip_standard_chksum(const void *dataptr, int len)
 }
 #endif
 
+#if (LWIP_CHKSUM_ALGORITHM == 4) /* Alternative version #4 */
+/**
+ * Word at a time checksum: after aligning to 4 bytes, 32-bit words are
+ * added into a 64-bit accumulator, so carries simply pile up in the upper
+ * half and are folded once at the end. With LWIP_CHKSUM_SIMD the bulk is
+ * summed 16 bytes per step by SSE2 or NEON instead.
+ *
+ * @param dataptr points to start of data to be summed at any boundary
+ * @param len length of data to be summed
+ * @return host order (!) lwip checksum (non-inverted Internet sum)
+ */
+u16_t
+lwip_standard_chksum(const void *dataptr, int len)
+{
+  const u8_t *pb = (const u8_t *)dataptr;
+  const u32_t *pl;
+  uint64_t sum = 0;
+  u16_t t = 0;
+  u16_t acc;
+  /* starts at odd byte address? */
+  int odd = ((mem_ptr_t)pb & 1);
+#if LWIP_CHKSUM_SIMD
+  int n;
+#endif /* LWIP_CHKSUM_SIMD */
+
+  if (odd && len > 0) {
+    ((u8_t *)&t)[1] = *pb++;
+    len--;
+  }
+
+  if (((mem_ptr_t)pb & 2) && len > 1) {
+    sum += *(const u16_t *)(const void *)pb;
+    pb += 2;
+    len -= 2;
+  }
+
+#if LWIP_CHKSUM_SIMD
+  while (len >= 16) {
+    n = LWIP_MIN(len >> 4, LWIP_CHKSUM_SIMD_BLOCKS);
+    sum += lwip_chksum_simd(NULL, pb, n);
+    pb += n << 4;
+    len -= n << 4;
+  }
+#endif /* LWIP_CHKSUM_SIMD */
+
+  pl = (const u32_t *)(const void *)pb;
+  while (len >= 16) {
+    sum += pl[0];
+    sum += pl[1];
+    sum += pl[2];
+    sum += pl[3];
+    pl += 4;
+    len -= 16;
+  }
+  while (len >= 4) {
+    sum += *pl++;
+    len -= 4;
+  }
+
+  pb = (const u8_t *)pl;
+  if (len > 1) {
+    sum += *(const u16_t *)(const void *)pb;
+    pb += 2;
+    len -= 2;
+  }
+
+  /* dangling tail byte remaining? */
+  if (len > 0) {
+    ((u8_t *)&t)[0] = *pb;
+  }
+
+  sum += t;
+  acc = lwip_chksum_fold64(sum);
+
+  if (odd) {
+    acc = SWAP_BYTES_IN_WORD(acc);
+  }
+
+  return acc;
+}
+#endif
+
 /** Parts of the pseudo checksum which are common to IPv4 and IPv6 */
 static u16_t
 inet_cksum_pseudo_base(struct pbuf *p, u8_t proto, u16_t proto_len, u32_t acc)
@@ -608,3 +784,100 @@ lwip_chksum_copy(void *dst, const void *src, u16_t len)
   return LWIP_CHKSUM(dst, len);
 }
 #endif /* (LWIP_CHKSUM_COPY_ALGORITHM == 1) */
+
+#if (LWIP_CHKSUM_COPY_ALGORITHM == 2) /* Version #2 */
+/** Copy and checksum in one pass, so the data is only read once: words
+ * are loaded aligned on src and summed as in checksum version #4, stores
+ * go through SMEMCPY so dst may have any alignment. With LWIP_CHKSUM_SIMD
+ * the bulk moves 16 bytes per step.
+ */
+u16_t
+lwip_chksum_copy(void *dst, const void *src, u16_t len)
+{
+  const u8_t *ps = (const u8_t *)src;
+  u8_t *pd = (u8_t *)dst;
+  uint64_t sum = 0;
+  u32_t w[4];
+  u16_t h;
+  u16_t t = 0;
+  u16_t acc;
+  int left = len;
+  /* starts at odd byte address? */
+  int odd = ((mem_ptr_t)ps & 1);
+#if LWIP_CHKSUM_SIMD
+  int n;
+#endif /* LWIP_CHKSUM_SIMD */
+
+  if (odd && left > 0) {
+    ((u8_t *)&t)[1] = *ps;
+    *pd++ = *ps++;
+    left--;
+  }
+
+  if (((mem_ptr_t)ps & 2) && left > 1) {
+    h = *(const u16_t *)(const void *)ps;
+    SMEMCPY(pd, &h, 2);
+    sum += h;
+    ps += 2;
+    pd += 2;
+    left -= 2;
+  }
+
+#if LWIP_CHKSUM_SIMD
+  if (left >= 16) {
+    n = left >> 4;
+    sum += lwip_chksum_simd(pd, ps, n);
+    ps += n << 4;
+    pd += n << 4;
+    left -= n << 4;
+  }
+#endif /* LWIP_CHKSUM_SIMD */
+
+  while (left >= 16) {
+    w[0] = ((const u32_t *)(const void *)ps)[0];
+    w[1] = ((const u32_t *)(const void *)ps)[1];
+    w[2] = ((const u32_t *)(const void *)ps)[2];
+    w[3] = ((const u32_t *)(const void *)ps)[3];
+    SMEMCPY(pd, w, 16);
+    sum += w[0];
+    sum += w[1];
+    sum += w[2];
+    sum += w[3];
+    ps += 16;
+    pd += 16;
+    left -= 16;
+  }
+  while (left >= 4) {
+    w[0] = *(const u32_t *)(const void *)ps;
+    SMEMCPY(pd, w, 4);
+    sum += w[0];
+    ps += 4;
+    pd += 4;
+    left -= 4;
+  }
+
+  if (left > 1) {
+    h = *(const u16_t *)(const void *)ps;
+    SMEMCPY(pd, &h, 2);
+    sum += h;
+    ps += 2;
+    pd += 2;
+    left -= 2;
+  }
+
+  /* dangling tail byte remaining? */
+  if (left > 0) {
+    ((u8_t *)&t)[0] = *ps;
+    *pd = *ps;
+  }
+
+  sum += t;
+  acc = lwip_chksum_fold64(sum);
+
+  if (odd) {
+    acc = SWAP_BYTES_IN_WORD(acc);
+  }
+
+  return acc;
+}
+#endif /* (LWIP_CHKSUM_COPY_ALGORITHM == 2) */
@@ -114,6 +114,18 @@ PACK_STRUCT_END
 #if (LWIP_TCP && (MEMP_NUM_TCP_PCB<=0))
   #error "If you want to use TCP, you have to define MEMP_NUM_TCP_PCB>=1 in your lwipopts.h"
 #endif
+#if (UDP_PCB_HASH_SIZE & (UDP_PCB_HASH_SIZE - 1))
+  #error "UDP_PCB_HASH_SIZE must be 0 or a power of 2 in your lwipopts.h"
+#endif
+#if (TCP_PCB_HASH_SIZE & (TCP_PCB_HASH_SIZE - 1))
+  #error "TCP_PCB_HASH_SIZE must be 0 or a power of 2 in your lwipopts.h"
+#endif
+#if (TCPIP_RX_RING_SIZE & (TCPIP_RX_RING_SIZE - 1))
+  #error "TCPIP_RX_RING_SIZE must be 0 or a power of 2 in your lwipopts.h"
+#endif
+#if (TCPIP_RX_RING_SIZE && (NO_SYS || TCPIP_RX_BATCH < 1))
+  #error "TCPIP_RX_RING_SIZE needs NO_SYS==0 and TCPIP_RX_BATCH>=1 in your lwipopts.h"
+#endif
 #if (LWIP_IGMP && (MEMP_NUM_IGMP_GROUP<=1))
   #error "If you want to use IGMP, you have to define MEMP_NUM_IGMP_GROUP>1 in your lwipopts.h"
 #endif
@@ -224,6 +236,9 @@ PACK_STRUCT_END
 #if LWIP_TCPIP_CORE_LOCKING_INPUT && !LWIP_TCPIP_CORE_LOCKING
   #error "When using LWIP_TCPIP_CORE_LOCKING_INPUT, LWIP_TCPIP_CORE_LOCKING must be enabled, too"
 #endif
+#if LWIP_SOCKET_ZEROCOPY && !LWIP_SUPPORT_CUSTOM_PBUF
+  #error "LWIP_SOCKET_ZEROCOPY needs LWIP_SUPPORT_CUSTOM_PBUF"
+#endif
 #if LWIP_TCP && LWIP_NETIF_TX_SINGLE_PBUF && !TCP_OVERSIZE
   #error "LWIP_NETIF_TX_SINGLE_PBUF needs TCP_OVERSIZE enabled to create single-pbuf TCP packets"
 #endif
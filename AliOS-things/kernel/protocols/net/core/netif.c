@@ -291,6 +291,12 @@ netif_add(struct netif *netif,
   netif->loop_first = NULL;
   netif->loop_last = NULL;
 #endif /* ENABLE_LOOPBACK */
+#if TCPIP_RX_RING_SIZE
+  sys_ring_idx_init(&netif->rx_head, 0);
+  sys_ring_idx_init(&netif->rx_tail, 0);
+  sys_ring_idx_init(&netif->rx_sched, 0);
+  netif->rx_msg = NULL;
+#endif /* TCPIP_RX_RING_SIZE */
 
   /* remember netif specific state information data */
   netif->state = state;
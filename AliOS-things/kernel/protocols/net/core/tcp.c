@@ -127,6 +127,83 @@ struct tcp_pcb ** const tcp_pcb_lists[] = {&tcp_listen_pcbs.pcbs, &tcp_bound_pcb
 
 u8_t tcp_active_pcbs_changed;
 
+#if TCP_PCB_HASH_SIZE
+/** Active and TIME-WAIT PCBs by remote address and ports */
+struct tcp_pcb *tcp_conn_hash[TCP_PCB_HASH_SIZE];
+/** LISTEN PCBs by local port */
+struct tcp_pcb_listen *tcp_listen_hash[TCP_PCB_HASH_SIZE];
+
+/**
+ * Bucket of the connection table for a segment from remote_ip:remote_port
+ * to local_port. The local address is left out, it rarely differs between
+ * connections.
+ */
+u16_t
+tcp_conn_hash_idx(u16_t local_port, u16_t remote_port, const ip_addr_t *remote_ip)
+{
+  u32_t h;
+
+#if LWIP_IPV4 && LWIP_IPV6
+  h = IP_IS_V6(remote_ip) ? ip_2_ip6(remote_ip)->addr[3] : ip_2_ip4(remote_ip)->addr;
+#elif LWIP_IPV6
+  h = ip_2_ip6(remote_ip)->addr[3];
+#else
+  h = ip_2_ip4(remote_ip)->addr;
+#endif
+  h ^= ((u32_t)remote_port << 16) | local_port;
+  h ^= h >> 16;
+  h ^= h >> 8;
+  return (u16_t)(h & (TCP_PCB_HASH_SIZE - 1));
+}
+
+static struct tcp_pcb **
+tcp_pcb_hash_bucket(struct tcp_pcb **pcbs, struct tcp_pcb *pcb)
+{
+  if ((pcbs == &tcp_active_pcbs) || (pcbs == &tcp_tw_pcbs)) {
+    return &tcp_conn_hash[tcp_conn_hash_idx(pcb->local_port, pcb->remote_port, &pcb->remote_ip)];
+  }
+  if (pcbs == &tcp_listen_pcbs.pcbs) {
+    return (struct tcp_pcb **)&tcp_listen_hash[TCP_LISTEN_HASH(pcb->local_port)];
+  }
+  return NULL;
+}
+
+/**
+ * Adds a PCB that was just put on one of the PCB lists to the hash table
+ * of that list. Called through TCP_REG.
+ */
+void
+tcp_pcb_hash_add(struct tcp_pcb **pcbs, struct tcp_pcb *npcb)
+{
+  struct tcp_pcb **bucket = tcp_pcb_hash_bucket(pcbs, npcb);
+
+  if (bucket != NULL) {
+    npcb->hash_next = *bucket;
+    *bucket = npcb;
+  }
+}
+
+/**
+ * Removes a PCB that was just taken off one of the PCB lists from the hash
+ * table of that list. Called through TCP_RMV.
+ */
+void
+tcp_pcb_hash_rmv(struct tcp_pcb **pcbs, struct tcp_pcb *npcb)
+{
+  struct tcp_pcb **bucket = tcp_pcb_hash_bucket(pcbs, npcb);
+
+  if (bucket != NULL) {
+    for (; *bucket != NULL; bucket = &(*bucket)->hash_next) {
+      if (*bucket == npcb) {
+        *bucket = npcb->hash_next;
+        break;
+      }
+    }
+    npcb->hash_next = NULL;
+  }
+}
+#endif /* TCP_PCB_HASH_SIZE */
+
 /** Timer counter to handle calling slow-timer from tcp_tmr() */
 static u8_t tcp_timer;
 static u8_t tcp_timer_ctr;
@@ -1101,6 +1178,7 @@ tcp_slowtmr_start:
       void *err_arg;
       tcp_pcb_purge(pcb);
       /* Remove PCB from tcp_active_pcbs list. */
+      TCP_HASH_RMV(&tcp_active_pcbs, pcb);
       if (prev != NULL) {
         LWIP_ASSERT("tcp_slowtmr: middle tcp != tcp_active_pcbs", pcb != tcp_active_pcbs);
         prev->next = pcb->next;
@@ -1166,6 +1244,7 @@ tcp_slowtmr_start:
       struct tcp_pcb *pcb2;
       tcp_pcb_purge(pcb);
       /* Remove PCB from tcp_tw_pcbs list. */
+      TCP_HASH_RMV(&tcp_tw_pcbs, pcb);
       if (prev != NULL) {
         LWIP_ASSERT("tcp_slowtmr: middle tcp != tcp_tw_pcbs", pcb != tcp_tw_pcbs);
         prev->next = pcb->next;
@@ -222,6 +222,28 @@ tcp_input(struct pbuf *p, struct netif *inp)
      for an active connection. */
   prev = NULL;
 
+#if TCP_PCB_HASH_SIZE
+  /* Active and TIME-WAIT connections share the table, a 4-tuple can only
+     be in one of the two lists. */
+  for (pcb = tcp_conn_hash[tcp_conn_hash_idx(tcphdr->dest, tcphdr->src, ip_current_src_addr())];
+       pcb != NULL; pcb = pcb->hash_next) {
+    LWIP_ASSERT("tcp_input: hashed pcb->state != CLOSED", pcb->state != CLOSED);
+    LWIP_ASSERT("tcp_input: hashed pcb->state != LISTEN", pcb->state != LISTEN);
+    if (pcb->remote_port == tcphdr->src &&
+        pcb->local_port == tcphdr->dest &&
+        ip_addr_cmp(&pcb->remote_ip, ip_current_src_addr()) &&
+        ip_addr_cmp(&pcb->local_ip, ip_current_dest_addr())) {
+      break;
+    }
+  }
+
+  if (pcb != NULL && pcb->state == TIME_WAIT) {
+    LWIP_DEBUGF(TCP_INPUT_DEBUG, ("tcp_input: packed for TIME_WAITing connection.\n"));
+    tcp_timewait_input(pcb);
+    pbuf_free(p);
+    return;
+  }
+#else /* TCP_PCB_HASH_SIZE */
   for (pcb = tcp_active_pcbs; pcb != NULL; pcb = pcb->next) {
     LWIP_ASSERT("tcp_input: active pcb->state != CLOSED", pcb->state != CLOSED);
     LWIP_ASSERT("tcp_input: active pcb->state != TIME-WAIT", pcb->state != TIME_WAIT);
@@ -246,8 +268,10 @@ tcp_input(struct pbuf *p, struct netif *inp)
     }
     prev = pcb;
   }
+#endif /* TCP_PCB_HASH_SIZE */
 
   if (pcb == NULL) {
+#if !TCP_PCB_HASH_SIZE
     /* If it did not go to an active connection, we check the connections
        in the TIME-WAIT state. */
     for (pcb = tcp_tw_pcbs; pcb != NULL; pcb = pcb->next) {
@@ -265,11 +289,16 @@ tcp_input(struct pbuf *p, struct netif *inp)
         return;
       }
     }
+#endif /* !TCP_PCB_HASH_SIZE */
 
     /* Finally, if we still did not get a match, we check all PCBs that
        are LISTENing for incoming connections. */
     prev = NULL;
+#if TCP_PCB_HASH_SIZE
+    for (lpcb = tcp_listen_hash[TCP_LISTEN_HASH(tcphdr->dest)]; lpcb != NULL; lpcb = lpcb->hash_next) {
+#else /* TCP_PCB_HASH_SIZE */
     for (lpcb = tcp_listen_pcbs.listen_pcbs; lpcb != NULL; lpcb = lpcb->next) {
+#endif /* TCP_PCB_HASH_SIZE */
       if (lpcb->local_port == tcphdr->dest) {
         if (IP_IS_ANY_TYPE_VAL(lpcb->local_ip)) {
           /* found an ANY TYPE (IPv4/IPv6) match */
@@ -296,6 +325,9 @@ tcp_input(struct pbuf *p, struct netif *inp)
       }
       prev = (struct tcp_pcb *)lpcb;
     }
+#if TCP_PCB_HASH_SIZE
+    LWIP_UNUSED_ARG(prev); /* the hash chains are not reordered */
+#endif /* TCP_PCB_HASH_SIZE */
 #if SO_REUSE
     /* first try specific local IP */
     if (lpcb == NULL) {
@@ -305,6 +337,7 @@ tcp_input(struct pbuf *p, struct netif *inp)
     }
 #endif /* SO_REUSE */
     if (lpcb != NULL) {
+#if !TCP_PCB_HASH_SIZE
       /* Move this PCB to the front of the list so that subsequent
          lookups will be faster (we exploit locality in TCP segment
          arrivals). */
@@ -317,6 +350,7 @@ tcp_input(struct pbuf *p, struct netif *inp)
       } else {
         TCP_STATS_INC(tcp.cachehit);
       }
+#endif /* !TCP_PCB_HASH_SIZE */
 
       LWIP_DEBUGF(TCP_INPUT_DEBUG, ("tcp_input: packed for LISTENing connection.\n"));
       tcp_listen_input(lpcb);
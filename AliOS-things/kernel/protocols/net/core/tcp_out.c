@@ -347,25 +347,65 @@ tcp_write_checks(struct tcp_pcb *pcb, u16_t len)
   return ERR_OK;
 }
 
+#if LWIP_SOCKET_ZEROCOPY
+/** Free-callback function to free a 'struct pbuf_custom_ref' created by
+ * tcp_pbuf_nocopy(), called by pbuf_free once the data has been acked. */
+static void
+tcp_free_ref_pbuf(struct pbuf *p)
+{
+  struct pbuf_custom_ref *pcr = (struct pbuf_custom_ref*)p;
+  struct pbuf *original = pcr->original;
+
+  memp_free(MEMP_TCP_REF_PBUF, pcr);
+  pbuf_free(original);
+}
+#endif /* LWIP_SOCKET_ZEROCOPY */
+
 /**
- * @ingroup tcp_raw
- * Write data for sending (but does not send it immediately).
+ * Allocate a pbuf referencing 'len' bytes of non-volatile data at 'data'.
  *
- * It waits in the expectation of more data being sent soon (as
- * it can send them more efficiently by combining them together).
- * To prompt the system to send data now, call tcp_output() after
- * calling tcp_write().
- *
- * @param pcb Protocol control block for the TCP connection to enqueue data for.
- * @param arg Pointer to the data to be enqueued for sending.
- * @param len Data length in bytes
- * @param apiflags combination of following flags :
- * - TCP_WRITE_FLAG_COPY (0x01) data will be copied into memory belonging to the stack
- * - TCP_WRITE_FLAG_MORE (0x02) for TCP connection, PSH flag will not be set on last segment sent,
- * @return ERR_OK if enqueued, another err_t on error
+ * Without 'ref' this is a plain PBUF_ROM. With 'ref', it is a custom
+ * PBUF_REF that holds a reference on 'ref' until TCP frees it.
  */
-err_t
-tcp_write(struct tcp_pcb *pcb, const void *arg, u16_t len, u8_t apiflags)
+static struct pbuf *
+tcp_pbuf_nocopy(pbuf_layer layer, const u8_t *data, u16_t len, struct pbuf *ref)
+{
+  struct pbuf *p;
+
+#if LWIP_SOCKET_ZEROCOPY
+  if (ref != NULL) {
+    struct pbuf_custom_ref *pcr = (struct pbuf_custom_ref*)memp_malloc(MEMP_TCP_REF_PBUF);
+    if (pcr == NULL) {
+      return NULL;
+    }
+    p = pbuf_alloced_custom(PBUF_RAW, len, PBUF_REF, &pcr->pc,
+      (void*)(mem_ptr_t)data, len);
+    LWIP_ASSERT("tcp_pbuf_nocopy: PBUF_RAW custom pbuf", p != NULL);
+    pbuf_ref(ref);
+    pcr->original = ref;
+    pcr->pc.custom_free_function = tcp_free_ref_pbuf;
+    return p;
+  }
+#else /* LWIP_SOCKET_ZEROCOPY */
+  LWIP_UNUSED_ARG(ref);
+#endif /* LWIP_SOCKET_ZEROCOPY */
+
+  p = pbuf_alloc(layer, len, PBUF_ROM);
+  if (p != NULL) {
+    /* reference the non-volatile payload data */
+    ((struct pbuf_rom*)p)->payload = data;
+  }
+  return p;
+}
+
+/**
+ * Common part of tcp_write() and tcp_write_ref(): 'ref', if not NULL,
+ * is the pbuf owning 'arg' and is referenced by every pbuf enqueued
+ * without copying.
+ */
+static err_t
+tcp_write_ext(struct tcp_pcb *pcb, const void *arg, u16_t len, u8_t apiflags,
+              struct pbuf *ref)
 {
   struct pbuf *concat_p = NULL;
   struct tcp_seg *last_unsent = NULL, *seg = NULL, *prev_seg = NULL, *queue = NULL;
@@ -508,7 +548,7 @@ tcp_write(struct tcp_pcb *pcb, const void *arg, u16_t len, u8_t apiflags)
 #endif /* TCP_CHECKSUM_ON_COPY */
       } else {
         /* Data is not copied */
-        if ((concat_p = pbuf_alloc(PBUF_RAW, seglen, PBUF_ROM)) == NULL) {
+        if ((concat_p = tcp_pbuf_nocopy(PBUF_RAW, (const u8_t*)arg + pos, seglen, ref)) == NULL) {
           LWIP_DEBUGF(TCP_OUTPUT_DEBUG | LWIP_DBG_LEVEL_SERIOUS,
                       ("tcp_write: could not allocate memory for zero-copy pbuf\n"));
           goto memerr;
@@ -519,8 +559,6 @@ tcp_write(struct tcp_pcb *pcb, const void *arg, u16_t len, u8_t apiflags)
           &concat_chksum, &concat_chksum_swapped);
         concat_chksummed += seglen;
 #endif /* TCP_CHECKSUM_ON_COPY */
-        /* reference the non-volatile payload data */
-        ((struct pbuf_rom*)concat_p)->payload = (const u8_t*)arg + pos;
       }
 
       pos += seglen;
@@ -564,12 +602,13 @@ tcp_write(struct tcp_pcb *pcb, const void *arg, u16_t len, u8_t apiflags)
        * Since the referenced data is available at least until it is
        * sent out on the link (as it has to be ACKed by the remote
        * party) we can safely use PBUF_ROM instead of PBUF_REF here.
+       * With 'ref', a custom PBUF_REF keeps the owning pbuf alive.
        */
       struct pbuf *p2;
 #if TCP_OVERSIZE
       LWIP_ASSERT("oversize == 0", oversize == 0);
 #endif /* TCP_OVERSIZE */
-      if ((p2 = pbuf_alloc(PBUF_TRANSPORT, seglen, PBUF_ROM)) == NULL) {
+      if ((p2 = tcp_pbuf_nocopy(PBUF_TRANSPORT, (const u8_t*)arg + pos, seglen, ref)) == NULL) {
         LWIP_DEBUGF(TCP_OUTPUT_DEBUG | LWIP_DBG_LEVEL_SERIOUS, ("tcp_write: could not allocate memory for zero-copy pbuf\n"));
         goto memerr;
       }
@@ -581,8 +620,6 @@ tcp_write(struct tcp_pcb *pcb, const void *arg, u16_t len, u8_t apiflags)
         chksum = SWAP_BYTES_IN_WORD(chksum);
       }
 #endif /* TCP_CHECKSUM_ON_COPY */
-      /* reference the non-volatile payload data */
-      ((struct pbuf_rom*)p2)->payload = (const u8_t*)arg + pos;
 
       /* Second, allocate a pbuf for the headers. */
       if ((p = pbuf_alloc(PBUF_TRANSPORT, optlen, PBUF_RAM)) == NULL) {
@@ -737,6 +774,55 @@ memerr:
   return ERR_MEM;
 }
 
+/**
+ * @ingroup tcp_raw
+ * Write data for sending (but does not send it immediately).
+ *
+ * It waits in the expectation of more data being sent soon (as
+ * it can send them more efficiently by combining them together).
+ * To prompt the system to send data now, call tcp_output() after
+ * calling tcp_write().
+ *
+ * @param pcb Protocol control block for the TCP connection to enqueue data for.
+ * @param arg Pointer to the data to be enqueued for sending.
+ * @param len Data length in bytes
+ * @param apiflags combination of following flags :
+ * - TCP_WRITE_FLAG_COPY (0x01) data will be copied into memory belonging to the stack
+ * - TCP_WRITE_FLAG_MORE (0x02) for TCP connection, PSH flag will not be set on last segment sent,
+ * @return ERR_OK if enqueued, another err_t on error
+ */
+err_t
+tcp_write(struct tcp_pcb *pcb, const void *arg, u16_t len, u8_t apiflags)
+{
+  return tcp_write_ext(pcb, arg, len, apiflags, NULL);
+}
+
+#if LWIP_SOCKET_ZEROCOPY
+/**
+ * @ingroup tcp_raw
+ * Write data owned by a pbuf for sending without copying it.
+ *
+ * Like tcp_write() without TCP_WRITE_FLAG_COPY, but every pbuf enqueued
+ * for the data holds a reference on 'ref', so 'ref' is only freed after
+ * the remote side has acked the data. The caller keeps its own reference.
+ *
+ * @param pcb Protocol control block for the TCP connection to enqueue data for.
+ * @param arg Pointer to the data to be enqueued for sending, inside 'ref'.
+ * @param len Data length in bytes
+ * @param apiflags TCP_WRITE_FLAG_MORE or 0 (TCP_WRITE_FLAG_COPY is ignored)
+ * @param ref pbuf owning the data at 'arg'
+ * @return ERR_OK if enqueued, another err_t on error
+ */
+err_t
+tcp_write_ref(struct tcp_pcb *pcb, const void *arg, u16_t len, u8_t apiflags,
+              struct pbuf *ref)
+{
+  LWIP_ERROR("tcp_write_ref: ref == NULL (programmer violates API)",
+             ref != NULL, return ERR_ARG;);
+  return tcp_write_ext(pcb, arg, len, (u8_t)(apiflags & ~TCP_WRITE_FLAG_COPY), ref);
+}
+#endif /* LWIP_SOCKET_ZEROCOPY */
+
 /**
  * Enqueue TCP options for transmission.
  *
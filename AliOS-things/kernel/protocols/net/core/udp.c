@@ -80,6 +80,42 @@ static u16_t udp_port = UDP_LOCAL_PORT_RANGE_START;
 /* exported in udp.h (was static) */
 struct udp_pcb *udp_pcbs;
 
+#if UDP_PCB_HASH_SIZE
+/* The PCBs of udp_pcbs by local port, so that input and binding only
+   look at the PCBs sharing a port. */
+static struct udp_pcb *udp_pcb_hash[UDP_PCB_HASH_SIZE];
+
+#define UDP_PCB_HASH(port)        (((port) ^ ((port) >> 8)) & (UDP_PCB_HASH_SIZE - 1))
+#define UDP_PCB_FIRST(port)       udp_pcb_hash[UDP_PCB_HASH(port)]
+#define UDP_PCB_NEXT(pcb)         ((pcb)->hash_next)
+
+static void
+udp_pcb_hash_add(struct udp_pcb *pcb)
+{
+  pcb->hash_next = UDP_PCB_FIRST(pcb->local_port);
+  UDP_PCB_FIRST(pcb->local_port) = pcb;
+}
+
+static void
+udp_pcb_hash_rmv(struct udp_pcb *pcb)
+{
+  struct udp_pcb **ppcb;
+
+  for (ppcb = &UDP_PCB_FIRST(pcb->local_port); *ppcb != NULL; ppcb = &(*ppcb)->hash_next) {
+    if (*ppcb == pcb) {
+      *ppcb = pcb->hash_next;
+      break;
+    }
+  }
+  pcb->hash_next = NULL;
+}
+#else /* UDP_PCB_HASH_SIZE */
+#define UDP_PCB_FIRST(port)       udp_pcbs
+#define UDP_PCB_NEXT(pcb)         ((pcb)->next)
+#define udp_pcb_hash_add(pcb)
+#define udp_pcb_hash_rmv(pcb)
+#endif /* UDP_PCB_HASH_SIZE */
+
 /**
  * Initialize this module.
  */
@@ -108,7 +144,7 @@ again:
     udp_port = UDP_LOCAL_PORT_RANGE_START;
   }
   /* Check all PCBs. */
-  for (pcb = udp_pcbs; pcb != NULL; pcb = pcb->next) {
+  for (pcb = UDP_PCB_FIRST(udp_port); pcb != NULL; pcb = UDP_PCB_NEXT(pcb)) {
     if (pcb->local_port == udp_port) {
       if (++n > (UDP_LOCAL_PORT_RANGE_END - UDP_LOCAL_PORT_RANGE_START)) {
         return 0;
@@ -262,7 +298,7 @@ udp_input(struct pbuf *p, struct netif *inp)
    * 'Perfect match' pcbs (connected to the remote port & ip address) are
    * preferred. If no perfect match is found, the first unconnected pcb that
    * matches the local port and ip address gets the datagram. */
-  for (pcb = udp_pcbs; pcb != NULL; pcb = pcb->next) {
+  for (pcb = UDP_PCB_FIRST(dest); pcb != NULL; pcb = UDP_PCB_NEXT(pcb)) {
     /* print the PCB local and remote address */
     LWIP_DEBUGF(UDP_DEBUG, ("pcb ("));
     ip_addr_debug_print(UDP_DEBUG, &pcb->local_ip);
@@ -289,6 +325,7 @@ udp_input(struct pbuf *p, struct netif *inp)
           (ip_addr_isany_val(pcb->remote_ip) ||
           ip_addr_cmp(&pcb->remote_ip, ip_current_src_addr()))) {
         /* the first fully matching PCB */
+#if !UDP_PCB_HASH_SIZE
         if (prev != NULL) {
           /* move the pcb to the front of udp_pcbs so that is
              found faster next time */
@@ -298,12 +335,16 @@ udp_input(struct pbuf *p, struct netif *inp)
         } else {
           UDP_STATS_INC(udp.cachehit);
         }
+#endif /* !UDP_PCB_HASH_SIZE */
         break;
       }
     }
 
     prev = pcb;
   }
+#if UDP_PCB_HASH_SIZE
+  LWIP_UNUSED_ARG(prev); /* the hash chains are not reordered */
+#endif /* UDP_PCB_HASH_SIZE */
   /* no fully matching pcb found? then look for an unconnected pcb */
   if (pcb == NULL) {
     pcb = uncon_pcb;
@@ -381,7 +422,7 @@ udp_input(struct pbuf *p, struct netif *inp)
         struct udp_pcb *mpcb;
         u8_t p_header_changed = 0;
         s16_t hdrs_len = (s16_t)(ip_current_header_tot_len() + UDP_HLEN);
-        for (mpcb = udp_pcbs; mpcb != NULL; mpcb = mpcb->next) {
+        for (mpcb = UDP_PCB_FIRST(dest); mpcb != NULL; mpcb = UDP_PCB_NEXT(mpcb)) {
           if (mpcb != pcb) {
             /* compare PCB local addr+port to UDP destination addr+port */
             if ((mpcb->local_port == dest) &&
@@ -941,7 +982,7 @@ udp_bind(struct udp_pcb *pcb, const ip_addr_t *ipaddr, u16_t port)
       return ERR_USE;
     }
   } else {
-    for (ipcb = udp_pcbs; ipcb != NULL; ipcb = ipcb->next) {
+    for (ipcb = UDP_PCB_FIRST(port); ipcb != NULL; ipcb = UDP_PCB_NEXT(ipcb)) {
       if (pcb != ipcb) {
       /* By default, we don't allow to bind to a port that any other udp
          PCB is already bound to, unless *all* PCBs with that port have tha
@@ -967,6 +1008,9 @@ udp_bind(struct udp_pcb *pcb, const ip_addr_t *ipaddr, u16_t port)
 
   ip_addr_set_ipaddr(&pcb->local_ip, ipaddr);
 
+  if (rebind) {
+    udp_pcb_hash_rmv(pcb);
+  }
   pcb->local_port = port;
   mib2_udp_bind(pcb);
   /* pcb not active yet? */
@@ -975,6 +1019,7 @@ udp_bind(struct udp_pcb *pcb, const ip_addr_t *ipaddr, u16_t port)
     pcb->next = udp_pcbs;
     udp_pcbs = pcb;
   }
+  udp_pcb_hash_add(pcb);
   LWIP_DEBUGF(UDP_DEBUG | LWIP_DBG_TRACE | LWIP_DBG_STATE, ("udp_bind: bound to "));
   ip_addr_debug_print(UDP_DEBUG | LWIP_DBG_TRACE | LWIP_DBG_STATE, &pcb->local_ip);
   LWIP_DEBUGF(UDP_DEBUG | LWIP_DBG_TRACE | LWIP_DBG_STATE, (", port %"U16_F")\n", pcb->local_port));
@@ -1034,6 +1079,7 @@ udp_connect(struct udp_pcb *pcb, const ip_addr_t *ipaddr, u16_t port)
   /* PCB not yet on the list, add PCB now */
   pcb->next = udp_pcbs;
   udp_pcbs = pcb;
+  udp_pcb_hash_add(pcb);
   return ERR_OK;
 }
 
@@ -1098,6 +1144,7 @@ udp_remove(struct udp_pcb *pcb)
   if (udp_pcbs == pcb) {
     /* make list start at 2nd pcb */
     udp_pcbs = udp_pcbs->next;
+    udp_pcb_hash_rmv(pcb);
     /* pcb not 1st in list */
   } else {
     for (pcb2 = udp_pcbs; pcb2 != NULL; pcb2 = pcb2->next) {
@@ -1105,6 +1152,7 @@ udp_remove(struct udp_pcb *pcb)
       if (pcb2->next != NULL && pcb2->next == pcb) {
         /* remove pcb from list */
         pcb2->next = pcb->next;
+        udp_pcb_hash_rmv(pcb);
         break;
       }
     }
@@ -322,6 +322,10 @@ err_t   netconn_write_partly(struct netconn *conn, const void *dataptr, size_t s
 /** @ingroup netconn_tcp */
 #define netconn_write(conn, dataptr, size, apiflags) \
           netconn_write_partly(conn, dataptr, size, apiflags, NULL)
+#if LWIP_SOCKET_ZEROCOPY
+err_t   netconn_write_pbuf(struct netconn *conn, struct pbuf *p, u8_t apiflags,
+                           size_t *bytes_written);
+#endif /* LWIP_SOCKET_ZEROCOPY */
 err_t   netconn_close(struct netconn *conn);
 err_t   netconn_shutdown(struct netconn *conn, u8_t shut_rx, u8_t shut_tx);
 
@@ -58,7 +58,7 @@
 # ifndef LWIP_CHKSUM_COPY
 #  define LWIP_CHKSUM_COPY(dst, src, len) lwip_chksum_copy(dst, src, len)
 #  ifndef LWIP_CHKSUM_COPY_ALGORITHM
-#   define LWIP_CHKSUM_COPY_ALGORITHM 1
+#   define LWIP_CHKSUM_COPY_ALGORITHM 2
 #  endif /* LWIP_CHKSUM_COPY_ALGORITHM */
 # else /* LWIP_CHKSUM_COPY */
 #  define LWIP_CHKSUM_COPY_ALGORITHM 0
@@ -48,6 +48,9 @@
 #include "lwip/def.h"
 #include "lwip/pbuf.h"
 #include "lwip/stats.h"
+#if TCPIP_RX_RING_SIZE
+#include "lwip/sys.h"
+#endif /* TCPIP_RX_RING_SIZE */
 
 #ifdef __cplusplus
 extern "C" {
@@ -338,6 +341,16 @@ struct netif {
   u16_t loop_cnt_current;
 #endif /* LWIP_LOOPBACK_MAX_PBUFS */
 #endif /* ENABLE_LOOPBACK */
+#if TCPIP_RX_RING_SIZE
+  /** Packets queued by tcpip_input_ring() for tcpip_thread. The driver
+   * advances rx_tail, tcpip_thread advances rx_head, both free running. */
+  struct pbuf *rx_ring[TCPIP_RX_RING_SIZE];
+  sys_ring_idx_t rx_head;
+  sys_ring_idx_t rx_tail;
+  /** 1 while a drain of rx_ring is posted to or running in tcpip_thread */
+  sys_ring_idx_t rx_sched;
+  struct tcpip_callback_msg *rx_msg;
+#endif /* TCPIP_RX_RING_SIZE */
 };
 
 #if LWIP_CHECKSUM_CTRL_PER_NETIF
@@ -409,6 +409,15 @@
 #define MEMP_NUM_FRAG_PBUF              15
 #endif
 
+/**
+ * MEMP_NUM_TCP_REF_PBUF: the number of application pbuf pieces that can be
+ * queued on TCP send queues at the same time by tcp_write_ref().
+ * This is only used with LWIP_SOCKET_ZEROCOPY==1.
+ */
+#if !defined MEMP_NUM_TCP_REF_PBUF || defined __DOXYGEN__
+#define MEMP_NUM_TCP_REF_PBUF           TCP_SND_QUEUELEN
+#endif
+
 /**
  * MEMP_NUM_ARP_QUEUE: the number of simultaneously queued outgoing
  * packets (pbufs) that are waiting for an ARP request (to resolve
@@ -1098,6 +1107,15 @@
 #if !defined LWIP_NETBUF_RECVINFO || defined __DOXYGEN__
 #define LWIP_NETBUF_RECVINFO            0
 #endif
+
+/**
+ * UDP_PCB_HASH_SIZE: Number of buckets (a power of 2) of the table that
+ * indexes bound UDP PCBs by local port, so udp_input() and udp_bind() only
+ * look at the PCBs of one port. 0 walks the udp_pcbs list instead.
+ */
+#if !defined UDP_PCB_HASH_SIZE || defined __DOXYGEN__
+#define UDP_PCB_HASH_SIZE               0
+#endif
 /**
  * @}
  */
@@ -1246,6 +1264,16 @@
 #define TCP_DEFAULT_LISTEN_BACKLOG      0xff
 #endif
 
+/**
+ * TCP_PCB_HASH_SIZE: Number of buckets (a power of 2) of the tables that
+ * index active and TIME-WAIT PCBs by address and ports, and LISTEN PCBs
+ * by local port, so tcp_input() finds the PCB of a segment without walking
+ * all connections. 0 walks the PCB lists instead.
+ */
+#if !defined TCP_PCB_HASH_SIZE || defined __DOXYGEN__
+#define TCP_PCB_HASH_SIZE               0
+#endif
+
 /**
  * TCP_OVERSIZE: The maximum number of bytes that tcp_write may
  * allocate ahead of time in an attempt to create shorter pbuf chains
@@ -1550,6 +1578,26 @@
 #define TCPIP_MBOX_SIZE                 0
 #endif
 
+/**
+ * TCPIP_RX_RING_SIZE: Number of received packets each netif can queue for
+ * tcpip_thread through tcpip_input_ring(), a power of 2. The ring is lock-free
+ * for one producer (the driver's RX thread or interrupt) and tcpip_thread;
+ * only the first packet after the ring went idle posts to the mbox, so no
+ * message is allocated per packet. 0 leaves the ring out.
+ */
+#if !defined TCPIP_RX_RING_SIZE || defined __DOXYGEN__
+#define TCPIP_RX_RING_SIZE              0
+#endif
+
+/**
+ * TCPIP_RX_BATCH: Maximum number of packets tcpip_thread takes from one
+ * netif's input ring per wakeup. The remainder is requeued behind the
+ * messages already in the mbox, so API calls and timers are not starved.
+ */
+#if !defined TCPIP_RX_BATCH || defined __DOXYGEN__
+#define TCPIP_RX_BATCH                  16
+#endif
+
 /**
  * Define this to something that triggers a watchdog. This is called from
  * tcpip_thread after processing a message.
@@ -1849,6 +1897,16 @@
 #if !defined LWIP_SOCKET_SEND_NOCOPY || defined __DOXYGEN__
 #define LWIP_SOCKET_SEND_NOCOPY         0
 #endif
+
+/**
+ * LWIP_SOCKET_ZEROCOPY==1: Enable lwip_recv_pbuf() and lwip_send_pbuf(),
+ * which pass pbuf chains between the application and the stack without
+ * copying. TCP data sent this way stays referenced until it is acked, so
+ * this needs LWIP_SUPPORT_CUSTOM_PBUF and MEMP_NUM_TCP_REF_PBUF.
+ */
+#if !defined LWIP_SOCKET_ZEROCOPY || defined __DOXYGEN__
+#define LWIP_SOCKET_ZEROCOPY            0
+#endif
 /**
  * @}
  */
@@ -110,6 +110,10 @@ struct api_msg {
 #if LWIP_SO_SNDTIMEO
       u32_t time_started;
 #endif /* LWIP_SO_SNDTIMEO */
+#if LWIP_SOCKET_ZEROCOPY
+      /** pbuf owning dataptr, enqueued by reference if not NULL */
+      struct pbuf *ref;
+#endif /* LWIP_SOCKET_ZEROCOPY */
     } w;
     /** used for lwip_netconn_do_recv */
     struct {
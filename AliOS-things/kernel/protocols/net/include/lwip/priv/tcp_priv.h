@@ -241,6 +241,21 @@ err_t            tcp_process_refused_data(struct tcp_pcb *pcb);
 /** Don't generate checksum on copy if CHECKSUM_GEN_TCP is disabled */
 #define TCP_CHECKSUM_ON_COPY  (LWIP_CHECKSUM_ON_COPY && CHECKSUM_GEN_TCP)
 
+#if LWIP_SOCKET_ZEROCOPY
+#ifndef LWIP_PBUF_CUSTOM_REF_DEFINED
+#define LWIP_PBUF_CUSTOM_REF_DEFINED
+/** A custom pbuf that holds a reference to another pbuf, which is freed
+ * when this custom pbuf is freed. This is used to create a custom PBUF_REF
+ * that points into the original pbuf. */
+struct pbuf_custom_ref {
+  /** 'base class' */
+  struct pbuf_custom pc;
+  /** pointer to the original pbuf that is referenced */
+  struct pbuf *original;
+};
+#endif /* LWIP_PBUF_CUSTOM_REF_DEFINED */
+#endif /* LWIP_SOCKET_ZEROCOPY */
+
 /* This structure represents a TCP segment on the unsent, unacked and ooseq queues */
 struct tcp_seg {
   struct tcp_seg *next;    /* used when putting segments on a queue */
@@ -325,6 +340,26 @@ extern struct tcp_pcb *tcp_tw_pcbs;      /* List of all TCP PCBs in TIME-WAIT. *
 #define NUM_TCP_PCB_LISTS               4
 extern struct tcp_pcb ** const tcp_pcb_lists[NUM_TCP_PCB_LISTS];
 
+#if TCP_PCB_HASH_SIZE
+/* Hash tables over the PCB lists: active and TIME-WAIT PCBs are indexed
+   by remote address and both ports, LISTEN PCBs by local port. Bound PCBs
+   are not indexed. TCP_REG and TCP_RMV keep the tables in step with the
+   lists, code that unlinks a PCB by hand must call TCP_HASH_RMV too. */
+extern struct tcp_pcb *tcp_conn_hash[TCP_PCB_HASH_SIZE];
+extern struct tcp_pcb_listen *tcp_listen_hash[TCP_PCB_HASH_SIZE];
+
+#define TCP_LISTEN_HASH(port) (((port) ^ ((port) >> 8)) & (TCP_PCB_HASH_SIZE - 1))
+u16_t tcp_conn_hash_idx(u16_t local_port, u16_t remote_port, const ip_addr_t *remote_ip);
+void tcp_pcb_hash_add(struct tcp_pcb **pcbs, struct tcp_pcb *npcb);
+void tcp_pcb_hash_rmv(struct tcp_pcb **pcbs, struct tcp_pcb *npcb);
+
+#define TCP_HASH_ADD(pcbs, npcb) tcp_pcb_hash_add(pcbs, npcb)
+#define TCP_HASH_RMV(pcbs, npcb) tcp_pcb_hash_rmv(pcbs, npcb)
+#else /* TCP_PCB_HASH_SIZE */
+#define TCP_HASH_ADD(pcbs, npcb)
+#define TCP_HASH_RMV(pcbs, npcb)
+#endif /* TCP_PCB_HASH_SIZE */
+
 /* Axioms about the above lists:
    1) Every TCP PCB that is not CLOSED is in one of the lists.
    2) A PCB is only in one of the lists.
@@ -349,6 +384,7 @@ extern struct tcp_pcb ** const tcp_pcb_lists[NUM_TCP_PCB_LISTS];
                             (npcb)->next = *(pcbs); \
                             LWIP_ASSERT("TCP_REG: npcb->next != npcb", (npcb)->next != (npcb)); \
                             *(pcbs) = (npcb); \
+                            TCP_HASH_ADD(pcbs, npcb); \
                             LWIP_ASSERT("TCP_RMV: tcp_pcbs sane", tcp_pcbs_sane()); \
               tcp_timer_needed(); \
                             } while(0)
@@ -365,6 +401,7 @@ extern struct tcp_pcb ** const tcp_pcb_lists[NUM_TCP_PCB_LISTS];
                                } \
                             } \
                             (npcb)->next = NULL; \
+                            TCP_HASH_RMV(pcbs, npcb); \
                             LWIP_ASSERT("TCP_RMV: tcp_pcbs sane", tcp_pcbs_sane()); \
                             LWIP_DEBUGF(TCP_DEBUG, ("TCP_RMV: removed %p from %p\n", (npcb), *(pcbs))); \
                             } while(0)
@@ -375,6 +412,7 @@ extern struct tcp_pcb ** const tcp_pcb_lists[NUM_TCP_PCB_LISTS];
   do {                                             \
     (npcb)->next = *pcbs;                          \
     *(pcbs) = (npcb);                              \
+    TCP_HASH_ADD(pcbs, npcb);                      \
     tcp_timer_needed();                            \
   } while (0)
 
@@ -395,6 +433,7 @@ extern struct tcp_pcb ** const tcp_pcb_lists[NUM_TCP_PCB_LISTS];
       }                                            \
     }                                              \
     (npcb)->next = NULL;                           \
+    TCP_HASH_RMV(pcbs, npcb);                      \
   } while(0)
 
 #endif /* LWIP_DEBUG */
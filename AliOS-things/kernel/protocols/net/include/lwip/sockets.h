@@ -514,6 +514,25 @@ int lwip_ioctl(int s, long cmd, void *argp);
 int lwip_fcntl(int s, int cmd, int val);
 int lwip_eventfd(unsigned int initval, int flags);
 
+/** readiness of a socket passed to a lwip_sock_notify_t */
+#define LWIP_SOCK_EVT_RCV   0x01
+#define LWIP_SOCK_EVT_SEND  0x02
+#define LWIP_SOCK_EVT_ERR   0x04
+
+/** called when a socket turns ready, with SYS_ARCH protection held, so it
+    must not block, like sys_sem_signal() */
+typedef void (*lwip_sock_notify_t)(int s, int evt, void *arg);
+int lwip_sock_notify(int s, lwip_sock_notify_t notify, void *arg);
+
+#if LWIP_SOCKET_ZEROCOPY
+struct pbuf;
+/** zero-copy receive: *p is handed over to the caller, who frees it */
+int lwip_recv_pbuf(int s, struct pbuf **p, int flags,
+      struct sockaddr *from, socklen_t *fromlen);
+/** zero-copy send: TCP keeps a reference on each pbuf of p until acked */
+int lwip_send_pbuf(int s, struct pbuf *p, int flags);
+#endif /* LWIP_SOCKET_ZEROCOPY */
+
 #if LWIP_COMPAT_SOCKETS
 #if LWIP_COMPAT_SOCKETS != 2
 /** @ingroup socket */
@@ -165,11 +165,18 @@ enum tcp_state {
   TIME_WAIT   = 10
 };
 
+#if TCP_PCB_HASH_SIZE
+#define TCP_PCB_HASH_NEXT(type) type *hash_next; /* for the hash bucket */
+#else
+#define TCP_PCB_HASH_NEXT(type)
+#endif
+
 /**
  * members common to struct tcp_pcb and struct tcp_listen_pcb
  */
 #define TCP_PCB_COMMON(type) \
   type *next; /* for the linked list */ \
+  TCP_PCB_HASH_NEXT(type) \
   void *callback_arg; \
   enum tcp_state state; /* TCP state */ \
   u8_t prio; \
@@ -401,6 +408,10 @@ err_t            tcp_shutdown(struct tcp_pcb *pcb, int shut_rx, int shut_tx);
 
 err_t            tcp_write   (struct tcp_pcb *pcb, const void *dataptr, u16_t len,
                               u8_t apiflags);
+#if LWIP_SOCKET_ZEROCOPY
+err_t            tcp_write_ref(struct tcp_pcb *pcb, const void *dataptr, u16_t len,
+                               u8_t apiflags, struct pbuf *ref);
+#endif /* LWIP_SOCKET_ZEROCOPY */
 
 void             tcp_setprio (struct tcp_pcb *pcb, u8_t prio);
 
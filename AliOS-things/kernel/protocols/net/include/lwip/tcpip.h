@@ -76,6 +76,9 @@ void   tcpip_init(tcpip_init_done_fn tcpip_init_done, void *arg);
 
 err_t  tcpip_inpkt(struct pbuf *p, struct netif *inp, netif_input_fn input_fn);
 err_t  tcpip_input(struct pbuf *p, struct netif *inp);
+#if TCPIP_RX_RING_SIZE
+err_t  tcpip_input_ring(struct pbuf *p, struct netif *inp);
+#endif /* TCPIP_RX_RING_SIZE */
 
 err_t  tcpip_callback_with_block(tcpip_callback_fn function, void *ctx, u8_t block);
 /**
@@ -24,4 +24,10 @@ $(NAME)_SOURCES += $(NETIFFILES)
 $(NAME)_SOURCES += $(TFTPFILES)
 $(NAME)_SOURCES += port/sys_arch.c
 
+# "aos_bench=1" on the make line adds the benchmark cli commands
+ifeq ($(aos_bench),1)
+$(NAME)_SOURCES += port/lwip_bench.c
+GLOBAL_DEFINES  += CONFIG_AOS_BENCH
+endif
+
 endif
@@ -77,5 +77,16 @@ typedef aos_queue_t sys_mbox_t;
 
 typedef void *sys_thread_t;
 
+/* ordered index accesses for the tcpip_thread input rings (TCPIP_RX_RING_SIZE) */
+#include <k_atomic.h>
+
+typedef rhino_atomic_idx_t sys_ring_idx_t;
+
+#define sys_ring_idx_init(idx, v)       rhino_atomic_idx_init(idx, v)
+#define sys_ring_load_relaxed(idx)      rhino_atomic_load_relaxed(idx)
+#define sys_ring_load_acquire(idx)      rhino_atomic_load_acquire(idx)
+#define sys_ring_store_release(idx, v)  rhino_atomic_store_release(idx, v)
+#define sys_ring_cas(idx, expect, v)    rhino_atomic_cas_weak(idx, expect, v)
+
 #endif /* LWIP_ARCH_SYS_ARCH_H */
 
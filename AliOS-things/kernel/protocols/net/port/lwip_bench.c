@@ -0,0 +1,660 @@
+/*
+ * Copyright (C) 2015-2017 Alibaba Group Holding Limited
+ */
+
+#include <string.h>
+#include <aos/aos.h>
+
+#include "lwip/opt.h"
+#include "lwip/inet_chksum.h"
+#include "lwip/ip4.h"
+#include "lwip/netif.h"
+#include "lwip/pbuf.h"
+#include "lwip/sys.h"
+#include "lwip/tcp.h"
+#include "lwip/tcpip.h"
+#include "lwip/udp.h"
+#include "lwip/prot/tcp.h"
+#include "lwip/prot/udp.h"
+
+#ifdef CONFIG_AOS_CLI
+#define LWIP_BENCH_PCB (LWIP_IPV4 && LWIP_TCP && LWIP_UDP && LWIP_CALLBACK_API)
+#define LWIP_BENCH_RX  (LWIP_IPV4 && LWIP_UDP && LWIP_CALLBACK_API && !NO_SYS)
+
+#if LWIP_BENCH_PCB || LWIP_BENCH_RX
+/*
+ * The runs hand synthetic packets from a made up subnet to a private netif
+ * whose output is dropped, so only the stack runs.
+ */
+#define LWIP_BENCH_TCP_PORT 7000
+#define LWIP_BENCH_UDP_PORT 20000
+
+/* 10.99.0.1/16 is the netif, the peers are 10.99.1.0 and up */
+#define LWIP_BENCH_NET      0x0a630000UL
+#define LWIP_BENCH_PEER(i)  (LWIP_BENCH_NET + 0x100 + (i))
+
+static struct netif   g_bench_netif;
+static u32_t          g_bench_synack_seqno;
+static volatile u32_t g_bench_rx;
+
+static err_t lwip_bench_output(struct netif *netif, struct pbuf *p, const ip4_addr_t *ipaddr)
+{
+    struct ip_hdr  *iph = (struct ip_hdr *)p->payload;
+    struct tcp_hdr *tcph;
+
+    /* remember the ISS of the last SYN|ACK for the handshake */
+    if (IPH_PROTO(iph) == IP_PROTO_TCP && p->len >= IP_HLEN + TCP_HLEN) {
+        tcph = (struct tcp_hdr *)((u8_t *)p->payload + IPH_HL(iph) * 4);
+        if ((TCPH_FLAGS(tcph) & (TCP_SYN | TCP_ACK)) == (TCP_SYN | TCP_ACK)) {
+            g_bench_synack_seqno = lwip_ntohl(tcph->seqno);
+        }
+    }
+
+    return ERR_OK;
+}
+
+static err_t lwip_bench_netif_init(struct netif *netif)
+{
+    netif->name[0] = 'b';
+    netif->name[1] = 'n';
+    netif->mtu     = 1500;
+    netif->output  = lwip_bench_output;
+    return ERR_OK;
+}
+
+static struct pbuf *lwip_bench_ip(u32_t peer, u8_t proto, u16_t len)
+{
+    struct pbuf   *p;
+    struct ip_hdr *iph;
+
+    p = pbuf_alloc(PBUF_RAW, IP_HLEN + len, PBUF_RAM);
+    if (p == NULL) {
+        return NULL;
+    }
+
+    iph = (struct ip_hdr *)p->payload;
+    IPH_VHL_SET(iph, 4, IP_HLEN / 4);
+    IPH_TOS_SET(iph, 0);
+    IPH_LEN_SET(iph, lwip_htons(IP_HLEN + len));
+    IPH_ID_SET(iph, 0);
+    IPH_OFFSET_SET(iph, 0);
+    IPH_TTL_SET(iph, 64);
+    IPH_PROTO_SET(iph, proto);
+    iph->src.addr  = lwip_htonl(peer);
+    iph->dest.addr = ip4_addr_get_u32(netif_ip4_addr(&g_bench_netif));
+    IPH_CHKSUM_SET(iph, 0);
+    IPH_CHKSUM_SET(iph, inet_chksum(iph, IP_HLEN));
+    return p;
+}
+
+static struct pbuf *lwip_bench_udp_pbuf(u16_t i)
+{
+    struct pbuf    *p;
+    struct udp_hdr *udph;
+
+    p = lwip_bench_ip(LWIP_BENCH_PEER(i), IP_PROTO_UDP, UDP_HLEN + 1);
+    if (p == NULL) {
+        return NULL;
+    }
+
+    udph = (struct udp_hdr *)((u8_t *)p->payload + IP_HLEN);
+    udph->src    = lwip_htons(49152 + (i & 0x3ff));
+    udph->dest   = lwip_htons(LWIP_BENCH_UDP_PORT + i);
+    udph->len    = lwip_htons(UDP_HLEN + 1);
+    udph->chksum = 0;
+    *((u8_t *)udph + UDP_HLEN) = 'x';
+    return p;
+}
+
+static void lwip_bench_udp_recv(void *arg, struct udp_pcb *pcb, struct pbuf *p,
+                                const ip_addr_t *addr, u16_t port)
+{
+    g_bench_rx++;
+    pbuf_free(p);
+}
+
+static err_t lwip_bench_netif_add(netif_input_fn input)
+{
+    ip4_addr_t ipaddr;
+    ip4_addr_t netmask;
+    ip4_addr_t gw;
+
+    ip4_addr_set_u32(&ipaddr, lwip_htonl(LWIP_BENCH_NET + 1));
+    ip4_addr_set_u32(&netmask, PP_HTONL(0xffff0000UL));
+    ip4_addr_set_zero(&gw);
+    if (netif_add(&g_bench_netif, &ipaddr, &netmask, &gw, NULL,
+                  lwip_bench_netif_init, input) == NULL) {
+        aos_cli_printf("lwip_bench: no netif\r\n");
+        return ERR_IF;
+    }
+    netif_set_up(&g_bench_netif);
+    netif_set_link_up(&g_bench_netif);
+    return ERR_OK;
+}
+#endif /* LWIP_BENCH_PCB || LWIP_BENCH_RX */
+
+#if LWIP_BENCH_PCB
+/*
+ * "lwip_bench pcb": input demultiplexing cost against growing numbers of
+ * PCBs, packets go straight to ip4_input(). For each count, that many TCP
+ * connections are opened to one listener through a replayed handshake and
+ * that many UDP PCBs are bound, then LWIP_BENCH_PKTS one byte packets go
+ * to them in a scattered order. Counts the PCB pools cannot hold are cut
+ * short and reported as such.
+ */
+#define LWIP_BENCH_PKTS     20000
+
+typedef struct {
+    struct tcp_pcb *pcb;
+    u32_t           seqno;  /* next peer sequence number */
+    u32_t           ackno;  /* our sequence number the peer acks */
+} lwip_bench_conn_t;
+
+static const u16_t g_bench_counts[] = { 10, 100, 500, 1000, 2000 };
+
+static lwip_bench_conn_t *g_bench_conns;
+static u16_t              g_bench_nconns;
+
+static void lwip_bench_tcp_seg(u16_t i, u8_t flags, u16_t len)
+{
+    struct pbuf    *p;
+    struct tcp_hdr *tcph;
+    ip4_addr_t      src;
+
+    p = lwip_bench_ip(LWIP_BENCH_PEER(i), IP_PROTO_TCP, TCP_HLEN + len);
+    if (p == NULL) {
+        return;
+    }
+
+    tcph = (struct tcp_hdr *)((u8_t *)p->payload + IP_HLEN);
+    tcph->src   = lwip_htons(49152 + (i & 0x3ff));
+    tcph->dest  = lwip_htons(LWIP_BENCH_TCP_PORT);
+    tcph->seqno = lwip_htonl(g_bench_conns[i].seqno);
+    tcph->ackno = lwip_htonl(g_bench_conns[i].ackno);
+    TCPH_HDRLEN_FLAGS_SET(tcph, TCP_HLEN / 4, flags);
+    tcph->wnd    = PP_HTONS(0xffff);
+    tcph->chksum = 0;
+    tcph->urgp   = 0;
+    memset((u8_t *)tcph + TCP_HLEN, 'x', len);
+
+    ip4_addr_set_u32(&src, lwip_htonl(LWIP_BENCH_PEER(i)));
+    pbuf_header(p, -IP_HLEN);
+    tcph->chksum = inet_chksum_pseudo(p, IP_PROTO_TCP, p->tot_len,
+                                      &src, netif_ip4_addr(&g_bench_netif));
+    pbuf_header(p, IP_HLEN);
+
+    g_bench_conns[i].seqno += len + ((flags & TCP_SYN) ? 1 : 0);
+    ip4_input(p, &g_bench_netif);
+}
+
+static void lwip_bench_udp_dgram(u16_t i)
+{
+    struct pbuf *p = lwip_bench_udp_pbuf(i);
+
+    if (p != NULL) {
+        ip4_input(p, &g_bench_netif);
+    }
+}
+
+static err_t lwip_bench_tcp_recv(void *arg, struct tcp_pcb *pcb, struct pbuf *p, err_t err)
+{
+    if (p != NULL) {
+        g_bench_rx++;
+        tcp_recved(pcb, p->tot_len);
+        pbuf_free(p);
+    }
+
+    return ERR_OK;
+}
+
+static err_t lwip_bench_accept(void *arg, struct tcp_pcb *pcb, err_t err)
+{
+    u32_t i = lwip_ntohl(ip4_addr_get_u32(ip_2_ip4(&pcb->remote_ip))) - LWIP_BENCH_PEER(0);
+
+    if (err != ERR_OK || i >= g_bench_nconns) {
+        return ERR_VAL;
+    }
+
+    g_bench_conns[i].pcb = pcb;
+    tcp_recv(pcb, lwip_bench_tcp_recv);
+    return ERR_OK;
+}
+
+/* scattered visiting order: a stride coprime to n */
+static u16_t lwip_bench_pick(u32_t k, u16_t n)
+{
+    return (u16_t)((k * 7919) % n);
+}
+
+static u16_t lwip_bench_tcp_open(u16_t n)
+{
+    u16_t i;
+
+    for (i = 0; i < n; i++) {
+        g_bench_conns[i].seqno = 1000 * i;
+        g_bench_conns[i].ackno = 0;
+        g_bench_synack_seqno   = 0;
+        lwip_bench_tcp_seg(i, TCP_SYN, 0);
+        if (g_bench_synack_seqno == 0) {
+            break;
+        }
+
+        g_bench_conns[i].ackno = g_bench_synack_seqno + 1;
+        lwip_bench_tcp_seg(i, TCP_ACK, 0);
+        if (g_bench_conns[i].pcb == NULL) {
+            break;
+        }
+    }
+
+    return i;
+}
+
+static void lwip_bench_pcb_run(u16_t n)
+{
+    struct tcp_pcb  *pcb;
+    struct tcp_pcb  *lpcb = NULL;
+    struct udp_pcb **upcbs;
+    u16_t            ntcp;
+    u16_t            nudp;
+    u32_t            start;
+    u32_t            tcp_ms;
+    u32_t            udp_ms;
+    u32_t            k;
+    u16_t            i;
+
+    g_bench_conns = (lwip_bench_conn_t *)aos_zalloc(n * sizeof(lwip_bench_conn_t));
+    upcbs = (struct udp_pcb **)aos_zalloc(n * sizeof(struct udp_pcb *));
+    pcb = tcp_new();
+    if (pcb != NULL && (tcp_bind(pcb, &g_bench_netif.ip_addr, LWIP_BENCH_TCP_PORT) != ERR_OK ||
+                        (lpcb = tcp_listen(pcb)) == NULL)) {
+        tcp_close(pcb);
+    }
+    if (g_bench_conns == NULL || upcbs == NULL || lpcb == NULL) {
+        aos_cli_printf("lwip_bench: out of memory\r\n");
+        goto out;
+    }
+    tcp_accept(lpcb, lwip_bench_accept);
+
+    g_bench_nconns = n;
+    ntcp = lwip_bench_tcp_open(n);
+
+    for (nudp = 0; nudp < n; nudp++) {
+        upcbs[nudp] = udp_new();
+        if (upcbs[nudp] == NULL) {
+            break;
+        }
+        if (udp_bind(upcbs[nudp], &g_bench_netif.ip_addr, LWIP_BENCH_UDP_PORT + nudp) != ERR_OK) {
+            udp_remove(upcbs[nudp]);
+            upcbs[nudp] = NULL;
+            break;
+        }
+        udp_recv(upcbs[nudp], lwip_bench_udp_recv, NULL);
+    }
+
+    g_bench_rx = 0;
+    start = sys_now();
+    for (k = 0; ntcp > 0 && k < LWIP_BENCH_PKTS; k++) {
+        lwip_bench_tcp_seg(lwip_bench_pick(k, ntcp), TCP_ACK | TCP_PSH, 1);
+    }
+    tcp_ms = sys_now() - start;
+
+    start = sys_now();
+    for (k = 0; nudp > 0 && k < LWIP_BENCH_PKTS; k++) {
+        lwip_bench_udp_dgram(lwip_bench_pick(k, nudp));
+    }
+    udp_ms = sys_now() - start;
+
+    aos_cli_printf("%4d pcbs: tcp %4d conns %6d ns/seg, udp %4d pcbs %6d ns/dgram, %d delivered\r\n",
+                   (int)n, (int)ntcp, (int)(tcp_ms * 1000000ULL / LWIP_BENCH_PKTS),
+                   (int)nudp, (int)(udp_ms * 1000000ULL / LWIP_BENCH_PKTS), (int)g_bench_rx);
+
+out:
+    for (i = 0; g_bench_conns != NULL && i < n; i++) {
+        if (g_bench_conns[i].pcb != NULL) {
+            tcp_abort(g_bench_conns[i].pcb);
+        }
+    }
+    for (i = 0; upcbs != NULL && i < n && upcbs[i] != NULL; i++) {
+        udp_remove(upcbs[i]);
+    }
+    if (lpcb != NULL) {
+        tcp_close(lpcb);
+    }
+    aos_free(upcbs);
+    aos_free(g_bench_conns);
+    g_bench_conns  = NULL;
+    g_bench_nconns = 0;
+}
+
+static void lwip_bench_pcb(void)
+{
+    int i;
+
+    if (lwip_bench_netif_add(ip4_input) != ERR_OK) {
+        return;
+    }
+
+    for (i = 0; i < sizeof(g_bench_counts) / sizeof(g_bench_counts[0]); i++) {
+        lwip_bench_pcb_run(g_bench_counts[i]);
+    }
+
+    netif_remove(&g_bench_netif);
+}
+#endif /* LWIP_BENCH_PCB */
+
+#if !NO_SYS
+typedef struct {
+    void    (*run)(void);
+    sys_sem_t done;
+} lwip_bench_req_t;
+
+static void lwip_bench_call(void *arg)
+{
+    lwip_bench_req_t *req = (lwip_bench_req_t *)arg;
+
+    req->run();
+    sys_sem_signal(&req->done);
+}
+#endif /* !NO_SYS */
+
+/* the raw API is only called from tcpip_thread */
+static void lwip_bench_core(void (*run)(void))
+{
+#if !NO_SYS
+    lwip_bench_req_t req;
+
+    req.run = run;
+    if (sys_sem_new(&req.done, 0) != ERR_OK) {
+        return;
+    }
+
+    if (tcpip_callback(lwip_bench_call, &req) == ERR_OK) {
+        sys_arch_sem_wait(&req.done, 0);
+    }
+    sys_sem_free(&req.done);
+#else
+    run();
+#endif
+}
+
+#if LWIP_BENCH_RX
+/*
+ * "lwip_bench rx": packet rate from a driver into tcpip_thread. The calling
+ * thread stands in for the RX interrupt and hands LWIP_BENCH_RX_PKTS one
+ * byte UDP datagrams for one bound PCB to each input path: tcpip_input(),
+ * which posts a message per packet, and tcpip_input_ring() when
+ * TCPIP_RX_RING_SIZE is set. Packets the mbox or ring cannot take are
+ * dropped, the rate counts delivered datagrams up to the last one.
+ */
+#define LWIP_BENCH_RX_PKTS  100000
+
+static const struct {
+    const char    *name;
+    netif_input_fn input;
+} g_bench_rx_paths[] = {
+    { "tcpip_input",      tcpip_input },
+#if TCPIP_RX_RING_SIZE
+    { "tcpip_input_ring", tcpip_input_ring },
+#endif
+};
+
+static struct udp_pcb *g_bench_rx_pcb;
+static volatile u32_t  g_bench_rx_last;
+
+static void lwip_bench_rx_recv(void *arg, struct udp_pcb *pcb, struct pbuf *p,
+                               const ip_addr_t *addr, u16_t port)
+{
+    g_bench_rx++;
+    g_bench_rx_last = sys_now();
+    pbuf_free(p);
+}
+
+static void lwip_bench_rx_setup(void)
+{
+    if (lwip_bench_netif_add(tcpip_input) != ERR_OK) {
+        return;
+    }
+
+    g_bench_rx_pcb = udp_new();
+    if (g_bench_rx_pcb != NULL &&
+        udp_bind(g_bench_rx_pcb, &g_bench_netif.ip_addr, LWIP_BENCH_UDP_PORT) != ERR_OK) {
+        udp_remove(g_bench_rx_pcb);
+        g_bench_rx_pcb = NULL;
+    }
+    if (g_bench_rx_pcb == NULL) {
+        aos_cli_printf("lwip_bench: no udp pcb\r\n");
+        netif_remove(&g_bench_netif);
+        return;
+    }
+    udp_recv(g_bench_rx_pcb, lwip_bench_rx_recv, NULL);
+}
+
+static void lwip_bench_rx_teardown(void)
+{
+    udp_remove(g_bench_rx_pcb);
+    g_bench_rx_pcb = NULL;
+    netif_remove(&g_bench_netif);
+#if TCPIP_RX_RING_SIZE
+    if (g_bench_netif.rx_msg != NULL) {
+        tcpip_callbackmsg_delete(g_bench_netif.rx_msg);
+        g_bench_netif.rx_msg = NULL;
+    }
+#endif
+}
+
+static void lwip_bench_rx(void)
+{
+    struct pbuf *p;
+    u32_t        start;
+    u32_t        drops;
+    u32_t        ms;
+    u32_t        k;
+    int          i;
+
+    lwip_bench_core(lwip_bench_rx_setup);
+    if (g_bench_rx_pcb == NULL) {
+        return;
+    }
+
+    for (i = 0; i < sizeof(g_bench_rx_paths) / sizeof(g_bench_rx_paths[0]); i++) {
+        g_bench_rx = 0;
+        drops = 0;
+        start = sys_now();
+        g_bench_rx_last = start;
+        for (k = 0; k < LWIP_BENCH_RX_PKTS; k++) {
+            p = lwip_bench_udp_pbuf(0);
+            if (p == NULL) {
+                drops++;
+            } else if (g_bench_rx_paths[i].input(p, &g_bench_netif) != ERR_OK) {
+                pbuf_free(p);
+                drops++;
+            }
+        }
+        /* wait for tcpip_thread to catch up */
+        while (g_bench_rx + drops < LWIP_BENCH_RX_PKTS && sys_now() - start < 10000) {
+            aos_msleep(1);
+        }
+
+        ms = g_bench_rx_last - start;
+        aos_cli_printf("%-16s %6d delivered %6d dropped %8d pps\r\n",
+                       g_bench_rx_paths[i].name, (int)g_bench_rx, (int)drops,
+                       (int)(ms ? g_bench_rx * 1000ULL / ms : 0));
+    }
+
+    lwip_bench_core(lwip_bench_rx_teardown);
+}
+#endif /* LWIP_BENCH_RX */
+
+/*
+ * "lwip_bench chksum": MB/s of inet_chksum() and, with LWIP_CHECKSUM_ON_COPY,
+ * of MEMCPY followed by inet_chksum() against the fused LWIP_CHKSUM_COPY(),
+ * for each buffer size and source alignment. Each figure runs for
+ * LWIP_BENCH_CHKSUM_MS. Results are checked against a byte at a time
+ * RFC 1071 sum first.
+ */
+#define LWIP_BENCH_CHKSUM_MS 100
+
+enum {
+    LWIP_BENCH_CHKSUM,
+    LWIP_BENCH_CHKSUM_MEMCPY,
+    LWIP_BENCH_CHKSUM_FUSED
+};
+
+static const u16_t g_bench_chksum_sizes[] = { 20, 64, 256, 576, 1460, 4096 };
+
+static volatile u16_t g_bench_chksum_sink;
+
+static u16_t lwip_bench_chksum_ref(const u8_t *p, u16_t len)
+{
+    u32_t acc = 0;
+    u16_t i;
+
+    for (i = 0; i + 1 < len; i += 2) {
+        acc += (p[i] << 8) | p[i + 1];
+    }
+    if (len & 1) {
+        acc += p[len - 1] << 8;
+    }
+    acc = FOLD_U32T(acc);
+    acc = FOLD_U32T(acc);
+    return (u16_t)~lwip_htons((u16_t)acc);
+}
+
+/* MB/s of one mode, dst is aligned and src is not */
+static u32_t lwip_bench_chksum_rate(int mode, u8_t *dst, const u8_t *src, u16_t len)
+{
+    u32_t start = sys_now();
+    u32_t calls = 0;
+    u32_t ms;
+    u16_t sum = 0;
+    int   k;
+
+    do {
+        switch (mode) {
+            case LWIP_BENCH_CHKSUM:
+                for (k = 0; k < 64; k++) {
+                    sum += inet_chksum(src, len);
+                }
+                break;
+#if LWIP_CHECKSUM_ON_COPY
+            case LWIP_BENCH_CHKSUM_MEMCPY:
+                for (k = 0; k < 64; k++) {
+                    MEMCPY(dst, src, len);
+                    sum += inet_chksum(dst, len);
+                }
+                break;
+            case LWIP_BENCH_CHKSUM_FUSED:
+                for (k = 0; k < 64; k++) {
+                    sum += LWIP_CHKSUM_COPY(dst, src, len);
+                }
+                break;
+#endif /* LWIP_CHECKSUM_ON_COPY */
+            default:
+                return 0;
+        }
+        calls += 64;
+        ms = sys_now() - start;
+    } while (ms < LWIP_BENCH_CHKSUM_MS);
+
+    g_bench_chksum_sink = sum;
+    return (u32_t)((unsigned long long)calls * len / (ms * 1000));
+}
+
+static void lwip_bench_chksum(void)
+{
+    u8_t *src;
+    u8_t *dst;
+    u16_t len;
+    int   i;
+    int   a;
+    int   k;
+
+    src = (u8_t *)aos_malloc(4096 + 4);
+    dst = (u8_t *)aos_malloc(4096 + 4);
+    if (src == NULL || dst == NULL) {
+        aos_cli_printf("lwip_bench: out of memory\r\n");
+        goto out;
+    }
+    for (k = 0; k < 4096 + 4; k++) {
+        src[k] = (u8_t)(k * 7 + (k >> 8));
+    }
+
+    aos_cli_printf(" size align chksum MB/s  memcpy+chksum MB/s  fused MB/s\r\n");
+    for (i = 0; i < sizeof(g_bench_chksum_sizes) / sizeof(g_bench_chksum_sizes[0]); i++) {
+        len = g_bench_chksum_sizes[i];
+        for (a = 0; a < 4; a++) {
+            if (inet_chksum(src + a, len) != lwip_bench_chksum_ref(src + a, len)) {
+                aos_cli_printf("lwip_bench: chksum mismatch at size %d align %d\r\n", (int)len, a);
+            }
+#if LWIP_CHECKSUM_ON_COPY
+            memset(dst, 0, len);
+            if ((u16_t)~LWIP_CHKSUM_COPY(dst, src + a, len) != lwip_bench_chksum_ref(src + a, len) ||
+                memcmp(dst, src + a, len) != 0) {
+                aos_cli_printf("lwip_bench: copy mismatch at size %d align %d\r\n", (int)len, a);
+            }
+#endif /* LWIP_CHECKSUM_ON_COPY */
+
+            aos_cli_printf("%5d %5d %11d %19d %11d\r\n", (int)len, a,
+                           (int)lwip_bench_chksum_rate(LWIP_BENCH_CHKSUM, dst, src + a, len),
+                           (int)lwip_bench_chksum_rate(LWIP_BENCH_CHKSUM_MEMCPY, dst, src + a, len),
+                           (int)lwip_bench_chksum_rate(LWIP_BENCH_CHKSUM_FUSED, dst, src + a, len));
+        }
+    }
+
+out:
+    aos_free(src);
+    aos_free(dst);
+}
+
+static const struct {
+    const char *name;
+    void      (*run)(void);
+    u8_t        core;  /* run in tcpip_thread */
+} lwip_bench_runs[] = {
+#if LWIP_BENCH_PCB
+    { "pcb",    lwip_bench_pcb,    1 },
+#endif
+#if LWIP_BENCH_RX
+    { "rx",     lwip_bench_rx,     0 },
+#endif
+    { "chksum", lwip_bench_chksum, 0 },
+    { NULL, NULL, 0 }
+};
+
+static void handle_lwip_bench_cmd(char *pwbuf, int blen, int argc, char **argv)
+{
+    int i;
+
+    for (i = 0; argc > 1 && lwip_bench_runs[i].name != NULL; i++) {
+        if (strcmp(argv[1], lwip_bench_runs[i].name) == 0) {
+            break;
+        }
+    }
+
+    if (argc < 2 || lwip_bench_runs[i].name == NULL) {
+        aos_cli_printf("usage: lwip_bench <run>, runs:");
+        for (i = 0; lwip_bench_runs[i].name != NULL; i++) {
+            aos_cli_printf(" %s", lwip_bench_runs[i].name);
+        }
+        aos_cli_printf("\r\n");
+        return;
+    }
+
+    if (lwip_bench_runs[i].core) {
+        lwip_bench_core(lwip_bench_runs[i].run);
+    } else {
+        lwip_bench_runs[i].run();
+    }
+}
+
+static struct cli_command lwip_bench_cmd = {
+    "lwip_bench",
+    "lwip stack benchmarks, pcb: input demultiplexing against 10-2000 pcbs, rx: driver to tcpip_thread pps, chksum: checksum and copy MB/s",
+    handle_lwip_bench_cmd
+};
+
+void lwip_bench_init(void)
+{
+    aos_cli_register_command(&lwip_bench_cmd);
+}
+#endif /* CONFIG_AOS_CLI */
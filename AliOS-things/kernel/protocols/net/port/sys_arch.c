@@ -42,6 +42,10 @@
 
 static aos_mutex_t sys_arch_mutex;
 
+#if defined(CONFIG_AOS_CLI) && defined(CONFIG_AOS_BENCH)
+void lwip_bench_init(void);
+#endif
+
 //#define      NET_TASK_NUME 2
 //#define      NET_TASK_STACK_SIZE 1024
 
@@ -636,5 +640,8 @@ int net_close(int sockfd)
 void sys_init(void)
 {
     aos_mutex_new(&sys_arch_mutex);
+#if defined(CONFIG_AOS_CLI) && defined(CONFIG_AOS_BENCH)
+    lwip_bench_init();
+#endif
 }
 
@@ -79,6 +79,9 @@ if not aos_global_config.get('use_private_lwip'):
     component = aos_component('net', src)
     component.add_global_includes('include', 'port/include')
     component.add_global_macros('CONFIG_NET_LWIP')
+    if aos_global_config.get('aos_bench') == '1':
+        component.add_sources('port/lwip_bench.c')
+        component.add_global_macros('CONFIG_AOS_BENCH')
 
 else:
     component = aos_component('net', [])
@@ -32,6 +32,77 @@ extern atomic_val_t rhino_atomic_clear(atomic_t *target);
 extern int rhino_atomic_cas(atomic_t *target, atomic_val_t old_value,
 			                atomic_val_t new_value);
 
+/*
+ * Ordered accesses for the lock-free rings. C11 <stdatomic.h> is used where
+ * the compiler provides it, the gcc __atomic builtins otherwise and, as a
+ * last resort on single core parts, plain volatile accesses plus the
+ * interrupt masking rhino_atomic_cas() above (RHINO_CONFIG_ATOMIC_GENERIC).
+ *
+ * rhino_atomic_idx_t is a free running 32 bit index, the _u8 variants act on
+ * single bytes of a plain buffer which another context polls.
+ * rhino_atomic_fence_acquire() orders plain loads before a later relaxed
+ * index load, for readers which check the index after copying the data.
+ */
+#if defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201112L) && !defined(__STDC_NO_ATOMICS__)
+#include <stdatomic.h>
+
+typedef atomic_uint rhino_atomic_idx_t;
+
+#define rhino_atomic_idx_init(p, v)      atomic_init((p), (v))
+#define rhino_atomic_load_relaxed(p)     atomic_load_explicit((p), memory_order_relaxed)
+#define rhino_atomic_load_acquire(p)     atomic_load_explicit((p), memory_order_acquire)
+#define rhino_atomic_store_release(p, v) atomic_store_explicit((p), (v), memory_order_release)
+#define rhino_atomic_fence_acquire()     atomic_thread_fence(memory_order_acquire)
+#define rhino_atomic_cas_weak(p, o, n)                                         \
+        atomic_compare_exchange_weak_explicit((p), (o), (n),                   \
+                                              memory_order_acq_rel,            \
+                                              memory_order_relaxed)
+
+#define rhino_atomic_load_acquire_u8(p)                                        \
+        atomic_load_explicit((_Atomic uint8_t *)(p), memory_order_acquire)
+#define rhino_atomic_store_release_u8(p, v)                                    \
+        atomic_store_explicit((_Atomic uint8_t *)(p), (v), memory_order_release)
+
+#elif defined(__GNUC__)
+typedef unsigned int rhino_atomic_idx_t;
+
+#define rhino_atomic_idx_init(p, v)      (*(p) = (v))
+#define rhino_atomic_load_relaxed(p)     __atomic_load_n((p), __ATOMIC_RELAXED)
+#define rhino_atomic_load_acquire(p)     __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define rhino_atomic_store_release(p, v) __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#define rhino_atomic_fence_acquire()     __atomic_thread_fence(__ATOMIC_ACQUIRE)
+#define rhino_atomic_cas_weak(p, o, n)                                         \
+        __atomic_compare_exchange_n((p), (o), (n), 1, __ATOMIC_ACQ_REL,        \
+                                    __ATOMIC_RELAXED)
+
+#define rhino_atomic_load_acquire_u8(p)     __atomic_load_n((uint8_t *)(p), __ATOMIC_ACQUIRE)
+#define rhino_atomic_store_release_u8(p, v) __atomic_store_n((uint8_t *)(p), (v), __ATOMIC_RELEASE)
+
+#else
+typedef volatile atomic_t rhino_atomic_idx_t;
+
+#define rhino_atomic_idx_init(p, v)      (*(p) = (v))
+#define rhino_atomic_load_relaxed(p)     (*(p))
+#define rhino_atomic_load_acquire(p)     (*(p))
+#define rhino_atomic_store_release(p, v) (*(p) = (v))
+#define rhino_atomic_fence_acquire()
+
+static inline int rhino_atomic_cas_weak(rhino_atomic_idx_t *target,
+                                        atomic_val_t *expect, atomic_val_t value)
+{
+    if (rhino_atomic_cas((atomic_t *)target, *expect, value)) {
+        return 1;
+    }
+
+    *expect = *target;
+
+    return 0;
+}
+
+#define rhino_atomic_load_acquire_u8(p)     (*(volatile uint8_t *)(p))
+#define rhino_atomic_store_release_u8(p, v) (*(volatile uint8_t *)(p) = (v))
+#endif
+
 #ifdef __cplusplus
 }
 #endif
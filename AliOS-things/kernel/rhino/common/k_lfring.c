@@ -0,0 +1,988 @@
+/*
+ * Copyright (C) 2015-2017 Alibaba Group Holding Limited
+ */
+
+#include "k_api.h"
+#include "k_lfring.h"
+
+#if (RHINO_CONFIG_RINGBUF_LOCKFREE > 0)
+
+/* indexes are free running 32 bit counters, keep the ring within half of it */
+#define LFRING_SIZE_MAX     0x80000000u
+
+#define LFRING_IS_POW2(x)   (((x) != 0u) && (((x) & ((x) - 1u)) == 0u))
+
+/*
+ * dyn record helpers, shared by both ring kinds
+ */
+static kstat_t lfring_dyn_len_chk(uint32_t mask, size_t len)
+{
+    if ((len == 0u) || (len > LFRING_DYN_LEN_MAXVALUE)) {
+        return RHINO_INV_PARAM;
+    }
+
+    if (COMPRESS_LEN(len) + len > (size_t)mask + 1u) {
+        return RHINO_INV_PARAM;
+    }
+
+    return RHINO_SUCCESS;
+}
+
+/* bytes taken by a record of rec bytes written at index t, pad included */
+RHINO_INLINE uint32_t lfring_dyn_span(uint32_t mask, uint32_t t, size_t rec)
+{
+    uint32_t off;
+
+    off = t & mask;
+    if (off + rec > mask + 1u) {
+        return (uint32_t)rec + (mask + 1u - off);
+    }
+
+    return (uint32_t)rec;
+}
+
+/*
+ * Record at index h, a pad is skipped. NULL if its first header byte is
+ * still 0, that is not yet published by an mpsc producer.
+ */
+static uint8_t *lfring_dyn_get(uint8_t *buf, uint32_t mask, uint32_t h,
+                               size_t *len, uint32_t *next)
+{
+    uint8_t *p;
+    uint8_t  first;
+    size_t   hdr;
+
+    p     = &buf[h & mask];
+    first = rhino_atomic_load_acquire_u8(p);
+
+    if (first == LFRING_PAD) {
+        h    += mask + 1u - (h & mask);
+        p     = buf;
+        first = rhino_atomic_load_acquire_u8(p);
+    }
+
+    if (first == 0u) {
+        return NULL;
+    }
+
+    if (first < RINGBUF_LEN_VLE_2BYTES) {
+        hdr = 1u;
+    } else if (first < RINGBUF_LEN_VLE_3BYTES) {
+        hdr = 2u;
+    } else {
+        hdr = 3u;
+    }
+
+    *len  = ringbuf_headlen_decompress(hdr, p);
+    *next = h + (uint32_t)(hdr + *len);
+
+    return p + hdr;
+}
+
+/* fill the record at p, the first header byte is left for the caller */
+RHINO_INLINE void lfring_dyn_fill(uint8_t *p, const uint8_t *c_len, size_t hdr,
+                                  const void *data, size_t len)
+{
+    if (hdr > 1u) {
+        memcpy(p + 1, &c_len[1], hdr - 1u);
+    }
+
+    if (data != NULL) {
+        memcpy(p + hdr, data, len);
+    }
+}
+
+static kstat_t lfring_init_chk(size_t len, size_t type, size_t block_size)
+{
+    if ((len == 0u) || (len > LFRING_SIZE_MAX)) {
+        return RHINO_INV_PARAM;
+    }
+
+    if (type == RINGBUF_TYPE_DYN) {
+        return LFRING_IS_POW2(len) ? RHINO_SUCCESS : RHINO_INV_PARAM;
+    }
+
+    if ((type != RINGBUF_TYPE_FIX) || (block_size == 0u) || (block_size > len)) {
+        return RHINO_INV_PARAM;
+    }
+
+    return RHINO_SUCCESS;
+}
+
+/*
+ * single producer single consumer
+ */
+kstat_t krhino_spsc_ring_init(k_spsc_ring_t *ring, void *buf, size_t len,
+                              size_t type, size_t block_size)
+{
+    kstat_t ret;
+
+    NULL_PARA_CHK(ring);
+    NULL_PARA_CHK(buf);
+
+    ret = lfring_init_chk(len, type, block_size);
+    if (ret != RHINO_SUCCESS) {
+        return ret;
+    }
+
+    if (type == RINGBUF_TYPE_FIX) {
+        if (((len % block_size) != 0u) || !LFRING_IS_POW2(len / block_size)) {
+            return RHINO_INV_PARAM;
+        }
+        ring->mask = (uint32_t)(len / block_size) - 1u;
+    } else {
+        ring->mask = (uint32_t)len - 1u;
+    }
+
+    ring->buf      = buf;
+    ring->type     = type;
+    ring->blk_size = block_size;
+    ring->reserve  = 0u;
+
+    rhino_atomic_idx_init(&ring->head, 0u);
+    rhino_atomic_idx_init(&ring->tail, 0u);
+
+    return RHINO_SUCCESS;
+}
+
+/* room for one record at producer index *t, *t is moved past it */
+static uint8_t *spsc_slot_get(k_spsc_ring_t *ring, uint32_t h, uint32_t *t,
+                              const uint8_t *c_len, size_t hdr, size_t len)
+{
+    uint8_t *p;
+    uint32_t span;
+
+    if (ring->type == RINGBUF_TYPE_FIX) {
+        if (*t - h > ring->mask) {
+            return NULL;
+        }
+
+        p   = &ring->buf[(*t & ring->mask) * ring->blk_size];
+        *t += 1u;
+
+        return p;
+    }
+
+    span = lfring_dyn_span(ring->mask, *t, hdr + len);
+    if (span > ring->mask + 1u - (*t - h)) {
+        return NULL;
+    }
+
+    p = &ring->buf[*t & ring->mask];
+    if (span != hdr + len) {
+        *p = LFRING_PAD;
+        p  = ring->buf;
+    }
+
+    *t += span;
+
+    p[0] = c_len[0];
+    lfring_dyn_fill(p, c_len, hdr, NULL, 0u);
+
+    return p + hdr;
+}
+
+kstat_t krhino_spsc_ring_push(k_spsc_ring_t *ring, const void *data, size_t len)
+{
+    uint8_t  c_len[RINGBUF_LEN_MAX_SIZE];
+    uint8_t *p;
+    size_t   hdr;
+    uint32_t h;
+    uint32_t t;
+
+    NULL_PARA_CHK(ring);
+    NULL_PARA_CHK(data);
+
+    hdr = 0u;
+    if (ring->type == RINGBUF_TYPE_FIX) {
+        if (len != ring->blk_size) {
+            return RHINO_INV_PARAM;
+        }
+    } else {
+        if (lfring_dyn_len_chk(ring->mask, len) != RHINO_SUCCESS) {
+            return RHINO_INV_PARAM;
+        }
+        hdr = ringbuf_headlen_compress(len, c_len);
+    }
+
+    t = rhino_atomic_load_relaxed(&ring->tail);
+    h = rhino_atomic_load_acquire(&ring->head);
+
+    p = spsc_slot_get(ring, h, &t, c_len, hdr, len);
+    if (p == NULL) {
+        return RHINO_RINGBUF_FULL;
+    }
+
+    memcpy(p, data, len);
+
+    rhino_atomic_store_release(&ring->tail, t);
+
+    return RHINO_SUCCESS;
+}
+
+/* oldest record at consumer index *h, *h is moved past it */
+static uint8_t *spsc_rec_get(k_spsc_ring_t *ring, uint32_t *h, uint32_t t, size_t *len)
+{
+    uint8_t *p;
+
+    if (*h == t) {
+        return NULL;
+    }
+
+    if (ring->type == RINGBUF_TYPE_FIX) {
+        p    = &ring->buf[(*h & ring->mask) * ring->blk_size];
+        *len = ring->blk_size;
+        *h  += 1u;
+
+        return p;
+    }
+
+    return lfring_dyn_get(ring->buf, ring->mask, *h, len, h);
+}
+
+kstat_t krhino_spsc_ring_pop(k_spsc_ring_t *ring, void *data, size_t *len)
+{
+    uint8_t *p;
+    size_t   n;
+    uint32_t h;
+    uint32_t t;
+
+    NULL_PARA_CHK(ring);
+    NULL_PARA_CHK(data);
+
+    if ((ring->type == RINGBUF_TYPE_DYN) && (len == NULL)) {
+        return RHINO_INV_PARAM;
+    }
+
+    h = rhino_atomic_load_relaxed(&ring->head);
+    t = rhino_atomic_load_acquire(&ring->tail);
+
+    p = spsc_rec_get(ring, &h, t, &n);
+    if (p == NULL) {
+        return RHINO_RINGBUF_EMPTY;
+    }
+
+    memcpy(data, p, n);
+    if (len != NULL) {
+        *len = n;
+    }
+
+    rhino_atomic_store_release(&ring->head, h);
+
+    return RHINO_SUCCESS;
+}
+
+size_t krhino_spsc_ring_push_batch(k_spsc_ring_t *ring, const void *data,
+                                   const size_t *len, size_t num)
+{
+    uint8_t        c_len[RINGBUF_LEN_MAX_SIZE];
+    const uint8_t *src;
+    uint8_t       *p;
+    size_t         hdr;
+    size_t         n;
+    size_t         i;
+    uint32_t       h;
+    uint32_t       t;
+
+    if ((ring == NULL) || (data == NULL)) {
+        return 0u;
+    }
+
+    if ((ring->type == RINGBUF_TYPE_DYN) && (len == NULL)) {
+        return 0u;
+    }
+
+    src = data;
+    hdr = 0u;
+    t   = rhino_atomic_load_relaxed(&ring->tail);
+    h   = rhino_atomic_load_acquire(&ring->head);
+
+    for (i = 0u; i < num; i++) {
+        if (ring->type == RINGBUF_TYPE_FIX) {
+            n = ring->blk_size;
+        } else {
+            n = len[i];
+            if (lfring_dyn_len_chk(ring->mask, n) != RHINO_SUCCESS) {
+                break;
+            }
+            hdr = ringbuf_headlen_compress(n, c_len);
+        }
+
+        p = spsc_slot_get(ring, h, &t, c_len, hdr, n);
+        if (p == NULL) {
+            break;
+        }
+
+        memcpy(p, src, n);
+        src += n;
+    }
+
+    if (i > 0u) {
+        rhino_atomic_store_release(&ring->tail, t);
+    }
+
+    return i;
+}
+
+size_t krhino_spsc_ring_pop_batch(k_spsc_ring_t *ring, void *data, size_t size,
+                                  size_t *len, size_t num)
+{
+    uint8_t *dst;
+    uint8_t *p;
+    size_t   n;
+    size_t   i;
+    uint32_t h;
+    uint32_t next;
+    uint32_t t;
+
+    if ((ring == NULL) || (data == NULL)) {
+        return 0u;
+    }
+
+    dst = data;
+    h   = rhino_atomic_load_relaxed(&ring->head);
+    t   = rhino_atomic_load_acquire(&ring->tail);
+
+    for (i = 0u; i < num; i++) {
+        next = h;
+        p    = spsc_rec_get(ring, &next, t, &n);
+        if ((p == NULL) || (n > size)) {
+            break;
+        }
+
+        memcpy(dst, p, n);
+        if (len != NULL) {
+            len[i] = n;
+        }
+
+        dst  += n;
+        size -= n;
+        h     = next;
+    }
+
+    if (i > 0u) {
+        rhino_atomic_store_release(&ring->head, h);
+    }
+
+    return i;
+}
+
+void *krhino_spsc_ring_reserve(k_spsc_ring_t *ring, size_t len)
+{
+    uint8_t  c_len[RINGBUF_LEN_MAX_SIZE];
+    uint8_t *p;
+    size_t   hdr;
+    uint32_t h;
+    uint32_t t;
+
+    if (ring == NULL) {
+        return NULL;
+    }
+
+    hdr = 0u;
+    if (ring->type == RINGBUF_TYPE_FIX) {
+        if (len != ring->blk_size) {
+            return NULL;
+        }
+    } else {
+        if (lfring_dyn_len_chk(ring->mask, len) != RHINO_SUCCESS) {
+            return NULL;
+        }
+        hdr = ringbuf_headlen_compress(len, c_len);
+    }
+
+    t = rhino_atomic_load_relaxed(&ring->tail);
+    h = rhino_atomic_load_acquire(&ring->head);
+
+    p = spsc_slot_get(ring, h, &t, c_len, hdr, len);
+    if (p != NULL) {
+        ring->reserve = t;
+    }
+
+    return p;
+}
+
+kstat_t krhino_spsc_ring_commit(k_spsc_ring_t *ring, void *data, size_t len)
+{
+    (void)len;
+
+    NULL_PARA_CHK(ring);
+    NULL_PARA_CHK(data);
+
+    if (ring->reserve == rhino_atomic_load_relaxed(&ring->tail)) {
+        return RHINO_INV_PARAM;
+    }
+
+    rhino_atomic_store_release(&ring->tail, ring->reserve);
+
+    return RHINO_SUCCESS;
+}
+
+void *krhino_spsc_ring_peek(k_spsc_ring_t *ring, size_t *len)
+{
+    uint8_t *p;
+    size_t   n;
+    uint32_t h;
+    uint32_t t;
+
+    if (ring == NULL) {
+        return NULL;
+    }
+
+    h = rhino_atomic_load_relaxed(&ring->head);
+    t = rhino_atomic_load_acquire(&ring->tail);
+
+    p = spsc_rec_get(ring, &h, t, &n);
+    if ((p != NULL) && (len != NULL)) {
+        *len = n;
+    }
+
+    return p;
+}
+
+kstat_t krhino_spsc_ring_consume(k_spsc_ring_t *ring)
+{
+    size_t   n;
+    uint32_t h;
+    uint32_t t;
+
+    NULL_PARA_CHK(ring);
+
+    h = rhino_atomic_load_relaxed(&ring->head);
+    t = rhino_atomic_load_acquire(&ring->tail);
+
+    if (spsc_rec_get(ring, &h, t, &n) == NULL) {
+        return RHINO_RINGBUF_EMPTY;
+    }
+
+    rhino_atomic_store_release(&ring->head, h);
+
+    return RHINO_SUCCESS;
+}
+
+uint8_t krhino_spsc_ring_is_empty(k_spsc_ring_t *ring)
+{
+    if (rhino_atomic_load_relaxed(&ring->head) == rhino_atomic_load_acquire(&ring->tail)) {
+        return true;
+    }
+
+    return false;
+}
+
+/*
+ * multi producer single consumer
+ *
+ * fix rings: a sequence word per block, seq == pos while the block is free
+ * for producer index pos, pos + 1 once published, pos + blocks once consumed.
+ *
+ * dyn rings: producers claim bytes with a cas on tail and publish a record
+ * by storing its first header byte last. Free bytes are kept 0, so the
+ * consumer stops at a record whose first byte is still 0.
+ */
+kstat_t krhino_mpsc_ring_init(k_mpsc_ring_t *ring, void *buf, size_t len,
+                              size_t type, size_t block_size)
+{
+    kstat_t  ret;
+    uint32_t num;
+    uint32_t i;
+
+    NULL_PARA_CHK(ring);
+    NULL_PARA_CHK(buf);
+
+    ret = lfring_init_chk(len, type, block_size);
+    if (ret != RHINO_SUCCESS) {
+        return ret;
+    }
+
+    ring->type     = type;
+    ring->blk_size = block_size;
+
+    rhino_atomic_idx_init(&ring->head, 0u);
+    rhino_atomic_idx_init(&ring->tail, 0u);
+
+    if (type == RINGBUF_TYPE_DYN) {
+        memset(buf, 0, len);
+        ring->buf  = buf;
+        ring->seq  = NULL;
+        ring->mask = (uint32_t)len - 1u;
+
+        return RHINO_SUCCESS;
+    }
+
+    if (((size_t)buf & (sizeof(rhino_atomic_idx_t) - 1u)) != 0u) {
+        return RHINO_INV_PARAM;
+    }
+
+    num = (uint32_t)(len / (block_size + sizeof(rhino_atomic_idx_t)));
+    if (num == 0u) {
+        return RHINO_INV_PARAM;
+    }
+
+    while (!LFRING_IS_POW2(num)) {
+        num &= num - 1u;
+    }
+
+    ring->seq  = buf;
+    ring->buf  = (uint8_t *)&ring->seq[num];
+    ring->mask = num - 1u;
+
+    for (i = 0u; i < num; i++) {
+        rhino_atomic_idx_init(&ring->seq[i], i);
+    }
+
+    return RHINO_SUCCESS;
+}
+
+/* claim num consecutive blocks, returns the first producer index */
+static kstat_t mpsc_fix_claim(k_mpsc_ring_t *ring, uint32_t num, uint32_t *pos)
+{
+    uint32_t t;
+    uint32_t seq;
+    int32_t  diff;
+
+    t = rhino_atomic_load_relaxed(&ring->tail);
+
+    for (;;) {
+        /* blocks are freed in order, the last one being free frees them all */
+        seq  = rhino_atomic_load_acquire(&ring->seq[(t + num - 1u) & ring->mask]);
+        diff = (int32_t)(seq - (t + num - 1u));
+
+        if (diff == 0) {
+            if (rhino_atomic_cas_weak(&ring->tail, &t, t + num)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return RHINO_RINGBUF_FULL;
+        } else {
+            t = rhino_atomic_load_relaxed(&ring->tail);
+        }
+    }
+
+    *pos = t;
+
+    return RHINO_SUCCESS;
+}
+
+/* claim the bytes of num records laid out from the tail, pads included */
+static kstat_t mpsc_dyn_claim(k_mpsc_ring_t *ring, const size_t *len, size_t num,
+                              uint32_t *pos, uint32_t *end)
+{
+    uint32_t h;
+    uint32_t t;
+    uint32_t n;
+    size_t   i;
+
+    t = rhino_atomic_load_relaxed(&ring->tail);
+
+    for (;;) {
+        h = rhino_atomic_load_acquire(&ring->head);
+
+        /* tail was read before head, it may be stale */
+        if ((int32_t)(t - h) < 0) {
+            t = rhino_atomic_load_relaxed(&ring->tail);
+            continue;
+        }
+
+        n = t;
+        for (i = 0u; i < num; i++) {
+            n += lfring_dyn_span(ring->mask, n, COMPRESS_LEN(len[i]) + len[i]);
+        }
+
+        if (n - h > ring->mask + 1u) {
+            if (t == rhino_atomic_load_relaxed(&ring->tail)) {
+                return RHINO_RINGBUF_FULL;
+            }
+            t = rhino_atomic_load_relaxed(&ring->tail);
+            continue;
+        }
+
+        if (rhino_atomic_cas_weak(&ring->tail, &t, n)) {
+            break;
+        }
+    }
+
+    *pos = t;
+    *end = n;
+
+    return RHINO_SUCCESS;
+}
+
+/* start of the record claimed at *t, writes the pad and moves *t past the record */
+static uint8_t *mpsc_dyn_place(k_mpsc_ring_t *ring, uint32_t *t, size_t rec)
+{
+    uint8_t *p;
+    uint32_t span;
+
+    span = lfring_dyn_span(ring->mask, *t, rec);
+    p    = &ring->buf[*t & ring->mask];
+
+    if (span != rec) {
+        rhino_atomic_store_release_u8(p, LFRING_PAD);
+        p = ring->buf;
+    }
+
+    *t += span;
+
+    return p;
+}
+
+kstat_t krhino_mpsc_ring_push(k_mpsc_ring_t *ring, const void *data, size_t len)
+{
+    uint8_t  c_len[RINGBUF_LEN_MAX_SIZE];
+    uint8_t *p;
+    size_t   hdr;
+    size_t   rec;
+    uint32_t pos;
+    uint32_t end;
+    kstat_t  ret;
+
+    NULL_PARA_CHK(ring);
+    NULL_PARA_CHK(data);
+
+    if (ring->type == RINGBUF_TYPE_FIX) {
+        if (len != ring->blk_size) {
+            return RHINO_INV_PARAM;
+        }
+
+        ret = mpsc_fix_claim(ring, 1u, &pos);
+        if (ret != RHINO_SUCCESS) {
+            return ret;
+        }
+
+        memcpy(&ring->buf[(pos & ring->mask) * ring->blk_size], data, ring->blk_size);
+        rhino_atomic_store_release(&ring->seq[pos & ring->mask], pos + 1u);
+
+        return RHINO_SUCCESS;
+    }
+
+    if (lfring_dyn_len_chk(ring->mask, len) != RHINO_SUCCESS) {
+        return RHINO_INV_PARAM;
+    }
+
+    hdr = ringbuf_headlen_compress(len, c_len);
+    rec = hdr + len;
+
+    ret = mpsc_dyn_claim(ring, &len, 1u, &pos, &end);
+    if (ret != RHINO_SUCCESS) {
+        return ret;
+    }
+
+    p = mpsc_dyn_place(ring, &pos, rec);
+    lfring_dyn_fill(p, c_len, hdr, data, len);
+    rhino_atomic_store_release_u8(p, c_len[0]);
+
+    return RHINO_SUCCESS;
+}
+
+/* zero the consumed bytes [from, to) and hand them back to the producers */
+static void mpsc_dyn_release(k_mpsc_ring_t *ring, uint32_t from, uint32_t to)
+{
+    uint32_t off;
+    uint32_t n;
+
+    n   = to - from;
+    off = from & ring->mask;
+
+    if (off + n > ring->mask + 1u) {
+        memset(&ring->buf[off], 0, ring->mask + 1u - off);
+        memset(ring->buf, 0, off + n - (ring->mask + 1u));
+    } else {
+        memset(&ring->buf[off], 0, n);
+    }
+
+    rhino_atomic_store_release(&ring->head, to);
+}
+
+/* oldest published record at consumer index h, *next is the index past it */
+static uint8_t *mpsc_rec_get(k_mpsc_ring_t *ring, uint32_t h, size_t *len, uint32_t *next)
+{
+    uint32_t seq;
+
+    if (ring->type == RINGBUF_TYPE_DYN) {
+        return lfring_dyn_get(ring->buf, ring->mask, h, len, next);
+    }
+
+    seq = rhino_atomic_load_acquire(&ring->seq[h & ring->mask]);
+    if (seq != h + 1u) {
+        return NULL;
+    }
+
+    *len  = ring->blk_size;
+    *next = h + 1u;
+
+    return &ring->buf[(h & ring->mask) * ring->blk_size];
+}
+
+/* fix blocks are handed back one by one, dyn bytes in a single release */
+RHINO_INLINE void mpsc_fix_release(k_mpsc_ring_t *ring, uint32_t h)
+{
+    rhino_atomic_store_release(&ring->seq[h & ring->mask], h + ring->mask + 1u);
+}
+
+kstat_t krhino_mpsc_ring_pop(k_mpsc_ring_t *ring, void *data, size_t *len)
+{
+    uint8_t *p;
+    size_t   n;
+    uint32_t h;
+    uint32_t next;
+
+    NULL_PARA_CHK(ring);
+    NULL_PARA_CHK(data);
+
+    if ((ring->type == RINGBUF_TYPE_DYN) && (len == NULL)) {
+        return RHINO_INV_PARAM;
+    }
+
+    h = rhino_atomic_load_relaxed(&ring->head);
+
+    p = mpsc_rec_get(ring, h, &n, &next);
+    if (p == NULL) {
+        return RHINO_RINGBUF_EMPTY;
+    }
+
+    memcpy(data, p, n);
+    if (len != NULL) {
+        *len = n;
+    }
+
+    if (ring->type == RINGBUF_TYPE_FIX) {
+        mpsc_fix_release(ring, h);
+        rhino_atomic_store_release(&ring->head, next);
+    } else {
+        mpsc_dyn_release(ring, h, next);
+    }
+
+    return RHINO_SUCCESS;
+}
+
+size_t krhino_mpsc_ring_push_batch(k_mpsc_ring_t *ring, const void *data,
+                                   const size_t *len, size_t num)
+{
+    uint8_t        c_len[RINGBUF_LEN_MAX_SIZE];
+    const uint8_t *src;
+    uint8_t       *p;
+    size_t         hdr;
+    size_t         i;
+    uint32_t       pos;
+    uint32_t       end;
+
+    if ((ring == NULL) || (data == NULL) || (num == 0u)) {
+        return 0u;
+    }
+
+    src = data;
+
+    if (ring->type == RINGBUF_TYPE_FIX) {
+        if ((num > ring->mask + 1u) || (mpsc_fix_claim(ring, (uint32_t)num, &pos) != RHINO_SUCCESS)) {
+            return 0u;
+        }
+
+        for (i = 0u; i < num; i++, pos++) {
+            memcpy(&ring->buf[(pos & ring->mask) * ring->blk_size], src, ring->blk_size);
+            rhino_atomic_store_release(&ring->seq[pos & ring->mask], pos + 1u);
+            src += ring->blk_size;
+        }
+
+        return num;
+    }
+
+    if (len == NULL) {
+        return 0u;
+    }
+
+    for (i = 0u; i < num; i++) {
+        if (lfring_dyn_len_chk(ring->mask, len[i]) != RHINO_SUCCESS) {
+            return 0u;
+        }
+    }
+
+    if (mpsc_dyn_claim(ring, len, num, &pos, &end) != RHINO_SUCCESS) {
+        return 0u;
+    }
+
+    for (i = 0u; i < num; i++) {
+        hdr = ringbuf_headlen_compress(len[i], c_len);
+        p   = mpsc_dyn_place(ring, &pos, hdr + len[i]);
+
+        lfring_dyn_fill(p, c_len, hdr, src, len[i]);
+        rhino_atomic_store_release_u8(p, c_len[0]);
+
+        src += len[i];
+    }
+
+    return num;
+}
+
+size_t krhino_mpsc_ring_pop_batch(k_mpsc_ring_t *ring, void *data, size_t size,
+                                  size_t *len, size_t num)
+{
+    uint8_t *dst;
+    uint8_t *p;
+    size_t   n;
+    size_t   i;
+    uint32_t start;
+    uint32_t h;
+    uint32_t next;
+
+    if ((ring == NULL) || (data == NULL)) {
+        return 0u;
+    }
+
+    dst   = data;
+    start = rhino_atomic_load_relaxed(&ring->head);
+    h     = start;
+
+    for (i = 0u; i < num; i++) {
+        p = mpsc_rec_get(ring, h, &n, &next);
+        if ((p == NULL) || (n > size)) {
+            break;
+        }
+
+        memcpy(dst, p, n);
+        if (len != NULL) {
+            len[i] = n;
+        }
+
+        if (ring->type == RINGBUF_TYPE_FIX) {
+            mpsc_fix_release(ring, h);
+        }
+
+        dst  += n;
+        size -= n;
+        h     = next;
+    }
+
+    if (i > 0u) {
+        if (ring->type == RINGBUF_TYPE_FIX) {
+            rhino_atomic_store_release(&ring->head, h);
+        } else {
+            mpsc_dyn_release(ring, start, h);
+        }
+    }
+
+    return i;
+}
+
+void *krhino_mpsc_ring_reserve(k_mpsc_ring_t *ring, size_t len)
+{
+    uint8_t  c_len[RINGBUF_LEN_MAX_SIZE];
+    uint8_t *p;
+    size_t   hdr;
+    size_t   rec;
+    uint32_t pos;
+    uint32_t end;
+
+    if (ring == NULL) {
+        return NULL;
+    }
+
+    if (ring->type == RINGBUF_TYPE_FIX) {
+        if ((len != ring->blk_size) || (mpsc_fix_claim(ring, 1u, &pos) != RHINO_SUCCESS)) {
+            return NULL;
+        }
+
+        return &ring->buf[(pos & ring->mask) * ring->blk_size];
+    }
+
+    if (lfring_dyn_len_chk(ring->mask, len) != RHINO_SUCCESS) {
+        return NULL;
+    }
+
+    hdr = ringbuf_headlen_compress(len, c_len);
+    rec = hdr + len;
+
+    if (mpsc_dyn_claim(ring, &len, 1u, &pos, &end) != RHINO_SUCCESS) {
+        return NULL;
+    }
+
+    p = mpsc_dyn_place(ring, &pos, rec);
+    lfring_dyn_fill(p, c_len, hdr, NULL, 0u);
+
+    return p + hdr;
+}
+
+kstat_t krhino_mpsc_ring_commit(k_mpsc_ring_t *ring, void *data, size_t len)
+{
+    uint8_t  c_len[RINGBUF_LEN_MAX_SIZE];
+    size_t   hdr;
+    uint32_t idx;
+
+    NULL_PARA_CHK(ring);
+    NULL_PARA_CHK(data);
+
+    if (ring->type == RINGBUF_TYPE_FIX) {
+        idx = (uint32_t)(((uint8_t *)data - ring->buf) / ring->blk_size);
+        if (idx > ring->mask) {
+            return RHINO_INV_PARAM;
+        }
+
+        /* seq still holds the producer index the block was claimed for */
+        rhino_atomic_store_release(&ring->seq[idx],
+                                   rhino_atomic_load_relaxed(&ring->seq[idx]) + 1u);
+
+        return RHINO_SUCCESS;
+    }
+
+    if (lfring_dyn_len_chk(ring->mask, len) != RHINO_SUCCESS) {
+        return RHINO_INV_PARAM;
+    }
+
+    hdr = ringbuf_headlen_compress(len, c_len);
+    rhino_atomic_store_release_u8((uint8_t *)data - hdr, c_len[0]);
+
+    return RHINO_SUCCESS;
+}
+
+void *krhino_mpsc_ring_peek(k_mpsc_ring_t *ring, size_t *len)
+{
+    uint8_t *p;
+    size_t   n;
+    uint32_t next;
+
+    if (ring == NULL) {
+        return NULL;
+    }
+
+    p = mpsc_rec_get(ring, rhino_atomic_load_relaxed(&ring->head), &n, &next);
+    if ((p != NULL) && (len != NULL)) {
+        *len = n;
+    }
+
+    return p;
+}
+
+kstat_t krhino_mpsc_ring_consume(k_mpsc_ring_t *ring)
+{
+    size_t   n;
+    uint32_t h;
+    uint32_t next;
+
+    NULL_PARA_CHK(ring);
+
+    h = rhino_atomic_load_relaxed(&ring->head);
+
+    if (mpsc_rec_get(ring, h, &n, &next) == NULL) {
+        return RHINO_RINGBUF_EMPTY;
+    }
+
+    if (ring->type == RINGBUF_TYPE_FIX) {
+        mpsc_fix_release(ring, h);
+        rhino_atomic_store_release(&ring->head, next);
+    } else {
+        mpsc_dyn_release(ring, h, next);
+    }
+
+    return RHINO_SUCCESS;
+}
+
+uint8_t krhino_mpsc_ring_is_empty(k_mpsc_ring_t *ring)
+{
+    if (krhino_mpsc_ring_peek(ring, NULL) == NULL) {
+        return true;
+    }
+
+    return false;
+}
+
+#endif /* RHINO_CONFIG_RINGBUF_LOCKFREE */
+
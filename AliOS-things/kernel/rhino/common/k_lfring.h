@@ -0,0 +1,247 @@
+/*
+ * Copyright (C) 2015-2017 Alibaba Group Holding Limited
+ */
+
+#ifndef K_LFRING_H
+#define K_LFRING_H
+
+#include "k_atomic.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Lock-free rings for irq to task paths, no critical section is taken.
+ *
+ * Record formats follow k_ringbuf: RINGBUF_TYPE_FIX rings carry blocks of
+ * blk_size bytes, RINGBUF_TYPE_DYN rings carry records prefixed by the 1-3
+ * byte compressed length header. Unlike k_ringbuf a dyn record is never
+ * split at the buffer end, the producer pads to the end instead, so every
+ * record can be reserved and read in place.
+ *
+ * The dyn ring size and the fix ring block count must be powers of 2.
+ * k_spsc_ring_t is wait-free for one producer and one consumer,
+ * k_mpsc_ring_t is lock-free for any number of producers, including
+ * interrupts, and one consumer.
+ */
+
+/* first byte of a pad to the buffer end, never the first byte of a header */
+#define LFRING_PAD                 0xff
+/* longest dyn record, keeps the first header byte below LFRING_PAD */
+#define LFRING_DYN_LEN_MAXVALUE    0x3effff
+
+typedef struct {
+    uint8_t           *buf;
+    uint32_t           mask;     /* bytes - 1 for dyn, blocks - 1 for fix */
+    size_t             type;
+    size_t             blk_size;
+    rhino_atomic_idx_t head;     /* consumer index, free running */
+    rhino_atomic_idx_t tail;     /* producer index, free running */
+    uint32_t           reserve;  /* producer index after the reserved record */
+} k_spsc_ring_t;
+
+typedef struct {
+    uint8_t            *buf;
+    rhino_atomic_idx_t *seq;     /* per block publish sequence, fix rings only */
+    uint32_t            mask;
+    size_t              type;
+    size_t              blk_size;
+    rhino_atomic_idx_t  head;
+    rhino_atomic_idx_t  tail;    /* next index to be reserved by any producer */
+} k_mpsc_ring_t;
+
+/**
+ * This function will init a single producer single consumer ring.
+ * @param[in]  ring        pointer to the ring
+ * @param[in]  buf         pointer to the memory buffer
+ * @param[in]  len         length of the buffer, power of 2 for dyn rings
+ * @param[in]  type        RINGBUF_TYPE_FIX or RINGBUF_TYPE_DYN
+ * @param[in]  block_size  block size of fix rings, len / block_size must be a power of 2
+ * @return  the operation status, RHINO_SUCCESS is OK, others is error
+ */
+kstat_t krhino_spsc_ring_init(k_spsc_ring_t *ring, void *buf, size_t len,
+                              size_t type, size_t block_size);
+
+/**
+ * This function will push one record, producer side.
+ * @param[in]  ring  pointer to the ring
+ * @param[in]  data  pointer to the record
+ * @param[in]  len   length of the record, blk_size for fix rings
+ * @return  the operation status, RHINO_SUCCESS is OK, RHINO_RINGBUF_FULL if no room
+ */
+kstat_t krhino_spsc_ring_push(k_spsc_ring_t *ring, const void *data, size_t len);
+
+/**
+ * This function will pop one record, consumer side.
+ * @param[in]   ring  pointer to the ring
+ * @param[out]  data  buffer large enough for the record
+ * @param[out]  len   length of the record, may be NULL for fix rings
+ * @return  the operation status, RHINO_SUCCESS is OK, RHINO_RINGBUF_EMPTY if none
+ */
+kstat_t krhino_spsc_ring_pop(k_spsc_ring_t *ring, void *data, size_t *len);
+
+/**
+ * This function will push records stored back to back and publish them at once.
+ * @param[in]  ring  pointer to the ring
+ * @param[in]  data  pointer to the records
+ * @param[in]  len   length of each record, may be NULL for fix rings
+ * @param[in]  num   number of records
+ * @return  the number of records pushed
+ */
+size_t krhino_spsc_ring_push_batch(k_spsc_ring_t *ring, const void *data,
+                                   const size_t *len, size_t num);
+
+/**
+ * This function will pop records back to back into data and release them at once.
+ * @param[in]   ring  pointer to the ring
+ * @param[out]  data  pointer to the output buffer
+ * @param[in]   size  size of the output buffer
+ * @param[out]  len   length of each record, may be NULL for fix rings
+ * @param[in]   num   max number of records
+ * @return  the number of records popped
+ */
+size_t krhino_spsc_ring_pop_batch(k_spsc_ring_t *ring, void *data, size_t size,
+                                  size_t *len, size_t num);
+
+/**
+ * This function will reserve room for one record to be filled in place.
+ * @param[in]  ring  pointer to the ring
+ * @param[in]  len   length of the record, blk_size for fix rings
+ * @return  where to write the record, NULL if no room
+ */
+void *krhino_spsc_ring_reserve(k_spsc_ring_t *ring, size_t len);
+
+/**
+ * This function will publish the record returned by the last reserve.
+ * @param[in]  ring  pointer to the ring
+ * @param[in]  data  the pointer returned by krhino_spsc_ring_reserve()
+ * @param[in]  len   the length passed to krhino_spsc_ring_reserve()
+ * @return  the operation status, RHINO_SUCCESS is OK, others is error
+ */
+kstat_t krhino_spsc_ring_commit(k_spsc_ring_t *ring, void *data, size_t len);
+
+/**
+ * This function will return the oldest record in place without removing it.
+ * @param[in]   ring  pointer to the ring
+ * @param[out]  len   length of the record, may be NULL for fix rings
+ * @return  the record, NULL if the ring is empty
+ */
+void *krhino_spsc_ring_peek(k_spsc_ring_t *ring, size_t *len);
+
+/**
+ * This function will drop the record returned by the last peek.
+ * @param[in]  ring  pointer to the ring
+ * @return  the operation status, RHINO_SUCCESS is OK, RHINO_RINGBUF_EMPTY if none
+ */
+kstat_t krhino_spsc_ring_consume(k_spsc_ring_t *ring);
+
+/**
+ * This function will check if the ring is empty.
+ * @param[in]  ring  pointer to the ring
+ * @return  1 if empty, 0 if not
+ */
+uint8_t krhino_spsc_ring_is_empty(k_spsc_ring_t *ring);
+
+/**
+ * This function will init a multi producer single consumer ring.
+ * Fix rings keep one sequence word per block at the start of buf, so
+ * the block count is the largest power of 2 that fits both.
+ * @param[in]  ring        pointer to the ring
+ * @param[in]  buf         pointer to the memory buffer, word aligned
+ * @param[in]  len         length of the buffer, power of 2 for dyn rings
+ * @param[in]  type        RINGBUF_TYPE_FIX or RINGBUF_TYPE_DYN
+ * @param[in]  block_size  block size of fix rings
+ * @return  the operation status, RHINO_SUCCESS is OK, others is error
+ */
+kstat_t krhino_mpsc_ring_init(k_mpsc_ring_t *ring, void *buf, size_t len,
+                              size_t type, size_t block_size);
+
+/**
+ * This function will push one record, any producer context.
+ * @param[in]  ring  pointer to the ring
+ * @param[in]  data  pointer to the record
+ * @param[in]  len   length of the record, blk_size for fix rings
+ * @return  the operation status, RHINO_SUCCESS is OK, RHINO_RINGBUF_FULL if no room
+ */
+kstat_t krhino_mpsc_ring_push(k_mpsc_ring_t *ring, const void *data, size_t len);
+
+/**
+ * This function will pop one record, consumer side. A record still being
+ * written by a producer ends the ring for now, RHINO_RINGBUF_EMPTY is returned.
+ * @param[in]   ring  pointer to the ring
+ * @param[out]  data  buffer large enough for the record
+ * @param[out]  len   length of the record, may be NULL for fix rings
+ * @return  the operation status, RHINO_SUCCESS is OK, RHINO_RINGBUF_EMPTY if none
+ */
+kstat_t krhino_mpsc_ring_pop(k_mpsc_ring_t *ring, void *data, size_t *len);
+
+/**
+ * This function will push records stored back to back with a single reservation.
+ * @param[in]  ring  pointer to the ring
+ * @param[in]  data  pointer to the records
+ * @param[in]  len   length of each record, may be NULL for fix rings
+ * @param[in]  num   number of records
+ * @return  the number of records pushed, all or nothing
+ */
+size_t krhino_mpsc_ring_push_batch(k_mpsc_ring_t *ring, const void *data,
+                                   const size_t *len, size_t num);
+
+/**
+ * This function will pop records back to back into data.
+ * @param[in]   ring  pointer to the ring
+ * @param[out]  data  pointer to the output buffer
+ * @param[in]   size  size of the output buffer
+ * @param[out]  len   length of each record, may be NULL for fix rings
+ * @param[in]   num   max number of records
+ * @return  the number of records popped
+ */
+size_t krhino_mpsc_ring_pop_batch(k_mpsc_ring_t *ring, void *data, size_t size,
+                                  size_t *len, size_t num);
+
+/**
+ * This function will reserve room for one record to be filled in place,
+ * other producers may reserve and commit behind it meanwhile.
+ * @param[in]  ring  pointer to the ring
+ * @param[in]  len   length of the record, blk_size for fix rings
+ * @return  where to write the record, NULL if no room
+ */
+void *krhino_mpsc_ring_reserve(k_mpsc_ring_t *ring, size_t len);
+
+/**
+ * This function will publish a reserved record.
+ * @param[in]  ring  pointer to the ring
+ * @param[in]  data  the pointer returned by krhino_mpsc_ring_reserve()
+ * @param[in]  len   the length passed to krhino_mpsc_ring_reserve()
+ * @return  the operation status, RHINO_SUCCESS is OK, others is error
+ */
+kstat_t krhino_mpsc_ring_commit(k_mpsc_ring_t *ring, void *data, size_t len);
+
+/**
+ * This function will return the oldest published record in place.
+ * @param[in]   ring  pointer to the ring
+ * @param[out]  len   length of the record, may be NULL for fix rings
+ * @return  the record, NULL if none is published
+ */
+void *krhino_mpsc_ring_peek(k_mpsc_ring_t *ring, size_t *len);
+
+/**
+ * This function will drop the record returned by the last peek.
+ * @param[in]  ring  pointer to the ring
+ * @return  the operation status, RHINO_SUCCESS is OK, RHINO_RINGBUF_EMPTY if none
+ */
+kstat_t krhino_mpsc_ring_consume(k_mpsc_ring_t *ring);
+
+/**
+ * This function will check if the ring holds no published record.
+ * @param[in]  ring  pointer to the ring
+ * @return  1 if empty, 0 if not
+ */
+uint8_t krhino_mpsc_ring_is_empty(k_mpsc_ring_t *ring);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* K_LFRING_H */
+
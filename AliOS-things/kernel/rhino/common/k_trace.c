@@ -2,26 +2,49 @@
  * Copyright (C) 2015-2017 Alibaba Group Holding Limited
  */
 
-#include <assert.h>
 #include <k_api.h>
-#include "k_fifo.h"
+#include "k_atomic.h"
 
 #if (RHINO_CONFIG_TRACE > 0)
 
-#define TRACE_BUFFER_SIZE 1024
-#define ROUND_POINT(sz) (((sz) + (4 - 1)) & ~(4 - 1))
+#define TRACE_RING_MASK     (RHINO_CONFIG_TRACE_RING_SIZE - 1u)
 
-#define TRACE_PACKET_LENGTH 120
-#define MAX_MODULE_NAME 40
-#define TRACE_TYPE  0XFFFFFF00
-#define TRACE_EVENT 0X000000FF
+/* a SYNC record and the event are published at once, the drain keeps off those two slots */
+#define TRACE_RING_SAFE     (RHINO_CONFIG_TRACE_RING_SIZE - 2u)
 
-static uint32_t buffer[TRACE_BUFFER_SIZE];
+#define TRACE_SYNC_INTERVAL (RHINO_CONFIG_TRACE_RING_SIZE / 4u)
 
-static uint32_t event_mask;
-static void *hit_task;
-static uint8_t init;
-struct k_fifo trace_fifo;
+/* longest name recorded, the NAME offset is 8 bits */
+#define TRACE_NAME_MAX      64u
+
+/* records handed to the sink at once */
+#define TRACE_DRAIN_BATCH   16u
+
+#define TRACE_OBJ(p)        ((uintptr_t)(p))
+
+typedef struct {
+    k_trace_rec_t      rec[RHINO_CONFIG_TRACE_RING_SIZE];
+    rhino_atomic_idx_t widx;      /* next record, written by the producer only */
+    rhino_atomic_idx_t ridx;      /* next record, written by the drain only */
+    rhino_atomic_idx_t drop;      /* records refused in TRACE_MODE_STOP */
+    hr_timer_t         last;      /* HR count of the previous record */
+    uint32_t           sync_left; /* records until the next SYNC */
+    uint32_t           drop_seen; /* drain side copy of drop */
+    uint32_t           lost;      /* records overwritten before the drain got them */
+} k_trace_ring_t;
+
+static k_trace_ring_t g_trace_ring[RHINO_CONFIG_CPU_NUM];
+
+static uint32_t      event_mask;
+static void         *hit_task;
+static uint8_t       init;
+static uint8_t       trace_mode;
+static uint8_t       drain_cpu;
+static trace_sink_t  trace_sink;
+
+static ktask_t       trace_task;
+static cpu_stack_t   trace_task_stack[RHINO_CONFIG_TRACE_TASK_STACK];
+static uint8_t       trace_task_started;
 
 int32_t set_filter_task(const char *task_name)
 {
@@ -52,1489 +75,561 @@ void trace_deinit(void)
     init = 0;
 }
 
-/* task trace function */
-void _trace_init(void)
+void trace_mode_set(uint8_t mode)
 {
-    uint32_t buf[10];
-
-    fifo_init(&trace_fifo, buffer, TRACE_BUFFER_SIZE * 4);
-
-    buf[0] = 0x101;
-    buf[1] = 0x0;
-    buf[2] = 0x0;
-    buf[3] = HR_COUNT_GET();
-    *((char *)buf + 16) = '\n';
+    trace_mode = mode;
+}
 
-    fifo_in(&trace_fifo, buf, 17);
-    init = 1;
+void trace_sink_set(trace_sink_t sink)
+{
+    trace_sink = sink;
 }
 
-void trace_filter_and_write(ktask_t *task, const void *buf, uint32_t len)
+static uint8_t trace_filter(ktask_t *task, uint32_t event)
 {
-    if (hit_task != NULL && hit_task != task) {
-        return;
+    /* meta records describe the stream itself */
+    if ((event & TRACE_TYPE) == 0u) {
+        return 0;
     }
 
-    uint32_t event = *(uint32_t *)buf;
+    if (hit_task != NULL && hit_task != task) {
+        return 1;
+    }
 
     /*when event_mask represents an event, filter exact event*/
     if ((event_mask & TRACE_EVENT) != 0 && event_mask != event) {
-        return;
+        return 1;
     }
 
     /*when event_mask represents an event type, filter match type*/
     if (((event_mask & TRACE_TYPE) != 0) && (event_mask & TRACE_TYPE) != (event & TRACE_TYPE)) {
-        return;
+        return 1;
     }
 
-    *((hr_timer_t *)((char *)buf + len)) = HR_COUNT_GET();
-    *((char *)buf + len + sizeof(hr_timer_t)) = '\n';
-    len = len + sizeof(hr_timer_t) + sizeof(char);
-
-    assert(len <= TRACE_PACKET_LENGTH);
+    return 0;
+}
 
-    fifo_in(&trace_fifo, buf, len);
+static void trace_rec_fill(k_trace_rec_t *rec, uint32_t delta, uint16_t id,
+                           uint8_t cpu, uint8_t arg0, uintptr_t obj, uintptr_t arg)
+{
+    rec->delta = delta;
+    rec->id    = id;
+    rec->cpu   = cpu;
+    rec->arg0  = arg0;
+    rec->obj   = obj;
+    rec->arg   = arg;
 }
 
-void _trace_task_switch(ktask_t *from, ktask_t *to)
+static void trace_write(ktask_t *task, uint16_t id, uint8_t arg0, uintptr_t obj,
+                        uintptr_t arg)
 {
-    uint32_t  buf[TRACE_PACKET_LENGTH / 4];
-    char     *addr_first = (char *)buf;
-    char     *addr_second;
-    uint32_t  str_len = 0;
+    CPSR_ALLOC();
 
-    if (!init) {
+    k_trace_ring_t *ring;
+    hr_timer_t      now;
+    uint32_t        w;
+    uint32_t        need;
+    uint8_t         sync;
+    uint8_t         cpu;
+
+    if (!init || trace_filter(task, id)) {
         return;
     }
 
-    buf[0] = 0x102;
-    buf[1] = 0x4;
-    buf[2] = (uint32_t)from->task_state;
-    buf[3] = (uint32_t)to->task_state;
-
-    addr_second = (char *)&buf[4];
-    strcpy(addr_second, from->task_name);
-    addr_second = (char *)&buf[4] + strlen(from->task_name) + 1;
-    str_len += strlen(from->task_name) + 1;
+    /* the owner cpu is the only producer of its ring */
+    RHINO_CPU_INTRPT_DISABLE();
 
-    strcpy(addr_second, to->task_name);
-    addr_second += strlen(to->task_name) + 1;
-    str_len += strlen(to->task_name) + 1;
+    cpu  = cpu_cur_get();
+    ring = &g_trace_ring[cpu];
+    now  = HR_COUNT_GET();
+    w    = rhino_atomic_load_relaxed(&ring->widx);
 
-    str_len = ROUND_POINT(str_len);
+    sync = (ring->sync_left == 0u) || ((uint64_t)(now - ring->last) > 0xffffffffu);
+    need = sync ? 2u : 1u;
 
-    addr_second = addr_first + 16 + str_len;
-
-    trace_filter_and_write(from, buf, addr_second - addr_first);
-}
-
-void _trace_intrpt_task_switch(ktask_t *from, ktask_t *to)
-{
-    uint32_t  buf[TRACE_PACKET_LENGTH / 4];
-    char     *addr_first = (char *)buf;
-    char     *addr_second;
-    uint32_t  str_len = 0;
-
-    if (!init) {
+    if ((trace_mode == TRACE_MODE_STOP) &&
+        (w + need - rhino_atomic_load_acquire(&ring->ridx) > RHINO_CONFIG_TRACE_RING_SIZE)) {
+        rhino_atomic_store_release(&ring->drop, rhino_atomic_load_relaxed(&ring->drop) + 1u);
+        RHINO_CPU_INTRPT_ENABLE();
         return;
     }
 
-    buf[0] = 0x104;
-    buf[1] = 0x4;
-    buf[2] = (uint32_t)from->task_state;
-    buf[3] = (uint32_t)to->task_state;
-
-    addr_second = (char *)&buf[4];
-    strcpy(addr_second, from->task_name);
-    addr_second = (char *)&buf[4] + strlen(from->task_name) + 1;
-    str_len += strlen(from->task_name) + 1;
-
-    strcpy(addr_second, to->task_name);
-    addr_second += strlen(to->task_name) + 1;
-    str_len += strlen(to->task_name) + 1;
+    if (sync) {
+        trace_rec_fill(&ring->rec[w & TRACE_RING_MASK], 0u, TRACE_ID_SYNC, cpu, 0u,
+                       (uint32_t)now, (uint32_t)((uint64_t)now >> 32));
+        ring->last      = now;
+        ring->sync_left = TRACE_SYNC_INTERVAL;
+        w++;
+    }
 
-    str_len = ROUND_POINT(str_len);
+    trace_rec_fill(&ring->rec[w & TRACE_RING_MASK], (uint32_t)(now - ring->last),
+                   id, cpu, arg0, obj, arg);
+    ring->last = now;
+    ring->sync_left--;
 
-    addr_second = addr_first + 16 + str_len;
+    rhino_atomic_store_release(&ring->widx, w + 1u);
 
-    trace_filter_and_write(from, buf, addr_second - addr_first);
+    RHINO_CPU_INTRPT_ENABLE();
 }
 
-void _trace_task_create(ktask_t *task)
+static void trace_name(const void *obj, const name_t *name)
 {
-    uint32_t  buf[TRACE_PACKET_LENGTH / 4];
-    char     *addr_first = (char *)buf;
-    char     *addr_second;
-    uint32_t  str_len = 0;
+    uint32_t chunk;
+    size_t   len;
+    size_t   off;
 
-    if (!init) {
+    if (name == NULL) {
         return;
     }
 
-    buf[0] = 0x103;
-    buf[1] = 0x2;
-    buf[2] = (uint32_t)task->task_state;
-
-    if ((strlen(task->task_name) + 1) > MAX_MODULE_NAME) {
-
-        task->task_name = "max_length_limited_task";
+    len = strlen(name) + 1u;
+    if (len > TRACE_NAME_MAX) {
+        len = TRACE_NAME_MAX;
     }
 
-    addr_second = (char *)&buf[3];
-    strcpy(addr_second, task->task_name);
-    addr_second = (char *)&buf[3] + strlen(task->task_name) + 1;
-
-    str_len += strlen(task->task_name) + 1;
-    str_len = ROUND_POINT(str_len);
-
-    addr_second = addr_first + 12 + str_len;
-
-    trace_filter_and_write(task, buf, addr_second - addr_first);
+    for (off = 0u; off < len; off += sizeof(chunk)) {
+        chunk = 0u;
+        memcpy(&chunk, name + off, (len - off) < sizeof(chunk) ? (len - off) : sizeof(chunk));
+        trace_write(NULL, TRACE_ID_NAME, (uint8_t)off, TRACE_OBJ(obj), chunk);
+    }
 }
 
-void _trace_task_sleep(ktask_t *task, tick_t ticks)
+#if (RHINO_CONFIG_SYSTEM_STATS > 0)
+static void trace_names_dump(klist_t *head, size_t item_off, size_t name_off)
 {
-    uint32_t  buf[TRACE_PACKET_LENGTH / 4];
-    char     *addr_first = (char *)buf;
-    char     *addr_second;
-    uint32_t  str_len = 0;
+    klist_t *tmp;
+    uint8_t *obj;
 
-    if (!init) {
-        return;
+    for (tmp = head->next; tmp != head; tmp = tmp->next) {
+        obj = (uint8_t *)tmp - item_off;
+        trace_name(obj, *(const name_t **)(obj + name_off));
     }
+}
 
-    buf[0] = 0x10a;
-    buf[1] = 0x3;
-    buf[2] = (uint32_t)task->task_state;
-
-    addr_second = (char *)&buf[3];
-    strcpy(addr_second, task->task_name);
-    addr_second = (char *)&buf[3] + strlen(task->task_name) + 1;
+#define TRACE_NAMES_DUMP(head, type, item, name) \
+    trace_names_dump(head, offsetof(type, item), offsetof(type, name))
 
-    str_len += strlen(task->task_name) + 1;
-    str_len = ROUND_POINT(str_len);
+/* objects created before tracing started */
+static void trace_names_init(void)
+{
+    CPSR_ALLOC();
 
-    addr_second = addr_first + 12 + str_len;
+    RHINO_CRITICAL_ENTER();
 
-    *(uint32_t *)addr_second = (uint32_t)ticks;
-    addr_second += 4;
+    TRACE_NAMES_DUMP(&g_kobj_list.task_head, ktask_t, task_stats_item, task_name);
+    TRACE_NAMES_DUMP(&g_kobj_list.mutex_head, kmutex_t, mutex_item, blk_obj.name);
+#if (RHINO_CONFIG_MM_BLK > 0)
+    TRACE_NAMES_DUMP(&g_kobj_list.mblkpool_head, mblk_pool_t, mblkpool_stats_item, pool_name);
+#endif
+#if (RHINO_CONFIG_SEM > 0)
+    TRACE_NAMES_DUMP(&g_kobj_list.sem_head, ksem_t, sem_item, blk_obj.name);
+#endif
+#if (RHINO_CONFIG_QUEUE > 0)
+    TRACE_NAMES_DUMP(&g_kobj_list.queue_head, kqueue_t, queue_item, blk_obj.name);
+#endif
+#if (RHINO_CONFIG_EVENT_FLAG > 0)
+    TRACE_NAMES_DUMP(&g_kobj_list.event_head, kevent_t, event_item, blk_obj.name);
+#endif
+#if (RHINO_CONFIG_BUF_QUEUE > 0)
+    TRACE_NAMES_DUMP(&g_kobj_list.buf_queue_head, kbuf_queue_t, buf_queue_item, blk_obj.name);
+#endif
 
-    trace_filter_and_write(task, buf, addr_second - addr_first);
+    RHINO_CRITICAL_EXIT();
 }
+#endif
 
-void _trace_task_pri_change(ktask_t *task, ktask_t *task_pri_chg, uint8_t pri)
+static size_t trace_ring_drain(k_trace_ring_t *ring, uint8_t cpu,
+                               k_trace_rec_t *out, size_t num)
 {
-    uint32_t  buf[TRACE_PACKET_LENGTH / 4];
-    char     *addr_first = (char *)buf;
-    char     *addr_second;
-    uint32_t  str_len = 0;
+    uint32_t r;
+    uint32_t w;
+    uint32_t drop;
+    size_t   n;
 
-    if (!init) {
-        return;
-    }
+    n = 0u;
+    r = rhino_atomic_load_relaxed(&ring->ridx);
+    w = rhino_atomic_load_acquire(&ring->widx);
 
-    buf[0] = 0x105;
-    buf[1] = 0x5;
-    buf[2] = (uint32_t)task->task_state;
-    buf[3] = (uint32_t)task_pri_chg->task_state;
+    /* one slot for the record, one for a LOST ahead of it */
+    while ((r != w) && (n + 2u <= num)) {
+        out[n] = ring->rec[r & TRACE_RING_MASK];
 
-    addr_second = (char *)&buf[4];
-    strcpy(addr_second, task->task_name);
-    addr_second = (char *)&buf[4] + strlen(task->task_name) + 1;
-    str_len += strlen(task->task_name) + 1;
+        /* the copy is good only if the producer did not lap the slot meanwhile */
+        rhino_atomic_fence_acquire();
+        w = rhino_atomic_load_relaxed(&ring->widx);
 
-    strcpy(addr_second, task_pri_chg->task_name);
-    addr_second += strlen(task_pri_chg->task_name) + 1;
-    str_len += strlen(task_pri_chg->task_name) + 1;
+        if ((trace_mode == TRACE_MODE_OVERWRITE) && (w - r > TRACE_RING_SAFE)) {
+            ring->lost += w - TRACE_RING_SAFE - r;
+            r           = w - TRACE_RING_SAFE;
+            continue;
+        }
 
-    str_len = ROUND_POINT(str_len);
+        if (ring->lost > 0u) {
+            out[n + 1u] = out[n];
+            trace_rec_fill(&out[n], 0u, TRACE_ID_LOST, cpu, 1u, ring->lost, 0u);
+            ring->lost = 0u;
+            n++;
+        }
 
-    addr_second = addr_first + 16 + str_len;
+        n++;
+        r++;
+    }
 
-    *(uint32_t *)addr_second = (uint32_t)pri;
-    addr_second += 4;
+    if ((ring->lost > 0u) && (n < num)) {
+        trace_rec_fill(&out[n], 0u, TRACE_ID_LOST, cpu, 1u, ring->lost, 0u);
+        ring->lost = 0u;
+        n++;
+    }
 
-    trace_filter_and_write(task, buf, addr_second - addr_first);
+    /* refused records leave the delta chain intact */
+    drop = rhino_atomic_load_acquire(&ring->drop);
+    if ((drop != ring->drop_seen) && (n < num)) {
+        trace_rec_fill(&out[n], 0u, TRACE_ID_LOST, cpu, 0u, drop - ring->drop_seen, 0u);
+        ring->drop_seen = drop;
+        n++;
+    }
+
+    rhino_atomic_store_release(&ring->ridx, r);
+
+    return n;
 }
 
-void _trace_task_suspend(ktask_t *task, ktask_t *task_suspended)
+size_t trace_drain(void *buf, size_t size)
 {
-    uint32_t  buf[TRACE_PACKET_LENGTH / 4];
-    char     *addr_first = (char *)buf;
-    char     *addr_second;
-    uint32_t  str_len = 0;
+    k_trace_rec_t *out;
+    size_t         num;
+    size_t         n;
+    uint8_t        cpu;
+    uint8_t        i;
 
-    if (!init) {
-        return;
+    if (buf == NULL) {
+        return 0u;
     }
 
-    buf[0] = 0x106;
-    buf[1] = 0x4;
-    buf[2] = (uint32_t)task->task_state;
-    buf[3] = (uint32_t)task_suspended->task_state;
-
-    addr_second = (char *)&buf[2];
-    strcpy(addr_second, task->task_name);
-    addr_second = (char *)&buf[2] + strlen(task->task_name) + 1;
-    str_len += strlen(task->task_name) + 1;
+    out = (k_trace_rec_t *)buf;
+    num = size / sizeof(k_trace_rec_t);
+    n   = 0u;
 
-    strcpy(addr_second, task_suspended->task_name);
-    addr_second += strlen(task_suspended->task_name) + 1;
-    str_len += strlen(task_suspended->task_name) + 1;
+    /* a small buf must not starve the last cpus */
+    cpu = drain_cpu;
+    drain_cpu = (uint8_t)((drain_cpu + 1u) % RHINO_CONFIG_CPU_NUM);
 
-    str_len = ROUND_POINT(str_len);
-
-    addr_second = addr_first + 16 + str_len;
+    for (i = 0u; i < RHINO_CONFIG_CPU_NUM; i++) {
+        n  += trace_ring_drain(&g_trace_ring[cpu], cpu, &out[n], num - n);
+        cpu = (uint8_t)((cpu + 1u) % RHINO_CONFIG_CPU_NUM);
+    }
 
-    trace_filter_and_write(task, buf, addr_second - addr_first);
+    return n * sizeof(k_trace_rec_t);
 }
 
-void _trace_task_resume(ktask_t *task, ktask_t *task_resumed)
+static void trace_drain_task(void *arg)
 {
-    uint32_t  buf[TRACE_PACKET_LENGTH / 4];
-    char     *addr_first = (char *)buf;
-    char     *addr_second;
-    uint32_t  str_len = 0;
-
-    if (!init) {
-        return;
-    }
+    k_trace_rec_t buf[TRACE_DRAIN_BATCH];
+    trace_sink_t  sink;
+    size_t        len;
+    uint32_t      i;
 
-    buf[0] = 0x107;
-    buf[1] = 0x4;
-    buf[2] = (uint32_t)task->task_state;
-    buf[3] = (uint32_t)task_resumed->task_state;
+    (void)arg;
 
-    addr_second = (char *)&buf[4];
-    strcpy(addr_second, task->task_name);
-    addr_second = (char *)&buf[4] + strlen(task->task_name) + 1;
-    str_len += strlen(task->task_name) + 1;
+    while (1) {
+        sink = trace_sink;
 
-    strcpy(addr_second, task_resumed->task_name);
-    addr_second += strlen(task_resumed->task_name) + 1;
-    str_len += strlen(task_resumed->task_name) + 1;
-
-    str_len = ROUND_POINT(str_len);
+        /* bounded, the sink may produce records itself */
+        for (i = 0u; (sink != NULL) &&
+             (i < RHINO_CONFIG_TRACE_RING_SIZE * RHINO_CONFIG_CPU_NUM / TRACE_DRAIN_BATCH + 1u); i++) {
+            len = trace_drain(buf, sizeof(buf));
+            if (len == 0u) {
+                break;
+            }
 
-    addr_second = addr_first + 16 + str_len;
+            sink(buf, len);
+        }
 
-    trace_filter_and_write(task, buf, addr_second - addr_first);
+        krhino_task_sleep(RHINO_CONFIG_TRACE_DRAIN_TICKS);
+    }
 }
 
-void _trace_task_del(ktask_t *task, ktask_t *task_del)
+/* task trace function */
+void _trace_init(void)
 {
-    uint32_t  buf[TRACE_PACKET_LENGTH / 4];
-    char     *addr_first = (char *)buf;
-    char     *addr_second;
-    uint32_t  str_len = 0;
+    uint8_t i;
 
-    if (!init) {
-        return;
-    }
+    init = 0;
 
-    buf[0] = 0x108;
-    buf[1] = 0x4;
-    buf[2] = (uint32_t)task->task_state;
-    buf[3] = (uint32_t)task_del->task_state;
+    for (i = 0u; i < RHINO_CONFIG_CPU_NUM; i++) {
+        memset(g_trace_ring[i].rec, 0, sizeof(g_trace_ring[i].rec));
+        rhino_atomic_idx_init(&g_trace_ring[i].widx, 0u);
+        rhino_atomic_idx_init(&g_trace_ring[i].ridx, 0u);
+        rhino_atomic_idx_init(&g_trace_ring[i].drop, 0u);
+        g_trace_ring[i].last      = 0u;
+        g_trace_ring[i].sync_left = 0u;
+        g_trace_ring[i].drop_seen = 0u;
+        g_trace_ring[i].lost      = 0u;
+    }
 
-    addr_second = (char *)&buf[4];
-    strcpy(addr_second, task->task_name);
-    addr_second = (char *)&buf[4] + strlen(task->task_name) + 1;
-    str_len += strlen(task->task_name) + 1;
+    init = 1;
 
-    strcpy(addr_second, task_del->task_name);
-    addr_second += strlen(task_del->task_name) + 1;
-    str_len += strlen(task_del->task_name) + 1;
+    trace_write(NULL, TRACE_ID_INIT, 0u, TRACE_OBJ(g_active_task[cpu_cur_get()]), 0u);
 
-    str_len = ROUND_POINT(str_len);
+#if (RHINO_CONFIG_SYSTEM_STATS > 0)
+    trace_names_init();
+#endif
 
-    addr_second = addr_first + 16 + str_len;
+    if (trace_task_started == 0u) {
+        trace_task_started = 1u;
+        krhino_task_create(&trace_task, "trace_drain", NULL, RHINO_CONFIG_TRACE_TASK_PRI,
+                           0, trace_task_stack, RHINO_CONFIG_TRACE_TASK_STACK,
+                           trace_drain_task, 1u);
+    }
+}
 
-    trace_filter_and_write(task, buf, addr_second - addr_first);
+void _trace_task_switch(ktask_t *from, ktask_t *to)
+{
+    trace_write(from, TRACE_ID_TASK_SWITCH, (uint8_t)from->task_state,
+                TRACE_OBJ(from), TRACE_OBJ(to));
 }
 
-void _trace_task_abort(ktask_t *task, ktask_t *task_abort)
+void _trace_intrpt_task_switch(ktask_t *from, ktask_t *to)
 {
-    uint32_t  buf[TRACE_PACKET_LENGTH / 4];
-    char     *addr_first = (char *)buf;
-    char     *addr_second;
-    uint32_t  str_len = 0;
+    trace_write(from, TRACE_ID_INTRPT_TASK_SWITCH, (uint8_t)from->task_state,
+                TRACE_OBJ(from), TRACE_OBJ(to));
+}
 
-    if (!init) {
-        return;
-    }
+void _trace_task_create(ktask_t *task)
+{
+    trace_write(task, TRACE_ID_TASK_CREATE, task->prio, TRACE_OBJ(task), 0u);
+    trace_name(task, task->task_name);
+}
 
-    buf[0] = 0x109;
-    buf[1] = 0x4;
-    buf[2] = (uint32_t)task->task_state;
-    buf[3] = (uint32_t)task_abort->task_state;
+void _trace_task_sleep(ktask_t *task, tick_t ticks)
+{
+    trace_write(task, TRACE_ID_TASK_SLEEP, 0u, TRACE_OBJ(task), (uint32_t)ticks);
+}
 
-    addr_second = (char *)&buf[4];
-    strcpy(addr_second, task->task_name);
-    addr_second = (char *)&buf[4] + strlen(task->task_name) + 1;
-    str_len += strlen(task->task_name) + 1;
+void _trace_task_pri_change(ktask_t *task, ktask_t *task_pri_chg, uint8_t pri)
+{
+    trace_write(task, TRACE_ID_TASK_PRI_CHANGE, pri, TRACE_OBJ(task_pri_chg), 0u);
+}
 
-    strcpy(addr_second, task_abort->task_name);
-    addr_second += strlen(task_abort->task_name) + 1;
-    str_len += strlen(task_abort->task_name) + 1;
+void _trace_task_suspend(ktask_t *task, ktask_t *task_suspended)
+{
+    trace_write(task, TRACE_ID_TASK_SUSPEND, 0u, TRACE_OBJ(task_suspended), 0u);
+}
 
-    str_len = ROUND_POINT(str_len);
+void _trace_task_resume(ktask_t *task, ktask_t *task_resumed)
+{
+    trace_write(task, TRACE_ID_TASK_RESUME, 0u, TRACE_OBJ(task_resumed), 0u);
+}
 
-    addr_second = addr_first + 16 + str_len;
+void _trace_task_del(ktask_t *task, ktask_t *task_del)
+{
+    trace_write(task, TRACE_ID_TASK_DEL, 0u, TRACE_OBJ(task_del), 0u);
+}
 
-    trace_filter_and_write(task, buf, addr_second - addr_first);
+void _trace_task_abort(ktask_t *task, ktask_t *task_abort)
+{
+    trace_write(task, TRACE_ID_TASK_ABORT, 0u, TRACE_OBJ(task_abort), 0u);
 }
 
 /* semaphore trace function */
 void _trace_sem_create(ktask_t *task, ksem_t *sem)
 {
-    uint32_t  buf[TRACE_PACKET_LENGTH / 4];
-    char     *addr_first = (char *)buf;
-    char     *addr_second;
-    uint32_t  str_len = 0;
-    const name_t *task_name;
-
-    if (!init) {
-        return;
-    }
-
-    if (task == 0) {
-        task_name = "system init";
-    } else {
-        task_name = task->task_name;
-    }
-
-    buf[0] = 0x201;
-    buf[1] = 0x3;
-    buf[2] = (uint32_t)task->task_state;
-
-    if ((strlen(sem->blk_obj.name) + 1) > MAX_MODULE_NAME) {
-        sem->blk_obj.name = "max_length_limited_sem";
-    }
-
-    addr_second = (char *)&buf[3];
-    strcpy(addr_second, task_name);
-    addr_second = (char *)&buf[3] + strlen(task_name) + 1;
-    str_len += strlen(task_name) + 1;
-
-    strcpy(addr_second, sem->blk_obj.name);
-    addr_second += strlen(sem->blk_obj.name) + 1;
-    str_len += strlen(sem->blk_obj.name) + 1;
-
-    str_len = ROUND_POINT(str_len);
-
-    addr_second = addr_first + 12 + str_len;
-
-    trace_filter_and_write(task, buf, addr_second - addr_first);
+    trace_write(task, TRACE_ID_SEM_CREATE, 0u, TRACE_OBJ(sem), (uint32_t)sem->count);
+    trace_name(sem, sem->blk_obj.name);
 }
 
 void _trace_sem_overflow(ktask_t *task, ksem_t *sem)
 {
-    uint32_t  buf[TRACE_PACKET_LENGTH / 4];
-    char     *addr_first = (char *)buf;
-    char     *addr_second;
-    uint32_t  str_len = 0;
-
-    if (!init) {
-        return;
-    }
-
-    buf[0] = 0x202;
-    buf[1] = 0x3;
-    buf[2] = (uint32_t)task->task_state;
-
-    addr_second = (char *)&buf[3];
-    strcpy(addr_second, task->task_name);
-    addr_second = (char *)&buf[3] + strlen(task->task_name) + 1;
-    str_len += strlen(task->task_name) + 1;
-
-    strcpy(addr_second, sem->blk_obj.name);
-    addr_second += strlen(sem->blk_obj.name) + 1;
-    str_len += strlen(sem->blk_obj.name) + 1;
-
-    str_len = ROUND_POINT(str_len);
-
-    addr_second = addr_first + 12 + str_len;
-
-    trace_filter_and_write(task, buf, addr_second - addr_first);
+    trace_write(task, TRACE_ID_SEM_OVERFLOW, 0u, TRACE_OBJ(sem), (uint32_t)sem->count);
 }
 
 void _trace_sem_del(ktask_t *task, ksem_t *sem)
 {
-    uint32_t  buf[TRACE_PACKET_LENGTH / 4];
-    char     *addr_first = (char *)buf;
-    char     *addr_second;
-    uint32_t  str_len = 0;
-
-    if (!init) {
-        return;
-    }
-
-    buf[0] = 0x207;
-    buf[1] = 0x3;
-    buf[2] = (uint32_t)task->task_state;
-
-    addr_second = (char *)&buf[3];
-    strcpy(addr_second, task->task_name);
-    addr_second = (char *)&buf[3] + strlen(task->task_name) + 1;
-    str_len += strlen(task->task_name) + 1;
-
-    strcpy(addr_second, sem->blk_obj.name);
-    addr_second += strlen(sem->blk_obj.name) + 1;
-    str_len += strlen(sem->blk_obj.name) + 1;
-
-    str_len = ROUND_POINT(str_len);
-
-    addr_second = addr_first + 12 + str_len;
-
-    trace_filter_and_write(task, buf, addr_second - addr_first);
+    trace_write(task, TRACE_ID_SEM_DEL, 0u, TRACE_OBJ(sem), 0u);
 }
 
 void _trace_sem_get_success(ktask_t *task, ksem_t *sem)
 {
-    uint32_t  buf[TRACE_PACKET_LENGTH / 4];
-    char     *addr_first = (char *)buf;
-    char     *addr_second;
-    uint32_t  str_len = 0;
-
-    if (!init) {
-        return;
-    }
-
-    buf[0] = 0x204;
-    buf[1] = 0x3;
-    buf[2] = (uint32_t)task->task_state;
-
-    addr_second = (char *)&buf[3];
-    strcpy(addr_second, task->task_name);
-    addr_second = (char *)&buf[3] + strlen(task->task_name) + 1;
-    str_len += strlen(task->task_name) + 1;
-
-    strcpy(addr_second, sem->blk_obj.name);
-    addr_second += strlen(sem->blk_obj.name) + 1;
-    str_len += strlen(sem->blk_obj.name) + 1;
-
-    str_len = ROUND_POINT(str_len);
-
-    addr_second = addr_first + 12 + str_len;
-
-    trace_filter_and_write(task, buf, addr_second - addr_first);
+    trace_write(task, TRACE_ID_SEM_GET_SUCCESS, 0u, TRACE_OBJ(sem), (uint32_t)sem->count);
 }
 
 void _trace_sem_get_blk(ktask_t *task, ksem_t *sem, tick_t wait_option)
 {
-    uint32_t  buf[TRACE_PACKET_LENGTH / 4];
-    char     *addr_first = (char *)buf;
-    char     *addr_second;
-    uint32_t  str_len = 0;
-
-    if (!init) {
-        return;
-    }
-
-    buf[0] = 0x205;
-    buf[1] = 0x4;
-    buf[2] = (uint32_t)task->task_state;
-
-    addr_second = (char *)&buf[3];
-    strcpy(addr_second, task->task_name);
-    addr_second = (char *)&buf[3] + strlen(task->task_name) + 1;
-    str_len += strlen(task->task_name) + 1;
-
-    strcpy(addr_second, sem->blk_obj.name);
-    addr_second += strlen(sem->blk_obj.name) + 1;
-    str_len += strlen(sem->blk_obj.name) + 1;
-
-    str_len = ROUND_POINT(str_len);
-
-    addr_second = addr_first + 12 + str_len;
-
-    *(uint32_t *)addr_second = wait_option;
-    addr_second += 4;
-
-    trace_filter_and_write(task, buf, addr_second - addr_first);
+    trace_write(task, TRACE_ID_SEM_GET_BLK, 0u, TRACE_OBJ(sem), (uint32_t)wait_option);
 }
 
 void _trace_sem_task_wake(ktask_t *task, ktask_t *task_waked_up, ksem_t *sem, uint8_t opt_wake_all)
 {
-
-    uint32_t  buf[TRACE_PACKET_LENGTH / 4];
-    char     *addr_first = (char *)buf;
-    char     *addr_second;
-    uint32_t  str_len = 0;
-
-    if (!init) {
-        return;
-    }
-
-    buf[0] = 0x206;
-    buf[1] = 0x6;
-    buf[2] = (uint32_t)task->task_state;
-    buf[3] = (uint32_t)task_waked_up->task_state;
-
-    addr_second = (char *)&buf[4];
-    strcpy(addr_second, task->task_name);
-    addr_second = (char *)&buf[4] + strlen(task->task_name) + 1;
-    str_len += strlen(task->task_name) + 1;
-
-    strcpy(addr_second, task_waked_up->task_name);
-    addr_second += strlen(task_waked_up->task_name) + 1;
-    str_len += strlen(task_waked_up->task_name) + 1;
-
-    strcpy(addr_second, sem->blk_obj.name);
-    addr_second += strlen(sem->blk_obj.name) + 1;
-    str_len += strlen(sem->blk_obj.name) + 1;
-
-    str_len = ROUND_POINT(str_len);
-
-    addr_second = addr_first + 16 + str_len;
-
-    *(uint32_t *)addr_second = (uint32_t)opt_wake_all;
-    addr_second += 4;
-
-    trace_filter_and_write(task, buf, addr_second - addr_first);
+    trace_write(task, TRACE_ID_SEM_TASK_WAKE, opt_wake_all, TRACE_OBJ(sem),
+                TRACE_OBJ(task_waked_up));
 }
 
 void _trace_sem_cnt_increase(ktask_t *task, ksem_t *sem)
 {
-    uint32_t  buf[TRACE_PACKET_LENGTH / 4];
-    char     *addr_first = (char *)buf;
-    char     *addr_second;
-    uint32_t  str_len = 0;
-
-    if (!init) {
-        return;
-    }
-
-    buf[0] = 0x203;
-    buf[1] = 0x3;
-    buf[2] = (uint32_t)task->task_state;
-
-    addr_second = (char *)&buf[3];
-    strcpy(addr_second, task->task_name);
-    addr_second = (char *)&buf[3] + strlen(task->task_name) + 1;
-    str_len += strlen(task->task_name) + 1;
-
-    strcpy(addr_second, sem->blk_obj.name);
-    addr_second += strlen(sem->blk_obj.name) + 1;
-    str_len += strlen(sem->blk_obj.name) + 1;
-
-    str_len = ROUND_POINT(str_len);
-
-    addr_second = addr_first + 12 + str_len;
-
-    trace_filter_and_write(task, buf, addr_second - addr_first);
+    trace_write(task, TRACE_ID_SEM_CNT_INCREASE, 0u, TRACE_OBJ(sem), (uint32_t)sem->count);
 }
 
 /* mutex trace function */
 void _trace_mutex_create(ktask_t *task, kmutex_t *mutex, const name_t *name)
 {
-    uint32_t  buf[TRACE_PACKET_LENGTH / 4];
-    char     *addr_first = (char *)buf;
-    char     *addr_second;
-    uint32_t  str_len = 0;
-
-    const name_t *task_name;
-
-    if (!init) {
-        return;
-    }
-
-    if (task == 0) {
-        task_name = "system init";
-    } else {
-        task_name = task->task_name;
-    }
-
-    buf[0] = 0x301;
-    buf[1] = 0x2;
-
-    if ((strlen(mutex->blk_obj.name) + 1) > MAX_MODULE_NAME) {
-        mutex->blk_obj.name = "max_length_limited_mutex";
-    }
-
-    addr_second = (char *)&buf[2];
-    strcpy(addr_second, task_name);
-    addr_second = (char *)&buf[2] + strlen(task_name) + 1;
-    str_len += strlen(task_name) + 1;
-
-    strcpy(addr_second, mutex->blk_obj.name);
-    addr_second += strlen(mutex->blk_obj.name) + 1;
-    str_len += strlen(mutex->blk_obj.name) + 1;
-
-    str_len = ROUND_POINT(str_len);
-
-    addr_second = addr_first + 8 + str_len;
-
-    trace_filter_and_write(task, buf, addr_second - addr_first);
+    trace_write(task, TRACE_ID_MUTEX_CREATE, 0u, TRACE_OBJ(mutex), 0u);
+    trace_name(mutex, name);
 }
 
 void _trace_mutex_release(ktask_t *task, ktask_t *task_release, uint8_t new_pri)
 {
-    uint32_t  buf[TRACE_PACKET_LENGTH / 4];
-    char     *addr_first = (char *)buf;
-    char     *addr_second;
-    uint32_t  str_len = 0;
-
-    if (!init) {
-        return;
-    }
-
-    buf[0] = 0x302;
-    buf[1] = 0x3;
-
-    addr_second = (char *)&buf[2];
-    strcpy(addr_second, task->task_name);
-    addr_second = (char *)&buf[2] + strlen(task->task_name) + 1;
-    str_len += strlen(task->task_name) + 1;
-
-    strcpy(addr_second, task_release->task_name);
-    addr_second += strlen(task_release->task_name) + 1;
-    str_len += strlen(task_release->task_name) + 1;
-
-    str_len = ROUND_POINT(str_len);
-
-    addr_second = addr_first + 8 + str_len;
-
-    *(uint32_t *)addr_second = new_pri;
-    addr_second += 4;
-
-    trace_filter_and_write(task, buf, addr_second - addr_first);
+    trace_write(task, TRACE_ID_MUTEX_RELEASE, new_pri, TRACE_OBJ(task_release), 0u);
 }
 
 void _trace_mutex_get(ktask_t *task, kmutex_t *mutex, tick_t wait_option)
 {
-    uint32_t  buf[TRACE_PACKET_LENGTH / 4];
-    char     *addr_first = (char *)buf;
-    char     *addr_second;
-    uint32_t  str_len = 0;
-
-    if (!init) {
-        return;
-    }
-
-    buf[0] = 0x303;
-    buf[1] = 0x3;
-
-    addr_second = (char *)&buf[2];
-    strcpy(addr_second, task->task_name);
-    addr_second = (char *)&buf[2] + strlen(task->task_name) + 1;
-    str_len += strlen(task->task_name) + 1;
-
-    strcpy(addr_second, mutex->blk_obj.name);
-    addr_second += strlen(mutex->blk_obj.name) + 1;
-    str_len += strlen(mutex->blk_obj.name) + 1;
-
-    str_len = ROUND_POINT(str_len);
-
-    addr_second = addr_first + 8 + str_len;
-
-    *(uint32_t *)addr_second = wait_option;
-    addr_second += 4;
-
-    trace_filter_and_write(task, buf, addr_second - addr_first);
+    trace_write(task, TRACE_ID_MUTEX_GET, 0u, TRACE_OBJ(mutex), (uint32_t)wait_option);
 }
 
 void _trace_task_pri_inv(ktask_t *task, ktask_t *mtxtsk)
 {
-    uint32_t  buf[TRACE_PACKET_LENGTH / 4];
-    char     *addr_first = (char *)buf;
-    char     *addr_second;
-    uint32_t  str_len = 0;
-
-    if (!init) {
-        return;
-    }
-
-    buf[0] = 0x304;
-    buf[1] = 0x2;
-
-    addr_second = (char *)&buf[2];
-    strcpy(addr_second, task->task_name);
-    addr_second = (char *)&buf[2] + strlen(task->task_name) + 1;
-    str_len += strlen(task->task_name) + 1;
-
-    strcpy(addr_second, mtxtsk->task_name);
-    addr_second += strlen(mtxtsk->task_name) + 1;
-    str_len += strlen(mtxtsk->task_name) + 1;
-
-    str_len = ROUND_POINT(str_len);
-
-    addr_second = addr_first + 8 + str_len;
-
-    trace_filter_and_write(task, buf, addr_second - addr_first);
+    trace_write(task, TRACE_ID_TASK_PRI_INV, mtxtsk->prio, TRACE_OBJ(mtxtsk), 0u);
 }
 
 void _trace_mutex_get_blk(ktask_t *task, kmutex_t *mutex, tick_t wait_option)
 {
-    uint32_t  buf[TRACE_PACKET_LENGTH / 4];
-    char     *addr_first = (char *)buf;
-    char     *addr_second;
-    uint32_t  str_len = 0;
-
-    if (!init) {
-        return;
-    }
-
-    buf[0] = 0x305;
-    buf[1] = 0x3;
-
-    addr_second = (char *)&buf[2];
-    strcpy(addr_second, task->task_name);
-    addr_second = (char *)&buf[2] + strlen(task->task_name) + 1;
-    str_len += strlen(task->task_name) + 1;
-
-    strcpy(addr_second, mutex->blk_obj.name);
-    addr_second += strlen(mutex->blk_obj.name) + 1;
-    str_len += strlen(mutex->blk_obj.name) + 1;
-
-    str_len = ROUND_POINT(str_len);
-
-    addr_second = addr_first + 8 + str_len;
-
-    *(uint32_t *)addr_second = wait_option;
-    addr_second += 4;
-
-    trace_filter_and_write(task, buf, addr_second - addr_first);
+    trace_write(task, TRACE_ID_MUTEX_GET_BLK, 0u, TRACE_OBJ(mutex), (uint32_t)wait_option);
 }
 
 void _trace_mutex_release_success(ktask_t *task, kmutex_t *mutex)
 {
-    uint32_t  buf[TRACE_PACKET_LENGTH / 4];
-    char     *addr_first = (char *)buf;
-    char     *addr_second;
-    uint32_t  str_len = 0;
-
-    if (!init) {
-        return;
-    }
-
-    buf[0] = 0x306;
-    buf[1] = 0x2;
-
-    addr_second = (char *)&buf[2];
-    strcpy(addr_second, task->task_name);
-    addr_second = (char *)&buf[2] + strlen(task->task_name) + 1;
-    str_len += strlen(task->task_name) + 1;
-
-    strcpy(addr_second, mutex->blk_obj.name);
-    addr_second += strlen(mutex->blk_obj.name) + 1;
-    str_len += strlen(mutex->blk_obj.name) + 1;
-
-    str_len = ROUND_POINT(str_len);
-
-    addr_second = addr_first + 8 + str_len;
-
-    trace_filter_and_write(task, buf, addr_second - addr_first);
+    trace_write(task, TRACE_ID_MUTEX_RELEASE_SUCCESS, 0u, TRACE_OBJ(mutex), 0u);
 }
 
-
 void _trace_mutex_task_wake(ktask_t *task, ktask_t *task_waked_up, kmutex_t *mutex)
 {
-    uint32_t  buf[TRACE_PACKET_LENGTH / 4];
-    char     *addr_first = (char *)buf;
-    char     *addr_second;
-    uint32_t  str_len = 0;
-
-    if (!init) {
-        return;
-    }
-
-    buf[0] = 0x307;
-    buf[1] = 0x3;
-
-    addr_second = (char *)&buf[2];
-    strcpy(addr_second, task->task_name);
-    addr_second = (char *)&buf[2] + strlen(task->task_name) + 1;
-    str_len += strlen(task->task_name) + 1;
-
-    strcpy(addr_second, task_waked_up->task_name);
-    addr_second += strlen(task_waked_up->task_name) + 1;
-    str_len += strlen(task_waked_up->task_name) + 1;
-
-    strcpy(addr_second, mutex->blk_obj.name);
-    addr_second += strlen(mutex->blk_obj.name) + 1;
-    str_len += strlen(mutex->blk_obj.name) + 1;
-
-    str_len = ROUND_POINT(str_len);
-
-    addr_second = addr_first + 8 + str_len;
-
-    trace_filter_and_write(task, buf, addr_second - addr_first);
+    trace_write(task, TRACE_ID_MUTEX_TASK_WAKE, 0u, TRACE_OBJ(mutex),
+                TRACE_OBJ(task_waked_up));
 }
 
 void _trace_mutex_del(ktask_t *task, kmutex_t *mutex)
 {
-    uint32_t  buf[TRACE_PACKET_LENGTH / 4];
-    char     *addr_first = (char *)buf;
-    char     *addr_second;
-    uint32_t  str_len = 0;
-
-    if (!init) {
-        return;
-    }
-
-    buf[0] = 0x308;
-    buf[1] = 0x2;
-
-    addr_second = (char *)&buf[2];
-    strcpy(addr_second, task->task_name);
-    addr_second = (char *)&buf[2] + strlen(task->task_name) + 1;
-    str_len += strlen(task->task_name) + 1;
-
-    strcpy(addr_second, mutex->blk_obj.name);
-    addr_second += strlen(mutex->blk_obj.name) + 1;
-    str_len += strlen(mutex->blk_obj.name) + 1;
-
-    str_len = ROUND_POINT(str_len);
-
-    addr_second = addr_first + 8 + str_len;
-
-    trace_filter_and_write(task, buf, addr_second - addr_first);
+    trace_write(task, TRACE_ID_MUTEX_DEL, 0u, TRACE_OBJ(mutex), 0u);
 }
 
 /* event trace function */
 void _trace_event_create(ktask_t *task, kevent_t *event, const name_t *name, uint32_t flags_init)
 {
-    uint32_t  buf[TRACE_PACKET_LENGTH / 4];
-    char     *addr_first = (char *)buf;
-    char     *addr_second;
-    uint32_t  str_len = 0;
-    const name_t *task_name;
-
-    if (!init) {
-        return;
-    }
-
-    if (task == 0) {
-        task_name = "system init";
-    } else {
-        task_name = task->task_name;
-    }
-
-    buf[0] = 0x401;
-    buf[1] = 0x3;
-
-    if ((strlen(event->blk_obj.name) + 1) > MAX_MODULE_NAME) {
-        event->blk_obj.name = "max_length_limited_event";
-    }
-
-    addr_second = (char *)&buf[2];
-    strcpy(addr_second, task_name);
-    addr_second = (char *)&buf[2] + strlen(task_name) + 1;
-    str_len += strlen(task_name) + 1;
-
-    strcpy(addr_second, event->blk_obj.name);
-    addr_second += strlen(event->blk_obj.name) + 1;
-    str_len += strlen(event->blk_obj.name) + 1;
-
-    str_len = ROUND_POINT(str_len);
-
-    addr_second = addr_first + 8 + str_len;
-
-    *(uint32_t *)addr_second = flags_init;
-    addr_second += 4;
-
-    trace_filter_and_write(task, buf, addr_second - addr_first);
-
+    trace_write(task, TRACE_ID_EVENT_CREATE, 0u, TRACE_OBJ(event), flags_init);
+    trace_name(event, name);
 }
 
 void _trace_event_get(ktask_t *task, kevent_t *event)
 {
-    uint32_t  buf[TRACE_PACKET_LENGTH / 4];
-    char     *addr_first = (char *)buf;
-    char     *addr_second;
-    uint32_t  str_len = 0;
-
-    if (!init) {
-        return;
-    }
-
-    buf[0] = 0x402;
-    buf[1] = 0x2;
-
-    addr_second = (char *)&buf[2];
-    strcpy(addr_second, task->task_name);
-    addr_second = (char *)&buf[2] + strlen(task->task_name) + 1;
-    str_len += strlen(task->task_name) + 1;
-
-    strcpy(addr_second, event->blk_obj.name);
-    addr_second += strlen(event->blk_obj.name) + 1;
-    str_len += strlen(event->blk_obj.name) + 1;
-
-    str_len = ROUND_POINT(str_len);
-
-    addr_second = addr_first + 8 + str_len;
-
-    trace_filter_and_write(task, buf, addr_second - addr_first);
+    trace_write(task, TRACE_ID_EVENT_GET, 0u, TRACE_OBJ(event), 0u);
 }
 
 void _trace_event_get_blk(ktask_t *task, kevent_t *event, tick_t wait_option)
 {
-    uint32_t  buf[TRACE_PACKET_LENGTH / 4];
-    char     *addr_first = (char *)buf;
-    char     *addr_second;
-    uint32_t  str_len = 0;
-
-    if (!init) {
-        return;
-    }
-
-    buf[0] = 0x403;
-    buf[1] = 0x3;
-
-    addr_second = (char *)&buf[2];
-    strcpy(addr_second, task->task_name);
-    addr_second = (char *)&buf[2] + strlen(task->task_name) + 1;
-    str_len += strlen(task->task_name) + 1;
-
-    strcpy(addr_second, event->blk_obj.name);
-    addr_second += strlen(event->blk_obj.name) + 1;
-    str_len += strlen(event->blk_obj.name) + 1;
-
-    str_len = ROUND_POINT(str_len);
-
-    addr_second = addr_first + 8 + str_len;
-
-    *(uint32_t *)addr_second = (uint32_t)wait_option;
-    addr_second += 4;
-
-    trace_filter_and_write(task, buf, addr_second - addr_first);
+    trace_write(task, TRACE_ID_EVENT_GET_BLK, 0u, TRACE_OBJ(event), (uint32_t)wait_option);
 }
 
 void _trace_event_task_wake(ktask_t *task, ktask_t *task_waked_up, kevent_t *event)
 {
-    uint32_t  buf[TRACE_PACKET_LENGTH / 4];
-    char     *addr_first = (char *)buf;
-    char     *addr_second;
-    uint32_t  str_len = 0;
-
-    if (!init) {
-        return;
-    }
-
-    buf[0] = 0x404;
-    buf[1] = 0x3;
-
-    addr_second = (char *)&buf[2];
-    strcpy(addr_second, task->task_name);
-    addr_second = (char *)&buf[2] + strlen(task->task_name) + 1;
-    str_len += strlen(task->task_name) + 1;
-
-    strcpy(addr_second, task_waked_up->task_name);
-    addr_second += strlen(task_waked_up->task_name) + 1;
-    str_len += strlen(task_waked_up->task_name) + 1;
-
-    strcpy(addr_second, event->blk_obj.name);
-    addr_second += strlen(event->blk_obj.name) + 1;
-    str_len += strlen(event->blk_obj.name) + 1;
-
-    str_len = ROUND_POINT(str_len);
-
-    addr_second = addr_first + 8 + str_len;
-
-    trace_filter_and_write(task, buf, addr_second - addr_first);
+    trace_write(task, TRACE_ID_EVENT_TASK_WAKE, 0u, TRACE_OBJ(event),
+                TRACE_OBJ(task_waked_up));
 }
 
-
 void _trace_event_del(ktask_t *task, kevent_t *event)
 {
-    uint32_t  buf[TRACE_PACKET_LENGTH / 4];
-    char     *addr_first = (char *)buf;
-    char     *addr_second;
-    uint32_t  str_len = 0;
-
-    if (!init) {
-        return;
-    }
-
-    buf[0] = 0x405;
-    buf[1] = 0x2;
-
-    addr_second = (char *)&buf[2];
-    strcpy(addr_second, task->task_name);
-    addr_second = (char *)&buf[2] + strlen(task->task_name) + 1;
-    str_len += strlen(task->task_name) + 1;
-
-    strcpy(addr_second, event->blk_obj.name);
-    addr_second += strlen(event->blk_obj.name) + 1;
-    str_len += strlen(event->blk_obj.name) + 1;
-
-    str_len = ROUND_POINT(str_len);
-
-    addr_second = addr_first + 8 + str_len;
-
-    trace_filter_and_write(task, buf, addr_second - addr_first);
+    trace_write(task, TRACE_ID_EVENT_DEL, 0u, TRACE_OBJ(event), 0u);
 }
 
 /* buf_queue trace function */
 void _trace_buf_queue_create(ktask_t *task, kbuf_queue_t *buf_queue)
 {
-    uint32_t  buf[TRACE_PACKET_LENGTH / 4];
-    char     *addr_first = (char *)buf;
-    char     *addr_second;
-    uint32_t  str_len = 0;
-    const name_t *task_name;
-
-    if (!init) {
-        return;
-    }
-
-    if (task == 0) {
-        task_name = "system init";
-    } else {
-        task_name = task->task_name;
-    }
-
-    buf[0] = 0x501;
-    buf[1] = 0x2;
-
-    if ((strlen(buf_queue->blk_obj.name) + 1) > MAX_MODULE_NAME) {
-        buf_queue->blk_obj.name = "max_length_limited_buf_queue";
-    }
-
-    addr_second = (char *)&buf[2];
-    strcpy(addr_second, task_name);
-    addr_second = (char *)&buf[2] + strlen(task_name) + 1;
-    str_len += strlen(task_name) + 1;
-
-    strcpy(addr_second, buf_queue->blk_obj.name);
-    addr_second += strlen(buf_queue->blk_obj.name) + 1;
-    str_len += strlen(buf_queue->blk_obj.name) + 1;
-
-    str_len = ROUND_POINT(str_len);
-
-    addr_second = addr_first + 8 + str_len;
-
-    trace_filter_and_write(task, buf, addr_second - addr_first);
+    trace_write(task, TRACE_ID_BUF_QUEUE_CREATE, 0u, TRACE_OBJ(buf_queue), 0u);
+    trace_name(buf_queue, buf_queue->blk_obj.name);
 }
 
 void _trace_buf_max(ktask_t *task, kbuf_queue_t *buf_queue, void *p_void, size_t msg_size)
 {
-    uint32_t  buf[TRACE_PACKET_LENGTH / 4];
-    char     *addr_first = (char *)buf;
-    char     *addr_second;
-    uint32_t  str_len = 0;
-
-    if (!init) {
-        return;
-    }
-
-    buf[0] = 0x502;
-    buf[1] = 0x3;
-
-    addr_second = (char *)&buf[2];
-    strcpy(addr_second, task->task_name);
-    addr_second = (char *)&buf[2] + strlen(task->task_name) + 1;
-    str_len += strlen(task->task_name) + 1;
-
-    strcpy(addr_second, buf_queue->blk_obj.name);
-    addr_second += strlen(buf_queue->blk_obj.name) + 1;
-    str_len += strlen(buf_queue->blk_obj.name) + 1;
-
-    str_len = ROUND_POINT(str_len);
-
-    addr_second = addr_first + 8 + str_len;
-
-    *(uint32_t *)addr_second = msg_size;
-    addr_second += 4;
-
-    trace_filter_and_write(task, buf, addr_second - addr_first);
+    trace_write(task, TRACE_ID_BUF_QUEUE_MAX, 0u, TRACE_OBJ(buf_queue), (uint32_t)msg_size);
 }
 
 void _trace_buf_post(ktask_t *task, kbuf_queue_t *buf_queue, void *p_void, size_t msg_size)
 {
-    uint32_t  buf[TRACE_PACKET_LENGTH / 4];
-    char     *addr_first = (char *)buf;
-    char     *addr_second;
-    uint32_t  str_len = 0;
-
-    if (!init) {
-        return;
-    }
-
-    buf[0] = 0x503;
-    buf[1] = 0x3;
-
-    addr_second = (char *)&buf[2];
-    strcpy(addr_second, task->task_name);
-    addr_second = (char *)&buf[2] + strlen(task->task_name) + 1;
-    str_len += strlen(task->task_name) + 1;
-
-    strcpy(addr_second, buf_queue->blk_obj.name);
-    addr_second += strlen(buf_queue->blk_obj.name) + 1;
-    str_len += strlen(buf_queue->blk_obj.name) + 1;
-
-    str_len = ROUND_POINT(str_len);
-
-    addr_second = addr_first + 8 + str_len;
-
-    *(uint32_t *)addr_second = msg_size;
-    addr_second += 4;
-
-    trace_filter_and_write(task, buf, addr_second - addr_first);
+    trace_write(task, TRACE_ID_BUF_QUEUE_POST, 0u, TRACE_OBJ(buf_queue), (uint32_t)msg_size);
 }
 
-
 void _trace_buf_queue_task_wake(ktask_t *task, ktask_t *task_waked_up, kbuf_queue_t *buf_queue)
 {
-    uint32_t  buf[TRACE_PACKET_LENGTH / 4];
-    char     *addr_first = (char *)buf;
-    char     *addr_second;
-    uint32_t  str_len = 0;
-
-    if (!init) {
-        return;
-    }
-
-    buf[0] = 0x504;
-    buf[1] = 0x3;
-
-    addr_second = (char *)&buf[2];
-    strcpy(addr_second, task->task_name);
-    addr_second = (char *)&buf[2] + strlen(task->task_name) + 1;
-    str_len += strlen(task->task_name) + 1;
-
-    strcpy(addr_second, task_waked_up->task_name);
-    addr_second += strlen(task_waked_up->task_name) + 1;
-    str_len += strlen(task_waked_up->task_name) + 1;
-
-    strcpy(addr_second, buf_queue->blk_obj.name);
-    addr_second += strlen(buf_queue->blk_obj.name) + 1;
-    str_len += strlen(buf_queue->blk_obj.name) + 1;
-
-    str_len = ROUND_POINT(str_len);
-
-    addr_second = addr_first + 8 + str_len;
-
-    trace_filter_and_write(task, buf, addr_second - addr_first);
+    trace_write(task, TRACE_ID_BUF_QUEUE_TASK_WAKE, 0u, TRACE_OBJ(buf_queue),
+                TRACE_OBJ(task_waked_up));
 }
 
-
 void _trace_buf_queue_get_blk(ktask_t *task, kbuf_queue_t *buf_queue, tick_t wait_option)
 {
-    uint32_t  buf[TRACE_PACKET_LENGTH / 4];
-    char     *addr_first = (char *)buf;
-    char     *addr_second;
-    uint32_t  str_len = 0;
-
-    if (!init) {
-        return;
-    }
-
-    buf[0] = 0x505;
-    buf[1] = 0x3;
-
-    addr_second = (char *)&buf[2];
-    strcpy(addr_second, task->task_name);
-    addr_second = (char *)&buf[2] + strlen(task->task_name) + 1;
-    str_len += strlen(task->task_name) + 1;
-
-    strcpy(addr_second, buf_queue->blk_obj.name);
-    addr_second += strlen(buf_queue->blk_obj.name) + 1;
-    str_len += strlen(buf_queue->blk_obj.name) + 1;
-
-    str_len = ROUND_POINT(str_len);
-
-    addr_second = addr_first + 8 + str_len;
-
-    *(uint32_t *)addr_second = (uint32_t)wait_option;
-    addr_second += 4;
-
-    trace_filter_and_write(task, buf, addr_second - addr_first);
+    trace_write(task, TRACE_ID_BUF_QUEUE_GET_BLK, 0u, TRACE_OBJ(buf_queue),
+                (uint32_t)wait_option);
 }
 
 /* timer trace function */
 void _trace_timer_create(ktask_t *task, ktimer_t *timer)
 {
-    uint32_t  buf[TRACE_PACKET_LENGTH / 4];
-    char     *addr_first = (char *)buf;
-    char     *addr_second;
-    uint32_t  str_len = 0;
-    const name_t *task_name;
-
-    if (!init) {
-        return;
-    }
-
-    if (task == 0) {
-        task_name = "system init";
-    } else {
-        task_name = task->task_name;
-    }
-
-    buf[0] = 0x601;
-    buf[1] = 0x2;
-
-    if ((strlen(timer->name) + 1) > MAX_MODULE_NAME) {
-        timer->name = "max_length_limited_timer";
-    }
-
-    addr_second = (char *)&buf[2];
-    strcpy(addr_second, task_name);
-    addr_second = (char *)&buf[2] + strlen(task_name) + 1;
-    str_len += strlen(task_name) + 1;
-
-    strcpy(addr_second, timer->name);
-    addr_second += strlen(timer->name) + 1;
-    str_len += strlen(timer->name) + 1;
-
-    str_len = ROUND_POINT(str_len);
-
-    addr_second = addr_first + 8 + str_len;
-
-    trace_filter_and_write(task, buf, addr_second - addr_first);
+    trace_write(task, TRACE_ID_TIMER_CREATE, 0u, TRACE_OBJ(timer), 0u);
+    trace_name(timer, timer->name);
 }
 
 void _trace_timer_del(ktask_t *task, ktimer_t *timer)
 {
-    uint32_t  buf[TRACE_PACKET_LENGTH / 4];
-    char     *addr_first = (char *)buf;
-    char     *addr_second;
-    uint32_t  str_len = 0;
-
-    if (!init) {
-        return;
-    }
-
-    buf[0] = 0x602;
-    buf[1] = 0x2;
-
-    addr_second = (char *)&buf[2];
-    strcpy(addr_second, task->task_name);
-    addr_second = (char *)&buf[2] + strlen(task->task_name) + 1;
-    str_len += strlen(task->task_name) + 1;
-
-    strcpy(addr_second, timer->name);
-    addr_second += strlen(timer->name) + 1;
-    str_len += strlen(timer->name) + 1;
-
-    str_len = ROUND_POINT(str_len);
-
-    addr_second = addr_first + 8 + str_len;
-
-    trace_filter_and_write(task, buf, addr_second - addr_first);
+    trace_write(task, TRACE_ID_TIMER_DEL, 0u, TRACE_OBJ(timer), 0u);
 }
 
 /* mblk trace function */
 void _trace_mblk_pool_create(ktask_t *task, mblk_pool_t *pool)
 {
-    uint32_t  buf[TRACE_PACKET_LENGTH / 4];
-    char     *addr_first = (char *)buf;
-    char     *addr_second;
-    uint32_t  str_len = 0;
-    const name_t *task_name;
-
-    if (!init) {
-        return;
-    }
-
-    if (task == 0) {
-        task_name = "system init";
-    } else {
-        task_name = task->task_name;
-    }
-
-    buf[0] = 0x701;
-    buf[1] = 0x2;
-
-    addr_second = (char *)&buf[2];
-    strcpy(addr_second, task_name);
-    addr_second = (char *)&buf[2] + strlen(task_name) + 1;
-    str_len += strlen(task_name) + 1;
-
-    strcpy(addr_second, pool->pool_name);
-    addr_second += strlen(pool->pool_name) + 1;
-    str_len += strlen(pool->pool_name) + 1;
-
-    str_len = ROUND_POINT(str_len);
-
-    addr_second = addr_first + 8 + str_len;
-
-    trace_filter_and_write(task, buf, addr_second - addr_first);
-}
-
-/* mm trace function */
-#if 0
-void _trace_mm_pool_create(ktask_t *task, mm_pool_t *pool)
-{
-    uint32_t  buf[20];
-    char     *addr_first = (char *)buf;
-    char     *addr_second;
-    uint32_t  str_len = 0;
-    const name_t *task_name;
-
-    if (task == 0) {
-        task_name = "system init";
-    } else {
-        task_name = task->task_name;
-    }
-
-    buf[0] = 0x801;
-    buf[1] = 0x2;
-
-    addr_second = (char *)&buf[2];
-    strcpy(addr_second, task_name);
-    addr_second = (char *)&buf[2] + strlen(task_name) + 1;
-    str_len += strlen(task_name) + 1;
-
-    strcpy(addr_second, pool->pool_name);
-    addr_second += strlen(pool->pool_name) + 1;
-    str_len += strlen(pool->pool_name) + 1;
-
-    str_len = ROUND_POINT(str_len);
-
-    addr_second = addr_first + 8 + str_len;
-
-    trace_filter_and_write(task, buf, addr_second - addr_first);
+    trace_write(task, TRACE_ID_MBLK_POOL_CREATE, 0u, TRACE_OBJ(pool), (uint32_t)pool->blk_size);
+    trace_name(pool, pool->pool_name);
 }
-#endif
 
 /* mm region function */
 void _trace_mm_region_create(ktask_t *task, k_mm_region_t *regions)
 {
-    uint32_t  buf[TRACE_PACKET_LENGTH / 4];
-    char     *addr_first = (char *)buf;
-    char     *addr_second;
-    uint32_t  str_len = 0;
-    const name_t *task_name;
-
-    if (!init) {
-        return;
-    }
-
-    if (task == 0) {
-        task_name = "system init";
-    } else {
-        task_name = task->task_name;
-    }
-
-    buf[0] = 0x901;
-    buf[1] = 0x2;
-
-    addr_second = (char *)&buf[2];
-    strcpy(addr_second, task_name);
-    addr_second = (char *)&buf[2] + strlen(task_name) + 1;
-    str_len += strlen(task_name) + 1;
-
-    strcpy(addr_second, "k_mm_region");
-    addr_second += strlen("k_mm_region") + 1;
-    str_len += strlen("k_mm_region") + 1;
-
-    str_len = ROUND_POINT(str_len);
-
-    addr_second = addr_first + 8 + str_len;
-
-    trace_filter_and_write(task, buf, addr_second - addr_first);
+    trace_write(task, TRACE_ID_MM_REGION_CREATE, 0u, TRACE_OBJ(regions), 0u);
 }
 
 /* work queue trace */
+#if (RHINO_CONFIG_WORKQUEUE > 0)
 void _trace_work_init(ktask_t *task, kwork_t *work)
 {
-    uint32_t  buf[TRACE_PACKET_LENGTH / 4];
-    char     *addr_first = (char *)buf;
-    char     *addr_second;
-    uint32_t  str_len = 0;
-    const name_t *task_name;
-
-    if (!init) {
-        return;
-    }
-
-    if (task == 0) {
-        task_name = "system init";
-    } else {
-        task_name = task->task_name;
-    }
-
-    buf[0] = 0xa01;
-    buf[1] = 0x2;
-
-    addr_second = (char *)&buf[2];
-    strcpy(addr_second, task_name);
-    addr_second = (char *)&buf[2] + strlen(task_name) + 1;
-    str_len += strlen(task_name) + 1;
-
-    strcpy(addr_second, "work");
-    addr_second += strlen("work") + 1;
-    str_len += strlen("work") + 1;
-
-    str_len = ROUND_POINT(str_len);
-
-    addr_second = addr_first + 8 + str_len;
-
-    trace_filter_and_write(task, buf, addr_second - addr_first);
+    trace_write(task, TRACE_ID_WORK_INIT, 0u, TRACE_OBJ(work), (uint32_t)work->dly);
 }
 
 void _trace_workqueue_create(ktask_t *task, kworkqueue_t *workqueue)
 {
-    uint32_t  buf[TRACE_PACKET_LENGTH / 4];
-    char     *addr_first = (char *)buf;
-    char     *addr_second;
-    uint32_t  str_len = 0;
-    const name_t *task_name;
-
-    if (!init) {
-        return;
-    }
-
-    if (task == 0) {
-        task_name = "system init";
-    } else {
-        task_name = task->task_name;
-    }
-
-    buf[0] = 0xa02;
-    buf[1] = 0x2;
-
-    if ((strlen(workqueue->name) + 1) > MAX_MODULE_NAME) {
-        workqueue->name = "max_length_limited_workqueue";
-    }
-
-    addr_second = (char *)&buf[2];
-    strcpy(addr_second, task_name);
-    addr_second = (char *)&buf[2] + strlen(task_name) + 1;
-    str_len += strlen(task_name) + 1;
-
-    strcpy(addr_second, workqueue->name);
-    addr_second += strlen(workqueue->name) + 1;
-    str_len += strlen(workqueue->name) + 1;
-
-    str_len = ROUND_POINT(str_len);
-
-    addr_second = addr_first + 8 + str_len;
-
-    trace_filter_and_write(task, buf, addr_second - addr_first);
+    trace_write(task, TRACE_ID_WORKQUEUE_CREATE, workqueue->worker_num,
+                TRACE_OBJ(workqueue), 0u);
+    trace_name(workqueue, workqueue->name);
 }
 
 void _trace_workqueue_del(ktask_t *task, kworkqueue_t *workqueue)
 {
-    uint32_t  buf[TRACE_PACKET_LENGTH / 4];
-    char     *addr_first = (char *)buf;
-    char     *addr_second;
-    uint32_t  str_len = 0;
-
-    if (!init) {
-        return;
-    }
-
-    buf[0] = 0xa03;
-    buf[1] = 0x2;
-
-    addr_second = (char *)&buf[2];
-    strcpy(addr_second, task->task_name);
-    addr_second = (char *)&buf[2] + strlen(task->task_name) + 1;
-    str_len += strlen(task->task_name) + 1;
-
-    strcpy(addr_second, workqueue->name);
-    addr_second += strlen(workqueue->name) + 1;
-    str_len += strlen(workqueue->name) + 1;
+    trace_write(task, TRACE_ID_WORKQUEUE_DEL, 0u, TRACE_OBJ(workqueue), 0u);
+}
+#endif
 
-    str_len = ROUND_POINT(str_len);
+/* queue trace function */
+void _trace_queue_create(ktask_t *task, kqueue_t *queue)
+{
+    trace_write(task, TRACE_ID_QUEUE_CREATE, 0u, TRACE_OBJ(queue), (uint32_t)queue->msg_q.size);
+    trace_name(queue, queue->blk_obj.name);
+}
 
-    addr_second = addr_first + 8 + str_len;
+void _trace_queue_get_blk(ktask_t *task, kqueue_t *queue, tick_t wait_option)
+{
+    trace_write(task, TRACE_ID_QUEUE_GET_BLK, 0u, TRACE_OBJ(queue), (uint32_t)wait_option);
+}
 
-    trace_filter_and_write(task, buf, addr_second - addr_first);
+void _trace_queue_task_wake(ktask_t *task, ktask_t *task_waked_up, kqueue_t *queue)
+{
+    trace_write(task, TRACE_ID_QUEUE_TASK_WAKE, 0u, TRACE_OBJ(queue),
+                TRACE_OBJ(task_waked_up));
 }
 
 #endif
@@ -21,6 +21,7 @@ extern "C" {
 #include <k_sys.h>
 #include <k_bitmap.h>
 #include <k_list.h>
+#include <k_tick_wheel.h>
 #include <k_obj.h>
 #include <k_sched.h>
 #include <k_task.h>
@@ -38,6 +39,8 @@ extern "C" {
 #include <k_mm_blk.h>
 #include <k_mm_region.h>
 #include <k_mm.h>
+#include <k_mm_slab.h>
+#include <k_mm_prof.h>
 #include <k_workqueue.h>
 #include <k_internal.h>
 #include <k_trace.h>
@@ -89,6 +89,21 @@ kstat_t krhino_buf_queue_dyn_del(kbuf_queue_t *queue);
  */
 kstat_t krhino_buf_queue_send(kbuf_queue_t *queue, void *msg, size_t size);
 
+/**
+ * This function will send msgs stored back to back under one critical
+ * section, blocked receivers get one msg each and are woken with a single
+ * reschedule
+ * @param[in]   queue  pointer to the queue
+ * @param[in]   msg    pointer to the msgs
+ * @param[in]   size   size of each msg, may be NULL for fix buf queues
+ * @param[in]   num    number of msgs
+ * @param[out]  sent   number of msgs sent
+ * @return  the operation status, RHINO_SUCCESS if all are sent, others is the
+ *          error that stopped the batch
+ */
+kstat_t krhino_buf_queue_send_batch(kbuf_queue_t *queue, void *msg,
+                                    const size_t *size, size_t num, size_t *sent);
+
 
 /**
  * This function will receive msg form aqueue
@@ -101,6 +116,22 @@ kstat_t krhino_buf_queue_send(kbuf_queue_t *queue, void *msg, size_t size);
 kstat_t krhino_buf_queue_recv(kbuf_queue_t *queue, tick_t ticks, void *msg,
                               size_t *size);
 
+/**
+ * This function will receive up to num msgs back to back into msg, blocking
+ * only until the first one arrives
+ * @param[in]   queue     pointer to the queue
+ * @param[in]   ticks     ticks to wait before the first msg
+ * @param[out]  msg       pointer to the buf to save msgs
+ * @param[in]   buf_size  size of the buf, at least max_msg_size
+ * @param[out]  size      size of each received msg
+ * @param[in]   num       max number of msgs
+ * @param[out]  recved    number of msgs received
+ * @return  the operation status, RHINO_SUCCESS is OK, others is error
+ */
+kstat_t krhino_buf_queue_recv_batch(kbuf_queue_t *queue, tick_t ticks, void *msg,
+                                    size_t buf_size, size_t *size, size_t num,
+                                    size_t *recved);
+
 /**
  * This function will reset queue
  * @param[in]  queue  pointer to the queue
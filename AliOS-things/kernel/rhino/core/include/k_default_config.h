@@ -47,6 +47,14 @@
 #define RHINO_CONFIG_WORKQUEUE_TASK_PRIO     20
 #endif
 
+#ifndef RHINO_CONFIG_WORKQUEUE_WORKER_MAX
+#define RHINO_CONFIG_WORKQUEUE_WORKER_MAX    1
+#endif
+
+#ifndef RHINO_CONFIG_WORKQUEUE_STATS
+#define RHINO_CONFIG_WORKQUEUE_STATS         0
+#endif
+
 #ifndef RHINO_CONFIG_EVENT_FLAG
 #define RHINO_CONFIG_EVENT_FLAG              0
 #endif
@@ -75,6 +83,13 @@
 #define RHINO_CONFIG_MM_TLF_BLK_SIZE         8192
 #endif
 
+/* log2 of the second level freelists per power of 2 class of k_mm, each
+   costs k_mm_head MM_BIT_LEVEL pointers, 0 keeps one freelist per class.
+   At most 4, a heap needs sizeof(k_mm_head) on top of its minimum size */
+#ifndef RHINO_CONFIG_MM_SL_BITS
+#define RHINO_CONFIG_MM_SL_BITS              0
+#endif
+
 #ifndef RHINO_CONFIG_MM_DEBUG
 #define RHINO_CONFIG_MM_DEBUG                0
 #endif
@@ -87,10 +102,60 @@
 #define RHINO_CONFIG_MM_LEAKCHECK            0
 #endif
 
+/* sampling heap profiler, counts live and peak bytes per call site */
+#ifndef RHINO_CONFIG_MM_PROF
+#define RHINO_CONFIG_MM_PROF                 0
+#endif
+
+/* mean bytes allocated between two samples */
+#ifndef RHINO_CONFIG_MM_PROF_RATE
+#define RHINO_CONFIG_MM_PROF_RATE            4096
+#endif
+
+#ifndef RHINO_CONFIG_MM_PROF_SITES
+#define RHINO_CONFIG_MM_PROF_SITES           64
+#endif
+
+/* sampled blks tracked at once */
+#ifndef RHINO_CONFIG_MM_PROF_LIVE
+#define RHINO_CONFIG_MM_PROF_LIVE            128
+#endif
+
 #ifndef K_MM_STATISTIC
 #define K_MM_STATISTIC                       0
 #endif
 
+/* per-cpu magazine caches in front of the small levels of k_mm */
+#ifndef RHINO_CONFIG_MM_MAGAZINE
+#define RHINO_CONFIG_MM_MAGAZINE             0
+#endif
+
+#ifndef RHINO_CONFIG_MM_MAGAZINE_SIZE
+#define RHINO_CONFIG_MM_MAGAZINE_SIZE        8
+#endif
+
+#ifndef RHINO_CONFIG_MM_MAGAZINE_LEVELS
+#define RHINO_CONFIG_MM_MAGAZINE_LEVELS      4
+#endif
+
+#ifndef RHINO_CONFIG_MM_MAGAZINE_TRIM_TICKS
+#define RHINO_CONFIG_MM_MAGAZINE_TRIM_TICKS  RHINO_CONFIG_TICKS_PER_SECOND
+#endif
+
+/* slab caches on mblk pools for 16 ~ 512 bytes and the dyn kernel objects */
+#ifndef RHINO_CONFIG_MM_SLAB
+#define RHINO_CONFIG_MM_SLAB                 0
+#endif
+
+#ifndef RHINO_CONFIG_MM_SLAB_PAGE_SIZE
+#define RHINO_CONFIG_MM_SLAB_PAGE_SIZE       2048
+#endif
+
+/* empty pages a cache keeps before giving them back to the heap */
+#ifndef RHINO_CONFIG_MM_SLAB_EMPTY_PAGES
+#define RHINO_CONFIG_MM_SLAB_EMPTY_PAGES     1
+#endif
+
 #ifndef RHINO_CONFIG_TASK_SEM
 #define RHINO_CONFIG_TASK_SEM                0
 #endif
@@ -140,6 +205,10 @@
 #define RHINO_CONFIG_RINGBUF_VENDOR          0
 #endif
 
+#ifndef RHINO_CONFIG_RINGBUF_LOCKFREE
+#define RHINO_CONFIG_RINGBUF_LOCKFREE        0
+#endif
+
 /* kernel mm_region conf */
 #ifndef RHINO_CONFIG_MM_REGION_MUTEX
 #define RHINO_CONFIG_MM_REGION_MUTEX         1
@@ -154,6 +223,22 @@
 #define RHINO_CONFIG_TICKS_PER_SECOND        100
 #endif
 
+#ifndef RHINO_CONFIG_TICK_WHEEL
+#define RHINO_CONFIG_TICK_WHEEL              0
+#endif
+
+#ifndef RHINO_CONFIG_TICK_WHEEL_LEVEL
+#define RHINO_CONFIG_TICK_WHEEL_LEVEL        4
+#endif
+
+#ifndef RHINO_CONFIG_TICKLESS
+#define RHINO_CONFIG_TICKLESS                0
+#endif
+
+#ifndef RHINO_CONFIG_TICKLESS_MIN_TICKS
+#define RHINO_CONFIG_TICKLESS_MIN_TICKS      2
+#endif
+
 #ifndef RHINO_CONFIG_TIMER_TASK_STACK_SIZE
 #define RHINO_CONFIG_TIMER_TASK_STACK_SIZE   200
 #endif
@@ -257,6 +342,24 @@
 #define RHINO_CONFIG_TRACE                   0
 #endif
 
+/* records per cpu ring, power of 2 */
+#ifndef RHINO_CONFIG_TRACE_RING_SIZE
+#define RHINO_CONFIG_TRACE_RING_SIZE         256
+#endif
+
+#ifndef RHINO_CONFIG_TRACE_TASK_PRI
+#define RHINO_CONFIG_TRACE_TASK_PRI          (RHINO_CONFIG_PRI_MAX - 3)
+#endif
+
+#ifndef RHINO_CONFIG_TRACE_TASK_STACK
+#define RHINO_CONFIG_TRACE_TASK_STACK        256
+#endif
+
+/* the drain task hands the rings to the sink every that many ticks */
+#ifndef RHINO_CONFIG_TRACE_DRAIN_TICKS
+#define RHINO_CONFIG_TRACE_DRAIN_TICKS       10
+#endif
+
 #ifndef RHINO_CONFIG_CPU_NUM
 #define RHINO_CONFIG_CPU_NUM                 1
 #endif
@@ -269,10 +372,45 @@
 #error  "RHINO_CONFIG_MM_BLK should be 1 when RHINO_CONFIG_MM_TLF is enabled."
 #endif
 
+#if (RHINO_CONFIG_MM_SL_BITS > 4)
+#error  "RHINO_CONFIG_MM_SL_BITS must be <= 4."
+#endif
+
+#if ((RHINO_CONFIG_MM_PROF >= 1) && ((RHINO_CONFIG_MM_TLF == 0) || (RHINO_CONFIG_GCC_RETADDR == 0)))
+#error  "RHINO_CONFIG_MM_TLF and RHINO_CONFIG_GCC_RETADDR should be 1 when RHINO_CONFIG_MM_PROF is enabled."
+#endif
+
+#if ((RHINO_CONFIG_MM_PROF >= 1) && \
+     (((RHINO_CONFIG_MM_PROF_SITES & (RHINO_CONFIG_MM_PROF_SITES - 1)) != 0) || \
+      ((RHINO_CONFIG_MM_PROF_LIVE & (RHINO_CONFIG_MM_PROF_LIVE - 1)) != 0)))
+#error  "RHINO_CONFIG_MM_PROF_SITES and RHINO_CONFIG_MM_PROF_LIVE must be powers of 2."
+#endif
+
+#if ((RHINO_CONFIG_MM_MAGAZINE >= 1) && (RHINO_CONFIG_MM_TLF == 0))
+#error  "RHINO_CONFIG_MM_TLF should be 1 when RHINO_CONFIG_MM_MAGAZINE is enabled."
+#endif
+
+#if ((RHINO_CONFIG_MM_MAGAZINE >= 1) && (RHINO_CONFIG_MM_MAGAZINE_SIZE < 2))
+#error  "RHINO_CONFIG_MM_MAGAZINE_SIZE must be >= 2."
+#endif
+
+#if ((RHINO_CONFIG_MM_SLAB >= 1) && (RHINO_CONFIG_MM_TLF == 0))
+#error  "RHINO_CONFIG_MM_TLF should be 1 when RHINO_CONFIG_MM_SLAB is enabled."
+#endif
+
+#if ((RHINO_CONFIG_MM_SLAB >= 1) && ((RHINO_CONFIG_MM_SLAB_PAGE_SIZE < 2048) || \
+     ((RHINO_CONFIG_MM_SLAB_PAGE_SIZE & (RHINO_CONFIG_MM_SLAB_PAGE_SIZE - 1)) != 0)))
+#error  "RHINO_CONFIG_MM_SLAB_PAGE_SIZE must be a power of 2 and >= 2048."
+#endif
+
 #if ((RHINO_CONFIG_KOBJ_DYN_ALLOC >= 1) && (RHINO_CONFIG_MM_TLF == 0))
 #error  "RHINO_CONFIG_MM_TLF should be 1 when RHINO_CONFIG_KOBJ_DYN_ALLOC is enabled."
 #endif
 
+#if ((RHINO_CONFIG_TICKLESS >= 1) && (RHINO_CONFIG_CPU_NUM > 1))
+#error  "RHINO_CONFIG_TICKLESS only supports RHINO_CONFIG_CPU_NUM 1."
+#endif
+
 #if (RHINO_CONFIG_PRI_MAX >= 256)
 #error  "RHINO_CONFIG_PRI_MAX must be <= 255."
 #endif
@@ -293,5 +431,23 @@
 #error  "you need enable RHINO_CONFIG_HW_COUNT as well."
 #endif
 
+#if ((RHINO_CONFIG_HW_COUNT == 0) && (RHINO_CONFIG_WORKQUEUE_STATS >= 1))
+#error  "you need enable RHINO_CONFIG_HW_COUNT as well."
+#endif
+
+#if ((RHINO_CONFIG_WORKQUEUE >= 1) && ((RHINO_CONFIG_WORKQUEUE_WORKER_MAX == 0) || \
+     (RHINO_CONFIG_WORKQUEUE_WORKER_MAX >= 256)))
+#error  "RHINO_CONFIG_WORKQUEUE_WORKER_MAX must be 1 ~ 255."
+#endif
+
+#if ((RHINO_CONFIG_HW_COUNT == 0) && (RHINO_CONFIG_TRACE >= 1))
+#error  "you need enable RHINO_CONFIG_HW_COUNT as well."
+#endif
+
+#if ((RHINO_CONFIG_TRACE >= 1) && ((RHINO_CONFIG_TRACE_RING_SIZE < 16) || \
+     ((RHINO_CONFIG_TRACE_RING_SIZE & (RHINO_CONFIG_TRACE_RING_SIZE - 1)) != 0)))
+#error  "RHINO_CONFIG_TRACE_RING_SIZE must be a power of 2, >= 16."
+#endif
+
 #endif /* K_DEFAULT_CONFIG_H */
 
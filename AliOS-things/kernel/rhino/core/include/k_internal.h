@@ -8,7 +8,11 @@
 extern kstat_t g_sys_stat;
 extern uint8_t g_idle_task_spawned[RHINO_CONFIG_CPU_NUM];
 
+#if (RHINO_CONFIG_CPU_NUM > 1)
+extern runqueue_t g_ready_queue[RHINO_CONFIG_CPU_NUM];
+#else
 extern runqueue_t g_ready_queue;
+#endif
 
 /* System lock */
 extern uint8_t g_sched_lock[RHINO_CONFIG_CPU_NUM];
@@ -27,14 +31,22 @@ extern cpu_stack_t  g_idle_task_stack[RHINO_CONFIG_CPU_NUM][RHINO_CONFIG_IDLE_TA
 
 /* tick attribute */
 extern tick_t     g_tick_count;
+#if (RHINO_CONFIG_TICK_WHEEL > 0)
+extern k_tick_wheel_t g_tick_wheel;
+#else
 extern klist_t    g_tick_head;
+#endif
 
 #if (RHINO_CONFIG_SYSTEM_STATS > 0)
 extern kobj_list_t g_kobj_list;
 #endif
 
 #if (RHINO_CONFIG_TIMER > 0)
+#if (RHINO_CONFIG_TICK_WHEEL > 0)
+extern k_tick_wheel_t   g_timer_wheel;
+#else
 extern klist_t          g_timer_head;
+#endif
 extern sys_time_t       g_timer_count;
 extern ktask_t          g_timer_task;
 extern cpu_stack_t      g_timer_task_stack[RHINO_CONFIG_TIMER_TASK_STACK_SIZE];
@@ -88,6 +100,20 @@ extern cpu_stack_t   g_workqueue_stack[RHINO_CONFIG_WORKQUEUE_STACK_SIZE];
 extern k_mm_head    *g_kmm_head;
 #endif
 
+#if (RHINO_CONFIG_MM_SLAB > 0 && RHINO_CONFIG_KOBJ_DYN_ALLOC > 0)
+extern k_slab_cache_t g_slab_task;
+extern k_slab_cache_t g_slab_sem;
+extern k_slab_cache_t g_slab_mutex;
+extern k_slab_cache_t g_slab_timer;
+
+/* objects of the *_dyn_create() paths come from their slab cache */
+#define KOBJ_DYN_ALLOC(cache, type) krhino_slab_cache_alloc(&(cache))
+#define KOBJ_DYN_FREE(obj)          krhino_slab_free(obj)
+#else
+#define KOBJ_DYN_ALLOC(cache, type) krhino_mm_alloc(sizeof(type))
+#define KOBJ_DYN_FREE(obj)          krhino_mm_free(obj)
+#endif
+
 #define K_OBJ_STATIC_ALLOC 1u
 #define K_OBJ_DYN_ALLOC    2u
 
@@ -111,9 +137,27 @@ extern k_mm_head    *g_kmm_head;
 typedef struct {
     uint8_t cnt;
     void   *res[RES_FREE_NUM];
+    void   *task;     /* freed after res[] by KOBJ_DYN_FREE() */
     klist_t res_list;
 } res_free_t;
 
+/* the run queue of a cpu */
+RHINO_INLINE runqueue_t *cpu_rq(uint8_t cpu_num)
+{
+#if (RHINO_CONFIG_CPU_NUM > 1)
+    return &g_ready_queue[cpu_num];
+#else
+    (void)cpu_num;
+    return &g_ready_queue;
+#endif
+}
+
+/* the run queue a ready task sits on */
+RHINO_INLINE runqueue_t *task_rq(ktask_t *task)
+{
+    return cpu_rq(task->cpu_num);
+}
+
 void preferred_cpu_ready_task_get(runqueue_t *rq, uint8_t cpu_num);
 
 void core_sched(void);
@@ -145,6 +189,19 @@ void tick_list_rm(ktask_t *task);
 void tick_list_insert(ktask_t *task, tick_t time);
 void tick_list_update(tick_i_t ticks);
 
+#if (RHINO_CONFIG_TICKLESS > 0)
+uint8_t tick_list_next(tick_t *match);
+#endif
+
+#if (RHINO_CONFIG_TICK_WHEEL > 0) || (RHINO_CONFIG_WORKQUEUE > 0)
+void     tick_wheel_init(k_tick_wheel_t *wheel, size_t node_off,
+                         size_t match_off, tick_t now);
+klist_t *tick_wheel_insert(k_tick_wheel_t *wheel, klist_t *node, tick_t match);
+void     tick_wheel_rm(k_tick_wheel_t *wheel, klist_t *node);
+void     tick_wheel_advance(k_tick_wheel_t *wheel, tick_t now, klist_t *expired);
+uint8_t  tick_wheel_next(k_tick_wheel_t *wheel, tick_t *match);
+#endif
+
 uint8_t mutex_pri_limit(ktask_t *tcb, uint8_t pri);
 void    mutex_task_pri_reset(ktask_t *tcb);
 uint8_t mutex_pri_look(ktask_t *tcb, kmutex_t *mutex_rel);
@@ -168,13 +225,45 @@ kstat_t ringbuf_head_push(k_ringbuf_t *p_ringbuf, void *data, size_t len);
 kstat_t ringbuf_pop(k_ringbuf_t *p_ringbuf, void *pdata, size_t *plen);
 uint8_t ringbuf_is_full(k_ringbuf_t *p_ringbuf);
 uint8_t ringbuf_is_empty(k_ringbuf_t *p_ringbuf);
+size_t  ringbuf_headlen_compress(size_t head_len, uint8_t *cmp_buf);
+size_t  ringbuf_headlen_decompress(size_t buf_len, uint8_t *cmp_buf);
 void    workqueue_init(void);
 void    k_mm_init(void);
 
+#if (RHINO_CONFIG_MM_SLAB > 0)
+void    k_mm_slab_init(void);
+#endif
+
+#if (RHINO_CONFIG_MM_PROF > 0)
+/* count size against the sampling interval, sample ptr when it is due */
+void    k_mm_prof_alloc(void *ptr, size_t size, size_t site);
+/* drop a RHINO_MM_SAMPLED blk from the live counters */
+void    k_mm_prof_free(void *ptr);
+#endif
+
+#if (RHINO_CONFIG_MM_MAGAZINE > 0)
+/* flush the magazines of the current cpu left unused since the last call, never pends */
+void    k_mm_magazine_idle_trim(void);
+#endif
+
+#if (RHINO_CONFIG_CPU_NUM > 1)
+/* raise the reschedule ipi on cpu_num, its handler only runs krhino_intrpt_enter()/exit() */
+void cpu_signal(uint8_t cpu_num);
+#endif
+
 #if (RHINO_CONFIG_CPU_PWR_MGMT > 0)
 void cpu_pwr_down(void);
 void cpu_pwr_up(void);
 #endif
 
+#if (RHINO_CONFIG_TICKLESS > 0)
+/* stop the periodic tick and arm a one-shot after ticks, RHINO_WAIT_FOREVER means nothing is due */
+void   cpu_tick_suspend(tick_t ticks);
+/* wait for any interrupt, entered and left with interrupts disabled */
+void   cpu_idle_wait(void);
+/* restart the periodic tick in phase, return the whole ticks slept */
+tick_t cpu_tick_resume(void);
+#endif
+
 #endif /* K_INTERNAL_H */
 
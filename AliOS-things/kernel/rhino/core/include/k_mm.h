@@ -26,6 +26,9 @@
 #define MM_MIN_SIZE         (1<<(MM_MIN_BIT - 1))
 #define MM_BIT_LEVEL        (MM_MAX_BIT - MM_MIN_BIT + 2)
 
+/* second level freelists of one first level class */
+#define MM_SL_NUM           (1 << RHINO_CONFIG_MM_SL_BITS)
+
 
 #define MIN_FREE_MEMORY_SIZE    1024 /*at least need 1k for user alloced*/
 
@@ -41,6 +44,9 @@
 #define RHINO_MM_PREVFREE       2
 #define RHINO_MM_PREVALLOCED    0
 
+/*bit 2, alloced blk sampled by the heap profiler*/
+#define RHINO_MM_SAMPLED        4
+
 #define MMLIST_HEAD_SIZE        (MM_ALIGN_UP(sizeof(k_mm_list_t) -  sizeof(free_ptr_t)))
 
 /* get buffer size */
@@ -55,6 +61,10 @@
 /* get this blk */
 #define MM_GET_THIS_BLK(buf)    \
     ((k_mm_list_t *)((char *)(buf) - MMLIST_HEAD_SIZE))
+/* buf from the fixed size blk pool */
+#define MM_IS_FIXEDBLK(mh,ptr) \
+        (mh->fixedmblk && ((void *)ptr > (void *)(mh->fixedmblk->mbinfo.buffer))            \
+        && ((void *)ptr < (void *)(mh->fixedmblk->mbinfo.buffer + mh->fixedmblk->buf_size)))
 
 /*struct of memory list ,every memory block include this information*/
 typedef struct free_ptr_struct {
@@ -82,6 +92,27 @@ typedef struct k_mm_region_info_struct {
     struct k_mm_region_info_struct *next;
 } k_mm_region_info_t;
 
+#if (RHINO_CONFIG_MM_MAGAZINE > 0)
+#if (RHINO_CONFIG_MM_MAGAZINE_LEVELS > MM_BIT_LEVEL)
+#error  "RHINO_CONFIG_MM_MAGAZINE_LEVELS must be <= MM_BIT_LEVEL."
+#endif
+
+/* largest buffer size of the blocks cached for level N, a block is cached
+   at the size it was cut at and serves requests up to that size */
+#define MM_MAG_BUF_SIZE(level)  ((1 << ((level) + MM_MIN_BIT)) - MM_ALIGN_SIZE)
+
+/* LIFO stack of allocated blocks of one level, owned by one cpu */
+typedef struct {
+    void               *blk[RHINO_CONFIG_MM_MAGAZINE_SIZE];
+    uint32_t            cnt;
+    uint32_t            active;   /* used since the last idle trim */
+#if (K_MM_STATISTIC > 0)
+    size_t              hit;
+    size_t              miss;
+#endif
+} k_mm_mag_t;
+#endif
+
 
 typedef struct {
 #if (RHINO_CONFIG_MM_REGION_MUTEX == 1)
@@ -96,13 +127,24 @@ typedef struct {
     size_t              free_size;
     size_t              mm_size_stats[MM_BIT_LEVEL];
 #endif
-    /* msb (MM_BIT_LEVEL-1) <-> lsb 0, one bit match one freelist */
+    /* msb (MM_BIT_LEVEL-1) <-> lsb 0, one bit match one first level class */
     uint32_t            free_bitmap;
-    /* freelist[N]: contain free blks at level N, 
-       2^(N + MM_MIN_BIT) <= level N buffer size < 2^(1 + N + MM_MIN_BIT) */
+#if (RHINO_CONFIG_MM_SL_BITS > 0)
+    /* sl_bitmap[N]: one bit match one freelist of level N */
+    uint32_t            sl_bitmap[MM_BIT_LEVEL];
+#endif
+    /* freelist[N][M]: contain free blks at level N, 
+       2^(N + MM_MIN_BIT) <= level N buffer size < 2^(1 + N + MM_MIN_BIT),
+       level N is split into MM_SL_NUM equal ranges, M is the range */
        /* ÿһԪָk_mm_list_tڴռͬ*/
        /* һ˫ */
-    k_mm_list_t        *freelist[MM_BIT_LEVEL]; /* 64 ~ 128, 128 ~ 256, ..., 64M~128M */
+    k_mm_list_t        *freelist[MM_BIT_LEVEL][MM_SL_NUM]; /* 64 ~ 128, 128 ~ 256, ..., 64M~128M */
+
+#if (RHINO_CONFIG_MM_MAGAZINE > 0)
+    /* blocks in a magazine stay allocated to the heap, used_size counts them */
+    k_mm_mag_t          mag[RHINO_CONFIG_CPU_NUM][RHINO_CONFIG_MM_MAGAZINE_LEVELS];
+    tick_t              mag_trim_tick[RHINO_CONFIG_CPU_NUM];
+#endif
 } k_mm_head;
 
 
@@ -115,6 +157,8 @@ kstat_t krhino_add_mm_region(k_mm_head *mmhead, void *addr, size_t len);
 void *k_mm_alloc(k_mm_head *mmhead, size_t size);
 void  k_mm_free(k_mm_head       *mmhead, void *ptr);
 void *k_mm_realloc(k_mm_head *mmhead, void *oldmem, size_t new_size);
+/* align must be a power of 2, the buffer is freed by k_mm_free() */
+void *k_mm_alloc_aligned(k_mm_head *mmhead, size_t size, size_t align);
 #endif
 
 /**
@@ -140,6 +184,14 @@ void krhino_mm_free(void *ptr);
  */
 void *krhino_mm_realloc(void *oldmem, size_t newsize);
 
+#if (RHINO_CONFIG_MM_MAGAZINE > 0)
+/**
+ * This function will give the blocks cached by the magazines of the
+ * current cpu back to the heap
+ */
+void krhino_mm_magazine_trim(void);
+#endif
+
 
 
 #endif /* K_MM_BESTFIT_H */
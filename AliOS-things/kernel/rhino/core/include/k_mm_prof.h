@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2015-2017 Alibaba Group Holding Limited
+ */
+
+#ifndef K_MM_PROF_H
+#define K_MM_PROF_H
+
+#if (RHINO_CONFIG_MM_PROF > 0)
+/* counters of one call site and task, in sampled blks and their request sizes */
+typedef struct {
+    size_t        site;       /* return address of the allocation */
+    const name_t *task;       /* name of the allocating task, NULL if none */
+    size_t        live_cnt;   /* sampled blks not freed yet */
+    size_t        live_size;
+    size_t        peak_size;  /* highest live_size */
+    size_t        alloc_cnt;  /* sampled blks since start or reset */
+    size_t        alloc_size;
+} k_mm_prof_site_t;
+
+/**
+ * This function will start sampling krhino_mm_alloc(), one blk per rate
+ * bytes allocated on average
+ * @param[in]  rate  mean bytes between two samples, 0 for RHINO_CONFIG_MM_PROF_RATE
+ * @return  the operation status, RHINO_SUCCESS is OK
+ */
+kstat_t krhino_mm_prof_start(size_t rate);
+
+/**
+ * This function will stop sampling, the sampled blks still count till freed
+ * @return  the operation status, RHINO_SUCCESS is OK
+ */
+kstat_t krhino_mm_prof_stop(void);
+
+/**
+ * This function will clear the alloc counters, the peaks restart from the
+ * live sizes
+ * @return  the operation status, RHINO_SUCCESS is OK
+ */
+kstat_t krhino_mm_prof_reset(void);
+
+/**
+ * This function will charge a sampled blk to another call site, for the
+ * wrappers of krhino_mm_alloc() to name their caller
+ * @param[in]  ptr   blk from krhino_mm_alloc() or krhino_mm_realloc()
+ * @param[in]  site  return address of the caller
+ */
+void krhino_mm_prof_site_set(void *ptr, size_t site);
+
+/**
+ * This function will copy the counters of the call sites seen so far
+ * @param[in]   sites  buffer for the counters
+ * @param[in]   num    entries of the buffer
+ * @param[out]  rate   the sampling rate, 0 if stopped, may be NULL
+ * @return  entries copied
+ */
+uint32_t krhino_mm_prof_sites_get(k_mm_prof_site_t *sites, uint32_t num, size_t *rate);
+
+/**
+ * This function will estimate the bytes allocated from sampled counters
+ * @param[in]  cnt   sampled blks
+ * @param[in]  size  their request sizes
+ * @param[in]  rate  the sampling rate
+ * @return  estimated bytes
+ */
+size_t krhino_mm_prof_unsample(size_t cnt, size_t size, size_t rate);
+
+/**
+ * This function will print a pprof legacy heap profile (heap_v2) of the
+ * sampled counters, "go tool pprof <elf> <file>" reads it
+ * @param[in]  buf  output buffer, may be NULL if len is 0
+ * @param[in]  len  size of buf
+ * @return  length of the whole profile, truncated in buf if not smaller than len
+ */
+size_t krhino_mm_prof_pprof(char *buf, size_t len);
+#endif
+
+#endif /* K_MM_PROF_H */
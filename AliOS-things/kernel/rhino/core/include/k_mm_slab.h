@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2015-2017 Alibaba Group Holding Limited
+ */
+
+#ifndef K_MM_SLAB_H
+#define K_MM_SLAB_H
+
+#if (RHINO_CONFIG_MM_SLAB > 0)
+/* size classes of krhino_slab_alloc(): 2^SLAB_MIN_BIT ~ 2^SLAB_MAX_BIT bytes */
+#define SLAB_MIN_BIT        4
+#define SLAB_MAX_BIT        9
+#define SLAB_CLASS_NUM      (SLAB_MAX_BIT - SLAB_MIN_BIT + 1)
+
+/* a page is a RHINO_CONFIG_MM_SLAB_PAGE_SIZE aligned buffer from g_kmm_head */
+#define SLAB_PAGE_MASK      ((size_t)RHINO_CONFIG_MM_SLAB_PAGE_SIZE - 1u)
+#define SLAB_PAGE_HEAD_SIZE MM_ALIGN_UP(sizeof(k_slab_page_t))
+
+typedef void (*slab_ctor_t)(void *obj);
+
+typedef struct {
+    const name_t *name;
+    size_t        obj_size;
+    slab_ctor_t   ctor;         /* run on each object handed out, may be NULL */
+    klist_t       partial_list; /* pages with free objects */
+    klist_t       full_list;    /* pages without */
+    size_t        page_num;
+    size_t        page_empty;   /* pages with no object in use */
+    size_t        obj_inuse;
+} k_slab_cache_t;
+
+/* head of each page, the rest of the page is carved by the mblk pool */
+typedef struct {
+    mblk_pool_t     pool;
+    klist_t         page_list;
+    k_slab_cache_t *cache;
+} k_slab_page_t;
+
+/**
+ * This function will init a slab cache of one object size
+ * @param[in]  cache     pointer to the cache
+ * @param[in]  name      name of the cache
+ * @param[in]  obj_size  size of the objects
+ * @param[in]  ctor      constructor run on each object handed out, may be NULL
+ * @return  the operation status, RHINO_SUCCESS is OK, others is error
+ */
+kstat_t krhino_slab_cache_init(k_slab_cache_t *cache, const name_t *name,
+                               size_t obj_size, slab_ctor_t ctor);
+
+/**
+ * This function will give back the pages of an unused slab cache
+ * @param[in]  cache  pointer to the cache
+ * @return  the operation status, RHINO_SUCCESS is OK, RHINO_KOBJ_DEL_ERR if objects are in use
+ */
+kstat_t krhino_slab_cache_del(k_slab_cache_t *cache);
+
+/**
+ * This function will alloc an object from a slab cache
+ * @param[in]  cache  pointer to the cache
+ * @return  the object, NULL if no memory
+ */
+void *krhino_slab_cache_alloc(k_slab_cache_t *cache);
+
+/**
+ * This function will alloc from the size class fitting size
+ * @param[in]  size  size of the mem, 1 ~ 2^SLAB_MAX_BIT
+ * @return  the mem, NULL if no memory or size is out of the classes
+ */
+void *krhino_slab_alloc(size_t size);
+
+/**
+ * This function will free an object to its slab cache, a page left empty
+ * goes back to the heap once the cache keeps RHINO_CONFIG_MM_SLAB_EMPTY_PAGES
+ * empty pages
+ * @param[in]  obj  object from krhino_slab_cache_alloc() or krhino_slab_alloc()
+ * @return  the operation status, RHINO_SUCCESS is OK, others is error
+ */
+kstat_t krhino_slab_free(void *obj);
+#endif
+
+#endif /* K_MM_SLAB_H */
+
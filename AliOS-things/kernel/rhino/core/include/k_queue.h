@@ -83,6 +83,19 @@ kstat_t krhino_queue_back_send(kqueue_t *queue, void *msg);
  */
 kstat_t krhino_queue_all_send(kqueue_t *queue, void *msg);
 
+/**
+ * This function will send msgs to the end of a queue under one critical
+ * section, blocked receivers get one msg each and are woken with a single
+ * reschedule
+ * @param[in]   queue  pointer to the queue
+ * @param[in]   msg    array of msgs to send
+ * @param[in]   num    number of msgs
+ * @param[out]  sent   number of msgs sent
+ * @return  the operation status, RHINO_SUCCESS if all are sent, RHINO_QUEUE_FULL if part
+ */
+kstat_t krhino_queue_back_send_batch(kqueue_t *queue, void **msg, size_t num,
+                                     size_t *sent);
+
 /**
  * This function will receive msg from a queue
  * @param[in]   queue  pointer to the queue
@@ -92,6 +105,19 @@ kstat_t krhino_queue_all_send(kqueue_t *queue, void *msg);
  */
 kstat_t krhino_queue_recv(kqueue_t *queue, tick_t ticks, void **msg);
 
+/**
+ * This function will receive up to num msgs from a queue, blocking only
+ * until the first one arrives
+ * @param[in]   queue   pointer to the queue
+ * @param[in]   ticks   ticks to wait before the first msg
+ * @param[out]  msg     array to save msgs
+ * @param[in]   num     size of the array
+ * @param[out]  recved  number of msgs received
+ * @return  the operation status, RHINO_SUCCESS is OK, others is error
+ */
+kstat_t krhino_queue_recv_batch(kqueue_t *queue, tick_t ticks, void **msg,
+                                size_t num, size_t *recved);
+
 /**
  * This function will detect a queue full or not
  * @param[in]  queue  pointer to the queue
@@ -10,10 +10,22 @@
 #define SCHED_MAX_LOCK_COUNT  200u
 #define NUM_WORDS             ((RHINO_CONFIG_PRI_MAX + 31) / 32)
 
+#if (RHINO_CONFIG_CPU_NUM > 1)
+typedef struct {
+    uint32_t ready_num;   /* ready tasks on the queue, the running one included */
+    uint32_t migrate_cnt; /* tasks moved onto this cpu from another one */
+    uint32_t steal_cnt;   /* tasks this cpu pulled from a busier queue */
+    uint32_t ipi_cnt;     /* reschedule ipis received by this cpu */
+} ksched_stats_t;
+#endif
+
 typedef struct {
     klist_t *cur_list_item[RHINO_CONFIG_PRI_MAX];
     uint32_t task_bit_map[NUM_WORDS];
     uint8_t  highest_pri;
+#if (RHINO_CONFIG_CPU_NUM > 1)
+    ksched_stats_t stats;
+#endif
 } runqueue_t;
 
 /**
@@ -28,5 +40,15 @@ kstat_t krhino_sched_disable(void);
  */
 kstat_t krhino_sched_enable(void);
 
+#if (RHINO_CONFIG_CPU_NUM > 1)
+/**
+ * This function will get the run queue statistics of a cpu
+ * @param[in]   cpu_num  the cpu to be queried
+ * @param[out]  stats    the statistics of its run queue
+ * @return  the operation status, RHINO_SUCCESS is OK, others is error
+ */
+kstat_t krhino_sched_stats_get(uint8_t cpu_num, ksched_stats_t *stats);
+#endif
+
 #endif /* K_SCHED_H */
 
@@ -0,0 +1,33 @@
+/*
+ * Copyright (C) 2015-2017 Alibaba Group Holding Limited
+ */
+
+#ifndef K_TICK_WHEEL_H
+#define K_TICK_WHEEL_H
+
+#if (RHINO_CONFIG_TICK_WHEEL > 0) || (RHINO_CONFIG_WORKQUEUE > 0)
+
+#define TICK_WHEEL_SLOT_BITS  5u
+#define TICK_WHEEL_SLOT_NUM   (1u << TICK_WHEEL_SLOT_BITS)
+#define TICK_WHEEL_SLOT_MASK  (TICK_WHEEL_SLOT_NUM - 1u)
+
+/* ticks covered by the wheel, longer waits are parked in the last slot and re-cascaded */
+#define TICK_WHEEL_SPAN       ((tick_t)1 << (TICK_WHEEL_SLOT_BITS * RHINO_CONFIG_TICK_WHEEL_LEVEL))
+
+/*
+ * Hierarchical timing wheel, level n slot covers 32^n ticks.
+ * Nodes are embedded klist_t, the expiry tick of a node is read back
+ * through match_off, so the wheel serves ktask_t, ktimer_t and kwork_t alike.
+ */
+typedef struct {
+    klist_t  slot[RHINO_CONFIG_TICK_WHEEL_LEVEL][TICK_WHEEL_SLOT_NUM];
+    uint32_t bitmap[RHINO_CONFIG_TICK_WHEEL_LEVEL];
+    tick_t   now;       /* every node whose match <= now has been expired */
+    size_t   node_off;  /* offset of the klist_t node in its container */
+    size_t   match_off; /* offset of the tick_t match in its container */
+} k_tick_wheel_t;
+
+#endif /* RHINO_CONFIG_TICK_WHEEL || RHINO_CONFIG_WORKQUEUE */
+
+#endif /* K_TICK_WHEEL_H */
+
@@ -7,6 +7,143 @@
 
 
 #if (RHINO_CONFIG_TRACE > 0)
+/*
+ * Every hook writes one fixed size record into the ring of the current cpu,
+ * with local interrupts off, so each ring has a single producer. The drain
+ * task (or any caller of trace_drain()) copies the records out without
+ * stopping the producers. tools/trace_decode.py turns the stream into Chrome
+ * trace JSON.
+ *
+ * delta is the HR_COUNT_GET() distance to the previous record of the same
+ * cpu. A TRACE_ID_SYNC record carries the absolute count in obj (low word)
+ * and arg (high word); it starts each ring, comes back every quarter ring and
+ * whenever delta would overflow. obj/arg hold object addresses or values,
+ * pointer sized so a record takes 16 bytes on 32 bit cpus and 24 on 64 bit
+ * ones, the meaning per id is given below.
+ */
+typedef struct {
+    uint32_t  delta;
+    uint16_t  id;
+    uint8_t   cpu;
+    uint8_t   arg0;
+    uintptr_t obj;
+    uintptr_t arg;
+} k_trace_rec_t;
+
+/* meta records, never filtered: obj / arg / arg0 */
+#define TRACE_ID_SYNC                 0x001u /* count low / count high / - */
+#define TRACE_ID_LOST                 0x002u /* records lost / - / 1 if a SYNC is needed */
+#define TRACE_ID_NAME                 0x003u /* object / 4 chars / byte offset in the name */
+
+/* task: obj / arg / arg0 */
+#define TRACE_ID_INIT                 0x101u /* current task / - / - */
+#define TRACE_ID_TASK_SWITCH          0x102u /* from / to / state of from */
+#define TRACE_ID_TASK_CREATE          0x103u /* task / - / pri */
+#define TRACE_ID_INTRPT_TASK_SWITCH   0x104u /* from / to / state of from */
+#define TRACE_ID_TASK_PRI_CHANGE      0x105u /* task / - / new pri */
+#define TRACE_ID_TASK_SUSPEND         0x106u /* task / - / - */
+#define TRACE_ID_TASK_RESUME          0x107u /* task / - / - */
+#define TRACE_ID_TASK_DEL             0x108u /* task / - / - */
+#define TRACE_ID_TASK_ABORT           0x109u /* task / - / - */
+#define TRACE_ID_TASK_SLEEP           0x10au /* task / ticks / - */
+
+/* sem */
+#define TRACE_ID_SEM_CREATE           0x201u /* sem / count / - */
+#define TRACE_ID_SEM_OVERFLOW         0x202u /* sem / count / - */
+#define TRACE_ID_SEM_CNT_INCREASE     0x203u /* sem / count / - */
+#define TRACE_ID_SEM_GET_SUCCESS      0x204u /* sem / count / - */
+#define TRACE_ID_SEM_GET_BLK          0x205u /* sem / ticks / - */
+#define TRACE_ID_SEM_TASK_WAKE        0x206u /* sem / task woken / wake all */
+#define TRACE_ID_SEM_DEL              0x207u /* sem / - / - */
+
+/* mutex */
+#define TRACE_ID_MUTEX_CREATE         0x301u /* mutex / - / - */
+#define TRACE_ID_MUTEX_RELEASE        0x302u /* owner / - / restored pri */
+#define TRACE_ID_MUTEX_GET            0x303u /* mutex / ticks / - */
+#define TRACE_ID_TASK_PRI_INV         0x304u /* owner / - / owner pri */
+#define TRACE_ID_MUTEX_GET_BLK        0x305u /* mutex / ticks / - */
+#define TRACE_ID_MUTEX_RELEASE_SUCCESS 0x306u /* mutex / - / - */
+#define TRACE_ID_MUTEX_TASK_WAKE      0x307u /* mutex / task woken / - */
+#define TRACE_ID_MUTEX_DEL            0x308u /* mutex / - / - */
+
+/* event */
+#define TRACE_ID_EVENT_CREATE         0x401u /* event / flags / - */
+#define TRACE_ID_EVENT_GET            0x402u /* event / - / - */
+#define TRACE_ID_EVENT_GET_BLK        0x403u /* event / ticks / - */
+#define TRACE_ID_EVENT_TASK_WAKE      0x404u /* event / task woken / - */
+#define TRACE_ID_EVENT_DEL            0x405u /* event / - / - */
+
+/* buf_queue */
+#define TRACE_ID_BUF_QUEUE_CREATE     0x501u /* buf_queue / - / - */
+#define TRACE_ID_BUF_QUEUE_MAX        0x502u /* buf_queue / msg size / - */
+#define TRACE_ID_BUF_QUEUE_POST       0x503u /* buf_queue / msg size / - */
+#define TRACE_ID_BUF_QUEUE_TASK_WAKE  0x504u /* buf_queue / task woken / - */
+#define TRACE_ID_BUF_QUEUE_GET_BLK    0x505u /* buf_queue / ticks / - */
+
+/* timer, mblk, mm */
+#define TRACE_ID_TIMER_CREATE         0x601u /* timer / - / - */
+#define TRACE_ID_TIMER_DEL            0x602u /* timer / - / - */
+#define TRACE_ID_MBLK_POOL_CREATE     0x701u /* pool / blk size / - */
+#define TRACE_ID_MM_REGION_CREATE     0x901u /* regions / - / - */
+
+/* workqueue */
+#define TRACE_ID_WORK_INIT            0xa01u /* work / dly / - */
+#define TRACE_ID_WORKQUEUE_CREATE     0xa02u /* workqueue / - / worker num */
+#define TRACE_ID_WORKQUEUE_DEL        0xa03u /* workqueue / - / - */
+
+/* queue */
+#define TRACE_ID_QUEUE_CREATE         0xb01u /* queue / size / - */
+#define TRACE_ID_QUEUE_GET_BLK        0xb02u /* queue / ticks / - */
+#define TRACE_ID_QUEUE_TASK_WAKE      0xb03u /* queue / task woken / - */
+
+/* set_event_mask(): an id picks one event, an id with 0 low byte a type */
+#define TRACE_TYPE                    0xFFFFFF00u
+#define TRACE_EVENT                   0x000000FFu
+
+/* a full ring drops the oldest records (default) or the new ones */
+#define TRACE_MODE_OVERWRITE          0u
+#define TRACE_MODE_STOP               1u
+
+typedef void (*trace_sink_t)(const void *buf, size_t len);
+
+/**
+ * This function will pick what a full ring drops
+ * @param[in]  mode  TRACE_MODE_OVERWRITE or TRACE_MODE_STOP
+ */
+void trace_mode_set(uint8_t mode);
+
+/**
+ * This function will set where the drain task hands the records to
+ * @param[in]  sink  called in the drain task with whole records, NULL to stop
+ */
+void trace_sink_set(trace_sink_t sink);
+
+/**
+ * This function will move the pending records of all cpus out of the rings
+ * @param[out]  buf   the buffer, aligned for k_trace_rec_t
+ * @param[in]   size  the size of buf
+ * @return  the bytes copied, a multiple of sizeof(k_trace_rec_t)
+ */
+size_t trace_drain(void *buf, size_t size);
+
+/**
+ * This function will keep only the records of one task
+ * @param[in]  task_name  the name of the task
+ * @return  0 if the task is found, 1 otherwise
+ */
+int32_t set_filter_task(const char *task_name);
+
+/**
+ * This function will keep only one event or one event type
+ * @param[in]  mask  a TRACE_ID_*, or one with the low byte cleared, 0 for all
+ */
+void set_event_mask(const uint32_t mask);
+
+/**
+ * This function will stop recording, the rings keep their records
+ */
+void trace_deinit(void);
+
 /* task trace function */
 void _trace_init(void);
 void _trace_task_switch(ktask_t *from, ktask_t *to);
@@ -68,13 +205,20 @@ void _trace_timer_del(ktask_t *task, ktimer_t *timer);
 /* mblk trace function */
 void _trace_mblk_pool_create(ktask_t *task, mblk_pool_t *pool);
 
-/* mm trace function */
-//void _trace_mm_pool_create(ktask_t *task, mm_pool_t *pool);
+/* mm region trace function */
+void _trace_mm_region_create(ktask_t *task, k_mm_region_t *regions);
 
 /* work queue trace */
+#if (RHINO_CONFIG_WORKQUEUE > 0)
 void _trace_work_init(ktask_t *task, kwork_t *work);
 void _trace_workqueue_create(ktask_t *task, kworkqueue_t *workqueue);
 void _trace_workqueue_del(ktask_t *task, kworkqueue_t *workqueue);
+#endif
+
+/* queue trace function */
+void _trace_queue_create(ktask_t *task, kqueue_t *queue);
+void _trace_queue_get_blk(ktask_t *task, kqueue_t *queue, tick_t wait_option);
+void _trace_queue_task_wake(ktask_t *task, ktask_t *task_waked_up, kqueue_t *queue);
 
 /* task trace */
 #define TRACE_INIT()                                   _trace_init()
@@ -95,7 +239,7 @@ void _trace_workqueue_del(ktask_t *task, kworkqueue_t *workqueue);
 #define TRACE_SEM_GET_SUCCESS(task, sem)                       _trace_sem_get_success(task, sem)
 #define TRACE_SEM_GET_BLK(task, sem, wait_option)              _trace_sem_get_blk(task, sem, wait_option)
 #define TRACE_SEM_TASK_WAKE(task, task_waked_up, sem, opt_wake_all) _trace_sem_task_wake(task, task_waked_up, sem, opt_wake_all)
-#define TRACE_SEM_DEL(task, sem)                               _trace_sem_del(task, sem);
+#define TRACE_SEM_DEL(task, sem)                               _trace_sem_del(task, sem)
 
 /* mutex trace */
 #define TRACE_MUTEX_CREATE(task, mutex, name)             _trace_mutex_create(task, mutex, name)
@@ -128,9 +272,6 @@ void _trace_workqueue_del(ktask_t *task, kworkqueue_t *workqueue);
 /* mblk trace */
 #define TRACE_MBLK_POOL_CREATE(task, pool)      _trace_mblk_pool_create(task, pool)
 
-/* mm trace */
-#define TRACE_MM_POOL_CREATE(task, pool)        _trace_mm_pool_create(task, pool)
-
 /* mm region */
 #define TRACE_MM_REGION_CREATE(task, regions)   _trace_mm_region_create(task, regions)
 
@@ -139,6 +280,11 @@ void _trace_workqueue_del(ktask_t *task, kworkqueue_t *workqueue);
 #define TRACE_WORKQUEUE_CREATE(task, workqueue) _trace_workqueue_create(task, workqueue)
 #define TRACE_WORKQUEUE_DEL(task, workqueue)    _trace_workqueue_del(task, workqueue)
 
+/* queue trace */
+#define TRACE_QUEUE_CREATE(task, queue)                       _trace_queue_create(task, queue)
+#define TRACE_QUEUE_GET_BLK(task, queue, wait_option)         _trace_queue_get_blk(task, queue, wait_option)
+#define TRACE_QUEUE_TASK_WAKE(task, task_waked_up, queue)     _trace_queue_task_wake(task, task_waked_up, queue)
+
 #else
 /* task trace */
 #define TRACE_INIT()
@@ -192,9 +338,6 @@ void _trace_workqueue_del(ktask_t *task, kworkqueue_t *workqueue);
 /* MBLK trace */
 #define TRACE_MBLK_POOL_CREATE(task, pool)
 
-/* MM trace */
-#define TRACE_MM_POOL_CREATE(task, pool)
-
 /* MM region trace*/
 #define TRACE_MM_REGION_CREATE(task, regions)
 
@@ -202,6 +345,11 @@ void _trace_workqueue_del(ktask_t *task, kworkqueue_t *workqueue);
 #define TRACE_WORK_INIT(task, work)
 #define TRACE_WORKQUEUE_CREATE(task, workqueue)
 #define TRACE_WORKQUEUE_DEL(task, workqueue)
+
+/* queue trace */
+#define TRACE_QUEUE_CREATE(task, queue)
+#define TRACE_QUEUE_GET_BLK(task, queue, wait_option)
+#define TRACE_QUEUE_TASK_WAKE(task, task_waked_up, queue)
 #endif
 #endif
 
@@ -6,7 +6,26 @@
 #define K_WORKQUEUE_H
 
 #if (RHINO_CONFIG_WORKQUEUE > 0)
-#define WORKQUEUE_WORK_MAX 32
+#define WORKQUEUE_WORK_MAX         32
+
+/* pending works are ordered by kwork_t pri, FIFO among equal ones */
+#define WORKQUEUE_FLAG_PRI         1u
+
+/* 0 is the highest */
+#define WORKQUEUE_WORK_PRI_DEFAULT 128u
+
+#if (RHINO_CONFIG_WORKQUEUE_STATS > 0)
+/* bucket 0 counts 0, bucket n counts [2^(n-1), 2^n), the last one the rest */
+#define WORKQUEUE_HIST_NUM         32u
+
+typedef struct {
+    uint32_t depth[WORKQUEUE_HIST_NUM];   /* pending works, sampled as each work gets pending */
+    uint32_t latency[WORKQUEUE_HIST_NUM]; /* HR_COUNT_GET() from pending to start */
+    uint32_t exec[WORKQUEUE_HIST_NUM];    /* HR_COUNT_GET() spent in the handle */
+    uint32_t depth_max;
+    uint32_t work_done;
+} kworkqueue_stats_t;
+#endif
 
 typedef void (*work_handle_t)(void *arg);
 
@@ -15,18 +34,33 @@ typedef struct {
     work_handle_t handle;
     void         *arg;
     tick_t        dly;
-    ktimer_t     *timer;
+    tick_t        match;     /* expiry tick while on the delay wheel */
+    klist_t      *dly_head;  /* non NULL while the work is on the wheel */
     void         *wq;
-    uint8_t       work_exit;
+    uint8_t       work_exit; /* pending on wq */
+    uint8_t       pri;
+#if (RHINO_CONFIG_WORKQUEUE_STATS > 0)
+    hr_timer_t    pend_time;
+#endif
 } kwork_t;
 
 typedef struct {
-    klist_t       workqueue_node;
-    klist_t       work_list;
-    kwork_t      *work_current; /* current work */
-    const name_t *name;
-    ktask_t       worker;
-    ksem_t        sem;
+    klist_t        workqueue_node;
+    klist_t        work_list;   /* pending works */
+    kwork_t       *work_current[RHINO_CONFIG_WORKQUEUE_WORKER_MAX]; /* current work of each worker */
+    const name_t  *name;
+    ktask_t        worker[RHINO_CONFIG_WORKQUEUE_WORKER_MAX];
+    uint8_t        worker_num;
+    uint8_t        worker_idle; /* workers blocked on sem */
+    uint8_t        flag;
+    ksem_t         sem;
+    size_t         work_num;    /* pending works */
+    k_tick_wheel_t dly_wheel;   /* delayed works, advanced by the workers */
+    ktask_t       *dly_keeper;  /* the idle worker sleeping until dly_match */
+    tick_t         dly_match;
+#if (RHINO_CONFIG_WORKQUEUE_STATS > 0)
+    kworkqueue_stats_t stats;
+#endif
 } kworkqueue_t;
 
 /**
@@ -41,6 +75,22 @@ typedef struct {
 kstat_t krhino_workqueue_create(kworkqueue_t *workqueue, const name_t *name,
                                 uint8_t pri, cpu_stack_t *stack_buf, size_t stack_size);
 
+/**
+ * This function will creat a workqueue served by several workers
+ * @param[in]  workqueue   the workqueue to be created
+ * @param[in]  name        the name of workqueue/workers, which should be unique
+ * @param[in]  pri         the priority of the workers
+ * @param[in]  stack_buf   the stacks of the workers, split evenly among them
+ * @param[in]  stack_size  the size of stack_buf
+ * @param[in]  worker_num  the number of workers, 1 ~ RHINO_CONFIG_WORKQUEUE_WORKER_MAX
+ * @param[in]  flag        0 or WORKQUEUE_FLAG_PRI
+ * @return  the operation status, RHINO_SUCCESS is OK, others is error
+ */
+kstat_t krhino_workqueue_pool_create(kworkqueue_t *workqueue, const name_t *name,
+                                     uint8_t pri, cpu_stack_t *stack_buf,
+                                     size_t stack_size, uint8_t worker_num,
+                                     uint8_t flag);
+
 /**
  * This function will initialize a work
  * @param[in]  work    the work to be initialized
@@ -52,6 +102,14 @@ kstat_t krhino_workqueue_create(kworkqueue_t *workqueue, const name_t *name,
 kstat_t krhino_work_init(kwork_t *work, work_handle_t handle, void *arg,
                          tick_t dly);
 
+/**
+ * This function will set the priority of a work, used on WORKQUEUE_FLAG_PRI workqueues
+ * @param[in]  work  the work
+ * @param[in]  pri   the priority, 0 is the highest
+ * @return  the operation status, RHINO_SUCCESS is OK, others is error
+ */
+kstat_t krhino_work_pri_set(kwork_t *work, uint8_t pri);
+
 /**
  * This function will run a work on a workqueue
  * @param[in]  workqueue  the workqueue to run work
@@ -73,6 +131,23 @@ kstat_t krhino_work_sched(kwork_t *work);
  * @return  the operation status, RHINO_SUCCESS is OK, others is error
  */
 kstat_t krhino_work_cancel(kwork_t *work);
+
+#if (RHINO_CONFIG_WORKQUEUE_STATS > 0)
+/**
+ * This function will get the histograms of a workqueue
+ * @param[in]   workqueue  the workqueue
+ * @param[out]  stats      the copy of the histograms
+ * @return  the operation status, RHINO_SUCCESS is OK, others is error
+ */
+kstat_t krhino_workqueue_stats_get(kworkqueue_t *workqueue, kworkqueue_stats_t *stats);
+
+/**
+ * This function will clear the histograms of a workqueue
+ * @param[in]  workqueue  the workqueue
+ * @return  the operation status, RHINO_SUCCESS is OK, others is error
+ */
+kstat_t krhino_workqueue_stats_reset(kworkqueue_t *workqueue);
+#endif
 #endif
 
 #endif /* K_WORKQUEUE_H */
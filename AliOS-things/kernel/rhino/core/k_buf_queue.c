@@ -275,6 +275,118 @@ kstat_t krhino_buf_queue_send(kbuf_queue_t *queue, void *msg, size_t size)
     return buf_queue_send(queue, msg, size);
 }
 
+kstat_t krhino_buf_queue_send_batch(kbuf_queue_t *queue, void *msg,
+                                    const size_t *size, size_t num, size_t *sent)
+{
+    CPSR_ALLOC();
+
+    klist_t *head;
+    ktask_t *task;
+    uint8_t *cur;
+    size_t   msg_size;
+    size_t   woken;
+    size_t   cnt;
+    kstat_t  err;
+
+    uint8_t  cur_cpu_num;
+
+    NULL_PARA_CHK(queue);
+    NULL_PARA_CHK(msg);
+    NULL_PARA_CHK(sent);
+
+    *sent = 0u;
+
+    if (num == 0u) {
+        return RHINO_INV_PARAM;
+    }
+
+    /* this is only needed when system zero interrupt feature is enabled */
+#if (RHINO_CONFIG_INTRPT_GUARD > 0)
+    soc_intrpt_guard();
+#endif
+
+    RHINO_CRITICAL_ENTER();
+
+    if (queue->blk_obj.obj_type != RHINO_BUF_QUEUE_OBJ_TYPE) {
+        RHINO_CRITICAL_EXIT();
+        return RHINO_KOBJ_TYPE_ERR;
+    }
+
+    /* a fix buf queue takes msgs of max_msg_size, size may be NULL */
+    if ((size == NULL) && (queue->ringbuf.type != RINGBUF_TYPE_FIX)) {
+        RHINO_CRITICAL_EXIT();
+        return RHINO_NULL_PTR;
+    }
+
+    cur_cpu_num = cpu_cur_get();
+    (void)cur_cpu_num;
+
+    head  = &queue->blk_obj.blk_list;
+    cur   = msg;
+    woken = 0u;
+    err   = RHINO_SUCCESS;
+
+    for (cnt = 0u; cnt < num; cnt++) {
+        msg_size = (size != NULL) ? size[cnt] : queue->max_msg_size;
+
+        if (msg_size > queue->max_msg_size) {
+            TRACE_BUF_QUEUE_MAX(g_active_task[cur_cpu_num], queue, cur, msg_size);
+            err = RHINO_BUF_QUEUE_MSG_SIZE_OVERFLOW;
+            break;
+        }
+
+        if (msg_size == 0u) {
+            err = RHINO_INV_PARAM;
+            break;
+        }
+
+        /* receivers only block on an empty queue, hand each one msg in order */
+        if (!is_klist_empty(head)) {
+            task = krhino_list_entry(head->next, ktask_t, task_list);
+            memcpy(task->msg, cur, msg_size);
+            task->bq_msg_size = msg_size;
+
+            pend_task_wakeup(task);
+            woken++;
+
+            TRACE_BUF_QUEUE_TASK_WAKE(g_active_task[cur_cpu_num], task, queue);
+        } else {
+            err = ringbuf_push(&(queue->ringbuf), cur, msg_size);
+            if (err != RHINO_SUCCESS) {
+                if (err == RHINO_RINGBUF_FULL) {
+                    err = RHINO_BUF_QUEUE_FULL;
+                }
+                break;
+            }
+
+            queue->cur_num++;
+
+            TRACE_BUF_QUEUE_POST(g_active_task[cur_cpu_num], queue, cur, msg_size);
+        }
+
+        cur += msg_size;
+    }
+
+    if (queue->peak_num < queue->cur_num) {
+        queue->peak_num = queue->cur_num;
+    }
+
+    if (queue->min_free_buf_size > queue->ringbuf.freesize) {
+        queue->min_free_buf_size = queue->ringbuf.freesize;
+    }
+
+    *sent = cnt;
+
+    /* one reschedule for the whole batch */
+    if (woken > 0u) {
+        RHINO_CRITICAL_EXIT_SCHED();
+    } else {
+        RHINO_CRITICAL_EXIT();
+    }
+
+    return err;
+}
+
 kstat_t krhino_buf_queue_recv(kbuf_queue_t *queue, tick_t ticks, void *msg,
                               size_t *size)
 {
@@ -348,6 +460,111 @@ kstat_t krhino_buf_queue_recv(kbuf_queue_t *queue, tick_t ticks, void *msg,
     return ret;
 }
 
+/* pop while the rest of buf can hold the longest msg */
+static size_t buf_queue_msg_pop(kbuf_queue_t *queue, uint8_t *buf, size_t buf_size,
+                                size_t *size, size_t num)
+{
+    size_t cnt;
+
+    for (cnt = 0u; (cnt < num) && (buf_size >= queue->max_msg_size) &&
+         !ringbuf_is_empty(&(queue->ringbuf)); cnt++) {
+        ringbuf_pop(&(queue->ringbuf), buf, &size[cnt]);
+        queue->cur_num--;
+
+        buf      += size[cnt];
+        buf_size -= size[cnt];
+    }
+
+    return cnt;
+}
+
+kstat_t krhino_buf_queue_recv_batch(kbuf_queue_t *queue, tick_t ticks, void *msg,
+                                    size_t buf_size, size_t *size, size_t num,
+                                    size_t *recved)
+{
+    CPSR_ALLOC();
+
+    kstat_t  ret;
+    uint8_t  cur_cpu_num;
+    ktask_t *task;
+
+    NULL_PARA_CHK(queue);
+    NULL_PARA_CHK(msg);
+    NULL_PARA_CHK(size);
+    NULL_PARA_CHK(recved);
+
+    *recved = 0u;
+
+    if (num == 0u) {
+        return RHINO_INV_PARAM;
+    }
+
+    RHINO_CRITICAL_ENTER();
+
+    cur_cpu_num = cpu_cur_get();
+
+    if ((g_intrpt_nested_level[cur_cpu_num] > 0u) && (ticks != RHINO_NO_WAIT)) {
+        RHINO_CRITICAL_EXIT();
+        return RHINO_NOT_CALLED_BY_INTRPT;
+    }
+
+    if (queue->blk_obj.obj_type != RHINO_BUF_QUEUE_OBJ_TYPE) {
+        RHINO_CRITICAL_EXIT();
+        return RHINO_KOBJ_TYPE_ERR;
+    }
+
+    /* a sender copies into msg directly, it must hold the longest msg */
+    if (buf_size < queue->max_msg_size) {
+        RHINO_CRITICAL_EXIT();
+        return RHINO_INV_PARAM;
+    }
+
+    if (!ringbuf_is_empty(&(queue->ringbuf))) {
+        *recved = buf_queue_msg_pop(queue, msg, buf_size, size, num);
+        RHINO_CRITICAL_EXIT();
+        return RHINO_SUCCESS;
+    }
+
+    if (ticks == RHINO_NO_WAIT) {
+        RHINO_CRITICAL_EXIT();
+        return RHINO_NO_PEND_WAIT;
+    }
+
+    if (g_sched_lock[cur_cpu_num] > 0u) {
+        RHINO_CRITICAL_EXIT();
+        return RHINO_SCHED_DISABLE;
+    }
+
+    g_active_task[cur_cpu_num]->msg = msg;
+    pend_to_blk_obj((blk_obj_t *)queue, g_active_task[cur_cpu_num], ticks);
+
+    TRACE_BUF_QUEUE_GET_BLK(g_active_task[cur_cpu_num], queue, ticks);
+
+    RHINO_CRITICAL_EXIT_SCHED();
+
+    RHINO_CPU_INTRPT_DISABLE();
+
+    cur_cpu_num = cpu_cur_get();
+    task        = g_active_task[cur_cpu_num];
+
+    ret = pend_state_end_proc(task);
+
+    if (ret == RHINO_SUCCESS) {
+        size[0] = task->bq_msg_size;
+        *recved = 1u;
+
+        /* a batch sender queues the rest behind the msg handed over */
+        if (queue->blk_obj.obj_type == RHINO_BUF_QUEUE_OBJ_TYPE) {
+            *recved += buf_queue_msg_pop(queue, (uint8_t *)msg + size[0],
+                                         buf_size - size[0], &size[1], num - 1u);
+        }
+    }
+
+    RHINO_CPU_INTRPT_ENABLE();
+
+    return ret;
+}
+
 kstat_t krhino_buf_queue_flush(kbuf_queue_t *queue)
 { /* Ϣ */
     CPSR_ALLOC();
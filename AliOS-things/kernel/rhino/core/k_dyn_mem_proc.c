@@ -32,6 +32,7 @@ void dyn_mem_proc_task(void *arg)
                 for (i = 0; i < tmp.cnt; i++) {
                     krhino_mm_free(tmp.res[i]);
                 }
+                KOBJ_DYN_FREE(tmp.task);
             }
             else {
                 RHINO_CRITICAL_EXIT();
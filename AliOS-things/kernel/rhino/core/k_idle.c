@@ -32,6 +32,49 @@ idle_count_t idle_count_get(void)
 }
 #endif
 
+#if (RHINO_CONFIG_TICKLESS > 0)
+/*
+ * Sleep through the ticks where nothing is due. Timers need no separate
+ * look-up: the timer task waits on g_timer_queue with a timeout equal to
+ * the earliest timer deadline, so that deadline is already on the tick list.
+ */
+static uint8_t tickless_idle(void)
+{
+    CPSR_ALLOC();
+
+    tick_t  match;
+    tick_t  ticks;
+    tick_t  elapsed;
+    uint8_t slept;
+
+    slept = RHINO_FALSE;
+
+    RHINO_CRITICAL_ENTER();
+
+    if (tick_list_next(&match) == RHINO_TRUE) {
+        ticks = ((tick_i_t)(match - g_tick_count) > 0) ? (match - g_tick_count) : 0u;
+    } else {
+        ticks = RHINO_WAIT_FOREVER;
+    }
+
+    if (ticks >= RHINO_CONFIG_TICKLESS_MIN_TICKS) {
+        cpu_tick_suspend(ticks);
+        cpu_idle_wait();
+        elapsed = cpu_tick_resume();
+
+        if (elapsed > 0u) {
+            tick_list_update((tick_i_t)elapsed);
+        }
+
+        slept = RHINO_TRUE;
+    }
+
+    RHINO_CRITICAL_EXIT_SCHED();
+
+    return slept;
+}
+#endif
+
 void idle_task(void *arg)
 { /* idle */
     CPSR_ALLOC();
@@ -54,6 +97,16 @@ void idle_task(void *arg)
         krhino_idle_hook();
 #endif
 
+#if (RHINO_CONFIG_MM_MAGAZINE > 0)
+        k_mm_magazine_idle_trim();
+#endif
+
+#if (RHINO_CONFIG_TICKLESS > 0)
+        if (tickless_idle() == RHINO_TRUE) {
+            continue;
+        }
+#endif
+
 #if (RHINO_CONFIG_CPU_PWR_MGMT > 0)
         cpu_pwr_down();
 #endif
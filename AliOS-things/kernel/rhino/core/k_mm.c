@@ -42,10 +42,21 @@
     krhino_mutex_unlock(pMutex)
 #endif
 
-#define MM_IS_FIXEDBLK(mh,ptr) \
-        (mh->fixedmblk && ((void *)ptr > (void *)(mh->fixedmblk->mbinfo.buffer))            \
-        && ((void *)ptr < (void *)(mh->fixedmblk->mbinfo.buffer + mh->fixedmblk->buf_size)))
-        
+#if (RHINO_CONFIG_MM_PROF > 0)
+#if defined (__CC_ARM)
+#define MM_RETADDR()    ((size_t)__return_address())
+#elif defined (__GNUC__)
+#define MM_RETADDR()    ((size_t)__builtin_return_address(0))
+#endif /* __CC_ARM */
+#endif
+
+/* the second level freelists grow k_mm_head to KBs, a pool has to hold it too */
+#if (RHINO_CONFIG_MM_SL_BITS > 0)
+#define MM_HEAD_ROOM    MM_ALIGN_UP(sizeof(k_mm_head))
+#else
+#define MM_HEAD_ROOM    0
+#endif
+
 extern k_mm_region_t   g_mm_region[];
 extern int             g_region_num;
 extern void aos_mm_leak_region_init(void);
@@ -130,6 +141,37 @@ static int32_t size_to_level(size_t size)
     return cnt - MM_MIN_BIT;
 }
 
+/* level of a free blk, and its freelist inside the level */
+static int32_t size_to_index(size_t size, int32_t *sl)
+{
+    int32_t level;
+
+    level = size_to_level(size);
+    *sl   = 0;
+
+#if (RHINO_CONFIG_MM_SL_BITS > 0)
+    if (level >= 0 && size >= MM_MIN_SIZE) {
+        *sl = (size >> (level + MM_MIN_BIT - 1 - RHINO_CONFIG_MM_SL_BITS))
+              & (MM_SL_NUM - 1);
+    }
+#endif
+
+    return level;
+}
+
+/* move size into the first freelist whose blks are all big enough for it */
+static size_t size_round_up(size_t size)
+{
+    int32_t level;
+
+    level = size_to_level(size);
+    if (level < 0) {
+        return size;
+    }
+
+    return size + ((size_t)1 << (level + MM_MIN_BIT - 1 - RHINO_CONFIG_MM_SL_BITS)) - 1;
+}
+
 #if(K_MM_STATISTIC > 0)
 static void addsize(k_mm_head *mmhead, size_t size, size_t req_size)
 {
@@ -189,6 +231,7 @@ kstat_t krhino_init_mm_head(k_mm_head **ppmmhead, void *addr, size_t len )
     /*check paramters, addr and len need algin
       1.  the length at least need RHINO_CONFIG_MM_TLF_BLK_SIZE  for fixed size memory block
       2.  and also ast least have 1k for user alloced
+      3.  and room for k_mm_head with second level freelists
     */
     orig_addr = addr;
     addr = (void *) MM_ALIGN_UP((size_t)addr); /* ʼַ8ֽ϶ */
@@ -196,7 +239,7 @@ kstat_t krhino_init_mm_head(k_mm_head **ppmmhead, void *addr, size_t len )
     len = MM_ALIGN_DOWN(len); /* ܳ8ֽ¶ */
 
     if ( len == 0
-         || len < MIN_FREE_MEMORY_SIZE + RHINO_CONFIG_MM_TLF_BLK_SIZE
+         || len < MM_HEAD_ROOM + MIN_FREE_MEMORY_SIZE + RHINO_CONFIG_MM_TLF_BLK_SIZE
          || len > MM_MAX_SIZE) { /* [1k+xk, 16M] */
         return RHINO_MM_POOL_SIZE_ERR;
     }
@@ -359,12 +402,12 @@ static void k_mm_smallblk_free(k_mm_head *mmhead, void *ptr)
 }
 #endif
 
-/* insert blk to freelist[level], and set freebitmap */
+/* insert blk to freelist[level][sl], and set freebitmap */
 static void k_mm_freelist_insert(k_mm_head *mmhead, k_mm_list_t *blk)
 {
-    int32_t level;
+    int32_t level, sl;
 
-    level = size_to_level(MM_GET_BUF_SIZE(blk));
+    level = size_to_index(MM_GET_BUF_SIZE(blk), &sl);
     if ( level < 0 || level >= MM_BIT_LEVEL )
     {
         return;
@@ -373,24 +416,27 @@ static void k_mm_freelist_insert(k_mm_head *mmhead, k_mm_list_t *blk)
     /* free list is LIFO */
 
     blk->mbinfo.free_ptr.prev = NULL;
-    blk->mbinfo.free_ptr.next = mmhead->freelist[level];
+    blk->mbinfo.free_ptr.next = mmhead->freelist[level][sl];
 
-    if (mmhead->freelist[level] != NULL) {
-        mmhead->freelist[level]->mbinfo.free_ptr.prev = blk;
+    if (mmhead->freelist[level][sl] != NULL) {
+        mmhead->freelist[level][sl]->mbinfo.free_ptr.prev = blk;
     }
 
-    mmhead->freelist[level] = blk;
+    mmhead->freelist[level][sl] = blk;
     
     /* freelist not null, so set the bit  */
-    mmhead->free_bitmap |= (1<<level);
+    mmhead->free_bitmap |= (1u << level);
+#if (RHINO_CONFIG_MM_SL_BITS > 0)
+    mmhead->sl_bitmap[level] |= (1u << sl);
+#endif
 }
 
-/* get blk from freelist[level], and clear freebitmap if needed */
+/* get blk from freelist[level][sl], and clear freebitmap if needed */
 static void k_mm_freelist_delete(k_mm_head *mmhead, k_mm_list_t *blk)
 { /* blockɾ */
-    int32_t level;
+    int32_t level, sl;
 
-    level = size_to_level(MM_GET_BUF_SIZE(blk));
+    level = size_to_index(MM_GET_BUF_SIZE(blk), &sl);
     if ( level < 0 || level >= MM_BIT_LEVEL )
     {
         return;
@@ -403,12 +449,19 @@ static void k_mm_freelist_delete(k_mm_head *mmhead, k_mm_list_t *blk)
         blk->mbinfo.free_ptr.prev->mbinfo.free_ptr.next = blk->mbinfo.free_ptr.next;
     }
     
-    if (mmhead->freelist[level] == blk) {
+    if (mmhead->freelist[level][sl] == blk) {
         /* first blk in this freelist */
-        mmhead->freelist[level] = blk->mbinfo.free_ptr.next;
-        if (mmhead->freelist[level] == NULL) {
+        mmhead->freelist[level][sl] = blk->mbinfo.free_ptr.next;
+        if (mmhead->freelist[level][sl] == NULL) {
             /* freelist null, so clear the bit  */ /* Сk_mm_list_tѾûԪ */
-            mmhead->free_bitmap &= (~(1<<level)); /* ˴Сblk λͼ */
+#if (RHINO_CONFIG_MM_SL_BITS > 0)
+            mmhead->sl_bitmap[level] &= ~(1u << sl);
+            if (mmhead->sl_bitmap[level] == 0) {
+                mmhead->free_bitmap &= ~(1u << level);
+            }
+#else
+            mmhead->free_bitmap &= ~(1u << level); /* ˴Сblk λͼ */
+#endif
         }
     }
     
@@ -416,23 +469,51 @@ static void k_mm_freelist_delete(k_mm_head *mmhead, k_mm_list_t *blk)
     blk->mbinfo.free_ptr.next = NULL;
 }
 
-/* find a freelist at higher level */
-static k_mm_list_t *find_up_level(k_mm_head *mmhead, int32_t level)
+/* find a free blk for size: the first non-empty freelist from the rounded up
+   size on fits with two bitmap lookups, only when there is none the freelist
+   of size itself is searched for a blk that still fits */
+static k_mm_list_t *k_mm_freelist_find(k_mm_head *mmhead, size_t size)
 {
-    uint32_t bitmap;
-    
-    bitmap = mmhead->free_bitmap & (0xfffffffful<<(level+1));
-    level  = krhino_ctz32(bitmap);
+    k_mm_list_t *blk;
+    uint32_t     bitmap;
+    int32_t      level, sl;
+
+    level = size_to_index(size_round_up(size), &sl);
+    if (level >= 0) {
+#if (RHINO_CONFIG_MM_SL_BITS > 0)
+        bitmap = mmhead->sl_bitmap[level] & (0xfffffffful << sl);
+        if (bitmap != 0) {
+            return mmhead->freelist[level][krhino_ctz32(bitmap)];
+        }
+        level++;
+#endif
+        bitmap = mmhead->free_bitmap & (0xfffffffful << level);
+        if (bitmap != 0) {
+            level = krhino_ctz32(bitmap);
+#if (RHINO_CONFIG_MM_SL_BITS > 0)
+            sl = krhino_ctz32(mmhead->sl_bitmap[level]);
+#else
+            sl = 0;
+#endif
+            return mmhead->freelist[level][sl];
+        }
+    }
 
-    if ( level < MM_BIT_LEVEL )
-    {
-        return mmhead->freelist[level];
+    level = size_to_index(size, &sl);
+    if (level < 0) {
+        return NULL;
+    }
+
+    blk = mmhead->freelist[level][sl];
+    while (blk != NULL && MM_GET_BUF_SIZE(blk) < size) {
+        blk = blk->mbinfo.free_ptr.next;
     }
 
-    return NULL;
+    return blk;
 }
 
-void *k_mm_alloc(k_mm_head *mmhead, size_t size)
+/* the caller holds the heap lock */
+static void *k_mm_blk_alloc(k_mm_head *mmhead, size_t size)
 {
     void        *retptr;
     k_mm_list_t *get_b, *new_b, *next_b;
@@ -442,20 +523,9 @@ void *k_mm_alloc(k_mm_head *mmhead, size_t size)
 #if (RHINO_CONFIG_MM_TLF_BLK_SIZE > 0)
     mblk_pool_t *mm_pool;
 #endif
-    MM_CRITICAL_ALLOC();
 
     (void)req_size;
 
-    if (!mmhead) {
-        return NULL;
-    }
-
-    if (size == 0) {
-        return NULL;
-    }
-
-    MM_CRITICAL_ENTER(&(mmhead->mm_mutex));
-    
 #if (RHINO_CONFIG_MM_TLF_BLK_SIZE > 0)
     /* little blk, try to get from mm_pool */
     if(mmhead->fixedmblk != NULL) {
@@ -463,7 +533,6 @@ void *k_mm_alloc(k_mm_head *mmhead, size_t size)
         if (size <= DEF_FIX_BLK_SIZE && mm_pool->blk_avail > 0) {
             retptr =  k_mm_smallblk_alloc(mmhead, size);
             if (retptr) {
-                MM_CRITICAL_EXIT(&(mmhead->mm_mutex));
                 return retptr;
             }
         }
@@ -479,25 +548,10 @@ void *k_mm_alloc(k_mm_head *mmhead, size_t size)
         goto ALLOCEXIT;
     }
 
-    /* try to find in higher level */ /* Ҹlevel k_mm_list_t*/
-    get_b = find_up_level(mmhead, level);
+    get_b = k_mm_freelist_find(mmhead, size);
     if (get_b == NULL) {
-        /* try to find in same level */
-        get_b = mmhead->freelist[level];
-        while ( get_b != NULL )        
-        {
-            if ( MM_GET_BUF_SIZE(get_b) >= size )
-            {
-                break;
-            }
-            get_b = get_b->mbinfo.free_ptr.next;
-        }
-
-        if ( get_b == NULL )
-        {   
-            /* do not find availalbe freeblk */
-            goto ALLOCEXIT;
-        }
+        /* do not find availalbe freeblk */
+        goto ALLOCEXIT;
     }
     k_mm_freelist_delete(mmhead, get_b);
 
@@ -534,44 +588,61 @@ void *k_mm_alloc(k_mm_head *mmhead, size_t size)
 
 ALLOCEXIT:
 
-    MM_CRITICAL_EXIT(&(mmhead->mm_mutex));
-
     return retptr ;
 }
 
-void  k_mm_free(k_mm_head *mmhead, void *ptr)
+void *k_mm_alloc(k_mm_head *mmhead, size_t size)
 {
-    k_mm_list_t *free_b, *next_b, *prev_b;
+    void *retptr;
     MM_CRITICAL_ALLOC();
 
-    if (!ptr || !mmhead) {
-        return;
+    if (!mmhead) {
+        return NULL;
+    }
+
+    if (size == 0) {
+        return NULL;
     }
 
     MM_CRITICAL_ENTER(&(mmhead->mm_mutex));
 
+    retptr = k_mm_blk_alloc(mmhead, size);
+
+    MM_CRITICAL_EXIT(&(mmhead->mm_mutex));
+
+    return retptr;
+}
+
+/* the caller holds the heap lock and drops it before k_err_proc() on error */
+static kstat_t k_mm_blk_free(k_mm_head *mmhead, void *ptr)
+{
+    k_mm_list_t *free_b, *next_b, *prev_b;
+
 #if (RHINO_CONFIG_MM_TLF_BLK_SIZE > 0)
     /* little blk, free to mm_pool */
     if (MM_IS_FIXEDBLK(mmhead, ptr)) {
         /*it's fixed size memory block*/
         k_mm_smallblk_free(mmhead, ptr);
-        MM_CRITICAL_EXIT(&(mmhead->mm_mutex));
-        return;
+        return RHINO_SUCCESS;
     }
 #endif
 
     free_b = MM_GET_THIS_BLK(ptr);
 
+#if (RHINO_CONFIG_MM_PROF > 0)
+    if (free_b->buf_size & RHINO_MM_SAMPLED) {
+        k_mm_prof_free(ptr);
+    }
+#endif
+
 #if (RHINO_CONFIG_MM_DEBUG > 0u)
     if (free_b->dye == RHINO_MM_FREE_DYE) {
-        MM_CRITICAL_EXIT(&(mmhead->mm_mutex));
         printf("WARNING!! memory maybe double free!!\r\n");
-        k_err_proc(RHINO_SYS_FATAL_ERR);
+        return RHINO_SYS_FATAL_ERR;
     }
     if (free_b->dye != RHINO_MM_CORRUPT_DYE) {
-        MM_CRITICAL_EXIT(&(mmhead->mm_mutex));
         printf("WARNING,memory maybe corrupt!!\r\n");
-        k_err_proc(RHINO_SYS_FATAL_ERR);
+        return RHINO_SYS_FATAL_ERR;
     }
     free_b->dye   = RHINO_MM_FREE_DYE;
     free_b->owner = 0;
@@ -592,9 +663,8 @@ void  k_mm_free(k_mm_head *mmhead, void *ptr)
         prev_b = free_b->prev;
 #if (RHINO_CONFIG_MM_DEBUG > 0u)
         if (prev_b->dye != RHINO_MM_FREE_DYE) {
-            MM_CRITICAL_EXIT(&(mmhead->mm_mutex));
             printf("WARNING,memory overwritten!!\r\n");
-            k_err_proc(RHINO_SYS_FATAL_ERR);
+            return RHINO_SYS_FATAL_ERR;
         }
 #endif
         k_mm_freelist_delete(mmhead, prev_b);
@@ -608,15 +678,34 @@ void  k_mm_free(k_mm_head *mmhead, void *ptr)
     next_b = MM_GET_NEXT_BLK(free_b);
 #if (RHINO_CONFIG_MM_DEBUG > 0u)
     if (next_b->dye != RHINO_MM_FREE_DYE && next_b->dye != RHINO_MM_CORRUPT_DYE) {
-        MM_CRITICAL_EXIT(&(mmhead->mm_mutex));
         printf("WARNING,memory overwritten!!\r\n");
-        k_err_proc(RHINO_SYS_FATAL_ERR);
+        return RHINO_SYS_FATAL_ERR;
     }
 #endif
     next_b->prev = free_b;
     next_b->buf_size |= RHINO_MM_PREVFREE;
 
+    return RHINO_SUCCESS;
+}
+
+void  k_mm_free(k_mm_head *mmhead, void *ptr)
+{
+    kstat_t ret;
+    MM_CRITICAL_ALLOC();
+
+    if (!ptr || !mmhead) {
+        return;
+    }
+
+    MM_CRITICAL_ENTER(&(mmhead->mm_mutex));
+
+    ret = k_mm_blk_free(mmhead, ptr);
+
     MM_CRITICAL_EXIT(&(mmhead->mm_mutex));
+
+    if (ret != RHINO_SUCCESS) {
+        k_err_proc(ret);
+    }
 }
 
 void *k_mm_realloc(k_mm_head *mmhead, void *oldmem, size_t new_size)
@@ -645,6 +734,14 @@ void *k_mm_realloc(k_mm_head *mmhead, void *oldmem, size_t new_size)
 
     req_size =  new_size;
 
+#if (RHINO_CONFIG_MM_PROF > 0)
+    /* the caller samples the result as a new blk */
+    if (!MM_IS_FIXEDBLK(mmhead, oldmem)
+        && (MM_GET_THIS_BLK(oldmem)->buf_size & RHINO_MM_SAMPLED)) {
+        k_mm_prof_free(oldmem);
+    }
+#endif
+
     MM_CRITICAL_ENTER(&(mmhead->mm_mutex));
     
 #if (RHINO_CONFIG_MM_BLK > 0)
@@ -765,6 +862,359 @@ void *k_mm_realloc(k_mm_head *mmhead, void *oldmem, size_t new_size)
 
 }
 
+void *k_mm_alloc_aligned(k_mm_head *mmhead, size_t size, size_t align)
+{
+    void        *ptr;
+    void        *retptr;
+    k_mm_list_t *this_b, *new_b, *next_b;
+    size_t       lead_size;
+    MM_CRITICAL_ALLOC();
+
+    if (!mmhead || size == 0 || size > MM_MAX_SIZE) {
+        return NULL;
+    }
+
+    if (align == 0 || (align & (align - 1)) != 0 || align > MM_MAX_SIZE) {
+        return NULL;
+    }
+
+    if (align <= MM_ALIGN_SIZE) {
+        return k_mm_alloc(mmhead, size);
+    }
+
+    size = MM_ALIGN_UP(size);
+    size = size < MM_MIN_SIZE ? MM_MIN_SIZE : size;
+
+    MM_CRITICAL_ENTER(&(mmhead->mm_mutex));
+
+    /* big enough to leave a free blk in front of the aligned buffer */
+    ptr = k_mm_alloc(mmhead, size + align + MMLIST_HEAD_SIZE + MM_MIN_SIZE);
+    if (ptr == NULL) {
+        MM_CRITICAL_EXIT(&(mmhead->mm_mutex));
+        return NULL;
+    }
+
+    retptr = ptr;
+
+    if (((size_t)ptr & (align - 1)) != 0) {
+        retptr = (void *)(((size_t)ptr + MMLIST_HEAD_SIZE + MM_MIN_SIZE + align - 1)
+                          & ~(align - 1));
+
+        this_b    = MM_GET_THIS_BLK(ptr);
+        new_b     = MM_GET_THIS_BLK(retptr);
+        next_b    = MM_GET_NEXT_BLK(this_b);
+        lead_size = (size_t)new_b - (size_t)this_b->mbinfo.buffer;
+
+        /* split at the aligned buffer, both parts used for now */
+        new_b->prev     = this_b;
+        new_b->buf_size = (MM_GET_BUF_SIZE(this_b) - lead_size - MMLIST_HEAD_SIZE)
+                        | RHINO_MM_ALLOCED | RHINO_MM_PREVALLOCED;
+#if (RHINO_CONFIG_MM_DEBUG > 0u)
+        new_b->dye   = RHINO_MM_CORRUPT_DYE;
+        new_b->owner = 0;
+#endif
+        next_b->prev     = new_b;
+        this_b->buf_size = lead_size | (this_b->buf_size & RHINO_MM_PRESTAT_MASK);
+
+        /* the lead part goes back to the freelist */
+        k_mm_free(mmhead, ptr);
+    }
+
+    /* and so does the tail behind size */
+    retptr = k_mm_realloc(mmhead, retptr, size);
+
+    MM_CRITICAL_EXIT(&(mmhead->mm_mutex));
+
+    return retptr;
+}
+
+#if (RHINO_CONFIG_MM_MAGAZINE > 0)
+/*
+ * Per-cpu magazines: each cpu keeps a LIFO of allocated blocks for the
+ * first RHINO_CONFIG_MM_MAGAZINE_LEVELS levels, guarded by disabling the
+ * local interrupts only. Blocks are cut at the aligned request size, so a
+ * level may hold blocks of several sizes. The heap lock is held once per
+ * half magazine when one runs empty or full, and the idle task gives back
+ * the magazines left unused for a trim period.
+ */
+#if (K_MM_STATISTIC > 0)
+#define MAG_STATS_INC(mag, cnt) ((mag)->cnt++)
+#else
+#define MAG_STATS_INC(mag, cnt) do{}while(0)
+#endif
+
+/* blocks moved between a magazine and the heap per lock round trip */
+#define MM_MAG_BATCH            (RHINO_CONFIG_MM_MAGAZINE_SIZE / 2)
+
+/* magazine level for a block or an aligned request size, -1 if none */
+static int32_t mag_level(size_t size)
+{
+    int32_t level;
+
+    level = size_to_level(size);
+    if (level >= RHINO_CONFIG_MM_MAGAZINE_LEVELS) {
+        return -1;
+    }
+
+    return level;
+}
+
+static uint32_t k_mm_mag_get(k_mm_head *mmhead, size_t size, void **blk, uint32_t num)
+{
+    uint32_t cnt;
+    MM_CRITICAL_ALLOC();
+
+    MM_CRITICAL_ENTER(&(mmhead->mm_mutex));
+
+    for (cnt = 0; cnt < num; cnt++) {
+        blk[cnt] = k_mm_blk_alloc(mmhead, size);
+        if (blk[cnt] == NULL) {
+            break;
+        }
+    }
+
+    MM_CRITICAL_EXIT(&(mmhead->mm_mutex));
+
+    return cnt;
+}
+
+static void k_mm_mag_put(k_mm_head *mmhead, void **blk, uint32_t num)
+{
+    uint32_t cnt;
+    kstat_t  ret;
+    MM_CRITICAL_ALLOC();
+
+    MM_CRITICAL_ENTER(&(mmhead->mm_mutex));
+
+    for (cnt = 0, ret = RHINO_SUCCESS; cnt < num && ret == RHINO_SUCCESS; cnt++) {
+        ret = k_mm_blk_free(mmhead, blk[cnt]);
+    }
+
+    MM_CRITICAL_EXIT(&(mmhead->mm_mutex));
+
+    if (ret != RHINO_SUCCESS) {
+        k_err_proc(ret);
+    }
+}
+
+static void *k_mm_mag_alloc(k_mm_head *mmhead, size_t size)
+{
+    k_mm_mag_t *mag;
+    void       *blk[MM_MAG_BATCH];
+    void       *retptr;
+    size_t      buf_size;
+    int32_t     level;
+    uint32_t    cnt;
+    uint32_t    i;
+    CPSR_ALLOC();
+
+    if (!mmhead) {
+        return NULL;
+    }
+
+#if (RHINO_CONFIG_MM_TLF_BLK_SIZE > 0)
+    /* the fixed size pool serves these first */
+    if (size <= DEF_FIX_BLK_SIZE && mmhead->fixedmblk != NULL) {
+        return k_mm_alloc(mmhead, size);
+    }
+#endif
+
+    /* the size k_mm_alloc() would cut the block at */
+    buf_size = MM_ALIGN_UP(size);
+    buf_size = buf_size < MM_MIN_SIZE ? MM_MIN_SIZE : buf_size;
+
+    level = mag_level(buf_size);
+    if (level < 0 || size == 0) {
+        return k_mm_alloc(mmhead, size);
+    }
+
+    RHINO_CPU_INTRPT_DISABLE();
+
+    mag = &mmhead->mag[cpu_cur_get()][level];
+    mag->active = 1u;
+
+    /* the most recently cached block big enough for the request */
+    for (i = mag->cnt; i > 0u; i--) {
+        if (MM_GET_BUF_SIZE(MM_GET_THIS_BLK(mag->blk[i - 1])) >= buf_size) {
+            break;
+        }
+    }
+
+    if (i > 0u) {
+        retptr = mag->blk[i - 1];
+        memmove(&mag->blk[i - 1], &mag->blk[i], (mag->cnt - i) * sizeof(void *));
+        mag->cnt--;
+        MAG_STATS_INC(mag, hit);
+        RHINO_CPU_INTRPT_ENABLE();
+        return retptr;
+    }
+
+    MAG_STATS_INC(mag, miss);
+
+    RHINO_CPU_INTRPT_ENABLE();
+
+    cnt = k_mm_mag_get(mmhead, buf_size, blk, MM_MAG_BATCH);
+    if (cnt == 0u) {
+        return NULL;
+    }
+
+    retptr = blk[--cnt];
+
+    RHINO_CPU_INTRPT_DISABLE();
+
+    /* the task may have moved to another cpu meanwhile, fill the current one */
+    mag = &mmhead->mag[cpu_cur_get()][level];
+    while (cnt > 0u && mag->cnt < RHINO_CONFIG_MM_MAGAZINE_SIZE) {
+        mag->blk[mag->cnt++] = blk[--cnt];
+    }
+
+    RHINO_CPU_INTRPT_ENABLE();
+
+    if (cnt > 0u) {
+        k_mm_mag_put(mmhead, blk, cnt);
+    }
+
+    return retptr;
+}
+
+static void k_mm_mag_free(k_mm_head *mmhead, void *ptr)
+{
+    k_mm_mag_t  *mag;
+    k_mm_list_t *free_b;
+    void        *blk[MM_MAG_BATCH];
+    int32_t      level;
+    CPSR_ALLOC();
+
+    if (!ptr || !mmhead) {
+        return;
+    }
+
+#if (RHINO_CONFIG_MM_TLF_BLK_SIZE > 0)
+    if (MM_IS_FIXEDBLK(mmhead, ptr)) {
+        k_mm_free(mmhead, ptr);
+        return;
+    }
+#endif
+
+    free_b = MM_GET_THIS_BLK(ptr);
+
+    level = mag_level(MM_GET_BUF_SIZE(free_b));
+    if (level < 0) {
+        k_mm_free(mmhead, ptr);
+        return;
+    }
+
+#if (RHINO_CONFIG_MM_DEBUG > 0u)
+    /* let k_mm_free() report double free and corruption */
+    if (free_b->dye != RHINO_MM_CORRUPT_DYE) {
+        k_mm_free(mmhead, ptr);
+        return;
+    }
+#endif
+
+#if (RHINO_CONFIG_MM_PROF > 0)
+    if (free_b->buf_size & RHINO_MM_SAMPLED) {
+        k_mm_prof_free(ptr);
+    }
+#endif
+
+    RHINO_CPU_INTRPT_DISABLE();
+
+    mag = &mmhead->mag[cpu_cur_get()][level];
+    mag->active = 1u;
+
+    if (mag->cnt < RHINO_CONFIG_MM_MAGAZINE_SIZE) {
+        mag->blk[mag->cnt++] = ptr;
+        RHINO_CPU_INTRPT_ENABLE();
+        return;
+    }
+
+    /* full, flush the coldest half and keep the recently freed ones on top */
+    memcpy(blk, mag->blk, sizeof(blk));
+    memmove(mag->blk, &mag->blk[MM_MAG_BATCH],
+            (mag->cnt - MM_MAG_BATCH) * sizeof(void *));
+    mag->cnt -= MM_MAG_BATCH;
+    mag->blk[mag->cnt++] = ptr;
+
+    RHINO_CPU_INTRPT_ENABLE();
+
+    k_mm_mag_put(mmhead, blk, MM_MAG_BATCH);
+}
+
+/* give back the magazines of the current cpu, only the unused ones unless all */
+static void k_mm_mag_flush(k_mm_head *mmhead, uint8_t all)
+{
+    k_mm_mag_t *mag;
+    void       *blk[RHINO_CONFIG_MM_MAGAZINE_SIZE];
+    int32_t     level;
+    uint32_t    cnt;
+    CPSR_ALLOC();
+
+    for (level = 0; level < RHINO_CONFIG_MM_MAGAZINE_LEVELS; level++) {
+        RHINO_CPU_INTRPT_DISABLE();
+
+        mag = &mmhead->mag[cpu_cur_get()][level];
+        cnt = 0u;
+
+        if (all == RHINO_TRUE || mag->active == 0u) {
+            cnt = mag->cnt;
+            memcpy(blk, mag->blk, cnt * sizeof(void *));
+            mag->cnt = 0u;
+        }
+
+        mag->active = 0u;
+
+        RHINO_CPU_INTRPT_ENABLE();
+
+        if (cnt > 0u) {
+            k_mm_mag_put(mmhead, blk, cnt);
+        }
+    }
+}
+
+void krhino_mm_magazine_trim(void)
+{
+    if (g_kmm_head == NULL) {
+        return;
+    }
+
+    k_mm_mag_flush(g_kmm_head, RHINO_TRUE);
+}
+
+void k_mm_magazine_idle_trim(void)
+{
+    k_mm_head *mmhead = g_kmm_head;
+    uint8_t    cur_cpu_num;
+
+    if (mmhead == NULL) {
+        return;
+    }
+
+    /* the idle task is bound to its cpu */
+    cur_cpu_num = cpu_cur_get();
+
+    if ((tick_i_t)(g_tick_count - mmhead->mag_trim_tick[cur_cpu_num])
+        < (tick_i_t)RHINO_CONFIG_MM_MAGAZINE_TRIM_TICKS) {
+        return;
+    }
+
+    mmhead->mag_trim_tick[cur_cpu_num] = g_tick_count;
+
+#if (RHINO_CONFIG_MM_REGION_MUTEX > 0)
+    /* the idle task must never pend, try again next period if the heap is busy */
+    if (krhino_mutex_lock(&mmhead->mm_mutex, RHINO_NO_WAIT) != RHINO_SUCCESS) {
+        return;
+    }
+#endif
+
+    k_mm_mag_flush(mmhead, RHINO_FALSE);
+
+#if (RHINO_CONFIG_MM_REGION_MUTEX > 0)
+    krhino_mutex_unlock(&mmhead->mm_mutex);
+#endif
+}
+#endif /* RHINO_CONFIG_MM_MAGAZINE */
+
 #if (RHINO_CONFIG_MM_DEBUG > 0u && RHINO_CONFIG_GCC_RETADDR > 0u)
 void krhino_owner_attach(k_mm_head *mmhead, void *addr, size_t allocator)
 {
@@ -806,7 +1256,16 @@ void *krhino_mm_alloc(size_t size)
         return NULL;
     }
 
+#if (RHINO_CONFIG_MM_MAGAZINE > 0)
+    tmp = k_mm_mag_alloc(g_kmm_head, size);
+    if (tmp == NULL) {
+        /* the blocks parked in the magazines may be what is missing */
+        krhino_mm_magazine_trim();
+        tmp = k_mm_alloc(g_kmm_head, size);
+    }
+#else
     tmp = k_mm_alloc(g_kmm_head, size);
+#endif
     if (tmp == NULL) {
 #if (RHINO_CONFIG_MM_DEBUG > 0)
         static int32_t dumped;
@@ -827,6 +1286,10 @@ void *krhino_mm_alloc(size_t size)
     krhino_mm_alloc_hook(tmp, size);
 #endif
 
+#if (RHINO_CONFIG_MM_PROF > 0)
+    k_mm_prof_alloc(tmp, size, MM_RETADDR());
+#endif
+
 #if (RHINO_CONFIG_MM_DEBUG > 0u && RHINO_CONFIG_GCC_RETADDR > 0u)
     if (app_malloc == 0) {
 #if defined (__CC_ARM)
@@ -842,7 +1305,11 @@ void *krhino_mm_alloc(size_t size)
 
 void krhino_mm_free(void *ptr)
 {
+#if (RHINO_CONFIG_MM_MAGAZINE > 0)
+    k_mm_mag_free(g_kmm_head, ptr);
+#else
     k_mm_free(g_kmm_head, ptr);
+#endif
 }
 
 void *krhino_mm_realloc(void *oldmem, size_t newsize)
@@ -856,6 +1323,10 @@ void *krhino_mm_realloc(void *oldmem, size_t newsize)
 
     tmp = k_mm_realloc(g_kmm_head, oldmem, newsize);
 
+#if (RHINO_CONFIG_MM_PROF > 0)
+    k_mm_prof_alloc(tmp, newsize, MM_RETADDR());
+#endif
+
 #if (RHINO_CONFIG_MM_DEBUG > 0u && RHINO_CONFIG_GCC_RETADDR > 0u)
     if (app_malloc == 0) {
 #if defined (__CC_ARM)
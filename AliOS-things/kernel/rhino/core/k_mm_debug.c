@@ -316,8 +316,8 @@ void print_block(k_mm_list_t *b)
     }
 
 #if (RHINO_CONFIG_MM_DEBUG > 0u)
-    print(" %8x ", b->dye);
-    print(" 0x%-8x ", b->owner);
+    print(" %8lx ", (unsigned long)b->dye);
+    print(" 0x%-8lx ", (unsigned long)b->owner);
 #endif
 
     if (b->buf_size & RHINO_MM_PREVFREE) {
@@ -336,7 +336,7 @@ void print_block(k_mm_list_t *b)
 void dump_kmm_free_map(k_mm_head *mmhead)
 {
     k_mm_list_t *next, *tmp;
-    int         i;
+    int         i, j;
 
     if (!mmhead) {
         return;
@@ -346,11 +346,13 @@ void dump_kmm_free_map(k_mm_head *mmhead)
     print("address,  stat   size     dye     caller   pre-stat    point\r\n");
 
     for (i = 0; i < MM_BIT_LEVEL; i++) {
-        next = mmhead->freelist[i];
-        while (next) {
-            print_block(next);
-            tmp = next->mbinfo.free_ptr.next;
-            next = tmp;
+        for (j = 0; j < MM_SL_NUM; j++) {
+            next = mmhead->freelist[i][j];
+            while (next) {
+                print_block(next);
+                tmp = next->mbinfo.free_ptr.next;
+                next = tmp;
+            }
         }
     }
 }
@@ -388,23 +390,48 @@ void dump_kmm_statistic_info(k_mm_head *mmhead)
 #if (K_MM_STATISTIC > 0)
     int i;
 #endif
+#if (K_MM_STATISTIC > 0 && RHINO_CONFIG_MM_MAGAZINE > 0)
+    int           cpu;
+    size_t        cached, hit, miss;
+    k_mm_mag_t   *mag;
+#endif
 
     if (!mmhead) {
         return;
     }
 #if (K_MM_STATISTIC > 0)
     print("     free     |     used     |     maxused\r\n");
-    print("  %10d  |  %10d  |  %10d\r\n", mmhead->free_size, mmhead->used_size,
-          mmhead->maxused_size);
+    print("  %10lu  |  %10lu  |  %10lu\r\n", (unsigned long)mmhead->free_size,
+          (unsigned long)mmhead->used_size, (unsigned long)mmhead->maxused_size);
     print("\r\n");
     print("-----------------alloc size statistic:-----------------\r\n");
     for (i = 0; i < MM_BIT_LEVEL; i++) {
         if (i % 4 == 0 && i != 0) {
             print("\r\n");
         }
-        print("[2^%02d] bytes: %5d   |", (i+MM_MIN_BIT), mmhead->mm_size_stats[i]);
+        print("[2^%02d] bytes: %5lu   |", (i+MM_MIN_BIT),
+              (unsigned long)mmhead->mm_size_stats[i]);
     }
     print("\r\n");
+#if (RHINO_CONFIG_MM_MAGAZINE > 0)
+    /* magazine hits are not counted in the alloc size statistic above */
+    print("\r\n");
+    print("-----------------magazine statistic:-----------------\r\n");
+    print("  max size  |  cached  |     hit     |    miss    | hit rate\r\n");
+    for (i = 0; i < RHINO_CONFIG_MM_MAGAZINE_LEVELS; i++) {
+        cached = hit = miss = 0;
+        for (cpu = 0; cpu < RHINO_CONFIG_CPU_NUM; cpu++) {
+            mag     = &mmhead->mag[cpu][i];
+            cached += mag->cnt;
+            hit    += mag->hit;
+            miss   += mag->miss;
+        }
+        print("  %8lu  | %8lu | %11lu | %10lu |  %3lu%%\r\n",
+              (unsigned long)MM_MAG_BUF_SIZE(i), (unsigned long)cached,
+              (unsigned long)hit, (unsigned long)miss,
+              (unsigned long)((hit + miss) ? (hit * 100 / (hit + miss)) : 0));
+    }
+#endif
 #endif
 }
 
@@ -416,7 +443,7 @@ uint32_t dumpsys_mm_info_func(char *buf, uint32_t len)
 
     print("\r\n");
     print("------------------------------- all memory blocks --------------------------------- \r\n");
-    print("g_kmm_head = %8x\r\n", (unsigned int)g_kmm_head);
+    print("g_kmm_head = %8p\r\n", (void *)g_kmm_head);
 
     dump_kmm_map(g_kmm_head);
     print("\r\n");
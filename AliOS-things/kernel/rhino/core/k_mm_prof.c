@@ -0,0 +1,443 @@
+/*
+ * Copyright (C) 2015-2017 Alibaba Group Holding Limited
+ */
+
+#include <k_api.h>
+#include <stdio.h>
+
+#if (RHINO_CONFIG_MM_PROF > 0)
+/*
+ * Sampling heap profiler: each cpu counts down the bytes krhino_mm_alloc()
+ * hands out and samples the blk that crosses zero, so the hot path is one
+ * subtraction. A sampled blk gets RHINO_MM_SAMPLED in its head and an entry
+ * in the live table, which is all k_mm_free() has to look at. The counters
+ * are kept per call site and task in a fixed table, unsampled on output.
+ */
+#define PROF_SITE_MASK  (RHINO_CONFIG_MM_PROF_SITES - 1u)
+#define PROF_LIVE_MASK  (RHINO_CONFIG_MM_PROF_LIVE - 1u)
+#define PROF_SITE_NONE  0xffffu
+
+typedef struct {
+    void    *ptr;
+    size_t   size;
+    uint16_t site;
+} prof_live_t;
+
+typedef struct {
+    size_t           rate;   /* 0 stopped */
+    uint32_t         seed;
+    long             left[RHINO_CONFIG_CPU_NUM];  /* bytes to the next sample */
+    uint32_t         live_num;
+    size_t           lost;   /* samples dropped on a full table */
+    k_mm_prof_site_t site[RHINO_CONFIG_MM_PROF_SITES];
+    prof_live_t      live[RHINO_CONFIG_MM_PROF_LIVE];
+} prof_t;
+
+static prof_t g_prof;
+
+static uint32_t prof_hash(size_t key)
+{
+    return (uint32_t)((key ^ (key >> 16)) * 0x9e3779b1u);
+}
+
+/* exponential intervals of mean rate, which the pprof unsampling assumes:
+   -ln(u) = ln2 * (32 - log2(u * 2^32)), log2(1 + f) ~ f + 0.343 * f * (1 - f)
+   in 16.16 fixed point */
+static long prof_interval(size_t rate)
+{
+    uint32_t r;
+    uint32_t msb;
+    uint32_t frac;
+    uint32_t log2_fix;
+    uint64_t interval;
+
+    g_prof.seed = g_prof.seed * 1664525u + 1013904223u;
+    r   = g_prof.seed | 1u;
+    msb = 31u - krhino_clz32(r);
+
+    frac     = ((r << (31u - msb)) & 0x7fffffffu) >> 15;
+    frac    += (((frac * (65536u - frac)) >> 16) * 22479u) >> 16;
+    log2_fix = (msb << 16) + frac;
+    interval = ((uint64_t)rate * ((32u << 16) - log2_fix) * 45426u) >> 32;
+
+    return interval > 0 ? (long)interval : 1;
+}
+
+static uint16_t prof_site_find(size_t site, const name_t *task)
+{
+    k_mm_prof_site_t *entry;
+    uint32_t          idx;
+    uint32_t          i;
+
+    idx = prof_hash(site ^ (size_t)task);
+
+    for (i = 0; i < RHINO_CONFIG_MM_PROF_SITES; i++, idx++) {
+        entry = &g_prof.site[idx & PROF_SITE_MASK];
+        if (entry->site == site && entry->task == task) {
+            return (uint16_t)(idx & PROF_SITE_MASK);
+        }
+        if (entry->site == 0u) {
+            entry->site = site;
+            entry->task = task;
+            return (uint16_t)(idx & PROF_SITE_MASK);
+        }
+    }
+
+    return PROF_SITE_NONE;
+}
+
+static prof_live_t *prof_live_find(void *ptr)
+{
+    prof_live_t *live;
+    uint32_t     idx;
+    uint32_t     i;
+
+    idx = prof_hash((size_t)ptr);
+
+    for (i = 0; i < RHINO_CONFIG_MM_PROF_LIVE; i++, idx++) {
+        live = &g_prof.live[idx & PROF_LIVE_MASK];
+        if (live->ptr == ptr || live->ptr == NULL) {
+            return live;
+        }
+    }
+
+    return NULL;
+}
+
+/* linear probing, pull the following entries back over the hole */
+static void prof_live_del(prof_live_t *live)
+{
+    uint32_t hole;
+    uint32_t idx;
+    uint32_t home;
+
+    hole = (uint32_t)(live - g_prof.live);
+    idx  = hole;
+
+    while (1) {
+        idx = (idx + 1u) & PROF_LIVE_MASK;
+        if (g_prof.live[idx].ptr == NULL) {
+            break;
+        }
+
+        home = prof_hash((size_t)g_prof.live[idx].ptr) & PROF_LIVE_MASK;
+        /* the entry can move if its home is not within (hole, idx] */
+        if (((idx - home) & PROF_LIVE_MASK) >= ((idx - hole) & PROF_LIVE_MASK)) {
+            g_prof.live[hole] = g_prof.live[idx];
+            hole = idx;
+        }
+    }
+
+    g_prof.live[hole].ptr = NULL;
+    g_prof.live_num--;
+}
+
+static void prof_site_add(k_mm_prof_site_t *entry, size_t size)
+{
+    entry->live_cnt++;
+    entry->live_size += size;
+    entry->alloc_cnt++;
+    entry->alloc_size += size;
+    if (entry->live_size > entry->peak_size) {
+        entry->peak_size = entry->live_size;
+    }
+}
+
+static void prof_site_sub(k_mm_prof_site_t *entry, size_t size, uint8_t all)
+{
+    entry->live_cnt--;
+    entry->live_size -= size;
+    if (all == RHINO_TRUE) {
+        entry->alloc_cnt--;
+        entry->alloc_size -= size;
+    }
+}
+
+static void prof_sample(void *ptr, size_t size, size_t site)
+{
+    k_mm_list_t  *blk;
+    prof_live_t  *live;
+    const name_t *task;
+    uint16_t      idx;
+    uint8_t       cur_cpu_num;
+    CPSR_ALLOC();
+
+    RHINO_CRITICAL_ENTER();
+
+    cur_cpu_num = cpu_cur_get();
+
+    if (g_prof.rate == 0u) {
+        RHINO_CRITICAL_EXIT();
+        return;
+    }
+
+    /* blks of the fixed size pool have no head to mark, the next one
+       counts instead */
+    if (MM_IS_FIXEDBLK(g_kmm_head, ptr)) {
+        g_prof.left[cur_cpu_num] = 0;
+        RHINO_CRITICAL_EXIT();
+        return;
+    }
+
+    g_prof.left[cur_cpu_num] = prof_interval(g_prof.rate);
+
+    blk  = MM_GET_THIS_BLK(ptr);
+    task = g_active_task[cur_cpu_num] != NULL ? g_active_task[cur_cpu_num]->task_name : NULL;
+    if (g_intrpt_nested_level[cur_cpu_num] > 0u) {
+        task = NULL;
+    }
+
+    live = NULL;
+    idx  = PROF_SITE_NONE;
+
+    /* keep the live table at most 3/4 full */
+    if (g_prof.live_num < RHINO_CONFIG_MM_PROF_LIVE - RHINO_CONFIG_MM_PROF_LIVE / 4u) {
+        live = prof_live_find(ptr);
+        idx  = prof_site_find(site, task);
+    }
+
+    if (live == NULL || live->ptr != NULL || idx == PROF_SITE_NONE) {
+        g_prof.lost++;
+        RHINO_CRITICAL_EXIT();
+        return;
+    }
+
+    live->ptr  = ptr;
+    live->size = size;
+    live->site = idx;
+    g_prof.live_num++;
+
+    prof_site_add(&g_prof.site[idx], size);
+
+    blk->buf_size |= RHINO_MM_SAMPLED;
+
+    RHINO_CRITICAL_EXIT();
+}
+
+void k_mm_prof_alloc(void *ptr, size_t size, size_t site)
+{
+    uint8_t cur_cpu_num;
+
+    if (ptr == NULL || g_prof.rate == 0u) {
+        return;
+    }
+
+    /* a race with a task moved to another cpu only shifts one sample */
+    cur_cpu_num = cpu_cur_get();
+    g_prof.left[cur_cpu_num] -= (long)size;
+    if (g_prof.left[cur_cpu_num] > 0) {
+        return;
+    }
+
+    prof_sample(ptr, size, site);
+}
+
+void k_mm_prof_free(void *ptr)
+{
+    k_mm_list_t *blk;
+    prof_live_t *live;
+    CPSR_ALLOC();
+
+    blk = MM_GET_THIS_BLK(ptr);
+
+    RHINO_CRITICAL_ENTER();
+
+    live = prof_live_find(ptr);
+    if (live != NULL && live->ptr == ptr) {
+        prof_site_sub(&g_prof.site[live->site], live->size, RHINO_FALSE);
+        prof_live_del(live);
+    }
+
+    blk->buf_size &= ~RHINO_MM_SAMPLED;
+
+    RHINO_CRITICAL_EXIT();
+}
+
+kstat_t krhino_mm_prof_start(size_t rate)
+{
+    uint8_t i;
+    CPSR_ALLOC();
+
+    if (rate == 0u) {
+        rate = RHINO_CONFIG_MM_PROF_RATE;
+    }
+
+    RHINO_CRITICAL_ENTER();
+
+    if (g_prof.seed == 0u) {
+        g_prof.seed = (uint32_t)(size_t)&g_prof ^ (uint32_t)g_tick_count;
+    }
+
+    g_prof.rate = rate;
+    for (i = 0; i < RHINO_CONFIG_CPU_NUM; i++) {
+        g_prof.left[i] = prof_interval(rate);
+    }
+
+    RHINO_CRITICAL_EXIT();
+
+    return RHINO_SUCCESS;
+}
+
+kstat_t krhino_mm_prof_stop(void)
+{
+    CPSR_ALLOC();
+
+    RHINO_CRITICAL_ENTER();
+    g_prof.rate = 0u;
+    RHINO_CRITICAL_EXIT();
+
+    return RHINO_SUCCESS;
+}
+
+kstat_t krhino_mm_prof_reset(void)
+{
+    k_mm_prof_site_t *entry;
+    uint32_t          i;
+    CPSR_ALLOC();
+
+    RHINO_CRITICAL_ENTER();
+
+    for (i = 0; i < RHINO_CONFIG_MM_PROF_SITES; i++) {
+        entry = &g_prof.site[i];
+        entry->alloc_cnt  = entry->live_cnt;
+        entry->alloc_size = entry->live_size;
+        entry->peak_size  = entry->live_size;
+    }
+
+    g_prof.lost = 0u;
+
+    RHINO_CRITICAL_EXIT();
+
+    return RHINO_SUCCESS;
+}
+
+void krhino_mm_prof_site_set(void *ptr, size_t site)
+{
+    k_mm_prof_site_t *entry;
+    prof_live_t      *live;
+    uint16_t          idx;
+    CPSR_ALLOC();
+
+    if (ptr == NULL || MM_IS_FIXEDBLK(g_kmm_head, ptr)) {
+        return;
+    }
+
+    if ((MM_GET_THIS_BLK(ptr)->buf_size & RHINO_MM_SAMPLED) == 0u) {
+        return;
+    }
+
+    RHINO_CRITICAL_ENTER();
+
+    live = prof_live_find(ptr);
+    if (live != NULL && live->ptr == ptr) {
+        entry = &g_prof.site[live->site];
+        idx   = prof_site_find(site, entry->task);
+        if (idx != PROF_SITE_NONE && idx != live->site) {
+            prof_site_sub(entry, live->size, RHINO_TRUE);
+            prof_site_add(&g_prof.site[idx], live->size);
+            live->site = idx;
+        }
+    }
+
+    RHINO_CRITICAL_EXIT();
+}
+
+uint32_t krhino_mm_prof_sites_get(k_mm_prof_site_t *sites, uint32_t num, size_t *rate)
+{
+    uint32_t i;
+    uint32_t cnt;
+    CPSR_ALLOC();
+
+    if (rate != NULL) {
+        *rate = g_prof.rate;
+    }
+
+    if (sites == NULL) {
+        return 0u;
+    }
+
+    cnt = 0u;
+
+    for (i = 0; i < RHINO_CONFIG_MM_PROF_SITES && cnt < num; i++) {
+        RHINO_CRITICAL_ENTER();
+        if (g_prof.site[i].site != 0u) {
+            sites[cnt++] = g_prof.site[i];
+        }
+        RHINO_CRITICAL_EXIT();
+    }
+
+    return cnt;
+}
+
+/* pprof scales by 1 / (1 - exp(-avg / rate)), per blk that is close to
+   rate + avg / 2 below rate and avg + rate^2 / (2 * avg) above */
+size_t krhino_mm_prof_unsample(size_t cnt, size_t size, size_t rate)
+{
+    uint64_t avg;
+
+    if (cnt == 0u || rate == 0u) {
+        return size;
+    }
+
+    avg = size / cnt;
+    if (avg < rate) {
+        return (size_t)(cnt * (rate + avg / 2u));
+    }
+
+    return (size_t)(cnt * (avg + (uint64_t)rate * rate / (2u * avg)));
+}
+
+size_t krhino_mm_prof_pprof(char *buf, size_t len)
+{
+    k_mm_prof_site_t entry;
+    size_t           live_cnt, live_size, alloc_cnt, alloc_size;
+    size_t           rate;
+    size_t           off;
+    uint32_t         i;
+    int              ret;
+    CPSR_ALLOC();
+
+    live_cnt = live_size = alloc_cnt = alloc_size = 0u;
+
+    RHINO_CRITICAL_ENTER();
+    for (i = 0; i < RHINO_CONFIG_MM_PROF_SITES; i++) {
+        live_cnt   += g_prof.site[i].live_cnt;
+        live_size  += g_prof.site[i].live_size;
+        alloc_cnt  += g_prof.site[i].alloc_cnt;
+        alloc_size += g_prof.site[i].alloc_size;
+    }
+    rate = g_prof.rate;
+    RHINO_CRITICAL_EXIT();
+
+    if (rate == 0u) {
+        rate = RHINO_CONFIG_MM_PROF_RATE;
+    }
+
+    off = 0u;
+
+    ret = snprintf(buf, len, "heap profile: %lu: %lu [%lu: %lu] @ heap_v2/%lu\n",
+                   (unsigned long)live_cnt, (unsigned long)live_size,
+                   (unsigned long)alloc_cnt, (unsigned long)alloc_size,
+                   (unsigned long)rate);
+    off += ret > 0 ? (size_t)ret : 0u;
+
+    for (i = 0; i < RHINO_CONFIG_MM_PROF_SITES; i++) {
+        RHINO_CRITICAL_ENTER();
+        entry = g_prof.site[i];
+        RHINO_CRITICAL_EXIT();
+
+        if (entry.site == 0u) {
+            continue;
+        }
+
+        ret = snprintf(off < len ? buf + off : NULL, off < len ? len - off : 0u,
+                       "%lu: %lu [%lu: %lu] @ 0x%lx\n",
+                       (unsigned long)entry.live_cnt, (unsigned long)entry.live_size,
+                       (unsigned long)entry.alloc_cnt, (unsigned long)entry.alloc_size,
+                       (unsigned long)entry.site);
+        off += ret > 0 ? (size_t)ret : 0u;
+    }
+
+    return off;
+}
+#endif
@@ -0,0 +1,267 @@
+/*
+ * Copyright (C) 2015-2017 Alibaba Group Holding Limited
+ */
+
+#include <k_api.h>
+
+#if (RHINO_CONFIG_MM_SLAB > 0)
+
+#define SLAB_PAGE_GET(obj)  ((k_slab_page_t *)((size_t)(obj) & ~SLAB_PAGE_MASK))
+
+static k_slab_cache_t g_slab_class[SLAB_CLASS_NUM];
+
+static const name_t *const g_slab_class_name[SLAB_CLASS_NUM] = {
+    "slab_16", "slab_32", "slab_64", "slab_128", "slab_256", "slab_512"
+};
+
+static k_slab_page_t *slab_page_new(k_slab_cache_t *cache)
+{
+    k_slab_page_t *page;
+    kstat_t        stat;
+
+    page = k_mm_alloc_aligned(g_kmm_head, RHINO_CONFIG_MM_SLAB_PAGE_SIZE,
+                              RHINO_CONFIG_MM_SLAB_PAGE_SIZE);
+    if (page == NULL) {
+        return NULL;
+    }
+
+    stat = krhino_mblk_pool_init(&page->pool, cache->name,
+                                 (uint8_t *)page + SLAB_PAGE_HEAD_SIZE, cache->obj_size,
+                                 RHINO_CONFIG_MM_SLAB_PAGE_SIZE - SLAB_PAGE_HEAD_SIZE);
+    if (stat != RHINO_SUCCESS) {
+        k_mm_free(g_kmm_head, page);
+        return NULL;
+    }
+
+    page->cache = cache;
+
+    return page;
+}
+
+static void slab_page_free(k_slab_page_t *page)
+{
+#if (RHINO_CONFIG_SYSTEM_STATS > 0)
+    CPSR_ALLOC();
+
+    RHINO_CRITICAL_ENTER();
+    klist_rm(&page->pool.mblkpool_stats_item);
+    RHINO_CRITICAL_EXIT();
+#endif
+
+    k_mm_free(g_kmm_head, page);
+}
+
+kstat_t krhino_slab_cache_init(k_slab_cache_t *cache, const name_t *name,
+                               size_t obj_size, slab_ctor_t ctor)
+{
+    NULL_PARA_CHK(cache);
+    NULL_PARA_CHK(name);
+
+    obj_size = MM_ALIGN_UP(obj_size);
+
+    /* a page holds two objects at least */
+    if (obj_size == 0u ||
+        obj_size > (RHINO_CONFIG_MM_SLAB_PAGE_SIZE - SLAB_PAGE_HEAD_SIZE) / 2u) {
+        return RHINO_INV_PARAM;
+    }
+
+    memset(cache, 0, sizeof(k_slab_cache_t));
+
+    cache->name     = name;
+    cache->obj_size = obj_size;
+    cache->ctor     = ctor;
+
+    klist_init(&cache->partial_list);
+    klist_init(&cache->full_list);
+
+    return RHINO_SUCCESS;
+}
+
+kstat_t krhino_slab_cache_del(k_slab_cache_t *cache)
+{
+    CPSR_ALLOC();
+
+    k_slab_page_t *page;
+
+    NULL_PARA_CHK(cache);
+
+    RHINO_CRITICAL_ENTER();
+
+    if (cache->obj_inuse > 0u) {
+        RHINO_CRITICAL_EXIT();
+        return RHINO_KOBJ_DEL_ERR;
+    }
+
+    while (!is_klist_empty(&cache->partial_list)) {
+        page = krhino_list_entry(cache->partial_list.next, k_slab_page_t, page_list);
+        klist_rm(&page->page_list);
+        cache->page_num--;
+        cache->page_empty--;
+        RHINO_CRITICAL_EXIT();
+
+        slab_page_free(page);
+
+        RHINO_CRITICAL_ENTER();
+    }
+
+    RHINO_CRITICAL_EXIT();
+
+    return RHINO_SUCCESS;
+}
+
+void *krhino_slab_cache_alloc(k_slab_cache_t *cache)
+{
+    CPSR_ALLOC();
+
+    k_slab_page_t *page;
+    void          *obj;
+
+    if (cache == NULL) {
+        return NULL;
+    }
+
+    RHINO_CRITICAL_ENTER();
+
+    if (is_klist_empty(&cache->partial_list)) {
+        /* grow outside the critical section, the heap may take its mutex */
+        RHINO_CRITICAL_EXIT();
+
+        page = slab_page_new(cache);
+        if (page == NULL) {
+            return NULL;
+        }
+
+        RHINO_CRITICAL_ENTER();
+
+        klist_insert(&cache->partial_list, &page->page_list);
+        cache->page_num++;
+        cache->page_empty++;
+    }
+
+    page = krhino_list_entry(cache->partial_list.next, k_slab_page_t, page_list);
+
+    if (page->pool.blk_avail == page->pool.blk_whole) {
+        cache->page_empty--;
+    }
+
+    krhino_mblk_alloc(&page->pool, &obj);
+
+    if (page->pool.blk_avail == 0u) {
+        klist_rm(&page->page_list);
+        klist_insert(&cache->full_list, &page->page_list);
+    }
+
+    cache->obj_inuse++;
+
+    RHINO_CRITICAL_EXIT();
+
+    if (cache->ctor != NULL) {
+        cache->ctor(obj);
+    }
+
+    return obj;
+}
+
+void *krhino_slab_alloc(size_t size)
+{
+    int32_t idx;
+
+    if (size == 0u || size > (1u << SLAB_MAX_BIT)) {
+        return NULL;
+    }
+
+    if (size <= (1u << SLAB_MIN_BIT)) {
+        idx = 0;
+    } else {
+        /* round up to the next power of 2 */
+        idx = 32 - krhino_clz32((uint32_t)size - 1u) - SLAB_MIN_BIT;
+    }
+
+    return krhino_slab_cache_alloc(&g_slab_class[idx]);
+}
+
+kstat_t krhino_slab_free(void *obj)
+{
+    CPSR_ALLOC();
+
+    k_slab_page_t  *page;
+    k_slab_cache_t *cache;
+    uint8_t         release;
+
+    NULL_PARA_CHK(obj);
+
+    page  = SLAB_PAGE_GET(obj);
+    cache = page->cache;
+
+    if ((uint8_t *)obj < (uint8_t *)page + SLAB_PAGE_HEAD_SIZE || cache == NULL) {
+        return RHINO_INV_PARAM;
+    }
+
+    release = RHINO_FALSE;
+
+    RHINO_CRITICAL_ENTER();
+
+    /* a page in use goes in front of the empty one */
+    if (page->pool.blk_avail == 0u) {
+        klist_rm(&page->page_list);
+        klist_insert(cache->partial_list.next, &page->page_list);
+    }
+
+    krhino_mblk_free(&page->pool, obj);
+    cache->obj_inuse--;
+
+    /* keep a few empty pages so a burst at a page boundary does not bounce
+       pages in and out of the heap, and move them behind the used pages */
+    if (page->pool.blk_avail == page->pool.blk_whole) {
+        klist_rm(&page->page_list);
+
+        if (cache->page_empty >= RHINO_CONFIG_MM_SLAB_EMPTY_PAGES) {
+            cache->page_num--;
+            release = RHINO_TRUE;
+        } else {
+            klist_insert(&cache->partial_list, &page->page_list);
+            cache->page_empty++;
+        }
+    }
+
+    RHINO_CRITICAL_EXIT();
+
+    if (release == RHINO_TRUE) {
+        slab_page_free(page);
+    }
+
+    return RHINO_SUCCESS;
+}
+
+#if (RHINO_CONFIG_KOBJ_DYN_ALLOC > 0)
+static void slab_kobj_cache_init(k_slab_cache_t *cache, const name_t *name, size_t size)
+{
+    /* a kernel object larger than half a page needs a bigger page */
+    if (krhino_slab_cache_init(cache, name, size, NULL) != RHINO_SUCCESS) {
+        k_err_proc(RHINO_SYS_FATAL_ERR);
+    }
+}
+#endif
+
+void k_mm_slab_init(void)
+{
+    uint8_t i;
+
+    for (i = 0; i < SLAB_CLASS_NUM; i++) {
+        krhino_slab_cache_init(&g_slab_class[i], g_slab_class_name[i],
+                               (size_t)1u << (i + SLAB_MIN_BIT), NULL);
+    }
+
+#if (RHINO_CONFIG_KOBJ_DYN_ALLOC > 0)
+    slab_kobj_cache_init(&g_slab_task, "slab_task", sizeof(ktask_t));
+#if (RHINO_CONFIG_SEM > 0)
+    slab_kobj_cache_init(&g_slab_sem, "slab_sem", sizeof(ksem_t));
+#endif
+    slab_kobj_cache_init(&g_slab_mutex, "slab_mutex", sizeof(kmutex_t));
+#if (RHINO_CONFIG_TIMER > 0)
+    slab_kobj_cache_init(&g_slab_timer, "slab_timer", sizeof(ktimer_t));
+#endif
+#endif
+}
+#endif /* RHINO_CONFIG_MM_SLAB */
+
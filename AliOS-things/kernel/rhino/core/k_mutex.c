@@ -114,14 +114,14 @@ kstat_t krhino_mutex_dyn_create(kmutex_t **mutex, const name_t *name)
 
     NULL_PARA_CHK(mutex);
 
-    mutex_obj = krhino_mm_alloc(sizeof(kmutex_t));
+    mutex_obj = KOBJ_DYN_ALLOC(g_slab_mutex, kmutex_t);
     if (mutex_obj == NULL) {
         return RHINO_NO_MEM;
     }
 
     stat = mutex_create(mutex_obj, name, K_OBJ_DYN_ALLOC);
     if (stat != RHINO_SUCCESS) {
-        krhino_mm_free(mutex_obj);
+        KOBJ_DYN_FREE(mutex_obj);
         return stat;
     }
 
@@ -177,7 +177,7 @@ kstat_t krhino_mutex_dyn_del(kmutex_t *mutex)
 
     RHINO_CRITICAL_EXIT_SCHED();
 
-    krhino_mm_free(mutex);
+    KOBJ_DYN_FREE(mutex);
 
     return RHINO_SUCCESS;
 }
@@ -7,7 +7,11 @@
 kstat_t      g_sys_stat;
 uint8_t      g_idle_task_spawned[RHINO_CONFIG_CPU_NUM];
 
+#if (RHINO_CONFIG_CPU_NUM > 1)
+runqueue_t   g_ready_queue[RHINO_CONFIG_CPU_NUM];
+#else
 runqueue_t   g_ready_queue; /*  */
+#endif
 
 /* schedule lock counter */
 uint8_t      g_sched_lock[RHINO_CONFIG_CPU_NUM]; /* ص */
@@ -26,14 +30,22 @@ cpu_stack_t  g_idle_task_stack[RHINO_CONFIG_CPU_NUM][RHINO_CONFIG_IDLE_TASK_STAC
 
 /* tick attribute */
 tick_t       g_tick_count; /* tick */
+#if (RHINO_CONFIG_TICK_WHEEL > 0)
+k_tick_wheel_t g_tick_wheel;
+#else
 klist_t      g_tick_head; /* ˯/ */
+#endif
 
 #if (RHINO_CONFIG_SYSTEM_STATS > 0)
 kobj_list_t  g_kobj_list; /* Уͳʹ */
 #endif
 
 #if (RHINO_CONFIG_TIMER > 0)
+#if (RHINO_CONFIG_TICK_WHEEL > 0)
+k_tick_wheel_t   g_timer_wheel;
+#else
 klist_t          g_timer_head;
+#endif
 sys_time_t       g_timer_count;
 ktask_t          g_timer_task;
 cpu_stack_t      g_timer_task_stack[RHINO_CONFIG_TIMER_TASK_STACK_SIZE];
@@ -89,3 +101,10 @@ k_mm_head    *g_kmm_head;
 
 #endif
 
+#if (RHINO_CONFIG_MM_SLAB > 0 && RHINO_CONFIG_KOBJ_DYN_ALLOC > 0)
+k_slab_cache_t g_slab_task;
+k_slab_cache_t g_slab_sem;
+k_slab_cache_t g_slab_mutex;
+k_slab_cache_t g_slab_timer;
+#endif
+
@@ -27,7 +27,7 @@ void pend_task_wakeup(ktask_t *task)
             /* remove task on the block list because task is waken up */
             klist_rm(&task->task_list);
             /* add to the ready list again */
-            ready_list_add(&g_ready_queue, task);
+            ready_list_add(task_rq(task), task);
             task->task_state = K_RDY;
             break;
         case K_PEND_SUSPENDED:
@@ -59,7 +59,7 @@ void pend_to_blk_obj(blk_obj_t *blk_obj, ktask_t *task, tick_t timeout)
     task->task_state = K_PEND;
 
     /* remove from the ready list */
-    ready_list_rm(&g_ready_queue, task);
+    ready_list_rm(task_rq(task), task);
 
     if (blk_obj->blk_policy == BLK_POLICY_FIFO) {
         /* add to the end of blocked objet list */
@@ -77,7 +77,7 @@ void pend_task_rm(ktask_t *task)
             /* remove task on the block list because task is waken up */
             klist_rm(&task->task_list);
             /*add to the ready list again*/
-            ready_list_add(&g_ready_queue, task);
+            ready_list_add(task_rq(task), task);
             task->task_state = K_RDY;
             break;
         case K_PEND_SUSPENDED:
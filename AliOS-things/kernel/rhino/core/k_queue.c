@@ -47,6 +47,8 @@ static kstat_t queue_create(kqueue_t *queue, const name_t *name, void **start,
 
     queue->blk_obj.obj_type = RHINO_QUEUE_OBJ_TYPE; /* ¼ */
 
+    TRACE_QUEUE_CREATE(krhino_cur_task_get(), queue);
+
     return RHINO_SUCCESS;
 }
 
@@ -223,10 +225,16 @@ static kstat_t msg_send(kqueue_t *p_q, void *p_void, uint8_t opt_wake_all)
     /* wake all the task blocked on this queue */
     if (opt_wake_all) { /* ѴϢ͸񣬲 */
         while (!is_klist_empty(blk_list_head)) {
+            TRACE_QUEUE_TASK_WAKE(g_active_task[cpu_cur_get()],
+                                  krhino_list_entry(blk_list_head->next, ktask_t, task_list),
+                                  p_q);
             task_msg_recv(krhino_list_entry(blk_list_head->next, ktask_t, task_list),
                           p_void);
         }
     } else { /* ֻһ */
+        TRACE_QUEUE_TASK_WAKE(g_active_task[cpu_cur_get()],
+                              krhino_list_entry(blk_list_head->next, ktask_t, task_list),
+                              p_q);
         task_msg_recv(krhino_list_entry(blk_list_head->next, ktask_t, task_list),
                       p_void);
     }
@@ -246,6 +254,75 @@ kstat_t krhino_queue_all_send(kqueue_t *queue, void *msg)
     return msg_send(queue, msg, WAKE_ALL_TASK);
 }
 
+kstat_t krhino_queue_back_send_batch(kqueue_t *queue, void **msg, size_t num,
+                                     size_t *sent)
+{
+    CPSR_ALLOC();
+
+    klist_t *blk_list_head;
+    size_t   woken;
+    size_t   cnt;
+
+    NULL_PARA_CHK(queue);
+    NULL_PARA_CHK(msg);
+    NULL_PARA_CHK(sent);
+
+    *sent = 0u;
+
+    if (num == 0u) {
+        return RHINO_INV_PARAM;
+    }
+
+    /* this is only needed when system zero interrupt feature is enabled */
+#if (RHINO_CONFIG_INTRPT_GUARD > 0)
+    soc_intrpt_guard();
+#endif
+
+    RHINO_CRITICAL_ENTER();
+
+    if (queue->blk_obj.obj_type != RHINO_QUEUE_OBJ_TYPE) {
+        RHINO_CRITICAL_EXIT();
+        return RHINO_KOBJ_TYPE_ERR;
+    }
+
+    blk_list_head = &queue->blk_obj.blk_list;
+    cnt           = 0u;
+
+    /* receivers only block on an empty queue, hand each one msg in order */
+    while ((cnt < num) && !is_klist_empty(blk_list_head)) {
+        TRACE_QUEUE_TASK_WAKE(g_active_task[cpu_cur_get()],
+                              krhino_list_entry(blk_list_head->next, ktask_t, task_list),
+                              queue);
+        task_msg_recv(krhino_list_entry(blk_list_head->next, ktask_t, task_list),
+                      msg[cnt]);
+        cnt++;
+    }
+
+    woken = cnt;
+
+    while ((cnt < num) && (queue->msg_q.cur_num < queue->msg_q.size)) {
+        ringbuf_push(&queue->ringbuf, &msg[cnt], sizeof(void *));
+        queue->msg_q.cur_num++;
+        cnt++;
+    }
+
+    /* update peak_num for debug */
+    if (queue->msg_q.cur_num > queue->msg_q.peak_num) {
+        queue->msg_q.peak_num = queue->msg_q.cur_num;
+    }
+
+    *sent = cnt;
+
+    /* one reschedule for the whole batch */
+    if (woken > 0u) {
+        RHINO_CRITICAL_EXIT_SCHED();
+    } else {
+        RHINO_CRITICAL_EXIT();
+    }
+
+    return (cnt == num) ? RHINO_SUCCESS : RHINO_QUEUE_FULL;
+}
+
 kstat_t krhino_queue_recv(kqueue_t *queue, tick_t ticks, void **msg)
 { /* ӶнϢʱѡ */
     CPSR_ALLOC();
@@ -295,6 +372,8 @@ kstat_t krhino_queue_recv(kqueue_t *queue, tick_t ticks, void **msg)
         RHINO_CRITICAL_EXIT();
         return RHINO_SCHED_DISABLE;
     }
+
+    TRACE_QUEUE_GET_BLK(g_active_task[cur_cpu_num], queue, ticks);
     /* ǰ */
     pend_to_blk_obj((blk_obj_t *)queue, g_active_task[cur_cpu_num], ticks);
     /* лĽ */
@@ -320,6 +399,96 @@ kstat_t krhino_queue_recv(kqueue_t *queue, tick_t ticks, void **msg)
     return ret;
 }
 
+static size_t queue_msg_pop(kqueue_t *queue, void **msg, size_t num)
+{
+    size_t cnt;
+
+    for (cnt = 0u; (cnt < num) && (queue->msg_q.cur_num > 0u); cnt++) {
+        ringbuf_pop(&queue->ringbuf, &msg[cnt], NULL);
+        queue->msg_q.cur_num--;
+    }
+
+    return cnt;
+}
+
+kstat_t krhino_queue_recv_batch(kqueue_t *queue, tick_t ticks, void **msg,
+                                size_t num, size_t *recved)
+{
+    CPSR_ALLOC();
+
+    kstat_t  ret;
+    uint8_t  cur_cpu_num;
+    ktask_t *task;
+
+    NULL_PARA_CHK(queue);
+    NULL_PARA_CHK(msg);
+    NULL_PARA_CHK(recved);
+
+    *recved = 0u;
+
+    if (num == 0u) {
+        return RHINO_INV_PARAM;
+    }
+
+    RHINO_CRITICAL_ENTER();
+
+    cur_cpu_num = cpu_cur_get();
+
+    if ((g_intrpt_nested_level[cur_cpu_num] > 0u) && (ticks != RHINO_NO_WAIT)) {
+        RHINO_CRITICAL_EXIT();
+        return RHINO_NOT_CALLED_BY_INTRPT;
+    }
+
+    if (queue->blk_obj.obj_type != RHINO_QUEUE_OBJ_TYPE) {
+        RHINO_CRITICAL_EXIT();
+        return RHINO_KOBJ_TYPE_ERR;
+    }
+
+    if (queue->msg_q.cur_num > 0u) {
+        *recved = queue_msg_pop(queue, msg, num);
+        RHINO_CRITICAL_EXIT();
+        return RHINO_SUCCESS;
+    }
+
+    if (ticks == RHINO_NO_WAIT) {
+        RHINO_CRITICAL_EXIT();
+        return RHINO_NO_PEND_WAIT;
+    }
+
+    /* if system is locked, block operation is not allowed */
+    if (g_sched_lock[cur_cpu_num] > 0u) {
+        RHINO_CRITICAL_EXIT();
+        return RHINO_SCHED_DISABLE;
+    }
+
+    TRACE_QUEUE_GET_BLK(g_active_task[cur_cpu_num], queue, ticks);
+
+    pend_to_blk_obj((blk_obj_t *)queue, g_active_task[cur_cpu_num], ticks);
+
+    RHINO_CRITICAL_EXIT_SCHED();
+
+    RHINO_CPU_INTRPT_DISABLE();
+
+    cur_cpu_num = cpu_cur_get();
+    task        = g_active_task[cur_cpu_num];
+
+    ret = pend_state_end_proc(task);
+
+    if (ret == RHINO_SUCCESS) {
+        msg[0]  = task->msg;
+        *recved = 1u;
+
+        /* a batch sender queues the rest behind the msg handed over */
+        if (queue->blk_obj.obj_type == RHINO_QUEUE_OBJ_TYPE) {
+            *recved += queue_msg_pop(queue, &msg[1], num - 1u);
+        }
+    }
+
+    RHINO_CPU_INTRPT_ENABLE();
+
+    return ret;
+}
+
 kstat_t krhino_queue_is_full(kqueue_t *queue)
 { /* ж϶Ƿ */
     CPSR_ALLOC();
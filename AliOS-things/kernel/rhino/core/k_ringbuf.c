@@ -17,7 +17,7 @@ kstat_t ringbuf_init(k_ringbuf_t *p_ringbuf, void *buf, size_t len, size_t type,
     return RHINO_SUCCESS;
 
 }
-static size_t ringbuf_headlen_compress(size_t head_len, uint8_t *cmp_buf)
+size_t ringbuf_headlen_compress(size_t head_len, uint8_t *cmp_buf)
 { /* ĸֽڵϢѹ1-3ֽ */
     size_t   len_bytes = 0;
     uint8_t *p_len   = NULL;
@@ -41,7 +41,7 @@ static size_t ringbuf_headlen_compress(size_t head_len, uint8_t *cmp_buf)
     return len_bytes; /* (1,3] */
 }
 
-static size_t ringbuf_headlen_decompress(size_t buf_len, uint8_t *cmp_buf)
+size_t ringbuf_headlen_decompress(size_t buf_len, uint8_t *cmp_buf)
 {
     size_t   data_len = 0;
     uint32_t be_len   = 0;
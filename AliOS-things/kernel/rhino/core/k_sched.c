@@ -84,6 +84,12 @@ kstat_t krhino_sched_enable(void)
 }
 
 #if (RHINO_CONFIG_CPU_NUM > 1)
+static void sched_ipi_send(uint8_t cpu_num)
+{
+    cpu_rq(cpu_num)->stats.ipi_cnt++;
+    cpu_signal(cpu_num);
+}
+
 void core_sched(void)
 {
     uint8_t cur_cpu_num;
@@ -98,7 +104,7 @@ void core_sched(void)
         return;
     }
 
-    preferred_cpu_ready_task_get(&g_ready_queue, cur_cpu_num);
+    preferred_cpu_ready_task_get(cpu_rq(cur_cpu_num), cur_cpu_num);
 
     /* if preferred task is currently task, then no need to do switch and just return */
     if (g_preferred_ready_task[cur_cpu_num] == g_active_task[cur_cpu_num]) {
@@ -113,6 +119,12 @@ void core_sched(void)
 
     g_active_task[cur_cpu_num]->cur_exc = 0;
 
+    /* a task bound away while running may start on its new cpu once switched out */
+    if ((g_active_task[cur_cpu_num]->cpu_num != cur_cpu_num)
+        && (g_active_task[cur_cpu_num]->task_state == K_RDY)) {
+        sched_ipi_send(g_active_task[cur_cpu_num]->cpu_num);
+    }
+
     cpu_task_switch();
 
 }
@@ -137,7 +149,7 @@ void core_sched(void)
     }
 
     /* Ѹݵ㷨ȳ浽g_prefered_ready_task */
-    preferred_cpu_ready_task_get(&g_ready_queue, cur_cpu_num); 
+    preferred_cpu_ready_task_get(cpu_rq(cur_cpu_num), cur_cpu_num); 
 
     /* if preferred task is currently task, then no need to do switch and just return */
     if (g_preferred_ready_task[cur_cpu_num] == g_active_task[cur_cpu_num]) {
@@ -181,6 +193,10 @@ void runqueue_init(runqueue_t *rq)
     for (prio = 0; prio < RHINO_CONFIG_PRI_MAX; prio++) {
         rq->cur_list_item[prio] = NULL;
     }
+
+#if (RHINO_CONFIG_CPU_NUM > 1)
+    memset(&rq->stats, 0, sizeof(rq->stats));
+#endif
 }
 
 RHINO_INLINE void ready_list_init(runqueue_t *rq, ktask_t *task)
@@ -194,14 +210,14 @@ RHINO_INLINE void ready_list_init(runqueue_t *rq, ktask_t *task)
     }
 }
 
-RHINO_INLINE uint8_t is_ready_list_empty(uint8_t prio)
+RHINO_INLINE uint8_t is_ready_list_empty(runqueue_t *rq, uint8_t prio)
 {
-    return (g_ready_queue.cur_list_item[prio] == NULL);
+    return (rq->cur_list_item[prio] == NULL);
 }
 
 RHINO_INLINE void _ready_list_add_tail(runqueue_t *rq, ktask_t *task)
 {
-    if (is_ready_list_empty(task->prio)) {
+    if (is_ready_list_empty(rq, task->prio)) {
         ready_list_init(rq, task);
         return;
     }
@@ -211,7 +227,7 @@ RHINO_INLINE void _ready_list_add_tail(runqueue_t *rq, ktask_t *task)
 
 RHINO_INLINE void _ready_list_add_head(runqueue_t *rq, ktask_t *task)
 {
-    if (is_ready_list_empty(task->prio)) {
+    if (is_ready_list_empty(rq, task->prio)) {
         ready_list_init(rq, task);
         return;
     }
@@ -221,52 +237,78 @@ RHINO_INLINE void _ready_list_add_head(runqueue_t *rq, ktask_t *task)
 }
 
 #if (RHINO_CONFIG_CPU_NUM > 1)
-static void task_sched_to_cpu(runqueue_t *rq, ktask_t *task, uint8_t cur_cpu_num)
+/* choose the cpu a task becoming ready is queued on */
+static uint8_t task_cpu_select(ktask_t *task)
 {
     uint8_t i;
-    uint8_t low_pri;
+    uint8_t target;
 
-    (void)rq;
+    /* bound, running or not yet started tasks keep their queue */
+    if ((task->cpu_binded == 1u) || (task->cur_exc == 1u) || (g_sys_stat != RHINO_RUNNING)) {
+        return task->cpu_num;
+    }
 
-    if (g_sys_stat == RHINO_RUNNING) {
-        if (task->cpu_binded == 1) {
-            if (task->cpu_num != cur_cpu_num) {
-                if (task->prio <= g_active_task[task->cpu_num]->prio) {
-                    cpu_signal(task->cpu_num);
-                }
-            }
-        } else {
-            /* find the lowest pri */
-            low_pri = g_active_task[0]->prio;
-            for (i = 0; i < RHINO_CONFIG_CPU_NUM - 1; i++) {
-                if (low_pri < g_active_task[i + 1]->prio) {
-                     low_pri = g_active_task[i + 1]->prio;
-                }
-            }
+    /* stay where the cache is warm if the task preempts there */
+    if (task->prio < g_active_task[task->cpu_num]->prio) {
+        return task->cpu_num;
+    }
 
-            /* which cpu run the lowest pri, just notify it */
-            for (i = 0; i < RHINO_CONFIG_CPU_NUM; i++) {
-                if (low_pri == g_active_task[i]->prio) {
-                    if (i != cur_cpu_num) {
-                        cpu_signal(i);
-                    }
-                    return;
-                }
-            }
+    /* else go to the cpu running the lowest prio work, if it preempts there */
+    target = task->cpu_num;
+    for (i = 0; i < RHINO_CONFIG_CPU_NUM; i++) {
+        if (g_active_task[i]->prio > g_active_task[target]->prio) {
+            target = i;
         }
     }
+
+    if (task->prio < g_active_task[target]->prio) {
+        return target;
+    }
+
+    /* everybody is busy with more urgent work, wait here or be stolen */
+    return task->cpu_num;
 }
 
+static void ready_list_enqueue(ktask_t *task, uint8_t to_head)
+{
+    runqueue_t *rq;
+    uint8_t     cpu_num;
+
+    cpu_num = task_cpu_select(task);
+    rq      = cpu_rq(cpu_num);
+
+    if (cpu_num != task->cpu_num) {
+        task->cpu_num = cpu_num;
+        rq->stats.migrate_cnt++;
+    }
+
+    if (to_head > 0u) {
+        _ready_list_add_head(rq, task);
+    } else {
+        _ready_list_add_tail(rq, task);
+    }
+
+    rq->stats.ready_num++;
+
+    if ((g_sys_stat == RHINO_RUNNING) && (cpu_num != cpu_cur_get())
+        && (task->prio < g_active_task[cpu_num]->prio)) {
+        sched_ipi_send(cpu_num);
+    }
+}
+
+/* on smp the queue follows task placement, rq is the one the task last ran on */
 void ready_list_add_head(runqueue_t *rq, ktask_t *task)
 {
-    _ready_list_add_head(rq, task);
-    task_sched_to_cpu(rq, task, cpu_cur_get());
+    (void)rq;
+
+    ready_list_enqueue(task, 1u);
 }
 
 void ready_list_add_tail(runqueue_t *rq, ktask_t *task)
 {
-    _ready_list_add_tail(rq, task);
-    task_sched_to_cpu(rq, task, cpu_cur_get());
+    (void)rq;
+
+    ready_list_enqueue(task, 0u);
 }
 
 #else
@@ -291,7 +333,7 @@ void ready_list_add(runqueue_t *rq, ktask_t *task)
     }
 }
 
-void ready_list_rm(runqueue_t *rq, ktask_t *task)
+static void _ready_list_rm(runqueue_t *rq, ktask_t *task)
 {
     int32_t  i;
     uint8_t  pri = task->prio;
@@ -328,13 +370,27 @@ void ready_list_rm(runqueue_t *rq, ktask_t *task)
     }
 }
 
+#if (RHINO_CONFIG_CPU_NUM > 1)
+void ready_list_rm(runqueue_t *rq, ktask_t *task)
+{
+    _ready_list_rm(rq, task);
+    rq->stats.ready_num--;
+}
+#else
+void ready_list_rm(runqueue_t *rq, ktask_t *task)
+{
+    _ready_list_rm(rq, task);
+}
+#endif
+
 void ready_list_head_to_tail(runqueue_t *rq, ktask_t *task)
 {
     rq->cur_list_item[task->prio] = rq->cur_list_item[task->prio]->next;
 }
 
 #if (RHINO_CONFIG_CPU_NUM > 1)
-void preferred_cpu_ready_task_get(runqueue_t *rq, uint8_t cpu_num)
+/* highest prio task of the local queue this cpu may run */
+static ktask_t *rq_local_pick(runqueue_t *rq, uint8_t cpu_num)
 {
     klist_t *iter;
     ktask_t *task;
@@ -359,9 +415,6 @@ void preferred_cpu_ready_task_get(runqueue_t *rq, uint8_t cpu_num)
                || ((task->cur_exc == 0) && (task->cpu_binded == 1) && (task->cpu_num == cpu_num));
 
         if (flag > 0) { /* ǰtaskûа󶨵ĳˣ߰󶨵˵ǰ */
-            task->cpu_num = cpu_num;
-            task->cur_exc = 1;
-            g_preferred_ready_task[cpu_num] = task; /*ѵǰȼߵŵg_preferred_ready_task*/
             break;
         }
 
@@ -373,6 +426,105 @@ void preferred_cpu_ready_task_get(runqueue_t *rq, uint8_t cpu_num)
             iter = iter->next;
         }
     }
+
+    return task;
+}
+
+/*
+ * First task more urgent than limit which no cpu runs and no cpu owns.
+ * The idle task of the queue is always ready at a prio >= limit, so the
+ * bitmap walk ends before the bitmap runs empty.
+ */
+static ktask_t *rq_steal_candidate(runqueue_t *rq, uint8_t limit)
+{
+    klist_t *iter;
+    ktask_t *task;
+    uint32_t task_bit_map[NUM_WORDS];
+    int32_t  pri;
+
+    memcpy(task_bit_map, rq->task_bit_map, NUM_WORDS * sizeof(uint32_t));
+
+    for (pri = krhino_find_first_bit(task_bit_map); pri < limit;
+         pri = krhino_find_first_bit(task_bit_map)) {
+        iter = rq->cur_list_item[pri];
+
+        do {
+            task = krhino_list_entry(iter, ktask_t, task_list);
+
+            if ((task->cur_exc == 0u) && (task->cpu_binded == 0u)) {
+                return task;
+            }
+
+            iter = iter->next;
+        } while (iter != rq->cur_list_item[pri]);
+
+        task_bit_map[pri >> 5] &= ~(1u << (31u - (pri & 31u)));
+    }
+
+    return NULL;
+}
+
+/* pull the most urgent waiting task of all other queues if it beats limit */
+static ktask_t *rq_steal(runqueue_t *rq, uint8_t cpu_num, uint8_t limit)
+{
+    runqueue_t *victim;
+    runqueue_t *busiest;
+    ktask_t    *task;
+    ktask_t    *stolen;
+    uint8_t     best_pri;
+    uint8_t     i;
+
+    busiest  = NULL;
+    stolen   = NULL;
+    best_pri = limit;
+
+    for (i = 0; i < RHINO_CONFIG_CPU_NUM; i++) {
+        victim = cpu_rq(i);
+
+        /* a queue holding just its running task has nothing to give */
+        if ((i == cpu_num) || (victim->stats.ready_num <= 1u)
+            || (victim->highest_pri >= best_pri)) {
+            continue;
+        }
+
+        task = rq_steal_candidate(victim, best_pri);
+        if (task != NULL) {
+            best_pri = task->prio;
+            busiest  = victim;
+            stolen   = task;
+        }
+    }
+
+    if (busiest == NULL) {
+        return NULL;
+    }
+
+    _ready_list_rm(busiest, stolen);
+    busiest->stats.ready_num--;
+
+    stolen->cpu_num = cpu_num;
+    _ready_list_add_head(rq, stolen);
+    rq->stats.ready_num++;
+    rq->stats.migrate_cnt++;
+    rq->stats.steal_cnt++;
+
+    return stolen;
+}
+
+void preferred_cpu_ready_task_get(runqueue_t *rq, uint8_t cpu_num)
+{
+    ktask_t *task;
+    ktask_t *stolen;
+
+    task = rq_local_pick(rq, cpu_num);
+
+    stolen = rq_steal(rq, cpu_num, task->prio);
+    if (stolen != NULL) {
+        task = stolen;
+    }
+
+    task->cur_exc = 1;
+    g_preferred_ready_task[cpu_num] = task;
 }
 #else //(RHINO_CONFIG_CPU_NUM > 1)
 void preferred_cpu_ready_task_get(runqueue_t *rq, uint8_t cpu_num)
@@ -391,10 +543,10 @@ static void _time_slice_update(ktask_t *task, uint8_t i)
 {
     klist_t *head;
 
-    head = g_ready_queue.cur_list_item[task->prio];
+    head = task_rq(task)->cur_list_item[task->prio];
 
     /* if ready list is empty then just return because nothing is to be caculated */
-    if (is_ready_list_empty(task->prio)) {
+    if (is_ready_list_empty(task_rq(task), task->prio)) {
         return;
     }
 
@@ -418,13 +570,13 @@ static void _time_slice_update(ktask_t *task, uint8_t i)
     }
 
     /* move current active task to the end of ready list for the same prio */
-    ready_list_head_to_tail(&g_ready_queue, task); /* ʱƬˣѵǰƵβ */
+    ready_list_head_to_tail(task_rq(task), task); /* ʱƬˣѵǰƵβ */
 
     /* restore the task time slice */
     task->time_slice = task->time_total; /* ȻָʱƬ */
 
     if (i != cpu_cur_get()) {
-        cpu_signal(i);
+        sched_ipi_send(i);
     }
 
 }
@@ -459,7 +611,7 @@ void time_slice_update(void)
     head = g_ready_queue.cur_list_item[task_pri];
 
     /* if ready list is empty then just return because nothing is to be caculated */
-    if (is_ready_list_empty(task_pri)) {
+    if (is_ready_list_empty(&g_ready_queue, task_pri)) {
         RHINO_CRITICAL_EXIT();
         return;
     }
@@ -501,3 +653,21 @@ void time_slice_update(void)
 
 #endif
 
+#if (RHINO_CONFIG_CPU_NUM > 1)
+kstat_t krhino_sched_stats_get(uint8_t cpu_num, ksched_stats_t *stats)
+{
+    CPSR_ALLOC();
+
+    NULL_PARA_CHK(stats);
+
+    if (cpu_num >= RHINO_CONFIG_CPU_NUM) {
+        return RHINO_INV_PARAM;
+    }
+
+    RHINO_CRITICAL_ENTER();
+    *stats = cpu_rq(cpu_num)->stats;
+    RHINO_CRITICAL_EXIT();
+
+    return RHINO_SUCCESS;
+}
+#endif
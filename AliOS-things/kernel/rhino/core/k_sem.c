@@ -90,7 +90,7 @@ kstat_t krhino_sem_dyn_create(ksem_t **sem, const name_t *name,
 
     NULL_PARA_CHK(sem);
 
-    sem_obj = krhino_mm_alloc(sizeof(ksem_t));
+    sem_obj = KOBJ_DYN_ALLOC(g_slab_sem, ksem_t);
 
     if (sem_obj == NULL) {
         return RHINO_NO_MEM;
@@ -99,7 +99,7 @@ kstat_t krhino_sem_dyn_create(ksem_t **sem, const name_t *name,
     stat = sem_create(sem_obj, name, count, K_OBJ_DYN_ALLOC);
 
     if (stat != RHINO_SUCCESS) {
-        krhino_mm_free(sem_obj);
+        KOBJ_DYN_FREE(sem_obj);
         return stat;
     }
 
@@ -145,7 +145,7 @@ kstat_t krhino_sem_dyn_del(ksem_t *sem)
     TRACE_SEM_DEL(g_active_task[cpu_cur_get()], sem);
     RHINO_CRITICAL_EXIT_SCHED();
 
-    krhino_mm_free(sem);
+    KOBJ_DYN_FREE(sem);
 
     return RHINO_SUCCESS;
 }
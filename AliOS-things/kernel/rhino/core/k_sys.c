@@ -27,7 +27,13 @@ kstat_t krhino_init(void)
     krhino_init_hook();
 #endif
 
+#if (RHINO_CONFIG_CPU_NUM > 1)
+    for (uint8_t i = 0; i < RHINO_CONFIG_CPU_NUM; i++) {
+        runqueue_init(cpu_rq(i));
+    }
+#else
     runqueue_init(&g_ready_queue);
+#endif
 
     tick_list_init();
 
@@ -39,6 +45,10 @@ kstat_t krhino_init(void)
     k_mm_init();
 #endif
 
+#if (RHINO_CONFIG_MM_SLAB > 0)
+    k_mm_slab_init();
+#endif
+
 #if (RHINO_CONFIG_KOBJ_DYN_ALLOC > 0)
     klist_init(&g_res_list);
     krhino_sem_create(&g_res_sem, "res_sem", 0);
@@ -69,6 +79,8 @@ kstat_t krhino_init(void)
     cpu_usage_stats_start();
 #endif
 
+    TRACE_INIT();
+
     rhino_stack_check_init();
 
     return RHINO_SUCCESS;
@@ -79,7 +91,7 @@ kstat_t krhino_start(void)
     if (g_sys_stat == RHINO_STOPPED) {
 #if (RHINO_CONFIG_CPU_NUM > 1)
         for (uint8_t i = 0; i < RHINO_CONFIG_CPU_NUM; i++) {
-            preferred_cpu_ready_task_get(&g_ready_queue, i);
+            preferred_cpu_ready_task_get(cpu_rq(i), i);
             g_active_task[i] = g_preferred_ready_task[i];
             g_active_task[i]->cur_exc = 1;
         }
@@ -193,7 +205,7 @@ void krhino_intrpt_exit(void)
         return;
     }
     /* һtask */
-    preferred_cpu_ready_task_get(&g_ready_queue, cur_cpu_num);
+    preferred_cpu_ready_task_get(cpu_rq(cur_cpu_num), cur_cpu_num);
 
     if (g_preferred_ready_task[cur_cpu_num] == g_active_task[cur_cpu_num]) {
         RHINO_CPU_INTRPT_ENABLE(); /* лֱӷ */
@@ -233,10 +245,21 @@ size_t krhino_global_space_get(void)
     mem = sizeof(g_sys_stat) + sizeof(g_idle_task_spawned) + sizeof(g_ready_queue)
           + sizeof(g_sched_lock) + sizeof(g_intrpt_nested_level) + sizeof(g_preferred_ready_task)
           + sizeof(g_active_task) + sizeof(g_idle_task) + sizeof(g_idle_task_stack)
-          + sizeof(g_tick_head) + sizeof(g_tick_count) + sizeof(g_idle_count);
+          + sizeof(g_tick_count) + sizeof(g_idle_count);
+
+#if (RHINO_CONFIG_TICK_WHEEL > 0)
+    mem += sizeof(g_tick_wheel);
+#else
+    mem += sizeof(g_tick_head);
+#endif
 
 #if (RHINO_CONFIG_TIMER > 0)
-    mem += sizeof(g_timer_head) + sizeof(g_timer_count)
+#if (RHINO_CONFIG_TICK_WHEEL > 0)
+    mem += sizeof(g_timer_wheel);
+#else
+    mem += sizeof(g_timer_head);
+#endif
+    mem += sizeof(g_timer_count)
            + sizeof(g_timer_task) + sizeof(g_timer_task_stack)
            + sizeof(g_timer_queue) + sizeof(timer_queue_cb);
 #endif
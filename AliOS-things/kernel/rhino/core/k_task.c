@@ -106,7 +106,7 @@ static kstat_t task_create(ktask_t *task, const name_t *name, void *arg,
 #endif
     /* ǰ񴴽Զʼִ */
     if (autorun > 0u) {/*ready listÿȼһklist*/
-        ready_list_add_tail(&g_ready_queue, task);/*task->prioklist*/
+        ready_list_add_tail(task_rq(task), task);/*task->prioklist*/
         /* if system is not start,not call core_sched */
         if (g_sys_stat == RHINO_RUNNING) {
             RHINO_CRITICAL_EXIT_SCHED();/*core_sched()ִеȣֱӷLRָĺ(δں) */
@@ -142,13 +142,24 @@ kstat_t krhino_task_cpu_bind(ktask_t *task, uint8_t cpu_num)
 
     ktask_t *task_cur;
 
+    if (cpu_num >= RHINO_CONFIG_CPU_NUM) {
+        return RHINO_INV_PARAM;
+    }
+
     RHINO_CRITICAL_ENTER();
     task_cur = g_active_task[cpu_cur_get()];
     if (task != task_cur) {
         RHINO_CRITICAL_EXIT();
         return RHINO_INV_PARAM;
     }
-    task->cpu_num    = cpu_num;
+
+    /* move to the queue of the new cpu, core_sched() hands it over once switched out */
+    if (task->cpu_num != cpu_num) {
+        ready_list_rm(task_rq(task), task);
+        task->cpu_num = cpu_num;
+        ready_list_add_tail(task_rq(task), task);
+    }
+
     task->cpu_binded = 1u;
     RHINO_CRITICAL_EXIT_SCHED();
 
@@ -194,7 +205,7 @@ kstat_t task_dyn_create(ktask_t **task, const name_t *name, void *arg,
         return RHINO_NO_MEM;
     }
 
-    task_obj = krhino_mm_alloc(sizeof(ktask_t));
+    task_obj = KOBJ_DYN_ALLOC(g_slab_task, ktask_t);
     if (task_obj == NULL) {
         krhino_mm_free(task_stack);
         return RHINO_NO_MEM;
@@ -206,7 +217,7 @@ kstat_t task_dyn_create(ktask_t **task, const name_t *name, void *arg,
                       autorun, K_OBJ_DYN_ALLOC, cpu_num, cpu_binded);
     if ((ret != RHINO_SUCCESS) && (ret != RHINO_STOPPED)) {
         krhino_mm_free(task_stack);
-        krhino_mm_free(task_obj);
+        KOBJ_DYN_FREE(task_obj);
         *task = NULL;
         return ret;
     }
@@ -257,7 +268,7 @@ kstat_t krhino_task_sleep(tick_t ticks)
 
     g_active_task[cur_cpu_num]->task_state = K_SLEEP;
     tick_list_insert(g_active_task[cur_cpu_num], ticks);
-    ready_list_rm(&g_ready_queue, g_active_task[cur_cpu_num]);
+    ready_list_rm(task_rq(g_active_task[cur_cpu_num]), g_active_task[cur_cpu_num]);
 
     TRACE_TASK_SLEEP(g_active_task[cur_cpu_num], ticks);
 
@@ -277,10 +288,13 @@ kstat_t krhino_task_yield(void)
 {
     CPSR_ALLOC();
 
+    ktask_t *task;
+
     /* make current task to the end of ready list */
     RHINO_CRITICAL_ENTER();
 
-    ready_list_head_to_tail(&g_ready_queue, g_active_task[cpu_cur_get()]);
+    task = g_active_task[cpu_cur_get()];
+    ready_list_head_to_tail(task_rq(task), task);
 
     RHINO_CRITICAL_EXIT_SCHED();
 
@@ -329,7 +343,7 @@ kstat_t task_suspend(ktask_t *task)
         case K_RDY:
             task->suspend_count = 1u;
             task->task_state    = K_SUSPENDED;
-            ready_list_rm(&g_ready_queue, task);
+            ready_list_rm(task_rq(task), task);
             break;
         case K_SLEEP:
             task->suspend_count = 1u;
@@ -393,7 +407,7 @@ kstat_t task_resume(ktask_t *task)
             if (task->suspend_count == 0u) {
                 /* Make task ready */
                 task->task_state = K_RDY;
-                ready_list_add(&g_ready_queue, task);
+                ready_list_add(task_rq(task), task);
             }
 
             break;
@@ -508,13 +522,13 @@ kstat_t task_pri_change(ktask_t *task, uint8_t new_pri)
         if (task->prio != new_pri) {
             switch (task->task_state) {
                 case K_RDY: /* ھ̬,ֻȼ */
-                    ready_list_rm(&g_ready_queue, task); /* Ѵȼready queueɾ */
+                    ready_list_rm(task_rq(task), task); /* Ѵȼready queueɾ */
                     task->prio = new_pri;
 
                     if (task == g_active_task[cpu_cur_get()]) {
-                        ready_list_add_head(&g_ready_queue, task); /* ǰִУŵ */
+                        ready_list_add_head(task_rq(task), task); /* ǰִУŵ */
                     } else {
-                        ready_list_add_tail(&g_ready_queue, task); /* ǰûִУŵβ */
+                        ready_list_add_tail(task_rq(task), task); /* ǰûִУŵβ */
                     }
 
                     task = NULL; /* ֻ */
@@ -640,13 +654,13 @@ kstat_t krhino_task_wait_abort(ktask_t *task)
         case K_SUSPENDED:
             /* change to ready state */
             task->task_state = K_RDY;
-            ready_list_add(&g_ready_queue, task);
+            ready_list_add(task_rq(task), task);
             break;
         case K_SLEEP:
         case K_SLEEP_SUSPENDED:
             /* change to ready state */
             tick_list_rm(task);
-            ready_list_add(&g_ready_queue, task);
+            ready_list_add(task_rq(task), task);
             task->task_state = K_RDY;
             task->blk_state  = BLK_ABORT;
             break;
@@ -657,7 +671,7 @@ kstat_t krhino_task_wait_abort(ktask_t *task)
             /* remove task on the block list because task is woken up */
             klist_rm(&task->task_list);
             /* add to the ready list again */
-            ready_list_add(&g_ready_queue, task);
+            ready_list_add(task_rq(task), task);
             task->task_state = K_RDY;
             task->blk_state  = BLK_ABORT;
 
@@ -763,7 +777,7 @@ kstat_t krhino_task_del(ktask_t *task)
 
     switch (task->task_state) {
         case K_RDY:
-            ready_list_rm(&g_ready_queue, task);
+            ready_list_rm(task_rq(task), task);
             task->task_state = K_DELETED;
             break;
         case K_SUSPENDED:
@@ -869,8 +883,8 @@ kstat_t krhino_task_dyn_del(ktask_t *task)
     g_sched_lock[cpu_cur_get()]++;
     klist_insert(&g_res_list, &res_free->res_list);
     res_free->res[0] = task->task_stack_base;
-    res_free->res[1] = task;
-    res_free->cnt += 2;
+    res_free->task   = task;
+    res_free->cnt   += 1;
     ret = krhino_sem_give(&g_res_sem);
     g_sched_lock[cpu_cur_get()]--;
 
@@ -885,7 +899,7 @@ kstat_t krhino_task_dyn_del(ktask_t *task)
 
     switch (task->task_state) {
         case K_RDY:
-            ready_list_rm(&g_ready_queue, task);
+            ready_list_rm(task_rq(task), task);
             task->task_state = K_DELETED;
             break;
         case K_SUSPENDED:
@@ -6,9 +6,15 @@
 
 void tick_list_init(void)
 {
+#if (RHINO_CONFIG_TICK_WHEEL > 0)
+    tick_wheel_init(&g_tick_wheel, (size_t)(&((ktask_t *)0)->tick_list),
+                    (size_t)(&((ktask_t *)0)->tick_match), g_tick_count);
+#else
    klist_init(&g_tick_head);
+#endif
 }
 
+#if (RHINO_CONFIG_TICK_WHEEL == 0)
 RHINO_INLINE void tick_list_pri_insert(klist_t *head, ktask_t *task)
 {
     tick_t   val;
@@ -29,6 +35,7 @@ RHINO_INLINE void tick_list_pri_insert(klist_t *head, ktask_t *task)
 
     klist_insert(q, &task->tick_list);
 }
+#endif
 
 void tick_list_insert(ktask_t *task, tick_t time)
 { /* ܱʱAPI */
@@ -38,8 +45,13 @@ void tick_list_insert(ktask_t *task, tick_t time)
         task->tick_match  = g_tick_count + time;
         task->tick_remain = time;
 
+#if (RHINO_CONFIG_TICK_WHEEL > 0)
+        tick_head_ptr = tick_wheel_insert(&g_tick_wheel, &task->tick_list,
+                                          task->tick_match);
+#else
         tick_head_ptr = &g_tick_head;
         tick_list_pri_insert(tick_head_ptr, task);
+#endif
         task->tick_head = tick_head_ptr;
     }
 }
@@ -49,11 +61,36 @@ void tick_list_rm(ktask_t *task)
     klist_t *tick_head_ptr = task->tick_head;
 
     if (tick_head_ptr != NULL) {
+#if (RHINO_CONFIG_TICK_WHEEL > 0)
+        tick_wheel_rm(&g_tick_wheel, &task->tick_list);
+#else
         klist_rm(&task->tick_list);
+#endif
         task->tick_head = NULL;
     }
 }
 
+#if (RHINO_CONFIG_TICKLESS > 0)
+uint8_t tick_list_next(tick_t *match)
+{
+#if (RHINO_CONFIG_TICK_WHEEL > 0)
+    return tick_wheel_next(&g_tick_wheel, match);
+#else
+    ktask_t *task;
+
+    if (is_klist_empty(&g_tick_head)) {
+        return RHINO_FALSE;
+    }
+
+    /* sorted by remain time, the head is due first */
+    task   = krhino_list_entry(g_tick_head.next, ktask_t, tick_list);
+    *match = task->tick_match;
+
+    return RHINO_TRUE;
+#endif
+}
+#endif
+
 void tick_list_update(tick_i_t ticks)
 {
     CPSR_ALLOC();
@@ -63,12 +100,22 @@ void tick_list_update(tick_i_t ticks)
     klist_t *iter;
     klist_t *iter_temp;
     tick_i_t delta;
+#if (RHINO_CONFIG_TICK_WHEEL > 0)
+    klist_t  expired;
+#endif
 
     RHINO_CRITICAL_ENTER();
 
     g_tick_count += ticks;
 
+#if (RHINO_CONFIG_TICK_WHEEL > 0)
+    /* the wheel hands back only the due tasks, the walk below then finishes on the list end */
+    klist_init(&expired);
+    tick_wheel_advance(&g_tick_wheel, g_tick_count, &expired);
+    tick_head_ptr = &expired;
+#else
     tick_head_ptr = &g_tick_head;
+#endif
     iter          =  tick_head_ptr->next;
 
     while (RHINO_TRUE) {
@@ -84,13 +131,13 @@ void tick_list_update(tick_i_t ticks)
                         p_tcb->blk_state  = BLK_FINISH;
                         p_tcb->task_state = K_RDY;
                         tick_list_rm(p_tcb);
-                        ready_list_add(&g_ready_queue, p_tcb);
+                        ready_list_add(task_rq(p_tcb), p_tcb);
                         break;
                     case K_PEND:
                         tick_list_rm(p_tcb);
                         /* remove task on the block list because task is timeout */
                         klist_rm(&p_tcb->task_list);
-                        ready_list_add(&g_ready_queue, p_tcb);
+                        ready_list_add(task_rq(p_tcb), p_tcb);
                         p_tcb->blk_state  = BLK_TIMEOUT;
                         p_tcb->task_state = K_RDY;
                         mutex_task_pri_reset(p_tcb);
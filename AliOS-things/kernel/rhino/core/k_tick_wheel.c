@@ -0,0 +1,264 @@
+/*
+ * Copyright (C) 2015-2017 Alibaba Group Holding Limited
+ */
+
+#include <k_api.h>
+
+#if (RHINO_CONFIG_TICK_WHEEL > 0) || (RHINO_CONFIG_WORKQUEUE > 0)
+
+#define TICK_WHEEL_SLOT_TOTAL (RHINO_CONFIG_TICK_WHEEL_LEVEL * TICK_WHEEL_SLOT_NUM)
+
+RHINO_INLINE tick_t tick_wheel_match_get(k_tick_wheel_t *wheel, klist_t *node)
+{
+    return *(tick_t *)((uint8_t *)node - wheel->node_off + wheel->match_off);
+}
+
+/* distance from bit pos to the next set bit, wrapping around the slot ring */
+RHINO_INLINE uint32_t tick_wheel_bit_next(uint32_t bitmap, uint32_t pos)
+{
+    if (pos != 0u) {
+        bitmap = (bitmap >> pos) | (bitmap << (TICK_WHEEL_SLOT_NUM - pos));
+    }
+
+    return krhino_ctz32(bitmap);
+}
+
+static void tick_wheel_slot_add(k_tick_wheel_t *wheel, klist_t *node, tick_t key,
+                                uint32_t level)
+{
+    uint32_t idx;
+
+    idx = (uint32_t)(key >> (TICK_WHEEL_SLOT_BITS * level)) & TICK_WHEEL_SLOT_MASK;
+
+    klist_insert(&wheel->slot[level][idx], node);
+    wheel->bitmap[level] |= 1u << idx;
+}
+
+void tick_wheel_init(k_tick_wheel_t *wheel, size_t node_off, size_t match_off,
+                     tick_t now)
+{
+    uint32_t level;
+    uint32_t idx;
+
+    for (level = 0u; level < RHINO_CONFIG_TICK_WHEEL_LEVEL; level++) {
+        for (idx = 0u; idx < TICK_WHEEL_SLOT_NUM; idx++) {
+            klist_init(&wheel->slot[level][idx]);
+        }
+        wheel->bitmap[level] = 0u;
+    }
+
+    wheel->now       = now;
+    wheel->node_off  = node_off;
+    wheel->match_off = match_off;
+}
+
+klist_t *tick_wheel_insert(k_tick_wheel_t *wheel, klist_t *node, tick_t match)
+{
+    tick_t   key;
+    tick_t   delta;
+    uint32_t level;
+    uint32_t idx;
+
+    key = match;
+
+    /* already due, fire on the next advance */
+    if ((tick_i_t)(key - wheel->now) <= 0) {
+        key = wheel->now + 1u;
+    }
+
+    delta = key - wheel->now;
+    if (delta >= TICK_WHEEL_SPAN) {
+        key   = wheel->now + TICK_WHEEL_SPAN - 1u;
+        delta = TICK_WHEEL_SPAN - 1u;
+    }
+
+    for (level = 0u; level < RHINO_CONFIG_TICK_WHEEL_LEVEL - 1u; level++) {
+        if (delta < ((tick_t)1 << (TICK_WHEEL_SLOT_BITS * (level + 1u)))) {
+            break;
+        }
+    }
+
+    tick_wheel_slot_add(wheel, node, key, level);
+
+    idx = (uint32_t)(key >> (TICK_WHEEL_SLOT_BITS * level)) & TICK_WHEEL_SLOT_MASK;
+
+    return &wheel->slot[level][idx];
+}
+
+void tick_wheel_rm(k_tick_wheel_t *wheel, klist_t *node)
+{
+    klist_t  *head;
+    klist_t  *first;
+    uintptr_t pos;
+
+    /* the last node of a list leaves only its head behind, a cascade may
+       have moved the node since it was inserted so its slot is found here */
+    head = node->next;
+    klist_rm(node);
+
+    if (head != node->prev) {
+        return;
+    }
+
+    /* head may be a list the node was expired to, only wheel slots own a bit */
+    first = &wheel->slot[0][0];
+    if (((uintptr_t)head < (uintptr_t)first) ||
+        ((uintptr_t)head >= (uintptr_t)(first + TICK_WHEEL_SLOT_TOTAL))) {
+        return;
+    }
+
+    pos = (uintptr_t)(head - first);
+    wheel->bitmap[pos >> TICK_WHEEL_SLOT_BITS] &= ~(1u << (pos & TICK_WHEEL_SLOT_MASK));
+}
+
+/* move every node of a higher level slot down, now sits on its boundary */
+static void tick_wheel_cascade(k_tick_wheel_t *wheel, uint32_t level, uint32_t idx)
+{
+    klist_t *head;
+    klist_t *node;
+    tick_t   match;
+
+    head = &wheel->slot[level][idx];
+    wheel->bitmap[level] &= ~(1u << idx);
+
+    while (!is_klist_empty(head)) {
+        node  = head->next;
+        match = tick_wheel_match_get(wheel, node);
+        klist_rm(node);
+
+        if ((tick_i_t)(match - wheel->now) <= 0) {
+            tick_wheel_slot_add(wheel, node, wheel->now, 0u);
+        } else {
+            (void)tick_wheel_insert(wheel, node, match);
+        }
+    }
+}
+
+/* process the single tick wheel->now */
+static void tick_wheel_tick(k_tick_wheel_t *wheel, klist_t *expired)
+{
+    klist_t *head;
+    klist_t *node;
+    uint32_t level;
+    uint32_t idx;
+
+    idx = (uint32_t)wheel->now & TICK_WHEEL_SLOT_MASK;
+
+    for (level = 1u; (idx == 0u) && (level < RHINO_CONFIG_TICK_WHEEL_LEVEL); level++) {
+        idx = (uint32_t)(wheel->now >> (TICK_WHEEL_SLOT_BITS * level)) & TICK_WHEEL_SLOT_MASK;
+        tick_wheel_cascade(wheel, level, idx);
+    }
+
+    idx  = (uint32_t)wheel->now & TICK_WHEEL_SLOT_MASK;
+    head = &wheel->slot[0][idx];
+    wheel->bitmap[0] &= ~(1u << idx);
+
+    while (!is_klist_empty(head)) {
+        node = head->next;
+        klist_rm(node);
+
+        if ((tick_i_t)(tick_wheel_match_get(wheel, node) - wheel->now) <= 0) {
+            klist_insert(expired, node);
+        } else {
+            (void)tick_wheel_insert(wheel, node, tick_wheel_match_get(wheel, node));
+        }
+    }
+}
+
+void tick_wheel_advance(k_tick_wheel_t *wheel, tick_t now, klist_t *expired)
+{
+    tick_t   next;
+    uint32_t level;
+    uint32_t idx;
+
+    while ((tick_i_t)(now - wheel->now) > 0) {
+        for (level = 0u; level < RHINO_CONFIG_TICK_WHEEL_LEVEL; level++) {
+            if (wheel->bitmap[level] != 0u) {
+                break;
+            }
+        }
+
+        if (level == RHINO_CONFIG_TICK_WHEEL_LEVEL) {
+            wheel->now = now;
+            break;
+        }
+
+        /* skip the ticks where nothing expires or cascades */
+        if (level == 0u) {
+            idx = ((uint32_t)wheel->now & TICK_WHEEL_SLOT_MASK) + 1u;
+            if ((idx < TICK_WHEEL_SLOT_NUM) && ((wheel->bitmap[0] >> idx) != 0u)) {
+                next = (wheel->now & ~(tick_t)TICK_WHEEL_SLOT_MASK)
+                       + idx + krhino_ctz32(wheel->bitmap[0] >> idx);
+            } else {
+                next = (wheel->now | TICK_WHEEL_SLOT_MASK) + 1u;
+            }
+        } else {
+            next = (wheel->now | (((tick_t)1 << (TICK_WHEEL_SLOT_BITS * level)) - 1u)) + 1u;
+        }
+
+        if ((tick_i_t)(next - now) > 0) {
+            wheel->now = now;
+            break;
+        }
+
+        wheel->now = next;
+        tick_wheel_tick(wheel, expired);
+    }
+}
+
+uint8_t tick_wheel_next(k_tick_wheel_t *wheel, tick_t *match)
+{
+    klist_t *head;
+    klist_t *iter;
+    tick_t   start;
+    tick_t   span;
+    tick_t   best;
+    tick_t   cand;
+    tick_t   tmp;
+    uint32_t level;
+    uint32_t shift;
+    uint32_t off;
+    uint8_t  found;
+
+    found = RHINO_FALSE;
+    best  = 0u;
+
+    for (level = 0u; level < RHINO_CONFIG_TICK_WHEEL_LEVEL; level++) {
+        if (wheel->bitmap[level] == 0u) {
+            continue;
+        }
+
+        /* slots after the current one hold later windows, the current one comes last */
+        shift = TICK_WHEEL_SLOT_BITS * level;
+        off   = tick_wheel_bit_next(wheel->bitmap[level],
+                                    ((uint32_t)(wheel->now >> shift) + 1u) & TICK_WHEEL_SLOT_MASK);
+        start = ((wheel->now >> shift) + 1u + off) << shift;
+        span  = (tick_t)1 << shift;
+
+        if (level == 0u) {
+            cand = start;
+        } else {
+            /* nodes parked beyond the span report the window end, they are re-cascaded by then */
+            head = &wheel->slot[level][(start >> shift) & TICK_WHEEL_SLOT_MASK];
+            cand = start + span - 1u;
+            for (iter = head->next; iter != head; iter = iter->next) {
+                tmp = tick_wheel_match_get(wheel, iter);
+                if ((tick_i_t)(tmp - cand) < 0) {
+                    cand = tmp;
+                }
+            }
+        }
+
+        if ((found == RHINO_FALSE) || ((tick_i_t)(cand - best) < 0)) {
+            best  = cand;
+            found = RHINO_TRUE;
+        }
+    }
+
+    *match = best;
+
+    return found;
+}
+
+#endif /* RHINO_CONFIG_TICK_WHEEL || RHINO_CONFIG_WORKQUEUE */
+
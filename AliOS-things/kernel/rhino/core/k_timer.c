@@ -5,6 +5,26 @@
 #include <k_api.h>
 
 #if (RHINO_CONFIG_TIMER > 0)
+#if (RHINO_CONFIG_TICK_WHEEL > 0)
+static void timer_list_insert(ktimer_t *timer)
+{
+    timer->to_head = tick_wheel_insert(&g_timer_wheel, &timer->timer_list,
+                                       timer->match);
+}
+
+static void timer_list_rm(ktimer_t *timer)
+{
+    if (timer->to_head != NULL) {
+        tick_wheel_rm(&g_timer_wheel, &timer->timer_list);
+        timer->to_head = NULL;
+    }
+}
+
+static uint8_t timer_list_next(sys_time_t *match)
+{
+    return tick_wheel_next(&g_timer_wheel, match);
+}
+#else
 static void timer_list_pri_insert(klist_t *head, ktimer_t *timer)
 {
     sys_time_t val;
@@ -37,6 +57,27 @@ static void timer_list_rm(ktimer_t *timer)
     }
 }
 
+static void timer_list_insert(ktimer_t *timer)
+{
+    timer->to_head = &g_timer_head;
+    timer_list_pri_insert(&g_timer_head, timer);
+}
+
+static uint8_t timer_list_next(sys_time_t *match)
+{
+    ktimer_t *timer;
+
+    if (is_klist_empty(&g_timer_head)) {
+        return RHINO_FALSE;
+    }
+
+    timer  = krhino_list_entry(g_timer_head.next, ktimer_t, timer_list);
+    *match = timer->match;
+
+    return RHINO_TRUE;
+}
+#endif /* RHINO_CONFIG_TICK_WHEEL */
+
 static kstat_t timer_create(ktimer_t *timer, const name_t *name, timer_cb_t cb,
                             sys_time_t first, sys_time_t round, void *arg, uint8_t auto_run,
                             uint8_t mm_alloc_flag)
@@ -112,7 +153,7 @@ kstat_t krhino_timer_dyn_create(ktimer_t **timer, const name_t *name,
 
     NULL_PARA_CHK(timer);
 
-    timer_obj = krhino_mm_alloc(sizeof(ktimer_t));
+    timer_obj = KOBJ_DYN_ALLOC(g_slab_timer, ktimer_t);
     if (timer_obj == NULL) {
         return RHINO_NO_MEM;
     }
@@ -120,7 +161,7 @@ kstat_t krhino_timer_dyn_create(ktimer_t **timer, const name_t *name,
     ret = timer_create(timer_obj, name, cb, first, round, arg, auto_run,
                        K_OBJ_DYN_ALLOC);
     if (ret != RHINO_SUCCESS) {
-        krhino_mm_free(timer_obj);
+        KOBJ_DYN_FREE(timer_obj);
         return ret;
     }
 
@@ -226,6 +267,30 @@ kstat_t krhino_timer_arg_change_auto(ktimer_t *timer, void *arg)
     return err;
 }
 
+#if (RHINO_CONFIG_TICK_WHEEL > 0)
+static void timer_cb_proc(void)
+{
+    klist_t   expired;
+    ktimer_t *timer;
+
+    klist_init(&expired);
+    tick_wheel_advance(&g_timer_wheel, g_timer_count, &expired);
+
+    while (!is_klist_empty(&expired)) {
+        timer = krhino_list_entry(expired.next, ktimer_t, timer_list);
+        timer->cb(timer, timer->timer_cb_arg);
+        timer_list_rm(timer);
+
+        if (timer->round_ticks > 0u) {
+            timer->remain = timer->round_ticks;
+            timer->match  = g_timer_count + timer->remain;
+            timer_list_insert(timer);
+        } else {
+            timer->timer_state = TIMER_DEACTIVE;
+        }
+    }
+}
+#else
 static void timer_cb_proc(void)
 {
     klist_t     *q;
@@ -258,6 +323,7 @@ static void timer_cb_proc(void)
         }
     }
 }
+#endif /* RHINO_CONFIG_TICK_WHEEL */
 
 static void cmd_proc(k_timer_queue_cb *cb, uint8_t cmd)
 {
@@ -278,8 +344,7 @@ static void cmd_proc(k_timer_queue_cb *cb, uint8_t cmd)
             /* sort by remain time */
             timer->remain  =  timer->init_count;
             /* used by timer delete */
-            timer->to_head = &g_timer_head;
-            timer_list_pri_insert(&g_timer_head, timer); /* ʣʱ붨ʱ */
+            timer_list_insert(timer); /* ʣʱ붨ʱ */
             timer->timer_state = TIMER_ACTIVE; /*  */
             break;
         case TIMER_CMD_STOP: /* ֹʱ */
@@ -352,7 +417,7 @@ static void cmd_proc(k_timer_queue_cb *cb, uint8_t cmd)
 
             timer->obj_type = RHINO_OBJ_TYPE_NONE;
             TRACE_TIMER_DEL(krhino_cur_task_get(), timer);
-            krhino_mm_free(timer);
+            KOBJ_DYN_FREE(timer);
             break;
 #endif
         default:
@@ -376,7 +441,7 @@ static void timer_cmd_proc(k_timer_queue_cb *cb)
 
 static void timer_task(void *pa)
 { /* ʱ(Linuxں߳) */
-    ktimer_t         *timer;
+    sys_time_t        match;
     k_timer_queue_cb  cb_msg; /* ûĶʱ(ص) */
     kstat_t           err;
     sys_time_t        tick_start;
@@ -396,12 +461,16 @@ static void timer_task(void *pa)
             k_err_proc(RHINO_SYS_FATAL_ERR);
         }
 
+#if (RHINO_CONFIG_TICK_WHEEL > 0)
+        /* the wheel is empty while waiting forever, catch it up before inserting */
+        timer_cb_proc();
+#endif
+
         timer_cmd_proc(&cb_msg); /* ѶʱϢ,µktimer_tg_timer_head */
                                                         /* ѸĵĶʱӦĴ */
-        while (!is_klist_empty(&g_timer_head)) { /* ʱֹͣˣͿ */
-            timer = krhino_list_entry(g_timer_head.next, ktimer_t, timer_list);
+        while (timer_list_next(&match)) { /* ʱֹͣˣͿ */
             tick_start = krhino_sys_tick_get();
-            delta = (sys_time_i_t)timer->match - (sys_time_i_t)tick_start;
+            delta = (sys_time_i_t)match - (sys_time_i_t)tick_start;
             if (delta > 0) { /* һʱ¼ʣʱΪʱʱȥȡʱ */
                 err = krhino_buf_queue_recv(&g_timer_queue, (tick_t)delta, &cb_msg, &msg_size); 
                 tick_end = krhino_sys_tick_get(); /* е */
@@ -426,7 +495,12 @@ static void timer_task(void *pa)
 
 void ktimer_init(void)
 {
+#if (RHINO_CONFIG_TICK_WHEEL > 0)
+    tick_wheel_init(&g_timer_wheel, (size_t)(&((ktimer_t *)0)->timer_list),
+                    (size_t)(&((ktimer_t *)0)->match), g_timer_count);
+#else
     klist_init(&g_timer_head);
+#endif
 
     krhino_fix_buf_queue_create(&g_timer_queue, "timer_queue",
                                  timer_queue_cb, sizeof(k_timer_queue_cb), RHINO_CONFIG_TIMER_MSG_NUM);
@@ -25,6 +25,131 @@ static kstat_t workqueue_is_exist(kworkqueue_t *workqueue)
     return RHINO_WORKQUEUE_NOT_EXIST;
 }
 
+#if (RHINO_CONFIG_WORKQUEUE_STATS > 0)
+RHINO_INLINE uint32_t workqueue_hist_idx(hr_timer_t val)
+{
+    if (val >= ((hr_timer_t)1 << (WORKQUEUE_HIST_NUM - 2u))) {
+        return WORKQUEUE_HIST_NUM - 1u;
+    }
+
+    return 32u - krhino_clz32((uint32_t)val);
+}
+#endif
+
+/* the helpers below run in the critical section */
+static uint8_t workqueue_work_running(kworkqueue_t *wq, kwork_t *work)
+{
+    uint8_t i;
+
+    for (i = 0u; i < wq->worker_num; i++) {
+        if (wq->work_current[i] == work) {
+            return RHINO_TRUE;
+        }
+    }
+
+    return RHINO_FALSE;
+}
+
+static void workqueue_work_insert(kworkqueue_t *wq, kwork_t *work)
+{
+    klist_t *pos;
+
+    pos = &(wq->work_list);
+
+    /* walk back over the lower ones, equal ones keep their order */
+    if ((wq->flag & WORKQUEUE_FLAG_PRI) != 0u) {
+        while ((pos->prev != &(wq->work_list)) &&
+               (krhino_list_entry(pos->prev, kwork_t, work_node)->pri > work->pri)) {
+            pos = pos->prev;
+        }
+    }
+
+    klist_insert(pos, &(work->work_node));
+}
+
+static void workqueue_work_pend(kworkqueue_t *wq, kwork_t *work)
+{
+    workqueue_work_insert(wq, work);
+
+    work->wq        = wq;
+    work->work_exit = 1;
+    wq->work_num++;
+
+#if (RHINO_CONFIG_WORKQUEUE_STATS > 0)
+    work->pend_time = HR_COUNT_GET();
+    wq->stats.depth[workqueue_hist_idx(wq->work_num)]++;
+    if (wq->work_num > wq->stats.depth_max) {
+        wq->stats.depth_max = wq->work_num;
+    }
+#endif
+}
+
+static void workqueue_dly_rm(kwork_t *work)
+{
+    kworkqueue_t *wq = (kworkqueue_t *)work->wq;
+
+    tick_wheel_rm(&(wq->dly_wheel), &(work->work_node));
+    klist_init(&(work->work_node));
+    work->dly_head = NULL;
+}
+
+/* move the delayed works due by now to the pending list */
+static void workqueue_dly_expire(kworkqueue_t *wq)
+{
+    klist_t  expired;
+    kwork_t *work;
+
+    klist_init(&expired);
+    tick_wheel_advance(&(wq->dly_wheel), g_tick_count, &expired);
+
+    while (!is_klist_empty(&expired)) {
+        work = krhino_list_entry(expired.next, kwork_t, work_node);
+        klist_rm_init(&(work->work_node));
+        work->dly_head = NULL;
+
+        /* a work still running misses this turn, as with the per work timer */
+        if (workqueue_work_running(wq, work) == RHINO_FALSE) {
+            workqueue_work_pend(wq, work);
+        }
+    }
+}
+
+static uint8_t workqueue_dly_is_empty(kworkqueue_t *wq)
+{
+    uint32_t level;
+
+    for (level = 0u; level < RHINO_CONFIG_TICK_WHEEL_LEVEL; level++) {
+        if (wq->dly_wheel.bitmap[level] != 0u) {
+            return RHINO_FALSE;
+        }
+    }
+
+    return RHINO_TRUE;
+}
+
+/* ticks an idle worker may block, one of them wakes for the earliest delayed work */
+static tick_t workqueue_dly_wait(kworkqueue_t *wq)
+{
+    tick_t match;
+
+    if (tick_wheel_next(&(wq->dly_wheel), &match) == RHINO_FALSE) {
+        return RHINO_WAIT_FOREVER;
+    }
+
+    if ((wq->dly_keeper != NULL) && ((tick_i_t)(match - wq->dly_match) >= 0)) {
+        return RHINO_WAIT_FOREVER;
+    }
+
+    wq->dly_keeper = krhino_cur_task_get();
+    wq->dly_match  = match;
+
+    if ((tick_i_t)(match - g_tick_count) <= 0) {
+        return 1u;
+    }
+
+    return match - g_tick_count;
+}
+
 static void worker_task(void *arg)
 {
     CPSR_ALLOC();
@@ -32,39 +157,132 @@ static void worker_task(void *arg)
     kstat_t       ret;
     kwork_t      *work = NULL;
     kworkqueue_t *queue = (kworkqueue_t *)arg;
+    uint8_t       idx;
+    uint8_t       wake;
+    tick_t        ticks;
+#if (RHINO_CONFIG_WORKQUEUE_STATS > 0)
+    hr_timer_t    start;
+#endif
+
+    idx = (uint8_t)(krhino_cur_task_get() - queue->worker);
 
     while (1) {
+        RHINO_CRITICAL_ENTER();
 
-        ret = krhino_sem_take(&(queue->sem), RHINO_WAIT_FOREVER);
-        if (ret != RHINO_SUCCESS) {
-            k_err_proc(ret);
-        }
+        workqueue_dly_expire(queue);
 
-        RHINO_CRITICAL_ENTER();
+        if (is_klist_empty(&(queue->work_list))) {
+            ticks = workqueue_dly_wait(queue);
+            queue->worker_idle++;
+            RHINO_CRITICAL_EXIT();
+
+            ret = krhino_sem_take(&(queue->sem), ticks);
+            if ((ret != RHINO_SUCCESS) && (ret != RHINO_BLK_TIMEOUT)) {
+                k_err_proc(ret);
+            }
+
+            RHINO_CRITICAL_ENTER();
+            queue->worker_idle--;
+            if (queue->dly_keeper == krhino_cur_task_get()) {
+                queue->dly_keeper = NULL;
+            }
+            RHINO_CRITICAL_EXIT();
+            continue;
+        }
 
         /* have work to do. */
         work = krhino_list_entry(queue->work_list.next, kwork_t, work_node);
         klist_rm_init(&(work->work_node));
-        queue->work_current = work;
+        queue->work_num--;
+        queue->work_current[idx] = work;
         work->work_exit = 0;
+
+        /* leave the other works and the delay wheel to an idle worker */
+        wake = (queue->worker_idle > 0u) &&
+               (!is_klist_empty(&(queue->work_list)) ||
+                ((queue->dly_keeper == NULL) && (workqueue_dly_is_empty(queue) == RHINO_FALSE)));
+
+#if (RHINO_CONFIG_WORKQUEUE_STATS > 0)
+        start = HR_COUNT_GET();
+        queue->stats.latency[workqueue_hist_idx(start - work->pend_time)]++;
+#endif
         RHINO_CRITICAL_EXIT();
 
+        if (wake) {
+            krhino_sem_give(&(queue->sem));
+        }
+
         /* do work */
         work->handle(work->arg);
         RHINO_CRITICAL_ENTER();
         /* clean current work */
-        queue->work_current = NULL;
+        queue->work_current[idx] = NULL;
 
+#if (RHINO_CONFIG_WORKQUEUE_STATS > 0)
+        queue->stats.exec[workqueue_hist_idx(HR_COUNT_GET() - start)]++;
+        queue->stats.work_done++;
+#endif
         RHINO_CRITICAL_EXIT();
     }
 }
 
-kstat_t krhino_workqueue_create(kworkqueue_t *workqueue, const name_t *name,
-                                uint8_t pri, cpu_stack_t *stack_buf, size_t stack_size)
+/* undo the creation of the first num workers, which are suspended and never ran */
+static void workqueue_workers_drop(kworkqueue_t *workqueue, uint8_t num)
+{
+#if (RHINO_CONFIG_TASK_DEL == 0)
+    CPSR_ALLOC();
+#endif
+    uint8_t i;
+
+    for (i = 0u; i < num; i++) {
+#if (RHINO_CONFIG_TASK_DEL > 0)
+        (void)krhino_task_del(&(workqueue->worker[i]));
+#else
+        RHINO_CRITICAL_ENTER();
+        workqueue->worker[i].task_state = K_DELETED;
+#if (RHINO_CONFIG_SYSTEM_STATS > 0)
+        klist_rm(&(workqueue->worker[i].task_stats_item));
+#endif
+        RHINO_CRITICAL_EXIT();
+#endif
+    }
+}
+
+/* make the suspended workers ready together, as autorun does for one task */
+static void workqueue_workers_start(kworkqueue_t *workqueue)
+{
+    CPSR_ALLOC();
+
+    ktask_t *task;
+    uint8_t  i;
+
+    RHINO_CRITICAL_ENTER();
+
+    for (i = 0u; i < workqueue->worker_num; i++) {
+        task = &(workqueue->worker[i]);
+        task->suspend_count = 0u;
+        task->task_state    = K_RDY;
+        ready_list_add_tail(task_rq(task), task);
+    }
+
+    if (g_sys_stat == RHINO_RUNNING) {
+        RHINO_CRITICAL_EXIT_SCHED();
+        return;
+    }
+
+    RHINO_CRITICAL_EXIT();
+}
+
+kstat_t krhino_workqueue_pool_create(kworkqueue_t *workqueue, const name_t *name,
+                                     uint8_t pri, cpu_stack_t *stack_buf,
+                                     size_t stack_size, uint8_t worker_num,
+                                     uint8_t flag)
 {
     CPSR_ALLOC();
 
     kstat_t ret;
+    size_t  worker_stack;
+    uint8_t i;
 
     NULL_PARA_CHK(workqueue);
     NULL_PARA_CHK(name);
@@ -74,7 +292,12 @@ kstat_t krhino_workqueue_create(kworkqueue_t *workqueue, const name_t *name,
         return RHINO_BEYOND_MAX_PRI;
     }
 
-    if (stack_size == 0u) {
+    if ((worker_num == 0u) || (worker_num > RHINO_CONFIG_WORKQUEUE_WORKER_MAX)) {
+        return RHINO_INV_PARAM;
+    }
+
+    worker_stack = stack_size / worker_num;
+    if (worker_stack == 0u) {
         return RHINO_TASK_INV_STACK_SIZE;
     }
 
@@ -85,8 +308,21 @@ kstat_t krhino_workqueue_create(kworkqueue_t *workqueue, const name_t *name,
 
     klist_init(&(workqueue->workqueue_node));
     klist_init(&(workqueue->work_list));
-    workqueue->work_current = NULL;
-    workqueue->name      = name;
+    memset(workqueue->work_current, 0, sizeof(workqueue->work_current));
+    workqueue->name        = name;
+    workqueue->worker_num  = worker_num;
+    workqueue->worker_idle = 0u;
+    workqueue->flag        = flag;
+    workqueue->work_num    = 0u;
+    workqueue->dly_keeper  = NULL;
+    workqueue->dly_match   = 0u;
+
+#if (RHINO_CONFIG_WORKQUEUE_STATS > 0)
+    memset(&(workqueue->stats), 0, sizeof(kworkqueue_stats_t));
+#endif
+
+    tick_wheel_init(&(workqueue->dly_wheel), (size_t)(&((kwork_t *)0)->work_node),
+                    (size_t)(&((kwork_t *)0)->match), krhino_sys_tick_get());
 
     ret = krhino_sem_create(&(workqueue->sem), "WORKQUEUE-SEM", 0);
     if (ret != RHINO_SUCCESS) {
@@ -97,61 +333,38 @@ kstat_t krhino_workqueue_create(kworkqueue_t *workqueue, const name_t *name,
     klist_insert(&g_workqueue_list_head, &(workqueue->workqueue_node));
     RHINO_CRITICAL_EXIT();
 
-    ret = krhino_task_create(&(workqueue->worker), name, (void *)workqueue, pri,
-                             0, stack_buf, stack_size, worker_task, 1);
-    if (ret != RHINO_SUCCESS) {
-        RHINO_CRITICAL_ENTER();
-        klist_rm_init(&(workqueue->workqueue_node));
-        RHINO_CRITICAL_EXIT();
-        krhino_sem_del(&(workqueue->sem));
-        return ret;
+    /* the workers start once all of them exist, so a failure can undo the others */
+    for (i = 0u; i < worker_num; i++) {
+        ret = krhino_task_create(&(workqueue->worker[i]), name, (void *)workqueue, pri,
+                                 0, stack_buf + i * worker_stack, worker_stack,
+                                 worker_task, 0);
+        if (ret != RHINO_SUCCESS) {
+            workqueue_workers_drop(workqueue, i);
+            RHINO_CRITICAL_ENTER();
+            klist_rm_init(&(workqueue->workqueue_node));
+            RHINO_CRITICAL_EXIT();
+            krhino_sem_del(&(workqueue->sem));
+            return ret;
+        }
     }
 
+    workqueue_workers_start(workqueue);
+
     TRACE_WORKQUEUE_CREATE(krhino_cur_task_get(), workqueue);
 
     return RHINO_SUCCESS;
 }
 
-static void work_timer_cb(void *timer, void *arg)
+kstat_t krhino_workqueue_create(kworkqueue_t *workqueue, const name_t *name,
+                                uint8_t pri, cpu_stack_t *stack_buf, size_t stack_size)
 {
-    CPSR_ALLOC();
-
-    kstat_t       ret;
-    kwork_t      *work = ((ktimer_t *)timer)->priv;
-
-    kworkqueue_t *wq   = (kworkqueue_t *)arg;
-
-    RHINO_CRITICAL_ENTER();
-    if (wq->work_current == work) {
-        RHINO_CRITICAL_EXIT();
-        return;
-    }
-
-    if (work->work_exit == 1) {
-        RHINO_CRITICAL_EXIT();
-        return;
-    }
-
-    /* NOTE: the work MUST be initialized firstly */
-    klist_rm_init(&(work->work_node));
-    klist_insert(&(wq->work_list), &(work->work_node));
-
-    work->wq = wq;
-    work->work_exit = 1;
-    RHINO_CRITICAL_EXIT();
-
-    ret = krhino_sem_give(&(wq->sem));
-    if (ret != RHINO_SUCCESS) {
-        return;
-    }
-
+    return krhino_workqueue_pool_create(workqueue, name, pri, stack_buf, stack_size,
+                                        1u, 0u);
 }
 
 kstat_t krhino_work_init(kwork_t *work, work_handle_t handle, void *arg,
                          tick_t dly)
 {
-    kstat_t ret;
-
     if (work == NULL) {
         return RHINO_NULL_PTR;
     }
@@ -166,20 +379,37 @@ kstat_t krhino_work_init(kwork_t *work, work_handle_t handle, void *arg,
     memset(work, 0, sizeof(kwork_t));
 
     klist_init(&(work->work_node));
-    work->handle  = handle;
-    work->arg     = arg;
-    work->dly     = dly;
-    work->wq      = NULL;
+    work->handle   = handle;
+    work->arg      = arg;
+    work->dly      = dly;
+    work->dly_head = NULL;
+    work->wq       = NULL;
+    work->pri      = WORKQUEUE_WORK_PRI_DEFAULT;
 
-    if (dly > 0) {
-        ret = krhino_timer_dyn_create((ktimer_t **)(&work->timer), "WORK-TIMER", work_timer_cb,
-                                       work->dly, 0, (void *)work, 0);
-        if (ret != RHINO_SUCCESS) {
-            return ret;
-        }
+    TRACE_WORK_INIT(krhino_cur_task_get(), work);
+
+    return RHINO_SUCCESS;
+}
+
+kstat_t krhino_work_pri_set(kwork_t *work, uint8_t pri)
+{
+    CPSR_ALLOC();
+    kworkqueue_t *wq;
+
+    NULL_PARA_CHK(work);
+
+    RHINO_CRITICAL_ENTER();
+
+    work->pri = pri;
+
+    /* a pending work moves to its new place */
+    wq = (kworkqueue_t *)work->wq;
+    if ((work->work_exit == 1) && ((wq->flag & WORKQUEUE_FLAG_PRI) != 0u)) {
+        klist_rm(&(work->work_node));
+        workqueue_work_insert(wq, work);
     }
 
-    TRACE_WORK_INIT(krhino_cur_task_get(), work);
+    RHINO_CRITICAL_EXIT();
 
     return RHINO_SUCCESS;
 }
@@ -188,7 +418,7 @@ kstat_t krhino_work_run(kworkqueue_t *workqueue, kwork_t *work)
 {
     CPSR_ALLOC();
 
-    kstat_t ret;
+    uint8_t wake;
 
     NULL_PARA_CHK(workqueue);
     NULL_PARA_CHK(work);
@@ -196,7 +426,7 @@ kstat_t krhino_work_run(kworkqueue_t *workqueue, kwork_t *work)
     RHINO_CRITICAL_ENTER();
 
     if (work->dly == 0) {
-        if (workqueue->work_current == work) {
+        if (workqueue_work_running(workqueue, work) == RHINO_TRUE) {
             RHINO_CRITICAL_EXIT();
             return RHINO_WORKQUEUE_WORK_RUNNING;
         }
@@ -208,24 +438,39 @@ kstat_t krhino_work_run(kworkqueue_t *workqueue, kwork_t *work)
 
         /* NOTE: the work MUST be initialized firstly */
         klist_rm_init(&(work->work_node));
-        klist_insert(&(workqueue->work_list), &(work->work_node));
-
-        work->wq = workqueue;
-        work->work_exit = 1;
+        workqueue_work_pend(workqueue, work);
 
-        RHINO_CRITICAL_EXIT();
-        ret = krhino_sem_give(&(workqueue->sem));
-        if (ret != RHINO_SUCCESS) {
-            return ret;
+        wake = (workqueue->worker_idle > 0u);
+    } else {
+        if (work->work_exit == 1) {
+            RHINO_CRITICAL_EXIT();
+            return RHINO_WORKQUEUE_WORK_EXIST;
         }
 
-    } else {
-        work->timer->priv = work;
-        RHINO_CRITICAL_EXIT();
-        ret = krhino_timer_arg_change_auto(work->timer, (void *)workqueue);
-        if (ret != RHINO_SUCCESS) {
-            return ret;
+        /* running it again restarts the delay */
+        if (work->dly_head != NULL) {
+            workqueue_dly_rm(work);
         }
+
+        /* catch the wheel up before inserting relative to now */
+        workqueue_dly_expire(workqueue);
+
+        work->wq       = workqueue;
+        work->match    = g_tick_count + work->dly;
+        work->dly_head = tick_wheel_insert(&(workqueue->dly_wheel), &(work->work_node),
+                                           work->match);
+
+        /* an idle worker has to pick up the new deadline if it comes first */
+        wake = (workqueue->worker_idle > 0u) &&
+               (!is_klist_empty(&(workqueue->work_list)) ||
+                (workqueue->dly_keeper == NULL) ||
+                ((tick_i_t)(work->match - workqueue->dly_match) < 0));
+    }
+
+    RHINO_CRITICAL_EXIT();
+
+    if (wake) {
+        return krhino_sem_give(&(workqueue->sem));
     }
 
     return RHINO_SUCCESS;
@@ -243,17 +488,23 @@ kstat_t krhino_work_cancel(kwork_t *work)
 
     NULL_PARA_CHK(work);
 
+    RHINO_CRITICAL_ENTER();
+
     wq = (kworkqueue_t *)work->wq;
 
     if (wq == NULL) {
-        if (work->dly > 0) {
-            krhino_timer_stop(work->timer);
-        }
+        RHINO_CRITICAL_EXIT();
         return RHINO_SUCCESS;
     }
 
-    RHINO_CRITICAL_ENTER();
-    if (wq->work_current == work) {
+    if (work->dly_head != NULL) {
+        workqueue_dly_rm(work);
+        work->wq = NULL;
+        RHINO_CRITICAL_EXIT();
+        return RHINO_SUCCESS;
+    }
+
+    if (workqueue_work_running(wq, work) == RHINO_TRUE) {
         RHINO_CRITICAL_EXIT();
         return RHINO_WORKQUEUE_WORK_RUNNING;
     }
@@ -270,6 +521,35 @@ kstat_t krhino_work_cancel(kwork_t *work)
     return RHINO_SUCCESS;
 }
 
+#if (RHINO_CONFIG_WORKQUEUE_STATS > 0)
+kstat_t krhino_workqueue_stats_get(kworkqueue_t *workqueue, kworkqueue_stats_t *stats)
+{
+    CPSR_ALLOC();
+
+    NULL_PARA_CHK(workqueue);
+    NULL_PARA_CHK(stats);
+
+    RHINO_CRITICAL_ENTER();
+    memcpy(stats, &(workqueue->stats), sizeof(kworkqueue_stats_t));
+    RHINO_CRITICAL_EXIT();
+
+    return RHINO_SUCCESS;
+}
+
+kstat_t krhino_workqueue_stats_reset(kworkqueue_t *workqueue)
+{
+    CPSR_ALLOC();
+
+    NULL_PARA_CHK(workqueue);
+
+    RHINO_CRITICAL_ENTER();
+    memset(&(workqueue->stats), 0, sizeof(kworkqueue_stats_t));
+    RHINO_CRITICAL_EXIT();
+
+    return RHINO_SUCCESS;
+}
+#endif
+
 void workqueue_init(void)
 {
     klist_init(&g_workqueue_list_head);
@@ -5,7 +5,7 @@ $(NAME)_MBINS_TYPE := kernel
 
 $(NAME)_COMPONENTS += rhino
 
-GLOBAL_INCLUDES += core/include
+GLOBAL_INCLUDES += core/include common
 
 #default gcc
 ifeq ($(COMPILER),)
@@ -28,11 +28,14 @@ $(NAME)_SOURCES := core/k_err.c          \
                    core/k_buf_queue.c    \
                    core/k_event.c        \
                    core/k_mm_blk.c       \
+                   core/k_mm_slab.c      \
+                   core/k_mm_prof.c      \
                    core/k_mutex.c        \
                    core/k_pend.c         \
                    core/k_sched.c        \
                    core/k_sys.c          \
                    core/k_tick.c         \
+                   core/k_tick_wheel.c   \
                    core/k_workqueue.c    \
                    core/k_dyn_mem_proc.c \
                    core/k_idle.c         \
@@ -42,5 +45,6 @@ $(NAME)_SOURCES := core/k_err.c          \
                    core/k_task.c         \
                    core/k_time.c         \
                    common/k_fifo.c       \
+                   common/k_lfring.c     \
                    common/k_trace.c
 
@@ -0,0 +1,177 @@
+/*
+ * Copyright (C) 2015-2017 Alibaba Group Holding Limited
+ */
+
+#include <stdio.h>
+#include <k_api.h>
+#include <test_fw.h>
+
+#include "buf_queue_test.h"
+
+#define TEST_BUFQUEUE_BUF0_SIZE  64
+#define TEST_BUFQUEUE_MSG_MAX    8
+#define TEST_BUFQUEUE_MSG_NUM    4
+#define TEST_BUFQUEUE_BATCH_NUM  6
+
+#define TEST_BUFQUEUE_RCV_TASK_RPI  10
+#define TEST_BUFQUEUE_SND_TASK_RPI  11
+
+static ktask_t      *task_0_test;
+static ktask_t      *task_1_test;
+static uint8_t       g_test_send_buf[TEST_BUFQUEUE_BATCH_NUM * TEST_BUFQUEUE_MSG_MAX];
+static uint8_t       g_test_recv_buf[TEST_BUFQUEUE_BATCH_NUM * TEST_BUFQUEUE_MSG_MAX];
+static size_t        g_test_send_size[TEST_BUFQUEUE_BATCH_NUM] = {1, 2, 3, 4, 5, 6};
+static size_t        g_test_recv_size[TEST_BUFQUEUE_BATCH_NUM];
+static char          g_test_bufqueue_buf0[TEST_BUFQUEUE_BUF0_SIZE];
+static char          g_test_bufqueue_buf1[TEST_BUFQUEUE_MSG_NUM * TEST_BUFQUEUE_MSG_MAX];
+
+static kbuf_queue_t  g_test_bufqueue0;
+static kbuf_queue_t  g_test_bufqueue1;
+
+static void buf_queue_batch_param_test(void)
+{
+    kstat_t ret;
+    size_t  num;
+    size_t  size[2] = {TEST_BUFQUEUE_MSG_MAX, TEST_BUFQUEUE_MSG_MAX + 1};
+
+    ret = krhino_buf_queue_send_batch(NULL, g_test_send_buf, g_test_send_size, 1, &num);
+    BUFQUEUE_VAL_CHK(ret == RHINO_NULL_PTR);
+
+    ret = krhino_buf_queue_send_batch(&g_test_bufqueue0, g_test_send_buf,
+                                      g_test_send_size, 0, &num);
+    BUFQUEUE_VAL_CHK(ret == RHINO_INV_PARAM);
+
+    /* a dyn buf queue needs the msg sizes */
+    ret = krhino_buf_queue_send_batch(&g_test_bufqueue0, g_test_send_buf, NULL, 1, &num);
+    BUFQUEUE_VAL_CHK(ret == RHINO_NULL_PTR);
+
+    /* the batch stops at the first bad msg */
+    ret = krhino_buf_queue_send_batch(&g_test_bufqueue0, g_test_send_buf, size, 2, &num);
+    BUFQUEUE_VAL_CHK(ret == RHINO_BUF_QUEUE_MSG_SIZE_OVERFLOW);
+    BUFQUEUE_VAL_CHK(num == 1);
+
+    ret = krhino_buf_queue_recv_batch(&g_test_bufqueue0, RHINO_NO_WAIT, g_test_recv_buf,
+                                      TEST_BUFQUEUE_MSG_MAX - 1, g_test_recv_size,
+                                      TEST_BUFQUEUE_BATCH_NUM, &num);
+    BUFQUEUE_VAL_CHK(ret == RHINO_INV_PARAM);
+
+    ret = krhino_buf_queue_recv_batch(&g_test_bufqueue0, RHINO_NO_WAIT, g_test_recv_buf,
+                                      sizeof(g_test_recv_buf), g_test_recv_size,
+                                      TEST_BUFQUEUE_BATCH_NUM, &num);
+    BUFQUEUE_VAL_CHK(ret == RHINO_SUCCESS);
+    BUFQUEUE_VAL_CHK(num == 1);
+    BUFQUEUE_VAL_CHK(g_test_recv_size[0] == TEST_BUFQUEUE_MSG_MAX);
+
+    ret = krhino_buf_queue_recv_batch(&g_test_bufqueue0, RHINO_NO_WAIT, g_test_recv_buf,
+                                      sizeof(g_test_recv_buf), g_test_recv_size,
+                                      TEST_BUFQUEUE_BATCH_NUM, &num);
+    BUFQUEUE_VAL_CHK(ret == RHINO_NO_PEND_WAIT);
+    BUFQUEUE_VAL_CHK(num == 0);
+}
+
+static void task_buf_queue0_entry(void *arg)
+{
+    kstat_t ret;
+    size_t  num;
+    size_t  off;
+    size_t  i;
+
+    while (1) {
+        buf_queue_batch_param_test();
+
+        /* one msg is copied to the receiver, the queue holds the next ones */
+        ret = krhino_buf_queue_recv_batch(&g_test_bufqueue0, RHINO_WAIT_FOREVER,
+                                          g_test_recv_buf, sizeof(g_test_recv_buf),
+                                          g_test_recv_size, TEST_BUFQUEUE_BATCH_NUM,
+                                          &num);
+        BUFQUEUE_VAL_CHK(ret == RHINO_SUCCESS);
+        BUFQUEUE_VAL_CHK(num == TEST_BUFQUEUE_BATCH_NUM);
+
+        for (i = 0, off = 0; i < num; i++) {
+            BUFQUEUE_VAL_CHK(g_test_recv_size[i] == g_test_send_size[i]);
+            off += g_test_send_size[i];
+        }
+        BUFQUEUE_VAL_CHK(memcmp(g_test_recv_buf, g_test_send_buf, off) == 0);
+
+        /* fix buf queue, all msgs are max_msg_size long */
+        ret = krhino_buf_queue_send_batch(&g_test_bufqueue1, g_test_send_buf, NULL,
+                                          TEST_BUFQUEUE_BATCH_NUM, &num);
+        BUFQUEUE_VAL_CHK(ret == RHINO_BUF_QUEUE_FULL);
+        BUFQUEUE_VAL_CHK(num == TEST_BUFQUEUE_MSG_NUM);
+
+        ret = krhino_buf_queue_recv_batch(&g_test_bufqueue1, RHINO_NO_WAIT,
+                                          g_test_recv_buf, sizeof(g_test_recv_buf),
+                                          g_test_recv_size, TEST_BUFQUEUE_BATCH_NUM,
+                                          &num);
+        BUFQUEUE_VAL_CHK(ret == RHINO_SUCCESS);
+        BUFQUEUE_VAL_CHK(num == TEST_BUFQUEUE_MSG_NUM);
+        BUFQUEUE_VAL_CHK(g_test_recv_size[TEST_BUFQUEUE_MSG_NUM - 1] == TEST_BUFQUEUE_MSG_MAX);
+        BUFQUEUE_VAL_CHK(memcmp(g_test_recv_buf, g_test_send_buf,
+                                TEST_BUFQUEUE_MSG_NUM * TEST_BUFQUEUE_MSG_MAX) == 0);
+
+        if (test_case_check_err == 0) {
+            test_case_success++;
+            PRINT_RESULT("buf queue batch", PASS);
+        } else {
+            test_case_check_err = 0;
+            test_case_fail++;
+            PRINT_RESULT("buf queue batch", FAIL);
+        }
+
+        krhino_buf_queue_del(&g_test_bufqueue0);
+        krhino_buf_queue_del(&g_test_bufqueue1);
+        next_test_case_notify();
+        krhino_task_dyn_del(task_0_test);
+    }
+}
+
+static void task_buf_queue1_entry(void *arg)
+{
+    kstat_t ret;
+    size_t  num;
+
+    while (1) {
+        /* the receiver runs only after the whole batch is in */
+        ret = krhino_buf_queue_send_batch(&g_test_bufqueue0, g_test_send_buf,
+                                          g_test_send_size, TEST_BUFQUEUE_BATCH_NUM,
+                                          &num);
+        BUFQUEUE_VAL_CHK(ret == RHINO_SUCCESS);
+        BUFQUEUE_VAL_CHK(num == TEST_BUFQUEUE_BATCH_NUM);
+
+        krhino_task_dyn_del(task_1_test);
+    }
+}
+
+kstat_t task_buf_queue_batch_test(void)
+{
+    kstat_t ret;
+    size_t  i;
+
+    test_case_check_err = 0;
+
+    for (i = 0; i < sizeof(g_test_send_buf); i++) {
+        g_test_send_buf[i] = (uint8_t)i;
+    }
+
+    ret = krhino_buf_queue_create(&g_test_bufqueue0, "test_bufqueue0",
+                                  g_test_bufqueue_buf0, TEST_BUFQUEUE_BUF0_SIZE,
+                                  TEST_BUFQUEUE_MSG_MAX);
+    BUFQUEUE_VAL_CHK(ret == RHINO_SUCCESS);
+
+    ret = krhino_fix_buf_queue_create(&g_test_bufqueue1, "test_bufqueue1",
+                                      g_test_bufqueue_buf1, TEST_BUFQUEUE_MSG_MAX,
+                                      TEST_BUFQUEUE_MSG_NUM);
+    BUFQUEUE_VAL_CHK(ret == RHINO_SUCCESS);
+
+    ret = krhino_task_dyn_create(&task_0_test, "task_bufqueue0_test", 0,
+                                 TEST_BUFQUEUE_RCV_TASK_RPI, 0, TASK_TEST_STACK_SIZE,
+                                 task_buf_queue0_entry, 1);
+    BUFQUEUE_VAL_CHK((ret == RHINO_SUCCESS) || (ret == RHINO_STOPPED));
+
+    ret = krhino_task_dyn_create(&task_1_test, "task_bufqueue1_test", 0,
+                                 TEST_BUFQUEUE_SND_TASK_RPI, 0, TASK_TEST_STACK_SIZE,
+                                 task_buf_queue1_entry, 1);
+    BUFQUEUE_VAL_CHK((ret == RHINO_SUCCESS) || (ret == RHINO_STOPPED));
+
+    return 0;
+}
@@ -24,5 +24,8 @@ void buf_queue_test(void)
     task_buf_queue_dyn_create_test();
     next_test_case_wait();
 
+    task_buf_queue_batch_test();
+    next_test_case_wait();
+
 }
 
@@ -23,5 +23,6 @@ kstat_t task_buf_queue_del_test(void);
 kstat_t task_buf_queue_flush_test(void);
 kstat_t task_buf_queue_info_get_test(void);
 kstat_t task_buf_queue_dyn_create_test(void);
+kstat_t task_buf_queue_batch_test(void);
 
 #endif /* BUF_QUEUE_TEST_H */
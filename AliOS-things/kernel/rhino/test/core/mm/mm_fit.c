@@ -0,0 +1,164 @@
+/*
+ * Copyright (C) 2015-2017 Alibaba Group Holding Limited
+ */
+
+#include <k_api.h>
+#include <test_fw.h>
+#include "mm_test.h"
+
+#define MODULE_NAME "mm_fit"
+
+#if (RHINO_CONFIG_MM_TLF > 0)
+
+#define FIT_BIG_SIZE     2048
+#define FIT_REGION_SIZE  4096
+#define FIT_BLK_NUM      7
+
+static char fit_region[FIT_REGION_SIZE];
+
+static const size_t fit_size[FIT_BLK_NUM] = {40, 100, 200, 400, 72, 64, 300};
+
+/* free blks merge back to the one they were split from */
+static uint8_t mm_fit_case1(void)
+{
+    kstat_t ret;
+    void   *big;
+    void   *ptr;
+    void   *blk[FIT_BLK_NUM];
+    int     i;
+
+    ret = krhino_init_mm_head(&pmmhead, (void *)mm_pool, MM_POOL_SIZE);
+    MYASSERT(ret == RHINO_SUCCESS);
+
+    ret = krhino_add_mm_region(pmmhead, fit_region, sizeof(fit_region));
+    MYASSERT(ret == RHINO_SUCCESS);
+
+    big = k_mm_alloc(pmmhead, FIT_BIG_SIZE);
+    MYASSERT(big != NULL);
+    k_mm_free(pmmhead, big);
+
+    for (i = 0; i < FIT_BLK_NUM; i++) {
+        blk[i] = k_mm_alloc(pmmhead, fit_size[i]);
+        MYASSERT(blk[i] != NULL);
+    }
+
+    for (i = 1; i < FIT_BLK_NUM; i += 2) {
+        k_mm_free(pmmhead, blk[i]);
+    }
+
+    for (i = 0; i < FIT_BLK_NUM; i += 2) {
+        k_mm_free(pmmhead, blk[i]);
+    }
+
+    ptr = k_mm_alloc(pmmhead, FIT_BIG_SIZE);
+    MYASSERT(ptr == big);
+    k_mm_free(pmmhead, ptr);
+
+    krhino_deinit_mm_head(pmmhead);
+
+    return 0;
+}
+
+/* an added region serves what the first one can not */
+static uint8_t mm_fit_case2(void)
+{
+    kstat_t ret;
+    char   *ptr[4];
+    int     i;
+    int     num;
+
+    ret = krhino_init_mm_head(&pmmhead, (void *)mm_pool, MM_POOL_SIZE);
+    MYASSERT(ret == RHINO_SUCCESS);
+
+    ret = krhino_add_mm_region(pmmhead, fit_region, sizeof(fit_region));
+    MYASSERT(ret == RHINO_SUCCESS);
+
+    for (num = 0; num < 4; num++) {
+        ptr[num] = k_mm_alloc(pmmhead, FIT_REGION_SIZE / 2 + FIT_REGION_SIZE / 4);
+        if (ptr[num] == NULL) {
+            break;
+        }
+    }
+    MYASSERT(num > 0);
+
+    for (i = 0; i < num; i++) {
+        if (ptr[i] > fit_region && ptr[i] < fit_region + FIT_REGION_SIZE) {
+            break;
+        }
+    }
+    MYASSERT(i < num);
+
+    for (i = 0; i < num; i++) {
+        k_mm_free(pmmhead, ptr[i]);
+    }
+
+    krhino_deinit_mm_head(pmmhead);
+
+    return 0;
+}
+
+#if (RHINO_CONFIG_MM_SL_BITS >= 3)
+/* the second level lists hand out the hole that fits, not a split
+   of the biggest blk */
+static uint8_t mm_fit_case3(void)
+{
+    kstat_t ret;
+    void   *hole[2];
+    void   *pin[2];
+    void   *ptr;
+
+    ret = krhino_init_mm_head(&pmmhead, (void *)mm_pool, MM_POOL_SIZE);
+    MYASSERT(ret == RHINO_SUCCESS);
+
+    hole[0] = k_mm_alloc(pmmhead, 120);
+    pin[0]  = k_mm_alloc(pmmhead, 40);
+    hole[1] = k_mm_alloc(pmmhead, 72);
+    pin[1]  = k_mm_alloc(pmmhead, 40);
+    MYASSERT(hole[0] != NULL && hole[1] != NULL);
+    MYASSERT(pin[0] != NULL && pin[1] != NULL);
+
+    k_mm_free(pmmhead, hole[0]);
+    k_mm_free(pmmhead, hole[1]);
+
+    ptr = k_mm_alloc(pmmhead, 100);
+    MYASSERT(ptr == hole[0]);
+    k_mm_free(pmmhead, ptr);
+
+    ptr = k_mm_alloc(pmmhead, 72);
+    MYASSERT(ptr == hole[1]);
+    k_mm_free(pmmhead, ptr);
+
+    k_mm_free(pmmhead, pin[0]);
+    k_mm_free(pmmhead, pin[1]);
+
+    krhino_deinit_mm_head(pmmhead);
+
+    return 0;
+}
+#endif
+
+static const test_func_t mm_func_runner[] = {
+    mm_fit_case1,
+    mm_fit_case2,
+#if (RHINO_CONFIG_MM_SL_BITS >= 3)
+    mm_fit_case3,
+#endif
+    NULL
+};
+
+void mm_fit_test(void)
+{
+    kstat_t ret;
+
+    task_mm_entry_register(MODULE_NAME, (test_func_t *)mm_func_runner,
+                           sizeof(mm_func_runner) / sizeof(test_func_t));
+
+    ret = krhino_task_dyn_create(&task_mm, MODULE_NAME, 0, TASK_MM_PRI,
+                                 0, TASK_TEST_STACK_SIZE, task_mm_entry, 1);
+    if ((ret != RHINO_SUCCESS) && (ret != RHINO_STOPPED)) {
+        test_case_fail++;
+        PRINT_RESULT(MODULE_NAME, FAIL);
+    }
+}
+
+#endif
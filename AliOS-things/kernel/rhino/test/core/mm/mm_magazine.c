@@ -0,0 +1,143 @@
+/*
+ * Copyright (C) 2015-2017 Alibaba Group Holding Limited
+ */
+
+#include <k_api.h>
+#include <test_fw.h>
+#include "mm_test.h"
+
+#define MODULE_NAME "mm_magazine"
+
+#if (RHINO_CONFIG_MM_TLF > 0) && (RHINO_CONFIG_MM_MAGAZINE > 0)
+
+/* level 1 request, cached at its aligned size */
+#define MAG_TEST_SIZE   100
+
+static uint8_t mm_magazine_case1(void)
+{
+    void   *ptr;
+    void   *newptr;
+#if (K_MM_STATISTIC > 0)
+    size_t  hit;
+#endif
+
+    krhino_mm_magazine_trim();
+
+    ptr = krhino_mm_alloc(MAG_TEST_SIZE);
+    MYASSERT(ptr != NULL);
+    MYASSERT(MM_GET_BUF_SIZE(MM_GET_THIS_BLK(ptr)) == MM_ALIGN_UP(MAG_TEST_SIZE));
+
+    krhino_mm_free(ptr);
+
+#if (K_MM_STATISTIC > 0)
+    hit = g_kmm_head->mag[cpu_cur_get()][1].hit;
+#endif
+
+    /* LIFO, the block just freed comes back first */
+    newptr = krhino_mm_alloc(MAG_TEST_SIZE - 30);
+    MYASSERT(newptr == ptr);
+
+#if (K_MM_STATISTIC > 0)
+    MYASSERT(g_kmm_head->mag[cpu_cur_get()][1].hit == hit + 1);
+#endif
+
+    krhino_mm_free(newptr);
+    krhino_mm_magazine_trim();
+
+    return 0;
+}
+
+static uint8_t mm_magazine_case2(void)
+{
+    void    *ptr[RHINO_CONFIG_MM_MAGAZINE_SIZE * 2];
+    uint32_t i;
+#if (K_MM_STATISTIC > 0)
+    size_t   used;
+#endif
+
+    krhino_mm_magazine_trim();
+
+#if (K_MM_STATISTIC > 0)
+    used = g_kmm_head->used_size;
+#endif
+
+    /* runs the magazine empty and full again, refill and flush in batches */
+    for (i = 0; i < RHINO_CONFIG_MM_MAGAZINE_SIZE * 2; i++) {
+        ptr[i] = krhino_mm_alloc(MM_MAG_BUF_SIZE(2));
+        MYASSERT(ptr[i] != NULL);
+        memset(ptr[i], (int)i, MM_MAG_BUF_SIZE(2));
+    }
+
+    for (i = 0; i < RHINO_CONFIG_MM_MAGAZINE_SIZE * 2; i++) {
+        krhino_mm_free(ptr[i]);
+    }
+
+    MYASSERT(g_kmm_head->mag[cpu_cur_get()][2].cnt <= RHINO_CONFIG_MM_MAGAZINE_SIZE);
+
+    krhino_mm_magazine_trim();
+
+    MYASSERT(g_kmm_head->mag[cpu_cur_get()][2].cnt == 0);
+#if (K_MM_STATISTIC > 0)
+    MYASSERT(g_kmm_head->used_size == used);
+#endif
+
+    return 0;
+}
+
+static uint8_t mm_magazine_case3(void)
+{
+    char    *ptr;
+    char    *newptr;
+    uint32_t i;
+
+    /* a cached block is an ordinary heap block for realloc */
+    ptr = krhino_mm_alloc(MAG_TEST_SIZE);
+    MYASSERT(ptr != NULL);
+
+    for (i = 0; i < MAG_TEST_SIZE; i++) {
+        ptr[i] = (char)i;
+    }
+
+    newptr = krhino_mm_realloc(ptr, MM_MAG_BUF_SIZE(3) + 1);
+    MYASSERT(newptr != NULL);
+
+    for (i = 0; i < MAG_TEST_SIZE; i++) {
+        MYASSERT(newptr[i] == (char)i);
+    }
+
+    krhino_mm_free(newptr);
+
+    /* above the cached levels, straight to the heap */
+    ptr = krhino_mm_alloc(MM_MAG_BUF_SIZE(RHINO_CONFIG_MM_MAGAZINE_LEVELS - 1) + 1);
+    MYASSERT(ptr != NULL);
+    krhino_mm_free(ptr);
+
+    krhino_mm_magazine_trim();
+
+    return 0;
+}
+
+static const test_func_t mm_func_runner[] = {
+    mm_magazine_case1,
+    mm_magazine_case2,
+    mm_magazine_case3,
+    NULL
+};
+
+void mm_magazine_test(void)
+{
+    kstat_t ret;
+
+    task_mm_entry_register(MODULE_NAME, (test_func_t *)mm_func_runner,
+                           sizeof(mm_func_runner) / sizeof(test_func_t));
+
+    ret = krhino_task_dyn_create(&task_mm, MODULE_NAME, 0, TASK_MM_PRI,
+                                 0, TASK_TEST_STACK_SIZE, task_mm_entry, 1);
+    if ((ret != RHINO_SUCCESS) && (ret != RHINO_STOPPED)) {
+        test_case_fail++;
+        PRINT_RESULT(MODULE_NAME, FAIL);
+    }
+}
+
+#endif
+
@@ -0,0 +1,139 @@
+/*
+ * Copyright (C) 2015-2017 Alibaba Group Holding Limited
+ */
+
+#include <k_api.h>
+#include <test_fw.h>
+#include <string.h>
+#include "mm_test.h"
+
+#define MODULE_NAME "mm_prof"
+
+#if (RHINO_CONFIG_MM_TLF > 0) && (RHINO_CONFIG_MM_PROF > 0)
+
+#define PROF_TEST_SITE  0x1234u
+#define PROF_TEST_SIZE  100
+#define PROF_TEST_NUM   4
+
+static k_mm_prof_site_t prof_sites[RHINO_CONFIG_MM_PROF_SITES];
+static char             prof_text[1024];
+
+static k_mm_prof_site_t *prof_site_get(size_t site)
+{
+    uint32_t num;
+    uint32_t i;
+
+    num = krhino_mm_prof_sites_get(prof_sites, RHINO_CONFIG_MM_PROF_SITES, NULL);
+    for (i = 0; i < num; i++) {
+        if (prof_sites[i].site == site) {
+            return &prof_sites[i];
+        }
+    }
+
+    return NULL;
+}
+
+/* rate 1 samples every blk, the counters follow alloc, free and reset */
+static uint8_t mm_prof_case1(void)
+{
+    k_mm_prof_site_t *site;
+    void             *ptr[PROF_TEST_NUM];
+    size_t            rate;
+    int               i;
+
+    MYASSERT(krhino_mm_prof_start(1) == RHINO_SUCCESS);
+    krhino_mm_prof_sites_get(NULL, 0, &rate);
+    MYASSERT(rate == 1);
+
+    for (i = 0; i < PROF_TEST_NUM; i++) {
+        ptr[i] = krhino_mm_alloc(PROF_TEST_SIZE);
+        MYASSERT(ptr[i] != NULL);
+        MYASSERT(MM_GET_THIS_BLK(ptr[i])->buf_size & RHINO_MM_SAMPLED);
+        krhino_mm_prof_site_set(ptr[i], PROF_TEST_SITE);
+    }
+
+    site = prof_site_get(PROF_TEST_SITE);
+    MYASSERT(site != NULL);
+    MYASSERT(site->live_cnt == PROF_TEST_NUM);
+    MYASSERT(site->live_size == PROF_TEST_NUM * PROF_TEST_SIZE);
+
+    krhino_mm_free(ptr[0]);
+    krhino_mm_free(ptr[1]);
+
+    site = prof_site_get(PROF_TEST_SITE);
+    MYASSERT(site->live_cnt == PROF_TEST_NUM - 2);
+    MYASSERT(site->peak_size == PROF_TEST_NUM * PROF_TEST_SIZE);
+    MYASSERT(site->alloc_cnt == PROF_TEST_NUM);
+
+    krhino_mm_prof_reset();
+    site = prof_site_get(PROF_TEST_SITE);
+    MYASSERT(site->alloc_cnt == PROF_TEST_NUM - 2);
+    MYASSERT(site->peak_size == (PROF_TEST_NUM - 2) * PROF_TEST_SIZE);
+
+    /* a realloc is a free and a new sample */
+    ptr[2] = krhino_mm_realloc(ptr[2], PROF_TEST_SIZE * 2);
+    MYASSERT(ptr[2] != NULL);
+    site = prof_site_get(PROF_TEST_SITE);
+    MYASSERT(site->live_cnt == PROF_TEST_NUM - 3);
+
+    krhino_mm_free(ptr[2]);
+    krhino_mm_free(ptr[3]);
+
+    site = prof_site_get(PROF_TEST_SITE);
+    MYASSERT(site->live_cnt == 0 && site->live_size == 0);
+
+    krhino_mm_prof_stop();
+
+    return 0;
+}
+
+/* no samples when stopped, the pprof text names the site */
+static uint8_t mm_prof_case2(void)
+{
+    void   *ptr;
+    size_t  len;
+
+    krhino_mm_prof_stop();
+
+    ptr = krhino_mm_alloc(PROF_TEST_SIZE);
+    MYASSERT(ptr != NULL);
+    MYASSERT((MM_GET_THIS_BLK(ptr)->buf_size & RHINO_MM_SAMPLED) == 0);
+    krhino_mm_free(ptr);
+
+    len = krhino_mm_prof_pprof(NULL, 0);
+    MYASSERT(len > 0 && len < sizeof(prof_text) * 8);
+    MYASSERT(krhino_mm_prof_pprof(prof_text, sizeof(prof_text)) == len);
+    MYASSERT(strncmp(prof_text, "heap profile: ", 14) == 0);
+    if (len < sizeof(prof_text)) {
+        MYASSERT(strstr(prof_text, "@ 0x1234\n") != NULL);
+    }
+
+    MYASSERT(krhino_mm_prof_unsample(0, 0, 4096) == 0);
+    MYASSERT(krhino_mm_prof_unsample(1, 8, 4096) == 4100);
+    MYASSERT(krhino_mm_prof_unsample(2, 16384, 4096) == 16384 + 2 * 1024);
+
+    return 0;
+}
+
+static const test_func_t mm_func_runner[] = {
+    mm_prof_case1,
+    mm_prof_case2,
+    NULL
+};
+
+void mm_prof_test(void)
+{
+    kstat_t ret;
+
+    task_mm_entry_register(MODULE_NAME, (test_func_t *)mm_func_runner,
+                           sizeof(mm_func_runner) / sizeof(test_func_t));
+
+    ret = krhino_task_dyn_create(&task_mm, MODULE_NAME, 0, TASK_MM_PRI,
+                                 0, TASK_TEST_STACK_SIZE, task_mm_entry, 1);
+    if ((ret != RHINO_SUCCESS) && (ret != RHINO_STOPPED)) {
+        test_case_fail++;
+        PRINT_RESULT(MODULE_NAME, FAIL);
+    }
+}
+
+#endif
@@ -22,6 +22,13 @@ static const test_case_t mm_case_runner[] = {
     mm_break_test,
     mm_opr_test,
     mm_coopr_test,
+    mm_fit_test,
+#if (RHINO_CONFIG_MM_MAGAZINE > 0)
+    mm_magazine_test,
+#endif
+#if (RHINO_CONFIG_MM_PROF > 0)
+    mm_prof_test,
+#endif
     NULL
 };
 
@@ -28,6 +28,13 @@ void mm_param_test(void);
 void mm_break_test(void);
 void mm_opr_test(void);
 void mm_coopr_test(void);
+void mm_fit_test(void);
+#if (RHINO_CONFIG_MM_MAGAZINE > 0)
+void mm_magazine_test(void);
+#endif
+#if (RHINO_CONFIG_MM_PROF > 0)
+void mm_prof_test(void);
+#endif
 #endif
 #endif /* MM_TEST_H */
 
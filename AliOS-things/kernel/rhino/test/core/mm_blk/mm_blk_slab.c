@@ -0,0 +1,201 @@
+/*
+ * Copyright (C) 2015-2017 Alibaba Group Holding Limited
+ */
+
+#include <k_api.h>
+#include <test_fw.h>
+#include "mm_blk_test.h"
+
+#define MODULE_NAME "mm_blk_slab"
+
+#if (RHINO_CONFIG_MM_SLAB > 0)
+#define SLAB_TEST_OBJ_SIZE 40
+#define SLAB_TEST_OBJ_NUM  64
+#define SLAB_TEST_MAGIC    0x5a
+
+#define SLAB_TEST_PAGE(obj) ((k_slab_page_t *)((size_t)(obj) & ~SLAB_PAGE_MASK))
+
+static k_slab_cache_t slab_cache_test;
+static void          *slab_obj[SLAB_TEST_OBJ_NUM];
+static uint32_t       slab_ctor_cnt;
+
+static void slab_test_ctor(void *obj)
+{
+    memset(obj, SLAB_TEST_MAGIC, SLAB_TEST_OBJ_SIZE);
+    slab_ctor_cnt++;
+}
+
+static uint8_t mm_blk_slab_case1(void)
+{
+    kstat_t  ret;
+    uint32_t i;
+
+    ret = krhino_slab_cache_init(NULL, MODULE_NAME, SLAB_TEST_OBJ_SIZE, NULL);
+    MYASSERT(ret == RHINO_NULL_PTR);
+
+    ret = krhino_slab_cache_init(&slab_cache_test, MODULE_NAME, 0, NULL);
+    MYASSERT(ret == RHINO_INV_PARAM);
+
+    ret = krhino_slab_cache_init(&slab_cache_test, MODULE_NAME,
+                                 RHINO_CONFIG_MM_SLAB_PAGE_SIZE, NULL);
+    MYASSERT(ret == RHINO_INV_PARAM);
+
+    ret = krhino_slab_cache_init(&slab_cache_test, MODULE_NAME,
+                                 SLAB_TEST_OBJ_SIZE, slab_test_ctor);
+    MYASSERT(ret == RHINO_SUCCESS);
+    MYASSERT(slab_cache_test.page_num == 0);
+
+    /* more objects than a page holds, the cache grows */
+    slab_ctor_cnt = 0;
+    for (i = 0; i < SLAB_TEST_OBJ_NUM; i++) {
+        slab_obj[i] = krhino_slab_cache_alloc(&slab_cache_test);
+        MYASSERT(slab_obj[i] != NULL);
+        MYASSERT(*(uint8_t *)slab_obj[i] == SLAB_TEST_MAGIC);
+        MYASSERT(SLAB_TEST_PAGE(slab_obj[i])->cache == &slab_cache_test);
+    }
+    MYASSERT(slab_ctor_cnt == SLAB_TEST_OBJ_NUM);
+    MYASSERT(slab_cache_test.obj_inuse == SLAB_TEST_OBJ_NUM);
+    MYASSERT(slab_cache_test.page_num > 1);
+
+    ret = krhino_slab_cache_del(&slab_cache_test);
+    MYASSERT(ret == RHINO_KOBJ_DEL_ERR);
+
+    /* empty pages go back to the heap beyond the kept ones */
+    for (i = 0; i < SLAB_TEST_OBJ_NUM; i++) {
+        ret = krhino_slab_free(slab_obj[i]);
+        MYASSERT(ret == RHINO_SUCCESS);
+    }
+    MYASSERT(slab_cache_test.obj_inuse == 0);
+    MYASSERT(slab_cache_test.page_num == slab_cache_test.page_empty);
+    MYASSERT(slab_cache_test.page_num <= RHINO_CONFIG_MM_SLAB_EMPTY_PAGES);
+
+    ret = krhino_slab_cache_del(&slab_cache_test);
+    MYASSERT(ret == RHINO_SUCCESS);
+    MYASSERT(slab_cache_test.page_num == 0);
+
+    return 0;
+}
+
+static uint8_t mm_blk_slab_case2(void)
+{
+    void    *ptr;
+    size_t   size;
+    kstat_t  ret;
+
+    MYASSERT(krhino_slab_alloc(0) == NULL);
+    MYASSERT(krhino_slab_alloc((1u << SLAB_MAX_BIT) + 1) == NULL);
+
+    ret = krhino_slab_free(NULL);
+    MYASSERT(ret == RHINO_NULL_PTR);
+
+    /* each size lands in the smallest power of 2 class holding it */
+    for (size = 1; size <= (1u << SLAB_MAX_BIT); size += 7) {
+        ptr = krhino_slab_alloc(size);
+        MYASSERT(ptr != NULL);
+        MYASSERT(SLAB_TEST_PAGE(ptr)->cache->obj_size >= size);
+        MYASSERT(SLAB_TEST_PAGE(ptr)->cache->obj_size < size * 2 ||
+                 SLAB_TEST_PAGE(ptr)->cache->obj_size == (1u << SLAB_MIN_BIT));
+        memset(ptr, 0, size);
+
+        ret = krhino_slab_free(ptr);
+        MYASSERT(ret == RHINO_SUCCESS);
+    }
+
+    return 0;
+}
+
+static uint8_t mm_blk_slab_case3(void)
+{
+    void  *ptr;
+    size_t align;
+
+    for (align = 64; align <= RHINO_CONFIG_MM_SLAB_PAGE_SIZE; align <<= 1) {
+        ptr = k_mm_alloc_aligned(g_kmm_head, 100, align);
+        MYASSERT(ptr != NULL);
+        MYASSERT(((size_t)ptr & (align - 1)) == 0);
+        memset(ptr, 0, 100);
+        k_mm_free(g_kmm_head, ptr);
+    }
+
+    return 0;
+}
+
+#if (RHINO_CONFIG_KOBJ_DYN_ALLOC > 0)
+static void slab_test_timer_cb(void *timer, void *arg)
+{
+}
+
+static uint8_t mm_blk_slab_case4(void)
+{
+    ksem_t   *sem;
+    kmutex_t *mutex;
+    ktimer_t *timer;
+    size_t    inuse;
+    kstat_t   ret;
+
+#if (RHINO_CONFIG_SEM > 0)
+    inuse = g_slab_sem.obj_inuse;
+    ret = krhino_sem_dyn_create(&sem, MODULE_NAME, 0);
+    MYASSERT(ret == RHINO_SUCCESS);
+    MYASSERT(SLAB_TEST_PAGE(sem)->cache == &g_slab_sem);
+    MYASSERT(g_slab_sem.obj_inuse == inuse + 1);
+    ret = krhino_sem_dyn_del(sem);
+    MYASSERT(ret == RHINO_SUCCESS);
+    MYASSERT(g_slab_sem.obj_inuse == inuse);
+#endif
+
+    inuse = g_slab_mutex.obj_inuse;
+    ret = krhino_mutex_dyn_create(&mutex, MODULE_NAME);
+    MYASSERT(ret == RHINO_SUCCESS);
+    MYASSERT(SLAB_TEST_PAGE(mutex)->cache == &g_slab_mutex);
+    MYASSERT(g_slab_mutex.obj_inuse == inuse + 1);
+    ret = krhino_mutex_dyn_del(mutex);
+    MYASSERT(ret == RHINO_SUCCESS);
+    MYASSERT(g_slab_mutex.obj_inuse == inuse);
+
+#if (RHINO_CONFIG_TIMER > 0)
+    ret = krhino_timer_dyn_create(&timer, MODULE_NAME, slab_test_timer_cb,
+                                  10, 0, NULL, 0);
+    MYASSERT(ret == RHINO_SUCCESS);
+    MYASSERT(SLAB_TEST_PAGE(timer)->cache == &g_slab_timer);
+    ret = krhino_timer_dyn_del(timer);
+    MYASSERT(ret == RHINO_SUCCESS);
+#endif
+
+    /* this task itself comes from the task cache */
+    MYASSERT(SLAB_TEST_PAGE(krhino_cur_task_get())->cache == &g_slab_task);
+
+    (void)sem;
+    (void)timer;
+
+    return 0;
+}
+#endif
+#endif /* RHINO_CONFIG_MM_SLAB */
+
+static const test_func_t mm_blk_func_runner[] = {
+#if (RHINO_CONFIG_MM_SLAB > 0)
+    mm_blk_slab_case1,
+    mm_blk_slab_case2,
+    mm_blk_slab_case3,
+#if (RHINO_CONFIG_KOBJ_DYN_ALLOC > 0)
+    mm_blk_slab_case4,
+#endif
+#endif
+    NULL
+};
+
+void mm_blk_slab_test(void)
+{
+    kstat_t ret;
+
+    task_mm_blk_entry_register(MODULE_NAME, (test_func_t *)mm_blk_func_runner,
+                               sizeof(mm_blk_func_runner) / sizeof(test_func_t));
+
+    ret = krhino_task_dyn_create(&task_mm_blk, MODULE_NAME, 0, TASK_MM_BLK_PRI,
+                                 0, TASK_TEST_STACK_SIZE, task_mm_blk_entry, 1);
+    if ((ret != RHINO_SUCCESS) && (ret != RHINO_STOPPED)) {
+        test_case_fail++;
+        PRINT_RESULT(MODULE_NAME, FAIL);
+    }
+}
@@ -21,6 +21,7 @@ static const test_case_t mm_blk_case_runner[] = {
     mm_blk_break_test,
     mm_blk_reinit_test,
     mm_blk_fragment_test,
+    mm_blk_slab_test,
     mm_blk_coopr_test,
     NULL
 };
@@ -28,6 +28,7 @@ void mm_blk_opr_test(void);
 void mm_blk_break_test(void);
 void mm_blk_reinit_test(void);
 void mm_blk_fragment_test(void);
+void mm_blk_slab_test(void);
 void mm_blk_coopr_test(void);
 
 #endif /* MM_BLK_TEST_H */
@@ -0,0 +1,158 @@
+/*
+ * Copyright (C) 2015-2017 Alibaba Group Holding Limited
+ */
+
+#include <stdio.h>
+#include <k_api.h>
+#include <test_fw.h>
+
+#include "queue_test.h"
+
+#define TEST_QUEUE_MSG0_SIZE 4
+#define TEST_QUEUE_BATCH_NUM 8
+
+static ktask_t  *task_0_test;
+static ktask_t  *task_1_test;
+static void     *g_test_queue_msg0[TEST_QUEUE_MSG0_SIZE];
+static void     *g_test_send_msg[TEST_QUEUE_BATCH_NUM];
+static void     *g_test_recv_msg[TEST_QUEUE_BATCH_NUM];
+static kqueue_t  g_test_queue0;
+static uint8_t   g_test_batch_fail;
+
+#define QUEUE_BATCH_CHK(value) do {if ((int)(value) == 0) \
+        {g_test_batch_fail++; QUEUE_VAL_CHK(0);}} while (0)
+
+static void queue_batch_param_test(void)
+{
+    kstat_t ret;
+    size_t  num;
+    ksem_t  sem;
+
+    ret = krhino_queue_back_send_batch(NULL, g_test_send_msg, 1, &num);
+    QUEUE_BATCH_CHK(ret == RHINO_NULL_PTR);
+
+    ret = krhino_queue_back_send_batch(&g_test_queue0, NULL, 1, &num);
+    QUEUE_BATCH_CHK(ret == RHINO_NULL_PTR);
+
+    ret = krhino_queue_back_send_batch(&g_test_queue0, g_test_send_msg, 1, NULL);
+    QUEUE_BATCH_CHK(ret == RHINO_NULL_PTR);
+
+    ret = krhino_queue_back_send_batch(&g_test_queue0, g_test_send_msg, 0, &num);
+    QUEUE_BATCH_CHK(ret == RHINO_INV_PARAM);
+
+    ret = krhino_queue_recv_batch(NULL, RHINO_NO_WAIT, g_test_recv_msg, 1, &num);
+    QUEUE_BATCH_CHK(ret == RHINO_NULL_PTR);
+
+    ret = krhino_queue_recv_batch(&g_test_queue0, RHINO_NO_WAIT, g_test_recv_msg, 1,
+                                  NULL);
+    QUEUE_BATCH_CHK(ret == RHINO_NULL_PTR);
+
+    ret = krhino_queue_recv_batch(&g_test_queue0, RHINO_NO_WAIT, g_test_recv_msg, 0,
+                                  &num);
+    QUEUE_BATCH_CHK(ret == RHINO_INV_PARAM);
+
+    krhino_sem_create(&sem, "test_sem ", 0);
+    ret = krhino_queue_back_send_batch((kqueue_t *)&sem, g_test_send_msg, 1, &num);
+    QUEUE_BATCH_CHK(ret == RHINO_KOBJ_TYPE_ERR);
+    ret = krhino_queue_recv_batch((kqueue_t *)&sem, RHINO_NO_WAIT, g_test_recv_msg, 1,
+                                  &num);
+    QUEUE_BATCH_CHK(ret == RHINO_KOBJ_TYPE_ERR);
+    krhino_sem_del(&sem);
+}
+
+static void task_queue0_entry(void *arg)
+{
+    kstat_t ret;
+    size_t  num;
+    size_t  i;
+
+    while (1) {
+        queue_batch_param_test();
+
+        ret = krhino_queue_recv_batch(&g_test_queue0, RHINO_NO_WAIT, g_test_recv_msg,
+                                      TEST_QUEUE_BATCH_NUM, &num);
+        QUEUE_BATCH_CHK(ret == RHINO_NO_PEND_WAIT);
+        QUEUE_BATCH_CHK(num == 0);
+
+        /* one msg is handed over, the queue holds the next ones */
+        ret = krhino_queue_recv_batch(&g_test_queue0, RHINO_WAIT_FOREVER, g_test_recv_msg,
+                                      TEST_QUEUE_BATCH_NUM, &num);
+        QUEUE_BATCH_CHK(ret == RHINO_SUCCESS);
+        QUEUE_BATCH_CHK(num == TEST_QUEUE_MSG0_SIZE + 1);
+
+        for (i = 0; i < num; i++) {
+            QUEUE_BATCH_CHK(g_test_recv_msg[i] == g_test_send_msg[i]);
+        }
+
+        /* no receiver blocked, everything goes through the queue */
+        ret = krhino_queue_back_send_batch(&g_test_queue0, g_test_send_msg, 3, &num);
+        QUEUE_BATCH_CHK(ret == RHINO_SUCCESS);
+        QUEUE_BATCH_CHK(num == 3);
+
+        ret = krhino_queue_recv_batch(&g_test_queue0, RHINO_NO_WAIT, g_test_recv_msg, 2,
+                                      &num);
+        QUEUE_BATCH_CHK(ret == RHINO_SUCCESS);
+        QUEUE_BATCH_CHK(num == 2);
+        QUEUE_BATCH_CHK(g_test_recv_msg[1] == g_test_send_msg[1]);
+
+        ret = krhino_queue_recv_batch(&g_test_queue0, RHINO_NO_WAIT, g_test_recv_msg,
+                                      TEST_QUEUE_BATCH_NUM, &num);
+        QUEUE_BATCH_CHK(ret == RHINO_SUCCESS);
+        QUEUE_BATCH_CHK(num == 1);
+        QUEUE_BATCH_CHK(g_test_recv_msg[0] == g_test_send_msg[2]);
+
+        if (g_test_batch_fail == 0) {
+            test_case_success++;
+            PRINT_RESULT("queue batch", PASS);
+        } else {
+            test_case_fail++;
+            PRINT_RESULT("queue batch", FAIL);
+        }
+
+        krhino_queue_del(&g_test_queue0);
+        next_test_case_notify();
+        krhino_task_dyn_del(task_0_test);
+    }
+}
+
+static void task_queue1_entry(void *arg)
+{
+    kstat_t ret;
+    size_t  num;
+
+    while (1) {
+        /* the receiver runs only after the whole batch is in */
+        ret = krhino_queue_back_send_batch(&g_test_queue0, g_test_send_msg,
+                                           TEST_QUEUE_BATCH_NUM, &num);
+        QUEUE_BATCH_CHK(ret == RHINO_QUEUE_FULL);
+        QUEUE_BATCH_CHK(num == TEST_QUEUE_MSG0_SIZE + 1);
+
+        krhino_task_dyn_del(task_1_test);
+    }
+}
+
+kstat_t task_queue_batch_test(void)
+{
+    kstat_t ret;
+    size_t  i;
+
+    g_test_batch_fail = 0;
+
+    for (i = 0; i < TEST_QUEUE_BATCH_NUM; i++) {
+        g_test_send_msg[i] = (void *)(i + 1);
+    }
+
+    ret = krhino_queue_create(&g_test_queue0, "test_queue0",
+                              (void **)&g_test_queue_msg0, TEST_QUEUE_MSG0_SIZE);
+    QUEUE_VAL_CHK(ret == RHINO_SUCCESS);
+
+    ret = krhino_task_dyn_create(&task_0_test, "task_queue0_test", 0, 10,
+                                 0, TASK_TEST_STACK_SIZE, task_queue0_entry, 1);
+    QUEUE_VAL_CHK((ret == RHINO_SUCCESS) || (ret == RHINO_STOPPED));
+
+    ret = krhino_task_dyn_create(&task_1_test, "task_queue1_test", 0, 11,
+                                 0, TASK_TEST_STACK_SIZE, task_queue1_entry, 1);
+    QUEUE_VAL_CHK((ret == RHINO_SUCCESS) || (ret == RHINO_STOPPED));
+
+    return 0;
+}
@@ -26,5 +26,8 @@ void queue_test(void)
 
     task_queue_info_get_test();
     next_test_case_wait();
+
+    task_queue_batch_test();
+    next_test_case_wait();
 }
 
@@ -18,5 +18,6 @@ kstat_t task_queue_is_full_test(void);
 kstat_t task_queue_flush_test(void);
 kstat_t task_queue_del_test(void);
 kstat_t task_queue_info_get_test(void);
+kstat_t task_queue_batch_test(void);
 
 #endif /* QUEUE_TEST_H */
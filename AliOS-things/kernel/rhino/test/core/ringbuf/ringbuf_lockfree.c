@@ -0,0 +1,429 @@
+/*
+ * Copyright (C) 2015-2017 Alibaba Group Holding Limited
+ */
+
+#include <k_api.h>
+#include <k_ringbuf.h>
+#include <test_fw.h>
+#include "ringbuf_test.h"
+
+#if (RHINO_CONFIG_RINGBUF_LOCKFREE > 0)
+#include <k_lfring.h>
+#endif
+
+#define MODULE_NAME "ringbuf_lockfree"
+
+#define LFRING_FIX_LEN      4
+#define LFRING_FIX_SIZE     (LFRING_FIX_LEN * 4)
+#define LFRING_DYN_SIZE     64
+
+#if (RHINO_CONFIG_RINGBUF_LOCKFREE > 0)
+
+static k_spsc_ring_t g_spsc_ring;
+static k_mpsc_ring_t g_mpsc_ring;
+
+static uint32_t lfring_buf[LFRING_DYN_SIZE / sizeof(uint32_t)];
+static uint8_t  lfring_data[LFRING_DYN_SIZE];
+static uint8_t  lfring_rev[LFRING_DYN_SIZE];
+
+static char *push_data[] = {
+    "1111",
+    "2222",
+    "3333",
+    "4444",
+    "5555",
+    "6666"
+};
+
+#endif
+
+static uint8_t ringbuf_lockfree_case_spsc_fix(void)
+{
+#if (RHINO_CONFIG_RINGBUF_LOCKFREE > 0)
+    kstat_t  ret;
+    uint8_t  rev[LFRING_FIX_LEN * 4];
+    uint8_t *p;
+    size_t   len;
+    size_t   num;
+    size_t   i;
+
+    ret = krhino_spsc_ring_init(NULL, NULL, 0, 0, 0);
+    MYASSERT(ret == RHINO_NULL_PTR);
+
+    ret = krhino_spsc_ring_init(&g_spsc_ring, NULL, 0, RINGBUF_TYPE_FIX, 0);
+    MYASSERT(ret == RHINO_NULL_PTR);
+
+    ret = krhino_spsc_ring_init(&g_spsc_ring, lfring_buf, LFRING_FIX_SIZE,
+                                RINGBUF_TYPE_FIX, 0);
+    MYASSERT(ret == RHINO_INV_PARAM);
+
+    /* three blocks is not a power of 2 */
+    ret = krhino_spsc_ring_init(&g_spsc_ring, lfring_buf, LFRING_FIX_LEN * 3,
+                                RINGBUF_TYPE_FIX, LFRING_FIX_LEN);
+    MYASSERT(ret == RHINO_INV_PARAM);
+
+    ret = krhino_spsc_ring_init(&g_spsc_ring, lfring_buf, LFRING_FIX_SIZE,
+                                RINGBUF_TYPE_FIX, LFRING_FIX_LEN);
+    MYASSERT(ret == RHINO_SUCCESS);
+
+    ret = krhino_spsc_ring_push(&g_spsc_ring, push_data[0], 1);
+    MYASSERT(ret == RHINO_INV_PARAM);
+
+    ret = krhino_spsc_ring_pop(&g_spsc_ring, rev, &len);
+    MYASSERT(ret == RHINO_RINGBUF_EMPTY);
+
+    for (i = 0; i < 4; i++) {
+        ret = krhino_spsc_ring_push(&g_spsc_ring, push_data[i], LFRING_FIX_LEN);
+        MYASSERT(ret == RHINO_SUCCESS);
+    }
+
+    ret = krhino_spsc_ring_push(&g_spsc_ring, push_data[4], LFRING_FIX_LEN);
+    MYASSERT(ret == RHINO_RINGBUF_FULL);
+
+    ret = krhino_spsc_ring_pop(&g_spsc_ring, rev, NULL);
+    MYASSERT(ret == RHINO_SUCCESS);
+    MYASSERT(memcmp(rev, push_data[0], LFRING_FIX_LEN) == 0);
+
+    /* wraps around the buffer end */
+    ret = krhino_spsc_ring_push(&g_spsc_ring, push_data[4], LFRING_FIX_LEN);
+    MYASSERT(ret == RHINO_SUCCESS);
+
+    p = krhino_spsc_ring_peek(&g_spsc_ring, &len);
+    MYASSERT(p != NULL);
+    MYASSERT(len == LFRING_FIX_LEN);
+    MYASSERT(memcmp(p, push_data[1], LFRING_FIX_LEN) == 0);
+
+    ret = krhino_spsc_ring_consume(&g_spsc_ring);
+    MYASSERT(ret == RHINO_SUCCESS);
+
+    num = krhino_spsc_ring_pop_batch(&g_spsc_ring, rev, sizeof(rev), NULL, 4);
+    MYASSERT(num == 3);
+    MYASSERT(memcmp(&rev[0], push_data[2], LFRING_FIX_LEN) == 0);
+    MYASSERT(memcmp(&rev[LFRING_FIX_LEN * 2], push_data[4], LFRING_FIX_LEN) == 0);
+
+    ret = krhino_spsc_ring_is_empty(&g_spsc_ring);
+    MYASSERT(ret == true);
+
+    for (i = 0; i < 4; i++) {
+        memcpy(&rev[i * LFRING_FIX_LEN], push_data[i], LFRING_FIX_LEN);
+    }
+
+    num = krhino_spsc_ring_push_batch(&g_spsc_ring, rev, NULL, 5);
+    MYASSERT(num == 4);
+
+    p = krhino_spsc_ring_reserve(&g_spsc_ring, LFRING_FIX_LEN);
+    MYASSERT(p == NULL);
+
+    ret = krhino_spsc_ring_pop(&g_spsc_ring, rev, &len);
+    MYASSERT(ret == RHINO_SUCCESS);
+
+    p = krhino_spsc_ring_reserve(&g_spsc_ring, LFRING_FIX_LEN);
+    MYASSERT(p != NULL);
+    memcpy(p, push_data[5], LFRING_FIX_LEN);
+
+    ret = krhino_spsc_ring_commit(&g_spsc_ring, p, LFRING_FIX_LEN);
+    MYASSERT(ret == RHINO_SUCCESS);
+
+    for (i = 1; i < 4; i++) {
+        ret = krhino_spsc_ring_pop(&g_spsc_ring, rev, &len);
+        MYASSERT(ret == RHINO_SUCCESS);
+        MYASSERT(memcmp(rev, push_data[i], LFRING_FIX_LEN) == 0);
+    }
+
+    ret = krhino_spsc_ring_pop(&g_spsc_ring, rev, &len);
+    MYASSERT(ret == RHINO_SUCCESS);
+    MYASSERT(memcmp(rev, push_data[5], LFRING_FIX_LEN) == 0);
+#endif
+    return 0;
+}
+
+static uint8_t ringbuf_lockfree_case_spsc_dyn(void)
+{
+#if (RHINO_CONFIG_RINGBUF_LOCKFREE > 0)
+    kstat_t  ret;
+    uint8_t *p;
+    size_t   lens[3];
+    size_t   len;
+    size_t   num;
+    size_t   i;
+
+    for (i = 0; i < sizeof(lfring_data); i++) {
+        lfring_data[i] = (uint8_t)i;
+    }
+
+    /* dyn rings must be a power of 2 */
+    ret = krhino_spsc_ring_init(&g_spsc_ring, lfring_buf, LFRING_DYN_SIZE - 4,
+                                RINGBUF_TYPE_DYN, 0);
+    MYASSERT(ret == RHINO_INV_PARAM);
+
+    ret = krhino_spsc_ring_init(&g_spsc_ring, lfring_buf, LFRING_DYN_SIZE,
+                                RINGBUF_TYPE_DYN, 0);
+    MYASSERT(ret == RHINO_SUCCESS);
+
+    ret = krhino_spsc_ring_push(&g_spsc_ring, lfring_data, 0);
+    MYASSERT(ret == RHINO_INV_PARAM);
+
+    ret = krhino_spsc_ring_push(&g_spsc_ring, lfring_data, LFRING_DYN_SIZE);
+    MYASSERT(ret == RHINO_INV_PARAM);
+
+    ret = krhino_spsc_ring_push(&g_spsc_ring, lfring_data, 20);
+    MYASSERT(ret == RHINO_SUCCESS);
+
+    ret = krhino_spsc_ring_pop(&g_spsc_ring, lfring_rev, NULL);
+    MYASSERT(ret == RHINO_INV_PARAM);
+
+    ret = krhino_spsc_ring_pop(&g_spsc_ring, lfring_rev, &len);
+    MYASSERT(ret == RHINO_SUCCESS);
+    MYASSERT(len == 20);
+    MYASSERT(memcmp(lfring_rev, lfring_data, len) == 0);
+
+    /* 43 bytes left before the end, a 49 byte record would need the pad too */
+    ret = krhino_spsc_ring_push(&g_spsc_ring, lfring_data, 49);
+    MYASSERT(ret == RHINO_RINGBUF_FULL);
+
+    ret = krhino_spsc_ring_push(&g_spsc_ring, lfring_data, 40);
+    MYASSERT(ret == RHINO_SUCCESS);
+
+    ret = krhino_spsc_ring_pop(&g_spsc_ring, lfring_rev, &len);
+    MYASSERT(ret == RHINO_SUCCESS);
+    MYASSERT(len == 40);
+
+    /* 2 bytes left before the end, the record pads and restarts at 0 */
+    ret = krhino_spsc_ring_push(&g_spsc_ring, &lfring_data[1], 30);
+    MYASSERT(ret == RHINO_SUCCESS);
+
+    p = krhino_spsc_ring_peek(&g_spsc_ring, &len);
+    MYASSERT(p == (uint8_t *)lfring_buf + 1);
+    MYASSERT(len == 30);
+    MYASSERT(memcmp(p, &lfring_data[1], len) == 0);
+
+    ret = krhino_spsc_ring_consume(&g_spsc_ring);
+    MYASSERT(ret == RHINO_SUCCESS);
+
+    ret = krhino_spsc_ring_consume(&g_spsc_ring);
+    MYASSERT(ret == RHINO_RINGBUF_EMPTY);
+
+    /* batch of three, the last one does not fit */
+    lens[0] = 20;
+    lens[1] = 20;
+    lens[2] = 20;
+    num = krhino_spsc_ring_push_batch(&g_spsc_ring, lfring_data, lens, 3);
+    MYASSERT(num == 2);
+
+    p = krhino_spsc_ring_reserve(&g_spsc_ring, 8);
+    MYASSERT(p != NULL);
+    memcpy(p, &lfring_data[40], 8);
+
+    MYASSERT(krhino_spsc_ring_peek(&g_spsc_ring, &len) != NULL);
+
+    ret = krhino_spsc_ring_commit(&g_spsc_ring, p, 8);
+    MYASSERT(ret == RHINO_SUCCESS);
+
+    num = krhino_spsc_ring_pop_batch(&g_spsc_ring, lfring_rev, sizeof(lfring_rev), lens, 3);
+    MYASSERT(num == 3);
+    MYASSERT((lens[0] == 20) && (lens[1] == 20) && (lens[2] == 8));
+    MYASSERT(memcmp(lfring_rev, lfring_data, 48) == 0);
+
+    ret = krhino_spsc_ring_is_empty(&g_spsc_ring);
+    MYASSERT(ret == true);
+#endif
+    return 0;
+}
+
+static uint8_t ringbuf_lockfree_case_mpsc_fix(void)
+{
+#if (RHINO_CONFIG_RINGBUF_LOCKFREE > 0)
+    kstat_t  ret;
+    uint8_t  rev[LFRING_FIX_LEN * 4];
+    uint8_t *p;
+    uint8_t *q;
+    size_t   len;
+    size_t   num;
+    size_t   i;
+
+    ret = krhino_mpsc_ring_init(NULL, NULL, 0, 0, 0);
+    MYASSERT(ret == RHINO_NULL_PTR);
+
+    ret = krhino_mpsc_ring_init(&g_mpsc_ring, (uint8_t *)lfring_buf + 1, LFRING_DYN_SIZE - 4,
+                                RINGBUF_TYPE_FIX, LFRING_FIX_LEN);
+    MYASSERT(ret == RHINO_INV_PARAM);
+
+    /* 64 bytes hold 8 blocks with their sequence words */
+    ret = krhino_mpsc_ring_init(&g_mpsc_ring, lfring_buf, LFRING_DYN_SIZE,
+                                RINGBUF_TYPE_FIX, LFRING_FIX_LEN);
+    MYASSERT(ret == RHINO_SUCCESS);
+
+    ret = krhino_mpsc_ring_pop(&g_mpsc_ring, rev, &len);
+    MYASSERT(ret == RHINO_RINGBUF_EMPTY);
+
+    for (i = 0; i < 8; i++) {
+        ret = krhino_mpsc_ring_push(&g_mpsc_ring, push_data[i % 6], LFRING_FIX_LEN);
+        MYASSERT(ret == RHINO_SUCCESS);
+    }
+
+    ret = krhino_mpsc_ring_push(&g_mpsc_ring, push_data[0], LFRING_FIX_LEN);
+    MYASSERT(ret == RHINO_RINGBUF_FULL);
+
+    for (i = 0; i < 8; i++) {
+        ret = krhino_mpsc_ring_pop(&g_mpsc_ring, rev, &len);
+        MYASSERT(ret == RHINO_SUCCESS);
+        MYASSERT(len == LFRING_FIX_LEN);
+        MYASSERT(memcmp(rev, push_data[i % 6], LFRING_FIX_LEN) == 0);
+    }
+
+    /* a reserved block holds back the blocks committed after it */
+    p = krhino_mpsc_ring_reserve(&g_mpsc_ring, LFRING_FIX_LEN);
+    q = krhino_mpsc_ring_reserve(&g_mpsc_ring, LFRING_FIX_LEN);
+    MYASSERT((p != NULL) && (q != NULL) && (p != q));
+
+    memcpy(q, push_data[1], LFRING_FIX_LEN);
+    ret = krhino_mpsc_ring_commit(&g_mpsc_ring, q, LFRING_FIX_LEN);
+    MYASSERT(ret == RHINO_SUCCESS);
+
+    ret = krhino_mpsc_ring_is_empty(&g_mpsc_ring);
+    MYASSERT(ret == true);
+
+    memcpy(p, push_data[0], LFRING_FIX_LEN);
+    ret = krhino_mpsc_ring_commit(&g_mpsc_ring, p, LFRING_FIX_LEN);
+    MYASSERT(ret == RHINO_SUCCESS);
+
+    for (i = 0; i < 4; i++) {
+        memcpy(&rev[i * LFRING_FIX_LEN], push_data[i + 2], LFRING_FIX_LEN);
+    }
+
+    /* all or nothing */
+    num = krhino_mpsc_ring_push_batch(&g_mpsc_ring, rev, NULL, 7);
+    MYASSERT(num == 0);
+
+    num = krhino_mpsc_ring_push_batch(&g_mpsc_ring, rev, NULL, 4);
+    MYASSERT(num == 4);
+
+    num = krhino_mpsc_ring_pop_batch(&g_mpsc_ring, rev, sizeof(rev), NULL, 8);
+    MYASSERT(num == 4);
+    MYASSERT(memcmp(&rev[0], push_data[0], LFRING_FIX_LEN) == 0);
+    MYASSERT(memcmp(&rev[LFRING_FIX_LEN], push_data[1], LFRING_FIX_LEN) == 0);
+
+    p = krhino_mpsc_ring_peek(&g_mpsc_ring, &len);
+    MYASSERT(p != NULL);
+    MYASSERT(memcmp(p, push_data[4], LFRING_FIX_LEN) == 0);
+
+    ret = krhino_mpsc_ring_consume(&g_mpsc_ring);
+    MYASSERT(ret == RHINO_SUCCESS);
+
+    ret = krhino_mpsc_ring_pop(&g_mpsc_ring, rev, &len);
+    MYASSERT(ret == RHINO_SUCCESS);
+    MYASSERT(memcmp(rev, push_data[5], LFRING_FIX_LEN) == 0);
+
+    ret = krhino_mpsc_ring_is_empty(&g_mpsc_ring);
+    MYASSERT(ret == true);
+#endif
+    return 0;
+}
+
+static uint8_t ringbuf_lockfree_case_mpsc_dyn(void)
+{
+#if (RHINO_CONFIG_RINGBUF_LOCKFREE > 0)
+    kstat_t  ret;
+    uint8_t *p;
+    uint8_t *q;
+    size_t   lens[2];
+    size_t   len;
+    size_t   num;
+    size_t   i;
+
+    for (i = 0; i < sizeof(lfring_data); i++) {
+        lfring_data[i] = (uint8_t)(i + 1);
+    }
+
+    ret = krhino_mpsc_ring_init(&g_mpsc_ring, lfring_buf, LFRING_DYN_SIZE,
+                                RINGBUF_TYPE_DYN, 0);
+    MYASSERT(ret == RHINO_SUCCESS);
+
+    ret = krhino_mpsc_ring_push(&g_mpsc_ring, lfring_data, 0);
+    MYASSERT(ret == RHINO_INV_PARAM);
+
+    ret = krhino_mpsc_ring_push(&g_mpsc_ring, lfring_data, 30);
+    MYASSERT(ret == RHINO_SUCCESS);
+
+    ret = krhino_mpsc_ring_pop(&g_mpsc_ring, lfring_rev, &len);
+    MYASSERT(ret == RHINO_SUCCESS);
+    MYASSERT(len == 30);
+    MYASSERT(memcmp(lfring_rev, lfring_data, len) == 0);
+
+    /* two producers in flight, the later one commits first */
+    p = krhino_mpsc_ring_reserve(&g_mpsc_ring, 20);
+    q = krhino_mpsc_ring_reserve(&g_mpsc_ring, 20);
+    MYASSERT((p != NULL) && (q != NULL));
+
+    /* 12 bytes left before the end, the second record is padded to the start */
+    MYASSERT(q == (uint8_t *)lfring_buf + 1);
+
+    memcpy(q, &lfring_data[20], 20);
+    ret = krhino_mpsc_ring_commit(&g_mpsc_ring, q, 20);
+    MYASSERT(ret == RHINO_SUCCESS);
+
+    MYASSERT(krhino_mpsc_ring_peek(&g_mpsc_ring, &len) == NULL);
+
+    memcpy(p, lfring_data, 20);
+    ret = krhino_mpsc_ring_commit(&g_mpsc_ring, p, 20);
+    MYASSERT(ret == RHINO_SUCCESS);
+
+    ret = krhino_mpsc_ring_push(&g_mpsc_ring, lfring_data, 30);
+    MYASSERT(ret == RHINO_RINGBUF_FULL);
+
+    num = krhino_mpsc_ring_pop_batch(&g_mpsc_ring, lfring_rev, sizeof(lfring_rev), lens, 2);
+    MYASSERT(num == 2);
+    MYASSERT((lens[0] == 20) && (lens[1] == 20));
+    MYASSERT(memcmp(lfring_rev, lfring_data, 40) == 0);
+
+    /* a consumed region reads as unpublished again */
+    MYASSERT(krhino_mpsc_ring_is_empty(&g_mpsc_ring) == true);
+
+    lens[0] = 10;
+    lens[1] = 25;
+    num = krhino_mpsc_ring_push_batch(&g_mpsc_ring, lfring_data, lens, 2);
+    MYASSERT(num == 2);
+
+    p = krhino_mpsc_ring_peek(&g_mpsc_ring, &len);
+    MYASSERT(p != NULL);
+    MYASSERT(len == 10);
+    MYASSERT(memcmp(p, lfring_data, len) == 0);
+
+    ret = krhino_mpsc_ring_consume(&g_mpsc_ring);
+    MYASSERT(ret == RHINO_SUCCESS);
+
+    ret = krhino_mpsc_ring_pop(&g_mpsc_ring, lfring_rev, &len);
+    MYASSERT(ret == RHINO_SUCCESS);
+    MYASSERT(len == 25);
+    MYASSERT(memcmp(lfring_rev, &lfring_data[10], len) == 0);
+
+    ret = krhino_mpsc_ring_pop(&g_mpsc_ring, lfring_rev, &len);
+    MYASSERT(ret == RHINO_RINGBUF_EMPTY);
+#endif
+    return 0;
+}
+
+static const test_func_t ringbuf_func_runner[] = {
+    ringbuf_lockfree_case_spsc_fix,
+    ringbuf_lockfree_case_spsc_dyn,
+    ringbuf_lockfree_case_mpsc_fix,
+    ringbuf_lockfree_case_mpsc_dyn,
+    NULL
+};
+
+void ringbuf_lockfree_test(void)
+{
+    kstat_t ret;
+
+    task_ringbuf_entry_register(MODULE_NAME, (test_func_t *)ringbuf_func_runner,
+                                sizeof(ringbuf_func_runner) / sizeof(test_func_t));
+
+    ret = krhino_task_dyn_create(&task_ringbuf, MODULE_NAME, 0, TASK_RINGBUF_PRI,
+                                 0, TASK_TEST_STACK_SIZE, task_ringbuf_entry, 1);
+
+    if ((ret != RHINO_SUCCESS) && (ret != RHINO_STOPPED)) {
+        test_case_fail++;
+        PRINT_RESULT(MODULE_NAME, FAIL);
+    }
+}
+
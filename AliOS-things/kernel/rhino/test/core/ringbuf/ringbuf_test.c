@@ -17,6 +17,7 @@ static uint8_t      module_casenum;
 
 static const test_case_t ringbuf_case_runner[] = {
     ringbuf_break_test,
+    ringbuf_lockfree_test,
     NULL
 };
 
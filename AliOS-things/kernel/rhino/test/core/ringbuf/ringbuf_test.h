@@ -20,6 +20,7 @@ void task_ringbuf_entry_register(const char *name, test_func_t *runner,
 void task_ringbuf_entry(void *arg);
 void ringbuf_test(void);
 void ringbuf_break_test(void);
+void ringbuf_lockfree_test(void);
 
 #endif /* RINGBUF_TEST_H */
 
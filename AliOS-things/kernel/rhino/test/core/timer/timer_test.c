@@ -20,5 +20,10 @@ void timer_test(void)
 
     task_timer_change_test();
     next_test_case_wait();
+
+#if (RHINO_CONFIG_TICK_WHEEL > 0)
+    task_timer_wheel_test();
+    next_test_case_wait();
+#endif
 }
 
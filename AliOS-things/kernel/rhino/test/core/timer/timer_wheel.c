@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2015-2017 Alibaba Group Holding Limited
+ */
+
+#include <stdio.h>
+#include <k_api.h>
+#include <test_fw.h>
+
+#include "timer_test.h"
+
+#if (RHINO_CONFIG_TICK_WHEEL > 0)
+typedef struct {
+    klist_t node;
+    tick_t  match;
+} wheel_node_t;
+
+static ktask_t        *task_0_test;
+static k_tick_wheel_t  wheel_0_test;
+static wheel_node_t    node_0_test;
+static wheel_node_t    node_1_test;
+
+static void wheel_node_insert(wheel_node_t *node, tick_t match)
+{
+    node->match = match;
+    (void)tick_wheel_insert(&wheel_0_test, &node->node, match);
+}
+
+/* nodes removed after a cascade moved them must not leave their slot marked */
+static void task_wheel0_entry(void *arg)
+{
+    klist_t expired;
+    tick_t  match;
+
+    while (1) {
+        klist_init(&expired);
+        tick_wheel_init(&wheel_0_test, (size_t)(&((wheel_node_t *)0)->node),
+                        (size_t)(&((wheel_node_t *)0)->match), 0u);
+
+        /* one level 1 slot, cascaded to level 0 at tick 32 */
+        wheel_node_insert(&node_0_test, 40u);
+        tick_wheel_advance(&wheel_0_test, 35u, &expired);
+        TIMER_VAL_CHK(is_klist_empty(&expired));
+
+        tick_wheel_rm(&wheel_0_test, &node_0_test.node);
+        TIMER_VAL_CHK(tick_wheel_next(&wheel_0_test, &match) == RHINO_FALSE);
+
+        /* the other node cascaded with it keeps its deadline */
+        wheel_node_insert(&node_0_test, 70u);
+        wheel_node_insert(&node_1_test, 75u);
+        tick_wheel_advance(&wheel_0_test, 66u, &expired);
+        TIMER_VAL_CHK(is_klist_empty(&expired));
+
+        tick_wheel_rm(&wheel_0_test, &node_0_test.node);
+        TIMER_VAL_CHK(tick_wheel_next(&wheel_0_test, &match) == RHINO_TRUE);
+        TIMER_VAL_CHK(match == 75u);
+
+        tick_wheel_advance(&wheel_0_test, 75u, &expired);
+        TIMER_VAL_CHK(expired.next == &node_1_test.node);
+        TIMER_VAL_CHK(tick_wheel_next(&wheel_0_test, &match) == RHINO_FALSE);
+
+        test_case_success++;
+
+        PRINT_RESULT("timer wheel", PASS);
+        next_test_case_notify();
+        krhino_task_dyn_del(task_0_test);
+    }
+}
+
+kstat_t task_timer_wheel_test(void)
+{
+    kstat_t ret;
+
+    ret = krhino_task_dyn_create(&task_0_test, "task_wheel0_test", 0, 10,
+                                 0, TASK_TEST_STACK_SIZE, task_wheel0_entry, 1);
+    TIMER_VAL_CHK((ret == RHINO_SUCCESS) || (ret == RHINO_STOPPED));
+
+    return 0;
+}
+#endif
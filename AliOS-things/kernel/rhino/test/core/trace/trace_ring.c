@@ -0,0 +1,279 @@
+/*
+ * Copyright (C) 2015-2017 Alibaba Group Holding Limited
+ */
+
+#include <k_api.h>
+#include <test_fw.h>
+#include "trace_test.h"
+
+#define MODULE_NAME "trace_ring"
+
+#if (RHINO_CONFIG_TRACE > 0)
+#define TRACE_GIVE_NUM  (RHINO_CONFIG_TRACE_RING_SIZE * 2)
+#define TRACE_REC_NUM   (RHINO_CONFIG_TRACE_RING_SIZE * 2 + 8)
+
+#define TRACE_CHK(value) do {if ((int)(value) == 0) \
+        {MYASSERT(0); return 1;}} while (0)
+
+static k_trace_rec_t trace_rec[TRACE_REC_NUM];
+static ksem_t        trace_sem;
+
+/* SYNC records may show up anywhere, drop them unless asked for */
+static size_t trace_rec_drain(uint8_t sync)
+{
+    size_t num;
+    size_t i;
+    size_t cnt;
+
+    num = trace_drain(trace_rec, sizeof(trace_rec)) / sizeof(k_trace_rec_t);
+
+    for (i = 0, cnt = 0; i < num; i++) {
+        if (sync || (trace_rec[i].id != TRACE_ID_SYNC)) {
+            trace_rec[cnt++] = trace_rec[i];
+        }
+    }
+
+    return cnt;
+}
+
+static size_t trace_rec_count(size_t num, uint16_t id, uintptr_t *sum)
+{
+    size_t i;
+    size_t cnt;
+
+    for (i = 0, cnt = 0; i < num; i++) {
+        if (trace_rec[i].id == id) {
+            cnt++;
+            if (sum != NULL) {
+                *sum += trace_rec[i].obj;
+            }
+        }
+    }
+
+    return cnt;
+}
+
+/* a ring starts with a SYNC, creates carry the name */
+static uint8_t trace_ring_case1(void)
+{
+    size_t   num;
+    size_t   i;
+    uint32_t name;
+
+    TRACE_CHK(trace_drain(NULL, sizeof(trace_rec)) == 0);
+
+    _trace_init();
+    num = trace_rec_drain(1);
+    TRACE_CHK(num > 0);
+    TRACE_CHK(trace_rec[0].id == TRACE_ID_SYNC);
+    TRACE_CHK(trace_rec[1].id == TRACE_ID_INIT);
+    TRACE_CHK(trace_rec[1].obj == (uintptr_t)krhino_cur_task_get());
+
+    krhino_sem_create(&trace_sem, "trace", 0);
+    krhino_sem_give(&trace_sem);
+
+    num = trace_rec_drain(0);
+    TRACE_CHK(num >= 4);
+    TRACE_CHK(trace_rec[0].id == TRACE_ID_SEM_CREATE);
+    TRACE_CHK(trace_rec[0].obj == (uintptr_t)&trace_sem);
+
+    memcpy(&name, "trac", sizeof(name));
+    TRACE_CHK(trace_rec[1].id == TRACE_ID_NAME);
+    TRACE_CHK(trace_rec[1].arg0 == 0);
+    TRACE_CHK(trace_rec[1].arg == name);
+    TRACE_CHK(trace_rec[2].id == TRACE_ID_NAME);
+    TRACE_CHK(trace_rec[2].arg0 == 4);
+
+    for (i = 0; i < num; i++) {
+        if (trace_rec[i].id == TRACE_ID_SEM_CNT_INCREASE) {
+            break;
+        }
+    }
+    TRACE_CHK(i < num);
+    TRACE_CHK(trace_rec[i].arg == 1);
+
+    return 0;
+}
+
+/* overwrite keeps the newest records and reports the rest */
+static uint8_t trace_ring_case2(void)
+{
+    size_t    num;
+    size_t    cnt;
+    uintptr_t lost;
+    uint32_t  i;
+
+    set_event_mask(TRACE_ID_SEM_CNT_INCREASE);
+    trace_mode_set(TRACE_MODE_OVERWRITE);
+
+    for (i = 0; i < TRACE_GIVE_NUM; i++) {
+        krhino_sem_give(&trace_sem);
+    }
+
+    num  = trace_rec_drain(0);
+    lost = 0;
+    cnt  = trace_rec_count(num, TRACE_ID_SEM_CNT_INCREASE, NULL);
+
+    TRACE_CHK(trace_rec[0].id == TRACE_ID_LOST);
+    TRACE_CHK(trace_rec[0].arg0 == 1);
+    TRACE_CHK(trace_rec_count(num, TRACE_ID_LOST, &lost) == 1);
+    TRACE_CHK(cnt < RHINO_CONFIG_TRACE_RING_SIZE);
+    TRACE_CHK(cnt + lost >= TRACE_GIVE_NUM);
+
+    /* the newest one is there */
+    TRACE_CHK(trace_rec[num - 1].id == TRACE_ID_SEM_CNT_INCREASE);
+    TRACE_CHK(trace_rec[num - 1].arg == trace_sem.count);
+
+    return 0;
+}
+
+/* stop keeps the oldest records, the deltas stay chained */
+static uint8_t trace_ring_case3(void)
+{
+    size_t    num;
+    size_t    cnt;
+    uintptr_t lost;
+    uint32_t  first;
+    uint32_t  i;
+
+    trace_mode_set(TRACE_MODE_STOP);
+
+    first = trace_sem.count + 1;
+
+    for (i = 0; i < TRACE_GIVE_NUM; i++) {
+        krhino_sem_give(&trace_sem);
+    }
+
+    num  = trace_rec_drain(0);
+    lost = 0;
+    cnt  = trace_rec_count(num, TRACE_ID_SEM_CNT_INCREASE, NULL);
+
+    TRACE_CHK(trace_rec_count(num, TRACE_ID_LOST, &lost) == 1);
+    TRACE_CHK(trace_rec[num - 1].id == TRACE_ID_LOST);
+    TRACE_CHK(trace_rec[num - 1].arg0 == 0);
+    TRACE_CHK(cnt + lost == TRACE_GIVE_NUM);
+
+    for (i = 0; i < num; i++) {
+        if (trace_rec[i].id == TRACE_ID_SEM_CNT_INCREASE) {
+            TRACE_CHK(trace_rec[i].arg == first++);
+        }
+    }
+
+    /* the ring has room again */
+    krhino_sem_give(&trace_sem);
+    num = trace_rec_drain(0);
+    TRACE_CHK(trace_rec_count(num, TRACE_ID_SEM_CNT_INCREASE, NULL) == 1);
+
+    trace_mode_set(TRACE_MODE_OVERWRITE);
+    set_event_mask(0);
+    krhino_sem_del(&trace_sem);
+
+    return 0;
+}
+
+static kqueue_t     trace_queue;
+static void        *trace_queue_msg[4];
+static kbuf_queue_t trace_buf_queue;
+static uint8_t      trace_buf_queue_buf[64];
+static ktask_t     *trace_recv_task;
+
+static void trace_recv_entry(void *arg)
+{
+    void  *msg[2];
+    size_t recved;
+
+    (void)arg;
+
+    krhino_queue_recv_batch(&trace_queue, RHINO_WAIT_FOREVER, msg, 2, &recved);
+    krhino_task_dyn_del(krhino_cur_task_get());
+}
+
+/* the batch paths trace like the single msg ones */
+static uint8_t trace_ring_case4(void)
+{
+    void     *msg[2];
+    uint8_t   buf[32];
+    size_t    size[2];
+    size_t    cnt;
+    size_t    num;
+    uintptr_t obj;
+    kstat_t   ret;
+
+    krhino_queue_create(&trace_queue, "trace_q", trace_queue_msg, 4);
+    krhino_buf_queue_create(&trace_buf_queue, "trace_bq", trace_buf_queue_buf,
+                            sizeof(trace_buf_queue_buf), 16);
+    trace_rec_drain(0);
+
+    /* a receiver blocks, one batch hands it a msg and queues the other */
+    ret = krhino_task_dyn_create(&trace_recv_task, "trace_recv", 0, TASK_TRACE_PRI - 1,
+                                 0, TASK_TEST_STACK_SIZE, trace_recv_entry, 1);
+    TRACE_CHK(ret == RHINO_SUCCESS);
+
+    msg[0] = &trace_queue;
+    msg[1] = &trace_buf_queue;
+    krhino_queue_back_send_batch(&trace_queue, msg, 2, &cnt);
+    TRACE_CHK(cnt == 2);
+
+    num = trace_rec_drain(0);
+    obj = 0;
+    TRACE_CHK(trace_rec_count(num, TRACE_ID_QUEUE_GET_BLK, &obj) == 1);
+    TRACE_CHK(obj == (uintptr_t)&trace_queue);
+    obj = 0;
+    TRACE_CHK(trace_rec_count(num, TRACE_ID_QUEUE_TASK_WAKE, &obj) == 1);
+    TRACE_CHK(obj == (uintptr_t)&trace_queue);
+
+    /* a queued msg posts, one longer than max_msg_size is reported */
+    memset(buf, 0, sizeof(buf));
+    size[0] = 8;
+    size[1] = 32;
+    ret = krhino_buf_queue_send_batch(&trace_buf_queue, buf, size, 2, &cnt);
+    TRACE_CHK(ret == RHINO_BUF_QUEUE_MSG_SIZE_OVERFLOW);
+    TRACE_CHK(cnt == 1);
+
+    num = trace_rec_drain(0);
+    TRACE_CHK(trace_rec_count(num, TRACE_ID_BUF_QUEUE_POST, NULL) == 1);
+    TRACE_CHK(trace_rec_count(num, TRACE_ID_BUF_QUEUE_MAX, NULL) == 1);
+
+    /* the second batch recv finds the queue empty and blocks */
+    ret = krhino_buf_queue_recv_batch(&trace_buf_queue, RHINO_NO_WAIT, buf, sizeof(buf),
+                                      size, 2, &cnt);
+    TRACE_CHK((ret == RHINO_SUCCESS) && (cnt == 1));
+    ret = krhino_buf_queue_recv_batch(&trace_buf_queue, 1, buf, sizeof(buf),
+                                      size, 2, &cnt);
+    TRACE_CHK(ret == RHINO_BLK_TIMEOUT);
+
+    num = trace_rec_drain(0);
+    obj = 0;
+    TRACE_CHK(trace_rec_count(num, TRACE_ID_BUF_QUEUE_GET_BLK, &obj) == 1);
+    TRACE_CHK(obj == (uintptr_t)&trace_buf_queue);
+
+    krhino_buf_queue_del(&trace_buf_queue);
+    krhino_queue_del(&trace_queue);
+
+    return 0;
+}
+
+static const test_func_t trace_func_runner[] = {
+    trace_ring_case1,
+    trace_ring_case2,
+    trace_ring_case3,
+    trace_ring_case4,
+    NULL
+};
+
+void trace_ring_test(void)
+{
+    kstat_t ret;
+
+    task_trace_entry_register(MODULE_NAME, (test_func_t *)trace_func_runner,
+                              sizeof(trace_func_runner) / sizeof(test_func_t));
+
+    ret = krhino_task_dyn_create(&task_trace, MODULE_NAME, 0, TASK_TRACE_PRI,
+                                 0, TASK_TEST_STACK_SIZE, task_trace_entry, 1);
+    if ((ret != RHINO_SUCCESS) && (ret != RHINO_STOPPED)) {
+        test_case_fail++;
+        PRINT_RESULT(MODULE_NAME, FAIL);
+    }
+}
+#endif
+
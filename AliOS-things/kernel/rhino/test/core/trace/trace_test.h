@@ -0,0 +1,23 @@
+/*
+ * Copyright (C) 2015-2017 Alibaba Group Holding Limited
+ */
+
+#ifndef TRACE_TEST_H
+#define TRACE_TEST_H
+
+#define TASK_TRACE_PRI       16
+#define TASK_TEST_STACK_SIZE 1024
+
+#define MYASSERT(value) do {if ((value) == 0) { printf("%s:%d\n", __FUNCTION__, __LINE__); }} while (0)
+
+extern ktask_t *task_trace;
+
+typedef uint8_t (*test_func_t)(void);
+
+void task_trace_entry_register(const char *name, test_func_t *runner,
+                               uint8_t casenum);
+void task_trace_entry(void *arg);
+void trace_test(void);
+void trace_ring_test(void);
+
+#endif /* TRACE_TEST_H */
@@ -0,0 +1,305 @@
+/*
+ * Copyright (C) 2015-2017 Alibaba Group Holding Limited
+ */
+
+#include <k_api.h>
+#include <test_fw.h>
+#include "workqueue_test.h"
+
+#define MODULE_NAME "workqueue_pool"
+
+#if (RHINO_CONFIG_WORKQUEUE > 0)
+#define POOL_STACK_BUF    512
+#define POOL_WORKER_NUM   2
+#define POOL_WORK_NUM     4
+#define POOL_WORK_TICKS   10
+
+#define POOL_CHK(value) do {if ((int)(value) == 0) \
+        {MYASSERT(0); return 1;}} while (0)
+
+static cpu_stack_t  pool_stack_buf[POOL_STACK_BUF * POOL_WORKER_NUM];
+static cpu_stack_t  pri_stack_buf[POOL_STACK_BUF];
+static kworkqueue_t wq_pool;
+static kworkqueue_t wq_pri;
+static kwork_t      work_pool[POOL_WORK_NUM];
+static kwork_t      work_gate;
+static ksem_t       sem_done;
+static ksem_t       sem_gate;
+static ktask_t     *work_task[POOL_WORK_NUM];
+static uint32_t     work_order[POOL_WORK_NUM];
+static uint32_t     work_order_num;
+static tick_t       work_tick[POOL_WORK_NUM];
+
+static void pool_work_func(void *arg)
+{
+    uint32_t id = (uint32_t)(size_t)arg;
+
+    work_task[id] = krhino_cur_task_get();
+    krhino_task_sleep(POOL_WORK_TICKS);
+    krhino_sem_give(&sem_done);
+}
+
+static void order_work_func(void *arg)
+{
+    uint32_t id = (uint32_t)(size_t)arg;
+
+    work_tick[id] = krhino_sys_tick_get();
+    work_order[work_order_num++] = id;
+    krhino_sem_give(&sem_done);
+}
+
+static void gate_work_func(void *arg)
+{
+    krhino_sem_take(&sem_gate, RHINO_WAIT_FOREVER);
+}
+
+static uint8_t workqueue_pool_case1(void)
+{
+    kstat_t ret;
+
+    krhino_sem_create(&sem_done, "POOL-DONE", 0);
+    krhino_sem_create(&sem_gate, "POOL-GATE", 0);
+
+    ret = krhino_workqueue_pool_create(&wq_pool, MODULE_NAME, TASK_WORKQUEUE_PRI,
+                                       pool_stack_buf, POOL_STACK_BUF, 0, 0);
+    POOL_CHK(ret == RHINO_INV_PARAM);
+
+#if (RHINO_CONFIG_WORKQUEUE_WORKER_MAX < 255)
+    ret = krhino_workqueue_pool_create(&wq_pool, MODULE_NAME, TASK_WORKQUEUE_PRI,
+                                       pool_stack_buf, POOL_STACK_BUF,
+                                       RHINO_CONFIG_WORKQUEUE_WORKER_MAX + 1, 0);
+    POOL_CHK(ret == RHINO_INV_PARAM);
+#endif
+
+    /* less than one stack element per worker */
+    ret = krhino_workqueue_pool_create(&wq_pool, MODULE_NAME, TASK_WORKQUEUE_PRI,
+                                       pool_stack_buf, 0, 1, 0);
+    POOL_CHK(ret == RHINO_TASK_INV_STACK_SIZE);
+
+    ret = krhino_work_pri_set(NULL, 0);
+    POOL_CHK(ret == RHINO_NULL_PTR);
+
+    return 0;
+}
+
+#if (RHINO_CONFIG_WORKQUEUE_WORKER_MAX >= POOL_WORKER_NUM)
+/* works sleeping in the handle overlap on the workers */
+static uint8_t workqueue_pool_case2(void)
+{
+    kstat_t  ret;
+    tick_t   start;
+    uint32_t i;
+
+    ret = krhino_workqueue_pool_create(&wq_pool, MODULE_NAME, TASK_WORKQUEUE_PRI,
+                                       pool_stack_buf, POOL_STACK_BUF * POOL_WORKER_NUM,
+                                       POOL_WORKER_NUM, 0);
+    POOL_CHK(ret == RHINO_SUCCESS);
+    POOL_CHK(wq_pool.worker_num == POOL_WORKER_NUM);
+
+    for (i = 0; i < POOL_WORK_NUM; i++) {
+        ret = krhino_work_init(&work_pool[i], pool_work_func, (void *)(size_t)i, 0);
+        POOL_CHK(ret == RHINO_SUCCESS);
+    }
+
+    start = krhino_sys_tick_get();
+
+    for (i = 0; i < POOL_WORK_NUM; i++) {
+        ret = krhino_work_run(&wq_pool, &work_pool[i]);
+        POOL_CHK(ret == RHINO_SUCCESS);
+    }
+
+    ret = krhino_work_run(&wq_pool, &work_pool[POOL_WORK_NUM - 1]);
+    POOL_CHK(ret == RHINO_WORKQUEUE_WORK_EXIST);
+
+    for (i = 0; i < POOL_WORK_NUM; i++) {
+        krhino_sem_take(&sem_done, RHINO_WAIT_FOREVER);
+    }
+
+    POOL_CHK(krhino_sys_tick_get() - start < POOL_WORK_NUM * POOL_WORK_TICKS);
+
+    for (i = 1; i < POOL_WORK_NUM; i++) {
+        if (work_task[i] != work_task[0]) {
+            break;
+        }
+    }
+    POOL_CHK(i < POOL_WORK_NUM);
+
+    return 0;
+}
+#endif
+
+/* pending works run by pri, FIFO among equal ones */
+static uint8_t workqueue_pool_case3(void)
+{
+    kstat_t  ret;
+    uint32_t i;
+    uint8_t  pri[POOL_WORK_NUM] = {3, 1, 2, 1};
+
+    ret = krhino_workqueue_pool_create(&wq_pri, "workqueue_pri", TASK_WORKQUEUE_PRI,
+                                       pri_stack_buf, POOL_STACK_BUF, 1,
+                                       WORKQUEUE_FLAG_PRI);
+    POOL_CHK(ret == RHINO_SUCCESS);
+
+    ret = krhino_work_init(&work_gate, gate_work_func, NULL, 0);
+    POOL_CHK(ret == RHINO_SUCCESS);
+
+    ret = krhino_work_run(&wq_pri, &work_gate);
+    POOL_CHK(ret == RHINO_SUCCESS);
+
+    /* let the worker block in the gate */
+    krhino_task_sleep(2);
+
+    work_order_num = 0;
+
+    for (i = 0; i < POOL_WORK_NUM; i++) {
+        krhino_work_init(&work_pool[i], order_work_func, (void *)(size_t)i, 0);
+        krhino_work_pri_set(&work_pool[i], pri[i]);
+        ret = krhino_work_run(&wq_pri, &work_pool[i]);
+        POOL_CHK(ret == RHINO_SUCCESS);
+    }
+
+    /* a pending work moves ahead */
+    ret = krhino_work_pri_set(&work_pool[2], 0);
+    POOL_CHK(ret == RHINO_SUCCESS);
+
+    krhino_sem_give(&sem_gate);
+
+    for (i = 0; i < POOL_WORK_NUM; i++) {
+        krhino_sem_take(&sem_done, RHINO_WAIT_FOREVER);
+    }
+
+    POOL_CHK(work_order_num == POOL_WORK_NUM);
+    POOL_CHK(work_order[0] == 2);
+    POOL_CHK(work_order[1] == 1);
+    POOL_CHK(work_order[2] == 3);
+    POOL_CHK(work_order[3] == 0);
+
+    return 0;
+}
+
+/* delayed works come off the workqueue wheel by their delay */
+static uint8_t workqueue_pool_case4(void)
+{
+    kstat_t  ret;
+    tick_t   start;
+    uint32_t i;
+    tick_t   dly[POOL_WORK_NUM] = {30, 5, 15, 10};
+
+    work_order_num = 0;
+
+    for (i = 0; i < POOL_WORK_NUM; i++) {
+        ret = krhino_work_init(&work_pool[i], order_work_func, (void *)(size_t)i, dly[i]);
+        POOL_CHK(ret == RHINO_SUCCESS);
+    }
+
+    start = krhino_sys_tick_get();
+
+    for (i = 0; i < POOL_WORK_NUM; i++) {
+        ret = krhino_work_run(&wq_pri, &work_pool[i]);
+        POOL_CHK(ret == RHINO_SUCCESS);
+    }
+
+    /* running a delayed work again restarts its delay */
+    ret = krhino_work_run(&wq_pri, &work_pool[1]);
+    POOL_CHK(ret == RHINO_SUCCESS);
+
+    ret = krhino_work_cancel(&work_pool[3]);
+    POOL_CHK(ret == RHINO_SUCCESS);
+
+    for (i = 0; i < POOL_WORK_NUM - 1; i++) {
+        krhino_sem_take(&sem_done, RHINO_WAIT_FOREVER);
+    }
+
+    /* the canceled one never comes */
+    ret = krhino_sem_take(&sem_done, dly[3] * 2);
+    POOL_CHK(ret == RHINO_BLK_TIMEOUT);
+
+    POOL_CHK(work_order_num == POOL_WORK_NUM - 1);
+    POOL_CHK(work_order[0] == 1);
+    POOL_CHK(work_order[1] == 2);
+    POOL_CHK(work_order[2] == 0);
+
+    for (i = 0; i < POOL_WORK_NUM - 1; i++) {
+        POOL_CHK(work_tick[i] - start >= dly[i]);
+    }
+
+    krhino_sem_del(&sem_done);
+    krhino_sem_del(&sem_gate);
+
+    return 0;
+}
+
+#if (RHINO_CONFIG_WORKQUEUE_STATS > 0)
+static uint8_t workqueue_pool_case5(void)
+{
+    kstat_t            ret;
+    kworkqueue_stats_t stats;
+    uint32_t           latency;
+    uint32_t           exec;
+    uint32_t           depth;
+    uint32_t           i;
+
+    ret = krhino_workqueue_stats_get(&wq_pri, NULL);
+    POOL_CHK(ret == RHINO_NULL_PTR);
+
+    ret = krhino_workqueue_stats_get(&wq_pri, &stats);
+    POOL_CHK(ret == RHINO_SUCCESS);
+
+    latency = 0;
+    exec    = 0;
+    depth   = 0;
+
+    for (i = 0; i < WORKQUEUE_HIST_NUM; i++) {
+        latency += stats.latency[i];
+        exec    += stats.exec[i];
+        depth   += stats.depth[i];
+    }
+
+    /* the gate, 4 by pri and 3 delayed */
+    POOL_CHK(stats.work_done == 1 + POOL_WORK_NUM * 2 - 1);
+    POOL_CHK(latency == stats.work_done);
+    POOL_CHK(exec == stats.work_done);
+    POOL_CHK(depth == stats.work_done);
+    POOL_CHK(stats.depth_max == POOL_WORK_NUM);
+
+    ret = krhino_workqueue_stats_reset(&wq_pri);
+    POOL_CHK(ret == RHINO_SUCCESS);
+
+    krhino_workqueue_stats_get(&wq_pri, &stats);
+    POOL_CHK(stats.work_done == 0);
+    POOL_CHK(stats.depth_max == 0);
+
+    return 0;
+}
+#endif
+
+static const test_func_t workqueue_func_runner[] = {
+    workqueue_pool_case1,
+#if (RHINO_CONFIG_WORKQUEUE_WORKER_MAX >= POOL_WORKER_NUM)
+    workqueue_pool_case2,
+#endif
+    workqueue_pool_case3,
+    workqueue_pool_case4,
+#if (RHINO_CONFIG_WORKQUEUE_STATS > 0)
+    workqueue_pool_case5,
+#endif
+    NULL
+};
+
+void workqueue_pool_test(void)
+{
+    kstat_t ret;
+
+    task_workqueue_entry_register(MODULE_NAME,
+                                  (test_func_t *)workqueue_func_runner,
+                                  sizeof(workqueue_func_runner) / sizeof(test_func_t));
+
+    ret = krhino_task_dyn_create(&task_workqueue, MODULE_NAME, 0,
+                                 TASK_WORKQUEUE_PRI, 0, TASK_TEST_STACK_SIZE,
+                                 task_workqueue_entry, 1);
+    if ((ret != RHINO_SUCCESS) && (ret != RHINO_STOPPED)) {
+        test_case_fail++;
+        PRINT_RESULT(MODULE_NAME, FAIL);
+    }
+}
+#endif
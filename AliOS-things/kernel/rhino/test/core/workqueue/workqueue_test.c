@@ -14,6 +14,7 @@ static uint8_t      module_casenum;
 
 static const test_case_t workqueue_case_runner[] = {
     workqueue_interface_test,
+    workqueue_pool_test,
     NULL
 };
 
@@ -19,6 +19,7 @@ void task_workqueue_entry_register(const char *name, test_func_t *runner,
 void task_workqueue_entry(void *arg);
 void workqueue_test(void);
 void workqueue_interface_test(void);
+void workqueue_pool_test(void);
 
 #endif /* WORKQUEUE_TEST_H */
 
@@ -2,24 +2,11 @@
  * Copyright (C) 2015-2017 Alibaba Group Holding Limited
  */
 
-#include <k_api.h>
-#include "stdio.h"
+#include "perf.h"
 
 #define RELOAD    (unsigned long )40000
 #define NUM   100
 
-extern ksem_t *SYNhandle;
-extern void WaitForNew_tick(void);
-extern double   Turn_to_Realtime(double counter);
-extern void show_times_detail(volatile double   *ft,  int nsamples,
-                              char *title, uint32_t ignore_first);
-
-extern void hobbit_timer0_stop(void);
-extern void hobbit_timer0_init(uint32_t hz);
-extern void hobbit_timer0_start(void);
-extern uint32_t hobbit_timer0_get_curval(void);
-extern void hobbit_timer0_clr(void);
-
 static double       InTimeBUFF[sizeof(double)*NUM] ;
 static volatile     uint32_t INT_NUM ;
 static unsigned long    Endtime;
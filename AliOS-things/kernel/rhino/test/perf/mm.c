@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2015-2017 Alibaba Group Holding Limited
+ */
+
+#include <stdlib.h>
+#include "perf.h"
+
+#if (RHINO_CONFIG_MM_TLF > 0)
+#define  MM_NUM             PERF_SAMPLE_NUM
+
+/* blocks held at once, then freed, MM_ROUNDS times per sample */
+#define  MM_BURST           4u
+#define  MM_ROUNDS          4u
+
+static double       MmBUFF[MM_NUM];
+static void        *MmBlk[MM_BURST];
+static char         MmTitle[32];
+
+static const size_t MmSize[] = {48, 100, 200, 400};
+
+#define  MM_MODE_HEAP        0u
+#define  MM_MODE_API         1u
+#define  MM_MODE_SLAB        2u
+
+static const char  *MmModeName[] = {"Heap", "Api", "Slab"};
+
+/* heap is k_mm_alloc() under the heap lock, api is krhino_mm_alloc(),
+   slab is krhino_slab_alloc() */
+static void *MmAlloc(uint32_t mode, size_t size)
+{
+    switch (mode) {
+        case MM_MODE_API:
+            return krhino_mm_alloc(size);
+#if (RHINO_CONFIG_MM_SLAB > 0)
+        case MM_MODE_SLAB:
+            return krhino_slab_alloc(size);
+#endif
+        default:
+            return k_mm_alloc(g_kmm_head, size);
+    }
+}
+
+static void MmFree(uint32_t mode, void *blk)
+{
+    switch (mode) {
+        case MM_MODE_API:
+            krhino_mm_free(blk);
+            break;
+#if (RHINO_CONFIG_MM_SLAB > 0)
+        case MM_MODE_SLAB:
+            krhino_slab_free(blk);
+            break;
+#endif
+        default:
+            k_mm_free(g_kmm_head, blk);
+            break;
+    }
+}
+
+static void MmChurn(uint32_t mode, size_t size)
+{
+    uint32_t i;
+    uint32_t j;
+
+    for (j = 0; j < MM_ROUNDS; j++) {
+        for (i = 0; i < MM_BURST; i++) {
+            MmBlk[i] = MmAlloc(mode, size);
+        }
+        for (i = 0; i < MM_BURST; i++) {
+            MmFree(mode, MmBlk[i]);
+        }
+    }
+}
+
+/* reported per alloc + free pair */
+static void MmRun(uint32_t mode, size_t size)
+{
+    unsigned long Starttime, Endtime;
+    uint32_t      i;
+
+    memset(MmBUFF, 0, sizeof(double) * MM_NUM);
+
+    for (i = 0; i < MM_NUM; i++) {
+        Starttime = PERF_COUNT_GET();
+        MmChurn(mode, size);
+        Endtime = PERF_COUNT_GET();
+
+        MmBUFF[i] = (double)PERF_COUNT_DIFF(Starttime, Endtime) / (MM_BURST * MM_ROUNDS);
+    }
+
+    for (i = 0; i < MM_NUM; i++) {
+        MmBUFF[i] = (double) Turn_to_Realtime(MmBUFF[i]);
+    }
+
+    snprintf(MmTitle, sizeof(MmTitle), "Mm%s%lu\t", MmModeName[mode],
+             (unsigned long)size);
+    show_times_percentile(MmBUFF, MM_NUM, MmTitle, 1);
+}
+#endif /* RHINO_CONFIG_MM_TLF */
+
+void MmAllocTimetest(void *arg)
+{
+#if (RHINO_CONFIG_MM_TLF > 0)
+    uint32_t i;
+
+    WaitForNew_tick();
+
+    perf_timer_stop();
+    perf_timer_init(0xffffffff);
+    perf_timer_start();
+
+    for (i = 0; i < sizeof(MmSize) / sizeof(MmSize[0]); i++) {
+        MmRun(MM_MODE_HEAP, MmSize[i]);
+        MmRun(MM_MODE_API, MmSize[i]);
+#if (RHINO_CONFIG_MM_SLAB > 0)
+        MmRun(MM_MODE_SLAB, MmSize[i]);
+#endif
+    }
+#endif
+
+    krhino_task_sleep(30);
+    krhino_sem_give(SYNhandle);
+}
+
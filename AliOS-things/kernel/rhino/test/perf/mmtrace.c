@@ -0,0 +1,302 @@
+/*
+ * Copyright (C) 2015-2017 Alibaba Group Holding Limited
+ */
+
+#include <stdlib.h>
+#include "perf.h"
+
+#if (RHINO_CONFIG_MM_TLF > 0)
+/*
+ * Replays one allocation trace on a private heap and reports the latency
+ * of every k_mm_alloc() / k_mm_free() and the fragmentation left at the
+ * peak of the trace. The trace comes from a generator with a fixed seed:
+ * small control blocks, packet sized buffers and a few large ones, with a
+ * growing, a churning, a shrinking and a second growing phase, every slot
+ * freed at the end. Build once per RHINO_CONFIG_MM_SL_BITS to compare the
+ * one level and the two level freelists.
+ */
+#ifndef MM_TRACE_HEAP_SIZE
+#define MM_TRACE_HEAP_SIZE  (64 * 1024)
+#endif
+
+#define MM_TRACE_SLOTS      48
+/* op index right after the live size peaks */
+#define MM_TRACE_PEAK       330
+#define MM_TRACE_NUM        PERF_SAMPLE_NUM
+
+typedef struct {
+    uint8_t  slot;
+    uint16_t size;  /* 0 frees the slot */
+} mm_trace_op_t;
+
+static const mm_trace_op_t MmTrace[] = {
+    {31,  116}, {27,  600}, {26, 3968}, {24,  600}, {12,  536}, {20, 3872},
+    {35, 1384}, {36, 1312}, {15,  536}, {28,  768}, {16,   24}, {40,  136},
+    {38,  896}, {12,    0}, { 4,  384}, { 9,   56}, {41,  872}, {42,  148},
+    {44,   32}, {41,    0}, {47,   72}, {10, 1040}, { 7,  992}, {19,   68},
+    {11,  536}, {15,    0}, {30,  320}, {12,  536}, { 0,  784}, { 3,   32},
+    {15,  960}, {34,   28}, { 6, 2448}, {10,    0}, {10, 1224}, { 1,   64},
+    {21,   28}, {33, 1576}, { 5,  100}, { 8,   52}, {39,  144}, {41,   68},
+    { 7,    0}, {18,  752}, {46,  320}, {23,   68}, {32,   28}, {25, 3392},
+    {12,    0}, {13,   32}, {35,    0}, {14,   28}, {22, 2992}, {12,  156},
+    { 2, 1192}, {33,    0}, {29,  256}, {33, 1384}, {17,   44}, {35,   32},
+    { 7,  320}, {45,   84}, {37,  536}, {43,  384}, {16,    0}, {16,  148},
+    {43,    0}, {43,   68}, {45,    0}, {45,   32}, {11,    0}, {11,  384},
+    {22,    0}, {22, 1384}, { 8,    0}, { 8,   28}, {40,    0}, {25,    0},
+    {25,  824}, {40,  124}, {37,    0}, {37,  256}, {44,    0}, {44,  320},
+    {30,    0}, {30,   44}, {13,    0}, {13,  320}, {27,    0}, {27,   52},
+    {30,    0}, {30,   72}, {15,    0}, {45,    0}, {15,  512}, {17,    0},
+    { 0,    0}, {17,   40}, { 0, 1400}, {20,    0}, {20,   28}, {45,  120},
+    {21,    0}, {28,    0}, { 9,    0}, {24,    0}, { 9, 1232}, {21,   28},
+    {12,    0}, {35,    0}, {24,  320}, { 3,    0}, {34,    0}, {47,    0},
+    {47, 1064}, {12, 3552}, { 3,  384}, {10,    0}, {35,  536}, {28,  536},
+    {10,   84}, {34,  120}, {41,    0}, {36,    0}, { 9,    0}, {36, 1184},
+    { 9, 2592}, { 9,    0}, {41,   92}, {18,    0}, { 5,    0}, {18, 2800},
+    { 9,   32}, { 5,  384}, {22,    0}, {22, 1304}, {38,    0}, {38,  600},
+    { 6,    0}, {36,    0}, {10,    0}, {10,   80}, {18,    0}, {30,    0},
+    { 1,    0}, {30,  536}, { 2,    0}, { 1,   24}, {30,    0}, {38,    0},
+    {36,  100}, {38,  872}, {30,   28}, { 2, 1544}, {43,    0}, {43, 3264},
+    { 6,  112}, {38,    0}, { 5,    0}, {22,    0}, {21,    0}, {24,    0},
+    {24, 1024}, {32,    0}, {18,  856}, {32,   32}, {21,  156}, {31,    0},
+    {38,  140}, {34,    0}, {34,   24}, {22, 1104}, { 5,  512}, {31,   32},
+    {38,    0}, {38,  148}, {44,    0}, {30,    0}, { 7,    0}, {13,    0},
+    {15,    0}, {32,    0}, {45,    0}, {45,  256}, {30,   24}, {13,  536},
+    {12,    0}, {30,    0}, {47,    0}, {46,    0}, {19,    0}, {10,    0},
+    { 9,    0}, { 7,  256}, {19, 1296}, { 6,    0}, { 5,    0}, {14,    0},
+    {31,    0}, {25,    0}, {34,    0}, {15, 1312}, { 7,    0}, {22,    0},
+    {23,    0}, {15,    0}, {17,    0}, {33,    0}, {25,  256}, {14,  140},
+    { 6,  384}, { 6,    0}, { 4,    0}, {40,    0}, {10,  120}, {32, 1232},
+    {40, 1520}, { 9,  512}, {40,    0}, { 5,  536}, {31,   56}, { 9,    0},
+    {32,    0}, {46,  736}, {25,    0}, {17,  116}, {37,    0}, {27,    0},
+    {33,   80}, {18,    0}, {14,    0}, {14,   92}, {17,    0}, {44, 2288},
+    {31,    0}, {23,  536}, { 4,  120}, {18,  536}, {37, 2528}, { 9,  536},
+    { 1,    0}, { 6, 1040}, {15,  600}, {12,   32}, {31, 1016}, {35,    0},
+    {23,    0}, {40,   72}, {45,    0}, {27,  600}, {20,    0}, { 1,   88},
+    {14,    0}, {22,  124}, {14, 4128}, {38,    0}, {16,    0}, {20,  108},
+    {16,  320}, {36,    0}, {34,  120}, {36,  512}, {10,    0}, {36,    0},
+    {17,   88}, { 7,   64}, {37,    0}, {21,    0}, {40,    0}, { 2,    0},
+    {23, 1136}, {35,  600}, {21,  512}, {10,  156}, { 2,   52}, { 5,    0},
+    {36, 1552}, { 5,  140}, {37,   28}, {32,   76}, {19,    0}, {42,    0},
+    {45,   28}, { 3,    0}, {28,    0}, { 3,   28}, {42,  116}, {36,    0},
+    {38, 3856}, {30,  140}, {36,  944}, {10,    0}, {30,    0}, {35,    0},
+    {35, 1312}, {39,    0}, {34,    0}, {47,  600}, {12,    0}, {34, 2864},
+    {28,  536}, {20,    0}, {19, 1368}, {40,  256}, {25,   28}, {21,    0},
+    {12, 1168}, {19,    0}, {12,    0}, {39,  536}, {12,   32}, {20, 3408},
+    {12,    0}, {23,    0}, {23,  152}, {40,    0}, {12,  960}, {10,  384},
+    {17,    0}, { 0,    0}, {17,   72}, {40,  600}, {24,    0}, {24,  320},
+    { 0,   28}, {19, 3664}, {21,  976}, {29,    0}, {18,    0}, {18,  840},
+    {21,    0}, {44,    0}, {38,    0}, {21,  104}, {44, 1360}, {30,   24},
+    {16,    0}, {20,    0}, {33,    0}, {27,    0}, {16, 2688}, {18,    0},
+    {18,  536}, {33,   60}, {29, 1216}, {15,    0}, {27,  512}, {19,    0},
+    {15,  928}, {38,   48}, {14,    0}, { 3,    0}, {20, 1544}, {19,   44},
+    {14,  944}, { 3, 1328}, {46,    0}, {46,  816}, {35,    0}, {15,    0},
+    {35,  148}, { 4,    0}, {15,  600}, {36,    0}, {36,  512}, {18,    0},
+    {30,    0}, {30,  512}, {27,    0}, {27,  536}, {40,    0}, {40, 1120},
+    { 4,  536}, { 4,    0}, { 4,  536}, {45,    0}, {12,    0}, {47,    0},
+    {47,   56}, {45,   24}, {18,   56}, {47,    0}, {31,    0}, {12,   72},
+    {45,    0}, {14,    0}, { 9,    0}, {45,  320}, {24,    0}, {28,    0},
+    {10,    0}, {24,   96}, {32,    0}, {36,    0}, { 8,    0}, {40,    0},
+    {44,    0}, {20,    0}, { 6,    0}, {47,  512}, {17,    0}, {17,   24},
+    { 0,    0}, {45,    0}, {37,    0}, {46,    0}, {29,    0}, {24,    0},
+    {22,    0}, {42,    0}, {12,    0}, {10,  384}, {25,    0}, {33,    0},
+    {19,    0}, {11,    0}, {47,    0}, {15,    0}, {13,    0}, {13,   28},
+    {27,    0}, {41,    0}, {13,    0}, {38,    0}, {16,    0}, {39,    0},
+    {21,    0}, { 1,    0}, { 7,    0}, {46,   56}, { 8,   80}, { 8,    0},
+    {30,    0}, { 7,  320}, { 2,    0}, {17,    0}, { 7,    0}, {33,   60},
+    {39,   40}, {18,    0}, {33,    0}, {28,   84}, {10,    0}, {34,    0},
+    { 4,    0}, {33, 1224}, {40,  100}, {18, 2992}, {45, 1096}, {18,    0},
+    {40,    0}, {23,    0}, {35,    0}, {20,  600}, {28,    0}, { 2,   24},
+    {43,    0}, {39,    0}, {33,    0}, { 5,    0}, { 2,    0}, {35,   64},
+    {43,  888}, {44,  384}, {26,    0}, {37, 2240}, {38,  148}, {35,    0},
+    {42,   48}, {37,    0}, {26,  152}, { 3,    0}, {24, 1592}, {17,  116},
+    {43,    0}, {28,   52}, { 5,  600}, {27,   84}, {38,    0}, {35,   88},
+    {28,    0}, {46,    0}, {42,    0}, {11,   96}, {24,    0}, {44,    0},
+    {45,    0}, { 5,    0}, {27,    0}, {35,    0}, {14,   28}, {34,   48},
+    {10,   32}, {15, 3552}, {24,  536}, {19,  120}, {21, 2576}, {27,   28},
+    {39,   24}, { 9,  320}, {17,    0}, {20,    0}, {21,    0}, {17, 1128},
+    { 1,   24}, {26,    0}, {14,    0}, {47,   24}, {37,  256}, { 7,   92},
+    {39,    0}, {38,  120}, {11,    0}, {34,    0}, {35,  600}, {35,    0},
+    {44,   68}, {18,   72}, {19,    0}, { 3, 1064}, {20,  144}, {34, 1272},
+    {10,    0}, { 3,    0}, {42,   40}, {34,    0}, {43, 1224}, { 5,   64},
+    { 8,  132}, {28,   32}, {17,    0}, {44,    0}, {43,    0}, {27,    0},
+    {30,  856}, {26,  384}, { 5,    0}, {14,   76}, { 4,   56}, {10,   60},
+    {39,  116}, {43, 1008}, {36,  128}, {45,  152}, {12,   24}, {17,  256},
+    { 7,    0}, {35,   72}, {39,    0}, {45,    0}, {32,  144}, {16,  600},
+    {13,   52}, { 6, 1088}, {24,    0}, { 2,  600}, {23,  864}, {29,  384},
+    {46, 1312}, {34,   24}, {27, 3632}, {19,  512}, {10,    0}, {23,    0},
+    {31,  112}, { 5,   76}, {39, 1120}, { 3,  384}, {26,    0}, {42,    0},
+    {43,    0}, {22,   72}, {23,   72}, {13,    0}, {28,    0}, {33,  100},
+    {35,    0}, {42,  536}, {20,    0}, { 7,  320}, {16,    0}, {15,    0},
+    { 5,    0}, {40,   32}, {12,    0}, {20,  384}, { 5, 1384}, { 4,    0},
+    {16,   80}, {36,    0}, { 8,    0}, {10,   24}, {44,  384}, { 5,    0},
+    {32,    0}, {24,   24}, {21,  600}, {21,    0}, {27,    0}, {12,  256},
+    {32,   32}, {26,  132}, { 1,    0}, {35,   28}, {45,  144}, {30,    0},
+    {13,  536}, {15, 3200}, { 1, 1136}, { 5,  108}, {28,   44}, {41,   32},
+    {43,  536}, { 8,  124}, {30,   28}, {21,   40}, {31,    0}, {14,    0},
+    {25,  512}, {31,   76}, {36,  968}, {14,  384}, {27, 2544}, { 0, 1256},
+    {11,   60}, { 4, 3776}, {31,    0}, {31, 1264}, { 5,    0}, { 5, 1080},
+    {25,    0}, {25,  512}, {10,    0}, { 5,    0}, { 5, 1568}, {10,  536},
+    {36,    0}, {36, 1408}, {44,    0}, { 6,    0}, {44,  320}, { 6,   88},
+    {43,    0}, {43,   48}, {24,    0}, {24,  100}, {36,    0}, {17,    0},
+    {17,  768}, {32,    0}, {32,  384}, {41,    0}, {41,  144}, {36,   24},
+    {12,    0}, {12, 2112}, {45,    0}, {45,  512}, { 2,    0}, { 8,    0},
+    {24,    0}, {24,   28}, {23,    0}, {15,    0}, {39,    0}, { 8,  124},
+    {23,   28}, {44,    0}, {36,    0}, {39, 4176}, {46,    0}, {11,    0},
+    {44,  936}, {36,  256}, {43,    0}, {11,  512}, {38,    0}, {41,    0},
+    {26,    0}, {28,    0}, {37,    0}, { 2,  320}, { 2,    0}, {38, 1312},
+    {43,   44}, {41,  976}, {37, 3872}, {41,    0}, {16,    0}, {28,  104},
+    {13,    0}, {30,    0}, {46,  136}, {13,  832}, {16,   24}, {28,    0},
+    {15,   24}, {41,  156}, {47,    0}, {43,    0}, { 9,    0}, {18,    0},
+    {29,    0}, {34,    0}, {19,    0}, { 3,    0}, {22,    0}, {33,    0},
+    {42,    0}, { 7,    0}, {40,    0}, {20,    0}, {35,    0}, { 1,    0},
+    {21,    0}, {14,    0}, {27,    0}, { 0,    0}, { 4,    0}, {31,    0},
+    {25,    0}, { 5,    0}, {10,    0}, { 6,    0}, {17,    0}, {32,    0},
+    {12,    0}, {45,    0}, {24,    0}, { 8,    0}, {23,    0}, {39,    0},
+    {44,    0}, {36,    0}, {11,    0}, {38,    0}, {37,    0}, {46,    0},
+    {13,    0}, {16,    0}, {15,    0}, {41,    0},
+};
+
+#define MM_TRACE_OPS        (sizeof(MmTrace) / sizeof(MmTrace[0]))
+
+static size_t       MmTraceHeap[MM_TRACE_HEAP_SIZE / sizeof(size_t)];
+static k_mm_head   *MmTraceHead;
+static void        *MmTraceBlk[MM_TRACE_SLOTS];
+static double       MmTraceAlloc[MM_TRACE_NUM];
+static double       MmTraceFree[MM_TRACE_NUM];
+static char         MmTraceTitle[32];
+
+/* runs ops [0, num) of the trace, counting the allocs that fail */
+static uint32_t MmTraceReplay(uint32_t num, uint32_t *alloc_num, uint32_t *free_num)
+{
+    unsigned long  Starttime, Endtime;
+    const mm_trace_op_t *op;
+    uint32_t       fail;
+    uint32_t       i;
+
+    fail = 0;
+
+    for (i = 0; i < num; i++) {
+        op = &MmTrace[i];
+
+        if (op->size != 0) {
+            Starttime = PERF_COUNT_GET();
+            MmTraceBlk[op->slot] = k_mm_alloc(MmTraceHead, op->size);
+            Endtime = PERF_COUNT_GET();
+
+            if (MmTraceBlk[op->slot] == NULL) {
+                fail++;
+            }
+            if (alloc_num != NULL && *alloc_num < MM_TRACE_NUM) {
+                MmTraceAlloc[(*alloc_num)++] = (double)PERF_COUNT_DIFF(Starttime, Endtime);
+            }
+        } else {
+            Starttime = PERF_COUNT_GET();
+            k_mm_free(MmTraceHead, MmTraceBlk[op->slot]);
+            Endtime = PERF_COUNT_GET();
+
+            MmTraceBlk[op->slot] = NULL;
+            if (free_num != NULL && *free_num < MM_TRACE_NUM) {
+                MmTraceFree[(*free_num)++] = (double)PERF_COUNT_DIFF(Starttime, Endtime);
+            }
+        }
+    }
+
+    return fail;
+}
+
+/* walks the heap blks, sums the free ones and finds the largest */
+static void MmTraceFreeInfo(size_t *free_size, size_t *largest, uint32_t *blks)
+{
+    k_mm_region_info_t *reginfo;
+    k_mm_list_t        *cur;
+
+    *free_size = 0;
+    *largest   = 0;
+    *blks      = 0;
+
+    for (reginfo = MmTraceHead->regioninfo; reginfo != NULL; reginfo = reginfo->next) {
+        cur = MM_GET_THIS_BLK(reginfo);
+        while (MM_GET_BUF_SIZE(cur) != 0) {
+            if (cur->buf_size & RHINO_MM_FREE) {
+                *free_size += MM_GET_BUF_SIZE(cur);
+                (*blks)++;
+                if (MM_GET_BUF_SIZE(cur) > *largest) {
+                    *largest = MM_GET_BUF_SIZE(cur);
+                }
+            }
+            cur = MM_GET_NEXT_BLK(cur);
+        }
+    }
+}
+
+static void MmTraceRun(void)
+{
+    size_t   free_size;
+    size_t   largest;
+    uint32_t blks;
+    uint32_t fail;
+    uint32_t alloc_num;
+    uint32_t free_num;
+    uint32_t i;
+
+    if (krhino_init_mm_head(&MmTraceHead, MmTraceHeap, sizeof(MmTraceHeap))
+        != RHINO_SUCCESS) {
+        printf("no memory for the heap\tMmTrace\n");
+        return;
+    }
+
+    /* fragmentation at the peak, then run the trace out */
+    fail = MmTraceReplay(MM_TRACE_PEAK, NULL, NULL);
+    MmTraceFreeInfo(&free_size, &largest, &blks);
+    for (i = 0; i < MM_TRACE_SLOTS; i++) {
+        k_mm_free(MmTraceHead, MmTraceBlk[i]);
+        MmTraceBlk[i] = NULL;
+    }
+
+    printf("free %lu largest %lu (%lu%%) in %u blks, %u allocs failed\tMmTraceSL%d\n",
+           (unsigned long)free_size, (unsigned long)largest,
+           (unsigned long)(free_size ? largest * 100 / free_size : 0),
+           (unsigned int)blks, (unsigned int)fail, (int)RHINO_CONFIG_MM_SL_BITS);
+
+    memset(MmTraceAlloc, 0, sizeof(double) * MM_TRACE_NUM);
+    memset(MmTraceFree, 0, sizeof(double) * MM_TRACE_NUM);
+
+    alloc_num = 0;
+    free_num  = 0;
+
+    while (alloc_num < MM_TRACE_NUM || free_num < MM_TRACE_NUM) {
+        MmTraceReplay(MM_TRACE_OPS, &alloc_num, &free_num);
+    }
+
+    for (i = 0; i < MM_TRACE_NUM; i++) {
+        MmTraceAlloc[i] = (double) Turn_to_Realtime(MmTraceAlloc[i]);
+        MmTraceFree[i]  = (double) Turn_to_Realtime(MmTraceFree[i]);
+    }
+
+    snprintf(MmTraceTitle, sizeof(MmTraceTitle), "MmTraceAllocSL%d\t",
+             (int)RHINO_CONFIG_MM_SL_BITS);
+    show_times_percentile(MmTraceAlloc, MM_TRACE_NUM, MmTraceTitle, 1);
+
+    snprintf(MmTraceTitle, sizeof(MmTraceTitle), "MmTraceFreeSL%d\t",
+             (int)RHINO_CONFIG_MM_SL_BITS);
+    show_times_percentile(MmTraceFree, MM_TRACE_NUM, MmTraceTitle, 1);
+
+    krhino_deinit_mm_head(MmTraceHead);
+}
+#endif /* RHINO_CONFIG_MM_TLF */
+
+void MmTraceTimetest(void *arg)
+{
+#if (RHINO_CONFIG_MM_TLF > 0)
+    WaitForNew_tick();
+
+    perf_timer_stop();
+    perf_timer_init(0xffffffff);
+    perf_timer_start();
+
+    MmTraceRun();
+#endif
+
+    krhino_task_sleep(30);
+    krhino_sem_give(SYNhandle);
+}
@@ -2,28 +2,12 @@
  * Copyright (C) 2015-2017 Alibaba Group Holding Limited
  */
 
-#include <k_api.h>
-#include "stdio.h"
-
-#define TASK_TEST_PRI     20
-#define TASK_MAIN_PRI     15
-#define TASK_TEST_STACK_SIZE 1024
-#define  SWITCH_NUM  100
-
-extern ksem_t   *SYNhandle;
-extern void WaitForNew_tick(void);
-extern double   Turn_to_Realtime(double counter);
-extern void show_times_detail(volatile double   *ft,  int nsamples,
-                              char *title, uint32_t ignore_first);
-
-extern void hobbit_timer0_stop(void);
-extern void hobbit_timer0_init(uint32_t hz);
-extern void hobbit_timer0_start(void);
-extern uint32_t hobbit_timer0_get_curval(void);
-extern void hobbit_timer0_clr(void);
+#include "perf.h"
+
+#define  SWITCH_NUM  PERF_SAMPLE_NUM
 
 static volatile unsigned long   Starttime, Endtime, Runtime;
-static double           ShufBUFF[sizeof(double)*SWITCH_NUM] ;
+static double           ShufBUFF[SWITCH_NUM] ;
 static volatile unsigned  long  ShufSwitch = 0;
 static ksem_t       *Shufhandle_1;
 static kmutex_t    Shufhandle_0;
@@ -56,7 +40,7 @@ static void MutexShuf1(void *arg)
         OurPriority = task_pri_get(krhino_cur_task_get());
         krhino_task_pri_change(ShufTaskHandle[1], OurPriority - 1, &oldpri);
 
-        Starttime = hobbit_timer0_get_curval();
+        Starttime = PERF_COUNT_GET();
         krhino_mutex_unlock(&Shufhandle_0);
 
         krhino_sem_take(Shufhandle_1, RHINO_WAIT_FOREVER);
@@ -76,8 +60,8 @@ static void MutexShuf2(void *arg)
     while (1) {
         krhino_mutex_lock(&Shufhandle_0, RHINO_WAIT_FOREVER);
 
-        Endtime = hobbit_timer0_get_curval();
-        Runtime = Starttime - Endtime;
+        Endtime = PERF_COUNT_GET();
+        Runtime = PERF_COUNT_DIFF(Starttime, Endtime);
 
         ShufBUFF[ShufSwitch] = (double)Runtime;
 
@@ -102,8 +86,8 @@ void MutexShufTimetest(void *arg)
     WaitForNew_tick();
     ShufSwitch = 0;
 
-    hobbit_timer0_stop();
-    hobbit_timer0_init(0xffffffff);
+    perf_timer_stop();
+    perf_timer_init(0xffffffff);
 
     memset(ShufBUFF, 0, sizeof(double)*SWITCH_NUM);
 
@@ -117,7 +101,7 @@ void MutexShufTimetest(void *arg)
     krhino_task_dyn_create(&ShufTaskHandle[1], "test_task", 0, TASK_TEST_PRI + 2,
                            0, TASK_TEST_STACK_SIZE, MutexShuf2, 1);
 
-    hobbit_timer0_start();
+    perf_timer_start();
     krhino_sem_take(ShufSynhandle, RHINO_WAIT_FOREVER);
 
     krhino_task_dyn_del(ShufTaskHandle[0]);
@@ -127,7 +111,7 @@ void MutexShufTimetest(void *arg)
         ShufBUFF[i] = (double) Turn_to_Realtime(ShufBUFF[i]);
     }
 
-    show_times_detail(ShufBUFF , SWITCH_NUM, "MutexShuf\t", 1);
+    show_times_percentile(ShufBUFF , SWITCH_NUM, "MutexShuf\t", 1);
     krhino_task_sleep(20);
     krhino_sem_give(SYNhandle);
 }
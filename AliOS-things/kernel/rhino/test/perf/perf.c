@@ -2,12 +2,8 @@
  * Copyright (C) 2015-2017 Alibaba Group Holding Limited
  */
 
-#include <k_api.h>
-#include "stdio.h"
-
-#define TASK_TEST_PRI     20
-#define TASK_MAIN_PRI     15
-#define TASK_TEST_STACK_SIZE 1024
+#include <stdlib.h>
+#include "perf.h"
 
 #define PRECISION 1000000000
 
@@ -19,27 +15,22 @@ ktask_t     *main_task;
 ksem_t      *SYNhandle;
 ksem_t      *SYNmainhandle;
 
-double  Turn_to_Realtime(double counter);
-void WaitForNew_tick(void);
-void OS_RealTime_test(void);
-
+#ifndef PERF_CONFIG_HOST
 extern int krhino_bsp_intc_attach_irq(int irq, int isr);
 extern int krhino_bsp_intc_enable_irq(int irq);;
 extern void timer0_handler(void);
-
-extern void show_times_hdr(void);
-extern void IntRealtimetest(void *arg);
-extern void TaskYIELDtimeTest(void *arg);
-extern void PreemptionTimetest(void *arg);
-extern void MutexShufTimetest(void *arg);
-extern void BinaryShufTimetest(void *arg);
-
+#endif
 
 double  Turn_to_Realtime(double counter)
 {
+#ifdef PERF_CONFIG_HOST
+    /* HR_COUNT_GET() already counts in ns */
+    return counter;
+#else
     double  realtime_us;
     double US_CLK = (double)(PRECISION / APB_DEFAULT_FREQ) ;
     return realtime_us = (US_CLK * counter);
+#endif
 }
 
 void WaitForNew_tick(void)
@@ -51,59 +42,42 @@ void WaitForNew_tick(void)
 }
 
 
-void OS_test(void *arg)
+static void OS_test_run(task_entry_t entry)
 {
-    kstat_t ret;
-
-    WaitForNew_tick();
-    krhino_sem_dyn_create(&SYNhandle, "syn_sem", 0);
-    krhino_sem_dyn_create(&SYNmainhandle, "synmain_sem", 0);
-    show_times_hdr();
-
-#if 1
-    ret = krhino_task_dyn_create(&test_task, "test_task", 0, TASK_TEST_PRI,
-                                 0, TASK_TEST_STACK_SIZE, IntRealtimetest, 1);
-    krhino_sem_take(SYNhandle, RHINO_WAIT_FOREVER);
-    krhino_task_dyn_del(test_task);
-
-    krhino_task_sleep(50);
-#endif
-
-#if 1
-    krhino_task_dyn_create(&test_task, "test_task", 0, TASK_TEST_PRI,
-                           0, TASK_TEST_STACK_SIZE, TaskYIELDtimeTest, 1);
-    krhino_sem_take(SYNhandle, RHINO_WAIT_FOREVER);
-    krhino_task_dyn_del(test_task);
-    krhino_task_sleep(50);
-#endif
-
-#if 1
     krhino_task_dyn_create(&test_task, "test_task", 0, TASK_TEST_PRI,
-                           0, TASK_TEST_STACK_SIZE, PreemptionTimetest, 1);
+                           0, TASK_TEST_STACK_SIZE, entry, 1);
     krhino_sem_take(SYNhandle, RHINO_WAIT_FOREVER);
     krhino_task_dyn_del(test_task);
 
     krhino_task_sleep(50);
-#endif
-
-#if 1
-    krhino_task_dyn_create(&test_task, "test_task", 0, TASK_TEST_PRI,
-                           0, TASK_TEST_STACK_SIZE, MutexShufTimetest, 1);
+}
 
-    krhino_sem_take(SYNhandle, RHINO_WAIT_FOREVER);
-    krhino_task_dyn_del(test_task);
+void OS_test(void *arg)
+{
+    WaitForNew_tick();
+    krhino_sem_dyn_create(&SYNhandle, "syn_sem", 0);
+    krhino_sem_dyn_create(&SYNmainhandle, "synmain_sem", 0);
+    show_times_hdr();
 
-    krhino_task_sleep(50);
+#ifndef PERF_CONFIG_HOST
+    OS_test_run(IntRealtimetest);
 #endif
-
-#if 1
-    krhino_task_dyn_create(&test_task, "test_task", 0, TASK_TEST_PRI,
-                           0, TASK_TEST_STACK_SIZE, BinaryShufTimetest, 1);
-
-    krhino_sem_take(SYNhandle, RHINO_WAIT_FOREVER);
-    krhino_task_dyn_del(test_task);
-
-    krhino_task_sleep(50);
+    OS_test_run(TaskYIELDtimeTest);
+    OS_test_run(PreemptionTimetest);
+    OS_test_run(MutexShufTimetest);
+    OS_test_run(BinaryShufTimetest);
+    OS_test_run(QueueShufTimetest);
+    OS_test_run(BufQueueShufTimetest);
+    OS_test_run(QueueBatchTimetest);
+    OS_test_run(TickListTimetest);
+    OS_test_run(RingBufTimetest);
+    OS_test_run(MmAllocTimetest);
+    OS_test_run(MmTraceTimetest);
+#ifdef PERF_CONFIG_HOST
+    OS_test_run(TimerLatencyTimetest);
+
+    printf("perf test finished\n");
+    exit(0);
 #endif
 
     krhino_task_dyn_del(krhino_cur_task_get());
@@ -112,9 +86,11 @@ void OS_test(void *arg)
 
 void OS_RealTime_test(void)
 {
+#ifndef PERF_CONFIG_HOST
     krhino_bsp_intc_enable_irq(2);
 #ifndef CONFIG_TEST_PERFORMANCE
     krhino_bsp_intc_attach_irq(2, (int)timer0_handler);
+#endif
 #endif
     krhino_task_dyn_create(&main_task, "main_task", 0, TASK_MAIN_PRI,
                            0, TASK_TEST_STACK_SIZE, OS_test, 1);
@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2015-2017 Alibaba Group Holding Limited
+ */
+
+#ifndef PERF_H
+#define PERF_H
+
+#include <k_api.h>
+#include <stdio.h>
+
+#define TASK_TEST_PRI     20
+#define TASK_MAIN_PRI     15
+
+#ifdef PERF_CONFIG_HOST
+/* hosted build: HR_COUNT_GET() is an up counting ns clock, stacks hold libc frames */
+#define TASK_TEST_STACK_SIZE    8192
+#define PERF_SAMPLE_NUM         10000
+#define PERF_TIMER_SAMPLE_NUM   1000
+
+#define PERF_COUNT_GET()        ((unsigned long)HR_COUNT_GET())
+#define PERF_COUNT_DIFF(s, e)   ((e) - (s))
+
+#define perf_timer_stop()
+#define perf_timer_init(load)
+#define perf_timer_start()
+#else
+/* csky 802: hobbit timer0 is a down counter */
+#define TASK_TEST_STACK_SIZE    1024
+#define PERF_SAMPLE_NUM         100
+#define PERF_TIMER_SAMPLE_NUM   100
+
+#define PERF_COUNT_GET()        ((unsigned long)hobbit_timer0_get_curval())
+#define PERF_COUNT_DIFF(s, e)   ((s) - (e))
+
+#define perf_timer_stop()       hobbit_timer0_stop()
+#define perf_timer_init(load)   hobbit_timer0_init(load)
+#define perf_timer_start()      hobbit_timer0_start()
+
+extern void hobbit_timer0_stop(void);
+extern void hobbit_timer0_init(uint32_t hz);
+extern void hobbit_timer0_start(void);
+extern uint32_t hobbit_timer0_get_curval(void);
+extern void hobbit_timer0_clr(void);
+#endif /* PERF_CONFIG_HOST */
+
+extern ksem_t *SYNhandle;
+
+void   WaitForNew_tick(void);
+double Turn_to_Realtime(double counter);
+
+void show_times_hdr(void);
+void show_times_detail(volatile double *ft, int nsamples,
+                       char *title, uint32_t ignore_first);
+void show_times_percentile(volatile double *ft, int nsamples,
+                           char *title, uint32_t ignore_first);
+
+void IntRealtimetest(void *arg);
+void TaskYIELDtimeTest(void *arg);
+void PreemptionTimetest(void *arg);
+void MutexShufTimetest(void *arg);
+void BinaryShufTimetest(void *arg);
+void QueueShufTimetest(void *arg);
+void BufQueueShufTimetest(void *arg);
+void QueueBatchTimetest(void *arg);
+void TimerLatencyTimetest(void *arg);
+void TickListTimetest(void *arg);
+void RingBufTimetest(void *arg);
+void MmAllocTimetest(void *arg);
+void MmTraceTimetest(void *arg);
+
+void OS_RealTime_test(void);
+
+#endif /* PERF_H */
+
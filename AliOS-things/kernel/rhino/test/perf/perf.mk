@@ -0,0 +1,31 @@
+NAME := perf
+
+GLOBAL_INCLUDES += ./
+
+ifeq ($(COMPILER),)
+$(NAME)_CFLAGS  += -Wall -Werror -Wno-unused-variable -Wno-unused-parameter
+else ifeq ($(COMPILER),gcc)
+$(NAME)_CFLAGS  += -Wall -Werror -Wno-unused-variable -Wno-unused-parameter
+endif
+
+$(NAME)_SOURCES := \
+    perf.c \
+    realtimelib.c \
+    taskswitch.c \
+    taskpree.c \
+    sem.c \
+    mutex.c \
+    queue.c \
+    ticklist.c \
+    ringbuf.c \
+    mm.c \
+    mmtrace.c
+
+ifeq ($(HOST_ARCH),linux)
+GLOBAL_DEFINES  += PERF_CONFIG_HOST
+$(NAME)_SOURCES += timerlatency.c \
+                   perf_app.c
+else
+$(NAME)_SOURCES += intrealtime.c \
+                   timer.c
+endif
@@ -0,0 +1,19 @@
+/*
+ * Copyright (C) 2015-2017 Alibaba Group Holding Limited
+ */
+
+#include "perf.h"
+
+int application_start(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    OS_RealTime_test();
+
+    while (1) {
+        krhino_task_sleep(RHINO_CONFIG_TICKS_PER_SECOND);
+    }
+
+    return 0;
+}
@@ -0,0 +1,275 @@
+/*
+ * Copyright (C) 2015-2017 Alibaba Group Holding Limited
+ */
+
+#include "perf.h"
+
+#define  SWITCH_NUM  PERF_SAMPLE_NUM
+#define  QUEUE_MSG_NUM        4
+#define  BUF_QUEUE_MSG_SIZE   16
+#define  QUEUE_BATCH_MAX      64
+
+static volatile unsigned long   Starttime, Endtime;
+static double           ShufBUFF[SWITCH_NUM] ;
+static volatile unsigned  long  ShufSwitch = 0;
+static ktask_t   *ShufTaskHandle[2];
+static ksem_t       *ShufSynhandle;
+
+static kqueue_t     *Queuehandle[2];
+
+static kbuf_queue_t *BufQueuehandle[2];
+
+/* QueueShuf1 sends a ping and records the round-trip when the pong comes back */
+static void QueueShuf1(void *arg)
+{
+    void *msg;
+
+    while (1) {
+        Starttime = PERF_COUNT_GET();
+        krhino_queue_back_send(Queuehandle[0], (void *)&Starttime);
+        krhino_queue_recv(Queuehandle[1], RHINO_WAIT_FOREVER, &msg);
+        Endtime = PERF_COUNT_GET();
+
+        if (ShufSwitch < SWITCH_NUM) {
+            ShufBUFF[ShufSwitch++] = (double)PERF_COUNT_DIFF(Starttime, Endtime);
+        }
+
+        if (ShufSwitch >= SWITCH_NUM) {
+            krhino_sem_give(ShufSynhandle);
+        }
+    }
+}
+
+static void QueueShuf2(void *arg)
+{
+    void *msg;
+
+    while (1) {
+        krhino_queue_recv(Queuehandle[0], RHINO_WAIT_FOREVER, &msg);
+        krhino_queue_back_send(Queuehandle[1], msg);
+    }
+}
+
+void QueueShufTimetest(void *arg)
+{
+    unsigned long i ;
+    WaitForNew_tick();
+
+    krhino_sem_dyn_create(&ShufSynhandle, "synsem", 0);
+    ShufSwitch = 0;
+
+    perf_timer_stop();
+    perf_timer_init(0xffffffff);
+
+    memset(ShufBUFF, 0, sizeof(double)*SWITCH_NUM);
+
+    krhino_queue_dyn_create(&Queuehandle[0], "queue", QUEUE_MSG_NUM);
+    krhino_queue_dyn_create(&Queuehandle[1], "queue", QUEUE_MSG_NUM);
+
+    /* the echo task runs at higher prio so each send is a preemption */
+    krhino_task_dyn_create(&ShufTaskHandle[1], "test_task", 0, TASK_TEST_PRI + 1,
+                           0, TASK_TEST_STACK_SIZE, QueueShuf2, 1);
+    krhino_task_dyn_create(&ShufTaskHandle[0], "test_task", 0, TASK_TEST_PRI + 2,
+                           0, TASK_TEST_STACK_SIZE, QueueShuf1, 1);
+
+    perf_timer_start();
+
+    krhino_sem_take(ShufSynhandle, RHINO_WAIT_FOREVER);
+
+    krhino_task_dyn_del(ShufTaskHandle[0]);
+    krhino_task_dyn_del(ShufTaskHandle[1]);
+    krhino_queue_dyn_del(Queuehandle[0]);
+    krhino_queue_dyn_del(Queuehandle[1]);
+    krhino_sem_dyn_del(ShufSynhandle);
+
+    for (i = 0; i < SWITCH_NUM; i++) {
+        ShufBUFF[i] = (double) Turn_to_Realtime(ShufBUFF[i]);
+    }
+
+    show_times_percentile(ShufBUFF , SWITCH_NUM, "QueueShuf\t", 1);
+    krhino_task_sleep(30);
+    krhino_sem_give(SYNhandle);
+}
+
+static void BufQueueShuf1(void *arg)
+{
+    uint8_t msg[BUF_QUEUE_MSG_SIZE];
+    size_t  size;
+
+    memset(msg, 0x5a, sizeof(msg));
+
+    while (1) {
+        Starttime = PERF_COUNT_GET();
+        krhino_buf_queue_send(BufQueuehandle[0], msg, sizeof(msg));
+        krhino_buf_queue_recv(BufQueuehandle[1], RHINO_WAIT_FOREVER, msg, &size);
+        Endtime = PERF_COUNT_GET();
+
+        if (ShufSwitch < SWITCH_NUM) {
+            ShufBUFF[ShufSwitch++] = (double)PERF_COUNT_DIFF(Starttime, Endtime);
+        }
+
+        if (ShufSwitch >= SWITCH_NUM) {
+            krhino_sem_give(ShufSynhandle);
+        }
+    }
+}
+
+static void BufQueueShuf2(void *arg)
+{
+    uint8_t msg[BUF_QUEUE_MSG_SIZE];
+    size_t  size;
+
+    while (1) {
+        krhino_buf_queue_recv(BufQueuehandle[0], RHINO_WAIT_FOREVER, msg, &size);
+        krhino_buf_queue_send(BufQueuehandle[1], msg, size);
+    }
+}
+
+void BufQueueShufTimetest(void *arg)
+{
+    unsigned long i ;
+    WaitForNew_tick();
+
+    krhino_sem_dyn_create(&ShufSynhandle, "synsem", 0);
+    ShufSwitch = 0;
+
+    perf_timer_stop();
+    perf_timer_init(0xffffffff);
+
+    memset(ShufBUFF, 0, sizeof(double)*SWITCH_NUM);
+
+    krhino_buf_queue_dyn_create(&BufQueuehandle[0], "buf_queue",
+                                QUEUE_MSG_NUM * (BUF_QUEUE_MSG_SIZE + sizeof(size_t)),
+                                BUF_QUEUE_MSG_SIZE);
+    krhino_buf_queue_dyn_create(&BufQueuehandle[1], "buf_queue",
+                                QUEUE_MSG_NUM * (BUF_QUEUE_MSG_SIZE + sizeof(size_t)),
+                                BUF_QUEUE_MSG_SIZE);
+
+    krhino_task_dyn_create(&ShufTaskHandle[1], "test_task", 0, TASK_TEST_PRI + 1,
+                           0, TASK_TEST_STACK_SIZE, BufQueueShuf2, 1);
+    krhino_task_dyn_create(&ShufTaskHandle[0], "test_task", 0, TASK_TEST_PRI + 2,
+                           0, TASK_TEST_STACK_SIZE, BufQueueShuf1, 1);
+
+    perf_timer_start();
+
+    krhino_sem_take(ShufSynhandle, RHINO_WAIT_FOREVER);
+
+    krhino_task_dyn_del(ShufTaskHandle[0]);
+    krhino_task_dyn_del(ShufTaskHandle[1]);
+    krhino_buf_queue_dyn_del(BufQueuehandle[0]);
+    krhino_buf_queue_dyn_del(BufQueuehandle[1]);
+    krhino_sem_dyn_del(ShufSynhandle);
+
+    for (i = 0; i < SWITCH_NUM; i++) {
+        ShufBUFF[i] = (double) Turn_to_Realtime(ShufBUFF[i]);
+    }
+
+    show_times_percentile(ShufBUFF , SWITCH_NUM, "BufQueueShuf\t", 1);
+    krhino_task_sleep(30);
+    krhino_sem_give(SYNhandle);
+}
+
+/* a burst of BatchSize[i] msgs is sent by one batch call and drained by a
+   higher prio sink blocked in the batch recv, reported per msg */
+static const size_t BatchSize[] = {1, 2, 4, 8, 16, 32, 64};
+
+static char         BatchTitle[32];
+static void        *BatchMsg[QUEUE_BATCH_MAX];
+static uint8_t      BatchBuf[QUEUE_BATCH_MAX * BUF_QUEUE_MSG_SIZE];
+
+/* fix msgs, the dyn create only makes dyn buf queues */
+static kbuf_queue_t BufQueueStatic;
+static uint8_t      BufQueueStaticBuf[QUEUE_BATCH_MAX * BUF_QUEUE_MSG_SIZE];
+
+static void QueueBatchSink(void *arg)
+{
+    void   *msg[QUEUE_BATCH_MAX];
+    size_t  num;
+
+    while (1) {
+        krhino_queue_recv_batch(Queuehandle[0], RHINO_WAIT_FOREVER, msg,
+                                QUEUE_BATCH_MAX, &num);
+    }
+}
+
+static void BufQueueBatchSink(void *arg)
+{
+    uint8_t buf[QUEUE_BATCH_MAX * BUF_QUEUE_MSG_SIZE];
+    size_t  size[QUEUE_BATCH_MAX];
+    size_t  num;
+
+    while (1) {
+        krhino_buf_queue_recv_batch(BufQueuehandle[0], RHINO_WAIT_FOREVER, buf,
+                                    sizeof(buf), size, QUEUE_BATCH_MAX, &num);
+    }
+}
+
+static void QueueBatchRun(uint32_t buf_queue, size_t batch)
+{
+    unsigned long i;
+    size_t        sent;
+
+    memset(ShufBUFF, 0, sizeof(double) * SWITCH_NUM);
+
+    for (i = 0; i < SWITCH_NUM; i++) {
+        Starttime = PERF_COUNT_GET();
+        if (buf_queue) {
+            krhino_buf_queue_send_batch(BufQueuehandle[0], BatchBuf, NULL, batch, &sent);
+        } else {
+            krhino_queue_back_send_batch(Queuehandle[0], BatchMsg, batch, &sent);
+        }
+        Endtime = PERF_COUNT_GET();
+
+        ShufBUFF[i] = (double)PERF_COUNT_DIFF(Starttime, Endtime) / batch;
+    }
+
+    for (i = 0; i < SWITCH_NUM; i++) {
+        ShufBUFF[i] = (double) Turn_to_Realtime(ShufBUFF[i]);
+    }
+
+    snprintf(BatchTitle, sizeof(BatchTitle), "%sBatch%lu\t",
+             buf_queue ? "BufQueue" : "Queue", (unsigned long)batch);
+    show_times_percentile(ShufBUFF, SWITCH_NUM, BatchTitle, 1);
+}
+
+void QueueBatchTimetest(void *arg)
+{
+    uint32_t i;
+
+    WaitForNew_tick();
+
+    perf_timer_stop();
+    perf_timer_init(0xffffffff);
+    perf_timer_start();
+
+    for (i = 0; i < QUEUE_BATCH_MAX; i++) {
+        BatchMsg[i] = (void *)&BatchMsg[i];
+    }
+    memset(BatchBuf, 0x5a, sizeof(BatchBuf));
+
+    krhino_queue_dyn_create(&Queuehandle[0], "queue", QUEUE_BATCH_MAX);
+    krhino_fix_buf_queue_create(&BufQueueStatic, "buf_queue", BufQueueStaticBuf,
+                                BUF_QUEUE_MSG_SIZE, QUEUE_BATCH_MAX);
+    BufQueuehandle[0] = &BufQueueStatic;
+
+    krhino_task_dyn_create(&ShufTaskHandle[0], "test_task", 0, TASK_TEST_PRI - 1,
+                           0, TASK_TEST_STACK_SIZE, QueueBatchSink, 1);
+    krhino_task_dyn_create(&ShufTaskHandle[1], "test_task", 0, TASK_TEST_PRI - 1,
+                           0, TASK_TEST_STACK_SIZE, BufQueueBatchSink, 1);
+
+    for (i = 0; i < sizeof(BatchSize) / sizeof(BatchSize[0]); i++) {
+        QueueBatchRun(0, BatchSize[i]);
+    }
+
+    for (i = 0; i < sizeof(BatchSize) / sizeof(BatchSize[0]); i++) {
+        QueueBatchRun(1, BatchSize[i]);
+    }
+
+    krhino_task_dyn_del(ShufTaskHandle[0]);
+    krhino_task_dyn_del(ShufTaskHandle[1]);
+    krhino_queue_dyn_del(Queuehandle[0]);
+    krhino_buf_queue_del(&BufQueueStatic);
+
+    krhino_task_sleep(30);
+    krhino_sem_give(SYNhandle);
+}
@@ -2,19 +2,27 @@
  * Copyright (C) 2015-2017 Alibaba Group Holding Limited
  */
 
-#include <k_api.h>
-#include <k_config.h>
-#include "stdio.h"
+#include <stdlib.h>
+#include "perf.h"
 
 #define APB_DEFAULT_FREQ    20000000
 
 void show_times_hdr(void)
 {
+#ifdef PERF_CONFIG_HOST
+    printf("\nRhino Function RealTime Test (hosted)\n");
+    printf("\nTesting Parameters:\n");
+    printf("   TICK_RATE_HZ :         %dHZ\n", (int)RHINO_CONFIG_TICKS_PER_SECOND);
+    printf("   CLOCK_SAMPLE :         CLOCK_MONOTONIC, ns\n\n");
+    printf(" ns/op      Min        P50        P90        P99        Max        Function      SampleNum\n");
+    printf("=======    =====      =====      =====      =====      =====      ========      =========\n");
+    return;
+#endif
     printf("\r\nFreeRTOS Function RealTime Test\r\n");
     printf("\r\nTesting Parameters:\r\n");
-    printf("   TICK_RATE_HZ :         %dHZ\r\n",
+    printf("   TICK_RATE_HZ :         %luHZ\r\n",
            (unsigned long) RHINO_CONFIG_TICKS_PER_SECOND);
-    printf("   CLOCK_SAMPLE :         %dHZ\r\n", (unsigned long) APB_DEFAULT_FREQ);
+    printf("   CLOCK_SAMPLE :         %luHZ\r\n", (unsigned long) APB_DEFAULT_FREQ);
 
     printf("                                                             Confidence\r\n");
     printf(" Ave              Min             Max             Var         Ave Min        Function      SampleNum \r\n");
@@ -212,6 +220,66 @@ void show_times_detail_2(volatile  unsigned long  ft[], int nsamples,
 }
 
 
+#ifdef PERF_CONFIG_HOST
+static double PercentileBUFF[PERF_SAMPLE_NUM];
+
+static int perf_double_cmp(const void *a, const void *b)
+{
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+
+    return (x > y) - (x < y);
+}
+
+static double perf_percentile(double *sorted, int nsamples, int pct)
+{
+    int idx;
+
+    idx = (nsamples * pct + 99) / 100 - 1;
+    if (idx < 0) {
+        idx = 0;
+    }
+
+    return sorted[idx];
+}
+#endif
+
+/* ns/op plus tail percentiles, ft[] holds ns samples, outliers are kept */
+void show_times_percentile(volatile double *ft, int nsamples, char *title,
+                           uint32_t ignore_first)
+{
+#ifdef PERF_CONFIG_HOST
+    int    i;
+    int    total_samples = 0;
+    double total = 0.0;
+
+    for (i = (ignore_first ? 1 : 0); i < nsamples && total_samples < PERF_SAMPLE_NUM; i++) {
+        if (ft[i] <= 0) {
+            continue;
+        }
+
+        PercentileBUFF[total_samples++] = ft[i];
+        total += ft[i];
+    }
+
+    if (total_samples == 0) {
+        printf("no valid sample\t%s\n", title);
+        return;
+    }
+
+    qsort(PercentileBUFF, total_samples, sizeof(double), perf_double_cmp);
+
+    printf("%-10.1f %-10.0f %-10.0f %-10.0f %-10.0f %-10.0f %s  %d\n",
+           total / total_samples, PercentileBUFF[0],
+           perf_percentile(PercentileBUFF, total_samples, 50),
+           perf_percentile(PercentileBUFF, total_samples, 90),
+           perf_percentile(PercentileBUFF, total_samples, 99),
+           PercentileBUFF[total_samples - 1], title, total_samples);
+#else
+    show_times_detail(ft, nsamples, title, ignore_first);
+#endif
+}
+
 void
 end_of_test_group(void)
 {
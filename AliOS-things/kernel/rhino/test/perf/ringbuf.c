@@ -0,0 +1,160 @@
+/*
+ * Copyright (C) 2015-2017 Alibaba Group Holding Limited
+ */
+
+#include <stdlib.h>
+#include "perf.h"
+
+#if (RHINO_CONFIG_RINGBUF_LOCKFREE > 0)
+#include "k_lfring.h"
+
+#define  RINGBUF_NUM        PERF_SAMPLE_NUM
+
+/* records moved per sample, one batch call for the batch cases */
+#define  RINGBUF_BATCH      16u
+#define  RINGBUF_FIX_SIZE   16u
+#define  RINGBUF_DYN_SIZE   64u
+#define  RINGBUF_BUF_SIZE   4096u
+
+static double         RingBufBUFF[RINGBUF_NUM];
+static uint8_t        RingBufMem[RINGBUF_BUF_SIZE] __attribute__((aligned(8)));
+static uint8_t        RingBufIn[RINGBUF_BATCH * RINGBUF_DYN_SIZE];
+static uint8_t        RingBufOut[RINGBUF_BATCH * RINGBUF_DYN_SIZE];
+static size_t         RingBufLen[RINGBUF_BATCH];
+static char           RingBufTitle[32];
+
+static k_ringbuf_t    RingBufLocked;
+static k_spsc_ring_t  RingBufSpsc;
+static k_mpsc_ring_t  RingBufMpsc;
+
+enum {
+    RINGBUF_LOCKED,
+    RINGBUF_SPSC,
+    RINGBUF_SPSC_BATCH,
+    RINGBUF_MPSC,
+    RINGBUF_MPSC_BATCH,
+    RINGBUF_CASE_NUM
+};
+
+static const char *const RingBufName[RINGBUF_CASE_NUM] = {
+    "Locked", "Spsc", "SpscBatch", "Mpsc", "MpscBatch"
+};
+
+static void RingBufMove(uint32_t kind, size_t size)
+{
+    size_t   len;
+    uint32_t i;
+
+    switch (kind) {
+        case RINGBUF_LOCKED:
+#if (RHINO_CONFIG_RINGBUF_VENDOR > 0)
+            for (i = 0; i < RINGBUF_BATCH; i++) {
+                krhino_ringbuf_push(&RingBufLocked, &RingBufIn[i * size], size);
+            }
+            for (i = 0; i < RINGBUF_BATCH; i++) {
+                krhino_ringbuf_pop(&RingBufLocked, &RingBufOut[i * size], &len);
+            }
+#endif
+            break;
+        case RINGBUF_SPSC:
+            for (i = 0; i < RINGBUF_BATCH; i++) {
+                krhino_spsc_ring_push(&RingBufSpsc, &RingBufIn[i * size], size);
+            }
+            for (i = 0; i < RINGBUF_BATCH; i++) {
+                krhino_spsc_ring_pop(&RingBufSpsc, &RingBufOut[i * size], &len);
+            }
+            break;
+        case RINGBUF_SPSC_BATCH:
+            krhino_spsc_ring_push_batch(&RingBufSpsc, RingBufIn, RingBufLen, RINGBUF_BATCH);
+            krhino_spsc_ring_pop_batch(&RingBufSpsc, RingBufOut, sizeof(RingBufOut),
+                                       RingBufLen, RINGBUF_BATCH);
+            break;
+        case RINGBUF_MPSC:
+            for (i = 0; i < RINGBUF_BATCH; i++) {
+                krhino_mpsc_ring_push(&RingBufMpsc, &RingBufIn[i * size], size);
+            }
+            for (i = 0; i < RINGBUF_BATCH; i++) {
+                krhino_mpsc_ring_pop(&RingBufMpsc, &RingBufOut[i * size], &len);
+            }
+            break;
+        case RINGBUF_MPSC_BATCH:
+            krhino_mpsc_ring_push_batch(&RingBufMpsc, RingBufIn, RingBufLen, RINGBUF_BATCH);
+            krhino_mpsc_ring_pop_batch(&RingBufMpsc, RingBufOut, sizeof(RingBufOut),
+                                       RingBufLen, RINGBUF_BATCH);
+            break;
+        default:
+            break;
+    }
+}
+
+/* push then pop RINGBUF_BATCH records, reported per record */
+static void RingBufRun(uint32_t kind, size_t type, size_t size)
+{
+    unsigned long Starttime, Endtime;
+    uint32_t      i;
+
+    memset(RingBufBUFF, 0, sizeof(double) * RINGBUF_NUM);
+
+    switch (kind) {
+        case RINGBUF_LOCKED:
+#if (RHINO_CONFIG_RINGBUF_VENDOR > 0)
+            krhino_ringbuf_init(&RingBufLocked, RingBufMem, sizeof(RingBufMem), type, size);
+#else
+            return;
+#endif
+            break;
+        case RINGBUF_SPSC:
+        case RINGBUF_SPSC_BATCH:
+            krhino_spsc_ring_init(&RingBufSpsc, RingBufMem, sizeof(RingBufMem), type, size);
+            break;
+        default:
+            krhino_mpsc_ring_init(&RingBufMpsc, RingBufMem, sizeof(RingBufMem), type, size);
+            break;
+    }
+
+    for (i = 0; i < RINGBUF_BATCH; i++) {
+        RingBufLen[i] = size;
+    }
+
+    for (i = 0; i < RINGBUF_NUM; i++) {
+        Starttime = PERF_COUNT_GET();
+        RingBufMove(kind, size);
+        Endtime = PERF_COUNT_GET();
+
+        RingBufBUFF[i] = (double)PERF_COUNT_DIFF(Starttime, Endtime) / RINGBUF_BATCH;
+    }
+
+    for (i = 0; i < RINGBUF_NUM; i++) {
+        RingBufBUFF[i] = (double) Turn_to_Realtime(RingBufBUFF[i]);
+    }
+
+    snprintf(RingBufTitle, sizeof(RingBufTitle), "Ring%s%s\t", RingBufName[kind],
+             (type == RINGBUF_TYPE_FIX) ? "Fix" : "Dyn");
+    show_times_percentile(RingBufBUFF, RINGBUF_NUM, RingBufTitle, 1);
+}
+#endif /* RHINO_CONFIG_RINGBUF_LOCKFREE */
+
+void RingBufTimetest(void *arg)
+{
+#if (RHINO_CONFIG_RINGBUF_LOCKFREE > 0)
+    uint32_t kind;
+
+    WaitForNew_tick();
+
+    perf_timer_stop();
+    perf_timer_init(0xffffffff);
+    perf_timer_start();
+
+    for (kind = 0; kind < RINGBUF_CASE_NUM; kind++) {
+        RingBufRun(kind, RINGBUF_TYPE_FIX, RINGBUF_FIX_SIZE);
+    }
+
+    for (kind = 0; kind < RINGBUF_CASE_NUM; kind++) {
+        RingBufRun(kind, RINGBUF_TYPE_DYN, RINGBUF_DYN_SIZE);
+    }
+#endif
+
+    krhino_task_sleep(30);
+    krhino_sem_give(SYNhandle);
+}
+
@@ -2,28 +2,12 @@
  * Copyright (C) 2015-2017 Alibaba Group Holding Limited
  */
 
-#include <k_api.h>
-#include "stdio.h"
-
-#define TASK_TEST_PRI     20
-#define TASK_MAIN_PRI     15
-#define TASK_TEST_STACK_SIZE 1024
-#define  SWITCH_NUM  100
-
-extern ksem_t   *SYNhandle;
-extern void WaitForNew_tick(void);
-extern double   Turn_to_Realtime(double counter);
-extern void show_times_detail(volatile double   *ft,  int nsamples,
-                              char *title, uint32_t ignore_first);
-
-extern void hobbit_timer0_stop(void);
-extern void hobbit_timer0_init(uint32_t hz);
-extern void hobbit_timer0_start(void);
-extern uint32_t hobbit_timer0_get_curval(void);
-extern void hobbit_timer0_clr(void);
+#include "perf.h"
+
+#define  SWITCH_NUM  PERF_SAMPLE_NUM
 
 static volatile unsigned long   Starttime, Endtime, Runtime;
-static double           ShufBUFF[sizeof(double)*SWITCH_NUM] ;
+static double           ShufBUFF[SWITCH_NUM] ;
 static volatile unsigned  long  ShufSwitch = 0;
 static ksem_t       *Shufhandle[2];
 static ktask_t   *ShufTaskHandle[2];
@@ -34,7 +18,7 @@ static void BinaryShuf1(void *arg)
 {
     while (1) {
 
-        Starttime = hobbit_timer0_get_curval();
+        Starttime = PERF_COUNT_GET();
         krhino_sem_give(Shufhandle[0]);
         krhino_sem_take(Shufhandle[1], RHINO_WAIT_FOREVER);
 
@@ -52,8 +36,8 @@ static void BinaryShuf2(void *arg)
     while (1) {
         krhino_sem_take(Shufhandle[0], RHINO_WAIT_FOREVER);
 
-        Endtime = hobbit_timer0_get_curval();
-        Runtime = Starttime - Endtime;
+        Endtime = PERF_COUNT_GET();
+        Runtime = PERF_COUNT_DIFF(Starttime, Endtime);
 
         ShufBUFF[ShufSwitch] = Runtime;
         krhino_sem_give(Shufhandle[1]);
@@ -73,8 +57,8 @@ void BinaryShufTimetest(void *arg)
     krhino_sem_dyn_create(&ShufSynhandle, "synsem", 0);
     ShufSwitch = 0;
 
-    hobbit_timer0_stop();
-    hobbit_timer0_init(0xffffffff);
+    perf_timer_stop();
+    perf_timer_init(0xffffffff);
 
     memset(ShufBUFF, 0, sizeof(double)*SWITCH_NUM);
 
@@ -87,7 +71,7 @@ void BinaryShufTimetest(void *arg)
     krhino_task_dyn_create(&ShufTaskHandle[1], "test_task", 0, TASK_TEST_PRI + 1,
                            0, TASK_TEST_STACK_SIZE, BinaryShuf2, 1);
 
-    hobbit_timer0_start();
+    perf_timer_start();
 
     krhino_sem_take(ShufSynhandle, RHINO_WAIT_FOREVER);
 
@@ -98,7 +82,7 @@ void BinaryShufTimetest(void *arg)
         ShufBUFF[i] = (double) Turn_to_Realtime(ShufBUFF[i]);
     }
 
-    show_times_detail(ShufBUFF , SWITCH_NUM, "BinaryShuf\t", 1);
+    show_times_percentile(ShufBUFF , SWITCH_NUM, "BinaryShuf\t", 1);
     krhino_task_sleep(30);
     krhino_sem_give(SYNhandle);
 }
@@ -2,29 +2,12 @@
  * Copyright (C) 2015-2017 Alibaba Group Holding Limited
  */
 
-#include <k_api.h>
-#include "stdio.h"
+#include "perf.h"
 
-#define TASK_TEST_PRI     20
-#define TASK_MAIN_PRI     15
-#define TASK_TEST_STACK_SIZE 1024
-
-#define  PreeTime  100
-
-extern ksem_t *SYNhandle;
-extern void WaitForNew_tick(void);
-extern double Turn_to_Realtime(double counter);
-extern void show_times_detail(volatile double   *ft,  int nsamples,
-                              char *title, uint32_t ignore_first);
-
-extern void hobbit_timer0_stop(void);
-extern void hobbit_timer0_init(uint32_t hz);
-extern void hobbit_timer0_start(void);
-extern uint32_t hobbit_timer0_get_curval(void);
-extern void hobbit_timer0_clr(void);
+#define  PreeTime  PERF_SAMPLE_NUM
 
 static ksem_t       *PreeSynhandle;
-static double           PreeBUFF[sizeof(double)*PreeTime] ;
+static double           PreeBUFF[PreeTime] ;
 static  ktask_t      *PreeTaskHandle[5];
 static volatile unsigned long   PreeCount = 0;
 static volatile unsigned long   Starttime = 0, Endtime = 0, Runtime = 0;
@@ -33,7 +16,7 @@ static void Preemption0(void *arg)
 {
     while (1) {
 
-        Starttime = hobbit_timer0_get_curval();
+        Starttime = PERF_COUNT_GET();
         krhino_task_resume(PreeTaskHandle[1]);
 
         if (PreeCount >= PreeTime) {
@@ -48,8 +31,8 @@ static void Preemption1(void *arg)
 {
     while (1) {
 
-        Endtime = hobbit_timer0_get_curval();
-        Runtime = Starttime - Endtime;
+        Endtime = PERF_COUNT_GET();
+        Runtime = PERF_COUNT_DIFF(Starttime, Endtime);
 
         PreeBUFF[PreeCount++] = (double)Runtime;
 
@@ -57,7 +40,7 @@ static void Preemption1(void *arg)
             krhino_sem_give(PreeSynhandle);
         }
 
-        Starttime =  hobbit_timer0_get_curval();
+        Starttime =  PERF_COUNT_GET();
         krhino_task_resume(PreeTaskHandle[2]);
 
         krhino_task_suspend(krhino_cur_task_get());
@@ -68,15 +51,15 @@ static void Preemption2(void *arg)
 {
     while (1) {
 
-        Endtime = hobbit_timer0_get_curval();
-        Runtime = Starttime - Endtime;
+        Endtime = PERF_COUNT_GET();
+        Runtime = PERF_COUNT_DIFF(Starttime, Endtime);
         PreeBUFF[PreeCount++] = (double)Runtime;
 
         if (PreeCount >= PreeTime) {
             krhino_sem_give(PreeSynhandle);
         }
 
-        Starttime =  hobbit_timer0_get_curval();
+        Starttime =  PERF_COUNT_GET();
         krhino_task_resume(PreeTaskHandle[3]);
 
         krhino_task_suspend(krhino_cur_task_get());
@@ -87,8 +70,8 @@ static void Preemption3(void *arg)
 {
     while (1) {
 
-        Endtime = hobbit_timer0_get_curval();
-        Runtime = Starttime - Endtime;
+        Endtime = PERF_COUNT_GET();
+        Runtime = PERF_COUNT_DIFF(Starttime, Endtime);
 
         PreeBUFF[PreeCount++] = (double)Runtime;
 
@@ -107,8 +90,8 @@ void  PreemptionTimetest(void *arg)
     WaitForNew_tick();
     krhino_sem_dyn_create(&PreeSynhandle, "pree", 0);
 
-    hobbit_timer0_stop();
-    hobbit_timer0_init(0xffffffff);
+    perf_timer_stop();
+    perf_timer_init(0xffffffff);
 
     memset(PreeBUFF, 0, sizeof(double)*PreeTime);
     krhino_task_dyn_create(&PreeTaskHandle[0], "test_task", 0, TASK_TEST_PRI + 4,
@@ -123,7 +106,7 @@ void  PreemptionTimetest(void *arg)
     krhino_task_suspend(PreeTaskHandle[2]);
     krhino_task_suspend(PreeTaskHandle[3]);
 
-    hobbit_timer0_start();
+    perf_timer_start();
     krhino_sem_take(PreeSynhandle, RHINO_WAIT_FOREVER);
 
     krhino_task_dyn_del(PreeTaskHandle[0]);
@@ -135,7 +118,7 @@ void  PreemptionTimetest(void *arg)
         PreeBUFF[i] = (double) Turn_to_Realtime(PreeBUFF[i]);
     }
 
-    show_times_detail(PreeBUFF , PreeTime, "TaskPree\t", 1);
+    show_times_percentile(PreeBUFF , PreeTime, "TaskPree\t", 1);
     krhino_task_sleep(5);
     krhino_sem_give(SYNhandle);
 }
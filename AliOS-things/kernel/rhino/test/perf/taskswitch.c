@@ -2,31 +2,14 @@
  * Copyright (C) 2015-2017 Alibaba Group Holding Limited
  */
 
-#include <k_api.h>
-#include "stdio.h"
+#include "perf.h"
 
-#define TASK_TEST_PRI     20
-#define TASK_MAIN_PRI     15
-#define TASK_TEST_STACK_SIZE 1024
-
-extern ksem_t *SYNhandle;
-extern void WaitForNew_tick(void);
-extern double   Turn_to_Realtime(double counter);
-extern void show_times_detail(volatile double   *ft,  int nsamples,
-                              char *title, uint32_t ignore_first);
-
-extern void hobbit_timer0_stop(void);
-extern void hobbit_timer0_init(uint32_t hz);
-extern void hobbit_timer0_start(void);
-extern uint32_t hobbit_timer0_get_curval(void);
-extern void hobbit_timer0_clr(void);
-
-#define   TASKSWITCH_NUM   100
+#define   TASKSWITCH_NUM   PERF_SAMPLE_NUM
 
 static volatile unsigned long   TaskSwitch = 0;
 static ktask_t       *xSwitchTaskHandle[2];
 static volatile unsigned long   Starttime, Endtime;
-static volatile   double        SwitchTimeBUFF[sizeof(double)*TASKSWITCH_NUM] ;
+static volatile   double        SwitchTimeBUFF[TASKSWITCH_NUM] ;
 static ksem_t       *Switchhandle[2];
 static ksem_t       *SwitchSynhandle;
 
@@ -35,10 +18,10 @@ static void SwitchTask3(void *arg)
 {
     while (1) {
         for (TaskSwitch = 0; TaskSwitch < TASKSWITCH_NUM;) {
-            Starttime = hobbit_timer0_get_curval();
+            Starttime = PERF_COUNT_GET();
             krhino_task_yield();
-            Endtime = hobbit_timer0_get_curval();
-            SwitchTimeBUFF[TaskSwitch++] = (double)(Starttime - Endtime);
+            Endtime = PERF_COUNT_GET();
+            SwitchTimeBUFF[TaskSwitch++] = (double)PERF_COUNT_DIFF(Starttime, Endtime);
         }
 
         krhino_sem_give(SwitchSynhandle);
@@ -49,9 +32,9 @@ static void SwitchTask4(void *arg)
 {
     while (1) {
         for (; TaskSwitch < TASKSWITCH_NUM;) {
-            Endtime = hobbit_timer0_get_curval();
-            SwitchTimeBUFF[TaskSwitch++] = (double)(Starttime - Endtime);
-            Starttime = hobbit_timer0_get_curval();
+            Endtime = PERF_COUNT_GET();
+            SwitchTimeBUFF[TaskSwitch++] = (double)PERF_COUNT_DIFF(Starttime, Endtime);
+            Starttime = PERF_COUNT_GET();
             krhino_task_yield();
         }
 
@@ -68,9 +51,9 @@ void TaskYIELDtimeTest(void *arg)
     TaskSwitch = 0;
     WaitForNew_tick();
 
-    hobbit_timer0_stop();
+    perf_timer_stop();
 
-    hobbit_timer0_init(0xffffffff);
+    perf_timer_init(0xffffffff);
 
     memset((void *)SwitchTimeBUFF, 0, sizeof(double)*TASKSWITCH_NUM);
 
@@ -85,7 +68,7 @@ void TaskYIELDtimeTest(void *arg)
     krhino_task_dyn_create(&xSwitchTaskHandle[1], "test_task", 0, TASK_TEST_PRI + 1,
                            0, TASK_TEST_STACK_SIZE, SwitchTask4, 1);
 
-    hobbit_timer0_start();
+    perf_timer_start();
 
     krhino_sem_take(SwitchSynhandle, RHINO_WAIT_FOREVER);
 
@@ -98,7 +81,7 @@ void TaskYIELDtimeTest(void *arg)
 
     }
 
-    show_times_detail(SwitchTimeBUFF , TASKSWITCH_NUM, "TaskYIELD\t", 1);
+    show_times_percentile(SwitchTimeBUFF , TASKSWITCH_NUM, "TaskYIELD\t", 1);
     krhino_task_sleep(10);
 
     krhino_sem_give(SYNhandle);
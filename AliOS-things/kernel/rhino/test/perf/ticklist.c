@@ -0,0 +1,164 @@
+/*
+ * Copyright (C) 2015-2017 Alibaba Group Holding Limited
+ */
+
+#include <stdlib.h>
+#include "perf.h"
+
+#define  TICKLIST_NUM        PERF_SAMPLE_NUM
+#define  TICKLIST_TIMER_NUM  PERF_TIMER_SAMPLE_NUM
+
+/* parked waiters never expire while a case runs */
+#define  TICKLIST_PARK_MIN   100000u
+#define  TICKLIST_PARK_RANGE 1000000u
+
+static const uint32_t   TickListWaiters[] = {10, 100, 1000};
+
+static double           TickListBUFF[TICKLIST_NUM];
+static uint32_t         TickListSeed = 1u;
+static char             TickListTitle[32];
+
+static tick_t TickListRand(void)
+{
+    TickListSeed = TickListSeed * 1103515245u + 12345u;
+
+    return TICKLIST_PARK_MIN + (tick_t)((TickListSeed >> 8) % TICKLIST_PARK_RANGE);
+}
+
+/* insert + remove of one sleeper while N others are parked on the tick list */
+static void TickListRun(uint32_t waiters)
+{
+    CPSR_ALLOC();
+
+    ktask_t       *parked;
+    ktask_t        probe;
+    unsigned long  Starttime, Endtime;
+    uint32_t       i;
+
+    parked = krhino_mm_alloc(waiters * sizeof(ktask_t));
+    if (parked == NULL) {
+        printf("no memory for %u waiters\tTickList\n", (unsigned int)waiters);
+        return;
+    }
+
+    memset(parked, 0, waiters * sizeof(ktask_t));
+    memset(&probe, 0, sizeof(probe));
+    memset(TickListBUFF, 0, sizeof(double) * TICKLIST_NUM);
+
+    RHINO_CRITICAL_ENTER();
+    for (i = 0; i < waiters; i++) {
+        tick_list_insert(&parked[i], TickListRand());
+    }
+    RHINO_CRITICAL_EXIT();
+
+    for (i = 0; i < TICKLIST_NUM; i++) {
+        RHINO_CRITICAL_ENTER();
+        Starttime = PERF_COUNT_GET();
+        tick_list_insert(&probe, TickListRand());
+        tick_list_rm(&probe);
+        Endtime = PERF_COUNT_GET();
+        RHINO_CRITICAL_EXIT();
+
+        TickListBUFF[i] = (double)PERF_COUNT_DIFF(Starttime, Endtime);
+    }
+
+    RHINO_CRITICAL_ENTER();
+    for (i = 0; i < waiters; i++) {
+        tick_list_rm(&parked[i]);
+    }
+    RHINO_CRITICAL_EXIT();
+
+    krhino_mm_free(parked);
+
+    for (i = 0; i < TICKLIST_NUM; i++) {
+        TickListBUFF[i] = (double) Turn_to_Realtime(TickListBUFF[i]);
+    }
+
+    snprintf(TickListTitle, sizeof(TickListTitle), "TickList%u\t", (unsigned int)waiters);
+    show_times_percentile(TickListBUFF, TICKLIST_NUM, TickListTitle, 1);
+}
+
+#if (RHINO_CONFIG_TIMER > 0)
+static void TimerListCb(void *timer, void *arg)
+{
+}
+
+/* timer start + stop round trip through the timer task with N armed timers */
+static void TimerListRun(uint32_t timers)
+{
+    ktimer_t     **parked;
+    ktimer_t      *probe;
+    unsigned long  Starttime, Endtime;
+    uint32_t       i;
+
+    parked = krhino_mm_alloc(timers * sizeof(ktimer_t *));
+    if (parked == NULL) {
+        printf("no memory for %u timers\tTimerList\n", (unsigned int)timers);
+        return;
+    }
+
+    memset(TickListBUFF, 0, sizeof(double) * TICKLIST_NUM);
+
+    for (i = 0; i < timers; i++) {
+        if (krhino_timer_dyn_create(&parked[i], "perf_timer", TimerListCb,
+                                    TickListRand(), 0, NULL, 1) != RHINO_SUCCESS) {
+            parked[i] = NULL;
+        }
+    }
+
+    krhino_timer_dyn_create(&probe, "perf_timer", TimerListCb,
+                            TICKLIST_PARK_MIN + TICKLIST_PARK_RANGE / 2u, 0, NULL, 0);
+
+    for (i = 0; i < TICKLIST_TIMER_NUM; i++) {
+        Starttime = PERF_COUNT_GET();
+        krhino_timer_start(probe);
+        krhino_timer_stop(probe);
+        Endtime = PERF_COUNT_GET();
+
+        TickListBUFF[i] = (double)PERF_COUNT_DIFF(Starttime, Endtime);
+    }
+
+    krhino_timer_dyn_del(probe);
+
+    for (i = 0; i < timers; i++) {
+        if (parked[i] != NULL) {
+            krhino_timer_stop(parked[i]);
+            krhino_timer_dyn_del(parked[i]);
+        }
+    }
+
+    krhino_mm_free(parked);
+
+    for (i = 0; i < TICKLIST_TIMER_NUM; i++) {
+        TickListBUFF[i] = (double) Turn_to_Realtime(TickListBUFF[i]);
+    }
+
+    snprintf(TickListTitle, sizeof(TickListTitle), "TimerList%u\t", (unsigned int)timers);
+    show_times_percentile(TickListBUFF, TICKLIST_TIMER_NUM, TickListTitle, 1);
+}
+#endif
+
+void TickListTimetest(void *arg)
+{
+    uint32_t i;
+
+    WaitForNew_tick();
+
+    perf_timer_stop();
+    perf_timer_init(0xffffffff);
+    perf_timer_start();
+
+    for (i = 0; i < sizeof(TickListWaiters) / sizeof(TickListWaiters[0]); i++) {
+        TickListRun(TickListWaiters[i]);
+    }
+
+#if (RHINO_CONFIG_TIMER > 0)
+    for (i = 0; i < sizeof(TickListWaiters) / sizeof(TickListWaiters[0]); i++) {
+        TimerListRun(TickListWaiters[i]);
+    }
+#endif
+
+    krhino_task_sleep(30);
+    krhino_sem_give(SYNhandle);
+}
+
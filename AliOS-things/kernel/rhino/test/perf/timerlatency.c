@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 2015-2017 Alibaba Group Holding Limited
+ */
+
+#include "perf.h"
+
+#ifdef PERF_CONFIG_HOST
+
+#define  TIMER_NUM  PERF_TIMER_SAMPLE_NUM
+
+static double           TimerBUFF[TIMER_NUM] ;
+static volatile unsigned  long  TimerCount = 0;
+static ktimer_t         *TimerHandle;
+static ksem_t           *TimerSynhandle;
+
+/* latency from the tick interrupt which expired the timer to its callback */
+static void TimerLatencyCb(void *timer, void *arg)
+{
+    unsigned long Endtime;
+
+    Endtime = PERF_COUNT_GET();
+
+    if (TimerCount < TIMER_NUM) {
+        TimerBUFF[TimerCount++] = (double)PERF_COUNT_DIFF((unsigned long)g_cpu_tick_stamp,
+                                                          Endtime);
+        if (TimerCount == TIMER_NUM) {
+            krhino_sem_give(TimerSynhandle);
+        }
+    }
+}
+
+void TimerLatencyTimetest(void *arg)
+{
+    unsigned long i ;
+    WaitForNew_tick();
+
+    krhino_sem_dyn_create(&TimerSynhandle, "synsem", 0);
+    TimerCount = 0;
+
+    memset(TimerBUFF, 0, sizeof(double)*TIMER_NUM);
+
+    krhino_timer_dyn_create(&TimerHandle, "perf_timer", TimerLatencyCb, 1, 1, NULL, 1);
+
+    krhino_sem_take(TimerSynhandle, RHINO_WAIT_FOREVER);
+
+    krhino_timer_stop(TimerHandle);
+    krhino_timer_dyn_del(TimerHandle);
+    krhino_sem_dyn_del(TimerSynhandle);
+
+    for (i = 0; i < TIMER_NUM; i++) {
+        TimerBUFF[i] = (double) Turn_to_Realtime(TimerBUFF[i]);
+    }
+
+    show_times_percentile(TimerBUFF , TIMER_NUM, "TimerLatency\t", 1);
+    krhino_task_sleep(30);
+    krhino_sem_give(SYNhandle);
+}
+
+#endif /* PERF_CONFIG_HOST */
@@ -0,0 +1,34 @@
+src = Split('''
+    perf.c
+    realtimelib.c
+    taskswitch.c
+    taskpree.c
+    sem.c
+    mutex.c
+    queue.c
+    ticklist.c
+    ringbuf.c
+    mm.c
+    mmtrace.c
+''')
+
+component = aos_component('perf', src)
+component.add_global_includes('.')
+
+if aos_global_config.arch == 'linux':
+    component.add_global_macros('PERF_CONFIG_HOST')
+    component.add_sources('timerlatency.c')
+    component.add_sources('perf_app.c')
+else:
+    component.add_sources('intrealtime.c')
+    component.add_sources('timer.c')
+
+if aos_global_config.compiler == 'gcc':
+    component_cflags = Split('''
+        -Wall
+        -Werror
+        -Wno-unused-variable
+        -Wno-unused-parameter
+    ''')
+    for i in component_cflags:
+        component.add_cflags(i)
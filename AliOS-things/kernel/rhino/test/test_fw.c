@@ -29,6 +29,8 @@ extern void workqueue_test(void);
 extern void ysh_cmd_test(void);
 extern void mm_region_test(void);
 extern void ringbuf_test(void);
+extern void trace_test(void);
+extern void yloop_test(void);
 
 test_case_map_t test_fw_map[] = {
     {"task_test", task_test},
@@ -50,6 +52,12 @@ test_case_map_t test_fw_map[] = {
 #endif
     {"buf_queue_test", buf_queue_test},
     {"comb_test", comb_test},
+#if (RHINO_CONFIG_TRACE > 0)
+    {"trace_test", trace_test},
+#endif
+#if defined(AOS_LOOP) && defined(AOS_VFS)
+    {"yloop_test", yloop_test},
+#endif
     /* last must be NULL! */
     {NULL, NULL},
 };
@@ -1,6 +1,7 @@
 src = Split('''
     test_fw.c 
     test_self_entry.c 
+    core/buf_queue/buf_queue_batch.c 
     core/buf_queue/buf_queue_del.c 
     core/buf_queue/buf_queue_dyn_create.c 
     core/buf_queue/buf_queue_flush.c 
@@ -13,7 +14,10 @@ src = Split('''
     core/event/event_reinit.c 
     core/event/event_test.c 
     core/mm/mm_break.c 
+    core/mm/mm_fit.c 
+    core/mm/mm_magazine.c 
     core/mm/mm_opr.c 
+    core/mm/mm_prof.c 
     core/mm/mm_param.c 
     core/mm/mm_test.c 
     core/mm_blk/mm_blk_break.c 
@@ -21,12 +25,14 @@ src = Split('''
     core/mm_blk/mm_blk_opr.c 
     core/mm_blk/mm_blk_param.c 
     core/mm_blk/mm_blk_reinit.c 
+    core/mm_blk/mm_blk_slab.c 
     core/mm_blk/mm_blk_test.c 
     core/mutex/mutex_opr.c 
     core/mutex/mutex_param.c 
     core/mutex/mutex_reinit.c 
     core/mutex/mutex_test.c 
     core/queue/queue_back_send.c 
+    core/queue/queue_batch.c 
     core/queue/queue_del.c 
     core/queue/queue_flush.c 
     core/queue/queue_info_get.c 
@@ -58,10 +64,17 @@ src = Split('''
     core/timer/timer_dyn_create_del.c 
     core/timer/timer_start_stop.c 
     core/timer/timer_test.c 
+    core/timer/timer_wheel.c 
     core/workqueue/workqueue_test.c 
     core/workqueue/workqueue_interface.c 
+    core/workqueue/workqueue_pool.c 
     core/ringbuf/ringbuf_break.c 
+    core/ringbuf/ringbuf_lockfree.c 
     core/ringbuf/ringbuf_test.c 
+    core/trace/trace_ring.c 
+    core/trace/trace_test.c 
+    yloop/yloop_edge.c 
+    yloop/yloop_test.c 
     core/combination/comb_test.c 
     core/combination/sem_event.c 
     core/combination/sem_queue_buf.c 
@@ -70,6 +83,7 @@ src = Split('''
 
 component = aos_component('test', src)
 component.add_global_includes('.')
+component.add_includes('../../yloop')
 
 if aos_global_config.compiler == 'gcc':
     component_cflags = Split('''
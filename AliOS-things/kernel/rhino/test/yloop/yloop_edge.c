@@ -0,0 +1,144 @@
+/*
+ * Copyright (C) 2015-2017 Alibaba Group Holding Limited
+ */
+
+#include <k_api.h>
+#include <test_fw.h>
+#include "yloop_test.h"
+
+#define MODULE_NAME "yloop_edge"
+
+#if defined(AOS_LOOP) && defined(AOS_VFS)
+#include <aos/aos.h>
+#include <vfs.h>
+#include <loop_device.h>
+#include "yloop.h"
+
+#define YLOOP_EDGE_RUN_MS 50
+
+#define YLOOP_CHK(value) do {if ((int)(value) == 0) \
+        {MYASSERT(0); return 1;}} while (0)
+
+typedef struct {
+    int fd;
+    int drain;
+    int calls;
+} yloop_edge_t;
+
+static void yloop_edge_exit(void *arg)
+{
+    aos_loop_exit();
+}
+
+/* a draining callback is followed by new data, as if the peer sent more */
+static void yloop_edge_read(int fd, void *arg)
+{
+    yloop_edge_t *e = arg;
+    char          buf[16];
+
+    e->calls++;
+
+    if (!e->drain) {
+        return;
+    }
+
+    while (aos_read(fd, buf, sizeof(buf)) > 0) {
+    }
+
+    if (e->calls == 1) {
+        aos_write(fd, "y", 1);
+    }
+}
+
+/* one byte is pending when the loop starts, returns bytes left after it */
+static int yloop_edge_run(const yloop_backend_t *be, yloop_edge_t *e)
+{
+    char c;
+    int  left;
+
+    if (vfs_loop_device_init() != 0 || aos_loop_init() == NULL) {
+        return -1;
+    }
+
+    if (be != NULL && yloop_backend_set(be) != 0) {
+        aos_loop_destroy();
+        return -1;
+    }
+
+    e->fd = aos_open(LOOP_DEVICE_PATH, 0);
+    if (e->fd < 0) {
+        aos_loop_destroy();
+        return -1;
+    }
+
+    aos_write(e->fd, "x", 1);
+    aos_poll_read_fd(e->fd, yloop_edge_read, e);
+    aos_poll_fd_edge(e->fd, 1);
+    aos_post_delayed_action(YLOOP_EDGE_RUN_MS, yloop_edge_exit, NULL);
+    aos_loop_run();
+
+    for (left = 0; aos_read(e->fd, &c, 1) == 1; left++) {
+    }
+
+    aos_cancel_poll_read_fd(e->fd, yloop_edge_read, e);
+    aos_close(e->fd);
+    aos_loop_destroy();
+
+    return left;
+}
+
+/* poll has no edges, it still sees the data after the drain */
+static uint8_t yloop_edge_case1(void)
+{
+    yloop_edge_t e = {-1, 1, 0};
+
+    YLOOP_CHK(yloop_edge_run(&yloop_poll_backend, &e) == 0);
+    YLOOP_CHK(e.calls == 2);
+
+    return 0;
+}
+
+/* epoll turns the fd ready again on the new data */
+static uint8_t yloop_edge_case2(void)
+{
+    yloop_edge_t e = {-1, 1, 0};
+
+    YLOOP_CHK(yloop_edge_run(&yloop_epoll_backend, &e) == 0);
+    YLOOP_CHK(e.calls == 2);
+
+    return 0;
+}
+
+/* an fd left ready is not reported again on epoll */
+static uint8_t yloop_edge_case3(void)
+{
+    yloop_edge_t e = {-1, 0, 0};
+
+    YLOOP_CHK(yloop_edge_run(&yloop_epoll_backend, &e) == 1);
+    YLOOP_CHK(e.calls == 1);
+
+    return 0;
+}
+
+static const test_func_t yloop_func_runner[] = {
+    yloop_edge_case1,
+    yloop_edge_case2,
+    yloop_edge_case3,
+    NULL
+};
+
+void yloop_edge_test(void)
+{
+    kstat_t ret;
+
+    task_yloop_entry_register(MODULE_NAME, (test_func_t *)yloop_func_runner,
+                              sizeof(yloop_func_runner) / sizeof(test_func_t));
+
+    ret = krhino_task_dyn_create(&task_yloop, MODULE_NAME, 0, TASK_YLOOP_PRI,
+                                 0, TASK_TEST_STACK_SIZE, task_yloop_entry, 1);
+    if ((ret != RHINO_SUCCESS) && (ret != RHINO_STOPPED)) {
+        test_case_fail++;
+        PRINT_RESULT(MODULE_NAME, FAIL);
+    }
+}
+#endif
@@ -0,0 +1,23 @@
+/*
+ * Copyright (C) 2015-2017 Alibaba Group Holding Limited
+ */
+
+#ifndef YLOOP_TEST_H
+#define YLOOP_TEST_H
+
+#define TASK_YLOOP_PRI       16
+#define TASK_TEST_STACK_SIZE 4096
+
+#define MYASSERT(value) do {if ((value) == 0) { printf("%s:%d\n", __FUNCTION__, __LINE__); }} while (0)
+
+extern ktask_t *task_yloop;
+
+typedef uint8_t (*test_func_t)(void);
+
+void task_yloop_entry_register(const char *name, test_func_t *runner,
+                               uint8_t casenum);
+void task_yloop_entry(void *arg);
+void yloop_test(void);
+void yloop_edge_test(void);
+
+#endif /* YLOOP_TEST_H */
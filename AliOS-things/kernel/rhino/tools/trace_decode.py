@@ -0,0 +1,270 @@
+#!/usr/bin/env python3
+#
+# Copyright (C) 2015-2017 Alibaba Group Holding Limited
+#
+# Decode the k_trace record stream (what trace_drain() / the trace sink hands
+# out) into Chrome trace JSON, to be opened by chrome://tracing or Perfetto.
+#
+#   trace_decode.py trace.bin -o trace.json --hz 1000000000
+#
+# "CPUs" shows which task runs on each cpu, "Tasks" shows per task when it
+# runs and what it is blocked on (mutex / sem / queue / buf_queue / event),
+# with an arrow from the waker. Priority inversions and the other kernel
+# events are instant markers on the task that hit them.
+
+import argparse
+import json
+import struct
+import sys
+
+ID_SYNC = 0x001
+ID_LOST = 0x002
+ID_NAME = 0x003
+ID_INIT = 0x101
+ID_TASK_SWITCH = 0x102
+ID_INTRPT_TASK_SWITCH = 0x104
+ID_TASK_DEL = 0x108
+ID_TASK_ABORT = 0x109
+ID_TASK_PRI_INV = 0x304
+
+EVENT_NAME = {
+    0x103: 'task_create', 0x105: 'task_pri_change', 0x106: 'task_suspend',
+    0x107: 'task_resume', 0x108: 'task_del', 0x109: 'task_abort',
+    0x10a: 'task_sleep',
+    0x201: 'sem_create', 0x202: 'sem_overflow', 0x203: 'sem_cnt_increase',
+    0x204: 'sem_get_success', 0x205: 'sem_get_blk', 0x206: 'sem_task_wake',
+    0x207: 'sem_del',
+    0x301: 'mutex_create', 0x302: 'mutex_release', 0x303: 'mutex_get',
+    0x304: 'task_pri_inv', 0x305: 'mutex_get_blk',
+    0x306: 'mutex_release_success', 0x307: 'mutex_task_wake',
+    0x308: 'mutex_del',
+    0x401: 'event_create', 0x402: 'event_get', 0x403: 'event_get_blk',
+    0x404: 'event_task_wake', 0x405: 'event_del',
+    0x501: 'buf_queue_create', 0x502: 'buf_queue_max',
+    0x503: 'buf_queue_post', 0x504: 'buf_queue_task_wake',
+    0x505: 'buf_queue_get_blk',
+    0x601: 'timer_create', 0x602: 'timer_del',
+    0x701: 'mblk_pool_create', 0x901: 'mm_region_create',
+    0xa01: 'work_init', 0xa02: 'workqueue_create', 0xa03: 'workqueue_del',
+    0xb01: 'queue_create', 0xb02: 'queue_get_blk', 0xb03: 'queue_task_wake',
+}
+
+# get_blk id -> (object kind, matching task_wake id)
+BLOCK = {
+    0x205: ('sem', 0x206),
+    0x305: ('mutex', 0x307),
+    0x403: ('event', 0x404),
+    0x505: ('buf_queue', 0x504),
+    0xb02: ('queue', 0xb03),
+}
+WAKE = dict((wake, kind) for kind, wake in BLOCK.values())
+
+# ids whose arg is a task
+ARG_TASK = set(WAKE)
+# ids whose obj is a task
+OBJ_TASK = set([0x103, 0x105, 0x106, 0x107, 0x108, 0x109, 0x10a, 0x302, 0x304])
+
+PID_CPU = 0
+PID_TASK = 1
+
+
+class Cpu(object):
+    def __init__(self):
+        self.synced = False
+        self.now = 0
+        self.task = None
+        self.run_start = None
+
+
+def read_records(path, endian, ptr_size):
+    rec = struct.Struct(endian + 'IHBB' + ('QQ' if ptr_size == 8 else 'II'))
+    chars = struct.Struct(endian + 'I')
+    with open(path, 'rb') as f:
+        data = f.read()
+    for off in range(0, len(data) - len(data) % rec.size, rec.size):
+        fields = rec.unpack_from(data, off)
+        # a NAME arg holds 4 chars as copied into a uint32_t
+        yield fields, chars.pack(fields[5] & 0xffffffff)
+
+
+def collect_names(records):
+    chunks = {}
+    for (delta, rid, cpu, arg0, obj, arg), raw in records:
+        if rid == ID_NAME:
+            chunks.setdefault(obj, {})[arg0] = raw
+    names = {}
+    for obj, parts in chunks.items():
+        buf = b''.join(parts[off] for off in sorted(parts))
+        names[obj] = buf.split(b'\0', 1)[0].decode('utf-8', 'replace')
+    return names
+
+
+def decode(records, names, hz):
+    events = []
+    cpus = {}
+    tasks = set()
+    blocked = {}
+    flow_id = [0]
+
+    def us(count):
+        return count * 1e6 / hz
+
+    def name(obj):
+        if obj in names:
+            return names[obj]
+        return '0x%08x' % obj
+
+    def run_end(c, cpu, now):
+        if c.task is not None and c.run_start is not None:
+            events.append({'ph': 'X', 'pid': PID_CPU, 'tid': cpu,
+                           'name': name(c.task), 'ts': us(c.run_start),
+                           'dur': us(now - c.run_start)})
+            events.append({'ph': 'X', 'pid': PID_TASK, 'tid': c.task,
+                           'name': 'running', 'ts': us(c.run_start),
+                           'dur': us(now - c.run_start),
+                           'args': {'cpu': cpu}})
+
+    def block_end(task, now, how, waker=None):
+        blk = blocked.pop(task, None)
+        if blk is None:
+            return
+        kind, obj, start = blk
+        args = {kind: name(obj), 'end': how}
+        if waker is not None:
+            args['woken by'] = name(waker)
+        events.append({'ph': 'X', 'pid': PID_TASK, 'tid': task,
+                       'name': 'blocked on %s %s' % (kind, name(obj)),
+                       'ts': us(start), 'dur': us(now - start), 'args': args})
+
+    now = 0
+    for (delta, rid, cpu, arg0, obj, arg), raw in records:
+        c = cpus.setdefault(cpu, Cpu())
+
+        if rid == ID_SYNC:
+            t = (arg << 32) | obj
+            # 32 bit counters wrap, keep the time monotonic per cpu
+            if c.synced and t < c.now:
+                t += (((c.now - t) >> 32) + 1) << 32
+            c.now = t
+            c.synced = True
+            continue
+
+        if rid == ID_LOST:
+            events.append({'ph': 'i', 's': 't', 'pid': PID_CPU, 'tid': cpu,
+                           'name': 'lost %d records' % obj, 'ts': us(c.now)})
+            if arg0:
+                # the delta chain is broken until the next SYNC
+                c.synced = False
+            continue
+
+        if rid == ID_NAME or not c.synced:
+            continue
+
+        c.now += delta
+        now = max(now, c.now)
+        cur = c.task
+
+        if rid == ID_INIT:
+            if obj != 0:
+                c.task = obj
+                c.run_start = c.now
+                tasks.add(obj)
+            continue
+
+        if rid in (ID_TASK_SWITCH, ID_INTRPT_TASK_SWITCH):
+            run_end(c, cpu, c.now)
+            c.task = arg
+            c.run_start = c.now
+            tasks.add(obj)
+            tasks.add(arg)
+            # woken by timeout, or the wake was lost
+            block_end(arg, c.now, 'timeout')
+            continue
+
+        if rid in BLOCK and cur is not None:
+            blocked[cur] = (BLOCK[rid][0], obj, c.now)
+
+        if rid in WAKE and arg in blocked:
+            block_end(arg, c.now, 'wake', cur)
+            if cur is not None:
+                flow_id[0] += 1
+                events.append({'ph': 's', 'pid': PID_TASK, 'tid': cur,
+                               'name': 'wake', 'cat': 'wake',
+                               'id': flow_id[0], 'ts': us(c.now)})
+                events.append({'ph': 'f', 'bp': 'e', 'pid': PID_TASK,
+                               'tid': arg, 'name': 'wake', 'cat': 'wake',
+                               'id': flow_id[0], 'ts': us(c.now)})
+
+        if rid in (ID_TASK_DEL, ID_TASK_ABORT):
+            block_end(obj, c.now, EVENT_NAME[rid])
+
+        args = {'obj': name(obj), 'arg': arg, 'arg0': arg0}
+        if rid in ARG_TASK:
+            args['arg'] = name(arg)
+            tasks.add(arg)
+        if rid in OBJ_TASK:
+            tasks.add(obj)
+
+        if rid == ID_TASK_PRI_INV:
+            # marked on the owner, which inherits the pri of the waiter
+            args = {'waiter': name(cur) if cur is not None else '?',
+                    'owner pri': arg0}
+            events.append({'ph': 'i', 's': 't', 'pid': PID_TASK, 'tid': obj,
+                           'name': 'pri inversion', 'ts': us(c.now),
+                           'args': args})
+            continue
+
+        ev = {'ph': 'i', 's': 't', 'ts': us(c.now),
+              'name': EVENT_NAME.get(rid, 'id 0x%x' % rid), 'args': args}
+        if cur is not None:
+            ev['pid'], ev['tid'] = PID_TASK, cur
+        else:
+            ev['pid'], ev['tid'] = PID_CPU, cpu
+        events.append(ev)
+
+    for cpu, c in cpus.items():
+        run_end(c, cpu, c.now)
+    for task in list(blocked):
+        block_end(task, now, 'end of trace')
+
+    meta = [{'ph': 'M', 'pid': PID_CPU, 'name': 'process_name',
+             'args': {'name': 'CPUs'}},
+            {'ph': 'M', 'pid': PID_TASK, 'name': 'process_name',
+             'args': {'name': 'Tasks'}}]
+    for cpu in sorted(cpus):
+        meta.append({'ph': 'M', 'pid': PID_CPU, 'tid': cpu,
+                     'name': 'thread_name', 'args': {'name': 'cpu%d' % cpu}})
+    for task in sorted(tasks):
+        meta.append({'ph': 'M', 'pid': PID_TASK, 'tid': task,
+                     'name': 'thread_name', 'args': {'name': name(task)}})
+
+    return meta + events
+
+
+def main():
+    parser = argparse.ArgumentParser(description='k_trace records to Chrome trace JSON')
+    parser.add_argument('input', help='raw records, as handed to the trace sink')
+    parser.add_argument('-o', '--output', help='json file, stdout by default')
+    parser.add_argument('--hz', type=float, default=1e9,
+                        help='HR_COUNT_GET() frequency (default 1e9, linuxhost counts ns)')
+    parser.add_argument('--big-endian', action='store_true',
+                        help='the target is big endian')
+    parser.add_argument('--ptr-size', type=int, choices=(4, 8), default=4,
+                        help='pointer size of the target, 8 for linuxhost on a 64 bit cpu')
+    opts = parser.parse_args()
+
+    records = list(read_records(opts.input, '>' if opts.big_endian else '<',
+                                opts.ptr_size))
+    names = collect_names(records)
+    trace = {'traceEvents': decode(records, names, opts.hz),
+             'displayTimeUnit': 'ns'}
+
+    if opts.output:
+        with open(opts.output, 'w') as f:
+            json.dump(trace, f)
+    else:
+        json.dump(trace, sys.stdout)
+
+
+if __name__ == '__main__':
+    main()
@@ -9,11 +9,14 @@ src     = Split('''
                    core/k_buf_queue.c    
                    core/k_event.c        
                    core/k_mm_blk.c       
+                   core/k_mm_slab.c      
+                   core/k_mm_prof.c      
                    core/k_mutex.c        
                    core/k_pend.c         
                    core/k_sched.c        
                    core/k_sys.c          
                    core/k_tick.c         
+                   core/k_tick_wheel.c   
                    core/k_workqueue.c    
                    core/k_dyn_mem_proc.c 
                    core/k_idle.c         
@@ -23,11 +26,13 @@ src     = Split('''
                    core/k_task.c         
                    core/k_time.c         
                    common/k_fifo.c       
+                   common/k_lfring.c     
                    common/k_trace.c
 ''')
 component = aos_component('rhino', src)
 
 component.add_global_includes('core/include')
+component.add_global_includes('common')
 
 CONFIG_SYSINFO_KERNEL_VERSION = 'AOS-R-1.3.0'
 component.add_global_macros({'SYSINFO_KERNEL_VERSION':'\\"AOS-R-1.3.0\\"'})
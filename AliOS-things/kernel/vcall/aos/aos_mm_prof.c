@@ -0,0 +1,221 @@
+/*
+ * Copyright (C) 2015-2017 Alibaba Group Holding Limited
+ */
+
+#include <k_api.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <aos/aos.h>
+
+#ifdef AOS_VFS
+#include <vfs_conf.h>
+#include <vfs_err.h>
+#include <vfs_register.h>
+#endif
+
+#if (RHINO_CONFIG_MM_PROF > 0)
+typedef struct {
+    size_t len;
+    char   text[];
+} mm_prof_snap_t;
+
+/* the profile may grow by the allocation of its own buffer, retry a few times */
+static mm_prof_snap_t *mm_prof_snap(void)
+{
+    mm_prof_snap_t *snap;
+    size_t          len;
+    int             i;
+
+    len = krhino_mm_prof_pprof(NULL, 0);
+
+    for (i = 0; i < 3; i++) {
+        snap = aos_malloc(sizeof(*snap) + len + 64);
+        if (snap == NULL) {
+            return NULL;
+        }
+
+        snap->len = krhino_mm_prof_pprof(snap->text, len + 64);
+        if (snap->len < len + 64) {
+            return snap;
+        }
+
+        len = snap->len;
+        aos_free(snap);
+    }
+
+    return NULL;
+}
+
+#ifdef AOS_VFS
+/* "cat /dev/mmprof > heap.prof", then "go tool pprof <elf> heap.prof" */
+static int mm_prof_open(inode_t *node, file_t *file)
+{
+    file->f_arg = mm_prof_snap();
+    if (file->f_arg == NULL) {
+        return -ENOMEM;
+    }
+
+    return 0;
+}
+
+static int mm_prof_close(file_t *file)
+{
+    aos_free(file->f_arg);
+
+    return 0;
+}
+
+static ssize_t mm_prof_read(file_t *file, void *buf, size_t len)
+{
+    mm_prof_snap_t *snap = file->f_arg;
+
+    if (file->offset >= snap->len) {
+        return 0;
+    }
+
+    if (len > snap->len - file->offset) {
+        len = snap->len - file->offset;
+    }
+
+    memcpy(buf, snap->text + file->offset, len);
+    file->offset += len;
+
+    return len;
+}
+
+static file_ops_t mm_prof_fops = {
+    .open  = mm_prof_open,
+    .read  = mm_prof_read,
+    .close = mm_prof_close,
+};
+#endif
+
+#ifdef CONFIG_AOS_CLI
+static int mm_prof_site_cmp(const void *a, const void *b)
+{
+    const k_mm_prof_site_t *sa = a;
+    const k_mm_prof_site_t *sb = b;
+
+    if (sa->live_size != sb->live_size) {
+        return sa->live_size < sb->live_size ? 1 : -1;
+    }
+
+    return sa->alloc_size < sb->alloc_size ? 1 : (sa->alloc_size > sb->alloc_size ? -1 : 0);
+}
+
+/* the peak is scaled like the allocations of the site */
+static size_t mm_prof_peak(const k_mm_prof_site_t *site, size_t rate)
+{
+    if (site->alloc_size == 0) {
+        return 0;
+    }
+
+    return (size_t)((uint64_t)site->peak_size *
+                    krhino_mm_prof_unsample(site->alloc_cnt, site->alloc_size, rate) /
+                    site->alloc_size);
+}
+
+static void mm_prof_list(void)
+{
+    k_mm_prof_site_t *sites;
+    size_t            rate;
+    uint32_t          num;
+    uint32_t          i;
+
+    sites = aos_malloc(RHINO_CONFIG_MM_PROF_SITES * sizeof(*sites));
+    if (sites == NULL) {
+        aos_cli_printf("mmprof: no memory\r\n");
+        return;
+    }
+
+    num = krhino_mm_prof_sites_get(sites, RHINO_CONFIG_MM_PROF_SITES, &rate);
+    qsort(sites, num, sizeof(*sites), mm_prof_site_cmp);
+
+    if (rate == 0) {
+        aos_cli_printf("stopped, ");
+        rate = RHINO_CONFIG_MM_PROF_RATE;
+    }
+
+    aos_cli_printf("rate %u, estimated bytes:\r\n", (unsigned)rate);
+    aos_cli_printf("site        task              live        peak        allocated\r\n");
+
+    for (i = 0; i < num; i++) {
+        aos_cli_printf("0x%08lx  %-16s  %-10u  %-10u  %u\r\n", (unsigned long)sites[i].site,
+                       sites[i].task ? sites[i].task : "(isr)",
+                       (unsigned)krhino_mm_prof_unsample(sites[i].live_cnt, sites[i].live_size, rate),
+                       (unsigned)mm_prof_peak(&sites[i], rate),
+                       (unsigned)krhino_mm_prof_unsample(sites[i].alloc_cnt, sites[i].alloc_size, rate));
+    }
+
+    aos_free(sites);
+}
+
+static void mm_prof_print(void)
+{
+    mm_prof_snap_t *snap;
+    char           *line;
+    char           *end;
+
+    snap = mm_prof_snap();
+    if (snap == NULL) {
+        aos_cli_printf("mmprof: no memory\r\n");
+        return;
+    }
+
+    /* the cli print buffer is short, one line at a time */
+    for (line = snap->text; line < snap->text + snap->len; line = end + 1) {
+        end = strchr(line, '\n');
+        aos_cli_printf("%.*s\r\n", (int)(end - line), line);
+    }
+
+    aos_free(snap);
+}
+
+static void handle_mm_prof_cmd(char *pwbuf, int blen, int argc, char **argv)
+{
+    const char *rtype = argc > 1 ? argv[1] : "";
+
+    if (strcmp(rtype, "start") == 0) {
+        krhino_mm_prof_start(argc > 2 ? strtoul(argv[2], NULL, 0) : 0);
+    } else if (strcmp(rtype, "stop") == 0) {
+        krhino_mm_prof_stop();
+    } else if (strcmp(rtype, "reset") == 0) {
+        krhino_mm_prof_reset();
+    } else if (strcmp(rtype, "pprof") == 0) {
+        mm_prof_print();
+    } else {
+        mm_prof_list();
+    }
+}
+
+static struct cli_command mm_prof_cmd = {
+    "mmprof",
+    "mmprof [start [rate] | stop | reset | pprof]",
+    handle_mm_prof_cmd
+};
+#endif
+
+int aos_mm_prof_init(void)
+{
+    int ret = 0;
+
+#ifdef AOS_VFS
+    ret = aos_register_driver("/dev/mmprof", &mm_prof_fops, NULL);
+    if (ret != VFS_SUCCESS) {
+        return ret;
+    }
+#endif
+
+#ifdef CONFIG_AOS_CLI
+    aos_cli_register_command(&mm_prof_cmd);
+#endif
+
+    return ret;
+}
+#else
+int aos_mm_prof_init(void)
+{
+    return 0;
+}
+#endif
@@ -13,6 +13,15 @@
 
 #define MS2TICK(ms) krhino_ms_to_ticks(ms)
 
+/* a macro, so the profiler charges the caller of the aos_*alloc() it is in */
+#if (RHINO_CONFIG_MM_PROF > 0) && defined (__CC_ARM)
+#define MM_PROF_SITE_SET(p) krhino_mm_prof_site_set((p), __return_address())
+#elif (RHINO_CONFIG_MM_PROF > 0) && defined (__GNUC__)
+#define MM_PROF_SITE_SET(p) krhino_mm_prof_site_set((p), (size_t)__builtin_return_address(0))
+#else
+#define MM_PROF_SITE_SET(p)
+#endif
+
 static unsigned int used_bitmap;
 
 extern void hal_reboot(void);
@@ -675,10 +684,8 @@ void aos_work_destroy(aos_work_t *work)
 
     w = work->hdl;
 
-    if (w->timer != NULL) {
-        krhino_timer_stop(w->timer);
-        krhino_timer_dyn_del(w->timer);
-    }
+    /* takes a delayed work off the workqueue wheel */
+    krhino_work_cancel(w);
 
     aos_free(work->hdl);
     work->hdl = NULL;
@@ -760,6 +767,8 @@ void *aos_zalloc(unsigned int size)
     tmp = krhino_mm_alloc(size);
 #endif
 
+    MM_PROF_SITE_SET(tmp);
+
     if (tmp) {		
         memset(tmp, 0, size);
     }
@@ -794,6 +803,8 @@ void *aos_malloc(unsigned int size)
     tmp = krhino_mm_alloc(size);
 #endif
 
+    MM_PROF_SITE_SET(tmp);
+
     return tmp;
 }
 
@@ -820,6 +831,8 @@ void *aos_realloc(void *mem, unsigned int size)
     tmp = krhino_mm_realloc(mem, size);
 #endif
 
+    MM_PROF_SITE_SET(tmp);
+
     return tmp;
 }
 
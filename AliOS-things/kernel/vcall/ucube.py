@@ -21,6 +21,7 @@ else:
             or aos_global_config.board == 'mk3239' or aos_global_config.board == 'mk3166' or aos_global_config.board == 'hobbit1_evb':
         src.append('mico/mico_rhino.c')
     src.append('aos/aos_rhino.c')
+    src.append('aos/aos_mm_prof.c')
 
 component = aos_component('vcall', src)
 component.add_global_includes('mico/include')
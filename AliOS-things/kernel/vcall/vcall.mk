@@ -49,6 +49,7 @@ $(NAME)_SOURCES += mico/mico_rhino.c
 endif
 
 $(NAME)_SOURCES += \
-    aos/aos_rhino.c
+    aos/aos_rhino.c \
+    aos/aos_mm_prof.c
 endif
 
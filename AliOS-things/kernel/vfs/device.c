@@ -16,9 +16,7 @@ static int inited;
 
 typedef struct {
     aos_mutex_t    mutex;
-    poll_notify_t  poll_cb;
-    struct pollfd *fd;
-    void          *poll_data;
+    vfs_poll_wq_t  wq;
     int            counter;
     dlist_t        bufs;
     int            cache_count;
@@ -38,6 +36,7 @@ static int event_open(inode_t *node, file_t *file)
     aos_mutex_new(&pdev->mutex);
     dlist_init(&pdev->bufs);
     dlist_init(&pdev->buf_cache);
+    vfs_poll_wq_init(&pdev->wq);
     file->f_arg = pdev;
     return 0;
 }
@@ -95,10 +94,7 @@ static ssize_t _event_write(file_t *f, const void *buf, size_t len, bool urgent)
         dlist_add_tail(&evt->node, &pdev->bufs);
     }
 
-    if (pdev->poll_cb != NULL) {
-        pdev->fd->revents |= POLLIN;
-        pdev->poll_cb(pdev->fd, pdev->poll_data);
-    }
+    vfs_poll_wq_wake(&pdev->wq, POLLIN);
 out:
     aos_mutex_unlock(&pdev->mutex);
     return ret;
@@ -158,26 +154,18 @@ static int event_poll(file_t *f, bool setup, poll_notify_t notify,
                       struct pollfd *fd, void *opa)
 {
     event_dev_t *pdev = f->f_arg;
+    int ret;
 
     aos_mutex_lock(&pdev->mutex, AOS_WAIT_FOREVER);
-    if (!setup) {
-        pdev->poll_cb = NULL;
-        pdev->poll_data = NULL;
-        goto out;
-    }
+    ret = vfs_poll_wq_setup(&pdev->wq, setup, notify, fd, opa);
 
-    pdev->poll_cb = notify;
-    pdev->fd = fd;
-    pdev->poll_data = opa;
-
-    if (pdev->counter) {
-        pdev->fd->revents |= POLLIN;
+    if (setup && ret == 0 && pdev->counter) {
+        fd->revents |= POLLIN;
         (*notify)(fd, opa);
     }
-out:
     aos_mutex_unlock(&pdev->mutex);
 
-    return 0;
+    return ret;
 }
 
 static file_ops_t event_fops = {
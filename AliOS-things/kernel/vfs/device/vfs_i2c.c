@@ -12,7 +12,9 @@ const struct file_ops i2c_ops =
     .open = vfs_i2c_open,
     .close = vfs_i2c_close,
     .read = vfs_i2c_read,
-    .write = vfs_i2c_write
+    .write = vfs_i2c_write,
+    .readv = vfs_i2c_readv,
+    .writev = vfs_i2c_writev
 };
 
 int vfs_i2c_open(inode_t *inode, file_t *fp)
@@ -150,3 +152,89 @@ ssize_t vfs_i2c_write(file_t *fp, const void *buf, size_t nbytes)
 
     return ret;
 }
+
+ssize_t vfs_i2c_readv(file_t *fp, const aos_iovec_t *iov, int iovcnt)
+{
+    int ret = -1;              /* return value */
+    i2c_dev_t *i2c_dev = NULL; /* device pointer */
+    ssize_t total = 0;         /* bytes read */
+    int i;
+
+    /* check empty pointer. */
+    if ((fp != NULL) && (fp->node != NULL)) {
+
+        /* get the device pointer. */
+        i2c_dev = (i2c_dev_t *)(fp->node->i_arg);
+
+        /* lock the device once for all the buffers. */
+        ret = aos_mutex_lock(&fp->node->mutex, AOS_WAIT_FOREVER);
+        if (ret == 0) {
+
+            /* fill the buffers in turn. */
+            for (i = 0; i < iovcnt; i++) {
+                ret = hal_i2c_master_recv(i2c_dev, i2c_dev->config.dev_addr, (uint8_t *)iov[i].iov_base,
+                                          iov[i].iov_len, HAL_WAIT_FOREVER);
+                if (ret != 0) {
+                    break;
+                }
+
+                total += iov[i].iov_len;
+            }
+
+            /* data read before a failure is still returned. */
+            if (ret == 0 || total > 0) {
+                ret = total;
+            }
+        }
+
+        /* unlock the device. */
+        aos_mutex_unlock(&fp->node->mutex);
+    } else {
+        ret = -EINVAL;
+    }
+
+    return ret;
+}
+
+ssize_t vfs_i2c_writev(file_t *fp, const aos_iovec_t *iov, int iovcnt)
+{
+    int ret = -1;              /* return value */
+    i2c_dev_t *i2c_dev = NULL; /* device pointer */
+    ssize_t total = 0;         /* bytes sent */
+    int i;
+
+    /* check empty pointer. */
+    if ((fp != NULL) && (fp->node != NULL)) {
+
+        /* get the device pointer. */
+        i2c_dev = (i2c_dev_t *)(fp->node->i_arg);
+
+        /* lock the device once, so the buffers go out back to back. */
+        ret = aos_mutex_lock(&fp->node->mutex, AOS_WAIT_FOREVER);
+        if (ret == 0) {
+
+            /* send the buffers in turn. */
+            for (i = 0; i < iovcnt; i++) {
+                ret = hal_i2c_master_send(i2c_dev, i2c_dev->config.dev_addr, (const uint8_t *)iov[i].iov_base,
+                                          iov[i].iov_len, HAL_WAIT_FOREVER);
+                if (ret != 0) {
+                    break;
+                }
+
+                total += iov[i].iov_len;
+            }
+
+            /* data sent before a failure is still returned. */
+            if (ret == 0 || total > 0) {
+                ret = total;
+            }
+        }
+
+        /* unlock the device. */
+        aos_mutex_unlock(&fp->node->mutex);
+    } else {
+        ret = -EINVAL;
+    }
+
+    return ret;
+}
@@ -12,7 +12,9 @@ const struct file_ops spi_ops =
     .open = vfs_spi_open,
     .close = vfs_spi_close,
     .read = vfs_spi_read,
-    .write = vfs_spi_write
+    .write = vfs_spi_write,
+    .readv = vfs_spi_readv,
+    .writev = vfs_spi_writev
 };
 
 int vfs_spi_open(inode_t *inode, file_t *fp)
@@ -142,3 +144,87 @@ ssize_t vfs_spi_write(file_t *fp, const void *buf, size_t nbytes)
 
     return ret;
 }
+
+ssize_t vfs_spi_readv(file_t *fp, const aos_iovec_t *iov, int iovcnt)
+{
+    int ret = -1;              /* return value */
+    spi_dev_t *spi_dev = NULL; /* device pointer */
+    ssize_t total = 0;         /* bytes read */
+    int i;
+
+    /* check empty pointer. */
+    if ((fp != NULL) && (fp->node != NULL)) {
+
+        /* get the device pointer. */
+        spi_dev = (spi_dev_t *)(fp->node->i_arg);
+
+        /* lock the device once for all the buffers. */
+        ret = aos_mutex_lock(&fp->node->mutex, AOS_WAIT_FOREVER);
+        if (ret == 0) {
+
+            /* fill the buffers in turn. */
+            for (i = 0; i < iovcnt; i++) {
+                ret = hal_spi_recv(spi_dev, (uint8_t *)iov[i].iov_base, iov[i].iov_len, HAL_WAIT_FOREVER);
+                if (ret != 0) {
+                    break;
+                }
+
+                total += iov[i].iov_len;
+            }
+
+            /* data read before a failure is still returned. */
+            if (ret == 0 || total > 0) {
+                ret = total;
+            }
+        }
+
+        /* unlock the device. */
+        aos_mutex_unlock(&fp->node->mutex);
+    } else {
+        ret = -EINVAL;
+    }
+
+    return ret;
+}
+
+ssize_t vfs_spi_writev(file_t *fp, const aos_iovec_t *iov, int iovcnt)
+{
+    int ret = -1;              /* return value */
+    spi_dev_t *spi_dev = NULL; /* device pointer */
+    ssize_t total = 0;         /* bytes sent */
+    int i;
+
+    /* check empty pointer. */
+    if ((fp != NULL) && (fp->node != NULL)) {
+
+        /* get the device pointer. */
+        spi_dev = (spi_dev_t *)(fp->node->i_arg);
+
+        /* lock the device once, so the buffers go out back to back. */
+        ret = aos_mutex_lock(&fp->node->mutex, AOS_WAIT_FOREVER);
+        if (ret == 0) {
+
+            /* send the buffers in turn. */
+            for (i = 0; i < iovcnt; i++) {
+                ret = hal_spi_send(spi_dev, (const uint8_t *)iov[i].iov_base, iov[i].iov_len, HAL_WAIT_FOREVER);
+                if (ret != 0) {
+                    break;
+                }
+
+                total += iov[i].iov_len;
+            }
+
+            /* data sent before a failure is still returned. */
+            if (ret == 0 || total > 0) {
+                ret = total;
+            }
+        }
+
+        /* unlock the device. */
+        aos_mutex_unlock(&fp->node->mutex);
+    } else {
+        ret = -EINVAL;
+    }
+
+    return ret;
+}
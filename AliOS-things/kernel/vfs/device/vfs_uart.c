@@ -12,7 +12,9 @@ const struct file_ops uart_ops =
     .open = vfs_uart_open,
     .close = vfs_uart_close,
     .read = vfs_uart_read,
-    .write = vfs_uart_write
+    .write = vfs_uart_write,
+    .readv = vfs_uart_readv,
+    .writev = vfs_uart_writev
 };
 
 int vfs_uart_open(inode_t *inode, file_t *fp)
@@ -142,3 +144,91 @@ ssize_t vfs_uart_write(file_t *fp, const void *buf, size_t nbytes)
 
     return ret;
 }
+
+ssize_t vfs_uart_readv(file_t *fp, const aos_iovec_t *iov, int iovcnt)
+{
+    int ret = -1;                /* return value */
+    uart_dev_t *uart_dev = NULL; /* device pointer */
+    ssize_t total = 0;           /* bytes read */
+    uint32_t recv_bytes = 0;     /* number of bytes received */
+    int i;
+
+    /* check empty pointer. */
+    if ((fp != NULL) && (fp->node != NULL)) {
+
+        /* get the device pointer. */
+        uart_dev = (uart_dev_t *)(fp->node->i_arg);
+
+        /* lock the device once for all the buffers. */
+        ret = aos_mutex_lock(&fp->node->mutex, AOS_WAIT_FOREVER);
+        if (ret == 0) {
+
+            /* fill the buffers in turn, a short one ends the read. */
+            for (i = 0; i < iovcnt; i++) {
+                ret = hal_uart_recv_II(uart_dev, iov[i].iov_base, iov[i].iov_len, &recv_bytes, HAL_WAIT_FOREVER);
+                if (ret != 0) {
+                    break;
+                }
+
+                total += recv_bytes;
+                if (recv_bytes < iov[i].iov_len) {
+                    break;
+                }
+            }
+
+            /* data read before a failure is still returned. */
+            if (ret == 0 || total > 0) {
+                ret = total;
+            }
+        }
+
+        /* unlock the device. */
+        aos_mutex_unlock(&fp->node->mutex);
+    } else {
+        ret = -EINVAL;
+    }
+
+    return ret;
+}
+
+ssize_t vfs_uart_writev(file_t *fp, const aos_iovec_t *iov, int iovcnt)
+{
+    int ret = -1;                /* return value */
+    uart_dev_t *uart_dev = NULL; /* device pointer */
+    ssize_t total = 0;           /* bytes sent */
+    int i;
+
+    /* check empty pointer. */
+    if ((fp != NULL) && (fp->node != NULL)) {
+
+        /* get the device pointer. */
+        uart_dev = (uart_dev_t *)(fp->node->i_arg);
+
+        /* lock the device once, so the buffers go out back to back. */
+        ret = aos_mutex_lock(&fp->node->mutex, AOS_WAIT_FOREVER);
+        if (ret == 0) {
+
+            /* send the buffers in turn. */
+            for (i = 0; i < iovcnt; i++) {
+                ret = hal_uart_send(uart_dev, iov[i].iov_base, iov[i].iov_len, HAL_WAIT_FOREVER);
+                if (ret != 0) {
+                    break;
+                }
+
+                total += iov[i].iov_len;
+            }
+
+            /* data sent before a failure is still returned. */
+            if (ret == 0 || total > 0) {
+                ret = total;
+            }
+        }
+
+        /* unlock the device. */
+        aos_mutex_unlock(&fp->node->mutex);
+    } else {
+        ret = -EINVAL;
+    }
+
+    return ret;
+}
@@ -56,6 +56,32 @@ ssize_t vfs_spi_read(file_t *fp, void *buf, size_t nbytes);
  */
 ssize_t vfs_spi_write(file_t *fp, const void *buf, size_t nbytes);
 
+/**
+ * This function is used to get data from spi into several buffers,
+ * with the device locked once.
+ *
+ * @param[in]   fp      device pointer.
+ * @param[out]  iov     the buffers, filled in turn.
+ * @param[in]   iovcnt  number of buffers.
+ *
+ * @return  The number of bytes read on success, or negative on failure
+ * with errno set appropriately.
+ */
+ssize_t vfs_spi_readv(file_t *fp, const aos_iovec_t *iov, int iovcnt);
+
+/**
+ * This function is used to send several buffers through spi back to
+ * back, with the device locked once.
+ *
+ * @param[in]  fp      device pointer.
+ * @param[in]  iov     the buffers, sent in turn.
+ * @param[in]  iovcnt  number of buffers.
+ *
+ * @return  The number of bytes written on success, or negative on failure
+ * with errno set appropriately.
+ */
+ssize_t vfs_spi_writev(file_t *fp, const aos_iovec_t *iov, int iovcnt);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,27 @@
+/*
+ * Copyright (C) 2015-2017 Alibaba Group Holding Limited
+ */
+
+#ifndef LOOP_DEVICE_H
+#define LOOP_DEVICE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LOOP_DEVICE_PATH  "/dev/loop"
+/* bytes each open of the device buffers, a power of 2 */
+#define LOOP_DEVICE_SIZE  8192
+
+/*
+ * Register LOOP_DEVICE_PATH, a device without hardware behind it: what is
+ * written to an open file is read back from the same file. It has every
+ * optional op and can be polled, so it measures the VFS layer itself.
+ */
+int vfs_loop_device_init(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -11,11 +11,141 @@ extern "C" {
 
 #include <sys/types.h>
 #include <vfs_conf.h>
+#include <vfs_inode.h>
 
 int vfs_init(void);
 
 int vfs_device_init(void);
 
+/* one read of aos_read_many() */
+typedef struct {
+    int     fd;     /* file to read */
+    void   *buf;    /* buffer for the data */
+    size_t  nbytes; /* size of buf */
+    ssize_t ret;    /* set to what aos_read() would return */
+} aos_read_req_t;
+
+/**
+ * Read from fd into several buffers, filling each one before the next.
+ *
+ * @param[in]  fd      the file.
+ * @param[in]  iov     the buffers.
+ * @param[in]  iovcnt  number of buffers.
+ *
+ * @return  bytes read, it stops at the first short read, negative error on failure.
+ */
+ssize_t aos_readv(int fd, const aos_iovec_t *iov, int iovcnt);
+
+/**
+ * Write several buffers to fd in order.
+ *
+ * @param[in]  fd      the file.
+ * @param[in]  iov     the buffers.
+ * @param[in]  iovcnt  number of buffers.
+ *
+ * @return  bytes written, it stops at the first short write, negative error on failure.
+ */
+ssize_t aos_writev(int fd, const aos_iovec_t *iov, int iovcnt);
+
+/**
+ * Run a batch of reads, e.g. one per fd found readable by aos_poll().
+ *
+ * @param[in,out]  reqs   the reads, ret of each one is set.
+ * @param[in]      nreqs  number of reads.
+ *
+ * @return  the number of reads which got data, negative error on failure.
+ */
+int aos_read_many(aos_read_req_t *reqs, int nreqs);
+
+/**
+ * Borrow a buffer of the driver of fd, so data does not have to be
+ * copied. With VFS_BUF_READ it holds received data, with VFS_BUF_WRITE it
+ * is room for data to send. Give it back with aos_put_buf().
+ *
+ * @param[in]   fd      the file.
+ * @param[out]  buf     the buffer.
+ * @param[in]   nbytes  the most bytes wanted.
+ * @param[in]   dir     VFS_BUF_READ or VFS_BUF_WRITE.
+ *
+ * @return  length of buf, 0 if nothing is to read or no room, -ENOSYS if
+ *          the driver lends no buffers, other negative error on failure.
+ */
+ssize_t aos_get_buf(int fd, void **buf, size_t nbytes, int dir);
+
+/**
+ * Give back a buffer of aos_get_buf().
+ *
+ * @param[in]  fd      the file.
+ * @param[in]  buf     the buffer.
+ * @param[in]  nbytes  bytes consumed of it (VFS_BUF_READ) or filled (VFS_BUF_WRITE).
+ * @param[in]  dir     as passed to aos_get_buf().
+ *
+ * @return  0 on success, negative error on failure.
+ */
+int aos_put_buf(int fd, void *buf, size_t nbytes, int dir);
+
+/* events of an epoll set, with the values of Linux */
+#define AOS_EPOLLIN   0x001u
+#define AOS_EPOLLOUT  0x004u
+#define AOS_EPOLLERR  0x008u
+#define AOS_EPOLLHUP  0x010u
+/* report an fd once each time it turns ready, not while it is ready */
+#define AOS_EPOLLET   0x80000000u
+
+/* ops of aos_epoll_ctl() */
+#define AOS_EPOLL_CTL_ADD 1
+#define AOS_EPOLL_CTL_DEL 2
+#define AOS_EPOLL_CTL_MOD 3
+
+typedef union {
+    void    *ptr;
+    int      fd;
+    uint32_t u32;
+} aos_epoll_data_t;
+
+typedef struct {
+    uint32_t         events; /* AOS_EPOLL* */
+    aos_epoll_data_t data;   /* given to aos_epoll_ctl(), returned as is */
+} aos_epoll_event_t;
+
+/**
+ * Create an epoll set: fds are added once, their drivers and sockets then
+ * queue them on the set when they turn ready, so a wait costs the ready
+ * fds only, not every fd watched. Close it with aos_close().
+ *
+ * @return  fd of the set, negative error on failure.
+ */
+int aos_epoll_create(void);
+
+/**
+ * Add, change or remove an fd of an epoll set. VFS fds need a driver with
+ * a poll op, sockets are supported with lwIP, where one socket can be in
+ * one set only. Remove an fd from its sets before closing it.
+ *
+ * @param[in]  epfd   the set.
+ * @param[in]  op     AOS_EPOLL_CTL_ADD, AOS_EPOLL_CTL_MOD or AOS_EPOLL_CTL_DEL.
+ * @param[in]  fd     the fd to watch.
+ * @param[in]  event  events to watch and data to return, unused by DEL.
+ *
+ * @return  0 on success, -EEXIST or -ENOENT if fd is or is not in the set
+ *          yet, -EPERM if fd cannot be watched, -EBUSY if the socket is in
+ *          another set, other negative error on failure.
+ */
+int aos_epoll_ctl(int epfd, int op, int fd, aos_epoll_event_t *event);
+
+/**
+ * Wait for fds of an epoll set to be ready. AOS_EPOLLERR and AOS_EPOLLHUP
+ * are always reported.
+ *
+ * @param[in]   epfd       the set.
+ * @param[out]  events     the ready fds.
+ * @param[in]   maxevents  size of events.
+ * @param[in]   timeout    ms to wait, -1 forever, 0 not at all.
+ *
+ * @return  number of events, 0 on timeout, negative error on failure.
+ */
+int aos_epoll_wait(int epfd, aos_epoll_event_t *events, int maxevents, int timeout);
+
 #ifdef __cplusplus
 }
 #endif
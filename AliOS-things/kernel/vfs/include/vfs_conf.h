@@ -16,6 +16,15 @@ extern "C" {
 #define    AOS_CONFIG_VFS_DEV_MEM      2000
 #define    AOS_CONFIG_VFS_POLL_SUPPORT 1
 #define    AOS_CONFIG_VFS_FD_OFFSET    64
+/* the inode and file tables grow by DEV_NODES and DEV_NODES * 2 entries */
+#define    AOS_CONFIG_VFS_NODE_CHUNKS  8
+#define    AOS_CONFIG_VFS_FILE_CHUNKS  8
+/* power of 2 */
+#define    AOS_CONFIG_VFS_HASH_BUCKETS 32
+/* pollers one file can have at once, see vfs_poll_wq_t */
+#define    AOS_CONFIG_VFS_POLL_WAITERS 4
+/* an epoll set grows by 16 fds, up to this many times */
+#define    AOS_CONFIG_VFS_EPOLL_CHUNKS 32
 
 #ifdef __cplusplus
 }
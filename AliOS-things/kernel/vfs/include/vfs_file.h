@@ -13,6 +13,7 @@ int get_fd(file_t *file);
 
 file_t *get_file(int fd);
 
+/* node comes with a reference taken by inode_get(), del_file() drops it */
 file_t *new_file(inode_t *node);
 
 void del_file(file_t *file);
@@ -9,6 +9,8 @@
 #include <stdint.h>
 #include <sys/stat.h>
 #include <aos/aos.h>
+#include <k_atomic.h>
+#include <vfs_conf.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -40,6 +42,9 @@ enum {
 #define INODE_SET_BLOCK(i) INODE_SET_TYPE(i, VFS_TYPE_BLOCK_DEV)
 #define INODE_SET_FS(i)    INODE_SET_TYPE(i, VFS_TYPE_FS_DEV)
 
+/* refs of an inode being removed, inode_get() no longer returns it */
+#define INODE_REFS_DEAD    0xffffffffu
+
 typedef const struct file_ops file_ops_t;
 typedef const struct fs_ops   fs_ops_t;
 
@@ -50,21 +55,35 @@ union inode_ops_t {
 
 /* this structure represents inode for driver and fs*/
 typedef struct {
-    union inode_ops_t ops;     /* inode operations */
-    void             *i_arg;   /* per inode private data */
-    char             *i_name;  /* name of inode */
-    int               i_flags; /* flags for inode */
-    uint8_t           type;    /* type for inode */
-    uint8_t           refs;    /* refs for inode */
-    aos_mutex_t       mutex;   /* mutex for inode */
+    union inode_ops_t  ops;     /* inode operations */
+    void              *i_arg;   /* per inode private data */
+    char              *i_name;  /* name of inode */
+    int                i_flags; /* flags for inode */
+    uint8_t            type;    /* type for inode */
+    rhino_atomic_idx_t refs;    /* refs for inode */
+    aos_mutex_t        mutex;   /* mutex for inode */
+    uint32_t           i_hash;  /* hash of i_name */
+    rhino_atomic_idx_t i_next;  /* next inode + 1 in hash bucket or free list */
+    rhino_atomic_idx_t i_mnext; /* next mount point + 1, FS_DEV only */
 } inode_t;
 
 typedef struct {
-    inode_t    *node;   /* node for file */
-    void       *f_arg;  /* f_arg for file */
-    size_t      offset; /* offset for file */
+    inode_t           *node;   /* node for file */
+    void              *f_arg;  /* f_arg for file */
+    size_t             offset; /* offset for file */
+    rhino_atomic_idx_t f_next; /* next free file + 1 */
 } file_t;
 
+/* one buffer of a vectored read or write */
+typedef struct {
+    void   *iov_base;
+    size_t  iov_len;
+} aos_iovec_t;
+
+/* direction of a buffer lent by get_buf() */
+#define VFS_BUF_READ   0
+#define VFS_BUF_WRITE  1
+
 struct pollfd;
 typedef void (*poll_notify_t)(struct pollfd *fd, void *arg);
 struct file_ops {
@@ -76,8 +95,42 @@ struct file_ops {
 #ifdef AOS_CONFIG_VFS_POLL_SUPPORT
     int     (*poll)  (file_t *fp, bool flag, poll_notify_t notify, struct pollfd *fd, void *arg);
 #endif
+    /* optional, the VFS loops over read/write without them */
+    ssize_t (*readv) (file_t *fp, const aos_iovec_t *iov, int iovcnt);
+    ssize_t (*writev)(file_t *fp, const aos_iovec_t *iov, int iovcnt);
+    /*
+     * optional, lend a driver buffer holding up to nbytes to read
+     * (VFS_BUF_READ) or to fill (VFS_BUF_WRITE), returns its length.
+     * put_buf() gives it back with the bytes consumed or filled.
+     */
+    ssize_t (*get_buf)(file_t *fp, void **buf, size_t nbytes, int dir);
+    int     (*put_buf)(file_t *fp, void *buf, size_t nbytes, int dir);
 };
 
+#ifdef AOS_CONFIG_VFS_POLL_SUPPORT
+/*
+ * The pollers of a file, for a driver which can be watched by aos_poll()
+ * and by epoll sets at the same time. The driver serialises the calls on
+ * a queue, e.g. with the lock of its data.
+ */
+typedef struct {
+    poll_notify_t  notify;
+    struct pollfd *fd;
+    void          *arg;
+} vfs_poll_waiter_t;
+
+typedef struct {
+    vfs_poll_waiter_t waiters[AOS_CONFIG_VFS_POLL_WAITERS];
+} vfs_poll_wq_t;
+
+void vfs_poll_wq_init(vfs_poll_wq_t *wq);
+/* the poll op on wq: add or drop the waiter of fd and arg, 0 or -ENOMEM */
+int  vfs_poll_wq_setup(vfs_poll_wq_t *wq, bool setup, poll_notify_t notify,
+                       struct pollfd *fd, void *arg);
+/* notify the waiters which asked for one of revents */
+void vfs_poll_wq_wake(vfs_poll_wq_t *wq, short revents);
+#endif
+
 struct fs_ops {
     int             (*open)     (file_t *fp, const char *path, int flags);
     int             (*close)    (file_t *fp);
@@ -93,18 +146,22 @@ struct fs_ops {
     int             (*closedir) (file_t *fp, aos_dir_t *dir);
     int             (*mkdir)    (file_t *fp, const char *path);
     int             (*ioctl)    (file_t *fp, int cmd, unsigned long arg);
+    ssize_t         (*readv)    (file_t *fp, const aos_iovec_t *iov, int iovcnt);
+    ssize_t         (*writev)   (file_t *fp, const aos_iovec_t *iov, int iovcnt);
 };
 
 int     inode_init(void);
 int     inode_alloc(void);
 int     inode_del(inode_t *node);
 inode_t *inode_open(const char *path);
+inode_t *inode_get(const char *path);
 int     inode_ptr_get(int fd, inode_t **node);
 int     inode_avail_count(void);
 void    inode_ref(inode_t *);
 void    inode_unref(inode_t *);
 int     inode_busy(inode_t *);
 int     inode_reserve(const char *path, inode_t **inode);
+void    inode_commit(inode_t *node);
 int     inode_release(const char *path);
 
 #ifdef __cplusplus
@@ -0,0 +1,259 @@
+/*
+ * Copyright (C) 2015-2017 Alibaba Group Holding Limited
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <aos/aos.h>
+#include <aos/network.h>
+
+#include <vfs_conf.h>
+#include <vfs_err.h>
+#include <vfs_register.h>
+#include <loop_device.h>
+
+#define LOOP_MASK (LOOP_DEVICE_SIZE - 1)
+
+/* head and tail run free, head - tail bytes are buffered */
+typedef struct {
+    aos_mutex_t mutex;
+    size_t      head;
+    size_t      tail;
+#if (AOS_CONFIG_VFS_POLL_SUPPORT > 0)
+    vfs_poll_wq_t wq;
+#endif
+    char        buf[LOOP_DEVICE_SIZE];
+} loop_dev_t;
+
+/* data came in or room was made, with pdev->mutex held */
+static void loop_wake(loop_dev_t *pdev, bool in)
+{
+#if (AOS_CONFIG_VFS_POLL_SUPPORT > 0)
+    vfs_poll_wq_wake(&pdev->wq, in ? POLLIN : POLLOUT);
+#endif
+}
+
+static int loop_open(inode_t *node, file_t *file)
+{
+    loop_dev_t *pdev = (loop_dev_t *)aos_malloc(sizeof(*pdev));
+
+    if (pdev == NULL) {
+        return -ENOMEM;
+    }
+
+    if (aos_mutex_new(&pdev->mutex) != 0) {
+        aos_free(pdev);
+        return -ENOMEM;
+    }
+
+    pdev->head  = 0;
+    pdev->tail  = 0;
+#if (AOS_CONFIG_VFS_POLL_SUPPORT > 0)
+    vfs_poll_wq_init(&pdev->wq);
+#endif
+    file->f_arg = pdev;
+
+    return 0;
+}
+
+static int loop_close(file_t *file)
+{
+    loop_dev_t *pdev = file->f_arg;
+
+    aos_mutex_free(&pdev->mutex);
+    aos_free(pdev);
+
+    return 0;
+}
+
+/* copy between buf and the ring from pos on, in at most two pieces */
+static void loop_copy(loop_dev_t *pdev, size_t pos, void *buf, size_t len, bool in)
+{
+    size_t off   = pos & LOOP_MASK;
+    size_t first = LOOP_DEVICE_SIZE - off;
+
+    if (first > len) {
+        first = len;
+    }
+
+    if (in) {
+        memcpy(pdev->buf + off, buf, first);
+        memcpy(pdev->buf, (char *)buf + first, len - first);
+    } else {
+        memcpy(buf, pdev->buf + off, first);
+        memcpy((char *)buf + first, pdev->buf, len - first);
+    }
+}
+
+static ssize_t loop_rw(loop_dev_t *pdev, const aos_iovec_t *iov, int iovcnt, bool in)
+{
+    size_t total = 0;
+    size_t room;
+    size_t len;
+    int    i;
+
+    aos_mutex_lock(&pdev->mutex, AOS_WAIT_FOREVER);
+
+    for (i = 0; i < iovcnt; i++) {
+        room = in ? LOOP_DEVICE_SIZE - (pdev->head - pdev->tail) : pdev->head - pdev->tail;
+        len  = iov[i].iov_len < room ? iov[i].iov_len : room;
+
+        if (in) {
+            loop_copy(pdev, pdev->head, iov[i].iov_base, len, true);
+            pdev->head += len;
+        } else {
+            loop_copy(pdev, pdev->tail, iov[i].iov_base, len, false);
+            pdev->tail += len;
+        }
+
+        total += len;
+
+        if (len < iov[i].iov_len) {
+            break;
+        }
+    }
+
+    if (total > 0) {
+        loop_wake(pdev, in);
+    }
+
+    aos_mutex_unlock(&pdev->mutex);
+
+    return total;
+}
+
+static ssize_t loop_read(file_t *file, void *buf, size_t len)
+{
+    aos_iovec_t iov = { buf, len };
+
+    return loop_rw(file->f_arg, &iov, 1, false);
+}
+
+static ssize_t loop_write(file_t *file, const void *buf, size_t len)
+{
+    aos_iovec_t iov = { (void *)buf, len };
+
+    return loop_rw(file->f_arg, &iov, 1, true);
+}
+
+static ssize_t loop_readv(file_t *file, const aos_iovec_t *iov, int iovcnt)
+{
+    return loop_rw(file->f_arg, iov, iovcnt, false);
+}
+
+static ssize_t loop_writev(file_t *file, const aos_iovec_t *iov, int iovcnt)
+{
+    return loop_rw(file->f_arg, iov, iovcnt, true);
+}
+
+/* lend the contiguous part of the data or of the room, up to the wrap */
+static ssize_t loop_get_buf(file_t *file, void **buf, size_t len, int dir)
+{
+    loop_dev_t *pdev = file->f_arg;
+    size_t      pos;
+    size_t      avail;
+
+    aos_mutex_lock(&pdev->mutex, AOS_WAIT_FOREVER);
+
+    if (dir == VFS_BUF_READ) {
+        pos   = pdev->tail;
+        avail = pdev->head - pdev->tail;
+    } else {
+        pos   = pdev->head;
+        avail = LOOP_DEVICE_SIZE - (pdev->head - pdev->tail);
+    }
+
+    aos_mutex_unlock(&pdev->mutex);
+
+    if (avail > LOOP_DEVICE_SIZE - (pos & LOOP_MASK)) {
+        avail = LOOP_DEVICE_SIZE - (pos & LOOP_MASK);
+    }
+
+    *buf = pdev->buf + (pos & LOOP_MASK);
+
+    return len < avail ? len : avail;
+}
+
+static int loop_put_buf(file_t *file, void *buf, size_t len, int dir)
+{
+    loop_dev_t *pdev = file->f_arg;
+    size_t     *pos;
+    size_t      avail;
+    int         ret = 0;
+
+    aos_mutex_lock(&pdev->mutex, AOS_WAIT_FOREVER);
+
+    if (dir == VFS_BUF_READ) {
+        pos   = &pdev->tail;
+        avail = pdev->head - pdev->tail;
+    } else {
+        pos   = &pdev->head;
+        avail = LOOP_DEVICE_SIZE - (pdev->head - pdev->tail);
+    }
+
+    if (buf != pdev->buf + (*pos & LOOP_MASK) || len > avail ||
+        len > LOOP_DEVICE_SIZE - (*pos & LOOP_MASK)) {
+        ret = -EINVAL;
+    } else if (len > 0) {
+        *pos += len;
+        loop_wake(pdev, dir == VFS_BUF_WRITE);
+    }
+
+    aos_mutex_unlock(&pdev->mutex);
+
+    return ret;
+}
+
+#if (AOS_CONFIG_VFS_POLL_SUPPORT > 0)
+static int loop_poll(file_t *file, bool setup, poll_notify_t notify,
+                     struct pollfd *fd, void *arg)
+{
+    loop_dev_t *pdev = file->f_arg;
+    short       revents;
+    int         ret;
+
+    aos_mutex_lock(&pdev->mutex, AOS_WAIT_FOREVER);
+
+    ret = vfs_poll_wq_setup(&pdev->wq, setup, notify, fd, arg);
+
+    if (setup && ret == 0) {
+        revents = (pdev->head != pdev->tail ? POLLIN : 0) |
+                  (pdev->head - pdev->tail < LOOP_DEVICE_SIZE ? POLLOUT : 0);
+        revents &= fd->events;
+        if (revents != 0) {
+            fd->revents |= revents;
+            (*notify)(fd, arg);
+        }
+    }
+
+    aos_mutex_unlock(&pdev->mutex);
+
+    return ret;
+}
+#endif
+
+static file_ops_t loop_fops = {
+    .open    = loop_open,
+    .close   = loop_close,
+    .read    = loop_read,
+    .write   = loop_write,
+    .readv   = loop_readv,
+    .writev  = loop_writev,
+    .get_buf = loop_get_buf,
+    .put_buf = loop_put_buf,
+#if (AOS_CONFIG_VFS_POLL_SUPPORT > 0)
+    .poll    = loop_poll,
+#endif
+};
+
+int vfs_loop_device_init(void)
+{
+    int ret;
+
+    ret = aos_register_driver(LOOP_DEVICE_PATH, &loop_fops, NULL);
+    if (ret == -EEXIST) {
+        return VFS_SUCCESS;
+    }
+
+    return ret;
+}
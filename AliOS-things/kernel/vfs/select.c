@@ -12,6 +12,7 @@
 #include <limits.h>
 #include <string.h>
 #include <vfs_file.h>
+#include <vfs_register.h>
 
 #ifdef __ICCARM__
 #include <sys/select.h>
@@ -21,6 +22,10 @@
 #include <vfs_trap.h>
 #endif
 
+#ifdef WITH_LWIP
+#include <lwip/sockets.h>
+#endif
+
 extern aos_mutex_t g_vfs_mutex;
 
 #if (AOS_CONFIG_VFS_POLL_SUPPORT>0)
@@ -51,7 +56,7 @@ static void vfs_poll_notify(struct pollfd *fd, void *arg)
     aos_sem_signal(&parg->sem);
 }
 
-static int wait_io(int maxfd, fd_set *rfds, struct poll_arg *parg, int timeout)
+static int wait_io(int maxfd, fd_set *rfds, fd_set *wfds, struct poll_arg *parg, int timeout)
 {
     timeout = timeout >= 0 ? timeout : AOS_WAIT_FOREVER;
     aos_sem_wait(&parg->sem, timeout);
@@ -96,14 +101,15 @@ static void teardown_fd(int fd)
     }
 }
 
-static int wait_io(int maxfd, fd_set *rfds, struct poll_arg *parg, int timeout)
+static int wait_io(int maxfd, fd_set *rfds, fd_set *wfds, struct poll_arg *parg, int timeout)
 {
     struct timeval tv = { 0 };
     int ret;
-    fd_set saved_fds = *rfds;
+    fd_set saved_rfds = *rfds;
+    fd_set saved_wfds = *wfds;
 
     /* check if already data available */
-    ret = select(maxfd + 1, rfds, NULL, NULL, &tv);
+    ret = select(maxfd + 1, rfds, wfds, NULL, &tv);
     if (ret > 0) {
         return ret;
     }
@@ -114,8 +120,9 @@ static int wait_io(int maxfd, fd_set *rfds, struct poll_arg *parg, int timeout)
         return 0;
     }
 
-    *rfds = saved_fds;
-    ret = select(maxfd + 1, rfds, NULL, NULL, &tv);
+    *rfds = saved_rfds;
+    *wfds = saved_wfds;
+    ret = select(maxfd + 1, rfds, wfds, NULL, &tv);
     return ret;
 }
 
@@ -185,7 +192,7 @@ static void deinit_parg(struct poll_arg *parg)
     close(parg->efd);
 }
 
-static int wait_io(int maxfd, fd_set *rfds, struct poll_arg *parg, int timeout)
+static int wait_io(int maxfd, fd_set *rfds, fd_set *wfds, struct poll_arg *parg, int timeout)
 {
     struct timeval tv = {
         .tv_sec  = timeout / 1024,
@@ -194,11 +201,11 @@ static int wait_io(int maxfd, fd_set *rfds, struct poll_arg *parg, int timeout)
 
     FD_SET(parg->efd, rfds);
     maxfd = parg->efd > maxfd ? parg->efd : maxfd;
-    return select(maxfd + 1, rfds, NULL, NULL, timeout >= 0 ? &tv : NULL);
+    return select(maxfd + 1, rfds, wfds, NULL, timeout >= 0 ? &tv : NULL);
 }
 #endif
 
-static int pre_poll(struct pollfd *fds, int nfds, fd_set *rfds, void *parg)
+static int pre_poll(struct pollfd *fds, int nfds, fd_set *rfds, fd_set *wfds, void *parg)
 {
     int i;
     int maxfd = 0;
@@ -215,7 +222,12 @@ static int pre_poll(struct pollfd *fds, int nfds, fd_set *rfds, void *parg)
 
         if (pfd->fd < AOS_CONFIG_VFS_FD_OFFSET) {
             setup_fd(pfd->fd);
-            FD_SET(pfd->fd, rfds);
+            if (pfd->events & POLLIN) {
+                FD_SET(pfd->fd, rfds);
+            }
+            if (pfd->events & POLLOUT) {
+                FD_SET(pfd->fd, wfds);
+            }
             maxfd = pfd->fd > maxfd ? pfd->fd : maxfd;
             continue;
         }
@@ -233,7 +245,7 @@ static int pre_poll(struct pollfd *fds, int nfds, fd_set *rfds, void *parg)
     return maxfd;
 }
 
-static int post_poll(struct pollfd *fds, int nfds)
+static int post_poll(struct pollfd *fds, int nfds, void *parg)
 {
     int j;
     int ret = 0;
@@ -254,7 +266,7 @@ static int post_poll(struct pollfd *fds, int nfds)
             continue;
         }
 
-        (f->node->ops.i_ops->poll)(f, false, NULL, NULL, NULL);
+        (f->node->ops.i_ops->poll)(f, false, NULL, pfd, parg);
 
         if (pfd->revents) {
             ret ++;
@@ -267,6 +279,7 @@ static int post_poll(struct pollfd *fds, int nfds)
 int aos_poll(struct pollfd *fds, int nfds, int timeout)
 {
     fd_set rfds;
+    fd_set wfds;
 
     int ret = VFS_SUCCESS;
     int nset = 0;
@@ -277,13 +290,14 @@ int aos_poll(struct pollfd *fds, int nfds, int timeout)
     }
 
     FD_ZERO(&rfds);
-    ret = pre_poll(fds, nfds, &rfds, &parg);
+    FD_ZERO(&wfds);
+    ret = pre_poll(fds, nfds, &rfds, &wfds, &parg);
 
     if (ret < 0) {
         goto check_poll;
     }
 
-    ret = wait_io(ret, &rfds, &parg, timeout); /* select() */
+    ret = wait_io(ret, &rfds, &wfds, &parg, timeout); /* select() */
 
     if (ret >= 0) {
         int i;
@@ -294,19 +308,597 @@ int aos_poll(struct pollfd *fds, int nfds, int timeout)
             if (FD_ISSET(pfd->fd, &rfds)) {
                 pfd->revents |= POLLIN;
             }
+            if (FD_ISSET(pfd->fd, &wfds)) {
+                pfd->revents |= POLLOUT;
+            }
         }
 
         nset += ret;
     }
 
 check_poll:
-    nset += post_poll(fds, nfds);
+    nset += post_poll(fds, nfds, &parg);
 
     deinit_parg(&parg);
 
     return ret < 0 ? 0 : nset;
 }
 AOS_EXPORT(int, aos_poll, struct pollfd *, int, int);
+
+void vfs_poll_wq_init(vfs_poll_wq_t *wq)
+{
+    memset(wq, 0, sizeof(*wq));
+}
+
+int vfs_poll_wq_setup(vfs_poll_wq_t *wq, bool setup, poll_notify_t notify,
+                      struct pollfd *fd, void *arg)
+{
+    vfs_poll_waiter_t *w;
+    vfs_poll_waiter_t *empty = NULL;
+    int                i;
+
+    for (i = 0; i < AOS_CONFIG_VFS_POLL_WAITERS; i++) {
+        w = &wq->waiters[i];
+        if (w->notify != NULL && w->fd == fd && w->arg == arg) {
+            break;
+        }
+        if (w->notify == NULL && empty == NULL) {
+            empty = w;
+        }
+    }
+
+    if (!setup) {
+        if (i < AOS_CONFIG_VFS_POLL_WAITERS) {
+            memset(w, 0, sizeof(*w));
+        }
+        return 0;
+    }
+
+    if (i == AOS_CONFIG_VFS_POLL_WAITERS) {
+        if (empty == NULL) {
+            return -ENOMEM;
+        }
+        w = empty;
+    }
+
+    w->notify = notify;
+    w->fd     = fd;
+    w->arg    = arg;
+
+    return 0;
+}
+
+void vfs_poll_wq_wake(vfs_poll_wq_t *wq, short revents)
+{
+    vfs_poll_waiter_t *w;
+    short              r;
+    int                i;
+
+    for (i = 0; i < AOS_CONFIG_VFS_POLL_WAITERS; i++) {
+        w = &wq->waiters[i];
+        if (w->notify == NULL) {
+            continue;
+        }
+
+        r = revents & (w->fd->events | POLLERR | POLLHUP);
+        if (r != 0) {
+            w->fd->revents |= r;
+            w->notify(w->fd, w->arg);
+        }
+    }
+}
+
+/*
+ * epoll sets. An fd is armed once by ADD: its driver gets epoll_notify()
+ * through the poll op, an lwIP socket epoll_sock_notify(). Both only OR
+ * the events into the item and push it on the lock-free ready stack of
+ * the set, so they may run in any context a semaphore can be signalled
+ * from, lwIP calls them with its SYS_ARCH protection held.
+ *
+ * Items live in chunks which stay until the set is closed and link each
+ * other by id, index + 1. Only aos_epoll_wait() pops the ready stack, all
+ * of it at once, so no ABA can happen. A removed item may still be on the
+ * stack and is skipped, a level triggered one is armed again by the next
+ * wait, which lets the driver queue it again if it is still ready.
+ */
+#define EPOLL_DEVICE_PATH  "/dev/epoll"
+#define EPOLL_CHUNK        16
+#define EPOLL_BUCKETS      16
+#define EPOLL_QUEUED       0x40000000u
+#define EPOLL_ALWAYS       (AOS_EPOLLERR | AOS_EPOLLHUP)
+
+typedef struct vfs_epoll vfs_epoll_t;
+
+typedef struct {
+    struct pollfd      pfd;     /* handed to the driver, fd is -1 when free */
+    uint32_t           events;  /* AOS_EPOLL* asked for */
+    aos_epoll_data_t   data;
+    file_t            *file;    /* NULL for a socket */
+    vfs_epoll_t       *ep;
+    uint16_t           id;
+    uint16_t           hnext;   /* next in the fd bucket or free list */
+    uint16_t           lnext;   /* next to arm again */
+    uint8_t            rearm;   /* on the list to arm again */
+    rhino_atomic_idx_t revents; /* events seen, EPOLL_QUEUED on the stack */
+    rhino_atomic_idx_t rnext;   /* next on the ready stack or taken list */
+} epoll_item_t;
+
+struct vfs_epoll {
+    aos_mutex_t        mutex;   /* ctl and wait */
+    aos_sem_t          sem;     /* the ready stack was empty and is not */
+    epoll_item_t      *chunks[AOS_CONFIG_VFS_EPOLL_CHUNKS];
+    int                nchunks;
+    uint16_t           free;
+    uint16_t           buckets[EPOLL_BUCKETS];
+    uint16_t           taken;   /* popped from the stack, not reported yet */
+    uint16_t           rearm;   /* reported level triggered items */
+    rhino_atomic_idx_t ready;   /* stack of ready items */
+};
+
+static int g_epoll_registered;
+
+static epoll_item_t *epoll_item_at(vfs_epoll_t *ep, uint32_t id)
+{
+    id--;
+    return &ep->chunks[id / EPOLL_CHUNK][id % EPOLL_CHUNK];
+}
+
+static uint32_t epoll_from_poll(short revents)
+{
+    return ((revents & POLLIN)  ? AOS_EPOLLIN  : 0) |
+           ((revents & POLLOUT) ? AOS_EPOLLOUT : 0) |
+           ((revents & POLLERR) ? AOS_EPOLLERR : 0) |
+           ((revents & POLLHUP) ? AOS_EPOLLHUP : 0);
+}
+
+static short epoll_to_poll(uint32_t events)
+{
+    return ((events & AOS_EPOLLIN)  ? POLLIN  : 0) |
+           ((events & AOS_EPOLLOUT) ? POLLOUT : 0);
+}
+
+static void epoll_item_ready(epoll_item_t *item, uint32_t revents)
+{
+    vfs_epoll_t *ep = item->ep;
+    atomic_val_t old;
+    atomic_val_t head;
+
+    old = rhino_atomic_load_relaxed(&item->revents);
+    while (!rhino_atomic_cas_weak(&item->revents, &old, old | revents | EPOLL_QUEUED));
+
+    if (old & EPOLL_QUEUED) {
+        return;
+    }
+
+    head = rhino_atomic_load_relaxed(&ep->ready);
+    do {
+        rhino_atomic_store_release(&item->rnext, head);
+    } while (!rhino_atomic_cas_weak(&ep->ready, &head, item->id));
+
+    if (head == 0) {
+        aos_sem_signal(&ep->sem);
+    }
+}
+
+static void epoll_notify(struct pollfd *fd, void *arg)
+{
+    uint32_t revents = epoll_from_poll(fd->revents);
+
+    fd->revents = 0;
+    if (revents != 0) {
+        epoll_item_ready(arg, revents);
+    }
+}
+
+#ifdef WITH_LWIP
+static void epoll_sock_notify(int s, int evt, void *arg)
+{
+    epoll_item_ready(arg, ((evt & LWIP_SOCK_EVT_RCV)  ? AOS_EPOLLIN  : 0) |
+                          ((evt & LWIP_SOCK_EVT_SEND) ? AOS_EPOLLOUT : 0) |
+                          ((evt & LWIP_SOCK_EVT_ERR)  ? AOS_EPOLLERR : 0));
+}
+#endif
+
+static int epoll_arm(epoll_item_t *item)
+{
+    file_t *f;
+
+    if (item->pfd.fd < AOS_CONFIG_VFS_FD_OFFSET) {
+#ifdef WITH_LWIP
+        /* -EBUSY if another epoll set watches the socket */
+        return lwip_sock_notify(item->pfd.fd, epoll_sock_notify, item);
+#else
+        return -EPERM;
+#endif
+    }
+
+    f = get_file(item->pfd.fd);
+    if (f == NULL) {
+        return -EBADF;
+    }
+
+    if (INODE_IS_FS(f->node) || f->node->ops.i_ops->poll == NULL) {
+        return -EPERM;
+    }
+
+    item->file = f;
+    return (f->node->ops.i_ops->poll)(f, true, epoll_notify, &item->pfd, item);
+}
+
+static void epoll_disarm(epoll_item_t *item)
+{
+    file_t *f;
+
+    if (item->file == NULL) {
+#ifdef WITH_LWIP
+        lwip_sock_notify(item->pfd.fd, NULL, item);
+#endif
+        return;
+    }
+
+    /* skip an fd closed meanwhile, its driver dropped the waiter then */
+    f = get_file(item->pfd.fd);
+    if (f == item->file) {
+        (f->node->ops.i_ops->poll)(f, false, NULL, &item->pfd, item);
+    }
+}
+
+static uint16_t *epoll_bucket(vfs_epoll_t *ep, int fd)
+{
+    return &ep->buckets[(unsigned int)fd % EPOLL_BUCKETS];
+}
+
+static epoll_item_t *epoll_find(vfs_epoll_t *ep, int fd)
+{
+    epoll_item_t *item;
+    uint16_t      id;
+
+    for (id = *epoll_bucket(ep, fd); id != 0; id = item->hnext) {
+        item = epoll_item_at(ep, id);
+        if (item->pfd.fd == fd) {
+            return item;
+        }
+    }
+
+    return NULL;
+}
+
+static epoll_item_t *epoll_alloc(vfs_epoll_t *ep)
+{
+    epoll_item_t *chunk;
+    epoll_item_t *item;
+    int           i;
+
+    if (ep->free == 0) {
+        if (ep->nchunks == AOS_CONFIG_VFS_EPOLL_CHUNKS) {
+            return NULL;
+        }
+
+        chunk = (epoll_item_t *)aos_zalloc(sizeof(epoll_item_t) * EPOLL_CHUNK);
+        if (chunk == NULL) {
+            return NULL;
+        }
+
+        for (i = EPOLL_CHUNK - 1; i >= 0; i--) {
+            chunk[i].pfd.fd = -1;
+            chunk[i].ep     = ep;
+            chunk[i].id     = ep->nchunks * EPOLL_CHUNK + i + 1;
+            chunk[i].hnext  = ep->free;
+            rhino_atomic_idx_init(&chunk[i].revents, 0);
+            rhino_atomic_idx_init(&chunk[i].rnext, 0);
+            ep->free = chunk[i].id;
+        }
+
+        ep->chunks[ep->nchunks++] = chunk;
+    }
+
+    item = epoll_item_at(ep, ep->free);
+    ep->free = item->hnext;
+
+    return item;
+}
+
+static void epoll_free(vfs_epoll_t *ep, epoll_item_t *item)
+{
+    /* revents, rnext and rearm stay, the item may still be queued */
+    item->pfd.fd = -1;
+    item->file   = NULL;
+    item->hnext  = ep->free;
+    ep->free     = item->id;
+}
+
+static void epoll_unlink(vfs_epoll_t *ep, epoll_item_t *item)
+{
+    uint16_t *link = epoll_bucket(ep, item->pfd.fd);
+
+    while (*link != item->id) {
+        link = &epoll_item_at(ep, *link)->hnext;
+    }
+
+    *link = item->hnext;
+}
+
+static int epoll_open(inode_t *node, file_t *file)
+{
+    vfs_epoll_t *ep = (vfs_epoll_t *)aos_zalloc(sizeof(*ep));
+
+    if (ep == NULL) {
+        return -ENOMEM;
+    }
+
+    if (aos_mutex_new(&ep->mutex) != 0) {
+        aos_free(ep);
+        return -ENOMEM;
+    }
+
+    if (aos_sem_new(&ep->sem, 0) != 0) {
+        aos_mutex_free(&ep->mutex);
+        aos_free(ep);
+        return -ENOMEM;
+    }
+
+    rhino_atomic_idx_init(&ep->ready, 0);
+    file->f_arg = ep;
+
+    return 0;
+}
+
+static int epoll_close(file_t *file)
+{
+    vfs_epoll_t  *ep = file->f_arg;
+    epoll_item_t *item;
+    int           c;
+    int           i;
+
+    for (c = 0; c < ep->nchunks; c++) {
+        for (i = 0; i < EPOLL_CHUNK; i++) {
+            item = &ep->chunks[c][i];
+            if (item->pfd.fd >= 0) {
+                epoll_disarm(item);
+            }
+        }
+    }
+
+    for (c = 0; c < ep->nchunks; c++) {
+        aos_free(ep->chunks[c]);
+    }
+
+    aos_sem_free(&ep->sem);
+    aos_mutex_free(&ep->mutex);
+    aos_free(ep);
+
+    return 0;
+}
+
+static file_ops_t epoll_fops = {
+    .open  = epoll_open,
+    .close = epoll_close,
+};
+
+static vfs_epoll_t *epoll_get(int epfd)
+{
+    file_t *f = get_file(epfd);
+
+    if (f == NULL || f->node->ops.i_ops != &epoll_fops) {
+        return NULL;
+    }
+
+    return f->f_arg;
+}
+
+int aos_epoll_create(void)
+{
+    int ret;
+
+    if (!g_epoll_registered) {
+        ret = aos_register_driver(EPOLL_DEVICE_PATH, &epoll_fops, NULL);
+        if (ret != VFS_SUCCESS && ret != -EEXIST) {
+            return ret;
+        }
+        g_epoll_registered = 1;
+    }
+
+    return aos_open(EPOLL_DEVICE_PATH, 0);
+}
+AOS_EXPORT(int, aos_epoll_create, void);
+
+int aos_epoll_ctl(int epfd, int op, int fd, aos_epoll_event_t *event)
+{
+    vfs_epoll_t  *ep = epoll_get(epfd);
+    epoll_item_t *item;
+    int           ret = 0;
+
+    if (ep == NULL) {
+        return -EBADF;
+    }
+
+    if (fd < 0 || fd == epfd || (op != AOS_EPOLL_CTL_DEL && event == NULL)) {
+        return -EINVAL;
+    }
+
+    if (aos_mutex_lock(&ep->mutex, AOS_WAIT_FOREVER) != 0) {
+        return -EIO;
+    }
+
+    item = epoll_find(ep, fd);
+
+    switch (op) {
+        case AOS_EPOLL_CTL_ADD:
+            if (item != NULL) {
+                ret = -EEXIST;
+                break;
+            }
+
+            item = epoll_alloc(ep);
+            if (item == NULL) {
+                ret = -ENOMEM;
+                break;
+            }
+
+            item->pfd.fd     = fd;
+            item->pfd.events = epoll_to_poll(event->events);
+            item->events     = event->events;
+            item->data       = event->data;
+
+            ret = epoll_arm(item);
+            if (ret != 0) {
+                epoll_free(ep, item);
+                break;
+            }
+
+            item->hnext = *epoll_bucket(ep, fd);
+            *epoll_bucket(ep, fd) = item->id;
+            break;
+
+        case AOS_EPOLL_CTL_MOD:
+            if (item == NULL) {
+                ret = -ENOENT;
+                break;
+            }
+
+            item->pfd.events = epoll_to_poll(event->events);
+            item->events     = event->events;
+            item->data       = event->data;
+            ret = epoll_arm(item);
+            break;
+
+        case AOS_EPOLL_CTL_DEL:
+            if (item == NULL) {
+                ret = -ENOENT;
+                break;
+            }
+
+            epoll_disarm(item);
+            epoll_unlink(ep, item);
+            epoll_free(ep, item);
+            break;
+
+        default:
+            ret = -EINVAL;
+            break;
+    }
+
+    aos_mutex_unlock(&ep->mutex);
+
+    return ret;
+}
+AOS_EXPORT(int, aos_epoll_ctl, int, int, int, aos_epoll_event_t *);
+
+/* arm the level triggered items reported last time, the ready ones queue again */
+static void epoll_rearm(vfs_epoll_t *ep)
+{
+    epoll_item_t *item;
+    uint16_t      id;
+
+    for (id = ep->rearm; id != 0; id = item->lnext) {
+        item = epoll_item_at(ep, id);
+        item->rearm = 0;
+        if (item->pfd.fd >= 0 && !(item->events & AOS_EPOLLET)) {
+            epoll_arm(item);
+        }
+    }
+
+    ep->rearm = 0;
+}
+
+static int epoll_collect(vfs_epoll_t *ep, aos_epoll_event_t *events, int maxevents)
+{
+    epoll_item_t *item;
+    atomic_val_t  head;
+    uint32_t      revents;
+    uint32_t      id;
+    int           n = 0;
+
+    while (n < maxevents) {
+        if (ep->taken == 0) {
+            head = rhino_atomic_load_acquire(&ep->ready);
+            if (head == 0) {
+                break;
+            }
+            while (!rhino_atomic_cas_weak(&ep->ready, &head, 0));
+
+            /* the stack is newest first, report in arrival order */
+            for (id = head; id != 0; id = head) {
+                item = epoll_item_at(ep, id);
+                head = rhino_atomic_load_acquire(&item->rnext);
+                rhino_atomic_store_release(&item->rnext, ep->taken);
+                ep->taken = id;
+            }
+        }
+
+        item = epoll_item_at(ep, ep->taken);
+        ep->taken = rhino_atomic_load_relaxed(&item->rnext);
+
+        /* a notify from now on queues the item again */
+        revents = rhino_atomic_load_relaxed(&item->revents);
+        while (!rhino_atomic_cas_weak(&item->revents, &revents, 0));
+
+        if (item->pfd.fd < 0) {
+            continue;
+        }
+
+        revents &= item->events | EPOLL_ALWAYS;
+        if (revents == 0) {
+            continue;
+        }
+
+        events[n].events = revents;
+        events[n].data   = item->data;
+        n++;
+
+        if (!(item->events & AOS_EPOLLET) && !item->rearm) {
+            item->rearm = 1;
+            item->lnext = ep->rearm;
+            ep->rearm   = item->id;
+        }
+    }
+
+    return n;
+}
+
+int aos_epoll_wait(int epfd, aos_epoll_event_t *events, int maxevents, int timeout)
+{
+    vfs_epoll_t *ep = epoll_get(epfd);
+    long long    deadline = aos_now_ms() + (timeout > 0 ? timeout : 0);
+    long long    left;
+    int          n;
+
+    if (ep == NULL) {
+        return -EBADF;
+    }
+
+    if (events == NULL || maxevents <= 0) {
+        return -EINVAL;
+    }
+
+    if (aos_mutex_lock(&ep->mutex, AOS_WAIT_FOREVER) != 0) {
+        return -EIO;
+    }
+
+    epoll_rearm(ep);
+
+    for (;;) {
+        n = epoll_collect(ep, events, maxevents);
+        if (n > 0 || timeout == 0) {
+            break;
+        }
+
+        left = timeout < 0 ? AOS_WAIT_FOREVER : deadline - aos_now_ms();
+        if (left <= 0) {
+            break;
+        }
+
+        aos_mutex_unlock(&ep->mutex);
+        /* may return early for items taken by the last collect, then it loops */
+        aos_sem_wait(&ep->sem, (unsigned int)left);
+        aos_mutex_lock(&ep->mutex, AOS_WAIT_FOREVER);
+    }
+
+    aos_mutex_unlock(&ep->mutex);
+
+    return n;
+}
+AOS_EXPORT(int, aos_epoll_wait, int, aos_epoll_event_t *, int, int);
 #endif
 
 int aos_fcntl(int fd, int cmd, int val)
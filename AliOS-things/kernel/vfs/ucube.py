@@ -2,6 +2,7 @@ src     = Split('''
         vfs.c
         select.c
         device.c
+        loop_device.c
         vfs_file.c
         vfs_inode.c
         vfs_register.c
@@ -14,3 +15,7 @@ if aos_global_config.ide != 'keil':
 component.add_global_includes('include')
 
 component.add_global_macros('AOS_VFS')
+
+if aos_global_config.get('aos_bench') == '1':
+    component.add_sources('vfs_bench.c')
+    component.add_global_macros('CONFIG_AOS_BENCH')
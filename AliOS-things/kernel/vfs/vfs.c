@@ -59,15 +59,9 @@ int aos_open(const char *path, int flags)
         return -ENAMETOOLONG;
     }
 
-    if ((ret = aos_mutex_lock(&g_vfs_mutex, AOS_WAIT_FOREVER)) != 0) {
-        return ret;
-    }
-
-    node = inode_open(path);
+    node = inode_get(path);
 
     if (node == NULL) {
-        aos_mutex_unlock(&g_vfs_mutex);
-
         #ifdef IO_NEED_TRAP
             return trap_open(path, flags);
         #else
@@ -78,9 +72,8 @@ int aos_open(const char *path, int flags)
     node->i_flags = flags;
     file = new_file(node);
 
-    aos_mutex_unlock(&g_vfs_mutex);
-
     if (file == NULL) {
+        inode_unref(node);
         return -ENFILE;
     }
 
@@ -134,14 +127,8 @@ int aos_close(int fd)
         }
     }
 
-    if ((ret = aos_mutex_lock(&g_vfs_mutex, AOS_WAIT_FOREVER)) != 0) {
-        return ret;
-    }
-
     del_file(f);
 
-    aos_mutex_unlock(&g_vfs_mutex);
-
     return ret;
 }
 AOS_EXPORT(int, aos_close, int);
@@ -210,6 +197,189 @@ ssize_t aos_write(int fd, const void *buf, size_t nbytes)
 }
 AOS_EXPORT(ssize_t, aos_write, int, const void *, size_t);
 
+/* readv/writev of a node without them, one read or write per buffer */
+static ssize_t vfs_iov_loop(int fd, const aos_iovec_t *iov, int iovcnt, bool write)
+{
+    ssize_t total = 0;
+    ssize_t n;
+    int     i;
+
+    for (i = 0; i < iovcnt; i++) {
+        if (write) {
+            n = aos_write(fd, iov[i].iov_base, iov[i].iov_len);
+        } else {
+            n = aos_read(fd, iov[i].iov_base, iov[i].iov_len);
+        }
+
+        if (n < 0) {
+            return total > 0 ? total : n;
+        }
+
+        total += n;
+
+        if ((size_t)n < iov[i].iov_len) {
+            break;
+        }
+    }
+
+    return total;
+}
+
+ssize_t aos_readv(int fd, const aos_iovec_t *iov, int iovcnt)
+{
+    file_t  *f;
+    inode_t *node;
+
+    if (iov == NULL || iovcnt < 0) {
+        return -EINVAL;
+    }
+
+    f = get_file(fd);
+
+    if (f != NULL) {
+        node = f->node;
+
+        if (INODE_IS_FS(node)) {
+            if ((node->ops.i_fops->readv) != NULL) {
+                return (node->ops.i_fops->readv)(f, iov, iovcnt);
+            }
+        } else {
+            if ((node->ops.i_ops->readv) != NULL) {
+                return (node->ops.i_ops->readv)(f, iov, iovcnt);
+            }
+        }
+    }
+
+    return vfs_iov_loop(fd, iov, iovcnt, false);
+}
+AOS_EXPORT(ssize_t, aos_readv, int, const aos_iovec_t *, int);
+
+ssize_t aos_writev(int fd, const aos_iovec_t *iov, int iovcnt)
+{
+    file_t  *f;
+    inode_t *node;
+
+    if (iov == NULL || iovcnt < 0) {
+        return -EINVAL;
+    }
+
+    f = get_file(fd);
+
+    if (f != NULL) {
+        node = f->node;
+
+        if (INODE_IS_FS(node)) {
+            if ((node->ops.i_fops->writev) != NULL) {
+                return (node->ops.i_fops->writev)(f, iov, iovcnt);
+            }
+        } else {
+            if ((node->ops.i_ops->writev) != NULL) {
+                return (node->ops.i_ops->writev)(f, iov, iovcnt);
+            }
+        }
+    }
+
+    return vfs_iov_loop(fd, iov, iovcnt, true);
+}
+AOS_EXPORT(ssize_t, aos_writev, int, const aos_iovec_t *, int);
+
+int aos_read_many(aos_read_req_t *reqs, int nreqs)
+{
+    file_t  *f = NULL;
+    inode_t *node;
+    int      fd = -1;
+    int      ready = 0;
+    int      i;
+
+    if (reqs == NULL || nreqs < 0) {
+        return -EINVAL;
+    }
+
+    for (i = 0; i < nreqs; i++) {
+        aos_read_req_t *req = &reqs[i];
+
+        /* requests on the same fd usually follow each other */
+        if (req->fd != fd || f == NULL) {
+            fd = req->fd;
+            f  = get_file(fd);
+        }
+
+        if (f == NULL) {
+            req->ret = aos_read(req->fd, req->buf, req->nbytes);
+        } else {
+            node     = f->node;
+            req->ret = -1;
+
+            if (INODE_IS_FS(node)) {
+                if ((node->ops.i_fops->read) != NULL) {
+                    req->ret = (node->ops.i_fops->read)(f, req->buf, req->nbytes);
+                }
+            } else {
+                if ((node->ops.i_ops->read) != NULL) {
+                    req->ret = (node->ops.i_ops->read)(f, req->buf, req->nbytes);
+                }
+            }
+        }
+
+        if (req->ret > 0) {
+            ready++;
+        }
+    }
+
+    return ready;
+}
+AOS_EXPORT(int, aos_read_many, aos_read_req_t *, int);
+
+ssize_t aos_get_buf(int fd, void **buf, size_t nbytes, int dir)
+{
+    file_t  *f;
+    inode_t *node;
+
+    if (buf == NULL || (dir != VFS_BUF_READ && dir != VFS_BUF_WRITE)) {
+        return -EINVAL;
+    }
+
+    f = get_file(fd);
+
+    if (f == NULL) {
+        return -ENOENT;
+    }
+
+    node = f->node;
+
+    if (INODE_IS_FS(node) || (node->ops.i_ops->get_buf) == NULL) {
+        return -ENOSYS;
+    }
+
+    return (node->ops.i_ops->get_buf)(f, buf, nbytes, dir);
+}
+AOS_EXPORT(ssize_t, aos_get_buf, int, void **, size_t, int);
+
+int aos_put_buf(int fd, void *buf, size_t nbytes, int dir)
+{
+    file_t  *f;
+    inode_t *node;
+
+    if (buf == NULL || (dir != VFS_BUF_READ && dir != VFS_BUF_WRITE)) {
+        return -EINVAL;
+    }
+
+    f = get_file(fd);
+
+    if (f == NULL) {
+        return -ENOENT;
+    }
+
+    node = f->node;
+
+    if (INODE_IS_FS(node) || (node->ops.i_ops->put_buf) == NULL) {
+        return -ENOSYS;
+    }
+
+    return (node->ops.i_ops->put_buf)(f, buf, nbytes, dir);
+}
+AOS_EXPORT(int, aos_put_buf, int, void *, size_t, int);
+
 int aos_ioctl(int fd, int cmd, unsigned long arg)
 {
     int ret = -ENOSYS;
@@ -294,28 +464,22 @@ int aos_stat(const char *path, struct stat *st)
 {
     file_t  *file;
     inode_t *node;
-    int err, ret = -ENOSYS;
+    int ret = -ENOSYS;
 
     if (path == NULL) {
         return -EINVAL;
     }
 
-    if ((err = aos_mutex_lock(&g_vfs_mutex, AOS_WAIT_FOREVER)) != 0) {
-        return err;
-    }
-
-    node = inode_open(path);
+    node = inode_get(path);
 
     if (node == NULL) {
-        aos_mutex_unlock(&g_vfs_mutex);
         return -ENODEV;
     }
 
     file = new_file(node);
 
-    aos_mutex_unlock(&g_vfs_mutex);
-
     if (file == NULL) {
+        inode_unref(node);
         return -ENOENT;
     }
 
@@ -325,13 +489,7 @@ int aos_stat(const char *path, struct stat *st)
         }
     }
 
-    if ((err = aos_mutex_lock(&g_vfs_mutex, AOS_WAIT_FOREVER)) != 0) {
-        return err;
-    }
-
     del_file(file);
-
-    aos_mutex_unlock(&g_vfs_mutex);
     return ret;
 }
 AOS_EXPORT(int, aos_stat, const char *, struct stat *);
@@ -340,28 +498,22 @@ int aos_unlink(const char *path)
 {
     file_t  *f;
     inode_t *node;
-    int err, ret = -ENOSYS;
+    int ret = -ENOSYS;
 
     if (path == NULL) {
         return -EINVAL;
     }
 
-    if ((err = aos_mutex_lock(&g_vfs_mutex, AOS_WAIT_FOREVER)) != 0) {
-        return err;
-    }
-
-    node = inode_open(path);
+    node = inode_get(path);
 
     if (node == NULL) {
-        aos_mutex_unlock(&g_vfs_mutex);
         return -ENODEV;
     }
 
     f = new_file(node);
 
-    aos_mutex_unlock(&g_vfs_mutex);
-
     if (f == NULL) {
+        inode_unref(node);
         return -ENOENT;
     }
 
@@ -371,13 +523,7 @@ int aos_unlink(const char *path)
         }
     }
 
-    if ((err = aos_mutex_lock(&g_vfs_mutex, AOS_WAIT_FOREVER)) != 0) {
-        return err;
-    }
-
     del_file(f);
-
-    aos_mutex_unlock(&g_vfs_mutex);
     return ret;
 }
 AOS_EXPORT(int, aos_unlink, const char *);
@@ -386,28 +532,22 @@ int aos_rename(const char *oldpath, const char *newpath)
 {
     file_t  *f;
     inode_t *node;
-    int err, ret = -ENOSYS;
+    int ret = -ENOSYS;
 
     if (oldpath == NULL || newpath == NULL) {
         return -EINVAL;
     }
 
-    if ((err = aos_mutex_lock(&g_vfs_mutex, AOS_WAIT_FOREVER)) != 0) {
-        return err;
-    }
-
-    node = inode_open(oldpath);
+    node = inode_get(oldpath);
 
     if (node == NULL) {
-        aos_mutex_unlock(&g_vfs_mutex);
         return -ENODEV;
     }
 
     f = new_file(node);
 
-    aos_mutex_unlock(&g_vfs_mutex);
-
     if (f == NULL) {
+        inode_unref(node);
         return -ENOENT;
     }
 
@@ -417,13 +557,7 @@ int aos_rename(const char *oldpath, const char *newpath)
         }
     }
 
-    if ((err = aos_mutex_lock(&g_vfs_mutex, AOS_WAIT_FOREVER)) != 0) {
-        return err;
-    }
-
     del_file(f);
-
-    aos_mutex_unlock(&g_vfs_mutex);
     return ret;
 }
 AOS_EXPORT(int, aos_rename, const char *, const char *);
@@ -438,22 +572,16 @@ aos_dir_t *aos_opendir(const char *path)
         return NULL;
     }
 
-    if (aos_mutex_lock(&g_vfs_mutex, AOS_WAIT_FOREVER) != 0) {
-        return NULL;
-    }
-
-    node = inode_open(path);
+    node = inode_get(path);
 
     if (node == NULL) {
-        aos_mutex_unlock(&g_vfs_mutex);
         return NULL;
     }
 
     file = new_file(node);
 
-    aos_mutex_unlock(&g_vfs_mutex);
-
     if (file == NULL) {
+        inode_unref(node);
         return NULL;
     }
 
@@ -464,13 +592,7 @@ aos_dir_t *aos_opendir(const char *path)
     }
 
     if (dp == NULL) {
-        if (aos_mutex_lock(&g_vfs_mutex, AOS_WAIT_FOREVER) != 0) {
-            return NULL;
-        }
-
         del_file(file);
-
-        aos_mutex_unlock(&g_vfs_mutex);
         return NULL;
     }
 
@@ -483,7 +605,7 @@ int aos_closedir(aos_dir_t *dir)
 {
     file_t  *f;
     inode_t *node;
-    int err, ret = -ENOSYS;
+    int ret = -ENOSYS;
 
     if (dir == NULL) {
         return -EINVAL;
@@ -503,14 +625,8 @@ int aos_closedir(aos_dir_t *dir)
         }
     }
 
-    if ((err = aos_mutex_lock(&g_vfs_mutex, AOS_WAIT_FOREVER)) != 0) {
-        return err;
-    }
-
     del_file(f);
 
-    aos_mutex_unlock(&g_vfs_mutex);
-
     return ret;
 }
 AOS_EXPORT(int, aos_closedir, aos_dir_t *);
@@ -550,28 +666,22 @@ int aos_mkdir(const char *path)
 {
     file_t  *file;
     inode_t *node;
-    int err, ret = -ENOSYS;
+    int ret = -ENOSYS;
 
     if (path == NULL) {
         return -EINVAL;
     }
 
-    if ((err = aos_mutex_lock(&g_vfs_mutex, AOS_WAIT_FOREVER)) != 0) {
-        return err;
-    }
-
-    node = inode_open(path);
+    node = inode_get(path);
 
     if (node == NULL) {
-        aos_mutex_unlock(&g_vfs_mutex);
         return -ENODEV;
     }
 
     file = new_file(node);
 
-    aos_mutex_unlock(&g_vfs_mutex);
-
     if (file == NULL) {
+        inode_unref(node);
         return -ENOENT;
     }
 
@@ -581,13 +691,7 @@ int aos_mkdir(const char *path)
         }
     }
 
-    if ((err = aos_mutex_lock(&g_vfs_mutex, AOS_WAIT_FOREVER)) != 0) {
-        return err;
-    }
-
     del_file(file);
-
-    aos_mutex_unlock(&g_vfs_mutex);
     return ret;
 }
 AOS_EXPORT(int, aos_mkdir, const char *);
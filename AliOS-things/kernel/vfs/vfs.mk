@@ -6,10 +6,17 @@ $(NAME)_MBINS_TYPE  := kernel
 $(NAME)_SOURCES     := vfs.c
 $(NAME)_SOURCES     += select.c
 $(NAME)_SOURCES     += device.c
+$(NAME)_SOURCES     += loop_device.c
 $(NAME)_SOURCES     += vfs_file.c
 $(NAME)_SOURCES     += vfs_inode.c
 $(NAME)_SOURCES     += vfs_register.c
 
+# "aos_bench=1" on the make line adds the benchmark cli commands
+ifeq ($(aos_bench),1)
+$(NAME)_SOURCES     += vfs_bench.c
+GLOBAL_DEFINES      += CONFIG_AOS_BENCH
+endif
+
 ifeq ($(HOST_ARCH),linux)
 $(NAME)_DEFINES     += IO_NEED_TRAP
 endif
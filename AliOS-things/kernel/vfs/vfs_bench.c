@@ -0,0 +1,330 @@
+/*
+ * Copyright (C) 2015-2017 Alibaba Group Holding Limited
+ */
+
+#include <string.h>
+#include <aos/aos.h>
+#include <aos/network.h>
+
+#include <vfs_conf.h>
+#include <vfs_err.h>
+#include <vfs.h>
+#include <loop_device.h>
+
+#ifdef CONFIG_AOS_CLI
+/*
+ * "vfs_bench": throughput of the VFS layer over the loop device, moving
+ * data through it for VBENCH_MS in chunks of 64/512/4096 bytes with a
+ * write and a read back per chunk, either by aos_write()/aos_read(), by 4
+ * element aos_writev()/aos_readv() or in place through aos_get_buf() and
+ * aos_put_buf(). Then the cost of finding the one ready fd out of 1/8/32
+ * by aos_poll() and by aos_epoll_wait().
+ */
+#define VBENCH_MS     500
+#define VBENCH_BATCH  256
+#define VBENCH_IOV    4
+#define VBENCH_FDS    8
+#define VBENCH_WAITS  32
+
+enum {
+    VBENCH_COPY,
+    VBENCH_IOVEC,
+    VBENCH_LENT,
+};
+
+static const char *const g_vbench_name[] = { "copy", "iovec", "lent" };
+
+static char g_vbench_buf[2][4096];
+
+static int vbench_lent(int fd, size_t len, int dir)
+{
+    void   *buf;
+    ssize_t n;
+
+    /* the loop device lends up to its wrap, at most two rounds */
+    while (len > 0) {
+        n = aos_get_buf(fd, &buf, len, dir);
+        if (n <= 0) {
+            return -1;
+        }
+
+        if (aos_put_buf(fd, buf, n, dir) != 0) {
+            return -1;
+        }
+
+        len -= n;
+    }
+
+    return 0;
+}
+
+static int vbench_chunk(int fd, int mode, size_t len)
+{
+    aos_iovec_t iov[VBENCH_IOV];
+    size_t      piece = len / VBENCH_IOV;
+    int         i;
+
+    switch (mode) {
+        case VBENCH_COPY:
+            if (aos_write(fd, g_vbench_buf[0], len) != len ||
+                aos_read(fd, g_vbench_buf[1], len) != len) {
+                return -1;
+            }
+            break;
+
+        case VBENCH_IOVEC:
+            for (i = 0; i < VBENCH_IOV; i++) {
+                iov[i].iov_base = g_vbench_buf[0] + i * piece;
+                iov[i].iov_len  = piece;
+            }
+            if (aos_writev(fd, iov, VBENCH_IOV) != len) {
+                return -1;
+            }
+
+            for (i = 0; i < VBENCH_IOV; i++) {
+                iov[i].iov_base = g_vbench_buf[1] + i * piece;
+            }
+            if (aos_readv(fd, iov, VBENCH_IOV) != len) {
+                return -1;
+            }
+            break;
+
+        default:
+            if (vbench_lent(fd, len, VFS_BUF_WRITE) != 0 ||
+                vbench_lent(fd, len, VFS_BUF_READ) != 0) {
+                return -1;
+            }
+            break;
+    }
+
+    return 0;
+}
+
+static void vbench_run(int fd, int mode, size_t len)
+{
+    long long start;
+    long long ms;
+    long long bytes = 0;
+    int       i;
+
+    start = aos_now_ms();
+    do {
+        for (i = 0; i < VBENCH_BATCH; i++) {
+            if (vbench_chunk(fd, mode, len) != 0) {
+                aos_cli_printf("vfs_bench: %s failed\r\n", g_vbench_name[mode]);
+                return;
+            }
+        }
+        bytes += VBENCH_BATCH * len;
+        ms = aos_now_ms() - start;
+    } while (ms < VBENCH_MS);
+
+    aos_cli_printf("%-6s %4d B: %8d KB/s\r\n", g_vbench_name[mode], (int)len,
+                   (int)(bytes * 1000 / 1024 / ms));
+}
+
+/* one aos_read_many() against an aos_read() per fd, each fd has data */
+static void vbench_many(void)
+{
+    aos_read_req_t reqs[VBENCH_FDS];
+    int            fds[VBENCH_FDS];
+    long long      start;
+    long long      ms;
+    long long      rounds;
+    int            ns[2];
+    int            round;
+    int            many;
+    int            i;
+
+    for (i = 0; i < VBENCH_FDS; i++) {
+        fds[i] = aos_open(LOOP_DEVICE_PATH, 0);
+        if (fds[i] < 0) {
+            aos_cli_printf("vfs_bench: open failed\r\n");
+            while (--i >= 0) {
+                aos_close(fds[i]);
+            }
+            return;
+        }
+    }
+
+    for (many = 0; many < 2; many++) {
+        rounds = 0;
+        start  = aos_now_ms();
+        do {
+            for (round = 0; round < VBENCH_BATCH; round++) {
+                for (i = 0; i < VBENCH_FDS; i++) {
+                    aos_write(fds[i], g_vbench_buf[0], 64);
+                }
+
+                if (many) {
+                    for (i = 0; i < VBENCH_FDS; i++) {
+                        reqs[i].fd     = fds[i];
+                        reqs[i].buf    = g_vbench_buf[1] + i * 64;
+                        reqs[i].nbytes = 64;
+                    }
+                    aos_read_many(reqs, VBENCH_FDS);
+                } else {
+                    for (i = 0; i < VBENCH_FDS; i++) {
+                        aos_read(fds[i], g_vbench_buf[1] + i * 64, 64);
+                    }
+                }
+            }
+            rounds += VBENCH_BATCH;
+            ms = aos_now_ms() - start;
+        } while (ms < VBENCH_MS);
+
+        ns[many] = (int)(ms * 1000000 / rounds);
+    }
+
+    for (i = 0; i < VBENCH_FDS; i++) {
+        aos_close(fds[i]);
+    }
+
+    aos_cli_printf("%d fds, 64 B each: %d ns by aos_read, %d ns by aos_read_many\r\n",
+                   VBENCH_FDS, ns[0], ns[1]);
+}
+
+#if (AOS_CONFIG_VFS_POLL_SUPPORT > 0)
+/* a byte goes to one fd after the other, a wait finds it and it is read */
+static int vbench_wait_round(int *fds, int nfds, int epfd, struct pollfd *pfds, int round)
+{
+    aos_epoll_event_t ev;
+    int               fd = fds[round % nfds];
+    int               i;
+
+    if (aos_write(fd, g_vbench_buf[0], 1) != 1) {
+        return -1;
+    }
+
+    if (epfd >= 0) {
+        if (aos_epoll_wait(epfd, &ev, 1, -1) != 1) {
+            return -1;
+        }
+        fd = ev.data.fd;
+    } else {
+        if (aos_poll(pfds, nfds, -1) != 1) {
+            return -1;
+        }
+        for (i = 0; pfds[i].revents == 0; i++);
+        fd = pfds[i].fd;
+    }
+
+    return aos_read(fd, g_vbench_buf[1], 1) == 1 ? 0 : -1;
+}
+
+static void vbench_wait(int nfds)
+{
+    static struct pollfd pfds[VBENCH_WAITS];
+    aos_epoll_event_t    ev;
+    int                  fds[VBENCH_WAITS];
+    int                  epfd;
+    long long            start;
+    long long            ms;
+    long long            rounds;
+    int                  ns[2];
+    int                  use_epoll;
+    int                  n;
+    int                  i;
+
+    epfd = aos_epoll_create();
+    if (epfd < 0) {
+        aos_cli_printf("vfs_bench: no epoll set\r\n");
+        return;
+    }
+
+    for (n = 0; n < nfds; n++) {
+        fds[n] = aos_open(LOOP_DEVICE_PATH, 0);
+        if (fds[n] < 0) {
+            aos_cli_printf("vfs_bench: open failed\r\n");
+            goto out;
+        }
+
+        pfds[n].fd      = fds[n];
+        pfds[n].events  = POLLIN;
+        ev.events       = AOS_EPOLLIN;
+        ev.data.fd      = fds[n];
+        if (aos_epoll_ctl(epfd, AOS_EPOLL_CTL_ADD, fds[n], &ev) != 0) {
+            aos_cli_printf("vfs_bench: epoll_ctl failed\r\n");
+            n++;
+            goto out;
+        }
+    }
+
+    for (use_epoll = 0; use_epoll < 2; use_epoll++) {
+        rounds = 0;
+        start  = aos_now_ms();
+        do {
+            for (i = 0; i < VBENCH_BATCH; i++) {
+                if (vbench_wait_round(fds, nfds, use_epoll ? epfd : -1, pfds, i) != 0) {
+                    aos_cli_printf("vfs_bench: wait failed\r\n");
+                    goto out;
+                }
+            }
+            rounds += VBENCH_BATCH;
+            ms = aos_now_ms() - start;
+        } while (ms < VBENCH_MS);
+
+        ns[use_epoll] = (int)(ms * 1000000 / rounds);
+    }
+
+    aos_cli_printf("1 of %2d fds ready: %6d ns by aos_poll, %6d ns by aos_epoll_wait\r\n",
+                   nfds, ns[0], ns[1]);
+
+out:
+    aos_close(epfd);
+    while (--n >= 0) {
+        aos_close(fds[n]);
+    }
+}
+#endif
+
+static void handle_vfs_bench_cmd(char *pwbuf, int blen, int argc, char **argv)
+{
+    static const size_t lens[] = { 64, 512, 4096 };
+    int                 fd;
+    int                 mode;
+    int                 i;
+
+    if (vfs_loop_device_init() != VFS_SUCCESS) {
+        aos_cli_printf("vfs_bench: no loop device\r\n");
+        return;
+    }
+
+    fd = aos_open(LOOP_DEVICE_PATH, 0);
+    if (fd < 0) {
+        aos_cli_printf("vfs_bench: open failed\r\n");
+        return;
+    }
+
+    for (i = 0; i < sizeof(lens) / sizeof(lens[0]); i++) {
+        for (mode = VBENCH_COPY; mode <= VBENCH_LENT; mode++) {
+            vbench_run(fd, mode, lens[i]);
+        }
+    }
+
+    aos_close(fd);
+
+    vbench_many();
+
+#if (AOS_CONFIG_VFS_POLL_SUPPORT > 0)
+    vbench_wait(1);
+    vbench_wait(8);
+    vbench_wait(VBENCH_WAITS);
+#endif
+}
+
+static struct cli_command vfs_bench_cmd = {
+    "vfs_bench",
+    "vfs throughput over " LOOP_DEVICE_PATH,
+    handle_vfs_bench_cmd
+};
+
+void vfs_bench_init(void)
+{
+    aos_cli_register_command(&vfs_bench_cmd);
+}
+#else
+void vfs_bench_init(void)
+{
+}
+#endif
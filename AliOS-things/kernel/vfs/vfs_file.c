@@ -6,31 +6,114 @@
 #include <vfs_conf.h>
 #include <vfs_err.h>
 #include <vfs_inode.h>
+#include <vfs_file.h>
 #include <stdio.h>
 
 #define MAX_FILE_NUM (AOS_CONFIG_VFS_DEV_NODES * 2)
 static file_t files[MAX_FILE_NUM]; /* 50 */
 
-file_t *new_file(inode_t *node)
+extern aos_mutex_t g_vfs_mutex;
+
+/*
+ * The table grows by chunks of MAX_FILE_NUM files which stay where they
+ * are, fd - AOS_CONFIG_VFS_FD_OFFSET indexes them. Free files are on a
+ * lock-free stack of index + 1 in the low 16 bits of g_file_free, the high
+ * ones count the changes against ABA.
+ */
+#define FILE_FREE_IDX(v)  ((v) & 0xffffu)
+#define FILE_FREE_TAG(v)  (((v) + 0x10000u) & ~0xffffu)
+
+static file_t            *g_file_chunks[AOS_CONFIG_VFS_FILE_CHUNKS];
+static rhino_atomic_idx_t g_file_nchunks;
+static rhino_atomic_idx_t g_file_free;
+
+static file_t *file_at(uint32_t idx)
 {
-    file_t *f;
-    int idx;
+    return &g_file_chunks[idx / MAX_FILE_NUM][idx % MAX_FILE_NUM];
+}
+
+/* push the files from first_idx to last, linked already */
+static void file_push(file_t *last, uint32_t first_idx)
+{
+    atomic_val_t head = rhino_atomic_load_relaxed(&g_file_free);
 
-    for (idx = 0; idx < MAX_FILE_NUM; idx++) {
-        f = &files[idx];
+    do {
+        rhino_atomic_store_release(&last->f_next, FILE_FREE_IDX(head));
+    } while (!rhino_atomic_cas_weak(&g_file_free, &head,
+                                    FILE_FREE_TAG(head) | (first_idx + 1)));
+}
 
-        if (f->node == NULL) {
-            goto got_file;
+static int file_grow(void)
+{
+    file_t  *chunk;
+    uint32_t n;
+    uint32_t base;
+    int      idx;
+    int      ret = 0;
+
+    if (aos_mutex_lock(&g_vfs_mutex, AOS_WAIT_FOREVER) != 0) {
+        return -1;
+    }
+
+    /* another task may have grown it meanwhile */
+    n = rhino_atomic_load_relaxed(&g_file_nchunks);
+    if (FILE_FREE_IDX(rhino_atomic_load_acquire(&g_file_free)) != 0) {
+        goto out;
+    }
+
+    if (n == AOS_CONFIG_VFS_FILE_CHUNKS) {
+        ret = -ENFILE;
+        goto out;
+    }
+
+    if (n == 0) {
+        chunk = files;
+    } else {
+        chunk = (file_t *)aos_zalloc(sizeof(file_t) * MAX_FILE_NUM);
+        if (chunk == NULL) {
+            ret = -ENOMEM;
+            goto out;
         }
     }
 
-    return NULL;
+    base = n * MAX_FILE_NUM;
+    for (idx = 0; idx < MAX_FILE_NUM - 1; idx++) {
+        rhino_atomic_idx_init(&chunk[idx].f_next, base + idx + 2);
+    }
+
+    g_file_chunks[n] = chunk;
+    rhino_atomic_store_release(&g_file_nchunks, n + 1);
+
+    file_push(&chunk[MAX_FILE_NUM - 1], base);
+
+out:
+    aos_mutex_unlock(&g_vfs_mutex);
+    return ret;
+}
+
+file_t *new_file(inode_t *node)
+{
+    file_t      *f;
+    atomic_val_t head;
+    uint32_t     next;
+
+    head = rhino_atomic_load_acquire(&g_file_free);
+
+    do {
+        while (FILE_FREE_IDX(head) == 0) {
+            if (file_grow() != 0) {
+                return NULL;
+            }
+            head = rhino_atomic_load_acquire(&g_file_free);
+        }
+
+        f    = file_at(FILE_FREE_IDX(head) - 1);
+        next = rhino_atomic_load_acquire(&f->f_next);
+    } while (!rhino_atomic_cas_weak(&g_file_free, &head, FILE_FREE_TAG(head) | next));
 
-got_file:
     f->node = node;
     f->f_arg = NULL;
     f->offset = 0;
-    inode_ref(node);
     return f;
 }
 
@@ -38,11 +121,21 @@ void del_file(file_t *file)
 {
     inode_unref(file->node);
     file->node = NULL;
+    file_push(file, get_fd(file) - AOS_CONFIG_VFS_FD_OFFSET);
 }
 
 int get_fd(file_t *file)
 {
-    return (file - files) + AOS_CONFIG_VFS_FD_OFFSET;
+    uint32_t n = rhino_atomic_load_acquire(&g_file_nchunks);
+    uint32_t c;
+
+    for (c = 0; c < n; c++) {
+        if (file >= g_file_chunks[c] && file < g_file_chunks[c] + MAX_FILE_NUM) {
+            return c * MAX_FILE_NUM + (file - g_file_chunks[c]) + AOS_CONFIG_VFS_FD_OFFSET;
+        }
+    }
+
+    return -ENOENT;
 }
 
 file_t *get_file(int fd)
@@ -55,10 +148,10 @@ file_t *get_file(int fd)
         return NULL;
     }
 
-    if (fd >= MAX_FILE_NUM) {
+    if ((uint32_t)fd >= rhino_atomic_load_acquire(&g_file_nchunks) * MAX_FILE_NUM) {
         return NULL;
     }
 
-    f = &files[fd];
+    f = file_at(fd);
     return f->node ? f : NULL;
 }
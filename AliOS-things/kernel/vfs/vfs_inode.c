@@ -10,67 +10,146 @@
 
 #define VFS_NULL_PARA_CHK(para)     do { if (!(para)) return -EINVAL; } while(0)
 
-static inode_t g_vfs_dev_nodes[AOS_CONFIG_VFS_DEV_NODES];
+#define INODE_HASH_MASK  (AOS_CONFIG_VFS_HASH_BUCKETS - 1)
+#define INODE_MAX_NUM    (AOS_CONFIG_VFS_DEV_NODES * AOS_CONFIG_VFS_NODE_CHUNKS)
 
-int inode_init()
+/*
+ * The inodes live in chunks of AOS_CONFIG_VFS_DEV_NODES, the first one
+ * static, the others allocated when it runs full. Chunks are never freed so
+ * an inode does not move, and inodes link each other by index + 1, 0 ends a
+ * chain.
+ *
+ * Every inode is in a hash bucket by its full name, FS_DEV ones are also on
+ * the mount list, longest name first, for prefix matches. Writers hold
+ * g_vfs_mutex, readers take no lock: a writer links a node only when it is
+ * complete, and reuses an unlinked one only after every reader which could
+ * still see it has left, see inode_sync().
+ */
+static inode_t  g_vfs_dev_nodes[AOS_CONFIG_VFS_DEV_NODES];
+static inode_t *g_inode_chunks[AOS_CONFIG_VFS_NODE_CHUNKS];
+static int      g_inode_nchunks;
+static int      g_inode_free;  /* free list, index + 1 */
+static int      g_inode_used;
+
+static rhino_atomic_idx_t g_inode_hash[AOS_CONFIG_VFS_HASH_BUCKETS];
+static rhino_atomic_idx_t g_inode_mounts;
+static rhino_atomic_idx_t g_inode_readers;
+
+static inode_t *inode_at(uint32_t id)
 {
-    memset(g_vfs_dev_nodes, 0, sizeof(inode_t) * AOS_CONFIG_VFS_DEV_NODES);
-    return 0;
+    id--;
+    return &g_inode_chunks[id / AOS_CONFIG_VFS_DEV_NODES][id % AOS_CONFIG_VFS_DEV_NODES];
 }
 
-int inode_alloc()
+static uint32_t inode_id(inode_t *node)
 {
-    int e = 0;
+    int c;
 
-    for (; e < AOS_CONFIG_VFS_DEV_NODES; e++) {
-        if (g_vfs_dev_nodes[e].type == VFS_TYPE_NOT_INIT) {
-            return e;
+    for (c = 0; c < g_inode_nchunks; c++) {
+        if (node >= g_inode_chunks[c] &&
+            node < g_inode_chunks[c] + AOS_CONFIG_VFS_DEV_NODES) {
+            return c * AOS_CONFIG_VFS_DEV_NODES + (node - g_inode_chunks[c]) + 1;
         }
     }
 
-    return -ENOMEM;
+    return 0;
 }
 
-int inode_del(inode_t *node)
+/* FNV-1a */
+static uint32_t inode_hash(const char *path)
 {
-    if (node->refs > 0) {
-        return -EBUSY;
+    uint32_t hash = 2166136261u;
+
+    while (*path != '\0') {
+        hash = (hash ^ (uint8_t)*path++) * 16777619u;
     }
 
-    if (node->refs == 0) {
-        if (node->i_name != NULL) {
-            aos_free(node->i_name);
+    return hash;
+}
+
+static void inode_read_enter(void)
+{
+    atomic_val_t readers = rhino_atomic_load_relaxed(&g_inode_readers);
+
+    while (!rhino_atomic_cas_weak(&g_inode_readers, &readers, readers + 1));
+}
+
+static void inode_read_exit(void)
+{
+    atomic_val_t readers = rhino_atomic_load_relaxed(&g_inode_readers);
+
+    while (!rhino_atomic_cas_weak(&g_inode_readers, &readers, readers - 1));
+}
+
+/*
+ * Wait until no reader is left which could have seen a node unlinked
+ * before. Readers come and go through the same counter, so a reader
+ * entering after the counter was read as 0 sees the unlink.
+ */
+static void inode_sync(void)
+{
+    atomic_val_t readers;
+
+    for (;;) {
+        readers = 0;
+        if (rhino_atomic_cas_weak(&g_inode_readers, &readers, 0)) {
+            return;
         }
 
-        node->i_name = NULL;
-        node->i_arg = NULL;
-        node->i_flags = 0;
-        node->type = VFS_TYPE_NOT_INIT;
+        if (readers != 0) {
+            aos_msleep(1);
+        }
     }
+}
 
-    return VFS_SUCCESS;
+/* take a reference unless the node is being removed */
+static int inode_tryref(inode_t *node)
+{
+    atomic_val_t refs = rhino_atomic_load_relaxed(&node->refs);
+
+    do {
+        if (refs == INODE_REFS_DEAD) {
+            return 0;
+        }
+    } while (!rhino_atomic_cas_weak(&node->refs, &refs, refs + 1));
+
+    return 1;
 }
 
-inode_t *inode_open(const char *path)
+static inode_t *inode_find(const char *path, uint32_t hash)
 {
-    int e = 0;
     inode_t *node;
+    uint32_t id;
 
-    for (; e < AOS_CONFIG_VFS_DEV_NODES; e++) {
-        node = &g_vfs_dev_nodes[e];
-        if (node == NULL) {
-            continue;
-        }
-        if (node->i_name == NULL) {
-            continue;
-        }
-        if (INODE_IS_TYPE(node, VFS_TYPE_FS_DEV)) {
-            if ((strncmp(node->i_name, path, strlen(node->i_name)) == 0) &&
-                (*(path + strlen(node->i_name)) == '/')) {
-                return node;
-            }
+    id = rhino_atomic_load_acquire(&g_inode_hash[hash & INODE_HASH_MASK]);
+
+    for (; id != 0; id = rhino_atomic_load_acquire(&node->i_next)) {
+        node = inode_at(id);
+        if (node->i_hash == hash && strcmp(node->i_name, path) == 0) {
+            return node;
         }
-        if (strcmp(node->i_name, path) == 0) {
+    }
+
+    return NULL;
+}
+
+static inode_t *inode_lookup(const char *path)
+{
+    inode_t *node;
+    uint32_t id;
+    size_t   len;
+
+    node = inode_find(path, inode_hash(path));
+    if (node != NULL) {
+        return node;
+    }
+
+    id = rhino_atomic_load_acquire(&g_inode_mounts);
+
+    for (; id != 0; id = rhino_atomic_load_acquire(&node->i_mnext)) {
+        node = inode_at(id);
+        len  = strlen(node->i_name);
+        if (strncmp(node->i_name, path, len) == 0 && path[len] == '/') {
             return node;
         }
     }
@@ -78,46 +157,194 @@ inode_t *inode_open(const char *path)
     return NULL;
 }
 
+static int inode_grow(void)
+{
+    inode_t *chunk;
+    int      base;
+    int      e;
+
+    if (g_inode_nchunks == AOS_CONFIG_VFS_NODE_CHUNKS) {
+        return -ENOMEM;
+    }
+
+    if (g_inode_nchunks == 0) {
+        chunk = g_vfs_dev_nodes;
+    } else {
+        chunk = (inode_t *)aos_zalloc(sizeof(inode_t) * AOS_CONFIG_VFS_DEV_NODES);
+        if (chunk == NULL) {
+            return -ENOMEM;
+        }
+    }
+
+    base = g_inode_nchunks * AOS_CONFIG_VFS_DEV_NODES;
+    g_inode_chunks[g_inode_nchunks++] = chunk;
+
+    for (e = AOS_CONFIG_VFS_DEV_NODES - 1; e >= 0; e--) {
+        rhino_atomic_store_release(&chunk[e].i_next, g_inode_free);
+        g_inode_free = base + e + 1;
+    }
+
+    return 0;
+}
+
+static void inode_free(inode_t *node)
+{
+    rhino_atomic_store_release(&node->i_next, g_inode_free);
+    g_inode_free = inode_id(node);
+    g_inode_used--;
+}
+
+static void inode_unlink(rhino_atomic_idx_t *head, inode_t *node, int mount)
+{
+    rhino_atomic_idx_t *link = head;
+    uint32_t            id   = inode_id(node);
+    uint32_t            cur;
+    inode_t            *prev;
+
+    while ((cur = rhino_atomic_load_relaxed(link)) != 0) {
+        if (cur == id) {
+            /* readers on node still find their way on through its link */
+            rhino_atomic_store_release(link, mount ? rhino_atomic_load_relaxed(&node->i_mnext)
+                                                   : rhino_atomic_load_relaxed(&node->i_next));
+            return;
+        }
+
+        prev = inode_at(cur);
+        link = mount ? &prev->i_mnext : &prev->i_next;
+    }
+}
+
+int inode_init()
+{
+    int e;
+
+    memset(g_vfs_dev_nodes, 0, sizeof(inode_t) * AOS_CONFIG_VFS_DEV_NODES);
+
+    g_inode_nchunks = 0;
+    g_inode_free    = 0;
+    g_inode_used    = 0;
+
+    for (e = 0; e < AOS_CONFIG_VFS_HASH_BUCKETS; e++) {
+        rhino_atomic_idx_init(&g_inode_hash[e], 0);
+    }
+    rhino_atomic_idx_init(&g_inode_mounts, 0);
+    rhino_atomic_idx_init(&g_inode_readers, 0);
+
+    return inode_grow();
+}
+
+int inode_alloc()
+{
+    int e;
+
+    if (g_inode_free == 0 && inode_grow() != 0) {
+        return -ENOMEM;
+    }
+
+    e = g_inode_free - 1;
+    g_inode_free = rhino_atomic_load_relaxed(&inode_at(e + 1)->i_next);
+    g_inode_used++;
+
+    return e;
+}
+
+int inode_del(inode_t *node)
+{
+    atomic_val_t refs = 0;
+
+    /* from now on inode_get() skips node */
+    while (!rhino_atomic_cas_weak(&node->refs, &refs, INODE_REFS_DEAD)) {
+        if (refs != 0) {
+            return -EBUSY;
+        }
+    }
+
+    inode_unlink(&g_inode_hash[node->i_hash & INODE_HASH_MASK], node, 0);
+    if (INODE_IS_FS(node)) {
+        inode_unlink(&g_inode_mounts, node, 1);
+    }
+
+    inode_sync();
+
+    if (node->i_name != NULL) {
+        aos_free(node->i_name);
+    }
+
+    node->i_name = NULL;
+    node->i_arg = NULL;
+    node->i_flags = 0;
+    node->type = VFS_TYPE_NOT_INIT;
+    rhino_atomic_store_release(&node->refs, 0);
+
+    inode_free(node);
+
+    return VFS_SUCCESS;
+}
+
+inode_t *inode_open(const char *path)
+{
+    inode_t *node;
+
+    inode_read_enter();
+    node = inode_lookup(path);
+    inode_read_exit();
+
+    return node;
+}
+
+inode_t *inode_get(const char *path)
+{
+    inode_t *node;
+
+    inode_read_enter();
+
+    node = inode_lookup(path);
+    if (node != NULL && !inode_tryref(node)) {
+        node = NULL;
+    }
+
+    inode_read_exit();
+
+    return node;
+}
+
 int inode_ptr_get(int fd, inode_t **node)
 {
-    if (fd < 0 || fd >= AOS_CONFIG_VFS_DEV_NODES) {
+    if (fd < 0 || fd >= g_inode_nchunks * AOS_CONFIG_VFS_DEV_NODES) {
         return -EINVAL;
     }
 
-    *node = &g_vfs_dev_nodes[fd];
+    *node = inode_at(fd + 1);
 
     return VFS_SUCCESS;
 }
 
 void inode_ref(inode_t *node)
 {
-    node->refs++;
+    atomic_val_t refs = rhino_atomic_load_relaxed(&node->refs);
+
+    while (!rhino_atomic_cas_weak(&node->refs, &refs, refs + 1));
 }
 
 void inode_unref(inode_t *node)
 {
-    if (node->refs > 0) {
-        node->refs--;
-    }
+    atomic_val_t refs = rhino_atomic_load_relaxed(&node->refs);
+
+    do {
+        if (refs == 0 || refs == INODE_REFS_DEAD) {
+            return;
+        }
+    } while (!rhino_atomic_cas_weak(&node->refs, &refs, refs - 1));
 }
 
 int inode_busy(inode_t *node)
 {
-    return node->refs > 0;
+    return rhino_atomic_load_relaxed(&node->refs) > 0;
 }
 
 int inode_avail_count(void)
 {
-    int count = 0;
-    int e = 0;
-
-    for (; e < AOS_CONFIG_VFS_DEV_NODES; e++) {
-        if (g_vfs_dev_nodes[count].type == VFS_TYPE_NOT_INIT) {
-            count++;
-        }
-    }
-
-    return count;
+    return INODE_MAX_NUM - g_inode_used;
 }
 
 static int inode_set_name(const char *path, inode_t **inode)
@@ -134,6 +361,7 @@ static int inode_set_name(const char *path, inode_t **inode)
     memcpy(mem, (const void *)path, len);
     (*inode)->i_name = (char *)mem;
     (*inode)->i_name[len] = '\0';
+    (*inode)->i_hash = inode_hash(path);
 
     return VFS_SUCCESS;
 }
@@ -151,6 +379,10 @@ int inode_reserve(const char *path, inode_t **inode)
         return -EINVAL;
     }
 
+    if (inode_find(path, inode_hash(path)) != NULL) {
+        return -EEXIST;
+    }
+
     ret = inode_alloc();
     if (ret < 0) {
         return ret;
@@ -160,6 +392,7 @@ int inode_reserve(const char *path, inode_t **inode)
 
     ret = inode_set_name(path, &node);
     if (ret < 0) {
+        inode_free(node);
         return ret;
     }
 
@@ -167,6 +400,31 @@ int inode_reserve(const char *path, inode_t **inode)
     return VFS_SUCCESS;
 }
 
+void inode_commit(inode_t *node)
+{
+    rhino_atomic_idx_t *link;
+    uint32_t            id = inode_id(node);
+    uint32_t            cur;
+    size_t              len;
+
+    if (INODE_IS_FS(node)) {
+        len  = strlen(node->i_name);
+        link = &g_inode_mounts;
+
+        while ((cur = rhino_atomic_load_relaxed(link)) != 0 &&
+               strlen(inode_at(cur)->i_name) > len) {
+            link = &inode_at(cur)->i_mnext;
+        }
+
+        rhino_atomic_store_release(&node->i_mnext, cur);
+        rhino_atomic_store_release(link, id);
+    }
+
+    link = &g_inode_hash[node->i_hash & INODE_HASH_MASK];
+    rhino_atomic_store_release(&node->i_next, rhino_atomic_load_relaxed(link));
+    rhino_atomic_store_release(link, id);
+}
+
 int inode_release(const char *path)
 {
     int ret;
@@ -174,7 +432,7 @@ int inode_release(const char *path)
 
     VFS_NULL_PARA_CHK(path != NULL);
 
-    node = inode_open(path);
+    node = inode_find(path, inode_hash(path));
     if (node == NULL) {
         return -ENODEV;
     }
@@ -186,4 +444,3 @@ int inode_release(const char *path)
 
     return VFS_SUCCESS;
 }
-
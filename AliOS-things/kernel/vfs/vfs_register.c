@@ -31,16 +31,17 @@ int aos_register_driver(const char *path, file_ops_t *ops, void *arg)
 
         /* creat device lock. */
         ret = aos_mutex_new(&node->mutex);
+        if (ret == 0) {
+            /* lookups see the node from here on */
+            inode_commit(node);
+        } else {
+            inode_del(node);
+        }
     }
 
     /* step out critical area for type is allocated */
     err = aos_mutex_unlock(&g_vfs_mutex);
     if (err != 0) {
-        if (node->i_name != NULL) {
-            aos_free(node->i_name);
-        }
-
-        memset(node, 0, sizeof(inode_t));
         return err;
     }
 
@@ -82,15 +83,12 @@ int aos_register_fs(const char *path, fs_ops_t *ops, void *arg)
 
         node->ops.i_fops = ops;
         node->i_arg      = arg;
+
+        inode_commit(node);
     }
 
-    err = aos_mutex_unlock(&g_vfs_mutex	);
+    err = aos_mutex_unlock(&g_vfs_mutex);
     if (err != 0) {
-        if (node->i_name != NULL) {
-            aos_free(node->i_name);
-        }
-
-        memset(node, 0, sizeof(inode_t));
         return err;
     }
 
@@ -10,31 +10,73 @@
 #include "event_device.h"
 #include "yloop.h"
 #include "k_config.h"
+
+/* typed filters are hashed by type, a power of 2 */
+#define EVENT_FILTER_BUCKETS 16
+
 typedef struct {
     dlist_t       node;
     aos_event_cb  cb;
     void         *priv;
     uint16_t      type_filter;
+    uint32_t      seq;  /* registration order across the lists */
 } event_list_node_t;
 
 static struct {
-    void *handle;
-    int   fd;
+    void       *handle;
+    int         fd;
+    aos_loop_t  loop; /* the loop reading fd */
 } local_event = {
     .fd = -1,
 };
 
-static dlist_t g_local_event_list = AOS_DLIST_INIT(g_local_event_list);
+static dlist_t  g_local_event_list = AOS_DLIST_INIT(g_local_event_list); /* EV_ALL */
+static dlist_t  g_event_buckets[EVENT_FILTER_BUCKETS];
+static bool     g_event_buckets_inited;
+static uint32_t g_event_seq;
 
-static void handle_events(input_event_t *event);
 static int  input_add_event(int fd, input_event_t *event);
 static void event_read_cb(int fd, void *param);
 
+static dlist_t *event_bucket(uint16_t type)
+{
+    int i;
+
+    if (!g_event_buckets_inited) {
+        for (i = 0; i < EVENT_FILTER_BUCKETS; i++) {
+            dlist_init(&g_event_buckets[i]);
+        }
+        g_event_buckets_inited = true;
+    }
+
+    return &g_event_buckets[(type ^ (type >> 8)) & (EVENT_FILTER_BUCKETS - 1)];
+}
+
+/* the next filter of type in a bucket, NULL at its end */
+static event_list_node_t *event_next_typed(dlist_t *head, dlist_t *pos, uint16_t type)
+{
+    event_list_node_t *node;
+
+    for (; pos != head; pos = pos->next) {
+        node = dlist_entry(pos, event_list_node_t, node);
+        if (node->type_filter == type) {
+            return node;
+        }
+    }
+
+    return NULL;
+}
+
 /* Handle events
  * just dispatch
  */
-void handle_events(input_event_t *event)
+void aos_loop_handle_event(input_event_t *event)
 {
+    event_list_node_t *all;
+    event_list_node_t *typed;
+    event_list_node_t *node;
+    dlist_t           *bucket;
+
     if (event->type == EV_RPC) {
         aos_call_t handler = (aos_call_t)event->value;
         void *arg = (void *)event->extra;
@@ -43,13 +85,26 @@ void handle_events(input_event_t *event)
         return;
     }
 
-    event_list_node_t *event_node = NULL;
-    dlist_for_each_entry(&g_local_event_list, event_node, event_list_node_t, node) {
-        if (event_node->type_filter != EV_ALL
-            && event_node->type_filter != event->type) {
-            continue;
+    /*
+     * EV_ALL filters and the ones of this type, merged in registration
+     * order, the next one is picked before the callback may drop its own
+     */
+    bucket = event_bucket(event->type);
+    typed  = event_next_typed(bucket, bucket->next, event->type);
+    all    = dlist_empty(&g_local_event_list) ? NULL :
+             dlist_entry(g_local_event_list.next, event_list_node_t, node);
+
+    while (all != NULL || typed != NULL) {
+        if (typed == NULL || (all != NULL && (int32_t)(all->seq - typed->seq) < 0)) {
+            node = all;
+            all  = node->node.next == &g_local_event_list ? NULL :
+                   dlist_entry(node->node.next, event_list_node_t, node);
+        } else {
+            node  = typed;
+            typed = event_next_typed(bucket, node->node.next, event->type);
         }
-        (event_node->cb)(event, event_node->priv);
+
+        (node->cb)(event, node->priv);
     }
 }
 
@@ -73,8 +128,67 @@ void event_read_cb(int fd, void *param)
     input_event_t event;
     int ret = aos_read(fd, &event, sizeof(event));
     if (ret == sizeof(event)) {
-        handle_events(&event);
+        aos_loop_handle_event(&event);
+    }
+}
+
+/*
+ * Normal events go through the lock-free ring of loop, only the first one
+ * queued while the loop is idle needs an event on fd to wake it. Urgent
+ * events, and the ones meeting a full ring, keep going through the device.
+ */
+static int post_event(aos_loop_t loop, int fd, input_event_t *event)
+{
+    input_event_t *copy;
+    int            ret;
+
+    if (event->type & EV_FLAG_URGENT) {
+        return input_add_event(fd, event) < 0 ? -1 : 0;
+    }
+
+    ret = yloop_msg_post(loop, event);
+    if (ret == 0) {
+        return 0;
+    }
+
+    if (ret > 0) {
+        input_event_t wake = {
+            .type  = EV_RPC,
+            .value = (unsigned long)yloop_msg_drain,
+            .extra = (unsigned long)(loop ? loop : aos_current_loop()),
+        };
+
+        /* the event is queued, hand the wakeup to the next post or the
+           loop would be taken as awake for good */
+        if (input_add_event(fd, &wake) < 0) {
+            yloop_msg_wake_cancel(loop);
+        }
+        return 0;
+    }
+
+    if (ret != -EAGAIN) {
+        return input_add_event(fd, event) < 0 ? -1 : 0;
     }
+
+    copy = aos_malloc(sizeof(*copy));
+    if (copy != NULL) {
+        input_event_t overflow = {
+            .type  = EV_RPC,
+            .value = (unsigned long)yloop_msg_overflow_run,
+            .extra = (unsigned long)copy,
+        };
+
+        *copy = *event;
+        if (input_add_event(fd, &overflow) >= 0) {
+            return 0;
+        }
+
+        aos_free(copy);
+    }
+
+    yloop_msg_overflow_cancel(loop);
+
+    return -1;
 }
 
 int aos_event_service_init(void)
@@ -83,6 +197,7 @@ int aos_event_service_init(void)
 
     if (local_event.fd < 0) {
         local_event.fd = fd;
+        local_event.loop = aos_current_loop();
     }
     aos_poll_read_fd(fd, event_read_cb, NULL);
     aos_loop_set_eventfd(fd); /* yloopeventfd */
@@ -104,7 +219,7 @@ int aos_post_event(uint16_t type, uint16_t code, unsigned long value)
         .value = value,
     };
 
-    return input_add_event(local_event.fd, &event);
+    return post_event(local_event.loop, local_event.fd, &event);
 }
 AOS_EXPORT(int, aos_post_event, uint16_t, uint16_t, unsigned long);
 
@@ -122,8 +237,9 @@ int aos_register_event_filter(uint16_t type, aos_event_cb cb, void *priv)
     event_node->cb           = cb;
     event_node->type_filter  = type;
     event_node->priv         = priv;
+    event_node->seq          = g_event_seq++;
 
-    dlist_add_tail(&event_node->node, &g_local_event_list);
+    dlist_add_tail(&event_node->node, type == EV_ALL ? &g_local_event_list : event_bucket(type));
 
     return 0;
 }
@@ -131,8 +247,10 @@ AOS_EXPORT(int, aos_register_event_filter, uint16_t, aos_event_cb, void *);
 
 int aos_unregister_event_filter(uint16_t type, aos_event_cb cb, void *priv)
 {
+    dlist_t *head = type == EV_ALL ? &g_local_event_list : event_bucket(type);
+
     event_list_node_t *event_node = NULL;
-    dlist_for_each_entry(&g_local_event_list, event_node, event_list_node_t, node) {
+    dlist_for_each_entry(head, event_node, event_list_node_t, node) {
         if (event_node->type_filter != type) {
             continue;
         }
@@ -172,12 +290,13 @@ static int _schedule_call(aos_loop_t *loop, aos_call_t fun, void *arg,
     int fd = aos_loop_get_eventfd(loop);
     if (fd < 0) {
         fd = local_event.fd;
+        loop = local_event.loop;
     }
 
     if (urgent) {
         event.type |= EV_FLAG_URGENT;
     }
-    return input_add_event(fd, &event);
+    return post_event(loop, fd, &event);
 }
 
 int aos_loop_schedule_urgent_call(aos_loop_t *loop, aos_call_t fun, void *arg)
@@ -1,7 +1,13 @@
 src     = Split('''
         yloop.c
+        yloop_poll.c
+        yloop_epoll.c
         local_event.c
 ''')
 component = aos_component('yloop', src)
 component.add_comp_deps('utility/log', 'kernel/vfs')
 component.add_global_macros('AOS_LOOP')
+
+if aos_global_config.get('aos_bench') == '1':
+    component.add_sources('yloop_bench.c')
+    component.add_global_macros('CONFIG_AOS_BENCH')
@@ -6,37 +6,93 @@
 #include <string.h>
 #include <stdbool.h>
 #include <stdlib.h>
+#include <limits.h>
 
 #include <errno.h>
 #include <aos/aos.h>
 #include <aos/network.h>
+#include <vfs_conf.h>
 
 #include "yloop.h"
 
+#ifdef VCALL_RHINO
+#include <k_api.h>
+#include <k_lfring.h>
+#endif
+
 #define TAG "yloop"
 
+/* events and calls from other tasks go through a per-loop lock-free ring */
+#if defined(VCALL_RHINO) && (RHINO_CONFIG_RINGBUF_LOCKFREE > 0)
+#define YLOOP_MSG_RING 1
+#endif
+
+#ifndef YLOOP_CONFIG_MSG_NUM
+#define YLOOP_CONFIG_MSG_NUM 32
+#endif
+
+/* an epoll set costs a wait the ready fds only, it arms lwIP sockets only */
+#if (AOS_CONFIG_VFS_POLL_SUPPORT > 0) && defined(WITH_LWIP)
+#define YLOOP_DEFAULT_BACKEND yloop_epoll_backend
+#else
+#define YLOOP_DEFAULT_BACKEND yloop_poll_backend
+#endif
+
 typedef struct {
     int              sock;
+    int              events; /* POLLIN/POLLOUT interest */
+    bool             edge;
     void            *private_data;
     aos_poll_call_t  cb;
+    void            *wprivate_data;
+    aos_poll_call_t  wcb;
 } yloop_sock_t;
 
-typedef struct yloop_timeout_s {
-    dlist_t          next;
+typedef struct {
     long long        timeout_ms;
+    uint32_t         seq;      /* post order, FIFO among equal timeouts */
+    int              heap_idx; /* -1 when not pending */
+    int              next_free;
+    uint16_t         gen;      /* bumped on release, stale handles miss */
     void            *private_data;
     aos_call_t       cb;
     int              ms;
 } yloop_timeout_t;
 
 typedef struct {
-    dlist_t          timeouts; /* ʱ¼˫ */
-    struct pollfd   *pollfds;
-    yloop_sock_t    *readers;
+    int              fd;
+    int              revents;
+} yloop_ready_t;
+
+#ifdef YLOOP_MSG_RING
+/* the fix ring keeps a sequence word per event */
+#define YLOOP_MSG_BUF_SIZE \
+    (YLOOP_CONFIG_MSG_NUM * (sizeof(input_event_t) + sizeof(rhino_atomic_idx_t)))
+#endif
+
+typedef struct {
+    const yloop_backend_t *be;
+    void            *be_data;
+    yloop_sock_t    *readers;      /* dense, swap removed */
+    int             *sock_slot;    /* fd -> index in readers + 1 */
+    yloop_ready_t   *ready;        /* filled by be->wait() */
+    int              slot_size;
+    int              reader_count;
+    int              reader_size;
+    int              ready_count;
+    yloop_timeout_t *timers;       /* pool, handles index it */
+    int             *heap;         /* min-heap of pool indices */
+    int              timer_size;
+    int              timer_free;
+    int              heap_count;
+    uint32_t         timer_seq;
     int              eventfd; /* /dev/eventfd */
-    uint8_t          max_sock; /* fd */
-    uint8_t          reader_count; /* ʹylooptask */
-    bool             pending_terminate;
+#ifdef YLOOP_MSG_RING
+    k_mpsc_ring_t    msgs;
+    rhino_atomic_idx_t wake; /* loop awake or a wakeup on its way */
+    rhino_atomic_idx_t overflow; /* events sent through eventfd, ring full */
+    void            *msg_buf;
+#endif
     bool             terminate; /* ͷֹyloop */
 } yloop_ctx_t;
 
@@ -87,17 +143,49 @@ aos_loop_t aos_loop_init(void)
 
     if (!g_main_ctx) { /* ֤ϵͳֻһg_loop_key */
         aos_task_key_create(&g_loop_key);
+#if defined(CONFIG_AOS_CLI) && defined(CONFIG_AOS_BENCH)
+        yloop_bench_init();
+#endif
     } else if (ctx) {
         LOGE(TAG, "yloop already inited");
         return ctx;
     }
 
     ctx = aos_zalloc(sizeof(*g_main_ctx));
+    if (ctx == NULL) {
+        return NULL;
+    }
+
+    ctx->be = &YLOOP_DEFAULT_BACKEND;
+    ctx->be_data = ctx->be->create();
+    if (ctx->be_data == NULL && ctx->be != &yloop_poll_backend) {
+        ctx->be = &yloop_poll_backend;
+        ctx->be_data = ctx->be->create();
+    }
+    if (ctx->be_data == NULL) {
+        aos_free(ctx);
+        return NULL;
+    }
+
+#ifdef YLOOP_MSG_RING
+    ctx->msg_buf = aos_malloc(YLOOP_MSG_BUF_SIZE);
+    if (ctx->msg_buf == NULL ||
+        krhino_mpsc_ring_init(&ctx->msgs, ctx->msg_buf, YLOOP_MSG_BUF_SIZE,
+                              RINGBUF_TYPE_FIX, sizeof(input_event_t)) != RHINO_SUCCESS) {
+        aos_free(ctx->msg_buf);
+        ctx->be->destroy(ctx->be_data);
+        aos_free(ctx);
+        return NULL;
+    }
+    rhino_atomic_idx_init(&ctx->wake, 0u);
+    rhino_atomic_idx_init(&ctx->overflow, 0u);
+#endif
+
     if (!g_main_ctx) {
         g_main_ctx = ctx;
     }
 
-    dlist_init(&ctx->timeouts);
+    ctx->timer_free = -1;
     ctx->eventfd = -1;
     _set_context(ctx); /* yloop_ctx_tŵktask_t->user_info[g_loop_key] */
 
@@ -107,118 +195,373 @@ aos_loop_t aos_loop_init(void)
 }
 AOS_EXPORT(aos_loop_t, aos_loop_init, void);
 
-int aos_poll_read_fd(int sock, aos_poll_call_t cb, void *private_data)
-{ /* sockŵyloop->readers[]Сظsockô? */
-    yloop_ctx_t *ctx = get_context();
-    if (sock  < 0) {
-        return -EINVAL;
-    }
+int loop_grow(void **arr, int *size, int num, int elem, int used)
+{
+    void *tmp;
+    int   new_size = *size > 0 ? *size : 8;
 
-    yloop_sock_t *new_sock;
-    struct pollfd *new_loop_pollfds;
-    int cnt = ctx->reader_count + 1;
+    if (num <= *size) {
+        return 0;
+    }
 
-    new_sock = aos_malloc(cnt * sizeof(yloop_sock_t));
-    new_loop_pollfds = aos_malloc(cnt * sizeof(struct pollfd));
+    while (new_size < num) {
+        new_size *= 2;
+    }
 
-    if (new_sock == NULL || new_loop_pollfds == NULL) {
+    tmp = aos_zalloc(new_size * elem);
+    if (tmp == NULL) {
         LOGE(TAG, "out of memory");
-        aos_free(new_sock);
-        aos_free(new_loop_pollfds);
         return -ENOMEM;
     }
 
-    int status = aos_fcntl(sock, F_GETFL, 0);
-    aos_fcntl(sock, F_SETFL, status | O_NONBLOCK); /* sockfdΪ */
+    if (*arr != NULL) {
+        memcpy(tmp, *arr, used * elem);
+        aos_free(*arr);
+    }
+    *arr  = tmp;
+    *size = new_size;
 
-    ctx->reader_count++;
+    return 0;
+}
 
-    memcpy(new_sock, ctx->readers, (cnt - 1) * sizeof(yloop_sock_t)); /* sockfdyloop_t->readers[] */
-    aos_free(ctx->readers);
-    ctx->readers = new_sock;
+static yloop_sock_t *loop_sock_find(yloop_ctx_t *ctx, int sock)
+{
+    if (sock >= ctx->slot_size || ctx->sock_slot[sock] == 0) {
+        return NULL;
+    }
 
-    memcpy(new_loop_pollfds, ctx->pollfds, (cnt - 1) * sizeof(struct pollfd));
-    aos_free(ctx->pollfds);
-    ctx->pollfds = new_loop_pollfds;
+    return &ctx->readers[ctx->sock_slot[sock] - 1];
+}
 
-    new_sock += cnt - 1;
-    new_sock->sock = sock; /* yloop_t->readers[yloop_t-> reader_count-1]->sock*/
-    new_sock->private_data = private_data; /* yloop_t->readers[yloop_t-> reader_count-1] */
-    new_sock->cb = cb; /* yloop_t->readers[yloop_t-> reader_count-1]ص */
+/* the interest of s as handed to the backend */
+static int loop_sock_events(yloop_sock_t *s, int events)
+{
+    return events != 0 && s->edge ? events | YLOOP_EDGE : events;
+}
 
-    if (sock > ctx->max_sock) { /* yloop_tfd */
-        ctx->max_sock = sock;
+static int loop_sock_add(yloop_ctx_t *ctx, int sock, int event,
+                         aos_poll_call_t cb, void *private_data)
+{
+    yloop_sock_t *s;
+    int           ret;
+    int           size;
+
+    if (sock < 0 || cb == NULL) {
+        return -EINVAL;
+    }
+
+    s = loop_sock_find(ctx, sock);
+    if (s == NULL) {
+        size = ctx->reader_size;
+        if (loop_grow((void **)&ctx->readers, &size, ctx->reader_count + 1,
+                      sizeof(yloop_sock_t), ctx->reader_count) != 0) {
+            return -ENOMEM;
+        }
+        /* one ready entry per fd at most */
+        if (loop_grow((void **)&ctx->ready, &ctx->reader_size, size,
+                      sizeof(yloop_ready_t), ctx->ready_count) != 0) {
+            return -ENOMEM;
+        }
+        if (loop_grow((void **)&ctx->sock_slot, &ctx->slot_size, sock + 1,
+                      sizeof(int), ctx->slot_size) != 0) {
+            return -ENOMEM;
+        }
+
+        ret = ctx->be->ctl(ctx->be_data, sock, event);
+        if (ret == -EBUSY && ctx->be != &yloop_poll_backend) {
+            /* another loop's epoll set has the socket, poll shares it */
+            ret = yloop_backend_set(&yloop_poll_backend);
+            if (ret == 0) {
+                ret = ctx->be->ctl(ctx->be_data, sock, event);
+            }
+        }
+        if (ret != 0) {
+            return ret;
+        }
+
+        int status = aos_fcntl(sock, F_GETFL, 0);
+        aos_fcntl(sock, F_SETFL, status | O_NONBLOCK);
+
+        s = &ctx->readers[ctx->reader_count++];
+        memset(s, 0, sizeof(*s));
+        s->sock = sock;
+        ctx->sock_slot[sock] = ctx->reader_count;
+    } else if ((s->events | event) != s->events) {
+        ret = ctx->be->ctl(ctx->be_data, sock, loop_sock_events(s, s->events | event));
+        if (ret != 0) {
+            return ret;
+        }
+    }
+
+    s->events |= event;
+    if (event == POLLIN) {
+        s->cb = cb;
+        s->private_data = private_data;
+    } else {
+        s->wcb = cb;
+        s->wprivate_data = private_data;
     }
 
     return 0;
 }
+
+static void loop_sock_del(yloop_ctx_t *ctx, int sock, int event)
+{
+    yloop_sock_t *s = loop_sock_find(ctx, sock);
+    yloop_sock_t *last;
+
+    if (s == NULL || (s->events & event) == 0) {
+        return;
+    }
+
+    s->events &= ~event;
+    ctx->be->ctl(ctx->be_data, sock, loop_sock_events(s, s->events));
+    if (s->events != 0) {
+        return;
+    }
+
+    /* move the last one into the hole */
+    last = &ctx->readers[--ctx->reader_count];
+    ctx->sock_slot[sock] = 0;
+    if (s != last) {
+        *s = *last;
+        ctx->sock_slot[s->sock] = s - ctx->readers + 1;
+    }
+}
+
+int aos_poll_read_fd(int sock, aos_poll_call_t cb, void *private_data)
+{
+    return loop_sock_add(get_context(), sock, POLLIN, cb, private_data);
+}
 AOS_EXPORT(int, aos_poll_read_fd, int, aos_poll_call_t, void *);
 
 void aos_cancel_poll_read_fd(int sock, aos_poll_call_t action, void *param)
 {
-    yloop_ctx_t *ctx = get_context();
-    if (ctx->readers == NULL || ctx->reader_count == 0) {
-        return;
+    loop_sock_del(get_context(), sock, POLLIN);
+}
+AOS_EXPORT(void, aos_cancel_poll_read_fd, int, aos_poll_call_t, void *);
+
+int aos_poll_write_fd(int sock, aos_poll_call_t cb, void *private_data)
+{
+    return loop_sock_add(get_context(), sock, POLLOUT, cb, private_data);
+}
+AOS_EXPORT(int, aos_poll_write_fd, int, aos_poll_call_t, void *);
+
+void aos_cancel_poll_write_fd(int sock, aos_poll_call_t action, void *param)
+{
+    loop_sock_del(get_context(), sock, POLLOUT);
+}
+AOS_EXPORT(void, aos_cancel_poll_write_fd, int, aos_poll_call_t, void *);
+
+int aos_poll_fd_edge(int sock, int edge)
+{
+    yloop_ctx_t  *ctx = get_context();
+    yloop_sock_t *s = loop_sock_find(ctx, sock);
+    int           ret;
+
+    if (s == NULL) {
+        return -ENOENT;
     }
 
-    int i;
-    for (i = 0; i < ctx->reader_count; i++) {
-        if (ctx->readers[i].sock == sock) {
-            break; /*滹ͬsockô? */
+    if (s->edge == (edge != 0)) {
+        return 0;
+    }
+
+    s->edge = edge != 0;
+    ret = ctx->be->ctl(ctx->be_data, sock, loop_sock_events(s, s->events));
+    if (ret != 0) {
+        s->edge = !s->edge;
+    }
+
+    return ret;
+}
+AOS_EXPORT(int, aos_poll_fd_edge, int, int);
+
+/* earlier timeout first, then earlier post */
+static bool timer_before(yloop_ctx_t *ctx, int a, int b)
+{
+    yloop_timeout_t *ta = &ctx->timers[a];
+    yloop_timeout_t *tb = &ctx->timers[b];
+
+    if (ta->timeout_ms != tb->timeout_ms) {
+        return ta->timeout_ms < tb->timeout_ms;
+    }
+
+    return (int32_t)(ta->seq - tb->seq) < 0;
+}
+
+static void timer_heap_set(yloop_ctx_t *ctx, int idx, int t)
+{
+    ctx->heap[idx] = t;
+    ctx->timers[t].heap_idx = idx;
+}
+
+static void timer_sift_up(yloop_ctx_t *ctx, int idx)
+{
+    int t = ctx->heap[idx];
+    int parent;
+
+    while (idx > 0) {
+        parent = (idx - 1) / 2;
+        if (!timer_before(ctx, t, ctx->heap[parent])) {
+            break;
         }
+        timer_heap_set(ctx, idx, ctx->heap[parent]);
+        idx = parent;
     }
 
-    if (i == ctx->reader_count) {
-        return;
+    timer_heap_set(ctx, idx, t);
+}
+
+static void timer_sift_down(yloop_ctx_t *ctx, int idx)
+{
+    int t = ctx->heap[idx];
+    int child;
+
+    while ((child = idx * 2 + 1) < ctx->heap_count) {
+        if (child + 1 < ctx->heap_count &&
+            timer_before(ctx, ctx->heap[child + 1], ctx->heap[child])) {
+            child++;
+        }
+        if (!timer_before(ctx, ctx->heap[child], t)) {
+            break;
+        }
+        timer_heap_set(ctx, idx, ctx->heap[child]);
+        idx = child;
+    }
+
+    timer_heap_set(ctx, idx, t);
+}
+
+static int timer_add(yloop_ctx_t *ctx, int ms, aos_call_t action, void *param)
+{
+    yloop_timeout_t *timeout;
+    int              old;
+    int              size;
+    int              t;
+
+    if (ctx->timer_free < 0) {
+        /* handles keep the index in 16 bits */
+        old = ctx->timer_size;
+        if (old >= 0x8000) {
+            return -ENOMEM;
+        }
+
+        size = old;
+        if (loop_grow((void **)&ctx->timers, &size, old + 1,
+                      sizeof(yloop_timeout_t), old) != 0) {
+            return -ENOMEM;
+        }
+        if (loop_grow((void **)&ctx->heap, &ctx->timer_size, size,
+                      sizeof(int), ctx->heap_count) != 0) {
+            return -ENOMEM;
+        }
+
+        /* chain the new pool entries, lowest first */
+        for (t = size - 1; t >= old; t--) {
+            ctx->timers[t].heap_idx  = -1;
+            ctx->timers[t].next_free = ctx->timer_free;
+            ctx->timer_free = t;
+        }
     }
 
-    if (i != ctx->reader_count - 1) {
-        memmove(&ctx->readers[i], &ctx->readers[i + 1],
-                (ctx->reader_count - i - 1) *
-                sizeof(yloop_sock_t));
+    t = ctx->timer_free;
+    timeout = &ctx->timers[t];
+    ctx->timer_free = timeout->next_free;
+
+    timeout->timeout_ms   = aos_now_ms() + ms;
+    timeout->seq          = ctx->timer_seq++;
+    timeout->private_data = param;
+    timeout->cb           = action;
+    timeout->ms           = ms;
+
+    ctx->heap_count++;
+    timer_heap_set(ctx, ctx->heap_count - 1, t);
+    timer_sift_up(ctx, ctx->heap_count - 1);
+
+    return t;
+}
+
+static void timer_del(yloop_ctx_t *ctx, int t)
+{
+    yloop_timeout_t *timeout = &ctx->timers[t];
+    int              idx = timeout->heap_idx;
+
+    int              moved;
+
+    ctx->heap_count--;
+    if (idx != ctx->heap_count) {
+        /* the last one fills the hole, then goes up or down */
+        moved = ctx->heap[ctx->heap_count];
+        timer_heap_set(ctx, idx, moved);
+        timer_sift_up(ctx, idx);
+        if (ctx->timers[moved].heap_idx == idx) {
+            timer_sift_down(ctx, idx);
+        }
     }
 
-    ctx->reader_count--;
+    timeout->heap_idx  = -1;
+    timeout->cb        = NULL;
+    timeout->gen++;
+    timeout->next_free = ctx->timer_free;
+    ctx->timer_free    = t;
 }
-AOS_EXPORT(void, aos_cancel_poll_read_fd, int, aos_poll_call_t, void *);
 
-int aos_post_delayed_action(int ms, aos_call_t action, void *param)
-{ /* һʱʱ */
+int aos_post_delayed_call(int ms, aos_call_t action, void *param)
+{
+    yloop_ctx_t *ctx = get_context();
+    int          t;
+
     if (action == NULL) {
         return -EINVAL;
     }
 
-    yloop_ctx_t *ctx = get_context();
-    yloop_timeout_t *timeout = aos_malloc(sizeof(*timeout));
-    if (timeout == NULL) {
-        return -ENOMEM;
+    t = timer_add(ctx, ms, action, param);
+    if (t < 0) {
+        return t;
     }
 
-    timeout->timeout_ms = aos_now_ms() + ms; /* ʱʱʱ */
-    timeout->private_data = param; /* ʱص */
-    timeout->cb = action; /* ʱص */
-    timeout->ms = ms; /* ʱʱ */
+    /* 15 bits of generation keep the handle positive */
+    return ((ctx->timers[t].gen & 0x7fff) << 16) | (t + 1);
+}
+AOS_EXPORT(int, aos_post_delayed_call, int, aos_call_t, void *);
 
-    yloop_timeout_t *tmp;
+int aos_cancel_delayed_call(int handle)
+{
+    yloop_ctx_t *ctx = get_context();
+    int          t = (handle & 0xffff) - 1;
 
-    dlist_for_each_entry(&ctx->timeouts, tmp, yloop_timeout_t, next) {
-        if (timeout->timeout_ms < tmp->timeout_ms) {
-            break;
-        }
-    } /* ʱʱе˫ */
+    if (handle <= 0 || t < 0 || t >= ctx->timer_size ||
+        ctx->timers[t].heap_idx < 0 ||
+        (ctx->timers[t].gen & 0x7fff) != (handle >> 16)) {
+        return -ENOENT;
+    }
 
-    dlist_add_tail(&timeout->next, &tmp->next); /* Ѷʱ */
+    timer_del(ctx, t);
 
     return 0;
 }
+AOS_EXPORT(int, aos_cancel_delayed_call, int);
+
+int aos_post_delayed_action(int ms, aos_call_t action, void *param)
+{
+    int ret = aos_post_delayed_call(ms, action, param);
+
+    return ret < 0 ? ret : 0;
+}
 AOS_EXPORT(int, aos_post_delayed_action, int, aos_call_t, void *);
 
 void aos_cancel_delayed_action(int ms, aos_call_t cb, void *private_data)
-{ /* ɾʱʱ */
-    yloop_ctx_t *ctx = get_context();
+{
+    yloop_ctx_t     *ctx = get_context();
     yloop_timeout_t *tmp;
-    /* O(n)ܷŻO(1)? */
-    dlist_for_each_entry(&ctx->timeouts, tmp, yloop_timeout_t, next) {
+    int              found = -1;
+    int              i;
+
+    /* no handle, the first matching one to expire goes */
+    for (i = 0; i < ctx->heap_count; i++) {
+        tmp = &ctx->timers[ctx->heap[i]];
+
         if (ms != -1 && tmp->ms != ms) {
             continue;
         }
@@ -231,69 +574,340 @@ void aos_cancel_delayed_action(int ms, aos_call_t cb, void *private_data)
             continue;
         }
 
-        dlist_del(&tmp->next);
-        aos_free(tmp);
-        return;
+        if (found < 0 || timer_before(ctx, ctx->heap[i], found)) {
+            found = ctx->heap[i];
+        }
+    }
+
+    if (found >= 0) {
+        timer_del(ctx, found);
     }
 }
 AOS_EXPORT(void, aos_cancel_delayed_action, int, aos_call_t, void *);
 
+#ifdef YLOOP_MSG_RING
+static void loop_msg_overflow_add(yloop_ctx_t *ctx, atomic_val_t delta)
+{
+    atomic_val_t old = rhino_atomic_load_relaxed(&ctx->overflow);
+
+    while (!rhino_atomic_cas_weak(&ctx->overflow, &old, old + delta)) {
+    }
+}
+#endif
+
+int yloop_msg_post(aos_loop_t loop, const input_event_t *event)
+{
+#ifdef YLOOP_MSG_RING
+    yloop_ctx_t   *ctx = loop ? loop : get_context();
+    input_event_t *slot = NULL;
+    atomic_val_t   idle = 0u;
+
+    if (ctx == NULL) {
+        return -EINVAL;
+    }
+
+    /*
+     * Once an event overflowed, the following ones queue behind it on the
+     * event fd until the loop handled it, which keeps the events in order.
+     */
+    if (rhino_atomic_load_acquire(&ctx->overflow) == 0u) {
+        slot = krhino_mpsc_ring_reserve(&ctx->msgs, sizeof(*slot));
+    }
+
+    if (slot == NULL) {
+        loop_msg_overflow_add(ctx, 1u);
+        return -EAGAIN;
+    }
+
+    /* the only copy, the loop handles the event in place */
+    *slot = *event;
+    krhino_mpsc_ring_commit(&ctx->msgs, slot, sizeof(*slot));
+
+    /* only the post which finds the loop idle wakes it */
+    while (!rhino_atomic_cas_weak(&ctx->wake, &idle, 1u)) {
+        if (idle != 0u) {
+            return 0;
+        }
+    }
+
+    return 1;
+#else
+    return -ENOSYS;
+#endif
+}
+
+#ifdef YLOOP_MSG_RING
+/* handle up to max events in place, a slot is released once handled */
+static void loop_msg_drain(yloop_ctx_t *ctx, int max)
+{
+    input_event_t *event;
+
+    while (max-- > 0 &&
+           (event = krhino_mpsc_ring_peek(&ctx->msgs, NULL)) != NULL) {
+        aos_loop_handle_event(event);
+        krhino_mpsc_ring_consume(&ctx->msgs);
+    }
+}
+#endif
+
+void yloop_msg_drain(void *loop)
+{
+#ifdef YLOOP_MSG_RING
+    loop_msg_drain(loop, INT_MAX);
+#endif
+}
+
+#ifdef YLOOP_MSG_RING
+/*
+ * The loop is about to block: rearm the wakeup, so a post from now on wakes
+ * it, and tell whether a post before the rearm is still to be drained.
+ * Posts while the loop is awake need no wakeup at all.
+ */
+static bool loop_msg_idle(yloop_ctx_t *ctx)
+{
+    atomic_val_t busy = 1u;
+
+    while (!rhino_atomic_cas_weak(&ctx->wake, &busy, 0u) && busy != 0u) {
+    }
+
+    return !krhino_mpsc_ring_is_empty(&ctx->msgs);
+}
+#endif
+
+void yloop_msg_overflow_run(void *event)
+{
+#ifdef YLOOP_MSG_RING
+    yloop_ctx_t *ctx = get_context();
+
+    /* whatever made it into the ring was posted first */
+    loop_msg_drain(ctx, INT_MAX);
+    aos_loop_handle_event(event);
+    aos_free(event);
+    loop_msg_overflow_add(ctx, (atomic_val_t)-1);
+#endif
+}
+
+void yloop_msg_wake_cancel(aos_loop_t loop)
+{
+#ifdef YLOOP_MSG_RING
+    yloop_ctx_t *ctx = loop ? loop : get_context();
+
+    rhino_atomic_store_release(&ctx->wake, 0u);
+#endif
+}
+
+void yloop_msg_overflow_cancel(aos_loop_t loop)
+{
+#ifdef YLOOP_MSG_RING
+    loop_msg_overflow_add(loop ? loop : get_context(), (atomic_val_t)-1);
+#endif
+}
+
+int aos_loop_bind_cpu(int cpu)
+{
+    if (_get_context() == NULL || cpu < 0) {
+        return -EINVAL;
+    }
+
+#if defined(VCALL_RHINO) && (RHINO_CONFIG_CPU_NUM > 1)
+    if (krhino_task_cpu_bind(krhino_cur_task_get(), cpu) != RHINO_SUCCESS) {
+        return -EINVAL;
+    }
+#elif defined(VCALL_RHINO)
+    if (cpu != 0) {
+        return -EINVAL;
+    }
+#else
+    return -ENOSYS;
+#endif
+
+    return 0;
+}
+AOS_EXPORT(int, aos_loop_bind_cpu, int);
+
+typedef struct {
+    aos_sem_t        sem;
+    int              cpu;
+    yloop_ctx_t     *ctx;
+} yloop_start_t;
+
+static void loop_task(void *arg)
+{
+    yloop_start_t *start = arg;
+    yloop_ctx_t   *ctx = aos_loop_init();
+
+    if (ctx != NULL && start->cpu >= 0 && aos_loop_bind_cpu(start->cpu) != 0) {
+        aos_loop_destroy();
+        ctx = NULL;
+    }
+
+    /* start lives on the creator's stack, done with it after the signal */
+    start->ctx = ctx;
+    aos_sem_signal(&start->sem);
+
+    if (ctx != NULL) {
+        aos_loop_run();
+        aos_loop_destroy();
+    }
+
+    aos_task_exit(0);
+}
+
+aos_loop_t aos_loop_new(const char *name, int stack_size, int cpu)
+{
+    yloop_start_t start;
+
+    memset(&start, 0, sizeof(start));
+    start.cpu = cpu;
+
+    if (aos_sem_new(&start.sem, 0) != 0) {
+        return NULL;
+    }
+
+    if (aos_task_new(name, loop_task, &start, stack_size) == 0) {
+        aos_sem_wait(&start.sem, AOS_WAIT_FOREVER);
+    }
+
+    aos_sem_free(&start.sem);
+
+    return start.ctx;
+}
+AOS_EXPORT(aos_loop_t, aos_loop_new, const char *, int, int);
+
+int yloop_backend_set(const yloop_backend_t *be)
+{
+    yloop_ctx_t *ctx = get_context();
+    void        *be_data;
+    int          ret;
+    int          i;
+
+    be_data = be->create();
+    if (be_data == NULL) {
+        return -ENOMEM;
+    }
+
+    /* the interest set moves over */
+    for (i = 0; i < ctx->reader_count; i++) {
+        ret = be->ctl(be_data, ctx->readers[i].sock,
+                      loop_sock_events(&ctx->readers[i], ctx->readers[i].events));
+        if (ret != 0) {
+            be->destroy(be_data);
+            return ret;
+        }
+    }
+
+    ctx->be->destroy(ctx->be_data);
+    ctx->be      = be;
+    ctx->be_data = be_data;
+
+    return 0;
+}
+
+static void loop_ready(int fd, int revents, void *arg)
+{
+    yloop_ctx_t *ctx = arg;
+
+    if (ctx->ready_count < ctx->reader_size) {
+        ctx->ready[ctx->ready_count].fd      = fd;
+        ctx->ready[ctx->ready_count].revents = revents;
+        ctx->ready_count++;
+    }
+}
+
+/* run the timeouts expired before this call, not the ones they post */
+static void loop_fire_timeouts(yloop_ctx_t *ctx)
+{
+    yloop_timeout_t *tmo;
+    uint32_t         seq = ctx->timer_seq;
+    long long        now = aos_now_ms();
+    aos_call_t       cb;
+    void            *private_data;
+
+    while (ctx->heap_count > 0) {
+        tmo = &ctx->timers[ctx->heap[0]];
+        if (now < tmo->timeout_ms || (int32_t)(tmo->seq - seq) >= 0) {
+            break;
+        }
+
+        cb = tmo->cb;
+        private_data = tmo->private_data;
+        timer_del(ctx, ctx->heap[0]);
+        cb(private_data);
+    }
+}
+
+static void loop_dispatch(yloop_ctx_t *ctx)
+{
+    yloop_sock_t *s;
+    int           revents;
+    int           fd;
+    int           i;
+
+    for (i = 0; i < ctx->ready_count; i++) {
+        fd = ctx->ready[i].fd;
+        revents = ctx->ready[i].revents;
+
+        /* an earlier callback may have cancelled it */
+        s = loop_sock_find(ctx, fd);
+        if (s == NULL) {
+            continue;
+        }
+
+        if ((revents & POLLIN) && (s->events & POLLIN)) {
+            s->cb(fd, s->private_data);
+            s = loop_sock_find(ctx, fd);
+        }
+
+        if (s != NULL && (revents & POLLOUT) && (s->events & POLLOUT)) {
+            s->wcb(fd, s->wprivate_data);
+        }
+    }
+
+    ctx->ready_count = 0;
+}
+
 void aos_loop_run(void)
 {
     yloop_ctx_t *ctx = get_context();
 
     while (!ctx->terminate &&
-           (!dlist_empty(&ctx->timeouts) || ctx->reader_count > 0)) { /* ڶʱ¼IO¼ */
+           (ctx->heap_count > 0 || ctx->reader_count > 0)) {
         int delayed_ms = -1;
-        int readers = ctx->reader_count;
-        int i;
 
-        if (!dlist_empty(&ctx->timeouts)) {
-            yloop_timeout_t *tmo = dlist_first_entry(&ctx->timeouts, yloop_timeout_t, next);
+        if (ctx->heap_count > 0) {
+            yloop_timeout_t *tmo = &ctx->timers[ctx->heap[0]];
             long long now = aos_now_ms();
 
             if (now < tmo->timeout_ms) {
                 delayed_ms = tmo->timeout_ms - now;
             } else {
                 delayed_ms = 0;
-            } /* ҵһʱʱʱ */
+            }
         }
 
-        for (i = 0; i < readers; i++) {
-            ctx->pollfds[i].fd = ctx->readers[i].sock;
-            ctx->pollfds[i].events = POLLIN;
+#ifdef YLOOP_MSG_RING
+        if (loop_msg_idle(ctx)) {
+            delayed_ms = 0;
         }
+#endif
 
-        int res = aos_poll(ctx->pollfds, readers, delayed_ms); /* IO· */
+        /* only the ready fds come back, the interest set stays in the backend */
+        int res = ctx->be->wait(ctx->be_data, delayed_ms, loop_ready, ctx);
 
         if (res < 0 && errno != EINTR) {
             LOGE(TAG, "aos_poll");
             return;
         }
 
-        /* check if some registered timeouts have occurred */ /* ٴִеˣ˵ʱ¼ */
-        if (!dlist_empty(&ctx->timeouts)) {
-            yloop_timeout_t *tmo = dlist_first_entry(&ctx->timeouts, yloop_timeout_t, next);
-            long long now = aos_now_ms();
+        /* check if some registered timeouts have occurred */
+        loop_fire_timeouts(ctx);
 
-            if (now >= tmo->timeout_ms) {
-                dlist_del(&tmo->next); /* ɾ׼ִеĶʱ */
-                tmo->cb(tmo->private_data); /* ִÿһʱ¼Ļص */
-                aos_free(tmo);
-            }
-        }
-
-        if (res <= 0) {
-            continue;
-        }
+#ifdef YLOOP_MSG_RING
+        /* a batch at a time, the fds get their turn in between */
+        loop_msg_drain(ctx, YLOOP_CONFIG_MSG_NUM);
+#endif
 
-        for (i = 0; i < readers; i++) { /* ִÿһIO¼Ļص */
-            if (ctx->pollfds[i].revents & POLLIN) {
-                ctx->readers[i].cb(
-                    ctx->readers[i].sock,
-                    ctx->readers[i].private_data);
-            }
-        }
+        loop_dispatch(ctx);
     }
 
     ctx->terminate = 0;
@@ -317,15 +931,16 @@ void aos_loop_destroy(void)
 
     aos_event_service_deinit(ctx->eventfd);
 
-    while (!dlist_empty(&ctx->timeouts)) {
-        yloop_timeout_t *timeout = dlist_first_entry(&ctx->timeouts, yloop_timeout_t,
-                                                     next);
-        dlist_del(&timeout->next);
-        aos_free(timeout);
-    }
+    ctx->be->destroy(ctx->be_data);
 
     aos_free(ctx->readers);
-    aos_free(ctx->pollfds);
+    aos_free(ctx->sock_slot);
+    aos_free(ctx->ready);
+    aos_free(ctx->timers);
+    aos_free(ctx->heap);
+#ifdef YLOOP_MSG_RING
+    aos_free(ctx->msg_buf);
+#endif
 
     _set_context(NULL);
     if (ctx == g_main_ctx) {
@@ -334,4 +949,3 @@ void aos_loop_destroy(void)
     aos_free(ctx);
 }
 AOS_EXPORT(void, aos_loop_destroy, void);
-
@@ -17,5 +17,142 @@ int aos_event_service_init(void);
 /* deinit per-loop event service */
 void aos_event_service_deinit(int fd);
 
-#endif /* YLOOP_H */
+/**
+ * Register a callback run by the current loop when sock is writable,
+ * sock keeps a read callback of aos_poll_read_fd() if it has one.
+ *
+ * @param[in]  sock          the fd to poll.
+ * @param[in]  cb            called with sock and private_data.
+ * @param[in]  private_data  private data for the callback.
+ *
+ * @return  0 on success, negative error on failure.
+ */
+int aos_poll_write_fd(int sock, aos_poll_call_t cb, void *private_data);
+
+/**
+ * Cancel the write interest set by aos_poll_write_fd().
+ *
+ * @param[in]  sock    the fd.
+ * @param[in]  action  the callback registered.
+ * @param[in]  param   its private data.
+ */
+void aos_cancel_poll_write_fd(int sock, aos_poll_call_t action, void *param);
+
+/**
+ * Switch sock between level triggered, the default, and edge triggered.
+ * An edge triggered callback runs once each time sock turns readable or
+ * writable, so it has to drain sock before returning. The poll backend
+ * has no edges and keeps reporting sock while it is ready.
+ *
+ * @param[in]  sock  the fd registered to the current loop.
+ * @param[in]  edge  1 for edge triggered, 0 for level triggered.
+ *
+ * @return  0 on success, -ENOENT if sock is not registered.
+ */
+int aos_poll_fd_edge(int sock, int edge);
+
+/**
+ * Post a delayed action like aos_post_delayed_action(), returning a handle.
+ *
+ * @param[in]  ms      delay in ms.
+ * @param[in]  action  the action.
+ * @param[in]  param   its private data.
+ *
+ * @return  a positive handle for aos_cancel_delayed_call(), negative error on failure.
+ */
+int aos_post_delayed_call(int ms, aos_call_t action, void *param);
+
+/**
+ * Cancel a delayed action by handle in O(log n), a handle which already
+ * fired or was cancelled is ignored.
+ *
+ * @param[in]  handle  returned by aos_post_delayed_call().
+ *
+ * @return  0 on success, -ENOENT if the action is not pending.
+ */
+int aos_cancel_delayed_call(int handle);
+
+/**
+ * Create a loop running in a task of its own, the task runs the loop until
+ * aos_loop_exit() is called from it, e.g. by an aos_loop_schedule_call().
+ *
+ * @param[in]  name        task name.
+ * @param[in]  stack_size  task stack size in bytes.
+ * @param[in]  cpu         cpu to bind the task to, -1 for none.
+ *
+ * @return  the loop, NULL on failure.
+ */
+aos_loop_t aos_loop_new(const char *name, int stack_size, int cpu);
+
+/**
+ * Bind the task of the current loop to a cpu.
+ *
+ * @param[in]  cpu  the cpu number.
+ *
+ * @return  0 on success, negative error on failure.
+ */
+int aos_loop_bind_cpu(int cpu);
+
+/* run an EV_RPC event or pass it to the filters of its type */
+void aos_loop_handle_event(input_event_t *event);
+
+/*
+ * queue a copy of event on the inbound ring of loop, NULL for the current
+ * one. Returns 1 if the loop was idle and the caller has to post
+ * yloop_msg_drain(loop) to its event fd, 0 if a drain is already on its
+ * way, -EAGAIN if the ring is full and a heap copy of event has to go to
+ * the event fd through yloop_msg_overflow_run(), other negative errors if
+ * there is no ring.
+ */
+int yloop_msg_post(aos_loop_t loop, const input_event_t *event);
 
+/* handle the events queued on loop, in the loop task */
+void yloop_msg_drain(void *loop);
+
+/* handle and free an overflowed event, after the ones queued before it */
+void yloop_msg_overflow_run(void *event);
+
+/* forget an overflowed event which could not be posted */
+void yloop_msg_overflow_cancel(aos_loop_t loop);
+
+/*
+ * give up the wakeup yloop_msg_post() returned 1 for and could not be
+ * posted, the next post asks for it again
+ */
+void yloop_msg_wake_cancel(aos_loop_t loop);
+
+/* grow *arr of *size elems to hold num, keeping the first used ones */
+int loop_grow(void **arr, int *size, int num, int elem, int used);
+
+/* in ctl() events: report fd when it turns ready, a backend may ignore it */
+#define YLOOP_EDGE 0x8000
+
+/* readiness backend of a loop, the interest set persists between waits */
+typedef void (*yloop_ready_cb_t)(int fd, int revents, void *arg);
+
+typedef struct {
+    const char *name;
+    void *(*create)(void);
+    void  (*destroy)(void *be);
+    /* set the POLLIN/POLLOUT interest of fd, YLOOP_EDGE added, 0 drops fd */
+    int   (*ctl)(void *be, int fd, int events);
+    /* wait up to timeout ms (-1 forever), ready() for each ready fd, returns their count */
+    int   (*wait)(void *be, int timeout, yloop_ready_cb_t ready, void *arg);
+} yloop_backend_t;
+
+/* aos_poll() over a persistent pollfd array */
+extern const yloop_backend_t yloop_poll_backend;
+
+/* an epoll set of the VFS, a wait costs the ready fds only */
+extern const yloop_backend_t yloop_epoll_backend;
+
+/* register the "yloop_bench" cli command, built with aos_bench=1 */
+void yloop_bench_init(void);
+
+/*
+ * switch the current loop to be, its fds move over, returns 0 or negative
+ * error. A loop starts on epoll where the VFS has it, on poll otherwise.
+ */
+int yloop_backend_set(const yloop_backend_t *be);
+
+#endif /* YLOOP_H */
@@ -6,8 +6,16 @@ $(NAME)_TYPE := kernel
 $(NAME)_MBINS_TYPE := kernel
 
 $(NAME)_SOURCES     := yloop.c
+$(NAME)_SOURCES     += yloop_poll.c
+$(NAME)_SOURCES     += yloop_epoll.c
 $(NAME)_SOURCES     += local_event.c
 
+# "aos_bench=1" on the make line adds the benchmark cli commands
+ifeq ($(aos_bench),1)
+$(NAME)_SOURCES     += yloop_bench.c
+GLOBAL_DEFINES      += CONFIG_AOS_BENCH
+endif
+
 #default gcc
 ifeq ($(COMPILER),)
 $(NAME)_CFLAGS      += -Wall -Werror
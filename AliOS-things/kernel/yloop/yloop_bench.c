@@ -0,0 +1,295 @@
+/*
+ * Copyright (C) 2015-2017 Alibaba Group Holding Limited
+ */
+
+#include <string.h>
+#include <stdbool.h>
+
+#include <errno.h>
+#include <aos/aos.h>
+#include <aos/network.h>
+
+#include "yloop.h"
+
+#ifdef CONFIG_AOS_CLI
+/*
+ * "yloop_bench": cost of one loop iteration with 1/64/512 registered fds
+ * and one of them ready, so the numbers show the loop itself, not a
+ * driver. The fds are virtual, served by a backend which either reports
+ * the ready fd directly or first rebuilds and scans a pollfd array of all
+ * of them, the way aos_loop_run() did before the interest set persisted.
+ */
+#define YBENCH_FD_BASE     1000
+#define YBENCH_MAX_FDS     512
+#define YBENCH_ITERATIONS  100000
+#define YBENCH_TIMERS      512
+#define YBENCH_EVENTS      20000
+#define YBENCH_EV_BURST    16
+#define YBENCH_EV_TYPE     (EV_USER + 0x0b0)
+#define YBENCH_EV_FILTERS  16
+
+typedef struct {
+    int           fds[YBENCH_MAX_FDS];
+    struct pollfd pollfds[YBENCH_MAX_FDS];
+    int           count;
+    int           next;
+    bool          rebuild;
+    int           left;
+} ybench_t;
+
+static ybench_t g_ybench;
+
+static void *ybench_create(void)
+{
+    g_ybench.count = 0;
+    g_ybench.next  = 0;
+
+    return &g_ybench;
+}
+
+static void ybench_destroy(void *be)
+{
+}
+
+static int ybench_ctl(void *be, int fd, int events)
+{
+    ybench_t *b = be;
+    int       i;
+
+    /* the loop's own event fd is never ready here */
+    if (fd < YBENCH_FD_BASE) {
+        return 0;
+    }
+
+    for (i = 0; i < b->count; i++) {
+        if (b->fds[i] == fd) {
+            break;
+        }
+    }
+
+    if (events == 0) {
+        if (i < b->count) {
+            b->fds[i] = b->fds[--b->count];
+        }
+        return 0;
+    }
+
+    if (i == b->count) {
+        if (b->count == YBENCH_MAX_FDS) {
+            return -ENOMEM;
+        }
+        b->fds[b->count++] = fd;
+    }
+
+    return 0;
+}
+
+static int ybench_wait(void *be, int timeout, yloop_ready_cb_t ready, void *arg)
+{
+    ybench_t *b = be;
+    int       hot;
+    int       i;
+
+    if (b->count == 0) {
+        return 0;
+    }
+
+    hot = b->next;
+    b->next = (b->next + 1) % b->count;
+
+    if (!b->rebuild) {
+        ready(b->fds[hot], POLLIN, arg);
+        return 1;
+    }
+
+    for (i = 0; i < b->count; i++) {
+        b->pollfds[i].fd      = b->fds[i];
+        b->pollfds[i].events  = POLLIN;
+        b->pollfds[i].revents = 0;
+    }
+    b->pollfds[hot].revents = POLLIN;
+
+    for (i = 0; i < b->count; i++) {
+        if (b->pollfds[i].revents & POLLIN) {
+            ready(b->pollfds[i].fd, b->pollfds[i].revents, arg);
+        }
+    }
+
+    return 1;
+}
+
+static const yloop_backend_t ybench_backend = {
+    .name    = "bench",
+    .create  = ybench_create,
+    .destroy = ybench_destroy,
+    .ctl     = ybench_ctl,
+    .wait    = ybench_wait,
+};
+
+static void ybench_read(int fd, void *arg)
+{
+    if (--g_ybench.left <= 0) {
+        aos_loop_exit();
+    }
+}
+
+static void ybench_fds(int nfds, bool rebuild)
+{
+    long long start;
+    long long ms;
+    int       i;
+
+    for (i = 0; i < nfds; i++) {
+        aos_poll_read_fd(YBENCH_FD_BASE + i, ybench_read, NULL);
+    }
+
+    g_ybench.rebuild = rebuild;
+    g_ybench.left    = YBENCH_ITERATIONS;
+
+    start = aos_now_ms();
+    aos_loop_run();
+    ms = aos_now_ms() - start;
+
+    for (i = 0; i < nfds; i++) {
+        aos_cancel_poll_read_fd(YBENCH_FD_BASE + i, ybench_read, NULL);
+    }
+
+    aos_cli_printf("%-8s %4d fds: %6d ns/iteration\r\n", rebuild ? "rebuild" : "ready",
+                   nfds, (int)(ms * 1000000 / YBENCH_ITERATIONS));
+}
+
+static void ybench_timer_cb(void *arg)
+{
+}
+
+static void ybench_timers(void)
+{
+    static int handle[YBENCH_TIMERS];
+    long long  start;
+    long long  ms;
+    int        round;
+    int        i;
+
+    start = aos_now_ms();
+    for (round = 0; round < YBENCH_ITERATIONS / YBENCH_TIMERS; round++) {
+        for (i = 0; i < YBENCH_TIMERS; i++) {
+            handle[i] = aos_post_delayed_call(1000 + (i * 7919) % 1000, ybench_timer_cb, NULL);
+        }
+        for (i = 0; i < YBENCH_TIMERS; i++) {
+            aos_cancel_delayed_call(handle[i]);
+        }
+    }
+    ms = aos_now_ms() - start;
+
+    aos_cli_printf("timers   %4d pending: %6d ns/post+cancel\r\n", YBENCH_TIMERS,
+                   (int)(ms * 1000000 / (round * YBENCH_TIMERS)));
+}
+
+/*
+ * aos_post_event() to the main loop in bursts, with filters of other types
+ * registered too. Urgent events take the event device, as every event did
+ * before the loops had their own rings.
+ */
+static aos_sem_t g_ybench_sem;
+static int       g_ybench_events;
+
+static void ybench_event_cb(input_event_t *event, void *priv)
+{
+    if (++g_ybench_events % YBENCH_EV_BURST == 0) {
+        aos_sem_signal(&g_ybench_sem);
+    }
+}
+
+static void ybench_other_cb(input_event_t *event, void *priv)
+{
+}
+
+static void ybench_events(bool urgent)
+{
+    long long start;
+    long long ms;
+    int       i;
+    int       j;
+
+    g_ybench_events = 0;
+
+    start = aos_now_ms();
+    for (i = 0; i < YBENCH_EVENTS; i += YBENCH_EV_BURST) {
+        for (j = 0; j < YBENCH_EV_BURST; j++) {
+            aos_post_event(YBENCH_EV_TYPE | (urgent ? EV_FLAG_URGENT : 0), 0, j);
+        }
+        aos_sem_wait(&g_ybench_sem, AOS_WAIT_FOREVER);
+    }
+    ms = aos_now_ms() - start;
+
+    aos_cli_printf("%-8s events: %8d events/s\r\n", urgent ? "device" : "ring",
+                   (int)(YBENCH_EVENTS * 1000LL / (ms > 0 ? ms : 1)));
+}
+
+static void ybench_event_run(void)
+{
+    int i;
+
+    if (aos_sem_new(&g_ybench_sem, 0) != 0) {
+        return;
+    }
+
+    aos_register_event_filter(YBENCH_EV_TYPE, ybench_event_cb, NULL);
+    for (i = 1; i <= YBENCH_EV_FILTERS; i++) {
+        aos_register_event_filter(YBENCH_EV_TYPE + i, ybench_other_cb, NULL);
+    }
+
+    ybench_events(true);
+    ybench_events(false);
+
+    for (i = 1; i <= YBENCH_EV_FILTERS; i++) {
+        aos_unregister_event_filter(YBENCH_EV_TYPE + i, ybench_other_cb, NULL);
+    }
+    aos_unregister_event_filter(YBENCH_EV_TYPE, ybench_event_cb, NULL);
+
+    aos_sem_free(&g_ybench_sem);
+}
+
+static void ybench_task(void *arg)
+{
+    static const int nfds[] = { 1, 64, 512 };
+    int              i;
+
+    /* the main loop handles these, before this task gets a loop */
+    ybench_event_run();
+
+    if (aos_loop_init() == NULL ||
+        yloop_backend_set(&ybench_backend) != 0) {
+        aos_cli_printf("yloop_bench: no memory\r\n");
+        aos_task_exit(0);
+        return;
+    }
+
+    for (i = 0; i < sizeof(nfds) / sizeof(nfds[0]); i++) {
+        ybench_fds(nfds[i], true);
+        ybench_fds(nfds[i], false);
+    }
+
+    ybench_timers();
+
+    yloop_backend_set(&yloop_poll_backend);
+    aos_loop_destroy();
+    aos_task_exit(0);
+}
+
+static void handle_yloop_bench_cmd(char *pwbuf, int blen, int argc, char **argv)
+{
+    aos_task_new("yloop_bench", ybench_task, NULL, 4096);
+}
+
+static struct cli_command ybench_cmd = {
+    "yloop_bench",
+    "yloop event rate and iteration cost with 1/64/512 fds",
+    handle_yloop_bench_cmd
+};
+
+void yloop_bench_init(void)
+{
+    aos_cli_register_command(&ybench_cmd);
+}
+#endif
@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2015-2017 Alibaba Group Holding Limited
+ */
+
+#include <string.h>
+#include <stdbool.h>
+
+#include <errno.h>
+#include <aos/aos.h>
+#include <aos/network.h>
+#include <vfs.h>
+
+#include "yloop.h"
+
+#define TAG "yloop_epoll"
+
+/* ready fds taken from the set per wait */
+#define YLOOP_EPOLL_BATCH 16
+
+/*
+ * The fds stay armed in an epoll set of the VFS, a wait only sees the
+ * ready ones. Level triggered like the poll backend, unless YLOOP_EDGE
+ * asks for AOS_EPOLLET.
+ */
+typedef struct {
+    int               epfd;
+    aos_epoll_event_t events[YLOOP_EPOLL_BATCH];
+} yloop_epoll_t;
+
+static void *yepoll_create(void)
+{
+    yloop_epoll_t *e = aos_zalloc(sizeof(yloop_epoll_t));
+
+    if (e == NULL) {
+        return NULL;
+    }
+
+    e->epfd = aos_epoll_create();
+    if (e->epfd < 0) {
+        LOGE(TAG, "no epoll set: %d", e->epfd);
+        aos_free(e);
+        return NULL;
+    }
+
+    return e;
+}
+
+static void yepoll_destroy(void *be)
+{
+    yloop_epoll_t *e = be;
+
+    aos_close(e->epfd);
+    aos_free(e);
+}
+
+static int yepoll_ctl(void *be, int fd, int events)
+{
+    yloop_epoll_t    *e = be;
+    aos_epoll_event_t ev;
+    int               ret;
+
+    if (events == 0) {
+        ret = aos_epoll_ctl(e->epfd, AOS_EPOLL_CTL_DEL, fd, NULL);
+        return ret == -ENOENT ? 0 : ret;
+    }
+
+    ev.events  = ((events & POLLIN)     ? AOS_EPOLLIN  : 0) |
+                 ((events & POLLOUT)    ? AOS_EPOLLOUT : 0) |
+                 ((events & YLOOP_EDGE) ? AOS_EPOLLET  : 0);
+    ev.data.fd = fd;
+
+    ret = aos_epoll_ctl(e->epfd, AOS_EPOLL_CTL_MOD, fd, &ev);
+    if (ret == -ENOENT) {
+        ret = aos_epoll_ctl(e->epfd, AOS_EPOLL_CTL_ADD, fd, &ev);
+    }
+
+    return ret;
+}
+
+static int yepoll_wait(void *be, int timeout, yloop_ready_cb_t ready, void *arg)
+{
+    yloop_epoll_t *e = be;
+    uint32_t       ev;
+    int            res;
+    int            i;
+
+    res = aos_epoll_wait(e->epfd, e->events, YLOOP_EPOLL_BATCH, timeout);
+
+    for (i = 0; i < res; i++) {
+        ev = e->events[i].events;
+        ready(e->events[i].data.fd,
+              ((ev & AOS_EPOLLIN)  ? POLLIN  : 0) |
+              ((ev & AOS_EPOLLOUT) ? POLLOUT : 0) |
+              ((ev & AOS_EPOLLERR) ? POLLERR : 0) |
+              ((ev & AOS_EPOLLHUP) ? POLLHUP : 0), arg);
+    }
+
+    return res;
+}
+
+const yloop_backend_t yloop_epoll_backend = {
+    .name    = "epoll",
+    .create  = yepoll_create,
+    .destroy = yepoll_destroy,
+    .ctl     = yepoll_ctl,
+    .wait    = yepoll_wait,
+};
@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2015-2017 Alibaba Group Holding Limited
+ */
+
+#include <string.h>
+#include <stdbool.h>
+
+#include <errno.h>
+#include <aos/aos.h>
+#include <aos/network.h>
+
+#include "yloop.h"
+
+/*
+ * The pollfd array is kept between waits and only touched by ctl(), an
+ * fd leaves by swapping the last one into its place.
+ */
+typedef struct {
+    struct pollfd *pollfds;
+    int           *fd_idx; /* fd -> index in pollfds + 1 */
+    int            idx_size;
+    int            count;
+    int            size;
+} yloop_poll_t;
+
+static void *poll_create(void)
+{
+    return aos_zalloc(sizeof(yloop_poll_t));
+}
+
+static void poll_destroy(void *be)
+{
+    yloop_poll_t *p = be;
+
+    aos_free(p->pollfds);
+    aos_free(p->fd_idx);
+    aos_free(p);
+}
+
+static int poll_ctl(void *be, int fd, int events)
+{
+    yloop_poll_t *p = be;
+    int           idx;
+
+    if (fd < 0) {
+        return -EINVAL;
+    }
+
+    idx = fd < p->idx_size ? p->fd_idx[fd] - 1 : -1;
+
+    if (events == 0) {
+        if (idx < 0) {
+            return 0;
+        }
+
+        p->fd_idx[fd] = 0;
+        if (idx != --p->count) {
+            p->pollfds[idx] = p->pollfds[p->count];
+            p->fd_idx[p->pollfds[idx].fd] = idx + 1;
+        }
+
+        return 0;
+    }
+
+    if (idx < 0) {
+        if (loop_grow((void **)&p->pollfds, &p->size, p->count + 1,
+                      sizeof(struct pollfd), p->count) != 0 ||
+            loop_grow((void **)&p->fd_idx, &p->idx_size, fd + 1,
+                      sizeof(int), p->idx_size) != 0) {
+            return -ENOMEM;
+        }
+
+        idx = p->count++;
+        p->pollfds[idx].fd = fd;
+        p->fd_idx[fd] = idx + 1;
+    }
+
+    /* no edges here, YLOOP_EDGE fds stay level triggered */
+    p->pollfds[idx].events = events & (POLLIN | POLLOUT);
+
+    return 0;
+}
+
+static int poll_wait(void *be, int timeout, yloop_ready_cb_t ready, void *arg)
+{
+    yloop_poll_t *p = be;
+    int           res;
+    int           cnt = 0;
+    int           i;
+
+    res = aos_poll(p->pollfds, p->count, timeout);
+    if (res <= 0) {
+        return res;
+    }
+
+    /* aos_poll() already walks every fd, one more pass picks the ready ones */
+    for (i = 0; i < p->count; i++) {
+        if (p->pollfds[i].revents != 0) {
+            ready(p->pollfds[i].fd, p->pollfds[i].revents, arg);
+            cnt++;
+        }
+    }
+
+    return cnt;
+}
+
+const yloop_backend_t yloop_poll_backend = {
+    .name    = "poll",
+    .create  = poll_create,
+    .destroy = poll_destroy,
+    .ctl     = poll_ctl,
+    .wait    = poll_wait,
+};
@@ -0,0 +1,301 @@
+/*
+ * Copyright (C) 2015-2017 Alibaba Group Holding Limited
+ */
+
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <ucontext.h>
+
+#include <k_api.h>
+
+/* saved context of a task, carved from the top of its own stack */
+typedef struct {
+    ucontext_t   uctx;
+    task_entry_t entry;
+    void        *arg;
+} cpu_task_ctx_t;
+
+#define CPU_TASK_CTX_RESERVED  (sizeof(res_free_t) / sizeof(cpu_stack_t) + 1u)
+
+/* soft interrupt mask and the tick latched while it was set */
+static volatile sig_atomic_t g_cpu_intrpt_disabled = 1;
+static volatile sig_atomic_t g_cpu_tick_pending;
+
+static timer_t g_cpu_tick_timer;
+static long    g_cpu_tick_period_ns;
+
+#if (RHINO_CONFIG_TICKLESS > 0)
+/* longest one-shot the port arms, the idle task simply suspends again */
+#define CPU_TICKLESS_MAX_TICKS  ((tick_t)RHINO_CONFIG_TICKS_PER_SECOND * 3600u)
+
+static volatile uint64_t g_cpu_tick_last_ns;
+static uint64_t          g_cpu_tick_base_ns;
+
+static uint64_t cpu_clock_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+#endif
+
+volatile hr_timer_t g_cpu_tick_stamp;
+
+static void cpu_tick_isr(void)
+{
+    krhino_intrpt_enter();
+    krhino_tick_proc();
+    krhino_intrpt_exit();
+}
+
+static void cpu_timespec_set(struct timespec *ts, uint64_t ns)
+{
+    ts->tv_sec  = (time_t)(ns / 1000000000ull);
+    ts->tv_nsec = (long)(ns % 1000000000ull);
+}
+
+static void cpu_tick_signal_handler(int signo)
+{
+    (void)signo;
+
+    g_cpu_tick_stamp = HR_COUNT_GET();
+
+#if (RHINO_CONFIG_TICKLESS > 0)
+    g_cpu_tick_last_ns = cpu_clock_ns();
+#endif
+
+    if (g_cpu_intrpt_disabled) {
+        g_cpu_tick_pending = 1;
+        return;
+    }
+
+    /* runs on the interrupted task stack, like a core without an irq stack */
+    cpu_tick_isr();
+}
+
+cpu_cpsr_t cpu_intrpt_save(void)
+{
+    cpu_cpsr_t cpsr;
+
+    cpsr = g_cpu_intrpt_disabled;
+    g_cpu_intrpt_disabled = 1;
+    __asm__ volatile("" ::: "memory");
+
+    return cpsr;
+}
+
+void cpu_intrpt_restore(cpu_cpsr_t cpsr)
+{
+    __asm__ volatile("" ::: "memory");
+    g_cpu_intrpt_disabled = cpsr;
+
+    /* deliver the tick which hit the critical section, as a real core would */
+    if ((cpsr == 0) && (g_cpu_tick_pending != 0)) {
+        g_cpu_tick_pending = 0;
+        cpu_tick_isr();
+    }
+}
+
+RHINO_INLINE cpu_task_ctx_t *cpu_task_ctx_get(ktask_t *task)
+{
+    return (cpu_task_ctx_t *)task->task_stack;
+}
+
+static void cpu_task_entry(void)
+{
+    cpu_task_ctx_t *ctx;
+
+    ctx = cpu_task_ctx_get(g_active_task[cpu_cur_get()]);
+
+    /* a new task always starts with interrupts enabled */
+    cpu_intrpt_restore(0);
+
+    ctx->entry(ctx->arg);
+
+#if (RHINO_CONFIG_TASK_DEL > 0)
+#if (RHINO_CONFIG_KOBJ_DYN_ALLOC > 0)
+    if (krhino_cur_task_get()->mm_alloc_flag == K_OBJ_DYN_ALLOC) {
+        krhino_task_dyn_del(NULL);
+    }
+#endif
+    krhino_task_del(NULL);
+#endif
+
+    k_err_proc(RHINO_SYS_FATAL_ERR);
+}
+
+void *cpu_task_stack_init(cpu_stack_t *base, size_t size,
+                          void *arg, task_entry_t entry)
+{
+    cpu_task_ctx_t *ctx;
+    size_t          top;
+
+    /* keep the topmost words free, krhino_task_dyn_del() parks res_free_t there */
+    top = (size_t)(base + size - CPU_TASK_CTX_RESERVED) - sizeof(cpu_task_ctx_t);
+    ctx = (cpu_task_ctx_t *)(top & ~(size_t)15u);
+
+    if ((size_t)ctx <= (size_t)base) {
+        k_err_proc(RHINO_TASK_INV_STACK_SIZE);
+    }
+
+    getcontext(&ctx->uctx);
+
+    ctx->uctx.uc_stack.ss_sp   = base;
+    ctx->uctx.uc_stack.ss_size = (size_t)ctx - (size_t)base;
+    ctx->uctx.uc_link          = NULL;
+    sigemptyset(&ctx->uctx.uc_sigmask);
+
+    ctx->entry = entry;
+    ctx->arg   = arg;
+
+    makecontext(&ctx->uctx, cpu_task_entry, 0);
+
+    return ctx;
+}
+
+RHINO_INLINE void cpu_task_swap(void)
+{
+    ktask_t *from;
+    ktask_t *to;
+
+    from = g_active_task[cpu_cur_get()];
+    to   = g_preferred_ready_task[cpu_cur_get()];
+
+#if (RHINO_CONFIG_TASK_STACK_OVF_CHECK > 0)
+    krhino_stack_ovf_check();
+#endif
+
+#if (RHINO_CONFIG_TASK_SCHED_STATS > 0)
+    krhino_task_sched_stats_get();
+#endif
+
+    g_active_task[cpu_cur_get()] = to;
+
+    swapcontext(&cpu_task_ctx_get(from)->uctx, &cpu_task_ctx_get(to)->uctx);
+}
+
+/* always called with interrupts disabled from core_sched() */
+void cpu_task_switch(void)
+{
+    cpu_task_swap();
+}
+
+/* called from krhino_intrpt_exit(), possibly inside the tick signal handler */
+void cpu_intrpt_switch(void)
+{
+    cpu_task_swap();
+}
+
+static void cpu_tick_start(void)
+{
+    struct sigaction  sa;
+    struct sigevent   sev;
+    struct itimerspec its;
+
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = cpu_tick_signal_handler;
+    sa.sa_flags   = SA_RESTART;
+    sigemptyset(&sa.sa_mask);
+    sigaction(RHINO_CPU_TICK_SIGNAL, &sa, NULL);
+
+    memset(&sev, 0, sizeof(sev));
+    sev.sigev_notify = SIGEV_SIGNAL;
+    sev.sigev_signo  = RHINO_CPU_TICK_SIGNAL;
+    if (timer_create(CLOCK_MONOTONIC, &sev, &g_cpu_tick_timer) != 0) {
+        perror("timer_create");
+        exit(1);
+    }
+
+    g_cpu_tick_period_ns = 1000000000L / RHINO_CONFIG_TICKS_PER_SECOND;
+    cpu_timespec_set(&its.it_value, (uint64_t)g_cpu_tick_period_ns);
+    its.it_interval = its.it_value;
+
+#if (RHINO_CONFIG_TICKLESS > 0)
+    g_cpu_tick_last_ns = cpu_clock_ns();
+#endif
+
+    timer_settime(g_cpu_tick_timer, 0, &its, NULL);
+}
+
+#if (RHINO_CONFIG_TICKLESS > 0)
+void cpu_tick_suspend(tick_t ticks)
+{
+    struct itimerspec its;
+    uint64_t          target;
+    uint64_t          now;
+
+    if (ticks > CPU_TICKLESS_MAX_TICKS) {
+        ticks = CPU_TICKLESS_MAX_TICKS;
+    }
+
+    /* count from the last tick announced to the kernel so the tick phase is kept */
+    g_cpu_tick_base_ns = g_cpu_tick_last_ns;
+    if (g_cpu_tick_pending != 0) {
+        g_cpu_tick_base_ns -= (uint64_t)g_cpu_tick_period_ns;
+    }
+
+    target = g_cpu_tick_base_ns + ticks * (uint64_t)g_cpu_tick_period_ns;
+    now    = cpu_clock_ns();
+
+    memset(&its, 0, sizeof(its));
+    cpu_timespec_set(&its.it_value, (target > now) ? (target - now) : 1u);
+    timer_settime(g_cpu_tick_timer, 0, &its, NULL);
+}
+
+void cpu_idle_wait(void)
+{
+    sigset_t mask;
+    sigset_t old;
+
+    /* block the tick signal so it cannot slip in between the check and the wait */
+    sigemptyset(&mask);
+    sigaddset(&mask, RHINO_CPU_TICK_SIGNAL);
+    sigprocmask(SIG_BLOCK, &mask, &old);
+
+    if (g_cpu_tick_pending == 0) {
+        sigdelset(&old, RHINO_CPU_TICK_SIGNAL);
+        sigsuspend(&old);
+    }
+
+    sigprocmask(SIG_SETMASK, &old, NULL);
+}
+
+tick_t cpu_tick_resume(void)
+{
+    struct itimerspec its;
+    uint64_t          now;
+    tick_t            elapsed;
+
+    now     = cpu_clock_ns();
+    elapsed = (now - g_cpu_tick_base_ns) / (uint64_t)g_cpu_tick_period_ns;
+
+    /* the signal which woke us is counted in elapsed, do not replay it */
+    g_cpu_tick_pending = 0;
+    g_cpu_tick_last_ns = g_cpu_tick_base_ns + elapsed * (uint64_t)g_cpu_tick_period_ns;
+
+    cpu_timespec_set(&its.it_value,
+                     g_cpu_tick_last_ns + (uint64_t)g_cpu_tick_period_ns - now);
+    cpu_timespec_set(&its.it_interval, (uint64_t)g_cpu_tick_period_ns);
+    timer_settime(g_cpu_tick_timer, 0, &its, NULL);
+
+    return elapsed;
+}
+#endif /* RHINO_CONFIG_TICKLESS */
+
+void cpu_first_task_start(void)
+{
+    ucontext_t boot;
+
+    cpu_tick_start();
+
+    /* krhino_start() runs with interrupts disabled, the first task enables them */
+    g_cpu_intrpt_disabled = 1;
+
+    swapcontext(&boot, &cpu_task_ctx_get(g_active_task[cpu_cur_get()])->uctx);
+}
+
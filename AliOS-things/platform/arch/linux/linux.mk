@@ -0,0 +1,12 @@
+NAME := linux
+
+$(NAME)_TYPE := kernel
+$(NAME)_MBINS_TYPE := kernel
+
+GLOBAL_INCLUDES += ./
+
+$(NAME)_CFLAGS  += -Wall -Werror
+
+$(NAME)_SOURCES := cpu_impl.c
+
+GLOBAL_LDFLAGS  += -lrt -lm
@@ -0,0 +1,38 @@
+/*
+ * Copyright (C) 2015-2017 Alibaba Group Holding Limited
+ */
+
+#ifndef PORT_H
+#define PORT_H
+
+/*
+ * Hosted port: tasks are ucontext_t coroutines inside one Linux process and
+ * the tick is a POSIX timer delivering RHINO_CPU_TICK_SIGNAL. "Interrupts"
+ * are masked with a soft flag instead of sigprocmask(), a tick that fires
+ * inside a critical section is latched and replayed by cpu_intrpt_restore().
+ */
+#define RHINO_CPU_TICK_SIGNAL SIGALRM
+
+cpu_cpsr_t cpu_intrpt_save(void);
+void       cpu_intrpt_restore(cpu_cpsr_t cpsr);
+void       cpu_intrpt_switch(void);
+void       cpu_task_switch(void);
+void       cpu_first_task_start(void);
+void      *cpu_task_stack_init(cpu_stack_t *base, size_t size,
+                               void *arg, task_entry_t entry);
+
+/* hr count of the last tick interrupt entry, used by the timer benchmarks */
+extern volatile hr_timer_t g_cpu_tick_stamp;
+
+RHINO_INLINE uint8_t cpu_cur_get(void)
+{
+    return 0;
+}
+
+#define CPSR_ALLOC() cpu_cpsr_t cpsr
+
+#define RHINO_CPU_INTRPT_DISABLE() do { cpsr = cpu_intrpt_save(); } while (0)
+#define RHINO_CPU_INTRPT_ENABLE()  do { cpu_intrpt_restore(cpsr); } while (0)
+
+#endif /* PORT_H */
+
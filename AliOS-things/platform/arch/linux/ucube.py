@@ -0,0 +1,10 @@
+src     = Split('''
+        cpu_impl.c
+''')
+component = aos_component('linux', src)
+
+component.add_global_includes('.')
+component.add_cflags('-Wall')
+component.add_cflags('-Werror')
+component.add_global_ldflags('-lrt')
+component.add_global_ldflags('-lm')